@@ -29,6 +29,7 @@
 #define TSDB_COLUMN_COMPRESS_ZSTD     "zstd"
 #define TSDB_COLUMN_COMPRESS_TSZ      "tsz"
 #define TSDB_COLUMN_COMPRESS_XZ       "xz"
+#define TSDB_COLUMN_COMPRESS_AUTO     "auto"
 #define TSDB_COLUMN_COMPRESS_DISABLED "disabled"
 
 #define TSDB_COLUMN_LEVEL_UNKNOWN "unknown"
@@ -49,6 +50,7 @@
 #define TSDB_COLVAL_COMPRESS_ZSTD     3
 #define TSDB_COLVAL_COMPRESS_TSZ      4
 #define TSDB_COLVAL_COMPRESS_XZ       5
+#define TSDB_COLVAL_COMPRESS_AUTO     6
 #define TSDB_COLVAL_COMPRESS_DISABLED 0xff
 
 #define TSDB_COLVAL_LEVEL_NOCHANGE 0
@@ -62,7 +64,7 @@
 #define TSDB_CL_OPTION_LEN          9
 
 extern const char* supportedEncode[5];
-extern const char* supportedCompress[6];
+extern const char* supportedCompress[7];
 extern const char* supportedLevel[3];
 
 uint8_t     getDefaultEncode(uint8_t type);
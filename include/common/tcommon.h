@@ -388,6 +388,7 @@ typedef struct {
 
 #define SORT_QSORT_T              0x1
 #define SORT_SPILLED_MERGE_SORT_T 0x2
+#define SORT_RADIX_T              0x4  // in memory, by radix sort on the normalized sort keys
 typedef struct SSortExecInfo {
   int32_t sortMethod;
   int32_t sortBuffer;
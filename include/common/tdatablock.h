@@ -243,6 +243,10 @@ double blockDataGetSerialRowSize(const SSDataBlock* pBlock);
 size_t blockDataGetSerialMetaSize(uint32_t numOfCols);
 
 int32_t blockDataSort(SSDataBlock* pDataBlock, SArray* pOrderInfo);
+/**
+ * @brief same as blockDataSort, and reports the method used (SORT_QSORT_T or SORT_RADIX_T) in pSortMethod if not NULL
+ */
+int32_t blockDataSortEx(SSDataBlock* pDataBlock, SArray* pOrderInfo, int32_t* pSortMethod);
 /**
  * @brief find how many rows already in order start from first row
  */
@@ -119,6 +119,10 @@ extern int64_t tsQueueMemoryUsed;
 extern int64_t tsApplyMemoryAllowed;
 extern int64_t tsApplyMemoryUsed;
 extern int32_t tsRetentionSpeedLimitMB;
+extern int32_t tsRetentionCheckpointMB;
+extern int32_t tsRetentionYieldLatencyMs;
+extern int32_t tsSttMergePolicy;
+extern int32_t tsDirectWrite;
 extern int32_t tsNumOfMnodeStreamMgmtThreads;
 extern int32_t tsNumOfStreamMgmtThreads;
 extern int32_t tsNumOfVnodeStreamReaderThreads;
@@ -213,6 +217,11 @@ extern int32_t tsCacheLazyLoadThreshold;  // cost threshold for last/last_row lo
 extern int32_t tsQueryPolicy;
 extern bool    tsQueryTbNotExistAsEmpty;
 extern int32_t tsQueryRspPolicy;
+extern int32_t tsQueryReadAheadSizeMB;
+extern int32_t tsQueryBlockCacheSizeMB;
+extern int32_t tsNumOfSortThreads;
+extern int32_t tsQueryGroupByMemSizeMB;
+extern int32_t tsQueryHashJoinMemSizeMB;
 extern int64_t tsQueryMaxConcurrentTables;
 extern int32_t tsQuerySmaOptimize;
 extern int32_t tsQueryRsmaTolerance;
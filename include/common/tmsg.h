@@ -3274,11 +3274,28 @@ typedef struct SOrgTbInfo {
   SArray* colMap;  // SArray<SColIdNameKV>
 } SOrgTbInfo;
 
+/*
+ * Filter on the join key built by a hash join from its build rows, and pushed to the table scan feeding its probe
+ * side so that rows and blocks without a match are skipped. A filter with neither a range nor a bloom filter clears
+ * the one set before. It is only pushed to a scan in the same task, so it is not serialized.
+ */
+typedef struct STableScanRtFilter {
+  int32_t                   slotId;    // output slot of the key column in the scan
+  int8_t                    type;
+  int32_t                   bytes;
+  int16_t                   colId;     // set by the scan when the filter is accepted
+  bool                      hasRange;  // for the signed integer and timestamp keys only
+  int64_t                   min;
+  int64_t                   max;
+  struct SBlockBloomFilter* pBloom;
+} STableScanRtFilter;
+
 typedef struct STableScanOperatorParam {
-  bool        tableSeq;
-  SArray*     pUidList;
-  SOrgTbInfo* pOrgTbInfo;
-  STimeWindow window;
+  bool                tableSeq;
+  SArray*             pUidList;
+  SOrgTbInfo*         pOrgTbInfo;
+  STimeWindow         window;
+  STableScanRtFilter* pRtFilter;
 } STableScanOperatorParam;
 
 typedef struct STagScanOperatorParam {
@@ -218,6 +218,11 @@ bool qTaskIsExecuting(qTaskInfo_t qinfo);
  */
 void qDestroyTask(qTaskInfo_t tinfo);
 
+/**
+ * release the resources shared by all tasks, called when the last query worker of the process is closed
+ */
+void qCleanupSharedRes(void);
+
 void qProcessRspMsg(void* parent, struct SRpcMsg* pMsg, struct SEpSet* pEpSet);
 
 int32_t qGetExplainExecInfo(qTaskInfo_t tinfo, SArray* pExecInfoList);
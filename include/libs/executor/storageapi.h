@@ -181,6 +181,9 @@ typedef union {
 } STsdReaderNotifyInfo;
 
 typedef void (*TsdReaderNotifyCbFn)(ETsdReaderNotifyType type, STsdReaderNotifyInfo* info, void* param);
+// tells by the block aggregates, in the slots of the result block, if the caller may keep any row of a data block
+typedef int32_t (*TsdReaderBlockFilterFn)(SColumnDataAgg* pColsAgg, int32_t numOfCols, int32_t numOfRows, void* param,
+                                          bool* keep);
 
 struct SFileSetReader;
 
@@ -193,7 +196,10 @@ typedef struct TsdReader {
   int32_t      (*tsdNextDataBlock)(void* pReader, bool* hasNext);
 
   int32_t      (*tsdReaderRetrieveBlockSMAInfo)();
+  int32_t      (*tsdReaderRetrieveBlockZoneMap)(void* pReader, SSDataBlock* pDataBlock, bool* allHave);
   int32_t      (*tsdReaderRetrieveDataBlock)(void* p, SSDataBlock** pBlock, SArray* pIdList);
+  // pIdList given to tsdReaderRetrieveDataBlock only loads these columns, the others are loaded or dropped by this one
+  int32_t      (*tsdReaderRetrieveRemainColumns)(void* p, SSDataBlock* pBlock, bool load);
 
   void         (*tsdReaderReleaseDataBlock)(void* pReader);
 
@@ -204,6 +210,7 @@ typedef struct TsdReader {
 
   void         (*tsdSetFilesetDelimited)(void* pReader);
   void         (*tsdSetSetNotifyCb)(void* pReader, TsdReaderNotifyCbFn notifyFn, void* param);
+  void         (*tsdSetBlockFilter)(void* pReader, TsdReaderBlockFilterFn filterFn, void* param);
 
   // for fileset query
   int32_t (*fileSetReaderOpen)(void *pVnode, struct SFileSetReader **ppReader);
@@ -37,6 +37,21 @@ typedef struct {
   int64_t applyMemoryUsed;
 } SRawDnodeMetrics;
 
+// Raw Query Worker Metrics Structure (Input data), one per worker of a query worker pool
+typedef struct {
+  const char *poolName;
+  int32_t     workerId;
+  int64_t     runCount;
+  int64_t     stealCount;
+  int64_t     parkCount;
+} SRawQueryWorkerMetrics;
+
+// Raw Query Metrics Structure (Input data), one per vnode
+typedef struct {
+  int64_t block_cache_hits;
+  int64_t block_cache_misses;
+} SRawQueryMetrics;
+
 // Raw Write Metrics Structure (Input data)
 typedef struct {
   char    dbname[TSDB_DB_NAME_LEN];  // Database name
@@ -59,6 +74,10 @@ typedef struct {
   int64_t merge_time;
   int64_t last_cache_commit_time;
   int64_t last_cache_commit_count;
+  int64_t commit_fset_count;
+  int64_t commit_fset_time;
+  int64_t commit_write_bytes;
+  int64_t merge_write_bytes;
 } SRawWriteMetrics;
 
 // Public API functions
@@ -72,6 +91,14 @@ int32_t addWriteMetrics(int32_t vgId, int32_t dnodeId, int64_t clusterId, const
 // Dnode metrics functions
 int32_t addDnodeMetrics(const SRawDnodeMetrics *pRawMetrics, int64_t clusterId, int32_t dnodeId, const char *dnodeEp);
 
+// Query worker metrics functions
+int32_t addQueryWorkerMetrics(const SRawQueryWorkerMetrics *pRawMetrics, int64_t clusterId, int32_t dnodeId,
+                              const char *dnodeEp);
+
+// Query metrics functions
+int32_t addQueryMetrics(int32_t vgId, int32_t dnodeId, int64_t clusterId, const char *dnodeEp, const char *dbname,
+                        const SRawQueryMetrics *pRawMetrics);
+
 // Clean expired metrics based on valid vgroups (similar to vmCleanExpriedSamples)
 int32_t cleanupExpiredMetrics(SHashObj *pValidVgroups);
 
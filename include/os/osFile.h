@@ -75,6 +75,7 @@ typedef struct TdFile *TdFilePtr;
 #define TD_FILE_STREAM        0x0100  // Only support taosFprintfFile, taosGetLineFile, taosEOFFile
 #define TD_FILE_WRITE_THROUGH 0x0200
 #define TD_FILE_CLOEXEC       0x0400
+#define TD_FILE_DIRECT        0x0800  // bypass the page cache, io buffers, offsets and sizes must be aligned, linux only
 
 TdFilePtr taosOpenFile(const char *path, int32_t tdFileOptions);
 TdFilePtr taosCreateFile(const char *path, int32_t tdFileOptions);
@@ -106,6 +107,8 @@ int32_t taosFsyncFile(TdFilePtr pFile);
 
 int64_t taosReadFile(TdFilePtr pFile, void *buf, int64_t count);
 int64_t taosPReadFile(TdFilePtr pFile, void *buf, int64_t count, int64_t offset);
+int32_t taosReadAheadFile(TdFilePtr pFile, int64_t offset, int64_t length);
+int32_t taosWriteBehindFile(TdFilePtr pFile, int64_t offset, int64_t length);
 int64_t taosWriteFile(TdFilePtr pFile, const void *buf, int64_t count);
 int64_t taosPWriteFile(TdFilePtr pFile, const void *buf, int64_t count, int64_t offset);
 void    taosFprintfFile(TdFilePtr pFile, const char *format, ...);
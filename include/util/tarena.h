@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_UTIL_ARENA_H_
+#define _TD_UTIL_ARENA_H_
+
+#include "os.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Bump-pointer arena. Memory is carved out of chunks and released all at once by taosArenaReset/taosArenaDestroy.
+ *
+ * 1. When the query memory pool is enabled, chunks are charged to the pool session of the thread creating the arena,
+ *    so the session quota is checked once per chunk instead of once per allocation.
+ * 2. The arena is not thread safe, it is owned by one task and used by the thread executing it.
+ * 3. The first chunk is kept across resets, and grows to the size of the largest batch seen so far.
+ * 4. Only buffers that die before the next reset belong here. Column buffers of SSDataBlock are grown by realloc and
+ *    freed one by one, and most blocks outlive a batch, so they stay on the general allocator.
+ */
+typedef struct SArena SArena;
+
+#define TAOS_ARENA_DEFAULT_CHUNK_SIZE (64 * 1024)
+#define TAOS_ARENA_MAX_CHUNK_SIZE     (16 * 1024 * 1024)
+
+int32_t taosArenaCreate(int64_t chunkSize, SArena **ppArena);
+void    taosArenaDestroy(SArena *pArena);
+void   *taosArenaMalloc(SArena *pArena, int64_t size);
+void   *taosArenaCalloc(SArena *pArena, int64_t num, int64_t size);
+void    taosArenaReset(SArena *pArena);
+int64_t taosArenaGetMemSize(SArena *pArena);  // bytes held in chunks
+int64_t taosArenaGetAllocSize(SArena *pArena);  // bytes allocated since the last reset
+
+/*
+ * The arena bound to the current thread, set by the executor while a task is running. Returns the previous one, which
+ * should be restored when the task gives up the thread.
+ */
+SArena *taosArenaSetThreadArena(SArena *pArena);
+SArena *taosArenaGetThreadArena(void);
+
+/*
+ * Scratch memory for short-lived buffers. It is taken from the thread arena if there is one, otherwise from the heap.
+ * Always release it by taosArenaScratchFree, freeing the latest scratch buffer gives its space back to the arena.
+ */
+void *taosArenaScratchMalloc(int64_t size);
+void *taosArenaScratchCalloc(int64_t num, int64_t size);
+void  taosArenaScratchFree(void *ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*_TD_UTIL_ARENA_H_*/
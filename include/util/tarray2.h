@@ -38,6 +38,10 @@ extern "C" {
 
 typedef void (*TArray2Cb)(void *);
 
+// the untyped views of an array used by the helpers below, named so that C++ sources can include this file
+typedef TARRAY2(void) TArray2Void;
+typedef TARRAY2(uint8_t) TArray2Byte;
+
 #define TARRAY2_SIZE(a)       ((a)->size)
 #define TARRAY2_CAPACITY(a)   ((a)->capacity)
 #define TARRAY2_DATA(a)       ((a)->data)
@@ -48,7 +52,7 @@ typedef void (*TArray2Cb)(void *);
 #define TARRAY2_DATA_LEN(a)   ((a)->size * sizeof(((a)->data[0])))
 
 static FORCE_INLINE int32_t tarray2_make_room(void *arr, int32_t expSize, int32_t eleSize) {
-  TARRAY2(void) *a = arr;
+  TArray2Void *a = (TArray2Void *)arr;
 
   int32_t capacity = (a->capacity > 0) ? (a->capacity << 1) : 32;
   while (capacity < expSize) {
@@ -63,7 +67,7 @@ static FORCE_INLINE int32_t tarray2_make_room(void *arr, int32_t expSize, int32_
 
 static FORCE_INLINE int32_t tarray2InsertBatch(void *arr, int32_t idx, const void *elePtr, int32_t numEle,
                                                int32_t eleSize) {
-  TARRAY2(uint8_t) *a = arr;
+  TArray2Byte *a = (TArray2Byte *)arr;
 
   int32_t ret = 0;
   if (a->size + numEle > a->capacity) {
@@ -81,13 +85,13 @@ static FORCE_INLINE int32_t tarray2InsertBatch(void *arr, int32_t idx, const voi
 
 static FORCE_INLINE void *tarray2Search(void *arr, const void *elePtr, int32_t eleSize, __compar_fn_t compar,
                                         int32_t flag) {
-  TARRAY2(void) *a = arr;
+  TArray2Void *a = (TArray2Void *)arr;
   return taosbsearch(elePtr, a->data, a->size, eleSize, compar, flag);
 }
 
 static FORCE_INLINE int32_t tarray2SearchIdx(void *arr, const void *elePtr, int32_t eleSize, __compar_fn_t compar,
                                              int32_t flag) {
-  TARRAY2(void) *a = arr;
+  TArray2Void *a = (TArray2Void *)arr;
   void *p = taosbsearch(elePtr, a->data, a->size, eleSize, compar, flag);
   if (p == NULL) {
     return -1;
@@ -97,7 +101,7 @@ static FORCE_INLINE int32_t tarray2SearchIdx(void *arr, const void *elePtr, int3
 }
 
 static FORCE_INLINE int32_t tarray2SortInsert(void *arr, const void *elePtr, int32_t eleSize, __compar_fn_t compar) {
-  TARRAY2(void) *a = arr;
+  TArray2Void *a = (TArray2Void *)arr;
   int32_t idx = tarray2SearchIdx(arr, elePtr, eleSize, compar, TD_GT);
   return tarray2InsertBatch(arr, idx < 0 ? a->size : idx, elePtr, 1, eleSize);
 }
@@ -51,6 +51,28 @@ bool    tBloomFilterIsFull(const SBloomFilter* pBF);
 int32_t tBloomFilterEncode(const SBloomFilter* pBF, SEncoder* pEncoder);
 int32_t tBloomFilterDecode(SDecoder* pDecoder, SBloomFilter** ppBF);
 
+/*
+ * Split block bloom filter. Every key sets one bit in each of the 8 words of a single 256-bit block, so a probe touches
+ * one cache line only and can be done with one AVX2 instruction sequence.
+ */
+#define BLOCK_BF_WORDS 8
+#define BLOCK_BF_BYTES (BLOCK_BF_WORDS * sizeof(uint32_t))
+
+typedef struct SBlockBloomFilter {
+  uint32_t  numBlocks;
+  uint64_t  size;
+  uint32_t* blocks;
+} SBlockBloomFilter;
+
+int32_t tBlockBloomFilterInit(uint64_t expectedEntries, double errorRate, SBlockBloomFilter** ppBF);
+void    tBlockBloomFilterPutHash(SBlockBloomFilter* pBF, uint64_t hash);
+void    tBlockBloomFilterPut(SBlockBloomFilter* pBF, const void* keyBuf, uint32_t len);
+bool    tBlockBloomFilterNoContainHash(const SBlockBloomFilter* pBF, uint64_t hash);
+bool    tBlockBloomFilterNoContain(const SBlockBloomFilter* pBF, const void* keyBuf, uint32_t len);
+void    tBlockBloomFilterDestroy(SBlockBloomFilter* pBF);
+int32_t tBlockBloomFilterEncode(const SBlockBloomFilter* pBF, SEncoder* pEncoder);
+int32_t tBlockBloomFilterDecode(SDecoder* pDecoder, SBlockBloomFilter** ppBF);
+
 #ifdef __cplusplus
 }
 #endif
@@ -153,11 +153,20 @@ int32_t tsDecompressBigint(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int
 int32_t getWordLength(char type);
 
 int32_t tsDecompressIntImpl_Hw(const char *const input, const int32_t nelements, char *const output, const char type);
+int32_t tsDecompressBigintImplAvx2(const char *const input, const int32_t nelements, char *const output);
+int32_t tsDecompressBoolImpAvx2(const char *const input, const int32_t nelements, char *const output);
+int32_t tsDecompressBoolImpNeon(const char *const input, const int32_t nelements, char *const output);
 int32_t tsDecompressFloatImpAvx2(const char *input, int32_t nelements, char *output);
 int32_t tsDecompressDoubleImpAvx2(const char *input, int32_t nelements, char *output);
 int32_t tsDecompressTimestampAvx2(const char *input, int32_t nelements, char *output, bool bigEndian);
 int32_t tsDecompressTimestampAvx512(const char *const input, const int32_t nelements, char *const output,
                                     bool bigEndian);
+int32_t tsCompressTimestampImpAvx2(const char *const input, const int32_t nelements, char *const output);
+int32_t tsCompressTimestampImpAvx512(const char *const input, const int32_t nelements, char *const output);
+int32_t tsCompressINTImpAvx2(const char *const input, const int32_t nelements, char *const output, const char type);
+int32_t tsCompressINTImpAvx512(const char *const input, const int32_t nelements, char *const output, const char type);
+int32_t tsCompressFloatImpAvx2(const char *const input, const int32_t nelements, char *const output);
+int32_t tsCompressDoubleImpAvx2(const char *const input, const int32_t nelements, char *const output);
 
 /*************************************************************************
  *                  REGULAR COMPRESSION 2
@@ -260,6 +269,7 @@ typedef enum {
   L2_ZSTD,
   L2_TSZ,
   L2_XZ,
+  L2_AUTO,  // resolved to a concrete codec per block before compressing, never stored
   L2_DISABLED = 0xFF,
 } TCmprL2Type;
 
@@ -278,6 +288,11 @@ typedef struct {
 
 void tcompressDebug(uint32_t cmprAlg, uint8_t *l1Alg, uint8_t *l2Alg, uint8_t *level);
 
+// Trial-compress pIn with the candidate L2 codecs and return in *l2 the one with the smallest
+// compressed size weighted by its relative decode cost. pBuf must hold nIn + COMP_OVERFLOW_BYTES.
+int32_t tsCompressL2Select(const char *pIn, int32_t nIn, const char type, char *pBuf, int32_t nBuf, uint8_t *l2);
+int32_t tsGetCompressL2DecodeCost(uint8_t l2);
+
 #define DEFINE_VAR(cmprAlg)                   \
   uint8_t l1 = COMPRESS_L1_TYPE_U32(cmprAlg); \
   uint8_t l2 = COMPRESS_L2_TYPE_U32(cmprAlg); \
@@ -58,6 +58,9 @@ _equal_fn_t taosGetDefaultEqualFunction(int32_t type);
 typedef enum SHashLockTypeE {
   HASH_NO_LOCK = 0,
   HASH_ENTRY_LOCK = 1,
+  // open addressing table split into independently locked stripes, nodes come from per-stripe slabs and a
+  // stripe is rehashed incrementally by its writers, so neither put nor resize blocks the whole table
+  HASH_STRIPED_LOCK = 2,
 } SHashLockTypeE;
 
 typedef struct SHashNode SHashNode;
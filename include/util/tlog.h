@@ -40,9 +40,12 @@ typedef enum {
 } ELogMode;
 
 typedef void (*LogFp)(int64_t ts, ELogLevel level, const char *content);
+typedef void (*FLogOutput)(void *param, const char *msg, int32_t msgLen);
 
 extern bool    tsLogEmbedded;
 extern bool    tsAsyncLog;
+extern bool    tsLogThreadRing;
+extern bool    tsLogBinary;
 extern bool    tsAssert;
 extern int32_t tsNumOfLogLines;
 extern int32_t tsLogKeepDays;
@@ -108,6 +111,16 @@ void taosPrintSlowLog(const char *format, ...)
 #endif
     ;
 
+/*
+ * Decoder of the log files written with tsLogBinary. The format strings are defined in the file they are first used,
+ * so files rotated from one another should be decoded in the order they are written by the same decoder.
+ */
+typedef struct SLogDecoder SLogDecoder;
+
+int32_t taosLogDecoderOpen(SLogDecoder **ppDecoder);
+void    taosLogDecoderClose(SLogDecoder *pDecoder);
+int32_t taosLogDecodeFile(SLogDecoder *pDecoder, const char *fileName, FLogOutput fp, void *param);
+
 bool taosAssertDebug(bool condition, const char *file, int32_t line, bool core, const char *format, ...);
 bool taosAssertRelease(bool condition);
 
@@ -32,6 +32,10 @@ typedef struct LRUHandle LRUHandle;
 
 typedef enum { TAOS_LRU_PRIORITY_HIGH, TAOS_LRU_PRIORITY_LOW } LRUPriority;
 
+// TAOS_LRU_POLICY_TINYLFU: W-TinyLFU admission, a small LRU window in front of a segmented LRU main space, entries
+// leaving the window are admitted only if they are accessed more often than the main victim. Priority is ignored.
+typedef enum { TAOS_LRU_POLICY_LRU, TAOS_LRU_POLICY_TINYLFU } LRUPolicy;
+
 typedef enum {
   TAOS_LRU_STATUS_OK,
   TAOS_LRU_STATUS_FAIL,
@@ -39,7 +43,13 @@ typedef enum {
   TAOS_LRU_STATUS_OK_OVERWRITTEN
 } LRUStatus;
 
+typedef struct {
+  int64_t hits;
+  int64_t misses;
+} SLRUCacheStat;
+
 SLRUCache *taosLRUCacheInit(size_t capacity, int numShardBits, double highPriPoolRatio);
+SLRUCache *taosLRUCacheInitWithPolicy(size_t capacity, int numShardBits, double highPriPoolRatio, LRUPolicy policy);
 void       taosLRUCacheCleanup(SLRUCache *cache);
 
 LRUStatus  taosLRUCacheInsert(SLRUCache *cache, const void *key, size_t keyLen, void *value, size_t charge,
@@ -62,6 +72,10 @@ size_t taosLRUCacheGetPinnedUsage(SLRUCache *cache);
 
 int32_t taosLRUCacheGetElems(SLRUCache *cache);
 
+int32_t taosLRUCacheGetNumShards(SLRUCache *cache);
+void    taosLRUCacheGetShardStat(SLRUCache *cache, int32_t shardIdx, SLRUCacheStat *pStat);
+void    taosLRUCacheGetStat(SLRUCache *cache, SLRUCacheStat *pStat);
+
 void   taosLRUCacheSetCapacity(SLRUCache *cache, size_t capacity);
 size_t taosLRUCacheGetCapacity(SLRUCache *cache);
 
@@ -32,7 +32,7 @@ a single API instead of looping every queue by itself.
 Notes:
 1: taosOpenQueue/taosCloseQueue, taosOpenQset/taosCloseQset is NOT multi-thread safe
 2: after taosCloseQueue/taosCloseQset is called, read/write operation APIs are not safe.
-3: read/write operation APIs are multi-thread safe
+3: read/write operation APIs are multi-thread safe, write never takes a lock (multi-producer/single-consumer list)
 
 To remove the limitation and make this set of queue APIs multi-thread safe, REF(tref.c)
 shall be used to set up the protection.
@@ -104,8 +104,10 @@ void    taosQsetThreadResume(STaosQset *qset);
 int32_t taosAddIntoQset(STaosQset *qset, STaosQueue *queue, void *ahandle);
 void    taosRemoveFromQset(STaosQset *qset, STaosQueue *queue);
 int32_t taosGetQueueNumber(STaosQset *qset);
+int32_t taosQsetItemSize(STaosQset *qset);
 
 int32_t taosReadQitemFromQset(STaosQset *qset, void **ppItem, SQueueInfo *qinfo);
+int32_t taosReadQitemsFromQset(STaosQset *qset, void **ppItems, int32_t maxItems, SQueueInfo *qinfo);
 int32_t taosReadAllQitemsFromQset(STaosQset *qset, STaosQall *qall, SQueueInfo *qinfo);
 void    taosResetQsetThread(STaosQset *qset, void *pItem);
 void    taosQueueSetThreadId(STaosQueue *pQueue, int64_t threadId);
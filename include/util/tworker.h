@@ -17,6 +17,7 @@
 #define _TD_UTIL_WORKER_H_
 
 #include "tlist.h"
+#include "tlockfree.h"
 #include "tqueue.h"
 #include "tarray.h"
 
@@ -127,14 +128,38 @@ void    tMultiWorkerCleanup(SMultiWorker *pWorker);
 
 struct SQueryAutoQWorkerPoolCB;
 
+#define QUERY_AUTOQ_LOCAL_SIZE 8  // capacity of the local deque of each query worker
+
+typedef struct SQueryAutoQLocalMsg {
+  void      *msg;
+  SQueueInfo qinfo;
+} SQueryAutoQLocalMsg;
+
 typedef struct SQueryAutoQWorker {
   int32_t  id;      // worker id
   int32_t  backupIdx;// the idx when put into backup pool
   int64_t  pid;     // thread pid
   TdThread thread;  // thread id
   void    *pool;
+
+  // msgs grabbed together with the one being processed, other workers steal from here when idle
+  SRWLatch            localLatch;
+  int32_t             localHead;
+  int32_t             localNum;
+  SQueryAutoQLocalMsg localMsgs[QUERY_AUTOQ_LOCAL_SIZE];
+
+  int64_t runNum;    // msgs processed
+  int64_t stealNum;  // msgs stolen from the local deques of other workers
+  int64_t parkNum;   // times the worker found no msg anywhere and blocked, or parked in the backup pool
 } SQueryAutoQWorker;
 
+typedef struct SQueryAutoQWorkerStat {
+  int32_t id;
+  int64_t runNum;
+  int64_t stealNum;
+  int64_t parkNum;
+} SQueryAutoQWorkerStat;
+
 typedef struct SQueryAutoQWorkerPool {
   int32_t       num;
   int32_t       max;
@@ -171,6 +196,7 @@ int32_t     tQueryAutoQWorkerInit(SQueryAutoQWorkerPool *pPool);
 void        tQueryAutoQWorkerCleanup(SQueryAutoQWorkerPool *pPool);
 STaosQueue *tQueryAutoQWorkerAllocQueue(SQueryAutoQWorkerPool *pPool, void *ahandle, FItem fp);
 void        tQueryAutoQWorkerFreeQueue(SQueryAutoQWorkerPool* pPool, STaosQueue* pQ);
+int32_t     tQueryAutoQWorkerGetStat(SQueryAutoQWorkerPool *pPool, SArray *pStats);
 
 typedef struct SQueryAutoQWorkerPoolCB {
   void *pPool;
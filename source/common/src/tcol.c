@@ -21,9 +21,10 @@
 const char* supportedEncode[5] = {TSDB_COLUMN_ENCODE_SIMPLE8B, TSDB_COLUMN_ENCODE_XOR, TSDB_COLUMN_ENCODE_RLE,
                                   TSDB_COLUMN_ENCODE_DELTAD, TSDB_COLUMN_ENCODE_DISABLED};
 
-const char* supportedCompress[6] = {TSDB_COLUMN_COMPRESS_LZ4,  TSDB_COLUMN_COMPRESS_TSZ,
+const char* supportedCompress[7] = {TSDB_COLUMN_COMPRESS_LZ4,  TSDB_COLUMN_COMPRESS_TSZ,
                                     TSDB_COLUMN_COMPRESS_XZ,   TSDB_COLUMN_COMPRESS_ZLIB,
-                                    TSDB_COLUMN_COMPRESS_ZSTD, TSDB_COLUMN_COMPRESS_DISABLED};
+                                    TSDB_COLUMN_COMPRESS_ZSTD, TSDB_COLUMN_COMPRESS_AUTO,
+                                    TSDB_COLUMN_COMPRESS_DISABLED};
 
 const char* supportedLevel[3] = {TSDB_COLUMN_LEVEL_HIGH, TSDB_COLUMN_LEVEL_MEDIUM, TSDB_COLUMN_LEVEL_LOW};
 
@@ -175,6 +176,9 @@ const char* columnCompressStr(uint16_t type) {
     case TSDB_COLVAL_COMPRESS_ZSTD:
       compress = TSDB_COLUMN_COMPRESS_ZSTD;
       break;
+    case TSDB_COLVAL_COMPRESS_AUTO:
+      compress = TSDB_COLUMN_COMPRESS_AUTO;
+      break;
     case TSDB_COLVAL_COMPRESS_DISABLED:
       compress = TSDB_COLUMN_COMPRESS_DISABLED;
       break;
@@ -213,6 +217,8 @@ uint16_t columnCompressVal(const char* compress) {
     c = TSDB_COLVAL_COMPRESS_ZLIB;
   } else if (0 == strcmp(compress, TSDB_COLUMN_COMPRESS_ZSTD)) {
     c = TSDB_COLVAL_COMPRESS_ZSTD;
+  } else if (0 == strcmp(compress, TSDB_COLUMN_COMPRESS_AUTO)) {
+    c = TSDB_COLVAL_COMPRESS_AUTO;
   } else if (0 == strcmp(compress, TSDB_COLUMN_COMPRESS_DISABLED)) {
     c = TSDB_COLVAL_COMPRESS_DISABLED;
   } else {
@@ -367,7 +373,7 @@ int8_t validColCompressLevel(uint8_t type, uint8_t level) {
   return 1;
 }
 int8_t validColCompress(uint8_t type, uint8_t l2) {
-  if (l2 > TSDB_COLVAL_COMPRESS_XZ && l2 < TSDB_COLVAL_COMPRESS_DISABLED) {
+  if (l2 > TSDB_COLVAL_COMPRESS_AUTO && l2 < TSDB_COLVAL_COMPRESS_DISABLED) {
     return 0;
   }
   if (l2 == TSDB_COLVAL_COMPRESS_TSZ) {
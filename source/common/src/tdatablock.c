@@ -15,6 +15,7 @@
 
 #define _DEFAULT_SOURCE
 #include "tdatablock.h"
+#include "tarena.h"
 #include "tcompare.h"
 #include "tglobal.h"
 #include "tlog.h"
@@ -1479,7 +1480,228 @@ static int32_t* createTupleIndex(size_t rows) {
 
 static void destroyTupleIndex(int32_t* index) { taosMemoryFreeClear(index); }
 
+/*
+ * Normalized sort key: the order columns of a row are encoded one after another into bytes that compare by memcmp in
+ * the requested order, so the rows can be radix sorted without calling the comparator of each column type.
+ *
+ * 1. A column with null values starts with one byte telling null from not null, ordered by nullFirst.
+ * 2. The value is stored in big endian, with the sign bit of signed integers flipped. A float has all its bits
+ *    inverted if negative, and the sign bit set otherwise. NaN is taken as the smallest value, and -0.0 as 0.0, the
+ *    same as compareFloatVal/compareDoubleVal.
+ * 3. The value bytes are inverted for the descending order.
+ */
+#define BLOCK_SORT_KEY_MAX_LEN 32   // a longer key costs more radix passes than comparisons
+#define BLOCK_SORT_RADIX_ROWS  256  // fewer rows are sorted by comparing the normalized keys
+
+static bool blockSortKeyTypeValid(int8_t type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+    case TSDB_DATA_TYPE_UTINYINT:
+    case TSDB_DATA_TYPE_USMALLINT:
+    case TSDB_DATA_TYPE_UINT:
+    case TSDB_DATA_TYPE_UBIGINT:
+    case TSDB_DATA_TYPE_FLOAT:
+    case TSDB_DATA_TYPE_DOUBLE:
+    case TSDB_DATA_TYPE_DECIMAL64:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// length of the normalized key, or -1 if the order columns can not be normalized
+static int32_t blockSortGetKeyLen(SArray* pOrderInfo) {
+  int32_t len = 0;
+  for (int32_t i = 0; i < taosArrayGetSize(pOrderInfo); ++i) {
+    SBlockOrderInfo* pInfo = taosArrayGet(pOrderInfo, i);
+    if (pInfo == NULL || pInfo->pColData == NULL || !blockSortKeyTypeValid(pInfo->pColData->info.type)) {
+      return -1;
+    }
+
+    len += pInfo->pColData->info.bytes + (pInfo->pColData->hasNull ? 1 : 0);
+  }
+
+  return (len > 0 && len <= BLOCK_SORT_KEY_MAX_LEN) ? len : -1;
+}
+
+static FORCE_INLINE uint64_t blockSortNormalize(int8_t type, const char* pData) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+      return (uint8_t)(*(int8_t*)pData) ^ 0x80u;
+    case TSDB_DATA_TYPE_SMALLINT:
+      return (uint16_t)(*(int16_t*)pData) ^ 0x8000u;
+    case TSDB_DATA_TYPE_INT:
+      return (uint32_t)(*(int32_t*)pData) ^ 0x80000000u;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+    case TSDB_DATA_TYPE_DECIMAL64:
+      return (uint64_t)(*(int64_t*)pData) ^ 0x8000000000000000ull;
+    case TSDB_DATA_TYPE_UTINYINT:
+      return *(uint8_t*)pData;
+    case TSDB_DATA_TYPE_USMALLINT:
+      return *(uint16_t*)pData;
+    case TSDB_DATA_TYPE_UINT:
+      return *(uint32_t*)pData;
+    case TSDB_DATA_TYPE_UBIGINT:
+      return *(uint64_t*)pData;
+    case TSDB_DATA_TYPE_FLOAT: {
+      float    f = GET_FLOAT_VAL(pData);
+      uint32_t u = 0;
+      if (isnan(f)) {
+        return 0;
+      }
+      if (f == 0) {
+        f = 0;
+      }
+      (void)memcpy(&u, &f, sizeof(u));
+      return (u & 0x80000000u) ? (~u & 0xFFFFFFFFu) : (u | 0x80000000u);
+    }
+    case TSDB_DATA_TYPE_DOUBLE: {
+      double   d = GET_DOUBLE_VAL(pData);
+      uint64_t u = 0;
+      if (isnan(d)) {
+        return 0;
+      }
+      if (d == 0) {
+        d = 0;
+      }
+      (void)memcpy(&u, &d, sizeof(u));
+      return (u & 0x8000000000000000ull) ? ~u : (u | 0x8000000000000000ull);
+    }
+    default:
+      return 0;
+  }
+}
+
+// encode one order column of all rows into the entries at the given offset
+static void blockSortPutKeyColumn(uint8_t* pEntries, int32_t entryLen, int32_t offset, const SBlockOrderInfo* pInfo,
+                                  int32_t rows) {
+  const SColumnInfoData* pCol = pInfo->pColData;
+  int8_t                 type = pCol->info.type;
+  int32_t                bytes = pCol->info.bytes;
+  uint64_t               mask = (pInfo->order == TSDB_ORDER_DESC) ? UINT64_MAX : 0;
+
+  for (int32_t j = 0; j < rows; ++j) {
+    uint8_t* p = pEntries + (int64_t)j * entryLen + offset;
+    if (pCol->hasNull) {
+      bool isNull = colDataIsNull_f(pCol, j);
+      *(p++) = (isNull != pInfo->nullFirst) ? 1 : 0;
+      if (isNull) {
+        (void)memset(p, 0, bytes);
+        continue;
+      }
+    }
+
+    uint64_t v = blockSortNormalize(type, pCol->pData + (int64_t)j * bytes) ^ mask;
+    for (int32_t k = bytes - 1; k >= 0; --k) {
+      p[k] = (uint8_t)v;
+      v >>= 8;
+    }
+  }
+}
+
+static int32_t blockSortKeyCompar(const void* p1, const void* p2, const void* param) {
+  return memcmp(p1, p2, *(const int32_t*)param);
+}
+
+/*
+ * LSD radix sort of the entries, one pass per key byte from the last one. The histograms of all bytes are built in a
+ * single scan, and a byte shared by all rows (e.g. the high bytes of timestamps in a block) costs no pass. Returns the
+ * buffer holding the sorted entries.
+ */
+static uint8_t* blockSortRadix(uint8_t* pSrc, uint8_t* pDst, uint32_t* pCounts, int32_t rows, int32_t keyLen,
+                               int32_t entryLen) {
+  for (int32_t j = 0; j < rows; ++j) {
+    const uint8_t* p = pSrc + (int64_t)j * entryLen;
+    for (int32_t b = 0; b < keyLen; ++b) {
+      pCounts[b * 256 + p[b]]++;
+    }
+  }
+
+  for (int32_t b = keyLen - 1; b >= 0; --b) {
+    uint32_t* pCount = pCounts + b * 256;
+    if (pCount[pSrc[b]] == (uint32_t)rows) {
+      continue;
+    }
+
+    uint32_t sum = 0;
+    for (int32_t k = 0; k < 256; ++k) {
+      uint32_t c = pCount[k];
+      pCount[k] = sum;
+      sum += c;
+    }
+
+    for (int32_t j = 0; j < rows; ++j) {
+      const uint8_t* p = pSrc + (int64_t)j * entryLen;
+      (void)memcpy(pDst + (int64_t)(pCount[p[b]]++) * entryLen, p, entryLen);
+    }
+
+    TSWAP(pSrc, pDst);
+  }
+
+  return pSrc;
+}
+
+// sort the rows by the normalized keys, the row order is returned in index
+static int32_t blockDataSortByKey(SSDataBlock* pDataBlock, SArray* pOrderInfo, int32_t keyLen, int32_t* index,
+                                  int32_t* pSortMethod) {
+  int32_t rows = pDataBlock->info.rows;
+  int32_t entryLen = ((keyLen + 3) & ~3) + sizeof(int32_t);  // the key followed by the row index
+  bool    radix = rows >= BLOCK_SORT_RADIX_ROWS;
+  int64_t entrySize = (int64_t)rows * entryLen;
+  int64_t size = radix ? entrySize * 2 + (int64_t)keyLen * 256 * sizeof(uint32_t) : entrySize;
+
+  uint8_t* pBuf = taosArenaScratchMalloc(size);
+  if (pBuf == NULL) {
+    return terrno;
+  }
+
+  int32_t offset = 0;
+  for (int32_t i = 0; i < taosArrayGetSize(pOrderInfo); ++i) {
+    SBlockOrderInfo* pInfo = taosArrayGet(pOrderInfo, i);
+    blockSortPutKeyColumn(pBuf, entryLen, offset, pInfo, rows);
+    offset += pInfo->pColData->info.bytes + (pInfo->pColData->hasNull ? 1 : 0);
+  }
+
+  for (int32_t j = 0; j < rows; ++j) {
+    *(int32_t*)(pBuf + (int64_t)j * entryLen + entryLen - sizeof(int32_t)) = j;
+  }
+
+  uint8_t* pSorted = pBuf;
+  if (radix) {
+    uint32_t* pCounts = (uint32_t*)(pBuf + entrySize * 2);
+    (void)memset(pCounts, 0, (int64_t)keyLen * 256 * sizeof(uint32_t));
+    pSorted = blockSortRadix(pBuf, pBuf + entrySize, pCounts, rows, keyLen, entryLen);
+  } else {
+    taosqsort_r(pBuf, rows, entryLen, &keyLen, blockSortKeyCompar);
+  }
+
+  for (int32_t j = 0; j < rows; ++j) {
+    index[j] = *(int32_t*)(pSorted + (int64_t)j * entryLen + entryLen - sizeof(int32_t));
+  }
+
+  taosArenaScratchFree(pBuf);
+  if (pSortMethod != NULL) {
+    *pSortMethod = radix ? SORT_RADIX_T : SORT_QSORT_T;
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t blockDataSort(SSDataBlock* pDataBlock, SArray* pOrderInfo) {
+  return blockDataSortEx(pDataBlock, pOrderInfo, NULL);
+}
+
+int32_t blockDataSortEx(SSDataBlock* pDataBlock, SArray* pOrderInfo, int32_t* pSortMethod) {
+  if (pSortMethod != NULL) {
+    *pSortMethod = SORT_QSORT_T;
+  }
+
   if (pDataBlock->info.rows <= 1) {
     return TSDB_CODE_SUCCESS;
   }
@@ -1557,9 +1779,21 @@ int32_t blockDataSort(SSDataBlock* pDataBlock, SArray* pOrderInfo) {
     pInfo->compFn = getKeyComparFunc(pInfo->pColData->info.type, pInfo->order);
   }
 
-  terrno = 0;
-  taosqsort_r(index, rows, sizeof(int32_t), &helper, dataBlockCompar);
-  if (terrno) return terrno;
+  int32_t keyLen = blockSortGetKeyLen(pOrderInfo);
+  if (keyLen > 0) {
+    int32_t code = blockDataSortByKey(pDataBlock, pOrderInfo, keyLen, index, pSortMethod);
+    if (code != 0) {
+      destroyTupleIndex(index);
+      return code;
+    }
+  } else {
+    terrno = 0;
+    taosqsort_r(index, rows, sizeof(int32_t), &helper, dataBlockCompar);
+    if (terrno) {
+      destroyTupleIndex(index);
+      return terrno;
+    }
+  }
 
   int64_t p1 = taosGetTimestampUs();
 
@@ -3609,16 +3843,17 @@ int32_t trimDataBlock(SSDataBlock* pBlock, int32_t totalRows, const bool* pBoolL
           //   len = varDataTLen(p1);
           // }
 
-          char* p2 = taosMemoryMalloc(len);
+          char* p2 = taosArenaScratchMalloc(len);
           if (p2 == NULL) {
-            return terrno;
+            code = terrno;
+            goto _end;
           }
 
           memcpy(p2, p1, len);
           code = colDataSetVal(pDst, numOfRows, p2, false);
-          taosMemoryFree(p2);
+          taosArenaScratchFree(p2);
           if (code) {
-            return code;
+            goto _end;
           }
         }
         numOfRows += 1;
@@ -3630,9 +3865,10 @@ int32_t trimDataBlock(SSDataBlock* pBlock, int32_t totalRows, const bool* pBoolL
       }
     } else {
       if (pBitmap == NULL) {
-        pBitmap = taosMemoryCalloc(1, bmLen);
+        pBitmap = taosArenaScratchCalloc(1, bmLen);
         if (pBitmap == NULL) {
-          return terrno;
+          code = terrno;
+          goto _end;
         }
       }
 
@@ -3741,10 +3977,9 @@ int32_t trimDataBlock(SSDataBlock* pBlock, int32_t totalRows, const bool* pBoolL
   }
 
   pBlock->info.rows = maxRows;
-  if (pBitmap != NULL) {
-    taosMemoryFree(pBitmap);
-  }
 
+_end:
+  taosArenaScratchFree(pBitmap);
   return code;
 }
 
@@ -109,6 +109,10 @@ int32_t tsNumOfSnodeStreamThreads = 4;
 int32_t tsNumOfSnodeWriteThreads = 1;
 int32_t tsPQSortMemThreshold = 16;      // M
 int32_t tsRetentionSpeedLimitMB = 0;    // unlimited
+int32_t tsRetentionCheckpointMB = 1024;  // progress of a file migration is saved every this many MB copied
+int32_t tsRetentionYieldLatencyMs = 0;   // 0: never yield to queries
+int32_t tsSttMergePolicy = 0;           // 0: leveled, 1: size-tiered, 2: scored leveled
+int32_t tsDirectWrite = 0;              // 1: data and stt files are written with O_DIRECT
 int32_t tsNumOfMnodeStreamMgmtThreads = 2;
 int32_t tsNumOfStreamMgmtThreads = 2;
 int32_t tsNumOfVnodeStreamReaderThreads = 4;
@@ -233,6 +237,11 @@ int32_t tmqRowSize = 1000;
 int32_t tsQueryPolicy = 1;
 bool    tsQueryTbNotExistAsEmpty = false;
 int32_t tsQueryRspPolicy = 0;
+int32_t tsQueryReadAheadSizeMB = 16;  // data blocks read ahead by a query, 0 means off
+int32_t tsQueryBlockCacheSizeMB = 32;  // decoded data blocks shared by the queries of a vnode, 0 means off
+int32_t tsNumOfSortThreads = 2;        // threads helping the queries sort large inputs, 0 means off
+int32_t tsQueryGroupByMemSizeMB = 1024;  // groups a hash group by keeps in memory before spilling new ones, 0 means off
+int32_t tsQueryHashJoinMemSizeMB = 1024;  // build rows a hash join keeps in memory before partitioning them to disk, 0 means off
 int64_t tsQueryMaxConcurrentTables = 200;  // unit is TSDB_TABLE_NUM_UNIT
 bool    tsEnableQueryHb = true;
 bool    tsEnableScience = false;  // on taos-cli show float and doulbe with scientific notation if true
@@ -498,6 +507,9 @@ int32_t taosAddClientLogCfg(SConfig *pCfg) {
   TAOS_CHECK_RETURN(cfgAddInt32(pCfg, "numOfLogLines", tsNumOfLogLines, 1000, 2000000000, CFG_SCOPE_BOTH,
                                 CFG_DYN_ENT_BOTH, CFG_CATEGORY_LOCAL));
   TAOS_CHECK_RETURN(cfgAddBool(pCfg, "asyncLog", tsAsyncLog, CFG_SCOPE_BOTH, CFG_DYN_BOTH, CFG_CATEGORY_LOCAL));
+  TAOS_CHECK_RETURN(
+      cfgAddBool(pCfg, "logThreadRing", tsLogThreadRing, CFG_SCOPE_BOTH, CFG_DYN_NONE, CFG_CATEGORY_LOCAL));
+  TAOS_CHECK_RETURN(cfgAddBool(pCfg, "binaryLog", tsLogBinary, CFG_SCOPE_BOTH, CFG_DYN_NONE, CFG_CATEGORY_LOCAL));
   TAOS_CHECK_RETURN(
       cfgAddInt32(pCfg, "logKeepDays", 0, -365000, 365000, CFG_SCOPE_BOTH, CFG_DYN_ENT_BOTH, CFG_CATEGORY_LOCAL));
   TAOS_CHECK_RETURN(cfgAddInt32(pCfg, "debugFlag", 0, 0, 255, CFG_SCOPE_BOTH, CFG_DYN_BOTH, CFG_CATEGORY_LOCAL));
@@ -728,6 +740,9 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   tsNumOfCommitThreads = tsNumOfCores / 2;
   tsNumOfCommitThreads = TRANGE(tsNumOfCommitThreads, 2, 4);
 
+  tsNumOfSortThreads = tsNumOfCores / 4;
+  tsNumOfSortThreads = TRANGE(tsNumOfSortThreads, 1, 8);
+
   tsNumOfSupportVnodes = tsNumOfCores * 2 + 5;
   tsNumOfSupportVnodes = TMAX(tsNumOfSupportVnodes, 2);
 
@@ -794,9 +809,18 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
 
   TAOS_CHECK_RETURN(cfgAddInt32(pCfg, "queryBufferSize", tsQueryBufferSize, -1, 500000000000, CFG_SCOPE_SERVER, CFG_DYN_SERVER_LAZY, CFG_CATEGORY_LOCAL));
   TAOS_CHECK_RETURN(cfgAddInt32(pCfg, "queryRspPolicy", tsQueryRspPolicy, 0, 1, CFG_SCOPE_SERVER, CFG_DYN_SERVER,CFG_CATEGORY_GLOBAL));
+  TAOS_CHECK_RETURN(cfgAddInt32(pCfg, "queryReadAheadSizeMB", tsQueryReadAheadSizeMB, 0, 1024, CFG_SCOPE_SERVER, CFG_DYN_SERVER,CFG_CATEGORY_LOCAL));
+  TAOS_CHECK_RETURN(cfgAddInt32(pCfg, "queryBlockCacheSizeMB", tsQueryBlockCacheSizeMB, 0, 65536, CFG_SCOPE_SERVER, CFG_DYN_NONE,CFG_CATEGORY_LOCAL));
+  TAOS_CHECK_RETURN(cfgAddInt32(pCfg, "numOfSortThreads", tsNumOfSortThreads, 0, 1024, CFG_SCOPE_SERVER, CFG_DYN_NONE,CFG_CATEGORY_LOCAL));
+  TAOS_CHECK_RETURN(cfgAddInt32(pCfg, "queryGroupByMemSizeMB", tsQueryGroupByMemSizeMB, 0, 1048576, CFG_SCOPE_SERVER, CFG_DYN_SERVER,CFG_CATEGORY_LOCAL));
+  TAOS_CHECK_RETURN(cfgAddInt32(pCfg, "queryHashJoinMemSizeMB", tsQueryHashJoinMemSizeMB, 0, 1048576, CFG_SCOPE_SERVER, CFG_DYN_SERVER,CFG_CATEGORY_LOCAL));
   TAOS_CHECK_RETURN(cfgAddInt32(pCfg, "numOfCommitThreads", tsNumOfCommitThreads, 1, 1024, CFG_SCOPE_SERVER, CFG_DYN_SERVER_LAZY,CFG_CATEGORY_LOCAL));
   TAOS_CHECK_RETURN(cfgAddInt32(pCfg, "numOfCompactThreads", tsNumOfCompactThreads, 1, 16, CFG_SCOPE_SERVER, CFG_DYN_SERVER,CFG_CATEGORY_LOCAL));
   TAOS_CHECK_RETURN(cfgAddInt32(pCfg, "retentionSpeedLimitMB", tsRetentionSpeedLimitMB, 0, 1024, CFG_SCOPE_SERVER, CFG_DYN_SERVER,CFG_CATEGORY_GLOBAL));
+  TAOS_CHECK_RETURN(cfgAddInt32(pCfg, "retentionCheckpointMB", tsRetentionCheckpointMB, 64, 1048576, CFG_SCOPE_SERVER, CFG_DYN_SERVER,CFG_CATEGORY_LOCAL));
+  TAOS_CHECK_RETURN(cfgAddInt32(pCfg, "retentionYieldLatencyMs", tsRetentionYieldLatencyMs, 0, 60000, CFG_SCOPE_SERVER, CFG_DYN_SERVER,CFG_CATEGORY_LOCAL));
+  TAOS_CHECK_RETURN(cfgAddInt32(pCfg, "sttMergePolicy", tsSttMergePolicy, 0, 2, CFG_SCOPE_SERVER, CFG_DYN_SERVER,CFG_CATEGORY_LOCAL));
+  TAOS_CHECK_RETURN(cfgAddInt32(pCfg, "directWrite", tsDirectWrite, 0, 1, CFG_SCOPE_SERVER, CFG_DYN_SERVER,CFG_CATEGORY_LOCAL));
   TAOS_CHECK_RETURN(cfgAddBool(pCfg, "queryUseMemoryPool", tsQueryUseMemoryPool, CFG_SCOPE_SERVER, CFG_DYN_NONE,CFG_CATEGORY_LOCAL) != 0);
   TAOS_CHECK_RETURN(cfgAddBool(pCfg, "memPoolFullFunc", tsMemPoolFullFunc, CFG_SCOPE_SERVER, CFG_DYN_NONE,CFG_CATEGORY_LOCAL) != 0);
   TAOS_CHECK_RETURN(cfgAddInt32(pCfg, "singleQueryMaxMemorySize", tsSingleQueryMaxMemorySize, 0, 1000000000, CFG_SCOPE_SERVER, CFG_DYN_NONE,CFG_CATEGORY_LOCAL) != 0);
@@ -988,6 +1012,14 @@ static int32_t taosUpdateServerCfg(SConfig *pCfg) {
     pItem->stype = stype;
   }
 
+  pItem = cfgGetItem(pCfg, "numOfSortThreads");
+  if (pItem != NULL && pItem->stype == CFG_STYPE_DEFAULT) {
+    tsNumOfSortThreads = numOfCores / 4;
+    tsNumOfSortThreads = TRANGE(tsNumOfSortThreads, 1, 8);
+    pItem->i32 = tsNumOfSortThreads;
+    pItem->stype = stype;
+  }
+
   pItem = cfgGetItem(pCfg, "numOfCompactThreads");
   if (pItem != NULL && pItem->stype == CFG_STYPE_DEFAULT) {
     pItem->i32 = tsNumOfCompactThreads;
@@ -1109,6 +1141,12 @@ static int32_t taosSetClientLogCfg(SConfig *pCfg) {
   TAOS_CHECK_GET_CFG_ITEM(pCfg, pItem, "asyncLog");
   tsAsyncLog = pItem->bval;
 
+  TAOS_CHECK_GET_CFG_ITEM(pCfg, pItem, "logThreadRing");
+  tsLogThreadRing = pItem->bval;
+
+  TAOS_CHECK_GET_CFG_ITEM(pCfg, pItem, "binaryLog");
+  tsLogBinary = pItem->bval;
+
   TAOS_CHECK_GET_CFG_ITEM(pCfg, pItem, "logKeepDays");
   tsLogKeepDays = pItem->i32;
 
@@ -1518,6 +1556,18 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   TAOS_CHECK_GET_CFG_ITEM(pCfg, pItem, "retentionSpeedLimitMB");
   tsRetentionSpeedLimitMB = pItem->i32;
 
+  TAOS_CHECK_GET_CFG_ITEM(pCfg, pItem, "retentionCheckpointMB");
+  tsRetentionCheckpointMB = pItem->i32;
+
+  TAOS_CHECK_GET_CFG_ITEM(pCfg, pItem, "retentionYieldLatencyMs");
+  tsRetentionYieldLatencyMs = pItem->i32;
+
+  TAOS_CHECK_GET_CFG_ITEM(pCfg, pItem, "sttMergePolicy");
+  tsSttMergePolicy = pItem->i32;
+
+  TAOS_CHECK_GET_CFG_ITEM(pCfg, pItem, "directWrite");
+  tsDirectWrite = pItem->i32;
+
   TAOS_CHECK_GET_CFG_ITEM(pCfg, pItem, "numOfMnodeReadThreads");
   tsNumOfMnodeReadThreads = pItem->i32;
 
@@ -1563,6 +1613,21 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
 
   TAOS_CHECK_GET_CFG_ITEM(pCfg, pItem, "queryRspPolicy");
   tsQueryRspPolicy = pItem->i32;
+
+  TAOS_CHECK_GET_CFG_ITEM(pCfg, pItem, "queryReadAheadSizeMB");
+  tsQueryReadAheadSizeMB = pItem->i32;
+
+  TAOS_CHECK_GET_CFG_ITEM(pCfg, pItem, "queryBlockCacheSizeMB");
+  tsQueryBlockCacheSizeMB = pItem->i32;
+
+  TAOS_CHECK_GET_CFG_ITEM(pCfg, pItem, "numOfSortThreads");
+  tsNumOfSortThreads = pItem->i32;
+
+  TAOS_CHECK_GET_CFG_ITEM(pCfg, pItem, "queryGroupByMemSizeMB");
+  tsQueryGroupByMemSizeMB = pItem->i32;
+
+  TAOS_CHECK_GET_CFG_ITEM(pCfg, pItem, "queryHashJoinMemSizeMB");
+  tsQueryHashJoinMemSizeMB = pItem->i32;
 #ifdef USE_MONITOR
   TAOS_CHECK_GET_CFG_ITEM(pCfg, pItem, "monitor");
   tsEnableMonitor = pItem->bval;
@@ -2582,12 +2647,19 @@ static int32_t taosCfgDynamicOptionsForServer(SConfig *pCfg, const char *name) {
                                          {"cacheLazyLoadThreshold", &tsCacheLazyLoadThreshold},
 
                                          {"retentionSpeedLimitMB", &tsRetentionSpeedLimitMB},
+                                         {"retentionCheckpointMB", &tsRetentionCheckpointMB},
+                                         {"retentionYieldLatencyMs", &tsRetentionYieldLatencyMs},
+                                         {"sttMergePolicy", &tsSttMergePolicy},
+                                         {"directWrite", &tsDirectWrite},
                                          {"ttlChangeOnWrite", &tsTtlChangeOnWrite},
 
                                          {"logKeepDays", &tsLogKeepDays},
                                          {"mqRebalanceInterval", &tsMqRebalanceInterval},
                                          {"numOfLogLines", &tsNumOfLogLines},
                                          {"queryRspPolicy", &tsQueryRspPolicy},
+                                         {"queryReadAheadSizeMB", &tsQueryReadAheadSizeMB},
+                                         {"queryGroupByMemSizeMB", &tsQueryGroupByMemSizeMB},
+                                         {"queryHashJoinMemSizeMB", &tsQueryHashJoinMemSizeMB},
                                          {"timeseriesThreshold", &tsTimeSeriesThreshold},
                                          {"tmqMaxTopicNum", &tmqMaxTopicNum},
                                          {"tmqRowSize", &tmqRowSize},
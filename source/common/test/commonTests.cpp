@@ -357,6 +357,68 @@ TEST(testCase, Datablock_test) {
   taosArrayDestroy(pOrderInfo);
 }
 
+static void checkBlockSortByKey(int32_t rows, int32_t expectMethod) {
+  SSDataBlock* b = NULL;
+  int32_t      code = createDataBlock(&b);
+  ASSERT_EQ(code, 0);
+
+  SColumnInfoData infoData = createColumnInfoData(TSDB_DATA_TYPE_INT, 4, 1);
+  ASSERT_EQ(blockDataAppendColInfo(b, &infoData), 0);
+  SColumnInfoData infoData1 = createColumnInfoData(TSDB_DATA_TYPE_DOUBLE, 8, 2);
+  ASSERT_EQ(blockDataAppendColInfo(b, &infoData1), 0);
+  ASSERT_EQ(blockDataEnsureCapacity(b, rows), 0);
+
+  SColumnInfoData* p0 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 0);
+  SColumnInfoData* p1 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 1);
+  for (int32_t i = 0; i < rows; ++i) {
+    int32_t v = (i * 7919) % 101 - 50;
+    double  d = ((i * 104729) % 1009 - 504) / 3.0;
+    ASSERT_EQ(colDataSetVal(p0, i, (const char*)&v, (i % 13) == 0), 0);
+    ASSERT_EQ(colDataSetVal(p1, i, (const char*)&d, false), 0);
+    b->info.rows++;
+  }
+
+  SArray*         pOrderInfo = taosArrayInit(2, sizeof(SBlockOrderInfo));
+  SBlockOrderInfo order0 = {true, TSDB_ORDER_ASC, 0, NULL};
+  SBlockOrderInfo order1 = {false, TSDB_ORDER_DESC, 1, NULL};
+  taosArrayPush(pOrderInfo, &order0);
+  taosArrayPush(pOrderInfo, &order1);
+
+  int32_t method = 0;
+  ASSERT_EQ(blockDataSortEx(b, pOrderInfo, &method), 0);
+  ASSERT_EQ(method, expectMethod);
+
+  p0 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 0);
+  p1 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 1);
+  for (int32_t i = 1; i < rows; ++i) {
+    bool prevNull = colDataIsNull_f(p0, i - 1);
+    bool curNull = colDataIsNull_f(p0, i);
+    ASSERT_FALSE(!prevNull && curNull);
+    if (prevNull && !curNull) {
+      continue;
+    }
+
+    if (!curNull) {
+      int32_t v0 = *(int32_t*)colDataGetData(p0, i - 1);
+      int32_t v1 = *(int32_t*)colDataGetData(p0, i);
+      ASSERT_LE(v0, v1);
+      if (v0 != v1) {
+        continue;
+      }
+    }
+
+    ASSERT_GE(*(double*)colDataGetData(p1, i - 1), *(double*)colDataGetData(p1, i));
+  }
+
+  blockDataDestroy(b);
+  taosArrayDestroy(pOrderInfo);
+}
+
+TEST(testCase, Datablock_sort_by_key_test) {
+  checkBlockSortByKey(10, SORT_QSORT_T);
+  checkBlockSortByKey(4096, SORT_RADIX_T);
+}
+
 #if 0
 TEST(testCase, non_var_dataBlock_split_test) {
   SSDataBlock* b = static_cast<SSDataBlock*>(taosMemoryCalloc(1, sizeof(SSDataBlock)));
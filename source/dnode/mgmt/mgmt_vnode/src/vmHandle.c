@@ -1906,6 +1906,16 @@ void vmUpdateMetricsInfo(SVnodeMgmt *pMgmt, int64_t clusterId) {
             dError("Failed to reset write metrics for vgId: %d", pVnode->vgId);
           }
         }
+
+        SRawQueryMetrics queryMetrics = {0};
+        if (vnodeGetRawQueryMetrics(pVnode->pImpl, &queryMetrics) == 0) {
+          code = addQueryMetrics(pVnode->vgId, pMgmt->pData->dnodeId, clusterId, tsLocalEp, name.dbname, &queryMetrics);
+          if (code != TSDB_CODE_SUCCESS) {
+            dError("Failed to add query metrics for vgId: %d, code: %d", pVnode->vgId, code);
+          } else if (vnodeResetRawQueryMetrics(pVnode->pImpl, &queryMetrics) != 0) {
+            dError("Failed to reset query metrics for vgId: %d", pVnode->vgId);
+          }
+        }
       } else {
         dError("Failed to get write metrics for vgId: %d", pVnode->vgId);
       }
@@ -1914,4 +1924,32 @@ void vmUpdateMetricsInfo(SVnodeMgmt *pMgmt, int64_t clusterId) {
   }
 
   (void)taosThreadRwlockUnlock(&pMgmt->hashLock);
-}
\ No newline at end of file
+}
+
+void vmUpdateQueryWorkerMetrics(SVnodeMgmt *pMgmt, int64_t clusterId) {
+  SArray *pStats = taosArrayInit(pMgmt->queryPool.num, sizeof(SQueryAutoQWorkerStat));
+  if (pStats == NULL) {
+    dError("failed to collect query worker metrics since %s", tstrerror(terrno));
+    return;
+  }
+
+  int32_t code = tQueryAutoQWorkerGetStat(&pMgmt->queryPool, pStats);
+  if (code != TSDB_CODE_SUCCESS) {
+    dError("failed to get query worker stat since %s", tstrerror(code));
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(pStats); ++i) {
+    SQueryAutoQWorkerStat  *pStat = taosArrayGet(pStats, i);
+    SRawQueryWorkerMetrics metrics = {.poolName = pMgmt->queryPool.name,
+                                      .workerId = pStat->id,
+                                      .runCount = pStat->runNum,
+                                      .stealCount = pStat->stealNum,
+                                      .parkCount = pStat->parkNum};
+    code = addQueryWorkerMetrics(&metrics, clusterId, pMgmt->pData->dnodeId, tsLocalEp);
+    if (code != TSDB_CODE_SUCCESS) {
+      dError("failed to add query worker metrics for worker:%d, code:%d", pStat->id, code);
+    }
+  }
+
+  taosArrayDestroy(pStats);
+}
@@ -41,6 +41,7 @@ void mmGetMnodeLoads(void *pMgmt, SMonMloadInfo *pInfo);
 void qmGetQnodeLoads(void *pMgmt, SQnodeLoad *pInfo);
 
 void vmUpdateMetricsInfo(void *pMgmt, int64_t clusterId);
+void vmUpdateQueryWorkerMetrics(void *pMgmt, int64_t clusterId);
 
 void vmCleanExpriedSamples(void *pMgmt);
 void vmCleanExpiredMetrics(void *pMgmt);
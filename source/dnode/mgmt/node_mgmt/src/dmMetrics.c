@@ -42,6 +42,16 @@ static void collectWriteMetricsInfo(SDnode *pDnode) {
   }
 }
 
+static void collectQueryWorkerMetricsInfo(SDnode *pDnode) {
+  SMgmtWrapper *pWrapper = &pDnode->wrappers[VNODE];
+  if (dmMarkWrapper(pWrapper) == 0) {
+    if (pWrapper->pMgmt != NULL) {
+      vmUpdateQueryWorkerMetrics(pWrapper->pMgmt, dmGetClusterId());
+    }
+    dmReleaseWrapper(pWrapper);
+  }
+}
+
 void dmSendMetricsReport() {
   if (!tsEnableMonitor || tsMonitorFqdn[0] == 0 || tsMonitorPort == 0 || !tsEnableMetrics) {
     return;
@@ -53,6 +63,7 @@ void dmSendMetricsReport() {
 
   collectDnodeMetricsInfo(pDnode);
   collectWriteMetricsInfo(pDnode);
+  collectQueryWorkerMetricsInfo(pDnode);
 
   // monitorfw automatically handles metrics reporting
 }
@@ -175,8 +175,10 @@ int32_t  tsdbReaderSetId(void *pReader, const char *idstr);
 void     tsdbReaderClose2(void *pReader);
 int32_t  tsdbNextDataBlock2(void *pReader, bool *hasNext);
 int32_t  tsdbRetrieveDatablockSMA2(STsdbReader *pReader, SSDataBlock *pDataBlock, bool *allHave, bool *hasNullSMA);
+int32_t  tsdbRetrieveDatablockZoneMap2(STsdbReader *pReader, SSDataBlock *pDataBlock, bool *allHave);
 void     tsdbReleaseDataBlock2(void *pReader);
 int32_t  tsdbRetrieveDataBlock2(void *pReader, SSDataBlock **pBlock, SArray *pIdList);
+int32_t  tsdbRetrieveRemainColumns2(void *pReader, SSDataBlock *pBlock, bool load);
 int32_t  tsdbReaderReset2(void *pReader, SQueryTableDataCond *pCond);
 int32_t  tsdbGetFileBlocksDistInfo2(STsdbReader *pReader, STableBlockDistInfo *pTableBlockInfo);
 int64_t  tsdbGetNumOfRowsInMemTable2(STsdbReader *pHandle, uint32_t *rows);
@@ -187,6 +189,7 @@ void     tsdbReaderSetCloseFlag(STsdbReader *pReader);
 int64_t  tsdbGetLastTimestamp2(SVnode *pVnode, void *pTableList, int32_t numOfTables, const char *pIdStr);
 void     tsdbSetFilesetDelimited(STsdbReader *pReader);
 void     tsdbReaderSetNotifyCb(STsdbReader *pReader, TsdReaderNotifyCbFn notifyFn, void *param);
+void     tsdbReaderSetBlockFilter(STsdbReader *pReader, TsdReaderBlockFilterFn filterFn, void *param);
 int32_t  tsdbReaderGetProgress(const STsdbReader *pReader, void **pBuf, uint64_t *pLen);
 int32_t  tsdbReaderSetProgress(STsdbReader *pReader, const void *buf, uint64_t len);
 
@@ -405,6 +408,24 @@ int32_t vnodeGetRawWriteMetrics(void *pVnode, SRawWriteMetrics *pRawMetrics);
  */
 int32_t vnodeResetRawWriteMetrics(void *pVnode, const SRawWriteMetrics *pOldMetrics);
 
+/**
+ * @brief Get raw query metrics for a vnode, the values accumulated since the last reset
+ *
+ * @param pVnode Pointer to the vnode object
+ * @param pRawMetrics Pointer to the SRawQueryMetrics struct to fill with raw metrics
+ * @return 0 on success, non-zero on error
+ */
+int32_t vnodeGetRawQueryMetrics(void *pVnode, SRawQueryMetrics *pRawMetrics);
+
+/**
+ * @brief Reset raw query metrics for a vnode by marking old values as reported
+ *
+ * @param pVnode Pointer to the vnode object
+ * @param pOldMetrics Pointer to the SRawQueryMetrics struct containing values already reported
+ * @return 0 on success, non-zero on error
+ */
+int32_t vnodeResetRawQueryMetrics(void *pVnode, const SRawQueryMetrics *pOldMetrics);
+
 #ifdef __cplusplus
 }
 #endif
@@ -194,6 +194,7 @@ void    tBlockDataDestroy(SBlockData *pBlockData);
 int32_t tBlockDataInit(SBlockData *pBlockData, TABLEID *pId, STSchema *pTSchema, int16_t *aCid, int32_t nCid);
 void    tBlockDataReset(SBlockData *pBlockData);
 int32_t tBlockDataAppendRow(SBlockData *pBlockData, TSDBROW *pRow, STSchema *pTSchema, int64_t uid);
+int32_t tBlockDataAppendBlockRows(SBlockData *pBlockData, SBlockData *pBlockDataFrom, int32_t iRow, int32_t nRow);
 int32_t tBlockDataUpdateRow(SBlockData *pBlockData, TSDBROW *pRow, STSchema *pTSchema);
 int32_t tBlockDataTryUpsertRow(SBlockData *pBlockData, TSDBROW *pRow, int64_t uid);
 int32_t tBlockDataUpsertRow(SBlockData *pBlockData, TSDBROW *pRow, STSchema *pTSchema, int64_t uid);
@@ -249,6 +250,8 @@ int32_t tsdbTbDataIterCreate(STbData *pTbData, STsdbRowKey *pFrom, int8_t backwa
 void   *tsdbTbDataIterDestroy(STbDataIter *pIter);
 void    tsdbTbDataIterOpen(STbData *pTbData, STsdbRowKey *pFrom, int8_t backward, STbDataIter *pIter);
 bool    tsdbTbDataIterNext(STbDataIter *pIter);
+TSDBROW *tsdbTbDataIterLoadRow(STbDataIter *pIter);
+int32_t tsdbTbDataIterTakeBlockRows(STbDataIter *pIter, SBlockData *pBlockData, int32_t iRow, int32_t nRow);
 void    tsdbMemTableCountRows(SMemTable *pMemTable, SSHashObj *pTableMap, int64_t *rowsNum);
 int32_t tsdbMemTableSaveToCache(SMemTable *pMemTable, void *func);
 
@@ -378,6 +381,10 @@ struct STsdb {
   TdThreadMutex        bMutex;
   SLRUCache           *pgCache;
   TdThreadMutex        pgMutex;
+  SLRUCache           *dCache;          // decoded columns of the data file blocks
+  SLRUCacheStat        dCacheReported;  // dCache hits and misses already reported to metrics
+  int64_t              readLatency;     // moving average of the time queries take to load a file block, in us
+  int64_t              readLatencyTs;   // when readLatency was last updated, in ms
   struct STFileSystem *pFS;  // new
   SRocksCache          rCache;
   SCompMonitor        *pCompMonitor;
@@ -403,6 +410,13 @@ typedef struct SMemSkipList {
   SMemSkipListNode *pTail;
 } SMemSkipList;
 
+typedef struct SMemChunk SMemChunk;
+typedef struct SMemChunkList {
+  int64_t    size;
+  SMemChunk *pHead;
+  SMemChunk *pTail;
+} SMemChunkList;
+
 struct STbData {
   tb_uid_t     suid;
   tb_uid_t     uid;
@@ -411,9 +425,10 @@ struct STbData {
   SRWLatch     lock;
   SDelData    *pHead;
   SDelData    *pTail;
-  SMemSkipList sl;
-  STbData     *next;
-  SRBTreeNode  rbtn[1];
+  SMemSkipList  sl;
+  SMemChunkList cl;  // rows that arrive in key order are appended here, only the others go to the skip list
+  STbData      *next;
+  SRBTreeNode   rbtn[1];
 };
 
 struct SMemTable {
@@ -454,6 +469,21 @@ struct SMemSkipListNode {
   SMemSkipListNode *forwards[0];
 };
 
+/*
+ * A chunk of the append list. Rows in the chunks are in strictly increasing key order and each of them is greater than
+ * all rows in the table at the time it is appended. A column chunk takes all rows of a block submitted in column
+ * format, a row chunk collects rows submitted in row format. The writer publishes rows by increasing nRow and chunks
+ * by linking them, so readers can iterate the list without a lock.
+ */
+struct SMemChunk {
+  SMemChunk  *next;
+  SMemChunk  *prev;
+  SBlockData *pBlockData;  // not NULL for a column chunk
+  int32_t     nRow;
+  int32_t     nCap;
+  TSDBROW     aRow[];
+};
+
 struct STsdbRowKey {
   SRowKey key;
   int64_t version;
@@ -555,7 +585,10 @@ struct TABLEID {
 struct STbDataIter {
   STbData          *pTbData;
   int8_t            backward;
+  int8_t            fromChunk;  // pRow is from the append list
   SMemSkipListNode *pNode;
+  SMemChunk        *pChunk;
+  int32_t           iChunkRow;
   TSDBROW          *pRow;
   TSDBROW           row;
 };
@@ -671,6 +704,10 @@ typedef struct {
   int32_t     fid;
   int64_t     cid;
   int64_t     blkno;
+  int8_t      direct;  // opened with TD_FILE_DIRECT, pBuf and pWBuf are aligned
+  uint8_t    *pWBuf;   // pages ready to write, consecutive from wPgno
+  int64_t     wPgno;
+  int32_t     nWPage;
 } STsdbFD;
 
 struct SDelFWriter {
@@ -963,6 +1000,12 @@ int32_t tsdbCacheGetBlockSs(SLRUCache *pCache, STsdbFD *pFD, LRUHandle **handle)
 int32_t tsdbCacheGetPageSs(SLRUCache *pCache, STsdbFD *pFD, int64_t pgno, LRUHandle **handle);
 void    tsdbCacheSetPageSs(SLRUCache *pCache, STsdbFD *pFD, int64_t pgno, uint8_t *pPage);
 
+// the decoded columns of the data file blocks, a block is identified by (fid, commit id, block offset)
+LRUHandle *tsdbCacheGetColData(STsdb *pTsdb, int32_t fid, int64_t cid, int64_t blockOffset, int16_t colId);
+int32_t    tsdbCacheCopyColData(STsdb *pTsdb, LRUHandle *h, SBlockData *pBlockData);
+void tsdbCachePutColData(STsdb *pTsdb, int32_t fid, int64_t cid, int64_t blockOffset, const SColData *pColData);
+void tsdbCacheGetColDataStat(STsdb *pTsdb, SLRUCacheStat *pStat);
+
 int32_t tsdbCacheDeleteLastrow(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey);
 int32_t tsdbCacheDeleteLast(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey);
 int32_t tsdbCacheDelete(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey);
@@ -999,20 +1042,7 @@ static FORCE_INLINE TSDBROW *tsdbTbDataIterGet(STbDataIter *pIter) {
     return pIter->pRow;
   }
 
-  if (pIter->backward) {
-    if (pIter->pNode == pIter->pTbData->sl.pHead) {
-      return NULL;
-    }
-  } else {
-    if (pIter->pNode == pIter->pTbData->sl.pTail) {
-      return NULL;
-    }
-  }
-
-  pIter->pRow = &pIter->row;
-  pIter->row = pIter->pNode->row;
-
-  return pIter->pRow;
+  return tsdbTbDataIterLoadRow(pIter);
 }
 
 typedef struct {
@@ -1093,6 +1123,10 @@ void tsdbRemoveFile(const char *path);
 int32_t tsdbAllocateDisk(STsdb *tsdb, const char *label, int32_t expLevel, SDiskID *diskId);
 int32_t tsdbAllocateDiskAtLevel(STsdb *tsdb, int32_t level, const char *label, SDiskID *diskId);
 
+// the recent time queries take to load a file block, background tasks yield to queries when it is high
+void    tsdbUpdateReadLatency(STsdb *tsdb, int64_t us);
+int64_t tsdbGetReadLatency(STsdb *tsdb);
+
 #ifdef __cplusplus
 }
 #endif
@@ -475,6 +475,10 @@ struct SVnodeWriteMetrics {
   int64_t memtable_wait_time;
   int64_t last_cache_commit_time;
   int64_t last_cache_commit_count;
+  int64_t commit_fset_count;
+  int64_t commit_fset_time;
+  int64_t commit_write_bytes;  // bytes of files written by commits, i.e. the bytes ingested
+  int64_t merge_write_bytes;   // bytes of files rewritten by stt merges
 };
 
 struct SVnode {
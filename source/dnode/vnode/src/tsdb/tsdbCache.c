@@ -35,7 +35,8 @@ static int32_t tsdbOpenBCache(STsdb *pTsdb) {
   int32_t szPage = pTsdb->pVnode->config.tsdbPageSize;
   int64_t szBlock = tsSsBlockSize <= 1024 ? 1024 : tsSsBlockSize;
 
-  SLRUCache *pCache = taosLRUCacheInit((int64_t)tsSsBlockCacheSize * szBlock * szPage, 0, .5);
+  SLRUCache *pCache =
+      taosLRUCacheInitWithPolicy((int64_t)tsSsBlockCacheSize * szBlock * szPage, 0, .5, TAOS_LRU_POLICY_TINYLFU);
   if (pCache == NULL) {
     TAOS_CHECK_GOTO(TSDB_CODE_OUT_OF_MEMORY, &lino, _err);
   }
@@ -74,7 +75,7 @@ static int32_t tsdbOpenPgCache(STsdb *pTsdb) {
   int32_t code = 0, lino = 0;
   int32_t szPage = pTsdb->pVnode->config.tsdbPageSize;
 
-  SLRUCache *pCache = taosLRUCacheInit((int64_t)tsSsPageCacheSize * szPage, 0, .5);
+  SLRUCache *pCache = taosLRUCacheInitWithPolicy((int64_t)tsSsPageCacheSize * szPage, 0, .5, TAOS_LRU_POLICY_TINYLFU);
   if (pCache == NULL) {
     TAOS_CHECK_GOTO(TSDB_CODE_OUT_OF_MEMORY, &lino, _err);
   }
@@ -110,6 +111,43 @@ static void tsdbClosePgCache(STsdb *pTsdb) {
 
 #endif  // USE_SHARED_STORAGE
 
+static int32_t tsdbOpenDCache(STsdb *pTsdb) {
+  int32_t code = 0, lino = 0;
+
+  if (tsQueryBlockCacheSizeMB <= 0) {
+    return code;
+  }
+
+  // TinyLFU keeps the blocks of a one-off scan from pushing out the ones many queries keep coming back to
+  SLRUCache *pCache =
+      taosLRUCacheInitWithPolicy((int64_t)tsQueryBlockCacheSizeMB * 1024 * 1024, -1, .5, TAOS_LRU_POLICY_TINYLFU);
+  if (pCache == NULL) {
+    TAOS_CHECK_GOTO(TSDB_CODE_OUT_OF_MEMORY, &lino, _err);
+  }
+
+  taosLRUCacheSetStrictCapacity(pCache, true);
+
+  pTsdb->dCache = pCache;
+
+_err:
+  if (code) {
+    tsdbError("tsdb/dcache: vgId:%d, open failed at line %d since %s.", TD_VID(pTsdb->pVnode), lino, tstrerror(code));
+  }
+
+  TAOS_RETURN(code);
+}
+
+static void tsdbCloseDCache(STsdb *pTsdb) {
+  SLRUCache *pCache = pTsdb->dCache;
+  if (pCache) {
+    taosLRUCacheEraseUnrefEntries(pCache);
+
+    taosLRUCacheCleanup(pCache);
+
+    pTsdb->dCache = NULL;
+  }
+}
+
 #define ROCKS_KEY_LEN (sizeof(tb_uid_t) + sizeof(int16_t) + sizeof(int8_t))
 
 enum {
@@ -2835,6 +2873,8 @@ int32_t tsdbOpenCache(STsdb *pTsdb) {
   }
 #endif
 
+  TAOS_CHECK_GOTO(tsdbOpenDCache(pTsdb), &lino, _err);
+
   TAOS_CHECK_GOTO(tsdbOpenRocksCache(pTsdb), &lino, _err);
 
   taosLRUCacheSetStrictCapacity(pCache, false);
@@ -2868,6 +2908,8 @@ void tsdbCloseCache(STsdb *pTsdb) {
   }
 #endif
 
+  tsdbCloseDCache(pTsdb);
+
   tsdbCloseRocksCache(pTsdb);
 }
 
@@ -4287,3 +4329,119 @@ void tsdbCacheSetPageSs(SLRUCache *pCache, STsdbFD *pFD, int64_t pgno, uint8_t *
   tsdbCacheRelease(pFD->pTsdb->pgCache, handle);
 }
 #endif
+
+// decoded column cache
+typedef struct {
+  int64_t commitId;
+  int64_t blockOffset;
+  int32_t fid;
+  int16_t colId;
+  int16_t rsvd;
+} SColDataCacheKey;
+
+// the buffers of a column in block data are tRealloc ones, which the block data grows and frees with tFree
+static void *tsdbColDataMalloc(void *arg, int32_t size) {
+  uint8_t *p = NULL;
+  (void)arg;
+  return tRealloc(&p, size) == 0 ? p : NULL;
+}
+
+static size_t tsdbColDataCharge(const SColData *pColData) {
+  size_t charge = sizeof(SColData) + pColData->nData;
+
+  switch (pColData->flag) {
+    case (HAS_NULL | HAS_NONE):
+    case (HAS_VALUE | HAS_NONE):
+    case (HAS_VALUE | HAS_NULL):
+      charge += BIT1_SIZE(pColData->nVal);
+      break;
+    case (HAS_VALUE | HAS_NULL | HAS_NONE):
+      charge += BIT2_SIZE(pColData->nVal);
+      break;
+    default:
+      break;
+  }
+
+  if (IS_VAR_DATA_TYPE(pColData->type) && (pColData->flag & HAS_VALUE)) {
+    charge += (size_t)pColData->nVal * sizeof(int32_t);
+  }
+
+  return charge;
+}
+
+// tColDataCopy leaves the buffers it has not reached yet pointing to the source
+static int32_t tsdbColDataDeepCopy(const SColData *pFrom, SColData *pTo) {
+  int32_t code = tColDataCopy((SColData *)pFrom, pTo, tsdbColDataMalloc, NULL);
+  if (code) {
+    if (pTo->pBitMap == pFrom->pBitMap) pTo->pBitMap = NULL;
+    if (pTo->aOffset == pFrom->aOffset) pTo->aOffset = NULL;
+    if (pTo->pData == pFrom->pData) pTo->pData = NULL;
+    tColDataDestroy(pTo);
+    memset(pTo, 0, sizeof(*pTo));
+  }
+
+  return code;
+}
+
+static void deleteDCache(const void *key, size_t keyLen, void *value, void *ud) {
+  (void)ud;
+  SColData *pColData = (SColData *)value;
+
+  tColDataDestroy(pColData);
+  taosMemoryFree(pColData);
+}
+
+LRUHandle *tsdbCacheGetColData(STsdb *pTsdb, int32_t fid, int64_t cid, int64_t blockOffset, int16_t colId) {
+  if (pTsdb->dCache == NULL) {
+    return NULL;
+  }
+
+  SColDataCacheKey key = {.commitId = cid, .blockOffset = blockOffset, .fid = fid, .colId = colId, .rsvd = 0};
+  return taosLRUCacheLookup(pTsdb->dCache, &key, sizeof(key));
+}
+
+int32_t tsdbCacheCopyColData(STsdb *pTsdb, LRUHandle *h, SBlockData *pBlockData) {
+  int32_t   code = 0;
+  SColData *pCached = (SColData *)taosLRUCacheValue(pTsdb->dCache, h);
+  SColData *pColData = NULL;
+
+  TAOS_CHECK_RETURN(tBlockDataAddColData(pBlockData, pCached->cid, pCached->type, pCached->cflag, &pColData));
+
+  code = tsdbColDataDeepCopy(pCached, pColData);
+  if (code) {
+    // keep the column, the caller resets the block data on failure
+    tColDataInit(pColData, pCached->cid, pCached->type, pCached->cflag);
+  }
+
+  TAOS_RETURN(code);
+}
+
+void tsdbCachePutColData(STsdb *pTsdb, int32_t fid, int64_t cid, int64_t blockOffset, const SColData *pColData) {
+  if (pTsdb->dCache == NULL) {
+    return;
+  }
+
+  SColData *pCached = taosMemoryCalloc(1, sizeof(SColData));
+  if (pCached == NULL) {
+    return;  // the cache is best effort
+  }
+
+  if (tsdbColDataDeepCopy(pColData, pCached) != 0) {
+    taosMemoryFree(pCached);
+    return;
+  }
+
+  // without a handle, an entry that does not fit is dropped instead of going over the capacity
+  SColDataCacheKey key = {.commitId = cid, .blockOffset = blockOffset, .fid = fid, .colId = pColData->cid, .rsvd = 0};
+  (void)taosLRUCacheInsert(pTsdb->dCache, &key, sizeof(key), pCached, tsdbColDataCharge(pCached), deleteDCache, NULL,
+                           NULL, TAOS_LRU_PRIORITY_LOW, NULL);
+}
+
+void tsdbCacheGetColDataStat(STsdb *pTsdb, SLRUCacheStat *pStat) {
+  pStat->hits = 0;
+  pStat->misses = 0;
+
+  if (pTsdb->dCache != NULL) {
+    taosLRUCacheGetStat(pTsdb->dCache, pStat);
+  }
+}
@@ -60,6 +60,16 @@ typedef struct {
   TFileOpArray fopArray[1];
 } SCommitter2;
 
+// file sets of one commit are independent of each other, they are taken one by one by the committing thread and the
+// helper tasks on the commit pool
+typedef struct {
+  SCommitter2  *committer;   // the configuration shared by all workers
+  int32_t       numOfFSets;  //
+  int32_t       nextFSet;    // index of the next file set to commit
+  int32_t       code;        // the first failure, file sets not taken yet are skipped
+  TFileOpArray *fopArrays;   // file operations of each file set, merged in fid order after all are done
+} SCommitFSetJob;
+
 static int32_t tsdbCommitOpenWriter(SCommitter2 *committer) {
   int32_t code = 0;
   int32_t lino = 0;
@@ -133,6 +143,19 @@ static int32_t tsdbCommitTSData(SCommitter2 *committer) {
     }
 
     committer->ctx->hasTSData = true;
+
+    // rows appended to the memtable in column format are handed to the writer as a whole
+    SBlockData *blockData;
+    int32_t     iRow, nRow;
+    TAOS_CHECK_GOTO(
+        tsdbIterMergerTakeBlockRows(committer->dataIterMerger, committer->ctx->maxKey, &blockData, &iRow, &nRow),
+        &lino, _exit);
+    if (nRow > 0) {
+      numOfRow += nRow;
+      TAOS_CHECK_GOTO(tsdbFSetWriteBlockRows(committer->writer, blockData, iRow, nRow), &lino, _exit);
+      continue;
+    }
+
     numOfRow++;
 
     TAOS_CHECK_GOTO(tsdbFSetWriteRow(committer->writer, row), &lino, _exit);
@@ -363,22 +386,166 @@ _exit:
   return code;
 }
 
+static int32_t tsdbCommitFileSetImpl(SCommitter2 *committer) {
+  TAOS_CHECK_RETURN(tsdbCommitFileSetBegin(committer));
+  TAOS_CHECK_RETURN(tsdbCommitTSData(committer));
+  TAOS_CHECK_RETURN(tsdbCommitTombData(committer));
+  TAOS_CHECK_RETURN(tsdbCommitFileSetEnd(committer));
+  return 0;
+}
+
 static int32_t tsdbCommitFileSet(SCommitter2 *committer) {
   int32_t code = 0;
   int32_t lino = 0;
+  SVnode *pVnode = committer->tsdb->pVnode;
 
-  TAOS_CHECK_GOTO(tsdbCommitFileSetBegin(committer), &lino, _exit);
-  TAOS_CHECK_GOTO(tsdbCommitTSData(committer), &lino, _exit);
-  TAOS_CHECK_GOTO(tsdbCommitTombData(committer), &lino, _exit);
-  TAOS_CHECK_GOTO(tsdbCommitFileSetEnd(committer), &lino, _exit);
+  METRICS_TIMING_BLOCK(pVnode->writeMetrics.commit_fset_time, METRIC_LEVEL_HIGH,
+                       { code = tsdbCommitFileSetImpl(committer); });
+  TSDB_CHECK_CODE(code, lino, _exit);
+  METRICS_UPDATE(pVnode->writeMetrics.commit_fset_count, METRIC_LEVEL_HIGH, 1);
 
 _exit:
   if (code) {
-    tsdbError("vgId:%d %s failed at %s:%d since %s", TD_VID(committer->tsdb->pVnode), __func__, __FILE__, lino,
-              tstrerror(code));
+    tsdbError("vgId:%d %s failed at %s:%d since %s", TD_VID(pVnode), __func__, __FILE__, lino, tstrerror(code));
   } else {
-    tsdbDebug("vgId:%d %s done, fid:%d", TD_VID(committer->tsdb->pVnode), __func__, committer->ctx->info->fid);
+    tsdbDebug("vgId:%d %s done, fid:%d", TD_VID(pVnode), __func__, committer->ctx->info->fid);
+  }
+  return code;
+}
+
+static void tsdbCommitWorkerInit(const SCommitter2 *committer, SCommitter2 *worker) {
+  worker->tsdb = committer->tsdb;
+  worker->minutes = committer->minutes;
+  worker->precision = committer->precision;
+  worker->minRow = committer->minRow;
+  worker->maxRow = committer->maxRow;
+  worker->cmprAlg = committer->cmprAlg;
+  worker->sttTrigger = committer->sttTrigger;
+  worker->szPage = committer->szPage;
+  worker->compactVersion = committer->compactVersion;
+  worker->cid = committer->cid;
+  worker->now = committer->now;
+}
+
+static void tsdbCommitWorkerClear(SCommitter2 *worker) {
+  // only left open by a failed file set, its half written files are dropped
+  if (worker->writer) {
+    (void)tsdbFSetWriterClose(&worker->writer, true, NULL);
+  }
+  tsdbCommitCloseIter(worker);
+  tsdbCommitCloseReader(worker);
+
+  TARRAY2_DESTROY(worker->dataIterArray, NULL);
+  TARRAY2_DESTROY(worker->tombIterArray, NULL);
+  TARRAY2_DESTROY(worker->sttReaderArray, NULL);
+  TARRAY2_DESTROY(worker->fopArray, NULL);
+}
+
+static void tsdbCommitFileSetsImpl(SCommitFSetJob *job) {
+  STsdb      *tsdb = job->committer->tsdb;
+  SCommitter2 worker = {0};
+
+  tsdbCommitWorkerInit(job->committer, &worker);
+
+  while (atomic_load_32(&job->code) == 0) {
+    int32_t idx = atomic_fetch_add_32(&job->nextFSet, 1);
+    if (idx >= job->numOfFSets) {
+      break;
+    }
+
+    worker.ctx->info = *(SFileSetCommitInfo **)taosArrayGet(tsdb->commitInfo->arr, idx);
+
+    int32_t code = tsdbCommitFileSet(&worker);
+    if (code) {
+      (void)atomic_val_compare_exchange_32(&job->code, 0, code);
+      break;
+    }
+
+    // hand the file operations over to the job, the worker starts the next file set with an empty array
+    job->fopArrays[idx] = worker.fopArray[0];
+    TARRAY2_INIT(worker.fopArray);
+  }
+
+  tsdbCommitWorkerClear(&worker);
+}
+
+static int32_t tsdbCommitFileSetTask(void *arg) {
+  tsdbCommitFileSetsImpl((SCommitFSetJob *)arg);
+  return 0;
+}
+
+static int32_t tsdbCommitFileSets(SCommitter2 *committer) {
+  int32_t    code = 0;
+  int32_t    lino = 0;
+  STsdb     *tsdb = committer->tsdb;
+  SVATaskID *helpers = NULL;
+  int32_t    numOfHelpers = 0;
+
+  SCommitFSetJob job = {
+      .committer = committer,
+      .numOfFSets = taosArrayGetSize(tsdb->commitInfo->arr),
+      .nextFSet = 0,
+      .code = 0,
+  };
+  if (job.numOfFSets == 0) {
+    return 0;
   }
+
+  job.fopArrays = taosMemoryCalloc(job.numOfFSets, sizeof(TFileOpArray));
+  if (job.fopArrays == NULL) {
+    TAOS_CHECK_GOTO(terrno, &lino, _exit);
+  }
+
+  // The committing thread takes file sets as well, so the commit always makes progress even if the helpers can not get
+  // a worker of the pool. Helpers not started when the file sets run out are cancelled.
+  numOfHelpers = TMIN(tsNumOfCommitThreads, job.numOfFSets) - 1;
+  if (numOfHelpers > 0 && (helpers = taosMemoryCalloc(numOfHelpers, sizeof(SVATaskID))) == NULL) {
+    numOfHelpers = 0;
+  }
+  for (int32_t i = 0; i < numOfHelpers; i++) {
+    if (vnodeAsync(COMMIT_TASK_ASYNC, EVA_PRIORITY_HIGH, tsdbCommitFileSetTask, NULL, &job, &helpers[i]) != 0) {
+      numOfHelpers = i;
+      break;
+    }
+  }
+
+  tsdbCommitFileSetsImpl(&job);
+
+  for (int32_t k = 0; k < 2; k++) {
+    for (int32_t i = 0; i < numOfHelpers; i++) {
+      if (k == 0) {
+        (void)vnodeACancel(&helpers[i]);
+      } else {
+        vnodeAWait(&helpers[i]);
+      }
+    }
+  }
+
+  TAOS_CHECK_GOTO(job.code, &lino, _exit);
+
+  // one edit for the whole commit, in the same order as a serial commit produces
+  for (int32_t i = 0; i < job.numOfFSets; i++) {
+    if (TARRAY2_SIZE(&job.fopArrays[i]) > 0) {
+      TAOS_CHECK_GOTO(TARRAY2_APPEND_BATCH(committer->fopArray, TARRAY2_DATA(&job.fopArrays[i]),
+                                           TARRAY2_SIZE(&job.fopArrays[i])),
+                      &lino, _exit);
+    }
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d %s failed at %s:%d since %s", TD_VID(tsdb->pVnode), __func__, __FILE__, lino, tstrerror(code));
+  } else {
+    tsdbDebug("vgId:%d %s done, %d file sets with %d helpers", TD_VID(tsdb->pVnode), __func__, job.numOfFSets,
+              numOfHelpers);
+  }
+  if (job.fopArrays) {
+    for (int32_t i = 0; i < job.numOfFSets; i++) {
+      TARRAY2_DESTROY(&job.fopArrays[i], NULL);
+    }
+    taosMemoryFree(job.fopArrays);
+  }
+  taosMemoryFree(helpers);
   return code;
 }
 
@@ -619,6 +786,8 @@ static int32_t tsdbCloseCommitter(SCommitter2 *committer, int32_t eno) {
   int32_t lino = 0;
 
   if (eno == 0) {
+    METRICS_UPDATE(committer->tsdb->pVnode->writeMetrics.commit_write_bytes, METRIC_LEVEL_HIGH,
+                   tsdbTFileOpArrayWriteSize(committer->fopArray));
     TAOS_CHECK_GOTO(tsdbFSEditBegin(committer->tsdb->pFS, committer->fopArray, TSDB_FEDIT_COMMIT), &lino, _exit);
   } else {
     tsdbError("vgId:%d %s failed at %s:%d since %s", TD_VID(committer->tsdb->pVnode), __func__, __FILE__, lino,
@@ -670,11 +839,7 @@ int32_t tsdbCommitBegin(STsdb *tsdb, SCommitInfo *info) {
 
     TAOS_CHECK_GOTO(tsdbOpenCommitter(tsdb, info, &committer), &lino, _exit);
 
-    for (int32_t i = 0; i < taosArrayGetSize(tsdb->commitInfo->arr); i++) {
-      committer.ctx->info = *(SFileSetCommitInfo **)taosArrayGet(tsdb->commitInfo->arr, i);
-      TAOS_CHECK_GOTO(tsdbCommitFileSet(&committer), &lino, _exit);
-    }
-
+    TAOS_CHECK_GOTO(tsdbCommitFileSets(&committer), &lino, _exit);
     TAOS_CHECK_GOTO(tsdbCloseCommitter(&committer, code), &lino, _exit);
   }
 
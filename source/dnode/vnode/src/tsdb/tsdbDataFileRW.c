@@ -28,14 +28,21 @@ struct SDataFileReader {
     bool tombFooterLoaded;
     bool brinBlkLoaded;
     bool tombBlkLoaded;
+    bool zoneMapBlkLoaded;
+    bool zoneMapBlockLoaded;
   } ctx[1];
 
   STsdbFD *fd[TSDB_FTYPE_MAX];
 
-  SHeadFooter   headFooter[1];
-  STombFooter   tombFooter[1];
-  TBrinBlkArray brinBlkArray[1];
-  TTombBlkArray tombBlkArray[1];
+  SHeadFooter      headFooter[1];
+  STombFooter      tombFooter[1];
+  TBrinBlkArray    brinBlkArray[1];
+  TTombBlkArray    tombBlkArray[1];
+  TZoneMapBlkArray zoneMapBlkArray[1];
+
+  // the zone map block last loaded by tsdbDataFileReadBlockZoneMap
+  int64_t       zoneMapBrinOffset;
+  SZoneMapBlock zoneMapBlock[1];
 };
 
 static int32_t tsdbDataFileReadHeadFooter(SDataFileReader *reader) {
@@ -157,6 +164,8 @@ void tsdbDataFileReaderClose(SDataFileReader **reader) {
 
   TARRAY2_DESTROY(reader[0]->tombBlkArray, NULL);
   TARRAY2_DESTROY(reader[0]->brinBlkArray, NULL);
+  TARRAY2_DESTROY(reader[0]->zoneMapBlkArray, NULL);
+  tZoneMapBlockDestroy(reader[0]->zoneMapBlock);
 
   for (int32_t i = 0; i < TSDB_FTYPE_MAX; ++i) {
     if (reader[0]->fd[i]) {
@@ -299,6 +308,97 @@ _exit:
 
 extern int32_t tBlockDataDecompress(SBufferReader *br, SBlockData *blockData, SBuffer *assist);
 
+int32_t tsdbDataFileReadAhead(SDataFileReader *reader, int64_t offset, int64_t size) {
+  if (reader->fd[TSDB_FTYPE_DATA] == NULL) {
+    return 0;
+  }
+
+  return tsdbReadAheadFile(reader->fd[TSDB_FTYPE_DATA], offset, size);
+}
+
+// Read ahead the data of the columns cids, in ascending order, of a block. Where the columns are is only known from
+// the SDiskDataHdr and SBlockCol parts of the block, which are read here, so the key part of the block should have
+// been read ahead before to keep this from waiting on the disk.
+int32_t tsdbDataFileReadAheadColumns(SDataFileReader *reader, const SBrinRecord *record, const int16_t cids[],
+                                     int32_t ncid) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  SDiskDataHdr hdr;
+  SBuffer     *buffer0 = reader->buffers + 0;
+
+  // files migrated to shared storage are not read ahead, see tsdbReadAheadFile
+  if (ncid <= 0 || reader->fd[TSDB_FTYPE_DATA] == NULL || reader->fd[TSDB_FTYPE_DATA]->lcn > 1) {
+    return 0;
+  }
+
+  int32_t encryptAlgorithm = reader->config->tsdb->pVnode->config.tsdbCfg.encryptAlgorithm;
+  char   *encryptKey = reader->config->tsdb->pVnode->config.tsdbCfg.encryptKey;
+  // SDiskDataHdr
+  tBufferClear(buffer0);
+  TAOS_CHECK_GOTO(tsdbReadFileToBuffer(reader->fd[TSDB_FTYPE_DATA], record->blockOffset, record->blockKeySize, buffer0,
+                                       0, encryptAlgorithm, encryptKey),
+                  &lino, _exit);
+
+  SBufferReader br = BUFFER_READER_INITIALIZER(0, buffer0);
+  TAOS_CHECK_GOTO(tGetDiskDataHdr(&br, &hdr), &lino, _exit);
+  if (hdr.delimiter != TSDB_FILE_DLMT) {
+    TSDB_CHECK_CODE(code = TSDB_CODE_FILE_CORRUPTED, lino, _exit);
+  }
+
+  if (hdr.szBlkCol <= 0) {
+    goto _exit;
+  }
+
+  // SBlockCol part
+  tBufferClear(buffer0);
+  TAOS_CHECK_GOTO(tsdbReadFileToBuffer(reader->fd[TSDB_FTYPE_DATA], record->blockOffset + record->blockKeySize,
+                                       hdr.szBlkCol, buffer0, 0, encryptAlgorithm, encryptKey),
+                  &lino, _exit);
+
+  // the columns are stored in the order of cid, the adjacent ones are merged into one request
+  int64_t   base = record->blockOffset + record->blockKeySize + hdr.szBlkCol;
+  int64_t   offset = 0;
+  int64_t   end = 0;
+  SBlockCol blockCol = {.cid = 0};
+  br = BUFFER_READER_INITIALIZER(0, buffer0);
+  for (int32_t i = 0; i < ncid; i++) {
+    while (cids[i] > blockCol.cid && br.offset < buffer0->size) {
+      TAOS_CHECK_GOTO(tGetBlockCol(&br, &blockCol, hdr.fmtVer, hdr.cmprAlg), &lino, _exit);
+    }
+
+    if (cids[i] != blockCol.cid) {
+      continue;
+    }
+
+    int64_t size = blockCol.szBitmap + blockCol.szOffset + blockCol.szValue;
+    if (size <= 0) {
+      continue;
+    }
+
+    if (end > offset && blockCol.offset == end) {
+      end += size;
+    } else {
+      if (end > offset) {
+        TAOS_CHECK_GOTO(tsdbReadAheadFile(reader->fd[TSDB_FTYPE_DATA], base + offset, end - offset), &lino, _exit);
+      }
+      offset = blockCol.offset;
+      end = blockCol.offset + size;
+    }
+  }
+
+  if (end > offset) {
+    TAOS_CHECK_GOTO(tsdbReadAheadFile(reader->fd[TSDB_FTYPE_DATA], base + offset, end - offset), &lino, _exit);
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d %s failed at %s:%d since %s", TD_VID(reader->config->tsdb->pVnode), __func__, __FILE__, lino,
+              tstrerror(code));
+  }
+  return code;
+}
+
 int32_t tsdbDataFileReadBlockData(SDataFileReader *reader, const SBrinRecord *record, SBlockData *bData) {
   int32_t code = 0;
   int32_t lino = 0;
@@ -336,9 +436,12 @@ _exit:
 
 int32_t tsdbDataFileReadBlockDataByColumn(SDataFileReader *reader, const SBrinRecord *record, SBlockData *bData,
                                           STSchema *pTSchema, int16_t cids[], int32_t ncid) {
-  int32_t code = 0;
-  int32_t lino = 0;
-  int32_t fid = reader->config->files[TSDB_FTYPE_DATA].file.fid;
+  int32_t     code = 0;
+  int32_t     lino = 0;
+  STsdb      *tsdb = reader->config->tsdb;
+  int32_t     fid = reader->config->files[TSDB_FTYPE_DATA].file.fid;
+  int64_t     commitId = reader->config->files[TSDB_FTYPE_DATA].file.cid;
+  LRUHandle **aHandle = NULL;
 
   SDiskDataHdr hdr;
   SBuffer     *buffer0 = reader->buffers + 0;
@@ -389,6 +492,30 @@ int32_t tsdbDataFileReadBlockDataByColumn(SDataFileReader *reader, const SBrinRe
     goto _exit;
   }
 
+  // the value columns decoded by other queries, the key part above is always read from the file
+  if (tsdb->dCache != NULL) {
+    int32_t nMiss = 0;
+
+    aHandle = taosMemoryCalloc(ncid, sizeof(LRUHandle *));
+    TSDB_CHECK_NULL(aHandle, code, lino, _exit, terrno);
+
+    for (int32_t i = extraColIdx; i < ncid; i++) {
+      if (tBlockDataGetColData(bData, cids[i]) == NULL) {
+        aHandle[i] = tsdbCacheGetColData(tsdb, fid, commitId, record->blockOffset, cids[i]);
+        nMiss += (aHandle[i] == NULL);
+      }
+    }
+
+    if (nMiss == 0) {
+      for (int32_t i = extraColIdx; i < ncid; i++) {
+        if (aHandle[i] != NULL) {
+          TAOS_CHECK_GOTO(tsdbCacheCopyColData(tsdb, aHandle[i], bData), &lino, _exit);
+        }
+      }
+      goto _exit;
+    }
+  }
+
   // load SBlockCol part
   tBufferClear(buffer0);
   TAOS_CHECK_GOTO(tsdbReadFileToBuffer(reader->fd[TSDB_FTYPE_DATA], record->blockOffset + record->blockKeySize,
@@ -473,6 +600,11 @@ int32_t tsdbDataFileReadBlockDataByColumn(SDataFileReader *reader, const SBrinRe
       continue;
     }
 
+    if (aHandle != NULL && aHandle[i] != NULL) {
+      TAOS_CHECK_GOTO(tsdbCacheCopyColData(tsdb, aHandle[i], bData), &lino, _exit);
+      continue;
+    }
+
     while (cid > blockCol.cid) {
       if (br.offset >= buffer0->size) {
         blockCol.cid = INT16_MAX;
@@ -513,6 +645,8 @@ int32_t tsdbDataFileReadBlockDataByColumn(SDataFileReader *reader, const SBrinRe
       // decode the buffer
       SBufferReader br1 = BUFFER_READER_INITIALIZER(0, buffer1);
       TAOS_CHECK_GOTO(tBlockDataDecompressColData(&hdr, &blockCol, &br1, bData, assist), &lino, _exit);
+
+      tsdbCachePutColData(tsdb, fid, commitId, record->blockOffset, &bData->aColData[bData->nColData - 1]);
     }
   }
 
@@ -521,6 +655,14 @@ _exit:
     tsdbError("vgId:%d %s fid:%d failed at %s:%d since %s", TD_VID(reader->config->tsdb->pVnode), __func__, fid,
               __FILE__, lino, tstrerror(code));
   }
+  if (aHandle != NULL) {
+    for (int32_t i = 0; i < ncid; i++) {
+      if (aHandle[i] != NULL) {
+        tsdbCacheRelease(tsdb->dCache, aHandle[i]);
+      }
+    }
+    taosMemoryFree(aHandle);
+  }
   return code;
 }
 
@@ -563,6 +705,139 @@ _exit:
   return code;
 }
 
+int32_t tsdbDataFileReadZoneMapBlk(SDataFileReader *reader, const TZoneMapBlkArray **zoneMapBlkArray) {
+  int32_t code = 0;
+  int32_t lino = 0;
+  void   *data = NULL;
+
+  if (!reader->ctx->zoneMapBlkLoaded) {
+    TAOS_CHECK_GOTO(tsdbDataFileReadHeadFooter(reader), &lino, _exit);
+
+    if (reader->headFooter->zoneMapBlkPtr->size > 0) {
+      data = taosMemoryMalloc(reader->headFooter->zoneMapBlkPtr->size);
+      if (data == NULL) {
+        TAOS_CHECK_GOTO(terrno, &lino, _exit);
+      }
+
+      int32_t encryptAlgorithm = reader->config->tsdb->pVnode->config.tsdbCfg.encryptAlgorithm;
+      char   *encryptKey = reader->config->tsdb->pVnode->config.tsdbCfg.encryptKey;
+
+      TAOS_CHECK_GOTO(tsdbReadFile(reader->fd[TSDB_FTYPE_HEAD], reader->headFooter->zoneMapBlkPtr->offset, data,
+                                   reader->headFooter->zoneMapBlkPtr->size, 0, encryptAlgorithm, encryptKey),
+                      &lino, _exit);
+
+      int32_t size = reader->headFooter->zoneMapBlkPtr->size / sizeof(SZoneMapBlk);
+      TARRAY2_INIT_EX(reader->zoneMapBlkArray, size, size, data);
+    } else {
+      TARRAY2_INIT(reader->zoneMapBlkArray);
+    }
+
+    reader->ctx->zoneMapBlkLoaded = true;
+  }
+  zoneMapBlkArray[0] = reader->zoneMapBlkArray;
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d %s failed at %s:%d since %s", TD_VID(reader->config->tsdb->pVnode), __func__, __FILE__, lino,
+              tstrerror(code));
+    taosMemoryFree(data);
+  }
+  return code;
+}
+
+static int32_t tsdbZoneMapBlkCmprFn(const void *p1, const void *p2) {
+  int64_t brinOffset = *(const int64_t *)p1;
+  int64_t brinOffset2 = ((const SZoneMapBlk *)p2)->brinOffset;
+  if (brinOffset < brinOffset2) return -1;
+  if (brinOffset > brinOffset2) return 1;
+  return 0;
+}
+
+// the zone map block of the brin block at brinOffset, left empty if the file or the brin block has none
+int32_t tsdbDataFileReadZoneMapBlock(SDataFileReader *reader, int64_t brinOffset, SZoneMapBlock *zoneMapBlock) {
+  int32_t                 code = 0;
+  int32_t                 lino = 0;
+  const TZoneMapBlkArray *zoneMapBlkArray = NULL;
+  SBuffer                *buffer = reader->buffers + 0;
+
+  tZoneMapBlockClear(zoneMapBlock);
+
+  TAOS_CHECK_GOTO(tsdbDataFileReadZoneMapBlk(reader, &zoneMapBlkArray), &lino, _exit);
+
+  const SZoneMapBlk *zoneMapBlk =
+      taosbsearch(&brinOffset, TARRAY2_DATA(zoneMapBlkArray), TARRAY2_SIZE(zoneMapBlkArray), sizeof(SZoneMapBlk),
+                  tsdbZoneMapBlkCmprFn, TD_EQ);
+  if (zoneMapBlk == NULL) {
+    goto _exit;
+  }
+
+  uint32_t szOffsets = zoneMapBlk->numRec * sizeof(int32_t);
+  if (zoneMapBlk->numRec < 0 || zoneMapBlk->dp->size < szOffsets) {
+    TSDB_CHECK_CODE(code = TSDB_CODE_FILE_CORRUPTED, lino, _exit);
+  }
+
+  int32_t encryptAlgorithm = reader->config->tsdb->pVnode->config.tsdbCfg.encryptAlgorithm;
+  char   *encryptKey = reader->config->tsdb->pVnode->config.tsdbCfg.encryptKey;
+
+  tBufferClear(buffer);
+  TAOS_CHECK_GOTO(tsdbReadFileToBuffer(reader->fd[TSDB_FTYPE_HEAD], zoneMapBlk->dp->offset, zoneMapBlk->dp->size,
+                                       buffer, 0, encryptAlgorithm, encryptKey),
+                  &lino, _exit);
+
+  TAOS_CHECK_GOTO(tBufferPut(&zoneMapBlock->offsets, buffer->data, szOffsets), &lino, _exit);
+  TAOS_CHECK_GOTO(tBufferPut(&zoneMapBlock->data, tBufferGetDataAt(buffer, szOffsets), buffer->size - szOffsets),
+                  &lino, _exit);
+  zoneMapBlock->numOfRecords = zoneMapBlk->numRec;
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d %s failed at %s:%d since %s", TD_VID(reader->config->tsdb->pVnode), __func__, __FILE__, lino,
+              tstrerror(code));
+    tZoneMapBlockClear(zoneMapBlock);
+  }
+  return code;
+}
+
+int32_t tsdbDataFileReadBlockZoneMap(SDataFileReader *reader, int64_t brinOffset, int32_t idx,
+                                     TColumnDataAggArray *columnDataAggArray) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  TARRAY2_CLEAR(columnDataAggArray, NULL);
+
+  // blocks are visited in the order of the brin records, so the decoded zone map block is kept for the next call
+  if (!reader->ctx->zoneMapBlockLoaded || reader->zoneMapBrinOffset != brinOffset) {
+    reader->ctx->zoneMapBlockLoaded = false;
+    TAOS_CHECK_GOTO(tsdbDataFileReadZoneMapBlock(reader, brinOffset, reader->zoneMapBlock), &lino, _exit);
+    reader->zoneMapBrinOffset = brinOffset;
+    reader->ctx->zoneMapBlockLoaded = true;
+  }
+
+  if (idx >= reader->zoneMapBlock->numOfRecords) {
+    goto _exit;
+  }
+
+  const void *entry = NULL;
+  uint32_t    size = 0;
+  TAOS_CHECK_GOTO(tZoneMapBlockGet(reader->zoneMapBlock, idx, &entry, &size), &lino, _exit);
+
+  SBuffer       buffer = {.size = size, .capacity = size, .data = (void *)entry};
+  SBufferReader br = BUFFER_READER_INITIALIZER(0, &buffer);
+  while (br.offset < size) {
+    SColumnDataAgg agg[1];
+
+    TAOS_CHECK_GOTO(tGetZoneMapColumn(&br, agg), &lino, _exit);
+    TAOS_CHECK_GOTO(TARRAY2_APPEND_PTR(columnDataAggArray, agg), &lino, _exit);
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d %s failed at %s:%d since %s", TD_VID(reader->config->tsdb->pVnode), __func__, __FILE__, lino,
+              tstrerror(code));
+  }
+  return code;
+}
+
 int32_t tsdbDataFileReadTombBlk(SDataFileReader *reader, const TTombBlkArray **tombBlkArray) {
   int32_t code = 0;
   int32_t lino = 0;
@@ -659,6 +934,7 @@ struct SDataFileWriter {
     int32_t              brinBlkArrayIdx;
     SBrinBlock           brinBlock[1];
     int32_t              brinBlockIdx;
+    SZoneMapBlock        zoneMapBlock[1];
     SBlockData           blockData[1];
     int32_t              blockDataIdx;
     // for tomb data
@@ -678,9 +954,11 @@ struct SDataFileWriter {
   SHeadFooter headFooter[1];
   STombFooter tombFooter[1];
 
-  TBrinBlkArray brinBlkArray[1];
-  SBrinBlock    brinBlock[1];
-  SBlockData    blockData[1];
+  TBrinBlkArray    brinBlkArray[1];
+  SBrinBlock       brinBlock[1];
+  TZoneMapBlkArray zoneMapBlkArray[1];
+  SZoneMapBlock    zoneMapBlock[1];
+  SBlockData       blockData[1];
 
   TTombBlkArray tombBlkArray[1];
   STombBlock    tombBlock[1];
@@ -700,11 +978,14 @@ static void tsdbDataFileWriterDoClose(SDataFileWriter *writer) {
   tTombBlockDestroy(writer->tombBlock);
   TARRAY2_DESTROY(writer->tombBlkArray, NULL);
   tBlockDataDestroy(writer->blockData);
+  tZoneMapBlockDestroy(writer->zoneMapBlock);
+  TARRAY2_DESTROY(writer->zoneMapBlkArray, NULL);
   tBrinBlockDestroy(writer->brinBlock);
   TARRAY2_DESTROY(writer->brinBlkArray, NULL);
 
   tTombBlockDestroy(writer->ctx->tombBlock);
   tBlockDataDestroy(writer->ctx->blockData);
+  tZoneMapBlockDestroy(writer->ctx->zoneMapBlock);
   tBrinBlockDestroy(writer->ctx->brinBlock);
 
   for (int32_t i = 0; i < ARRAY_SIZE(writer->local); ++i) {
@@ -957,6 +1238,37 @@ int32_t tsdbFileWriteBrinBlock(STsdbFD *fd, SBrinBlock *brinBlock, uint32_t cmpr
   return 0;
 }
 
+int32_t tsdbFileWriteZoneMapBlock(STsdbFD *fd, SZoneMapBlock *zoneMapBlock, int64_t brinOffset, int64_t *fileSize,
+                                  TZoneMapBlkArray *zoneMapBlkArray, int32_t encryptAlgorithm, char *encryptKey) {
+  if (zoneMapBlock->data.size == 0) {
+    // no block of the brin block has a zone map, nothing to write
+    tZoneMapBlockClear(zoneMapBlock);
+    return 0;
+  }
+
+  SZoneMapBlk zoneMapBlk = {
+      .dp[0] =
+          {
+              .offset = *fileSize,
+              .size = zoneMapBlock->offsets.size + zoneMapBlock->data.size,
+          },
+      .brinOffset = brinOffset,
+      .numRec = zoneMapBlock->numOfRecords,
+  };
+
+  TAOS_CHECK_RETURN(tsdbWriteFile(fd, *fileSize, zoneMapBlock->offsets.data, zoneMapBlock->offsets.size,
+                                  encryptAlgorithm, encryptKey));
+  *fileSize += zoneMapBlock->offsets.size;
+  TAOS_CHECK_RETURN(
+      tsdbWriteFile(fd, *fileSize, zoneMapBlock->data.data, zoneMapBlock->data.size, encryptAlgorithm, encryptKey));
+  *fileSize += zoneMapBlock->data.size;
+
+  TAOS_CHECK_RETURN(TARRAY2_APPEND_PTR(zoneMapBlkArray, &zoneMapBlk));
+
+  tZoneMapBlockClear(zoneMapBlock);
+  return 0;
+}
+
 static int32_t tsdbDataFileWriteBrinBlock(SDataFileWriter *writer) {
   if (writer->brinBlock->numOfRecords == 0) {
     return 0;
@@ -967,11 +1279,16 @@ static int32_t tsdbDataFileWriteBrinBlock(SDataFileWriter *writer) {
 
   int32_t encryptAlgorithm = writer->config->tsdb->pVnode->config.tsdbCfg.encryptAlgorithm;
   char   *encryptKey = writer->config->tsdb->pVnode->config.tsdbCfg.encryptKey;
+  int64_t brinOffset = writer->files[TSDB_FTYPE_HEAD].size;
 
   TAOS_CHECK_GOTO(tsdbFileWriteBrinBlock(writer->fd[TSDB_FTYPE_HEAD], writer->brinBlock, writer->config->cmprAlg,
                                          &writer->files[TSDB_FTYPE_HEAD].size, writer->brinBlkArray, writer->buffers,
                                          &writer->ctx->range, encryptAlgorithm, encryptKey),
                   &lino, _exit);
+  TAOS_CHECK_GOTO(tsdbFileWriteZoneMapBlock(writer->fd[TSDB_FTYPE_HEAD], writer->zoneMapBlock, brinOffset,
+                                            &writer->files[TSDB_FTYPE_HEAD].size, writer->zoneMapBlkArray,
+                                            encryptAlgorithm, encryptKey),
+                  &lino, _exit);
 
 _exit:
   if (code) {
@@ -981,7 +1298,8 @@ _exit:
   return code;
 }
 
-static int32_t tsdbDataFileWriteBrinRecord(SDataFileWriter *writer, const SBrinRecord *record) {
+static int32_t tsdbDataFileWriteBrinRecord(SDataFileWriter *writer, const SBrinRecord *record, const void *zoneMap,
+                                           uint32_t szZoneMap) {
   int32_t code = 0;
   int32_t lino = 0;
 
@@ -996,6 +1314,7 @@ static int32_t tsdbDataFileWriteBrinRecord(SDataFileWriter *writer, const SBrinR
     }
     break;
   }
+  TAOS_CHECK_GOTO(tZoneMapBlockPut(writer->zoneMapBlock, zoneMap, szZoneMap), &lino, _exit);
 
   if ((writer->brinBlock->numOfRecords) >= 256) {
     TAOS_CHECK_GOTO(tsdbDataFileWriteBrinBlock(writer), &lino, _exit);
@@ -1009,6 +1328,43 @@ _exit:
   return code;
 }
 
+// a record of the existing file is kept as it is, so is its zone map
+static int32_t tsdbDataFileWriteOldBrinRecord(SDataFileWriter *writer, const SBrinRecord *record) {
+  const void *zoneMap = NULL;
+  uint32_t    szZoneMap = 0;
+
+  if (writer->ctx->brinBlockIdx < writer->ctx->zoneMapBlock->numOfRecords) {
+    TAOS_CHECK_RETURN(tZoneMapBlockGet(writer->ctx->zoneMapBlock, writer->ctx->brinBlockIdx, &zoneMap, &szZoneMap));
+  }
+  return tsdbDataFileWriteBrinRecord(writer, record, zoneMap, szZoneMap);
+}
+
+int32_t tsdbBlockDataPutAgg(SBlockData *bData, SBuffer *sma, SBuffer *zoneMap) {
+  tBufferClear(sma);
+  tBufferClear(zoneMap);
+  for (int32_t i = 0; i < bData->nColData; ++i) {
+    SColData *colData = bData->aColData + i;
+    if ((colData->cflag & COL_SMA_ON) == 0) continue;
+
+    if ((colData->flag & HAS_VALUE) == 0) {
+      if (ZONE_MAP_TYPE_VALID(colData->type)) {
+        SColumnDataAgg nullAgg[1] = {{.colId = colData->cid, .numOfNull = bData->nRow}};
+        TAOS_CHECK_RETURN(tPutZoneMapColumn(zoneMap, nullAgg));
+      }
+      continue;
+    }
+
+    SColumnDataAgg colAgg[1] = {{.colId = colData->cid}};
+    tColDataCalcSMA[colData->type](colData, colAgg);
+
+    TAOS_CHECK_RETURN(tPutColumnDataAgg(sma, colAgg));
+    if (ZONE_MAP_TYPE_VALID(colData->type)) {
+      TAOS_CHECK_RETURN(tPutZoneMapColumn(zoneMap, colAgg));
+    }
+  }
+  return 0;
+}
+
 static int32_t tsdbDataFileDoWriteBlockData(SDataFileWriter *writer, SBlockData *bData) {
   if (bData->nRow == 0) {
     return 0;
@@ -1023,7 +1379,8 @@ static int32_t tsdbDataFileDoWriteBlockData(SDataFileWriter *writer, SBlockData
   SBuffer *buffers = writer->buffers;
   SBuffer *assist = writer->buffers + 4;
 
-  SColCompressInfo cmprInfo = {.pColCmpr = NULL, .defaultCmprAlg = writer->config->cmprAlg};
+  // data file blocks are cold, pay for a trial compression to pick the L2 codec of "auto" columns
+  SColCompressInfo cmprInfo = {.pColCmpr = NULL, .defaultCmprAlg = writer->config->cmprAlg, .trialCmpr = true};
 
   SBrinRecord record[1] = {{
       .suid = bData->suid,
@@ -1076,17 +1433,9 @@ static int32_t tsdbDataFileDoWriteBlockData(SDataFileWriter *writer, SBlockData
     writer->files[TSDB_FTYPE_DATA].size += buffers[i].size;
   }
 
-  // to .sma file
-  tBufferClear(&buffers[0]);
-  for (int32_t i = 0; i < bData->nColData; ++i) {
-    SColData *colData = bData->aColData + i;
-    if ((colData->cflag & COL_SMA_ON) == 0 || ((colData->flag & HAS_VALUE) == 0)) continue;
-
-    SColumnDataAgg sma[1] = {{.colId = colData->cid}};
-    tColDataCalcSMA[colData->type](colData, sma);
-
-    TAOS_CHECK_GOTO(tPutColumnDataAgg(&buffers[0], sma), &lino, _exit);
-  }
+  // to .sma file, and the zone map to .head file
+  SBuffer *zoneMap = &buffers[5];
+  TAOS_CHECK_GOTO(tsdbBlockDataPutAgg(bData, &buffers[0], zoneMap), &lino, _exit);
   record->smaSize = buffers[0].size;
 
   if (record->smaSize > 0) {
@@ -1097,7 +1446,7 @@ static int32_t tsdbDataFileDoWriteBlockData(SDataFileWriter *writer, SBlockData
   }
 
   // append SBrinRecord
-  TAOS_CHECK_GOTO(tsdbDataFileWriteBrinRecord(writer, record), &lino, _exit);
+  TAOS_CHECK_GOTO(tsdbDataFileWriteBrinRecord(writer, record, zoneMap->data, zoneMap->size), &lino, _exit);
 
   tBlockDataClear(bData);
 
@@ -1203,7 +1552,7 @@ static int32_t tsdbDataFileDoWriteTableOldData(SDataFileWriter *writer, const ST
               TAOS_CHECK_GOTO(tsdbDataFileDoWriteBlockData(writer, writer->blockData), &lino, _exit);
             }
 
-            TAOS_CHECK_GOTO(tsdbDataFileWriteBrinRecord(writer, record), &lino, _exit);
+            TAOS_CHECK_GOTO(tsdbDataFileWriteOldBrinRecord(writer, record), &lino, _exit);
           } else {
             TAOS_CHECK_GOTO(tsdbDataFileReadBlockData(writer->ctx->reader, record, writer->ctx->blockData), &lino,
                             _exit);
@@ -1230,6 +1579,9 @@ static int32_t tsdbDataFileDoWriteTableOldData(SDataFileWriter *writer, const ST
       }
 
       TAOS_CHECK_GOTO(tsdbDataFileReadBrinBlock(writer->ctx->reader, brinBlk, writer->ctx->brinBlock), &lino, _exit);
+      TAOS_CHECK_GOTO(
+          tsdbDataFileReadZoneMapBlock(writer->ctx->reader, brinBlk->dp->offset, writer->ctx->zoneMapBlock), &lino,
+          _exit);
 
       writer->ctx->brinBlockIdx = 0;
       writer->ctx->brinBlkArrayIdx++;
@@ -1320,7 +1672,7 @@ static int32_t tsdbDataFileWriteTableDataBegin(SDataFileWriter *writer, const TA
           }
         }
 
-        TAOS_CHECK_GOTO(tsdbDataFileWriteBrinRecord(writer, &record), &lino, _exit);
+        TAOS_CHECK_GOTO(tsdbDataFileWriteOldBrinRecord(writer, &record), &lino, _exit);
       }
     }
 
@@ -1331,6 +1683,9 @@ static int32_t tsdbDataFileWriteTableDataBegin(SDataFileWriter *writer, const TA
       const SBrinBlk *brinBlk = TARRAY2_GET_PTR(writer->ctx->brinBlkArray, writer->ctx->brinBlkArrayIdx);
 
       TAOS_CHECK_GOTO(tsdbDataFileReadBrinBlock(writer->ctx->reader, brinBlk, writer->ctx->brinBlock), &lino, _exit);
+      TAOS_CHECK_GOTO(
+          tsdbDataFileReadZoneMapBlock(writer->ctx->reader, brinBlk->dp->offset, writer->ctx->zoneMapBlock), &lino,
+          _exit);
 
       writer->ctx->brinBlockIdx = 0;
       writer->ctx->brinBlkArrayIdx++;
@@ -1639,6 +1994,41 @@ _exit:
   return code;
 }
 
+int32_t tsdbFileWriteZoneMapBlk(STsdbFD *fd, TZoneMapBlkArray *zoneMapBlkArray, SFDataPtr *ptr, int64_t *fileSize,
+                                int32_t encryptAlgorithm, char *encryptKey) {
+  ptr->offset = *fileSize;
+  ptr->size = TARRAY2_DATA_LEN(zoneMapBlkArray);
+  if (ptr->size == 0) {
+    return 0;
+  }
+
+  TAOS_CHECK_RETURN(tsdbWriteFile(fd, ptr->offset, (uint8_t *)TARRAY2_DATA(zoneMapBlkArray), ptr->size,
+                                  encryptAlgorithm, encryptKey));
+
+  *fileSize += ptr->size;
+  return 0;
+}
+
+static int32_t tsdbDataFileWriteZoneMapBlk(SDataFileWriter *writer) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  int32_t encryptAlgorithm = writer->config->tsdb->pVnode->config.tsdbCfg.encryptAlgorithm;
+  char   *encryptKey = writer->config->tsdb->pVnode->config.tsdbCfg.encryptKey;
+
+  TAOS_CHECK_GOTO(tsdbFileWriteZoneMapBlk(writer->fd[TSDB_FTYPE_HEAD], writer->zoneMapBlkArray,
+                                          writer->headFooter->zoneMapBlkPtr, &writer->files[TSDB_FTYPE_HEAD].size,
+                                          encryptAlgorithm, encryptKey),
+                  &lino, _exit);
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d %s failed at %s:%d since %s", TD_VID(writer->config->tsdb->pVnode), __func__, __FILE__, lino,
+              tstrerror(code));
+  }
+  return code;
+}
+
 void tsdbTFileUpdVerRange(STFile *f, SVersionRange range) {
   f->minVer = TMIN(f->minVer, range.minVer);
   f->maxVer = TMAX(f->maxVer, range.maxVer);
@@ -1661,6 +2051,7 @@ static int32_t tsdbDataFileWriterCloseCommit(SDataFileWriter *writer, TFileOpArr
     TAOS_CHECK_GOTO(tsdbDataFileWriteTableDataBegin(writer, tbid), &lino, _exit);
     TAOS_CHECK_GOTO(tsdbDataFileWriteBrinBlock(writer), &lino, _exit);
     TAOS_CHECK_GOTO(tsdbDataFileWriteBrinBlk(writer), &lino, _exit);
+    TAOS_CHECK_GOTO(tsdbDataFileWriteZoneMapBlk(writer), &lino, _exit);
     TAOS_CHECK_GOTO(tsdbDataFileWriteHeadFooter(writer), &lino, _exit);
 
     SVersionRange ofRange = {.minVer = VERSION_MAX, .maxVer = VERSION_MIN};
@@ -1763,11 +2154,9 @@ static int32_t tsdbDataFileWriterCloseCommit(SDataFileWriter *writer, TFileOpArr
   }
   int32_t encryptAlgorithm = writer->config->tsdb->pVnode->config.tsdbCfg.encryptAlgorithm;
   char   *encryptKey = writer->config->tsdb->pVnode->config.tsdbCfg.encryptKey;
+  TAOS_CHECK_GOTO(tsdbFsyncFiles(writer->fd, TSDB_FTYPE_MAX, encryptAlgorithm, encryptKey), &lino, _exit);
   for (int32_t i = 0; i < TSDB_FTYPE_MAX; ++i) {
-    if (writer->fd[i]) {
-      TAOS_CHECK_GOTO(tsdbFsyncFile(writer->fd[i], encryptAlgorithm, encryptKey), &lino, _exit);
-      tsdbCloseFile(&writer->fd[i]);
-    }
+    tsdbCloseFile(&writer->fd[i]);
   }
 
 _exit:
@@ -29,7 +29,8 @@ typedef TARRAY2(SColumnDataAgg) TColumnDataAggArray;
 
 typedef struct {
   SFDataPtr brinBlkPtr[1];
-  char      rsrvd[32];
+  SFDataPtr zoneMapBlkPtr[1];  // zero in files written without zone map
+  char      rsrvd[16];
 } SHeadFooter;
 
 typedef struct {
@@ -55,7 +56,14 @@ void    tsdbDataFileReaderClose(SDataFileReader **reader);
 // .head
 int32_t tsdbDataFileReadBrinBlk(SDataFileReader *reader, const TBrinBlkArray **brinBlkArray);
 int32_t tsdbDataFileReadBrinBlock(SDataFileReader *reader, const SBrinBlk *brinBlk, SBrinBlock *brinBlock);
+int32_t tsdbDataFileReadZoneMapBlk(SDataFileReader *reader, const TZoneMapBlkArray **zoneMapBlkArray);
+int32_t tsdbDataFileReadZoneMapBlock(SDataFileReader *reader, int64_t brinOffset, SZoneMapBlock *zoneMapBlock);
+int32_t tsdbDataFileReadBlockZoneMap(SDataFileReader *reader, int64_t brinOffset, int32_t idx,
+                                     TColumnDataAggArray *columnDataAggArray);
 // .data
+int32_t tsdbDataFileReadAhead(SDataFileReader *reader, int64_t offset, int64_t size);
+int32_t tsdbDataFileReadAheadColumns(SDataFileReader *reader, const SBrinRecord *record, const int16_t cids[],
+                                     int32_t ncid);
 int32_t tsdbDataFileReadBlockData(SDataFileReader *reader, const SBrinRecord *record, SBlockData *bData);
 int32_t tsdbDataFileReadBlockDataByColumn(SDataFileReader *reader, const SBrinRecord *record, SBlockData *bData,
                                           STSchema *pTSchema, int16_t cids[], int32_t ncid);
@@ -94,6 +102,8 @@ int32_t tsdbDataFileWriterClose(SDataFileWriter **writer, bool abort, TFileOpArr
 int32_t tsdbDataFileWriteRow(SDataFileWriter *writer, SRowInfo *row);
 int32_t tsdbDataFileWriteBlockData(SDataFileWriter *writer, SBlockData *bData);
 int32_t tsdbDataFileFlush(SDataFileWriter *writer);
+// the SMA of the columns with SMA on to sma, and the zone map entry of the block to zoneMap
+int32_t tsdbBlockDataPutAgg(SBlockData *bData, SBuffer *sma, SBuffer *zoneMap);
 
 // head
 int32_t tsdbFileWriteBrinBlock(STsdbFD *fd, SBrinBlock *brinBlock, uint32_t cmprAlg, int64_t *fileSize,
@@ -101,6 +111,10 @@ int32_t tsdbFileWriteBrinBlock(STsdbFD *fd, SBrinBlock *brinBlock, uint32_t cmpr
                                int32_t encryptAlgorithm, char *encryptKey);
 int32_t tsdbFileWriteBrinBlk(STsdbFD *fd, TBrinBlkArray *brinBlkArray, SFDataPtr *ptr, int64_t *fileSize,
                              int32_t encryptAlgorithm, char *encryptKey);
+int32_t tsdbFileWriteZoneMapBlock(STsdbFD *fd, SZoneMapBlock *zoneMapBlock, int64_t brinOffset, int64_t *fileSize,
+                                  TZoneMapBlkArray *zoneMapBlkArray, int32_t encryptAlgorithm, char *encryptKey);
+int32_t tsdbFileWriteZoneMapBlk(STsdbFD *fd, TZoneMapBlkArray *zoneMapBlkArray, SFDataPtr *ptr, int64_t *fileSize,
+                                int32_t encryptAlgorithm, char *encryptKey);
 int32_t tsdbFileWriteHeadFooter(STsdbFD *fd, int64_t *fileSize, const SHeadFooter *footer, int32_t encryptAlgorithm,
                                 char *encryptKey);
 
@@ -40,12 +40,15 @@ extern int32_t tsdbReadFile(STsdbFD *pFD, int64_t offset, uint8_t *pBuf, int64_t
                             int32_t encryptAlgorithm, char *encryptKey);
 extern int32_t tsdbReadFileToBuffer(STsdbFD *pFD, int64_t offset, int64_t size, SBuffer *buffer, int64_t szHint,
                                     int32_t encryptAlgorithm, char *encryptKey);
+extern int32_t tsdbReadAheadFile(STsdbFD *pFD, int64_t offset, int64_t size);
 extern int32_t tsdbFsyncFile(STsdbFD *pFD, int32_t encryptAlgorithm, char *encryptKey);
+extern int32_t tsdbFsyncFiles(STsdbFD *pFDs[], int32_t nFD, int32_t encryptAlgorithm, char *encryptKey);
 
 typedef struct SColCompressInfo SColCompressInfo;
 struct SColCompressInfo {
   SHashObj *pColCmpr;
   uint32_t  defaultCmprAlg;
+  bool      trialCmpr;  // resolve "auto" L2 by trial compression, otherwise fall back to lz4
 };
 typedef struct SColCompressInfo2 SColCompressInfo2;
 struct SColCompressInfo2 {
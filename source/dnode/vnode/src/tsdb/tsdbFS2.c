@@ -461,6 +461,13 @@ static int32_t tsdbFSCreateFileObjHash(STFileSystem *fs, STFileHash *hash) {
         TSDB_CHECK_CODE(code, lino, _exit);
       }
     }
+
+    // the copied part of a file being migrated
+    if (fset->rtnCkpt.offset > 0) {
+      tsdbTFileName(fs->tsdb, fset->rtnCkpt.nf, fname);
+      code = tsdbFSAddEntryToFileObjHash(hash, fname);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
   }
 
 _exit:
@@ -731,6 +738,8 @@ static int32_t edit_fs(STFileSystem *fs, const TFileOpArray *opArray, EFEditT et
   while (i < TARRAY2_SIZE(fsetArray)) {
     fset = TARRAY2_GET(fsetArray, i);
 
+    tsdbTFileSetCheckCkpt(fset);
+
     SSttLvl *lvl;
     int32_t  j = 0;
     while (j < TARRAY2_SIZE(fset->lvlArr)) {
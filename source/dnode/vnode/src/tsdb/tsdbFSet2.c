@@ -47,6 +47,7 @@ static int32_t tsdbSttLvlInitEx(STsdb *pTsdb, const SSttLvl *lvl1, SSttLvl **lvl
       tsdbSttLvlClear(lvl);
       return code;
     }
+    fobj->nRead = atomic_load_64((int64_t *)&fobj1->nRead);
 
     code = TARRAY2_APPEND(lvl[0]->fobjArr, fobj);
     if (code) {
@@ -286,6 +287,30 @@ int32_t tsdbTFileSetToJson(const STFileSet *fset, cJSON *json) {
     return TSDB_CODE_OUT_OF_MEMORY;
   }
 
+  // retention checkpoint
+  if (fset->rtnCkpt.offset > 0) {
+    item1 = cJSON_AddObjectToObject(json, "rtn ckpt");
+    if (item1 == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+
+    if (cJSON_AddNumberToObject(item1, "ftype", fset->rtnCkpt.of->type) == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    if (cJSON_AddNumberToObject(item1, "offset", fset->rtnCkpt.offset) == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    item2 = cJSON_AddObjectToObject(item1, "of");
+    if (item2 == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+    code = tsdbTFileToJson(fset->rtnCkpt.of, item2);
+    if (code) return code;
+
+    item2 = cJSON_AddObjectToObject(item1, "nf");
+    if (item2 == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+    code = tsdbTFileToJson(fset->rtnCkpt.nf, item2);
+    if (code) return code;
+  }
+
   return 0;
 }
 
@@ -359,6 +384,20 @@ int32_t tsdbJsonToTFileSet(STsdb *pTsdb, const cJSON *json, STFileSet **fset) {
     (*fset)->lastMigrate = 0;
   }
 
+  // retention checkpoint, a bad one only makes the migration start over
+  item1 = cJSON_GetObjectItem(json, "rtn ckpt");
+  if (cJSON_IsObject(item1)) {
+    STFileCkpt   ckpt = {0};
+    const cJSON *item3 = cJSON_GetObjectItem(item1, "ftype");
+    item2 = cJSON_GetObjectItem(item1, "offset");
+    if (cJSON_IsNumber(item2) && cJSON_IsNumber(item3) &&
+        tsdbJsonToTFile(cJSON_GetObjectItem(item1, "of"), item3->valuedouble, ckpt.of) == 0 &&
+        tsdbJsonToTFile(cJSON_GetObjectItem(item1, "nf"), item3->valuedouble, ckpt.nf) == 0) {
+      ckpt.offset = item2->valuedouble;
+      (*fset)->rtnCkpt = ckpt;
+    }
+  }
+
   return 0;
 }
 
@@ -401,6 +440,10 @@ int32_t tsdbTFileSetEdit(STsdb *pTsdb, STFileSet *fset, const STFileOp *op) {
       if (code) return code;
       fset->farr[op->of.type] = NULL;
     }
+  } else if (op->optype == TSDB_FOP_CKPT) {
+    fset->rtnCkpt.of[0] = op->of;
+    fset->rtnCkpt.nf[0] = op->nf;
+    fset->rtnCkpt.offset = op->offset;
   } else {
     if (op->nf.type == TSDB_FTYPE_STT) {
       SSttLvl *lvl = tsdbTFileSetGetSttLvl(fset, op->of.stt->level);
@@ -504,6 +547,7 @@ int32_t tsdbTFileSetApplyEdit(STsdb *pTsdb, const STFileSet *fset1, STFileSet *f
   fset2->lastCompact = fset1->lastCompact;
   fset2->lastCommit = fset1->lastCommit;
   fset2->lastMigrate = fset1->lastMigrate;
+  fset2->rtnCkpt = fset1->rtnCkpt;
 
   return 0;
 }
@@ -563,6 +607,7 @@ int32_t tsdbTFileSetInitCopy(STsdb *pTsdb, const STFileSet *fset1, STFileSet **f
   (*fset)->lastCompact = fset1->lastCompact;
   (*fset)->lastCommit = fset1->lastCommit;
   (*fset)->lastMigrate = fset1->lastMigrate;
+  (*fset)->rtnCkpt = fset1->rtnCkpt;
 
   return 0;
 }
@@ -662,6 +707,7 @@ int32_t tsdbTFileSetInitRef(STsdb *pTsdb, const STFileSet *fset1, STFileSet **fs
   (*fset)->lastCompact = fset1->lastCompact;
   (*fset)->lastCommit = fset1->lastCommit;
   (*fset)->lastMigrate = fset1->lastMigrate;
+  (*fset)->rtnCkpt = fset1->rtnCkpt;
 
   return 0;
 }
@@ -733,6 +779,20 @@ int32_t tsdbTFileSetCmprFn(const STFileSet **fset1, const STFileSet **fset2) {
   return 0;
 }
 
+int64_t tsdbTFileOpArrayWriteSize(const TFileOpArray *fopArr) {
+  int64_t         size = 0;
+  const STFileOp *op;
+  TARRAY2_FOREACH_PTR(fopArr, op) {
+    if (op->optype == TSDB_FOP_CREATE) {
+      size += op->nf.size;
+    } else if (op->optype == TSDB_FOP_MODIFY && op->nf.size > op->of.size) {
+      // data files are modified by appending
+      size += op->nf.size - op->of.size;
+    }
+  }
+  return size;
+}
+
 int64_t tsdbTFileSetMaxCid(const STFileSet *fset) {
   int64_t maxCid = 0;
   for (tsdb_ftype_t ftype = TSDB_FTYPE_MIN; ftype < TSDB_FTYPE_MAX; ++ftype) {
@@ -753,3 +813,26 @@ bool tsdbTFileSetIsEmpty(const STFileSet *fset) {
   }
   return TARRAY2_SIZE(fset->lvlArr) == 0;
 }
+
+void tsdbTFileSetCheckCkpt(STFileSet *fset) {
+  const STFile *of = fset->rtnCkpt.of;
+  STFileObj    *fobj = NULL;
+
+  if (fset->rtnCkpt.offset == 0) return;
+
+  if (of->type == TSDB_FTYPE_STT) {
+    SSttLvl *lvl = tsdbTFileSetGetSttLvl(fset, of->stt->level);
+    if (lvl) {
+      STFileObj   tfobj = {.f[0] = {.cid = of->cid}}, *tfobjp = &tfobj;
+      STFileObj **fobjPtr = TARRAY2_SEARCH(lvl->fobjArr, &tfobjp, tsdbTFileObjCmpr, TD_EQ);
+      fobj = fobjPtr ? *fobjPtr : NULL;
+    }
+  } else if (of->type < TSDB_FTYPE_MAX) {
+    fobj = fset->farr[of->type];
+  }
+
+  // the source file is migrated, removed, or appended to which may rewrite its last page
+  if (fobj == NULL || !tsdbIsSameTFile(fobj->f, of) || tsdbIsTFileChanged(fobj->f, of)) {
+    fset->rtnCkpt = (STFileCkpt){0};
+  }
+}
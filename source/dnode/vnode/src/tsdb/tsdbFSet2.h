@@ -33,6 +33,7 @@ typedef enum {
   TSDB_FOP_CREATE,
   TSDB_FOP_REMOVE,
   TSDB_FOP_MODIFY,
+  TSDB_FOP_CKPT,  // save the progress of copying of to nf
 } tsdb_fop_t;
 
 #define TFILE_SET(fid_) \
@@ -59,12 +60,16 @@ int32_t tsdbTFileSetCmprFn(const STFileSet **fset1, const STFileSet **fset2);
 // edit
 int32_t tsdbTFileSetEdit(STsdb *pTsdb, STFileSet *fset, const STFileOp *op);
 int32_t tsdbTFileSetApplyEdit(STsdb *pTsdb, const STFileSet *fset1, STFileSet *fset);
+// bytes written by the file operations
+int64_t tsdbTFileOpArrayWriteSize(const TFileOpArray *fopArr);
 // max commit id
 int64_t tsdbTFileSetMaxCid(const STFileSet *fset);
 // get
 SSttLvl *tsdbTFileSetGetSttLvl(STFileSet *fset, int32_t level);
 // is empty
 bool tsdbTFileSetIsEmpty(const STFileSet *fset);
+// drop the retention checkpoint if its source file is not in the set anymore
+void tsdbTFileSetCheckCkpt(STFileSet *fset);
 // stt
 int32_t tsdbSttLvlInit(int32_t level, SSttLvl **lvl);
 void    tsdbSttLvlClear(SSttLvl **lvl);
@@ -72,10 +77,22 @@ void    tsdbSttLvlClear(SSttLvl **lvl);
 struct STFileOp {
   tsdb_fop_t optype;
   int32_t    fid;
-  STFile     of;  // old file state
-  STFile     nf;  // new file state
+  STFile     of;      // old file state
+  STFile     nf;      // new file state
+  int64_t    offset;  // TSDB_FOP_CKPT only, bytes of nf copied
 };
 
+/*
+ * Progress of a file of the set being migrated to another disk. The copied part of the target file is kept across
+ * restarts, so that the migration resumes from the offset instead of copying the whole file again. The checkpoint is
+ * dropped once the source file is migrated or removed.
+ */
+typedef struct {
+  STFile  of[1];   // the source file
+  STFile  nf[1];   // the target file
+  int64_t offset;  // bytes copied, 0 if there is no migration in progress
+} STFileCkpt;
+
 struct SSttLvl {
   int32_t       level;
   TFileObjArray fobjArr[1];
@@ -95,6 +112,7 @@ struct STFileSet {
   TSKEY        lastCompact;
   TSKEY        lastCommit;
   TSKEY        lastMigrate;
+  STFileCkpt   rtnCkpt;
 
   SVATaskID mergeTask;
   SVATaskID compactTask;
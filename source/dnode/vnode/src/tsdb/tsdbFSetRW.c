@@ -289,6 +289,36 @@ _exit:
   return code;
 }
 
+int32_t tsdbFSetWriteBlockRows(SFSetWriter *writer, SBlockData *blockData, int32_t iRow, int32_t numRow) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  if (writer->config->toSttOnly) {
+    code = tsdbSttFileWriteBlockRows(writer->sttWriter, blockData, iRow, numRow);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  } else {
+    // rows written to the data file are split among blocks by tsdbFSetWriteRow
+    SRowInfo row = {
+        .suid = blockData->suid,
+        .uid = blockData->uid,
+        .row = tsdbRowFromBlockData(blockData, iRow),
+    };
+
+    for (int32_t i = 0; i < numRow; i++) {
+      row.row.iRow = iRow + i;
+
+      code = tsdbFSetWriteRow(writer, &row);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+  }
+
+_exit:
+  if (code) {
+    TSDB_ERROR_LOG(TD_VID(writer->config->tsdb->pVnode), lino, code);
+  }
+  return code;
+}
+
 int32_t tsdbFSetWriteTombRecord(SFSetWriter *writer, const STombRecord *tombRecord) {
   int32_t code = 0;
   int32_t lino = 0;
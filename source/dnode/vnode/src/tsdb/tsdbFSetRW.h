@@ -47,6 +47,7 @@ typedef struct {
 int32_t tsdbFSetWriterOpen(SFSetWriterConfig *config, SFSetWriter **writer);
 int32_t tsdbFSetWriterClose(SFSetWriter **writer, bool abort, TFileOpArray *fopArr);
 int32_t tsdbFSetWriteRow(SFSetWriter *writer, SRowInfo *row);
+int32_t tsdbFSetWriteBlockRows(SFSetWriter *writer, SBlockData *blockData, int32_t iRow, int32_t numRow);
 int32_t tsdbFSetWriteTombRecord(SFSetWriter *writer, const STombRecord *tombRecord);
 
 #ifdef __cplusplus
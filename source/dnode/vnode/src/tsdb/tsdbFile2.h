@@ -89,6 +89,7 @@ struct STFileObj {
   int32_t       ref;
   int32_t       nlevel;
   char          fname[TSDB_FILENAME_LEN];
+  int64_t       nRead;  // times queries found data in the file, an input of the stt merge policy
 };
 
 const char *tsdbFTypeLabel(tsdb_ftype_t ftype);
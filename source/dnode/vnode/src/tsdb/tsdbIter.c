@@ -779,4 +779,64 @@ int32_t tsdbIterMergerSkipTableData(SIterMerger *merger, const TABLEID *tbid) {
   }
 
   return 0;
-}
\ No newline at end of file
+}
+
+/*
+ * If the current row is from a column chunk of the memtable, take the run of rows of the chunk that come next in the
+ * merged order as a whole, so that they can be written column by column. Rows with ts greater than maxKey are not
+ * taken. *numRow is set to 0 if there is no such run, and the current row is left to the caller.
+ */
+int32_t tsdbIterMergerTakeBlockRows(SIterMerger *merger, TSKEY maxKey, SBlockData **blockData, int32_t *iRow,
+                                    int32_t *numRow) {
+  STsdbIter *iter = merger->iter;
+
+  numRow[0] = 0;
+  if (iter == NULL || iter->type != TSDB_ITER_TYPE_MEMT || iter->filterByVersion ||
+      iter->row->row.type != TSDBROW_COL_FMT) {
+    return 0;
+  }
+
+  SBlockData *bData = iter->row->row.pBlockData;
+  int32_t     start = iter->row->row.iRow;
+  int32_t     lo, hi;
+
+  // rows beyond maxKey
+  for (lo = start + 1, hi = bData->nRow; lo < hi;) {
+    int32_t mid = (lo + hi) >> 1;
+    if (bData->aTSKEY[mid] > maxKey) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+
+  // rows not less than the next row of the other iterators
+  SRBTreeNode *node = tRBTreeMin(merger->iterTree);
+  if (node) {
+    STsdbIter *other = TCONTAINER_OF(node, STsdbIter, node);
+    SRowInfo   row = {.suid = iter->row->suid, .uid = iter->row->uid};
+
+    for (hi = lo, lo = start + 1; lo < hi;) {
+      int32_t mid = (lo + hi) >> 1;
+
+      row.row = tsdbRowFromBlockData(bData, mid);
+      if (tRowInfoCmprFn(&row, other->row) >= 0) {
+        hi = mid;
+      } else {
+        lo = mid + 1;
+      }
+    }
+  }
+
+  int32_t n = tsdbTbDataIterTakeBlockRows(iter->memtData->tbIter, bData, start + 1, lo - start - 1);
+  if (n == 0) {
+    return 0;
+  }
+
+  blockData[0] = bData;
+  iRow[0] = start;
+  numRow[0] = n + 1;
+
+  // move past the last row taken
+  return tsdbIterMergerNext(merger);
+}
@@ -62,6 +62,8 @@ int32_t tsdbIterMergerOpen(const TTsdbIterArray *iterArray, SIterMerger **merger
 void    tsdbIterMergerClose(SIterMerger **merger);
 int32_t tsdbIterMergerNext(SIterMerger *merger);
 int32_t tsdbIterMergerSkipTableData(SIterMerger *merger, const TABLEID *tbid);
+int32_t tsdbIterMergerTakeBlockRows(SIterMerger *merger, TSKEY maxKey, SBlockData **blockData, int32_t *iRow,
+                                    int32_t *numRow);
 
 SRowInfo    *tsdbIterMergerGetData(SIterMerger *merger);
 STombRecord *tsdbIterMergerGetTombRecord(SIterMerger *merger);
@@ -31,7 +31,11 @@
 #define SL_MOVE_BACKWARD 0x1
 #define SL_MOVE_FROM_POS 0x2
 
+#define CL_MIN_CHUNK_ROWS 16
+#define CL_MAX_CHUNK_ROWS 4096
+
 static void    tbDataMovePosTo(STbData *pTbData, SMemSkipListNode **pos, STsdbRowKey *pKey, int32_t flags);
+static void    tbDataChunkMoveTo(STbData *pTbData, STsdbRowKey *pKey, int8_t backward, STbDataIter *pIter);
 static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid_t uid, STbData **ppTbData);
 static int32_t tsdbInsertRowDataToTable(SMemTable *pMemTable, STbData *pTbData, int64_t version,
                                         SSubmitTbData *pSubmitTbData, int32_t *affectedRows);
@@ -237,6 +241,78 @@ void *tsdbTbDataIterDestroy(STbDataIter *pIter) {
   return NULL;
 }
 
+static FORCE_INLINE void tbDataChunkGetRow(SMemChunk *pChunk, int32_t iRow, TSDBROW *pRow) {
+  if (pChunk->pBlockData) {
+    *pRow = tsdbRowFromBlockData(pChunk->pBlockData, iRow);
+  } else {
+    *pRow = pChunk->aRow[iRow];
+  }
+}
+
+// index of the first row in [lo, hi) whose key is greater than pKey, or not less than pKey if !strict
+static int32_t tbDataChunkSearch(SMemChunk *pChunk, int32_t lo, int32_t hi, STsdbRowKey *pKey, bool strict) {
+  TSDBROW     row;
+  STsdbRowKey tKey;
+
+  while (lo < hi) {
+    int32_t mid = (lo + hi) >> 1;
+
+    tbDataChunkGetRow(pChunk, mid, &row);
+    tsdbRowGetKey(&row, &tKey);
+
+    int32_t c = tsdbRowKeyCmpr(&tKey, pKey);
+    if (c < 0 || (strict && c == 0)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  return lo;
+}
+
+static void tbDataChunkMoveTo(STbData *pTbData, STsdbRowKey *pKey, int8_t backward, STbDataIter *pIter) {
+  TSDBROW     row;
+  STsdbRowKey tKey;
+
+  if (backward) {
+    // the last row not greater than the key
+    for (SMemChunk *pChunk = atomic_load_ptr(&pTbData->cl.pTail); pChunk; pChunk = pChunk->prev) {
+      int32_t nRow = atomic_load_32(&pChunk->nRow);
+
+      tbDataChunkGetRow(pChunk, 0, &row);
+      tsdbRowGetKey(&row, &tKey);
+      if (tsdbRowKeyCmpr(&tKey, pKey) > 0) continue;
+
+      pIter->pChunk = pChunk;
+      pIter->iChunkRow = tbDataChunkSearch(pChunk, 1, nRow, pKey, true) - 1;
+      return;
+    }
+
+    pIter->pChunk = NULL;
+    pIter->iChunkRow = -1;
+  } else {
+    // the first row not less than the key, or the end of the list so that rows appended later are seen
+    SMemChunk *pChunk = atomic_load_ptr(&pTbData->cl.pHead);
+
+    pIter->pChunk = pChunk;
+    pIter->iChunkRow = 0;
+    for (; pChunk; pChunk = atomic_load_ptr(&pChunk->next)) {
+      int32_t nRow = atomic_load_32(&pChunk->nRow);
+
+      pIter->pChunk = pChunk;
+      pIter->iChunkRow = nRow;
+
+      tbDataChunkGetRow(pChunk, nRow - 1, &row);
+      tsdbRowGetKey(&row, &tKey);
+      if (tsdbRowKeyCmpr(&tKey, pKey) < 0) continue;
+
+      pIter->iChunkRow = tbDataChunkSearch(pChunk, 0, nRow - 1, pKey, false);
+      return;
+    }
+  }
+}
+
 void tsdbTbDataIterOpen(STbData *pTbData, STsdbRowKey *pFrom, int8_t backward, STbDataIter *pIter) {
   SMemSkipListNode *pos[SL_MAX_LEVEL];
   SMemSkipListNode *pHead;
@@ -246,13 +322,18 @@ void tsdbTbDataIterOpen(STbData *pTbData, STsdbRowKey *pFrom, int8_t backward, S
   pTail = pTbData->sl.pTail;
   pIter->pTbData = pTbData;
   pIter->backward = backward;
+  pIter->fromChunk = 0;
   pIter->pRow = NULL;
   if (pFrom == NULL) {
     // create from head or tail
     if (backward) {
       pIter->pNode = SL_GET_NODE_BACKWARD(pTbData->sl.pTail, 0);
+      pIter->pChunk = atomic_load_ptr(&pTbData->cl.pTail);
+      pIter->iChunkRow = pIter->pChunk ? atomic_load_32(&pIter->pChunk->nRow) - 1 : -1;
     } else {
       pIter->pNode = SL_GET_NODE_FORWARD(pTbData->sl.pHead, 0);
+      pIter->pChunk = atomic_load_ptr(&pTbData->cl.pHead);
+      pIter->iChunkRow = 0;
     }
   } else {
     // create from a key
@@ -263,37 +344,135 @@ void tsdbTbDataIterOpen(STbData *pTbData, STsdbRowKey *pFrom, int8_t backward, S
       tbDataMovePosTo(pTbData, pos, pFrom, 0);
       pIter->pNode = SL_GET_NODE_FORWARD(pos[0], 0);
     }
+    tbDataChunkMoveTo(pTbData, pFrom, backward, pIter);
   }
 }
 
-bool tsdbTbDataIterNext(STbDataIter *pIter) {
-  pIter->pRow = NULL;
+static bool tbDataIterGetChunkRow(STbDataIter *pIter, TSDBROW *pRow) {
+  SMemChunk *pChunk = pIter->pChunk;
+  if (pChunk == NULL) {
+    return false;
+  }
+
   if (pIter->backward) {
-    if (pIter->pNode == pIter->pTbData->sl.pHead) {
+    if (pIter->iChunkRow < 0) {
       return false;
     }
+  } else {
+    while (pIter->iChunkRow >= atomic_load_32(&pChunk->nRow)) {
+      SMemChunk *pNext = atomic_load_ptr(&pChunk->next);
+      if (pNext == NULL) {
+        return false;
+      }
 
-    pIter->pNode = SL_GET_NODE_BACKWARD(pIter->pNode, 0);
-    if (pIter->pNode == pIter->pTbData->sl.pHead) {
-      return false;
+      pIter->pChunk = pChunk = pNext;
+      pIter->iChunkRow = 0;
+    }
+  }
+
+  tbDataChunkGetRow(pChunk, pIter->iChunkRow, pRow);
+  return true;
+}
+
+TSDBROW *tsdbTbDataIterLoadRow(STbDataIter *pIter) {
+  TSDBROW *pNodeRow = NULL;
+  TSDBROW  chunkRow;
+  bool     hasChunkRow = tbDataIterGetChunkRow(pIter, &chunkRow);
+
+  if (pIter->backward) {
+    if (pIter->pNode != pIter->pTbData->sl.pHead) {
+      pNodeRow = &pIter->pNode->row;
     }
   } else {
-    if (pIter->pNode == pIter->pTbData->sl.pTail) {
-      return false;
+    if (pIter->pNode != pIter->pTbData->sl.pTail) {
+      pNodeRow = &pIter->pNode->row;
     }
+  }
 
-    pIter->pNode = SL_GET_NODE_FORWARD(pIter->pNode, 0);
-    if (pIter->pNode == pIter->pTbData->sl.pTail) {
-      return false;
+  if (pNodeRow && hasChunkRow) {
+    // merge the two lists, rows of the same key are taken from the append list first when moving forward
+    STsdbRowKey nodeKey;
+    STsdbRowKey chunkKey;
+
+    tsdbRowGetKey(pNodeRow, &nodeKey);
+    tsdbRowGetKey(&chunkRow, &chunkKey);
+
+    int32_t c = tsdbRowKeyCmpr(&chunkKey, &nodeKey);
+    pIter->fromChunk = pIter->backward ? (c > 0) : (c <= 0);
+  } else if (hasChunkRow) {
+    pIter->fromChunk = 1;
+  } else if (pNodeRow) {
+    pIter->fromChunk = 0;
+  } else {
+    return NULL;
+  }
+
+  pIter->pRow = &pIter->row;
+  pIter->row = pIter->fromChunk ? chunkRow : *pNodeRow;
+
+  return pIter->pRow;
+}
+
+bool tsdbTbDataIterNext(STbDataIter *pIter) {
+  if (tsdbTbDataIterGet(pIter) == NULL) {
+    return false;
+  }
+
+  pIter->pRow = NULL;
+  if (pIter->fromChunk) {
+    if (pIter->backward) {
+      if (--pIter->iChunkRow < 0) {
+        // chunks before the tail are never appended to again
+        pIter->pChunk = pIter->pChunk->prev;
+        pIter->iChunkRow = pIter->pChunk ? pIter->pChunk->nRow - 1 : -1;
+      }
+    } else {
+      pIter->iChunkRow++;
+    }
+  } else {
+    if (pIter->backward) {
+      pIter->pNode = SL_GET_NODE_BACKWARD(pIter->pNode, 0);
+    } else {
+      pIter->pNode = SL_GET_NODE_FORWARD(pIter->pNode, 0);
     }
   }
 
-  return true;
+  return tsdbTbDataIterGet(pIter) != NULL;
+}
+
+int32_t tsdbTbDataIterTakeBlockRows(STbDataIter *pIter, SBlockData *pBlockData, int32_t iRow, int32_t nRow) {
+  TSDBROW row;
+
+  if (pIter->backward || nRow <= 0 || !tbDataIterGetChunkRow(pIter, &row)) {
+    return 0;
+  }
+
+  SMemChunk *pChunk = pIter->pChunk;
+  if (pChunk->pBlockData != pBlockData || pIter->iChunkRow != iRow) {
+    return 0;
+  }
+
+  nRow = TMIN(nRow, pChunk->nRow - iRow);
+
+  // rows of the skip list that sort in between are left to the row by row path
+  if (pIter->pNode != pIter->pTbData->sl.pTail) {
+    STsdbRowKey key;
+
+    tsdbRowGetKey(&pIter->pNode->row, &key);
+    nRow = tbDataChunkSearch(pChunk, iRow, iRow + nRow, &key, true) - iRow;
+  }
+
+  if (nRow > 0) {
+    pIter->iChunkRow += nRow;
+    pIter->pRow = NULL;
+  }
+
+  return nRow;
 }
 
 int64_t tsdbCountTbDataRows(STbData *pTbData) {
   SMemSkipListNode *pNode = pTbData->sl.pHead;
-  int64_t           rowsNum = 0;
+  int64_t           rowsNum = pTbData->cl.size;
 
   while (NULL != pNode) {
     pNode = SL_GET_NODE_FORWARD(pNode, 0);
@@ -408,6 +587,9 @@ static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid
   pTbData->sl.pTail = (SMemSkipListNode *)POINTER_SHIFT(pTbData->sl.pHead, SL_NODE_SIZE(maxLevel));
   pTbData->sl.pHead->level = maxLevel;
   pTbData->sl.pTail->level = maxLevel;
+  pTbData->cl.size = 0;
+  pTbData->cl.pHead = NULL;
+  pTbData->cl.pTail = NULL;
   for (int8_t iLevel = 0; iLevel < maxLevel; iLevel++) {
     SL_NODE_FORWARD(pTbData->sl.pHead, iLevel) = pTbData->sl.pTail;
     SL_NODE_BACKWARD(pTbData->sl.pTail, iLevel) = pTbData->sl.pHead;
@@ -598,6 +780,147 @@ _exit:
   return code;
 }
 
+// a row can be appended if it is greater than all rows in the table
+static bool tbDataCanAppend(STbData *pTbData, STsdbRowKey *pKey) {
+  TSDBROW     row;
+  STsdbRowKey tKey;
+
+  SMemChunk *pChunk = pTbData->cl.pTail;
+  if (pChunk) {
+    tbDataChunkGetRow(pChunk, pChunk->nRow - 1, &row);
+    tsdbRowGetKey(&row, &tKey);
+    if (tRowKeyCompare(&pKey->key, &tKey.key) <= 0) {
+      return false;
+    }
+  }
+
+  if (pTbData->sl.size > 0) {
+    tsdbRowGetKey(&SL_NODE_BACKWARD(pTbData->sl.pTail, 0)->row, &tKey);
+    if (tRowKeyCompare(&pKey->key, &tKey.key) <= 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static bool tbDataCanAppendBlock(STbData *pTbData, SBlockData *pBlockData) {
+  TSDBROW     row = tsdbRowFromBlockData(pBlockData, 0);
+  STsdbRowKey key;
+  STsdbRowKey lastKey;
+
+  tsdbRowGetKey(&row, &key);
+  if (!tbDataCanAppend(pTbData, &key)) {
+    return false;
+  }
+
+  // duplicate keys in the block need to be merged, leave them to the skip list
+  for (row.iRow = 1; row.iRow < pBlockData->nRow; row.iRow++) {
+    lastKey = key;
+    tsdbRowGetKey(&row, &key);
+    if (tRowKeyCompare(&key.key, &lastKey.key) <= 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static void tbDataLinkChunk(STbData *pTbData, SMemChunk *pChunk) {
+  pChunk->next = NULL;
+  pChunk->prev = pTbData->cl.pTail;
+  if (pTbData->cl.pTail) {
+    atomic_store_ptr(&pTbData->cl.pTail->next, pChunk);
+  } else {
+    atomic_store_ptr(&pTbData->cl.pHead, pChunk);
+  }
+  atomic_store_ptr(&pTbData->cl.pTail, pChunk);
+}
+
+static int32_t tbDataAppendBlock(SMemTable *pMemTable, STbData *pTbData, SBlockData *pBlockData) {
+  SVBufPool *pPool = pMemTable->pTsdb->pVnode->inUse;
+
+  SMemChunk *pChunk = (SMemChunk *)vnodeBufPoolMallocAligned(pPool, sizeof(*pChunk));
+  if (pChunk == NULL) {
+    return terrno;
+  }
+
+  pChunk->pBlockData = pBlockData;
+  pChunk->nRow = pBlockData->nRow;
+  pChunk->nCap = 0;
+  tbDataLinkChunk(pTbData, pChunk);
+
+  pTbData->cl.size += pBlockData->nRow;
+  return 0;
+}
+
+static int32_t tbDataAppendRow(SMemTable *pMemTable, STbData *pTbData, TSDBROW *pRow) {
+  SVBufPool *pPool = pMemTable->pTsdb->pVnode->inUse;
+  SMemChunk *pChunk = pTbData->cl.pTail;
+  bool       newChunk = false;
+
+  if (pChunk == NULL || pChunk->pBlockData || pChunk->nRow >= pChunk->nCap) {
+    // chunks grow with the table, so that tables with few rows do not waste memory
+    int32_t nCap = CL_MIN_CHUNK_ROWS;
+    if (pChunk && pChunk->pBlockData == NULL) {
+      nCap = TMIN(pChunk->nCap << 1, CL_MAX_CHUNK_ROWS);
+    }
+
+    pChunk = (SMemChunk *)vnodeBufPoolMallocAligned(pPool, sizeof(*pChunk) + sizeof(TSDBROW) * nCap);
+    if (pChunk == NULL) {
+      return terrno;
+    }
+    pChunk->pBlockData = NULL;
+    pChunk->nRow = 0;
+    pChunk->nCap = nCap;
+    newChunk = true;
+  }
+
+  SRow *pTSRow = (SRow *)vnodeBufPoolMallocAligned(pPool, pRow->pTSRow->len);
+  if (pTSRow == NULL) {
+    return terrno;
+  }
+  memcpy(pTSRow, pRow->pTSRow, pRow->pTSRow->len);
+
+  pChunk->aRow[pChunk->nRow] = *pRow;
+  pChunk->aRow[pChunk->nRow].pTSRow = pTSRow;
+  if (newChunk) {
+    pChunk->nRow = 1;
+    tbDataLinkChunk(pTbData, pChunk);
+  } else {
+    atomic_store_32(&pChunk->nRow, pChunk->nRow + 1);
+  }
+
+  pTbData->cl.size++;
+  return 0;
+}
+
+// put rows of a batch in key order to the skip list, pos is kept between calls
+static int32_t tbDataPutRow(SMemTable *pMemTable, STbData *pTbData, SMemSkipListNode **pos, bool *posValid,
+                            TSDBROW *pRow, STsdbRowKey *pKey) {
+  int32_t code = 0;
+
+  if (!*posValid) {
+    // backward put the first row
+    tbDataMovePosTo(pTbData, pos, pKey, SL_MOVE_BACKWARD);
+    code = tbDataDoPut(pMemTable, pTbData, pos, pRow, 0);
+    if (code) return code;
+
+    for (int8_t iLevel = pos[0]->level; iLevel < pTbData->sl.maxLevel; iLevel++) {
+      pos[iLevel] = SL_NODE_BACKWARD(pos[iLevel], iLevel);
+    }
+    *posValid = true;
+    return code;
+  }
+
+  // forward put the rest
+  if (SL_NODE_FORWARD(pos[0], 0) != pTbData->sl.pTail) {
+    tbDataMovePosTo(pTbData, pos, pKey, SL_MOVE_FROM_POS);
+  }
+
+  return tbDataDoPut(pMemTable, pTbData, pos, pRow, 1);
+}
+
 static int32_t tsdbInsertColDataToTable(SMemTable *pMemTable, STbData *pTbData, int64_t version,
                                         SSubmitTbData *pSubmitTbData, int32_t *affectedRows) {
   int32_t code = 0;
@@ -645,34 +968,30 @@ static int32_t tsdbInsertColDataToTable(SMemTable *pMemTable, STbData *pTbData,
     if (code) goto _exit;
   }
 
-  // loop to add each row to the skiplist
-  SMemSkipListNode *pos[SL_MAX_LEVEL];
-  TSDBROW           tRow = tsdbRowFromBlockData(pBlockData, 0);
-  STsdbRowKey       key;
+  TSDBROW     tRow = tsdbRowFromBlockData(pBlockData, 0);
+  STsdbRowKey key;
 
-  // first row
-  tsdbRowGetKey(&tRow, &key);
-  tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_BACKWARD);
-  if ((code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 0))) goto _exit;
-  pTbData->minKey = TMIN(pTbData->minKey, key.key.ts);
+  if (tbDataCanAppendBlock(pTbData, pBlockData)) {
+    // in order, keep the block as a column chunk
+    if ((code = tbDataAppendBlock(pMemTable, pTbData, pBlockData))) goto _exit;
 
-  // remain row
-  ++tRow.iRow;
-  if (tRow.iRow < pBlockData->nRow) {
-    for (int8_t iLevel = pos[0]->level; iLevel < pTbData->sl.maxLevel; iLevel++) {
-      pos[iLevel] = SL_NODE_BACKWARD(pos[iLevel], iLevel);
-    }
+    tsdbRowGetKey(&tRow, &key);
+    pTbData->minKey = TMIN(pTbData->minKey, key.key.ts);
 
-    while (tRow.iRow < pBlockData->nRow) {
+    tRow.iRow = pBlockData->nRow - 1;
+    tsdbRowGetKey(&tRow, &key);
+  } else {
+    // loop to add each row to the skiplist
+    SMemSkipListNode *pos[SL_MAX_LEVEL];
+    bool              posValid = false;
+
+    for (; tRow.iRow < pBlockData->nRow; ++tRow.iRow) {
       tsdbRowGetKey(&tRow, &key);
+      if ((code = tbDataPutRow(pMemTable, pTbData, pos, &posValid, &tRow, &key))) goto _exit;
 
-      if (SL_NODE_FORWARD(pos[0], 0) != pTbData->sl.pTail) {
-        tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_FROM_POS);
+      if (tRow.iRow == 0) {
+        pTbData->minKey = TMIN(pTbData->minKey, key.key.ts);
       }
-
-      if ((code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 1))) goto _exit;
-
-      ++tRow.iRow;
     }
   }
 
@@ -706,36 +1025,23 @@ static int32_t tsdbInsertRowDataToTable(SMemTable *pMemTable, STbData *pTbData,
   SRow            **aRow = (SRow **)TARRAY_DATA(pSubmitTbData->aRowP);
   STsdbRowKey       key;
   SMemSkipListNode *pos[SL_MAX_LEVEL];
+  bool              posValid = false;
   TSDBROW           tRow = {.type = TSDBROW_ROW_FMT, .version = version};
-  int32_t           iRow = 0;
-
-  // backward put first data
-  tRow.pTSRow = aRow[iRow++];
-  tsdbRowGetKey(&tRow, &key);
-  tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_BACKWARD);
-  code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 0);
-  if (code) goto _exit;
 
-  pTbData->minKey = TMIN(pTbData->minKey, key.key.ts);
+  for (int32_t iRow = 0; iRow < nRow; iRow++) {
+    tRow.pTSRow = aRow[iRow];
+    tsdbRowGetKey(&tRow, &key);
 
-  // forward put rest data
-  if (iRow < nRow) {
-    for (int8_t iLevel = pos[0]->level; iLevel < pTbData->sl.maxLevel; iLevel++) {
-      pos[iLevel] = SL_NODE_BACKWARD(pos[iLevel], iLevel);
+    // rows are appended while they come in order, the skip list only takes the ones out of order
+    if (tbDataCanAppend(pTbData, &key)) {
+      code = tbDataAppendRow(pMemTable, pTbData, &tRow);
+    } else {
+      code = tbDataPutRow(pMemTable, pTbData, pos, &posValid, &tRow, &key);
     }
+    if (code) goto _exit;
 
-    while (iRow < nRow) {
-      tRow.pTSRow = aRow[iRow];
-      tsdbRowGetKey(&tRow, &key);
-
-      if (SL_NODE_FORWARD(pos[0], 0) != pTbData->sl.pTail) {
-        tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_FROM_POS);
-      }
-
-      code = tbDataDoPut(pMemTable, pTbData, pos, &tRow, 1);
-      if (code) goto _exit;
-
-      iRow++;
+    if (iRow == 0) {
+      pTbData->minKey = TMIN(pTbData->minKey, key.key.ts);
     }
   }
 
@@ -757,7 +1063,7 @@ _exit:
   return code;
 }
 
-int32_t tsdbGetNRowsInTbData(STbData *pTbData) { return pTbData->sl.size; }
+int32_t tsdbGetNRowsInTbData(STbData *pTbData) { return pTbData->sl.size + pTbData->cl.size; }
 
 int32_t tsdbRefMemTable(SMemTable *pMemTable, SQueryNode *pQNode) {
   int32_t code = 0;
@@ -14,8 +14,7 @@
  */
 
 #include "tsdbMerge.h"
-
-#define TSDB_MAX_LEVEL 2  // means max level is 3
+#include "tsdbMergePlan.h"
 
 typedef struct {
   STsdb     *tsdb;
@@ -23,6 +22,7 @@ typedef struct {
   STFileSet *fset;
 
   int32_t sttTrigger;
+  int32_t policy;
   int32_t maxRow;
   int32_t minRow;
   int32_t szPage;
@@ -61,6 +61,10 @@ static int32_t tsdbMergerOpen(SMerger *merger) {
   merger->cmprAlg = merger->tsdb->pVnode->config.tsdbCfg.compression;
   merger->compactVersion = INT64_MAX;
   merger->cid = tsdbFSAllocEid(merger->tsdb->pFS);
+  merger->policy = tsSttMergePolicy;
+  if (merger->policy < 0 || merger->policy >= TSDB_MERGE_POLICY_MAX) {
+    merger->policy = TSDB_MERGE_POLICY_LEVELED;
+  }
   merger->ctx->opened = true;
   return 0;
 }
@@ -81,11 +85,306 @@ static void tsdbMergeFileSetEndCloseReader(SMerger *merger) {
   TARRAY2_CLEAR(merger->sttReaderArr, tsdbSttFileReaderClose);
 }
 
-static int32_t tsdbMergeFileSetBeginOpenReader(SMerger *merger) {
+void tsdbMergePlanClear(SMergePlan *plan) {
+  for (int32_t i = 0; i < plan->numFile; ++i) {
+    if (plan->files[i].reader) {
+      tsdbSttFileReaderClose(&plan->files[i].reader);
+    }
+  }
+  taosMemoryFreeClear(plan->files);
+  plan->numFile = 0;
+  taosMemoryFreeClear(plan->order);
+  taosMemoryFreeClear(plan->candidate);
+  taosMemoryFreeClear(plan->best);
+}
+
+static int32_t tsdbMergeFileSizeCmpr(const void *arg1, const void *arg2, const void *param) {
+  const SMergeFile *files = (const SMergeFile *)param;
+  int64_t           size1 = files[*(const int32_t *)arg1].size;
+  int64_t           size2 = files[*(const int32_t *)arg2].size;
+  if (size1 < size2) {
+    return -1;
+  } else if (size1 > size2) {
+    return 1;
+  } else {
+    return 0;
+  }
+}
+
+static int32_t tsdbMergeFileStat(SMerger *merger, SMergeFile *file) {
+  const TSttBlkArray  *sttBlkArray;
+  const TTombBlkArray *tombBlkArray;
+
+  TAOS_CHECK_RETURN(tsdbSttFileReadSttBlk(file->reader, &sttBlkArray));
+  TAOS_CHECK_RETURN(tsdbSttFileReadTombBlk(file->reader, &tombBlkArray));
+
+  file->skey = TSKEY_MAX;
+  file->ekey = TSKEY_MIN;
+
+  const SSttBlk *sttBlk;
+  TARRAY2_FOREACH_PTR(sttBlkArray, sttBlk) {
+    file->nRow += sttBlk->nRow;
+    file->skey = TMIN(file->skey, sttBlk->minKey);
+    file->ekey = TMAX(file->ekey, sttBlk->maxKey);
+  }
+
+  const STombBlk *tombBlk;
+  TARRAY2_FOREACH_PTR(tombBlkArray, tombBlk) { file->nTomb += tombBlk->numRec; }
+  return 0;
+}
+
+// allocate the candidate buffers of the files in the plan and sort the files by size
+int32_t tsdbMergePlanPrepare(SMergePlan *plan) {
+  int32_t numFile = TMAX(plan->numFile, 1);
+
+  plan->order = taosMemoryMalloc(sizeof(int32_t) * numFile);
+  plan->candidate = taosMemoryCalloc(numFile, sizeof(bool));
+  plan->best = taosMemoryCalloc(numFile, sizeof(bool));
+  if (plan->order == NULL || plan->candidate == NULL || plan->best == NULL) {
+    return terrno;
+  }
+
+  for (int32_t i = 0; i < plan->numFile; ++i) {
+    plan->order[i] = i;
+  }
+  taosqsort_r(plan->order, plan->numFile, sizeof(int32_t), plan->files, tsdbMergeFileSizeCmpr);
+  plan->level = 0;
+  plan->score = -1;
+  return 0;
+}
+
+/*
+ * Collect all stt files of the file set. The plain leveled policy goes by file counts only, so the files are opened and
+ * their block indexes read for the statistics of the candidates only if another policy scores them. Otherwise just the
+ * merged files are opened, as before the merge plan.
+ */
+static int32_t tsdbMergePlanInit(SMerger *merger, SMergePlan *plan) {
   int32_t  code = 0;
   int32_t  lino = 0;
   SSttLvl *lvl;
 
+  int32_t numFile = 0;
+  TARRAY2_FOREACH(merger->ctx->fset->lvlArr, lvl) { numFile += TARRAY2_SIZE(lvl->fobjArr); }
+
+  plan->files = taosMemoryCalloc(TMAX(numFile, 1), sizeof(SMergeFile));
+  if (plan->files == NULL) {
+    TAOS_CHECK_GOTO(terrno, &lino, _exit);
+  }
+
+  TARRAY2_FOREACH(merger->ctx->fset->lvlArr, lvl) {
+    STFileObj *fobj;
+    TARRAY2_FOREACH(lvl->fobjArr, fobj) {
+      SMergeFile *file = &plan->files[plan->numFile];
+      file->fobj = fobj;
+      file->level = lvl->level;
+      file->size = fobj->f->size;
+      file->nRead = atomic_load_64(&fobj->nRead);
+      file->skey = TSKEY_MAX;
+      file->ekey = TSKEY_MIN;
+      if (merger->policy == TSDB_MERGE_POLICY_LEVELED) {
+        plan->numFile++;
+        continue;
+      }
+
+      SSttFileReaderConfig config = {
+          .tsdb = merger->tsdb,
+          .szPage = merger->szPage,
+          .file[0] = fobj->f[0],
+      };
+      TAOS_CHECK_GOTO(tsdbSttFileReaderOpen(fobj->fname, &config, &file->reader), &lino, _exit);
+      plan->numFile++;
+
+      TAOS_CHECK_GOTO(tsdbMergeFileStat(merger, file), &lino, _exit);
+    }
+  }
+
+  TAOS_CHECK_GOTO(tsdbMergePlanPrepare(plan), &lino, _exit);
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d %s failed at %s:%d since %s", TD_VID(merger->tsdb->pVnode), __func__, __FILE__, lino,
+              tstrerror(code));
+  }
+  return code;
+}
+
+static double tsdbMergePlanScore(const SMergePlan *plan) {
+  int32_t nFile = 0;
+  int64_t size = 0;
+  int64_t nRow = 0;
+  int64_t nTomb = 0;
+  int64_t nRead = 0;
+  double  span = 0;
+  TSKEY   skey = TSKEY_MAX;
+  TSKEY   ekey = TSKEY_MIN;
+
+  for (int32_t i = 0; i < plan->numFile; ++i) {
+    if (!plan->candidate[i]) continue;
+
+    const SMergeFile *file = &plan->files[i];
+    nFile++;
+    size += file->size;
+    nRow += file->nRow;
+    nTomb += file->nTomb;
+    nRead += file->nRead;
+    if (file->skey <= file->ekey) {
+      span += (double)file->ekey - file->skey + 1;
+      skey = TMIN(skey, file->skey);
+      ekey = TMAX(ekey, file->ekey);
+    }
+  }
+
+  if (nFile < 2) {
+    return 0;
+  }
+
+  // the hull of the key ranges bounds their union from above, so the overlap is never overestimated
+  double overlap = 0;
+  if (span > 0) {
+    overlap = TMAX(0, 1 - ((double)ekey - skey + 1) / span);
+  }
+  double tombDensity = (nRow + nTomb > 0) ? (double)nTomb / (nRow + nTomb) : 0;
+  double mb = (double)size / (1024 * 1024);
+
+  return (nFile - 1) * (1 + overlap) * (1 + tombDensity) * (1 + log2(1 + (double)nRead)) / (1 + mb);
+}
+
+static void tsdbMergePlanPropose(SMergePlan *plan, int32_t level) {
+  double score = tsdbMergePlanScore(plan);
+  if (score > plan->score) {
+    (void)memcpy(plan->best, plan->candidate, sizeof(bool) * plan->numFile);
+    plan->level = level;
+    plan->score = score;
+  }
+}
+
+static int32_t tsdbMergePlanLevelSize(const SMergePlan *plan, int32_t level) {
+  int32_t size = 0;
+  for (int32_t i = 0; i < plan->numFile; ++i) {
+    if (plan->files[i].level == level) {
+      size++;
+    }
+  }
+  return size;
+}
+
+// propose the oldest level-0 files that, with all files below the level, fill the level
+static void tsdbMergeProposeLevel(SMergePlan *plan, int32_t sttTrigger, int32_t level) {
+  // get number of level-0 files to merge
+  int32_t numFile = pow(sttTrigger, level);
+  for (int32_t l = 1; l < level; ++l) {
+    numFile = numFile - tsdbMergePlanLevelSize(plan, l) * pow(sttTrigger, l);
+  }
+  if (numFile <= 0 && plan->score >= 0) {
+    // a lower level that takes no level-0 file is not worth an alternative
+    return;
+  }
+
+  for (int32_t i = 0, numLevel0 = 0; i < plan->numFile; ++i) {
+    const SMergeFile *file = &plan->files[i];
+    if (file->level == 0) {
+      plan->candidate[i] = (numLevel0++ < numFile);
+    } else {
+      plan->candidate[i] = (file->level < level);
+    }
+  }
+  tsdbMergePlanPropose(plan, level);
+}
+
+/*
+ * Leveled: level i holds up to sttTrigger files of the size of sttTrigger^i level-0 files. The merge carries level-0
+ * files up to the highest level they overflow. If scored, it may stop at a lower level when that scores better, but a
+ * level that is already full is always carried, so no level grows beyond sttTrigger files.
+ */
+void tsdbMergeProposeLeveled(SMergePlan *plan, int32_t sttTrigger, bool scored) {
+  // find the highest level that can be merged to
+  int32_t maxLevel = 0;
+  for (int32_t numCarry = 0;;) {
+    int32_t numFile = numCarry + tsdbMergePlanLevelSize(plan, maxLevel);
+
+    numCarry = numFile / sttTrigger;
+    if (numCarry == 0) {
+      break;
+    } else {
+      maxLevel++;
+    }
+  }
+
+  int32_t minLevel = maxLevel;
+  if (scored) {
+    minLevel = 1;
+    for (int32_t level = 1; level < maxLevel; ++level) {
+      if (tsdbMergePlanLevelSize(plan, level) >= sttTrigger) {
+        minLevel = maxLevel;
+        break;
+      }
+    }
+  }
+
+  // the highest level is proposed first, lower levels replace it only if they score strictly better
+  plan->score = -1;
+  tsdbMergeProposeLevel(plan, sttTrigger, maxLevel);
+  for (int32_t level = maxLevel - 1; level >= minLevel && level > 0; --level) {
+    tsdbMergeProposeLevel(plan, sttTrigger, level);
+  }
+}
+
+/*
+ * Size-tiered: files of similar size are merged together whatever level they are on, so large files are not rewritten
+ * for every few small ones. A tier is ready once it has sttTrigger level-0 files, so each merge drains level 0 at least
+ * as fast as the leveled policy does. When no tier is ready, the files are merged as the leveled policy does.
+ */
+void tsdbMergeProposeTiered(SMergePlan *plan, int32_t sttTrigger) {
+  int32_t numFile = plan->numFile;
+
+  plan->score = -1;
+  for (int32_t i = 0, j; i < numFile; i = j) {
+    int64_t size = plan->files[plan->order[i]].size;
+    for (j = i + 1; j < numFile; ++j) {
+      int64_t size1 = plan->files[plan->order[j]].size;
+      if (size1 > (double)size / (j - i) * TSDB_MERGE_TIER_RATIO) {
+        break;
+      }
+      size += size1;
+    }
+
+    int32_t numLevel0 = 0;
+    int32_t level = 0;
+    (void)memset(plan->candidate, 0, sizeof(bool) * numFile);
+    for (int32_t k = i; k < j; ++k) {
+      const SMergeFile *file = &plan->files[plan->order[k]];
+      plan->candidate[plan->order[k]] = true;
+      numLevel0 += (file->level == 0);
+      level = TMAX(level, file->level + 1);
+    }
+
+    if (numLevel0 >= sttTrigger) {
+      tsdbMergePlanPropose(plan, TMIN(level, TSDB_MAX_LEVEL + 1));
+    }
+  }
+
+  if (plan->score < 0) {
+    tsdbMergeProposeLeveled(plan, sttTrigger, false);
+  }
+}
+
+static const char *tsdbMergePolicyName(int32_t policy) {
+  switch (policy) {
+    case TSDB_MERGE_POLICY_TIERED:
+      return "size-tiered";
+    case TSDB_MERGE_POLICY_LEVELED_SCORED:
+      return "scored leveled";
+    default:
+      return "leveled";
+  }
+}
+
+static int32_t tsdbMergeFileSetBeginOpenReader(SMerger *merger) {
+  int32_t    code = 0;
+  int32_t    lino = 0;
+  SSttLvl   *lvl;
+  SMergePlan plan[1] = {{.score = -1}};
+
   bool hasLevelLargerThanMax = false;
   TARRAY2_FOREACH_REVERSE(merger->ctx->fset->lvlArr, lvl) {
     if (lvl->level <= TSDB_MAX_LEVEL) {
@@ -128,85 +427,53 @@ static int32_t tsdbMergeFileSetBeginOpenReader(SMerger *merger) {
     }
   } else {
     // do regular merge
-    merger->ctx->toData = true;
-    merger->ctx->level = 0;
-
-    // find the highest level that can be merged to
-    for (int32_t i = 0, numCarry = 0;;) {
-      int32_t numFile = numCarry;
-      if (i < TARRAY2_SIZE(merger->ctx->fset->lvlArr) &&
-          merger->ctx->level == TARRAY2_GET(merger->ctx->fset->lvlArr, i)->level) {
-        numFile += TARRAY2_SIZE(TARRAY2_GET(merger->ctx->fset->lvlArr, i)->fobjArr);
-        i++;
-      }
+    TAOS_CHECK_GOTO(tsdbMergePlanInit(merger, plan), &lino, _exit);
 
-      numCarry = numFile / merger->sttTrigger;
-      if (numCarry == 0) {
-        break;
-      } else {
-        merger->ctx->level++;
-      }
+    if (merger->policy == TSDB_MERGE_POLICY_TIERED) {
+      tsdbMergeProposeTiered(plan, merger->sttTrigger);
+    } else {
+      tsdbMergeProposeLeveled(plan, merger->sttTrigger, merger->policy == TSDB_MERGE_POLICY_LEVELED_SCORED);
     }
 
-    if (merger->ctx->level <= TSDB_MAX_LEVEL) {
-      TARRAY2_FOREACH_REVERSE(merger->ctx->fset->lvlArr, lvl) {
-        if (TARRAY2_SIZE(lvl->fobjArr) == 0) {
-          continue;
-        }
-
-        if (lvl->level >= merger->ctx->level) {
-          merger->ctx->toData = false;
-        }
+    // merge to data file if no stt file is left on the target level or above
+    merger->ctx->level = plan->level;
+    merger->ctx->toData = true;
+    for (int32_t i = 0; i < plan->numFile; ++i) {
+      if (!plan->best[i] && plan->files[i].level >= merger->ctx->level) {
+        merger->ctx->toData = false;
         break;
       }
     }
 
-    // get number of level-0 files to merge
-    int32_t numFile = pow(merger->sttTrigger, merger->ctx->level);
-    TARRAY2_FOREACH(merger->ctx->fset->lvlArr, lvl) {
-      if (lvl->level == 0) continue;
-      if (lvl->level >= merger->ctx->level) break;
-
-      numFile = numFile - TARRAY2_SIZE(lvl->fobjArr) * pow(merger->sttTrigger, lvl->level);
-    }
-
-    // get file system operations
-    TARRAY2_FOREACH(merger->ctx->fset->lvlArr, lvl) {
-      if (lvl->level >= merger->ctx->level) {
-        break;
-      }
+    tsdbInfo("vgId:%d fid:%d merge stt files to level %d%s by %s policy, score:%.3f", TD_VID(merger->tsdb->pVnode),
+             merger->ctx->fset->fid, merger->ctx->level, merger->ctx->toData ? " and data file" : "",
+             tsdbMergePolicyName(merger->policy), plan->score);
 
-      int32_t numMergeFile;
-      if (lvl->level == 0) {
-        numMergeFile = numFile;
-      } else {
-        numMergeFile = TARRAY2_SIZE(lvl->fobjArr);
+    // get file system operations, readers of the merged files are taken over from the plan or opened now
+    for (int32_t i = 0; i < plan->numFile; ++i) {
+      SMergeFile *file = &plan->files[i];
+      if (!plan->best[i]) {
+        continue;
       }
 
-      for (int32_t i = 0; i < numMergeFile; ++i) {
-        STFileObj *fobj = TARRAY2_GET(lvl->fobjArr, i);
-
-        STFileOp op = {
-            .optype = TSDB_FOP_REMOVE,
-            .fid = merger->ctx->fset->fid,
-            .of = fobj->f[0],
-        };
-        TAOS_CHECK_GOTO(TARRAY2_APPEND(merger->fopArr, op), &lino, _exit);
-
-        SSttFileReader      *reader;
+      if (file->reader == NULL) {
         SSttFileReaderConfig config = {
             .tsdb = merger->tsdb,
             .szPage = merger->szPage,
-            .file[0] = fobj->f[0],
+            .file[0] = file->fobj->f[0],
         };
+        TAOS_CHECK_GOTO(tsdbSttFileReaderOpen(file->fobj->fname, &config, &file->reader), &lino, _exit);
+      }
 
-        TAOS_CHECK_GOTO(tsdbSttFileReaderOpen(fobj->fname, &config, &reader), &lino, _exit);
+      STFileOp op = {
+          .optype = TSDB_FOP_REMOVE,
+          .fid = merger->ctx->fset->fid,
+          .of = file->fobj->f[0],
+      };
+      TAOS_CHECK_GOTO(TARRAY2_APPEND(merger->fopArr, op), &lino, _exit);
 
-        if ((code = TARRAY2_APPEND(merger->sttReaderArr, reader))) {
-          tsdbSttFileReaderClose(&reader);
-          TSDB_CHECK_CODE(code, lino, _exit);
-        }
-      }
+      TAOS_CHECK_GOTO(TARRAY2_APPEND(merger->sttReaderArr, file->reader), &lino, _exit);
+      file->reader = NULL;
     }
 
     if (merger->ctx->level > TSDB_MAX_LEVEL) {
@@ -220,6 +487,7 @@ _exit:
               tstrerror(code));
     tsdbMergeFileSetEndCloseReader(merger);
   }
+  tsdbMergePlanClear(plan);
   return code;
 }
 
@@ -350,6 +618,8 @@ static int32_t tsdbMergeFileSetEnd(SMerger *merger) {
   tsdbMergeFileSetEndCloseReader(merger);
 
   // edit file system
+  METRICS_UPDATE(merger->tsdb->pVnode->writeMetrics.merge_write_bytes, METRIC_LEVEL_HIGH,
+                 tsdbTFileOpArrayWriteSize(merger->fopArr));
   TAOS_CHECK_GOTO(tsdbFSEditBegin(merger->tsdb->pFS, merger->fopArr, TSDB_FEDIT_MERGE), &lino, _exit);
 
   (void)taosThreadMutexLock(&merger->tsdb->mutex);
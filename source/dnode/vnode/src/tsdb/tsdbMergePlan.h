@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "os.h"
+
+#ifndef _TD_TSDB_MERGE_PLAN_H_
+#define _TD_TSDB_MERGE_PLAN_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TSDB_MAX_LEVEL 2  // means max level is 3
+
+// a file joins a size tier if it is at most this times larger than the average of the tier
+#define TSDB_MERGE_TIER_RATIO 1.5
+
+typedef enum {
+  TSDB_MERGE_POLICY_LEVELED = 0,
+  TSDB_MERGE_POLICY_TIERED,
+  TSDB_MERGE_POLICY_LEVELED_SCORED,
+  TSDB_MERGE_POLICY_MAX,
+} EMergePolicy;
+
+/* Exposed Structs */
+typedef struct {
+  struct STFileObj      *fobj;
+  struct SSttFileReader *reader;
+  int32_t                level;
+  int64_t                size;
+  int64_t                nRead;
+  int64_t                nRow;
+  int64_t                nTomb;
+  int64_t                skey;
+  int64_t                ekey;
+} SMergeFile;
+
+/*
+ * A merge policy proposes candidate sets of stt files, each with the level the merged file goes to. Candidates are
+ * scored by the same cost model and the best one is merged:
+ *
+ *   score = (nFile - 1) * (1 + overlap) * (1 + tombDensity) * (1 + log2(1 + nRead)) / (1 + MB rewritten)
+ *
+ * nFile - 1 is the number of files taken off the read path, overlap the share of the key span covered by more than one
+ * file, tombDensity the share of tomb records and nRead the number of times queries found data in the files.
+ */
+typedef struct {
+  SMergeFile *files;      // all stt files of the file set, level by level
+  int32_t     numFile;    // number of files
+  int32_t    *order;      // files sorted by size
+  bool       *candidate;  // files of the candidate being proposed
+  bool       *best;       // files of the best candidate so far
+  int32_t     level;      // level the best candidate is merged to
+  double      score;      // score of the best candidate, negative if there is none
+} SMergePlan;
+
+/* Exposed APIs */
+int32_t tsdbMergePlanPrepare(SMergePlan *plan);
+void    tsdbMergePlanClear(SMergePlan *plan);
+void    tsdbMergeProposeLeveled(SMergePlan *plan, int32_t sttTrigger, bool scored);
+void    tsdbMergeProposeTiered(SMergePlan *plan, int32_t sttTrigger);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*_TD_TSDB_MERGE_PLAN_H_*/
@@ -649,6 +649,20 @@ int32_t tLDataIterOpen2(SLDataIter *pIter, SSttFileReader *pSttFileReader, int32
     return TSDB_CODE_SUCCESS;
   }
 
+  // no data or tomb record of this table in current stt file, skip it without loading any block
+  const SBlockBloomFilter *pBloom = NULL;
+  code = tsdbSttFileReadBloomFilter(pIter->pReader, &pBloom);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  if (pBloom != NULL && tBlockBloomFilterNoContain(pBloom, &pConf->uid, sizeof(pConf->uid))) {
+    tsdbTrace("uid:%" PRIu64 " not in stt file, skip it, %s", pConf->uid, idStr);
+    pIter->pSttBlk = NULL;
+    pIter->iSttBlk = -1;
+    return code;
+  }
+
   if (!pBlockLoadInfo->sttBlockLoaded) {
     code = doLoadSttFilesBlk(pBlockLoadInfo, pIter, pConf->suid, pConf->loadTombFn, pConf->pReader, idStr);
     if (code != TSDB_CODE_SUCCESS) {
@@ -1029,6 +1043,7 @@ int32_t tMergeTreeOpen2(SMergeTree *pMTree, SMergeTreeConf *pConf, SSttDataInfoF
 
       if (hasVal) {
         tMergeTreeAddIter(pMTree, pIter);
+        (void)atomic_add_fetch_64(&pSttLevel->fobjArr->data[i]->nRead, 1);
 
         // let's record the time window for current table of uid in the stt files
         if (pSttDataInfo != NULL && numOfRows > 0) {
@@ -482,6 +482,8 @@ int32_t resetDataBlockIterator(SDataBlockIter* pIter, int32_t order, bool needFr
 
   pIter->order = order;
   pIter->index = -1;
+  pIter->readAheadIndex = -1;
+  pIter->readAheadColIndex = -1;
   pIter->numOfBlocks = 0;
 
   if (pIter->blockList == NULL) {
@@ -1012,7 +1014,9 @@ static int32_t loadFileBlockBrinInfo(STsdbReader* pReader, SArray* pIndexList, S
       TSDB_CHECK_NULL(pScanInfo->pBlockIdxList, code, lino, _end, terrno);
     }
 
-    SFileDataBlockInfo blockInfo = {.tbBlockIdx = TARRAY_SIZE(pScanInfo->pBlockList)};
+    SFileDataBlockInfo blockInfo = {.tbBlockIdx = TARRAY_SIZE(pScanInfo->pBlockList),
+                                    .brinIdx = iter.recordIndex,
+                                    .brinOffset = iter.pCurrentBlk->dp->offset};
     code = recordToBlockInfo(&blockInfo, pRecord);
     TSDB_CHECK_CODE(code, lino, _end);
     sizeInDisk += blockInfo.blockSize;
@@ -1394,7 +1398,7 @@ _end:
 }
 
 static int32_t copyPrimaryTsCol(const SBlockData* pBlockData, SFileBlockDumpInfo* pDumpInfo, SColumnInfoData* pColData,
-                                int32_t dumpedRows, bool asc) {
+                                int32_t dstRow, int32_t dumpedRows, bool asc) {
   int32_t code = TSDB_CODE_SUCCESS;
   int32_t lino = 0;
 
@@ -1403,16 +1407,17 @@ static int32_t copyPrimaryTsCol(const SBlockData* pBlockData, SFileBlockDumpInfo
   TSDB_CHECK_NULL(pColData, code, lino, _end, TSDB_CODE_INVALID_PARA);
   TSDB_CHECK_CONDITION(dumpedRows >= 0, code, lino, _end, TSDB_CODE_INVALID_PARA);
 
+  int64_t* pDst = (int64_t*)pColData->pData + dstRow;
   if (asc) {
-    TAOS_MEMCPY(pColData->pData, &pBlockData->aTSKEY[pDumpInfo->rowIndex], dumpedRows * sizeof(int64_t));
+    TAOS_MEMCPY(pDst, &pBlockData->aTSKEY[pDumpInfo->rowIndex], dumpedRows * sizeof(int64_t));
   } else {
     int32_t startIndex = pDumpInfo->rowIndex - dumpedRows + 1;
-    TAOS_MEMCPY(pColData->pData, &pBlockData->aTSKEY[startIndex], dumpedRows * sizeof(int64_t));
+    TAOS_MEMCPY(pDst, &pBlockData->aTSKEY[startIndex], dumpedRows * sizeof(int64_t));
 
     // todo: opt perf by extract the loop
     // reverse the array list
     int32_t  mid = dumpedRows >> 1u;
-    int64_t* pts = (int64_t*)pColData->pData;
+    int64_t* pts = pDst;
     for (int32_t j = 0; j < mid; ++j) {
       int64_t t = pts[j];
       pts[j] = pts[dumpedRows - j - 1];
@@ -1429,7 +1434,7 @@ _end:
 
 // a faster version of copy procedure.
 static int32_t copyNumericCols(const SColData* pData, SFileBlockDumpInfo* pDumpInfo, SColumnInfoData* pColData,
-                               int32_t dumpedRows, bool asc) {
+                               int32_t dstRow, int32_t dumpedRows, bool asc) {
   int32_t  code = TSDB_CODE_SUCCESS;
   int32_t  lino = 0;
   uint8_t* p = NULL;
@@ -1451,7 +1456,8 @@ static int32_t copyNumericCols(const SColData* pData, SFileBlockDumpInfo* pDumpI
   // make sure it is aligned to 8bit, the allocated memory address is aligned to 256bit
 
   // 1. copy data in a batch model
-  TAOS_MEMCPY(pColData->pData, p, dumpedRows * tDataTypes[pData->type].bytes);
+  char* pDst = pColData->pData + (int64_t)dstRow * tDataTypes[pData->type].bytes;
+  TAOS_MEMCPY(pDst, p, dumpedRows * tDataTypes[pData->type].bytes);
 
   // 2. reverse the array list in case of descending order scan data block
   if (!asc) {
@@ -1462,7 +1468,7 @@ static int32_t copyNumericCols(const SColData* pData, SFileBlockDumpInfo* pDumpI
       case TSDB_DATA_TYPE_DECIMAL64:
       case TSDB_DATA_TYPE_UBIGINT: {
         int32_t  mid = dumpedRows >> 1u;
-        int64_t* pts = (int64_t*)pColData->pData;
+        int64_t* pts = (int64_t*)pDst;
         for (int32_t j = 0; j < mid; ++j) {
           int64_t t = pts[j];
           pts[j] = pts[dumpedRows - j - 1];
@@ -1475,7 +1481,7 @@ static int32_t copyNumericCols(const SColData* pData, SFileBlockDumpInfo* pDumpI
       case TSDB_DATA_TYPE_TINYINT:
       case TSDB_DATA_TYPE_UTINYINT: {
         int32_t mid = dumpedRows >> 1u;
-        int8_t* pts = (int8_t*)pColData->pData;
+        int8_t* pts = (int8_t*)pDst;
         for (int32_t j = 0; j < mid; ++j) {
           int8_t t = pts[j];
           pts[j] = pts[dumpedRows - j - 1];
@@ -1487,7 +1493,7 @@ static int32_t copyNumericCols(const SColData* pData, SFileBlockDumpInfo* pDumpI
       case TSDB_DATA_TYPE_SMALLINT:
       case TSDB_DATA_TYPE_USMALLINT: {
         int32_t  mid = dumpedRows >> 1u;
-        int16_t* pts = (int16_t*)pColData->pData;
+        int16_t* pts = (int16_t*)pDst;
         for (int32_t j = 0; j < mid; ++j) {
           int64_t t = pts[j];
           pts[j] = pts[dumpedRows - j - 1];
@@ -1500,7 +1506,7 @@ static int32_t copyNumericCols(const SColData* pData, SFileBlockDumpInfo* pDumpI
       case TSDB_DATA_TYPE_INT:
       case TSDB_DATA_TYPE_UINT: {
         int32_t  mid = dumpedRows >> 1u;
-        int32_t* pts = (int32_t*)pColData->pData;
+        int32_t* pts = (int32_t*)pDst;
         for (int32_t j = 0; j < mid; ++j) {
           int32_t t = pts[j];
           pts[j] = pts[dumpedRows - j - 1];
@@ -1510,7 +1516,7 @@ static int32_t copyNumericCols(const SColData* pData, SFileBlockDumpInfo* pDumpI
       }
       case TSDB_DATA_TYPE_DECIMAL: {
         int32_t      mid = dumpedRows >> 1u;
-        DecimalWord* pDec = (DecimalWord*)pColData->pData;
+        DecimalWord* pDec = (DecimalWord*)pDst;
         DecimalWord  tmp[2] = {0};
         for (int32_t j = 0; j < mid; ++j) {
           tmp[0] = pDec[2 * j];
@@ -1532,7 +1538,7 @@ static int32_t copyNumericCols(const SColData* pData, SFileBlockDumpInfo* pDumpI
     for (int32_t j = pDumpInfo->rowIndex; rowIndex < dumpedRows; j += step, rowIndex++) {
       uint8_t v = tColDataGetBitValue(pData, j);
       if (v == 0 || v == 1) {
-        colDataSetNull_f(pColData->nullbitmap, rowIndex);
+        colDataSetNull_f(pColData->nullbitmap, dstRow + rowIndex);
         pColData->hasNull = true;
       }
     }
@@ -1589,7 +1595,94 @@ static void blockInfoToRecord(SBrinRecord* record, SFileDataBlockInfo* pBlockInf
   record->count = pBlockInfo->count;
 }
 
-static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader, SRowKey* pLastProcKey) {
+// Copy dumpedRows rows starting from pDumpInfo->rowIndex of the block data to the result block from row dstRow on. The
+// output column i is skipped if pColMask is not NULL and pColMask[i] is 0.
+static int32_t copyBlockDataColumns(STsdbReader* pReader, SBlockData* pBlockData, SFileBlockDumpInfo* pDumpInfo,
+                                    int32_t dstRow, int32_t dumpedRows, const int8_t* pColMask) {
+  int32_t             code = TSDB_CODE_SUCCESS;
+  int32_t             lino = 0;
+  SBlockLoadSuppInfo* pSupInfo = &pReader->suppInfo;
+  SSDataBlock*        pResBlock = pReader->resBlockInfo.pResBlock;
+  int32_t             numOfOutputCols = pSupInfo->numOfCols;
+  bool                asc = ASCENDING_TRAVERSE(pReader->info.order);
+  int32_t             step = asc ? 1 : -1;
+  SColumnInfoData*    pColData = NULL;
+  SColVal             cv = {0};
+  int32_t             i = 0;
+  int32_t             rowIndex = 0;
+
+  if (pSupInfo->colId[i] == PRIMARYKEY_TIMESTAMP_COL_ID) {
+    if (pColMask == NULL || pColMask[i]) {
+      pColData = taosArrayGet(pResBlock->pDataBlock, pSupInfo->slotId[i]);
+      TSDB_CHECK_NULL(pColData, code, lino, _end, TSDB_CODE_INVALID_PARA);
+
+      code = copyPrimaryTsCol(pBlockData, pDumpInfo, pColData, dstRow, dumpedRows, asc);
+      TSDB_CHECK_CODE(code, lino, _end);
+    }
+    i += 1;
+  }
+
+  int32_t colIndex = 0;
+  int32_t num = pBlockData->nColData;
+  while (i < numOfOutputCols && colIndex < num) {
+    rowIndex = 0;
+
+    SColData* pData = tBlockDataGetColDataByIdx(pBlockData, colIndex);
+    if (pData->cid < pSupInfo->colId[i]) {
+      colIndex += 1;
+    } else if (pColMask != NULL && !pColMask[i]) {
+      i += 1;
+    } else if (pData->cid == pSupInfo->colId[i]) {
+      pColData = taosArrayGet(pResBlock->pDataBlock, pSupInfo->slotId[i]);
+      TSDB_CHECK_NULL(pColData, code, lino, _end, TSDB_CODE_INVALID_PARA);
+
+      if (pData->flag == HAS_NONE || pData->flag == HAS_NULL || pData->flag == (HAS_NULL | HAS_NONE)) {
+        colDataSetNNULL(pColData, dstRow, dumpedRows);
+      } else {
+        if (IS_MATHABLE_TYPE(pColData->info.type)) {
+          code = copyNumericCols(pData, pDumpInfo, pColData, dstRow, dumpedRows, asc);
+          TSDB_CHECK_CODE(code, lino, _end);
+        } else {  // varchar/nchar type
+          for (int32_t j = pDumpInfo->rowIndex; rowIndex < dumpedRows; j += step) {
+            code = tColDataGetValue(pData, j, &cv);
+            TSDB_CHECK_CODE(code, lino, _end);
+            code = doCopyColVal(pColData, dstRow + rowIndex++, i, &cv, pSupInfo);
+            TSDB_CHECK_CODE(code, lino, _end);
+          }
+        }
+      }
+
+      colIndex += 1;
+      i += 1;
+    } else {  // the specified column does not exist in file block, fill with null data
+      pColData = taosArrayGet(pResBlock->pDataBlock, pSupInfo->slotId[i]);
+      TSDB_CHECK_NULL(pColData, code, lino, _end, TSDB_CODE_INVALID_PARA);
+
+      colDataSetNNULL(pColData, dstRow, dumpedRows);
+      i += 1;
+    }
+  }
+
+  // fill the mis-matched columns with null value
+  for (; i < numOfOutputCols; ++i) {
+    if (pColMask != NULL && !pColMask[i]) {
+      continue;
+    }
+
+    pColData = taosArrayGet(pResBlock->pDataBlock, pSupInfo->slotId[i]);
+    TSDB_CHECK_NULL(pColData, code, lino, _end, TSDB_CODE_INVALID_PARA);
+
+    colDataSetNNULL(pColData, dstRow, dumpedRows);
+  }
+
+_end:
+  if (code != TSDB_CODE_SUCCESS) {
+    tsdbError("%s failed at line %d since %s", __func__, lino, tstrerror(code));
+  }
+  return code;
+}
+
+static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader, SRowKey* pLastProcKey, const int8_t* pColMask) {
   int32_t             code = TSDB_CODE_SUCCESS;
   int32_t             lino = 0;
   SReaderStatus*      pStatus = NULL;
@@ -1599,11 +1692,9 @@ static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader, SRowKey* pLastPro
   SBlockData*         pBlockData = NULL;
   SFileDataBlockInfo* pBlockInfo = NULL;
   SSDataBlock*        pResBlock = NULL;
-  int32_t             numOfOutputCols = 0;
   int64_t             st = 0;
   bool                asc = false;
   int32_t             step = 0;
-  SColVal             cv = {0};
   SBrinRecord         tmp;
   SBrinRecord*        pRecord = NULL;
 
@@ -1618,7 +1709,6 @@ static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader, SRowKey* pLastPro
 
   pBlockData = &pStatus->fileBlockData;
   pResBlock = pReader->resBlockInfo.pResBlock;
-  numOfOutputCols = pSupInfo->numOfCols;
   st = taosGetTimestampUs();
   asc = ASCENDING_TRAVERSE(pReader->info.order);
   step = asc ? 1 : -1;
@@ -1709,64 +1799,14 @@ static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader, SRowKey* pLastPro
     goto _end;
   }
 
-  int32_t i = 0;
-  int32_t rowIndex = 0;
-
-  SColumnInfoData* pColData = taosArrayGet(pResBlock->pDataBlock, pSupInfo->slotId[i]);
-  TSDB_CHECK_NULL(pColData, code, lino, _end, TSDB_CODE_INVALID_PARA);
-
-  if (pSupInfo->colId[i] == PRIMARYKEY_TIMESTAMP_COL_ID) {
-    code = copyPrimaryTsCol(pBlockData, pDumpInfo, pColData, dumpedRows, asc);
-    TSDB_CHECK_CODE(code, lino, _end);
-    i += 1;
-  }
-
-  int32_t colIndex = 0;
-  int32_t num = pBlockData->nColData;
-  while (i < numOfOutputCols && colIndex < num) {
-    rowIndex = 0;
-
-    SColData* pData = tBlockDataGetColDataByIdx(pBlockData, colIndex);
-    if (pData->cid < pSupInfo->colId[i]) {
-      colIndex += 1;
-    } else if (pData->cid == pSupInfo->colId[i]) {
-      pColData = taosArrayGet(pResBlock->pDataBlock, pSupInfo->slotId[i]);
-      TSDB_CHECK_NULL(pColData, code, lino, _end, TSDB_CODE_INVALID_PARA);
-
-      if (pData->flag == HAS_NONE || pData->flag == HAS_NULL || pData->flag == (HAS_NULL | HAS_NONE)) {
-        colDataSetNNULL(pColData, 0, dumpedRows);
-      } else {
-        if (IS_MATHABLE_TYPE(pColData->info.type)) {
-          code = copyNumericCols(pData, pDumpInfo, pColData, dumpedRows, asc);
-          TSDB_CHECK_CODE(code, lino, _end);
-        } else {  // varchar/nchar type
-          for (int32_t j = pDumpInfo->rowIndex; rowIndex < dumpedRows; j += step) {
-            code = tColDataGetValue(pData, j, &cv);
-            TSDB_CHECK_CODE(code, lino, _end);
-            code = doCopyColVal(pColData, rowIndex++, i, &cv, pSupInfo);
-            TSDB_CHECK_CODE(code, lino, _end);
-          }
-        }
-      }
-
-      colIndex += 1;
-      i += 1;
-    } else {  // the specified column does not exist in file block, fill with null data
-      pColData = taosArrayGet(pResBlock->pDataBlock, pSupInfo->slotId[i]);
-      TSDB_CHECK_NULL(pColData, code, lino, _end, TSDB_CODE_INVALID_PARA);
-
-      colDataSetNNULL(pColData, 0, dumpedRows);
-      i += 1;
-    }
-  }
-
-  // fill the mis-matched columns with null value
-  while (i < numOfOutputCols) {
-    pColData = taosArrayGet(pResBlock->pDataBlock, pSupInfo->slotId[i]);
-    TSDB_CHECK_NULL(pColData, code, lino, _end, TSDB_CODE_INVALID_PARA);
+  code = copyBlockDataColumns(pReader, pBlockData, pDumpInfo, 0, dumpedRows, pColMask);
+  TSDB_CHECK_CODE(code, lino, _end);
 
-    colDataSetNNULL(pColData, 0, dumpedRows);
-    i += 1;
+  // remember the rows copied, the other columns of them are copied by tsdbRetrieveRemainColumns2
+  if (pColMask != NULL) {
+    pStatus->lateLoad.pending = true;
+    pStatus->lateLoad.rowIndex = pDumpInfo->rowIndex;
+    pStatus->lateLoad.rows = dumpedRows;
   }
 
   pResBlock->info.dataLoad = 1;
@@ -1830,14 +1870,143 @@ _end:
   return pReader->info.pSchema;
 }
 
-static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockIter, SBlockData* pBlockData,
-                                   uint64_t uid) {
+#define TSDB_READ_AHEAD_MAX_BLOCKS 64
+
+// Whether a block to read ahead may be kept by the block filter of the caller, which judges the block by its zone map
+// in the way the table scan does before loading the block. Blocks whose zone map lacks some loaded columns are kept.
+static bool readAheadKeepBlock(STsdbReader* pReader, SFileDataBlockInfo* pInfo) {
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+  SSDataBlock*        pResBlock = pReader->resBlockInfo.pResBlock;
+  bool                keep = true;
+
+  if (pReader->blockFilterFn == NULL || pReader->type == TIMEWINDOW_RANGE_EXTERNAL || !pSup->smaValid ||
+      pResBlock == NULL) {
+    return true;
+  }
+
+  // the aggregates of the current block are copied into the result block already, so colAggArray can be reused
+  int32_t code = tsdbDataFileReadBlockZoneMap(pReader->pFileReader, pInfo->brinOffset, pInfo->brinIdx,
+                                              &pSup->colAggArray);
+  if (code != TSDB_CODE_SUCCESS || pSup->colAggArray.size == 0) {
+    return true;
+  }
+
+  int32_t numOfSlots = taosArrayGetSize(pResBlock->pDataBlock);
+  if (pSup->numOfAheadAgg < numOfSlots) {
+    SColumnDataAgg* p = taosMemoryRealloc(pSup->pAheadAgg, numOfSlots * sizeof(SColumnDataAgg));
+    if (p == NULL) {
+      return true;
+    }
+    pSup->pAheadAgg = p;
+    pSup->numOfAheadAgg = numOfSlots;
+  }
+
+  for (int32_t i = 0; i < numOfSlots; ++i) {
+    pSup->pAheadAgg[i].colId = -1;
+  }
+
+  SColumnDataAgg tsAgg = {.colId = PRIMARYKEY_TIMESTAMP_COL_ID, .min = pInfo->firstKey, .max = pInfo->lastKey};
+  pSup->pAheadAgg[pSup->slotId[0]] = tsAgg;
+
+  int32_t i = 0, j = 1;
+  while (j < pSup->numOfCols) {
+    if (i >= pSup->colAggArray.size || pSup->colId[j] < pSup->colAggArray.data[i].colId) {
+      return true;
+    }
+
+    SColumnDataAgg* pAgg = &pSup->colAggArray.data[i];
+    if (pAgg->colId == pSup->colId[j]) {
+      pSup->pAheadAgg[pSup->slotId[j]] = *pAgg;
+      j += 1;
+    }
+    i += 1;
+  }
+
+  code = pReader->blockFilterFn(pSup->pAheadAgg, numOfSlots, pInfo->numRow, pReader->blockFilterParam, &keep);
+  return (code != TSDB_CODE_SUCCESS) || keep;
+}
+
+// Ask the OS to read the next blocks of the iterator while the current one is decoded, so that several reads are in
+// flight for a scan. Blocks the caller can drop by their zone map are skipped. The key part of the blocks in the window
+// is read ahead first. The columns cids of the next block are read ahead then, their place being found in its key
+// part read ahead by an earlier call. It is only a hint, an error is logged and ignored.
+static void doReadAheadFileBlocks(STsdbReader* pReader, SDataBlockIter* pBlockIter, int16_t* cids, int32_t ncid) {
+  if (tsQueryReadAheadSizeMB <= 0 || pReader->pFileReader == NULL) {
+    return;
+  }
+
+  bool    asc = ASCENDING_TRAVERSE(pBlockIter->order);
+  int32_t step = asc ? 1 : -1;
+  int64_t maxSize = (int64_t)tsQueryReadAheadSizeMB * 1024 * 1024;
+  int32_t next = pBlockIter->readAheadIndex;
+  int32_t code = TSDB_CODE_SUCCESS;
+
+  // the blocks between the current one and the next one to read ahead are already requested
+  if (next < 0 || (asc && next <= pBlockIter->index) || (!asc && next >= pBlockIter->index)) {
+    next = pBlockIter->index + step;
+  }
+
+  int64_t size = 0;
+  for (int32_t i = pBlockIter->index + step; i != next; i += step) {
+    SFileDataBlockInfo* pInfo = taosArrayGet(pBlockIter->blockList, i);
+    if (pInfo != NULL) {
+      size += pInfo->blockKeySize;
+    }
+  }
+
+  while (next >= 0 && next < pBlockIter->numOfBlocks && size < maxSize &&
+         (next - pBlockIter->index) * step <= TSDB_READ_AHEAD_MAX_BLOCKS) {
+    SFileDataBlockInfo* pInfo = taosArrayGet(pBlockIter->blockList, next);
+    if (pInfo == NULL) {
+      break;
+    }
+
+    next += step;
+    if (!readAheadKeepBlock(pReader, pInfo)) {
+      continue;
+    }
+
+    code = tsdbDataFileReadAhead(pReader->pFileReader, pInfo->blockOffset, pInfo->blockKeySize);
+    if (code != TSDB_CODE_SUCCESS) {
+      tsdbDebug("%p failed to read ahead file blocks, code:%s, %s", pReader, tstrerror(code), pReader->idStr);
+    }
+    size += pInfo->blockKeySize;
+  }
+
+  pBlockIter->readAheadIndex = next;
+
+  // the columns of the next block, once for each block
+  int32_t index = pBlockIter->index + step;
+  if (index < 0 || index >= pBlockIter->numOfBlocks || pBlockIter->readAheadColIndex == index) {
+    return;
+  }
+
+  SFileDataBlockInfo* pInfo = taosArrayGet(pBlockIter->blockList, index);
+  if (pInfo == NULL) {
+    return;
+  }
+
+  pBlockIter->readAheadColIndex = index;
+  if (!readAheadKeepBlock(pReader, pInfo)) {
+    return;
+  }
+
+  SBrinRecord record;
+  blockInfoToRecord(&record, pInfo, &pReader->suppInfo);
+  code = tsdbDataFileReadAheadColumns(pReader->pFileReader, &record, cids, ncid);
+  if (code != TSDB_CODE_SUCCESS) {
+    tsdbDebug("%p failed to read ahead block columns, code:%s, %s", pReader, tstrerror(code), pReader->idStr);
+  }
+}
+
+// load the columns cids, in ascending order, of the current file block besides the key part
+static int32_t doLoadFileBlockDataColumns(STsdbReader* pReader, SDataBlockIter* pBlockIter, SBlockData* pBlockData,
+                                          uint64_t uid, int16_t* cids, int32_t ncid) {
   int32_t             code = TSDB_CODE_SUCCESS;
   int32_t             lino = 0;
   STSchema*           pSchema = NULL;
   SFileDataBlockInfo* pBlockInfo = NULL;
   SBlockLoadSuppInfo* pSup = NULL;
-  SFileBlockDumpInfo* pDumpInfo = NULL;
   int64_t             st = 0;
   SBrinRecord         tmp;
   SBrinRecord*        pRecord = NULL;
@@ -1863,12 +2032,10 @@ static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockI
   code = getCurrentBlockInfo(pBlockIter, &pBlockInfo, pReader->idStr);
   TSDB_CHECK_CODE(code, lino, _end);
 
-  pDumpInfo = &pReader->status.fBlockDumpInfo;
-
   blockInfoToRecord(&tmp, pBlockInfo, pSup);
   pRecord = &tmp;
-  code = tsdbDataFileReadBlockDataByColumn(pReader->pFileReader, pRecord, pBlockData, pSchema, &pSup->colId[1],
-                                           pSup->numOfCols - 1);
+  doReadAheadFileBlocks(pReader, pBlockIter, cids, ncid);
+  code = tsdbDataFileReadBlockDataByColumn(pReader->pFileReader, pRecord, pBlockData, pSchema, cids, ncid);
   if (code != TSDB_CODE_SUCCESS) {
     tsdbError("%p error occurs in loading file block, global index:%d, table index:%d, brange:%" PRId64 "-%" PRId64
               ", rows:%d, code:%s %s",
@@ -1877,7 +2044,9 @@ static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockI
     TSDB_CHECK_CODE(code, lino, _end);
   }
 
-  double elapsedTime = (taosGetTimestampUs() - st) / 1000.0;
+  int64_t et = taosGetTimestampUs();
+  double  elapsedTime = (et - st) / 1000.0;
+  tsdbUpdateReadLatency(pReader->pTsdb, et - st);
 
   tsdbDebug("%p load file block into buffer, global index:%d, index in table block list:%d, brange:%" PRId64 "-%" PRId64
             ", rows:%d, minVer:%" PRId64 ", maxVer:%" PRId64 ", elapsed time:%.2f ms, %s",
@@ -1885,7 +2054,6 @@ static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockI
             pRecord->numRow, pRecord->minVer, pRecord->maxVer, elapsedTime, pReader->idStr);
 
   pReader->cost.blockLoadTime += elapsedTime;
-  pDumpInfo->allDumped = false;
 
 _end:
   if (code != TSDB_CODE_SUCCESS) {
@@ -1894,6 +2062,18 @@ _end:
   return code;
 }
 
+static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockIter, SBlockData* pBlockData,
+                                   uint64_t uid) {
+  int32_t             code = TSDB_CODE_SUCCESS;
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+
+  code = doLoadFileBlockDataColumns(pReader, pBlockIter, pBlockData, uid, &pSup->colId[1], pSup->numOfCols - 1);
+  if (code == TSDB_CODE_SUCCESS) {
+    pReader->status.fBlockDumpInfo.allDumped = false;
+  }
+  return code;
+}
+
 /**
  * This is an two rectangles overlap cases.
  */
@@ -3445,6 +3625,102 @@ void updateComposedBlockInfo(STsdbReader* pReader, double el, STableBlockScanInf
   pReader->cost.buildComposedBlockTime += el;
 }
 
+/*
+ * Copy the rows of the file block from the current one on that sort before the current rows of mem, imem and stt files
+ * column by column, instead of merging them one by one. The run ends at a row that is not valid, shares its key with the
+ * next row, or is the last row of the block, which may overlap with the neighbor block. Those rows, and the ones
+ * overlapping with the other sources, go through the row merge.
+ */
+static int32_t copyDistinctRunFromFileBlock(STsdbReader* pReader, STableBlockScanInfo* pBlockScanInfo,
+                                            SBlockData* pBlockData, SSttBlockReader* pSttBlockReader,
+                                            int32_t* pCopied) {
+  int32_t             code = TSDB_CODE_SUCCESS;
+  int32_t             lino = 0;
+  SFileBlockDumpInfo* pDumpInfo = &pReader->status.fBlockDumpInfo;
+  SSDataBlock*        pResBlock = pReader->resBlockInfo.pResBlock;
+  bool                asc = ASCENDING_TRAVERSE(pReader->info.order);
+  int32_t             step = asc ? 1 : -1;
+  int64_t             bound = asc ? INT64_MAX : INT64_MIN;
+  TSDBROW*            pRow = NULL;
+  int32_t             numOfRows = 0;
+
+  *pCopied = 0;
+
+  // the run stops before the first key of the other sources
+  if (pBlockScanInfo->iter.hasVal) {
+    code = getValidMemRow(&pBlockScanInfo->iter, pBlockScanInfo->delSkyline, pReader, &pRow);
+    TSDB_CHECK_CODE(code, lino, _end);
+    if (pRow != NULL) {
+      bound = asc ? TMIN(bound, TSDBROW_TS(pRow)) : TMAX(bound, TSDBROW_TS(pRow));
+    }
+  }
+
+  if (pBlockScanInfo->iiter.hasVal) {
+    code = getValidMemRow(&pBlockScanInfo->iiter, pBlockScanInfo->delSkyline, pReader, &pRow);
+    TSDB_CHECK_CODE(code, lino, _end);
+    if (pRow != NULL) {
+      bound = asc ? TMIN(bound, TSDBROW_TS(pRow)) : TMAX(bound, TSDBROW_TS(pRow));
+    }
+  }
+
+  if (hasDataInSttBlock(pBlockScanInfo)) {
+    int64_t ts = getCurrentKeyInSttBlock(pSttBlockReader)->ts;
+    bound = asc ? TMIN(bound, ts) : TMAX(bound, ts);
+  }
+
+  int32_t capacity = pReader->resBlockInfo.capacity - pResBlock->info.rows;
+  int32_t lastRow = asc ? pBlockData->nRow - 1 : 0;
+  bool    hasPk = pReader->suppInfo.numOfPks > 0;
+  for (int32_t i = pDumpInfo->rowIndex; i != lastRow && numOfRows < capacity; i += step, ++numOfRows) {
+    int64_t ts = pBlockData->aTSKEY[i];
+    if ((asc && ts >= bound) || ((!asc) && ts <= bound)) {
+      break;
+    }
+
+    bool valid = false;
+    code = isValidFileBlockRow(pBlockData, i, pBlockScanInfo, asc, &pReader->info, pReader, &valid);
+    TSDB_CHECK_CODE(code, lino, _end);
+    if (!valid) {
+      break;
+    }
+
+    if (ts == pBlockData->aTSKEY[i + step]) {
+      if (!hasPk) {
+        break;
+      }
+
+      SRowKey key, nextKey;
+      tColRowGetKey(pBlockData, i, &key);
+      tColRowGetKey(pBlockData, i + step, &nextKey);
+      if (pkCompEx(&key, &nextKey) == 0) {
+        break;
+      }
+    }
+  }
+
+  if (numOfRows == 0) {
+    goto _end;
+  }
+
+  pReader->suppInfo.args = pReader->pTsdb->pVnode->pBse;
+  code = copyBlockDataColumns(pReader, pBlockData, pDumpInfo, pResBlock->info.rows, numOfRows, NULL);
+  TSDB_CHECK_CODE(code, lino, _end);
+
+  pDumpInfo->rowIndex += step * numOfRows;
+  tColRowGetKeyDeepCopy(pBlockData, pDumpInfo->rowIndex - step, pReader->suppInfo.pkSrcSlot,
+                        &pBlockScanInfo->lastProcKey);
+
+  pResBlock->info.dataLoad = 1;
+  pResBlock->info.rows += numOfRows;
+  *pCopied = numOfRows;
+
+_end:
+  if (code != TSDB_CODE_SUCCESS) {
+    tsdbError("%s failed at line %d since %s", __func__, lino, tstrerror(code));
+  }
+  return code;
+}
+
 static int32_t buildComposedDataBlock(STsdbReader* pReader) {
   int32_t              code = TSDB_CODE_SUCCESS;
   int32_t              lino = 0;
@@ -3493,7 +3769,7 @@ static int32_t buildComposedDataBlock(STsdbReader* pReader) {
                     ((asc && ((pBlockInfo->lastKey < keyInBuf.ts) || (keyInBuf.ts == INT64_MIN))) ||
                      (!asc && (pBlockInfo->lastKey > keyInBuf.ts)));
   if (directCopy) {
-    code = copyBlockDataToSDataBlock(pReader, &pBlockScanInfo->lastProcKey);
+    code = copyBlockDataToSDataBlock(pReader, &pBlockScanInfo->lastProcKey, NULL);
     TSDB_CHECK_CODE(code, lino, _end);
     goto _end;
   }
@@ -3542,8 +3818,14 @@ static int32_t buildComposedDataBlock(STsdbReader* pReader) {
       break;
     }
 
-    code = buildComposedDataBlockImpl(pReader, pBlockScanInfo, pBlockData, pSttBlockReader);
+    // copy the rows not overlapping with the other sources in a batch, merge the others row by row
+    int32_t copied = 0;
+    code = copyDistinctRunFromFileBlock(pReader, pBlockScanInfo, pBlockData, pSttBlockReader, &copied);
     TSDB_CHECK_CODE(code, lino, _end);
+    if (copied == 0) {
+      code = buildComposedDataBlockImpl(pReader, pBlockScanInfo, pBlockData, pSttBlockReader);
+      TSDB_CHECK_CODE(code, lino, _end);
+    }
 
     // currently loaded file data block is consumed
     if ((pBlockData->nRow > 0) && (pDumpInfo->rowIndex >= pBlockData->nRow || pDumpInfo->rowIndex < 0)) {
@@ -5840,6 +6122,7 @@ void tsdbReaderClose2(void* ptr) {
 
   SBlockLoadSuppInfo* pSupInfo = &pReader->suppInfo;
   TARRAY2_DESTROY(&pSupInfo->colAggArray, NULL);
+  taosMemoryFreeClear(pSupInfo->pAheadAgg);
 
   if (pSupInfo->buildBuf) {
     for (int32_t i = 0; i < pSupInfo->numOfCols; ++i) {
@@ -5855,6 +6138,7 @@ void tsdbReaderClose2(void* ptr) {
   }
 
   taosMemoryFree(pSupInfo->colId);
+  taosMemoryFree(pReader->status.lateLoad.filterColId);
   tBlockDataDestroy(&pReader->status.fileBlockData);
   cleanupDataBlockIterator(&pReader->status.blockIter, shouldFreePkBuf(&pReader->suppInfo));
 
@@ -6442,7 +6726,9 @@ _end:
   return code;
 }
 
-int32_t tsdbRetrieveDatablockSMA2(STsdbReader* pReader, SSDataBlock* pDataBlock, bool* allHave, bool* hasNullSMA) {
+// the block aggregates come from the .sma file, or from the zone map in the .head file if zoneMap is true. Columns
+// absent from the .sma file are all NULL, while those absent from the zone map are unknown.
+static int32_t doRetrieveDatablockAgg(STsdbReader* pReader, SSDataBlock* pDataBlock, bool* allHave, bool zoneMap) {
   int32_t             code = TSDB_CODE_SUCCESS;
   int32_t             lino = 0;
   SColumnDataAgg**    pBlockSMA = NULL;
@@ -6478,12 +6764,17 @@ int32_t tsdbRetrieveDatablockSMA2(STsdbReader* pReader, SSDataBlock* pDataBlock,
   //  int64_t st = taosGetTimestampUs();
   TARRAY2_CLEAR(&pSup->colAggArray, 0);
 
-  SBrinRecord pRecord;
-  blockInfoToRecord(&pRecord, pBlockInfo, pSup);
-  code = tsdbDataFileReadBlockSma(pReader->pFileReader, &pRecord, &pSup->colAggArray);
+  if (zoneMap) {
+    code = tsdbDataFileReadBlockZoneMap(pReader->pFileReader, pBlockInfo->brinOffset, pBlockInfo->brinIdx,
+                                        &pSup->colAggArray);
+  } else {
+    SBrinRecord pRecord;
+    blockInfoToRecord(&pRecord, pBlockInfo, pSup);
+    code = tsdbDataFileReadBlockSma(pReader->pFileReader, &pRecord, &pSup->colAggArray);
+  }
   if (code != TSDB_CODE_SUCCESS) {
-    tsdbDebug("vgId:%d, failed to load block SMA for uid %" PRIu64 ", code:%s, %s", 0, pBlockInfo->uid, tstrerror(code),
-              pReader->idStr);
+    tsdbDebug("vgId:%d, failed to load block %s for uid %" PRIu64 ", code:%s, %s", 0, zoneMap ? "zone map" : "SMA",
+              pBlockInfo->uid, tstrerror(code), pReader->idStr);
     TSDB_CHECK_CODE(code, lino, _end);
   }
 
@@ -6514,8 +6805,12 @@ int32_t tsdbRetrieveDatablockSMA2(STsdbReader* pReader, SSDataBlock* pDataBlock,
     }
   }
 
-  // do fill all null column value SMA info
-  code = doFillNullColSMA(pSup, pBlockInfo->numRow, numOfCols, pTsAgg);
+  if (zoneMap) {
+    code = TARRAY2_INSERT_PTR(&pSup->colAggArray, 0, pTsAgg);
+  } else {
+    // do fill all null column value SMA info
+    code = doFillNullColSMA(pSup, pBlockInfo->numRow, numOfCols, pTsAgg);
+  }
   TSDB_CHECK_CODE(code, lino, _end);
 
   size_t size = pSup->colAggArray.size;
@@ -6537,12 +6832,75 @@ int32_t tsdbRetrieveDatablockSMA2(STsdbReader* pReader, SSDataBlock* pDataBlock,
   }
 
   *pBlockSMA = pResBlock->pBlockAgg;
-  pReader->cost.smaDataLoad += 1;
+  if (!zoneMap) {
+    pReader->cost.smaDataLoad += 1;
+
+    //  double elapsedTime = (taosGetTimestampUs() - st) / 1000.0;
+    pReader->cost.smaLoadTime += 0;  // elapsedTime;
+  }
+
+  tsdbDebug("vgId:%d, succeed to load block %s for uid %" PRIu64 ", %s", 0, zoneMap ? "zone map" : "SMA",
+            pBlockInfo->uid, pReader->idStr);
+
+_end:
+  if (code != TSDB_CODE_SUCCESS) {
+    tsdbError("%s failed at line %d since %s", __func__, lino, tstrerror(code));
+  }
+  return code;
+}
+
+int32_t tsdbRetrieveDatablockSMA2(STsdbReader* pReader, SSDataBlock* pDataBlock, bool* allHave, bool* hasNullSMA) {
+  return doRetrieveDatablockAgg(pReader, pDataBlock, allHave, false);
+}
+
+int32_t tsdbRetrieveDatablockZoneMap2(STsdbReader* pReader, SSDataBlock* pDataBlock, bool* allHave) {
+  return doRetrieveDatablockAgg(pReader, pDataBlock, allHave, true);
+}
+
+// Split the output columns into the ones used by the filter, which are loaded first, and the remain ones. The id list
+// is kept by the caller during the scan, so the result is reused until another list is given.
+static int32_t prepareLateLoadColumns(STsdbReader* pReader, const SArray* pIdList) {
+  int32_t             code = TSDB_CODE_SUCCESS;
+  int32_t             lino = 0;
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+  SBlockLateLoadInfo* pLateLoad = &pReader->status.lateLoad;
+
+  if (pLateLoad->pIdList == pIdList) {
+    return code;
+  }
 
-  //  double elapsedTime = (taosGetTimestampUs() - st) / 1000.0;
-  pReader->cost.smaLoadTime += 0;  // elapsedTime;
+  if (pLateLoad->filterColId == NULL) {
+    pLateLoad->filterColId = taosMemoryCalloc(pSup->numOfCols, sizeof(int16_t) * 2 + sizeof(int8_t));
+    TSDB_CHECK_NULL(pLateLoad->filterColId, code, lino, _end, terrno);
 
-  tsdbDebug("vgId:%d, succeed to load block SMA for uid %" PRIu64 ", %s", 0, pBlockInfo->uid, pReader->idStr);
+    pLateLoad->remainColId = pLateLoad->filterColId + pSup->numOfCols;
+    pLateLoad->colMask = (int8_t*)(pLateLoad->remainColId + pSup->numOfCols);
+  }
+
+  pLateLoad->numOfFilterCols = 0;
+  pLateLoad->numOfRemainCols = 0;
+
+  // the key part, including the primary timestamp and the primary key, is always loaded
+  pLateLoad->colMask[0] = 1;
+  for (int32_t i = 1; i < pSup->numOfCols; ++i) {
+    bool   inFilter = (pSup->numOfPks > 0 && i == pSup->pkSrcSlot + 1);
+    size_t size = taosArrayGetSize(pIdList);
+    for (int32_t j = 0; j < size && !inFilter; ++j) {
+      if (*(int16_t*)taosArrayGet(pIdList, j) == pSup->colId[i]) {
+        inFilter = true;
+        break;
+      }
+    }
+
+    pLateLoad->colMask[i] = inFilter;
+    if (inFilter) {
+      pLateLoad->filterColId[pLateLoad->numOfFilterCols++] = pSup->colId[i];
+    } else {
+      pLateLoad->remainColId[pLateLoad->numOfRemainCols++] = pSup->colId[i];
+    }
+  }
+
+  pLateLoad->pIdList = pIdList;
 
 _end:
   if (code != TSDB_CODE_SUCCESS) {
@@ -6551,18 +6909,20 @@ _end:
   return code;
 }
 
-static int32_t doRetrieveDataBlock(STsdbReader* pReader, SSDataBlock** pBlock) {
+static int32_t doRetrieveDataBlock(STsdbReader* pReader, SSDataBlock** pBlock, const SArray* pIdList) {
   int32_t              code = TSDB_CODE_SUCCESS;
   int32_t              lino = 0;
   SReaderStatus*       pStatus = NULL;
   SFileDataBlockInfo*  pBlockInfo = NULL;
   STableBlockScanInfo* pBlockScanInfo = NULL;
+  SBlockLateLoadInfo*  pLateLoad = NULL;
   bool                 reset = false;
 
   TSDB_CHECK_NULL(pReader, code, lino, _end, TSDB_CODE_INVALID_PARA);
   TSDB_CHECK_NULL(pBlock, code, lino, _end, TSDB_CODE_INVALID_PARA);
 
   pStatus = &pReader->status;
+  pLateLoad = &pStatus->lateLoad;
   *pBlock = NULL;
 
   code = getCurrentBlockInfo(&pStatus->blockIter, &pBlockInfo, pReader->idStr);
@@ -6574,12 +6934,29 @@ static int32_t doRetrieveDataBlock(STsdbReader* pReader, SSDataBlock** pBlock) {
   code = getTableBlockScanInfo(pStatus->pTableMap, pBlockInfo->uid, &pBlockScanInfo, pReader->idStr);
   TSDB_CHECK_CODE(code, lino, _end);
 
+  if (pIdList != NULL) {
+    code = prepareLateLoadColumns(pReader, pIdList);
+    TSDB_CHECK_CODE(code, lino, _end);
+  }
+
+  // a block larger than the result block is rarely dumped in whole, so it is loaded at once
   reset = true;
-  code = doLoadFileBlockData(pReader, &pStatus->blockIter, &pStatus->fileBlockData, pBlockScanInfo->uid);
-  TSDB_CHECK_CODE(code, lino, _end);
+  if (pIdList != NULL && pLateLoad->numOfRemainCols > 0 && pBlockInfo->numRow <= pReader->resBlockInfo.capacity) {
+    // only the filter columns, the remain ones are loaded by tsdbRetrieveRemainColumns2 if any row is qualified
+    code = doLoadFileBlockDataColumns(pReader, &pStatus->blockIter, &pStatus->fileBlockData, pBlockScanInfo->uid,
+                                      pLateLoad->filterColId, pLateLoad->numOfFilterCols);
+    TSDB_CHECK_CODE(code, lino, _end);
 
-  code = copyBlockDataToSDataBlock(pReader, &pBlockScanInfo->lastProcKey);
-  TSDB_CHECK_CODE(code, lino, _end);
+    pStatus->fBlockDumpInfo.allDumped = false;
+    code = copyBlockDataToSDataBlock(pReader, &pBlockScanInfo->lastProcKey, pLateLoad->colMask);
+    TSDB_CHECK_CODE(code, lino, _end);
+  } else {
+    code = doLoadFileBlockData(pReader, &pStatus->blockIter, &pStatus->fileBlockData, pBlockScanInfo->uid);
+    TSDB_CHECK_CODE(code, lino, _end);
+
+    code = copyBlockDataToSDataBlock(pReader, &pBlockScanInfo->lastProcKey, NULL);
+    TSDB_CHECK_CODE(code, lino, _end);
+  }
 
   *pBlock = pReader->resBlockInfo.pResBlock;
 
@@ -6593,6 +6970,17 @@ _end:
   return code;
 }
 
+static STsdbReader* getRetrieveReader(STsdbReader* pReader) {
+  if (pReader->type == TIMEWINDOW_RANGE_EXTERNAL) {
+    if (pReader->step == EXTERNAL_ROWS_PREV) {
+      return pReader->innerReader[0];
+    } else if (pReader->step == EXTERNAL_ROWS_NEXT) {
+      return pReader->innerReader[1];
+    }
+  }
+  return pReader;
+}
+
 int32_t tsdbRetrieveDataBlock2(void* p, SSDataBlock** pBlock, SArray* pIdList) {
   int32_t      code = TSDB_CODE_SUCCESS;
   int32_t      lino = 0;
@@ -6604,16 +6992,10 @@ int32_t tsdbRetrieveDataBlock2(void* p, SSDataBlock** pBlock, SArray* pIdList) {
 
   *pBlock = NULL;
 
-  pTReader = pReader;
-  if (pReader->type == TIMEWINDOW_RANGE_EXTERNAL) {
-    if (pReader->step == EXTERNAL_ROWS_PREV) {
-      pTReader = pReader->innerReader[0];
-    } else if (pReader->step == EXTERNAL_ROWS_NEXT) {
-      pTReader = pReader->innerReader[1];
-    }
-  }
+  pTReader = getRetrieveReader(pReader);
 
   SReaderStatus* pStatus = &pTReader->status;
+  pStatus->lateLoad.pending = false;
   if (pStatus->composedDataBlock || pReader->info.execMode == READER_EXEC_ROWS) {
     //    tsdbReaderSuspend2(pReader);
     //    tsdbReaderResume2(pReader);
@@ -6621,7 +7003,12 @@ int32_t tsdbRetrieveDataBlock2(void* p, SSDataBlock** pBlock, SArray* pIdList) {
     goto _end;
   }
 
-  code = doRetrieveDataBlock(pTReader, pBlock);
+  code = doRetrieveDataBlock(pTReader, pBlock, pIdList);
+
+  // keep the reader locked until the remain columns are loaded, so it cannot be suspended in between
+  if (code == TSDB_CODE_SUCCESS && pStatus->lateLoad.pending) {
+    goto _end;
+  }
 
   tsdbTrace("tsdb/read-retrieve: %p, unlock read mutex", pReader);
   (void)tsdbReleaseReader(pReader);
@@ -6636,6 +7023,76 @@ _end:
   return code;
 }
 
+int32_t tsdbRetrieveRemainColumns2(void* p, SSDataBlock* pBlock, bool load) {
+  int32_t              code = TSDB_CODE_SUCCESS;
+  int32_t              lino = 0;
+  STsdbReader*         pReader = (STsdbReader*)p;
+  STsdbReader*         pTReader = NULL;
+  SReaderStatus*       pStatus = NULL;
+  SBlockLateLoadInfo*  pLateLoad = NULL;
+  SFileDataBlockInfo*  pBlockInfo = NULL;
+  STableBlockScanInfo* pBlockScanInfo = NULL;
+
+  TSDB_CHECK_NULL(pReader, code, lino, _end, TSDB_CODE_INVALID_PARA);
+
+  pTReader = getRetrieveReader(pReader);
+  pStatus = &pTReader->status;
+  pLateLoad = &pStatus->lateLoad;
+  if (!pLateLoad->pending) {
+    goto _end;
+  }
+
+  pLateLoad->pending = false;
+  code = getCurrentBlockInfo(&pStatus->blockIter, &pBlockInfo, pTReader->idStr);
+  if (code == TSDB_CODE_SUCCESS) {
+    code = getTableBlockScanInfo(pStatus->pTableMap, pBlockInfo->uid, &pBlockScanInfo, pTReader->idStr);
+  }
+
+  if (code == TSDB_CODE_SUCCESS && load) {
+    code = (pBlock == pTReader->resBlockInfo.pResBlock) ? TSDB_CODE_SUCCESS : TSDB_CODE_INVALID_PARA;
+    if (code == TSDB_CODE_SUCCESS) {
+      code = doLoadFileBlockDataColumns(pTReader, &pStatus->blockIter, &pStatus->fileBlockData, pBlockScanInfo->uid,
+                                        pLateLoad->remainColId, pLateLoad->numOfRemainCols);
+    }
+
+    if (code == TSDB_CODE_SUCCESS) {
+      // copy the same rows as the filter columns, the mask is flipped to select the remain columns
+      SFileBlockDumpInfo dumpInfo = {.rowIndex = pLateLoad->rowIndex};
+      int32_t            numOfCols = pTReader->suppInfo.numOfCols;
+
+      for (int32_t i = 0; i < numOfCols; ++i) {
+        pLateLoad->colMask[i] = !pLateLoad->colMask[i];
+      }
+      code =
+          copyBlockDataColumns(pTReader, &pStatus->fileBlockData, &dumpInfo, 0, pLateLoad->rows, pLateLoad->colMask);
+      for (int32_t i = 0; i < numOfCols; ++i) {
+        pLateLoad->colMask[i] = !pLateLoad->colMask[i];
+      }
+    }
+  }
+
+  // the rest of a block not dumped in whole is merged from the block data later, which needs all the columns
+  if (code == TSDB_CODE_SUCCESS && !pStatus->fBlockDumpInfo.allDumped) {
+    SBlockLoadSuppInfo* pSup = &pTReader->suppInfo;
+    code = doLoadFileBlockDataColumns(pTReader, &pStatus->blockIter, &pStatus->fileBlockData, pBlockScanInfo->uid,
+                                      &pSup->colId[1], pSup->numOfCols - 1);
+  }
+
+  if (code != TSDB_CODE_SUCCESS) {
+    tBlockDataReset(&pStatus->fileBlockData);
+  }
+
+  tsdbTrace("tsdb/read-retrieve: %p, unlock read mutex", pReader);
+  (void)tsdbReleaseReader(pReader);
+  TSDB_CHECK_CODE(code, lino, _end);
+
+_end:
+  if (code != TSDB_CODE_SUCCESS) {
+    tsdbError("%s failed at line %d since %s", __func__, lino, tstrerror(code));
+  }
+  return code;
+}
+
 int32_t tsdbReaderReset2(void* p, SQueryTableDataCond* pCond) {
   int32_t code = TSDB_CODE_SUCCESS;
   int32_t lino = 0;
@@ -7142,6 +7599,11 @@ void tsdbReaderSetNotifyCb(STsdbReader* pReader, TsdReaderNotifyCbFn notifyFn, v
   pReader->notifyParam = param;
 }
 
+void tsdbReaderSetBlockFilter(STsdbReader* pReader, TsdReaderBlockFilterFn filterFn, void* param) {
+  pReader->blockFilterFn = filterFn;
+  pReader->blockFilterParam = param;
+}
+
 #if 0
 static int32_t tsdbEncodeLastProcKeys(const SSHashObj* pTableMap, void** buf) {
   void* p = NULL;
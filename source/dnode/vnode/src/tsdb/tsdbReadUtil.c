@@ -762,6 +762,8 @@ void clearDataBlockIterator(SDataBlockIter* pIter, bool needFree) {
   }
 
   pIter->index = -1;
+  pIter->readAheadIndex = -1;
+  pIter->readAheadColIndex = -1;
   pIter->numOfBlocks = 0;
 
   if (needFree) {
@@ -777,6 +779,8 @@ void cleanupDataBlockIterator(SDataBlockIter* pIter, bool needFree) {
   }
 
   pIter->index = -1;
+  pIter->readAheadIndex = -1;
+  pIter->readAheadColIndex = -1;
   pIter->numOfBlocks = 0;
   if (needFree) {
     taosArrayDestroyEx(pIter->blockList, freePkItem);
@@ -186,7 +186,9 @@ typedef struct SBlockLoadSuppInfo {
   SColumnInfo         pk;
   int32_t             pkSrcSlot;
   int32_t             pkDstSlot;
-  bool                smaValid;  // the sma on all queried columns are activated
+  bool                smaValid;   // the sma on all queried columns are activated
+  SColumnDataAgg*     pAheadAgg;  // aggregates of a block to read ahead, in the slots of the result block
+  int32_t             numOfAheadAgg;
 
   void* args;
 } SBlockLoadSuppInfo;
@@ -236,6 +238,8 @@ typedef struct SFileDataBlockInfo {
   int32_t numRow;
   int32_t count;
   int32_t tbBlockIdx;
+  int32_t brinIdx;     // index of the record in its brin block, with brinOffset to find the zone map of the block
+  int64_t brinOffset;
 } SFileDataBlockInfo;
 
 typedef struct SDataBlockIter {
@@ -243,6 +247,8 @@ typedef struct SDataBlockIter {
   int32_t index;
   SArray* blockList;  // SArray<SFileDataBlockInfo>
   int32_t order;
+  int32_t readAheadIndex;     // the next block to read ahead, -1 if none has been read ahead
+  int32_t readAheadColIndex;  // the last block whose columns are read ahead, -1 if none
 } SDataBlockIter;
 
 typedef struct SFileBlockDumpInfo {
@@ -251,6 +257,19 @@ typedef struct SFileBlockDumpInfo {
   bool    allDumped;
 } SFileBlockDumpInfo;
 
+// The filter columns of a file block are loaded first, the other columns are loaded only if some rows are qualified.
+typedef struct SBlockLateLoadInfo {
+  const SArray* pIdList;          // SArray<int16_t>, the columns used by the filter
+  int16_t*      filterColId;      // the output columns in pIdList, except the primary timestamp
+  int16_t*      remainColId;      // the output columns not in pIdList
+  int8_t*       colMask;          // 1 if the output column is loaded with the filter columns
+  int32_t       numOfFilterCols;
+  int32_t       numOfRemainCols;
+  bool          pending;          // the remain columns of the current result block are not loaded yet
+  int32_t       rowIndex;         // the first row of the result block in the file block
+  int32_t       rows;
+} SBlockLateLoadInfo;
+
 typedef struct SReaderStatus {
   bool                  suspendInvoked;
   bool                  loadFromFile;       // check file stage
@@ -261,6 +280,7 @@ typedef struct SReaderStatus {
   SFileBlockDumpInfo    fBlockDumpInfo;
   STFileSet*            pCurrentFileset;  // current opened file set
   SBlockData            fileBlockData;
+  SBlockLateLoadInfo    lateLoad;
   SFilesetIter          fileIter;
   SDataBlockIter        blockIter;
   SArray*               pLDataIterArray;
@@ -280,28 +300,30 @@ typedef struct SReaderStatus {
 } SReaderStatus;
 
 struct STsdbReader {
-  STsdb*              pTsdb;
-  STsdbReaderInfo     info;
-  TdThreadMutex       readerMutex;
-  EReaderStatus       flag;
-  int32_t             code;
-  SResultBlockInfo    resBlockInfo;
-  SReaderStatus       status;
-  char*               idStr;  // query info handle, for debug purpose
-  int32_t             type;   // query type: 1. retrieve all data blocks, 2. retrieve direct prev|next rows
-  SBlockLoadSuppInfo  suppInfo;
-  STsdbReadSnap*      pReadSnap;
-  tsem_t              resumeAfterSuspend;
-  SReadCostSummary    cost;
-  SHashObj**          pIgnoreTables;
-  SSHashObj*          pSchemaMap;   // keep the retrieved schema info, to avoid the overhead by repeatly load schema
-  SDataFileReader*    pFileReader;  // the file reader
-  SBlockInfoBuf       blockInfoBuf;
-  EContentData        step;
-  STsdbReader*        innerReader[2];
-  bool                bFilesetDelimited;  // duration by duration output
-  TsdReaderNotifyCbFn notifyFn;
-  void*               notifyParam;
+  STsdb*                 pTsdb;
+  STsdbReaderInfo        info;
+  TdThreadMutex          readerMutex;
+  EReaderStatus          flag;
+  int32_t                code;
+  SResultBlockInfo       resBlockInfo;
+  SReaderStatus          status;
+  char*                  idStr;  // query info handle, for debug purpose
+  int32_t                type;   // query type: 1. retrieve all data blocks, 2. retrieve direct prev|next rows
+  SBlockLoadSuppInfo     suppInfo;
+  STsdbReadSnap*         pReadSnap;
+  tsem_t                 resumeAfterSuspend;
+  SReadCostSummary       cost;
+  SHashObj**             pIgnoreTables;
+  SSHashObj*             pSchemaMap;   // keep the retrieved schema info, to avoid the overhead by repeatly load schema
+  SDataFileReader*       pFileReader;  // the file reader
+  SBlockInfoBuf          blockInfoBuf;
+  EContentData           step;
+  STsdbReader*           innerReader[2];
+  bool                   bFilesetDelimited;  // duration by duration output
+  TsdReaderNotifyCbFn    notifyFn;
+  void*                  notifyParam;
+  TsdReaderBlockFilterFn blockFilterFn;  // drops the blocks not to read ahead, by their zone map
+  void*                  blockFilterParam;
 };
 
 typedef struct SBrinRecordIter {
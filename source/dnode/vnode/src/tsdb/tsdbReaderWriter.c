@@ -19,6 +19,11 @@
 #include "tsdbDef.h"
 #include "vnd.h"
 
+// the pages of a written file are batched into writes of this size, and their write back is started right away
+#define TSDB_WRITE_BATCH_SIZE (1024 * 1024)
+// direct io needs the buffers, offsets and sizes aligned to the logical block size of the device
+#define TSDB_DIRECT_IO_ALIGN 4096
+
 static int32_t tsdbOpenFileImpl(STsdbFD *pFD) {
   int32_t     code = 0;
   int32_t     lino;
@@ -28,6 +33,14 @@ static int32_t tsdbOpenFileImpl(STsdbFD *pFD) {
   int64_t     lc_size = 0;
 
   pFD->pFD = taosOpenFile(path, flag);
+  if (pFD->pFD == NULL && pFD->direct && terrno == TAOS_SYSTEM_ERROR(EINVAL)) {
+    // not every file system supports direct io, such as tmpfs
+    tsdbWarn("vgId:%d, failed to open file %s with direct io since %s, use page cache instead", TD_VID(pFD->pTsdb->pVnode),
+             path, tstrerror(terrno));
+    pFD->direct = 0;
+    pFD->flag = flag = (flag & ~TD_FILE_DIRECT);
+    pFD->pFD = taosOpenFile(path, flag);
+  }
   if (pFD->pFD == NULL) {
     if (tsSsEnabled && pFD->lcn > 1 && !strncmp(path + strlen(path) - 5, ".data", 5)) {
       char lc_path[TSDB_FILENAME_LEN];
@@ -58,9 +71,17 @@ static int32_t tsdbOpenFileImpl(STsdbFD *pFD) {
     pFD->ssFile = 1;
   }
 
-  pFD->pBuf = taosMemoryCalloc(1, szPage);
-  if (pFD->pBuf == NULL) {
-    TSDB_CHECK_CODE(code = terrno, lino, _exit);
+  if (pFD->direct) {
+    pFD->pBuf = taosMemoryMallocAlign(TSDB_DIRECT_IO_ALIGN, szPage);
+    if (pFD->pBuf == NULL) {
+      TSDB_CHECK_CODE(code = terrno, lino, _exit);
+    }
+    memset(pFD->pBuf, 0, szPage);
+  } else {
+    pFD->pBuf = taosMemoryCalloc(1, szPage);
+    if (pFD->pBuf == NULL) {
+      TSDB_CHECK_CODE(code = terrno, lino, _exit);
+    }
   }
 
   if (lc_size > 0) {
@@ -71,7 +92,7 @@ static int32_t tsdbOpenFileImpl(STsdbFD *pFD) {
   }
 
   // not check file size when reading data files.
-  if (flag != TD_FILE_READ /* && !pFD->s3File*/) {
+  if ((flag & ~TD_FILE_DIRECT) != TD_FILE_READ /* && !pFD->s3File*/) {
     if (!lc_size && taosStatFile(path, &pFD->szFile, NULL, NULL) < 0) {
       TSDB_CHECK_CODE(code = terrno, lino, _exit);
     }
@@ -112,6 +133,11 @@ int32_t tsdbOpenFile(const char *path, STsdb *pTsdb, int32_t flag, STsdbFD **ppF
   pFD->lcn = lcn;
   pFD->pTsdb = pTsdb;
 
+  if ((flag & TD_FILE_WRITE) && tsDirectWrite && szPage % TSDB_DIRECT_IO_ALIGN == 0) {
+    pFD->direct = 1;
+    pFD->flag |= TD_FILE_DIRECT;
+  }
+
   *ppFD = pFD;
 
 _exit:
@@ -125,6 +151,7 @@ void tsdbCloseFile(STsdbFD **ppFD) {
   STsdbFD *pFD = *ppFD;
   if (pFD) {
     taosMemoryFree(pFD->pBuf);
+    taosMemoryFree(pFD->pWBuf);
     int32_t code = taosCloseFile(&pFD->pFD);
     if (code) {
       tsdbError("failed to close file: %s, code:%d reason:%s", pFD->path, code, tstrerror(code));
@@ -136,6 +163,52 @@ void tsdbCloseFile(STsdbFD **ppFD) {
   }
 }
 
+static int64_t tsdbFilePageOffset(STsdbFD *pFD, int64_t pgno) {
+  int64_t offset = PAGE_OFFSET(pgno, pFD->szPage);
+  if (pFD->ssFile && pFD->lcn > 1) {
+    SVnodeCfg *pCfg = &pFD->pTsdb->pVnode->config;
+    int64_t    chunksize = (int64_t)pCfg->tsdbPageSize * pCfg->ssChunkSize;
+    int64_t    chunkoffset = chunksize * (pFD->lcn - 1);
+
+    offset -= chunkoffset;
+  }
+  return offset;
+}
+
+// write the batched pages out in one go
+static int32_t tsdbFlushFilePages(STsdbFD *pFD) {
+  int32_t code = 0;
+  int32_t lino;
+
+  if (pFD->nWPage == 0) {
+    return code;
+  }
+
+  int64_t offset = tsdbFilePageOffset(pFD, pFD->wPgno);
+  int64_t size = (int64_t)pFD->nWPage * pFD->szPage;
+  int64_t n = 0;
+  while (n < size) {
+    int64_t nWrite = taosPWriteFile(pFD->pFD, pFD->pWBuf + n, size - n, offset + n);
+    if (nWrite <= 0) {
+      TSDB_CHECK_CODE(code = (nWrite < 0 ? terrno : TSDB_CODE_FAILED), lino, _exit);
+    }
+    n += nWrite;
+  }
+
+  if (!pFD->direct) {
+    // start the write back now instead of leaving a whole file of dirty pages to the fsync, only a hint
+    (void)taosWriteBehindFile(pFD->pFD, offset, size);
+  }
+
+  pFD->nWPage = 0;
+
+_exit:
+  if (code) {
+    TSDB_ERROR_LOG(TD_VID(pFD->pTsdb->pVnode), lino, code);
+  }
+  return code;
+}
+
 static int32_t tsdbWriteFilePage(STsdbFD *pFD, int32_t encryptAlgorithm, char *encryptKey) {
   int32_t code = 0;
   int32_t lino;
@@ -146,20 +219,6 @@ static int32_t tsdbWriteFilePage(STsdbFD *pFD, int32_t encryptAlgorithm, char *e
   }
 
   if (pFD->pgno > 0) {
-    int64_t offset = PAGE_OFFSET(pFD->pgno, pFD->szPage);
-    if (pFD->ssFile && pFD->lcn > 1) {
-      SVnodeCfg *pCfg = &pFD->pTsdb->pVnode->config;
-      int64_t    chunksize = (int64_t)pCfg->tsdbPageSize * pCfg->ssChunkSize;
-      int64_t    chunkoffset = chunksize * (pFD->lcn - 1);
-
-      offset -= chunkoffset;
-    }
-
-    int64_t n = taosLSeekFile(pFD->pFD, offset, SEEK_SET);
-    if (n < 0) {
-      TSDB_CHECK_CODE(code = terrno, lino, _exit);
-    }
-
     code = taosCalcChecksumAppend(0, pFD->pBuf, pFD->szPage);
     TSDB_CHECK_CODE(code, lino, _exit);
 
@@ -184,11 +243,26 @@ static int32_t tsdbWriteFilePage(STsdbFD *pFD, int32_t encryptAlgorithm, char *e
       // tsdbDebug("CBC_Encrypt count:%d %s", count, __FUNCTION__);
     }
 
-    n = taosWriteFile(pFD->pFD, pFD->pBuf, pFD->szPage);
-    if (n < 0) {
-      TSDB_CHECK_CODE(code = terrno, lino, _exit);
+    int32_t maxWPage = TMAX(TSDB_WRITE_BATCH_SIZE / pFD->szPage, 1);
+    if (pFD->nWPage > 0 && (pFD->nWPage >= maxWPage || pFD->pgno != pFD->wPgno + pFD->nWPage)) {
+      code = tsdbFlushFilePages(pFD);
+      TSDB_CHECK_CODE(code, lino, _exit);
     }
 
+    if (pFD->pWBuf == NULL) {
+      pFD->pWBuf = pFD->direct ? taosMemoryMallocAlign(TSDB_DIRECT_IO_ALIGN, (int64_t)maxWPage * pFD->szPage)
+                               : taosMemoryMalloc((int64_t)maxWPage * pFD->szPage);
+      if (pFD->pWBuf == NULL) {
+        TSDB_CHECK_CODE(code = terrno, lino, _exit);
+      }
+    }
+
+    if (pFD->nWPage == 0) {
+      pFD->wPgno = pFD->pgno;
+    }
+    memcpy(pFD->pWBuf + (int64_t)pFD->nWPage * pFD->szPage, pFD->pBuf, pFD->szPage);
+    pFD->nWPage++;
+
     if (pFD->szFile < pFD->pgno) {
       pFD->szFile = pFD->pgno;
     }
@@ -211,6 +285,12 @@ static int32_t tsdbReadFilePage(STsdbFD *pFD, int64_t pgno, int32_t encryptAlgor
     TSDB_CHECK_CODE(code, lino, _exit);
   }
 
+  // a page still in the write batch is read back from the file after the batch is written
+  if (pFD->nWPage > 0 && pgno >= pFD->wPgno && pgno < pFD->wPgno + pFD->nWPage) {
+    code = tsdbFlushFilePages(pFD);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
   int64_t offset = PAGE_OFFSET(pgno, pFD->szPage);
   if (pFD->lcn > 1) {
     SVnodeCfg *pCfg = &pFD->pTsdb->pVnode->config;
@@ -561,17 +641,31 @@ _exit:
   return code;
 }
 
-int32_t tsdbFsyncFile(STsdbFD *pFD, int32_t encryptAlgorithm, char *encryptKey) {
+// start loading the pages holding [offset, offset + size) in the background, see taosReadAheadFile
+int32_t tsdbReadAheadFile(STsdbFD *pFD, int64_t offset, int64_t size) {
   int32_t code = 0;
   int32_t lino;
 
-  code = tsdbWriteFilePage(pFD, encryptAlgorithm, encryptKey);
-  TSDB_CHECK_CODE(code, lino, _exit);
+  if (size <= 0) {
+    return 0;
+  }
+
+  if (!pFD->pFD) {
+    code = tsdbOpenFileImpl(pFD);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
 
-  if (taosFsyncFile(pFD->pFD) < 0) {
-    TSDB_CHECK_CODE(code = TAOS_SYSTEM_ERROR(ERRNO), lino, _exit);
+  // files migrated to shared storage are fetched by chunks on demand, only the local ones are read ahead
+  if (pFD->lcn > 1) {
+    return 0;
   }
 
+  int64_t spgno = OFFSET_PGNO(LOGIC_TO_FILE_OFFSET(offset, pFD->szPage), pFD->szPage);
+  int64_t epgno = OFFSET_PGNO(LOGIC_TO_FILE_OFFSET(offset + size - 1, pFD->szPage), pFD->szPage);
+
+  code = taosReadAheadFile(pFD->pFD, PAGE_OFFSET(spgno, pFD->szPage), (epgno - spgno + 1) * pFD->szPage);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
 _exit:
   if (code) {
     TSDB_ERROR_LOG(TD_VID(pFD->pTsdb->pVnode), lino, code);
@@ -579,6 +673,45 @@ _exit:
   return code;
 }
 
+int32_t tsdbFsyncFile(STsdbFD *pFD, int32_t encryptAlgorithm, char *encryptKey) {
+  return tsdbFsyncFiles(&pFD, 1, encryptAlgorithm, encryptKey);
+}
+
+/*
+ * Write out the pages of all the files before waiting for any of them, so that the write back of the files overlaps
+ * and the fsyncs that follow find little left to do. NULL entries are skipped.
+ */
+int32_t tsdbFsyncFiles(STsdbFD *pFDs[], int32_t nFD, int32_t encryptAlgorithm, char *encryptKey) {
+  int32_t code = 0;
+  int32_t lino;
+  int32_t vid = 0;
+
+  for (int32_t i = 0; i < nFD; ++i) {
+    if (pFDs[i] == NULL) continue;
+
+    vid = TD_VID(pFDs[i]->pTsdb->pVnode);
+    code = tsdbWriteFilePage(pFDs[i], encryptAlgorithm, encryptKey);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    code = tsdbFlushFilePages(pFDs[i]);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  for (int32_t i = 0; i < nFD; ++i) {
+    if (pFDs[i] == NULL) continue;
+
+    if (taosFsyncFile(pFDs[i]->pFD) < 0) {
+      TSDB_CHECK_CODE(code = TAOS_SYSTEM_ERROR(ERRNO), lino, _exit);
+    }
+  }
+
+_exit:
+  if (code) {
+    TSDB_ERROR_LOG(vid, lino, code);
+  }
+  return code;
+}
+
 // SDataFReader ====================================================
 int32_t tsdbDataFReaderOpen(SDataFReader **ppReader, STsdb *pTsdb, SDFileSet *pSet) {
   int32_t       code = 0;
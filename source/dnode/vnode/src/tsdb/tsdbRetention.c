@@ -32,26 +32,116 @@ static int32_t tsdbDoRemoveFileObject(SRTNer *rtner, const STFileObj *fobj) {
   return TARRAY2_APPEND(&rtner->fopArr, op);
 }
 
-static int32_t tsdbCopyFileWithLimitedSpeed(TdFilePtr from, TdFilePtr to, int64_t size, uint32_t limitMB) {
+#define TSDB_RETENTION_COPY_STEP     (16 * 1024 * 1024)
+#define TSDB_RETENTION_YIELD_MS      100
+#define TSDB_RETENTION_MAX_YIELD_MS  10000  // copy a step anyway after yielding this long, so migration never starves
+
+// wait while queries are slow on loading file blocks, returns TSDB_CODE_VND_STOPPED if the vnode is closing
+static int32_t tsdbRetentionYield(SRTNer *rtner) {
+  for (int64_t waited = 0;; waited += TSDB_RETENTION_YIELD_MS) {
+    (void)taosThreadMutexLock(&rtner->tsdb->mutex);
+    bool disabled = rtner->tsdb->bgTaskDisabled;
+    (void)taosThreadMutexUnlock(&rtner->tsdb->mutex);
+    if (disabled) {
+      return TSDB_CODE_VND_STOPPED;
+    }
+
+    int64_t target = (int64_t)tsRetentionYieldLatencyMs * 1000;
+    int64_t latency = tsdbGetReadLatency(rtner->tsdb);
+    if (target <= 0 || latency <= target || waited >= TSDB_RETENTION_MAX_YIELD_MS) {
+      return 0;
+    }
+
+    if (waited == 0) {
+      tsdbDebug("vgId:%d, fid:%d, retention yields to queries, read latency:%" PRId64 "us", TD_VID(rtner->tsdb->pVnode),
+                rtner->fset->fid, latency);
+    }
+    taosMsleep(TSDB_RETENTION_YIELD_MS);
+  }
+}
+
+// save the progress of copying of to nf in the file system, the copied part must be durable before that
+static int32_t tsdbDoRetentionCkpt(SRTNer *rtner, TdFilePtr fdTo, const STFile *of, const STFile *nf, int64_t offset) {
+  int32_t      code = 0;
+  int32_t      lino = 0;
+  TFileOpArray fopArr = {0};
+  STFileOp     op = {
+          .optype = TSDB_FOP_CKPT,
+          .fid = of->fid,
+          .of = of[0],
+          .nf = nf[0],
+          .offset = offset,
+  };
+
+  if (taosFsyncFile(fdTo) < 0) {
+    TAOS_CHECK_GOTO(terrno, &lino, _exit);
+  }
+
+  TAOS_CHECK_GOTO(TARRAY2_APPEND(&fopArr, op), &lino, _exit);
+  TAOS_CHECK_GOTO(tsdbFSEditBegin(rtner->tsdb->pFS, &fopArr, TSDB_FEDIT_RETENTION), &lino, _exit);
+
+  (void)taosThreadMutexLock(&rtner->tsdb->mutex);
+  code = tsdbFSEditCommit(rtner->tsdb->pFS);
+  (void)taosThreadMutexUnlock(&rtner->tsdb->mutex);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  tsdbDebug("vgId:%d, fid:%d, cid:%" PRId64 ", retention checkpoint at offset:%" PRId64, TD_VID(rtner->tsdb->pVnode),
+            of->fid, of->cid, offset);
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at %s:%d since %s", TD_VID(rtner->tsdb->pVnode), __func__, __FILE__, lino,
+              tstrerror(code));
+  }
+  TARRAY2_DESTROY(&fopArr, NULL);
+  return code;
+}
+
+/*
+ * Copy [offset, size) of the file in steps, so that the copy can yield to queries between steps, and stop when the
+ * vnode is closing. The progress is saved every tsRetentionCheckpointMB and when stopping.
+ */
+static int32_t tsdbCopyFileWithLimitedSpeed(SRTNer *rtner, TdFilePtr from, TdFilePtr to, const STFile *of,
+                                            const STFile *nf, int64_t offset, int64_t size, uint32_t limitMB) {
+  int32_t code = 0;
   int64_t interval = 1000;  // 1s
   int64_t limit = limitMB ? limitMB * 1024 * 1024 : INT64_MAX;
-  int64_t offset = 0;
-  int64_t remain = size;
-
-  while (remain > 0) {
-    int64_t n;
-    int64_t last = taosGetTimestampMs();
-    if ((n = taosFSendFile(to, from, &offset, TMIN(limit, remain))) < 0) {
-      TAOS_CHECK_RETURN(terrno);
+  int64_t step = TMIN(limit, TSDB_RETENTION_COPY_STEP);
+  int64_t ckpt = offset;
+  int64_t winStart = taosGetTimestampMs();
+  int64_t winSize = 0;
+
+  while (offset < size) {
+    code = tsdbRetentionYield(rtner);
+    if (code == 0) {
+      int64_t pos = offset;
+      int64_t n = taosFSendFile(to, from, &pos, TMIN(step, size - offset));
+      if (n < 0) {
+        return terrno;
+      } else if (n == 0) {
+        return TSDB_CODE_FILE_CORRUPTED;
+      }
+
+      offset += n;
+      winSize += n;
     }
 
-    remain -= n;
+    int64_t ckptSize = (int64_t)tsRetentionCheckpointMB * 1024 * 1024;
+    if (offset > ckpt && offset < size && (code || offset - ckpt >= ckptSize)) {
+      int32_t ret = tsdbDoRetentionCkpt(rtner, to, of, nf, offset);
+      if (ret) return ret;
+      ckpt = offset;
+    }
 
-    if (remain > 0) {
-      int64_t elapsed = taosGetTimestampMs() - last;
+    if (code) return code;
+
+    if (winSize >= limit && offset < size) {
+      int64_t elapsed = taosGetTimestampMs() - winStart;
       if (elapsed < interval) {
         taosMsleep(interval - elapsed);
       }
+      winStart = taosGetTimestampMs();
+      winSize = 0;
     }
   }
 
@@ -102,35 +192,53 @@ _exit:
   return code;
 }
 
-static int32_t tsdbDoCopyFile(SRTNer *rtner, const STFileObj *from, const STFile *to) {
+static int32_t tsdbDoCopyFile(SRTNer *rtner, const STFileObj *from, const STFile *to, int64_t offset) {
   int32_t code = 0;
   int32_t lino = 0;
 
   char      fname[TSDB_FILENAME_LEN];
   TdFilePtr fdFrom = NULL;
   TdFilePtr fdTo = NULL;
+  int64_t   size = tsdbLogicToFileSize(from->f->size, rtner->szPage);
 
   tsdbTFileName(rtner->tsdb, to, fname);
 
+  // the copied part may be lost if the checkpoint outlived it, start over then
+  if (offset > 0) {
+    int64_t copied = 0;
+    if (taosStatFile(fname, &copied, NULL, NULL) != 0 || copied < offset || offset > size) {
+      tsdbWarn("vgId:%d, file %s is shorter than the retention checkpoint %" PRId64 ", copy from start",
+               TD_VID(rtner->tsdb->pVnode), fname, offset);
+      offset = 0;
+    }
+  }
+
   fdFrom = taosOpenFile(from->fname, TD_FILE_READ);
   if (fdFrom == NULL) {
     TAOS_CHECK_GOTO(terrno, &lino, _exit);
   }
 
-  tsdbInfo("vgId: %d, open tofile: %s size: %" PRId64, TD_VID(rtner->tsdb->pVnode), fname, from->f->size);
+  tsdbInfo("vgId: %d, open tofile: %s size: %" PRId64 " offset: %" PRId64, TD_VID(rtner->tsdb->pVnode), fname,
+           from->f->size, offset);
 
-  fdTo = taosOpenFile(fname, TD_FILE_WRITE | TD_FILE_CREATE | TD_FILE_TRUNC);
+  fdTo = taosOpenFile(fname, TD_FILE_WRITE | TD_FILE_CREATE | (offset > 0 ? 0 : TD_FILE_TRUNC));
   if (fdTo == NULL) {
     TAOS_CHECK_GOTO(terrno, &lino, _exit);
   }
-  TSDB_CHECK_CODE(code, lino, _exit);
 
-  TAOS_CHECK_GOTO(tsdbCopyFileWithLimitedSpeed(fdFrom, fdTo, tsdbLogicToFileSize(from->f->size, rtner->szPage),
-                                               tsRetentionSpeedLimitMB),
+  if (offset > 0 && taosLSeekFile(fdTo, offset, SEEK_SET) < 0) {
+    TAOS_CHECK_GOTO(terrno, &lino, _exit);
+  }
+
+  TAOS_CHECK_GOTO(tsdbCopyFileWithLimitedSpeed(rtner, fdFrom, fdTo, from->f, to, offset, size, tsRetentionSpeedLimitMB),
                   &lino, _exit);
 
+  if (taosFsyncFile(fdTo) < 0) {
+    TAOS_CHECK_GOTO(terrno, &lino, _exit);
+  }
+
 _exit:
-  if (code) {
+  if (code && code != TSDB_CODE_VND_STOPPED) {
     tsdbError("vgId:%d, %s failed at %s:%d since %s", TD_VID(rtner->tsdb->pVnode), __func__, __FILE__, lino,
               tstrerror(code));
   }
@@ -143,11 +251,47 @@ _exit:
   return code;
 }
 
+static int32_t tsdbDoRetentionEnd(SRTNer *rtner, bool ssMigrate);
+
 static int32_t tsdbDoMigrateFileObj(SRTNer *rtner, const STFileObj *fobj, const SDiskID *did) {
   int32_t  code = 0;
   int32_t  lino = 0;
   STFileOp op = {0};
   int32_t  lcn = fobj->f->lcn;
+  STFile   nf = {
+        .type = fobj->f->type,
+        .did = did[0],
+        .fid = fobj->f->fid,
+        .minVer = fobj->f->minVer,
+        .maxVer = fobj->f->maxVer,
+        .mid = fobj->f->mid,
+        .cid = fobj->f->cid,
+        .size = fobj->f->size,
+        .lcn = lcn,
+        .stt[0] =
+            {
+                .level = fobj->f->stt[0].level,
+            },
+  };
+
+  // do copy the file, resuming from the checkpoint if it is of the same copy
+  if (lcn < 1) {
+    const STFileCkpt *ckpt = &rtner->fset->rtnCkpt;
+    int64_t           offset = 0;
+    if (ckpt->offset > 0 && tsdbIsSameTFile(ckpt->of, fobj->f)) {
+      if (!tsdbIsTFileChanged(ckpt->of, fobj->f) && tsdbIsSameTFile(ckpt->nf, &nf)) {
+        offset = ckpt->offset;
+      } else {
+        // the file goes to another disk this time
+        char fname[TSDB_FILENAME_LEN];
+        tsdbTFileName(rtner->tsdb, ckpt->nf, fname);
+        tsdbRemoveFile(fname);
+      }
+    }
+    TAOS_CHECK_GOTO(tsdbDoCopyFile(rtner, fobj, &nf, offset), &lino, _exit);
+  } else {
+    TAOS_CHECK_GOTO(tsdbDoCopyFileLC(rtner, fobj, &nf), &lino, _exit);
+  }
 
   // remove old
   op = (STFileOp){
@@ -162,36 +306,16 @@ static int32_t tsdbDoMigrateFileObj(SRTNer *rtner, const STFileObj *fobj, const
   op = (STFileOp){
       .optype = TSDB_FOP_CREATE,
       .fid = fobj->f->fid,
-      .nf =
-          {
-              .type = fobj->f->type,
-              .did = did[0],
-              .fid = fobj->f->fid,
-              .minVer = fobj->f->minVer,
-              .maxVer = fobj->f->maxVer,
-              .mid = fobj->f->mid,
-              .cid = fobj->f->cid,
-              .size = fobj->f->size,
-              .lcn = lcn,
-              .stt[0] =
-                  {
-                      .level = fobj->f->stt[0].level,
-                  },
-          },
+      .nf = nf,
   };
 
   TAOS_CHECK_GOTO(TARRAY2_APPEND(&rtner->fopArr, op), &lino, _exit);
 
-  // do copy the file
-
-  if (lcn < 1) {
-    TAOS_CHECK_GOTO(tsdbDoCopyFile(rtner, fobj, &op.nf), &lino, _exit);
-  } else {
-    TAOS_CHECK_GOTO(tsdbDoCopyFileLC(rtner, fobj, &op.nf), &lino, _exit);
-  }
+  // commit each migrated file, a large file set is moved file by file instead of all at once
+  TAOS_CHECK_GOTO(tsdbDoRetentionEnd(rtner, false), &lino, _exit);
 
 _exit:
-  if (code) {
+  if (code && code != TSDB_CODE_VND_STOPPED) {
     tsdbError("vgId:%d, %s failed at %s:%d since %s", TD_VID(rtner->tsdb->pVnode), __func__, __FILE__, lino,
               tstrerror(code));
   }
@@ -251,6 +375,18 @@ static int32_t tsdbRemoveOrMoveFileObject(SRTNer *rtner, int32_t expLevel, STFil
     code = tsdbDoRemoveFileObject(rtner, fobj);
     TSDB_CHECK_CODE(code, lino, _exit);
   } else if (expLevel > fobj->f->did.level) {
+    // Resume the migration stopped last time on the same disk
+    const STFileCkpt *ckpt = &rtner->fset->rtnCkpt;
+    if (ckpt->offset > 0 && tsdbIsSameTFile(ckpt->of, fobj->f) && ckpt->nf->did.level <= expLevel) {
+      tsdbInfo("vgId:%d resume to migrate file %s from level %d to %d, size:%" PRId64 ", offset:%" PRId64,
+               TD_VID(rtner->tsdb->pVnode), fobj->fname, fobj->f->did.level, ckpt->nf->did.level, fobj->f->size,
+               ckpt->offset);
+
+      code = tsdbDoMigrateFileObj(rtner, fobj, &ckpt->nf->did);
+      TSDB_CHECK_CODE(code, lino, _exit);
+      goto _exit;
+    }
+
     // Try to move the file to a new level
     for (; expLevel > fobj->f->did.level; expLevel--) {
       SDiskID diskId = {0};
@@ -276,7 +412,7 @@ static int32_t tsdbRemoveOrMoveFileObject(SRTNer *rtner, int32_t expLevel, STFil
   }
 
 _exit:
-  if (code) {
+  if (code && code != TSDB_CODE_VND_STOPPED) {
     tsdbError("vgId:%d, %s failed at %s:%d since %s", TD_VID(rtner->tsdb->pVnode), __func__, __FILE__, lino,
               tstrerror(code));
   }
@@ -306,7 +442,7 @@ static int32_t tsdbDoRetention(SRTNer *rtner) {
   }
 
 _exit:
-  if (code) {
+  if (code && code != TSDB_CODE_VND_STOPPED) {
     tsdbError("vgId:%d, %s failed at %s:%d since %s", TD_VID(rtner->tsdb->pVnode), __func__, __FILE__, lino,
               tstrerror(code));
   }
@@ -363,6 +499,12 @@ static int32_t tsdbRetention(void *arg) {
   }
 
 _exit:
+  if (code == TSDB_CODE_VND_STOPPED) {
+    tsdbInfo("vgId:%d, fid:%d, retention stopped, the files migrated are kept and the next one resumes from them",
+             TD_VID(pTsdb->pVnode), rtnArg->fid);
+    code = 0;
+  }
+
   if (rtner.fset) {
     (void)taosThreadMutexLock(&pTsdb->mutex);
     tsdbFinishTaskOnFileSet(pTsdb, rtnArg->fid, EVA_TASK_RETENTION);
@@ -26,12 +26,14 @@ struct SSttFileReader {
     bool sttBlkLoaded;
     bool statisBlkLoaded;
     bool tombBlkLoaded;
+    bool bloomLoaded;
   } ctx[1];
-  TSttBlkArray    sttBlkArray[1];
-  TStatisBlkArray statisBlkArray[1];
-  TTombBlkArray   tombBlkArray[1];
-  SBuffer         local[10];
-  SBuffer        *buffers;
+  TSttBlkArray       sttBlkArray[1];
+  TStatisBlkArray    statisBlkArray[1];
+  TTombBlkArray      tombBlkArray[1];
+  SBlockBloomFilter *bloom;
+  SBuffer            local[10];
+  SBuffer           *buffers;
 };
 
 // SSttFileReader
@@ -109,12 +111,53 @@ void tsdbSttFileReaderClose(SSttFileReader **reader) {
     TARRAY2_DESTROY(reader[0]->tombBlkArray, NULL);
     TARRAY2_DESTROY(reader[0]->statisBlkArray, NULL);
     TARRAY2_DESTROY(reader[0]->sttBlkArray, NULL);
+    tBlockBloomFilterDestroy(reader[0]->bloom);
     taosMemoryFree(reader[0]);
     reader[0] = NULL;
   }
 }
 
 // SSttFSegReader
+int32_t tsdbSttFileReadBloomFilter(SSttFileReader *reader, const SBlockBloomFilter **bloom) {
+  int32_t  code = 0;
+  int32_t  lino = 0;
+  uint8_t *data = NULL;
+
+  if (!reader->ctx->bloomLoaded) {
+    if (reader->footer->bloomPtr->size > 0) {
+      int32_t encryptAlgorithm = reader->config->tsdb->pVnode->config.tsdbCfg.encryptAlgorithm;
+      char   *encryptKey = reader->config->tsdb->pVnode->config.tsdbCfg.encryptKey;
+
+      data = taosMemoryMalloc(reader->footer->bloomPtr->size);
+      if (!data) {
+        TAOS_CHECK_GOTO(terrno, &lino, _exit);
+      }
+
+      TAOS_CHECK_GOTO(tsdbReadFile(reader->fd, reader->footer->bloomPtr->offset, data, reader->footer->bloomPtr->size,
+                                   0, encryptAlgorithm, encryptKey),
+                      &lino, _exit);
+
+      SDecoder decoder = {0};
+      tDecoderInit(&decoder, data, reader->footer->bloomPtr->size);
+      code = tBlockBloomFilterDecode(&decoder, &reader->bloom);
+      tDecoderClear(&decoder);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+
+    reader->ctx->bloomLoaded = true;
+  }
+
+  bloom[0] = reader->bloom;
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d %s failed at %s:%d since %s", TD_VID(reader->config->tsdb->pVnode), __func__, __FILE__, lino,
+              tstrerror(code));
+  }
+  taosMemoryFree(data);
+  return code;
+}
+
 int32_t tsdbSttFileReadStatisBlk(SSttFileReader *reader, const TStatisBlkArray **statisBlkArray) {
   if (!reader->ctx->statisBlkLoaded) {
     if (reader->footer->statisBlkPtr->size > 0) {
@@ -502,6 +545,7 @@ struct SSttFileWriter {
   STFile   file[1];
   // data
   SSttFooter      footer[1];
+  TSttUidArray    uidArray[1];
   TTombBlkArray   tombBlkArray[1];
   TSttBlkArray    sttBlkArray[1];
   TStatisBlkArray statisBlkArray[1];
@@ -516,6 +560,13 @@ struct SSttFileWriter {
   // SColCompressInfo2 pInfo;
 };
 
+static int32_t tsdbSttFileAddBloomUid(SSttFileWriter *writer, int64_t uid) {
+  if (TARRAY2_SIZE(writer->uidArray) > 0 && TARRAY2_LAST(writer->uidArray) == uid) {
+    return 0;
+  }
+  return TARRAY2_APPEND(writer->uidArray, uid);
+}
+
 static int32_t tsdbFileDoWriteSttBlockData(STsdbFD *fd, SBlockData *blockData, SColCompressInfo *info,
                                            int64_t *fileSize, TSttBlkArray *sttBlkArray, SBuffer *buffers,
                                            SVersionRange *range, int32_t encryptAlgorithm, char *encryptKey) {
@@ -781,6 +832,54 @@ _exit:
   return code;
 }
 
+static int32_t tsdbSttFileDoWriteBloomFilter(SSttFileWriter *writer) {
+  if (TARRAY2_SIZE(writer->uidArray) == 0) {
+    return 0;
+  }
+
+  int32_t            code = 0;
+  int32_t            lino = 0;
+  SBlockBloomFilter *bloom = NULL;
+  SEncoder           encoder = {0};
+  SBuffer           *buffer = writer->buffers + 0;
+  int32_t            encryptAlgorithm = writer->config->tsdb->pVnode->config.tsdbCfg.encryptAlgorithm;
+  char              *encryptKey = writer->config->tsdb->pVnode->config.tsdbCfg.encryptKey;
+
+  TAOS_CHECK_GOTO(tBlockBloomFilterInit(TARRAY2_SIZE(writer->uidArray), TSDB_STT_BLOOM_ERROR_RATE, &bloom), &lino,
+                  _exit);
+  for (int32_t i = 0; i < TARRAY2_SIZE(writer->uidArray); i++) {
+    int64_t uid = TARRAY2_GET(writer->uidArray, i);
+    tBlockBloomFilterPut(bloom, &uid, sizeof(uid));
+  }
+
+  tEncoderInit(&encoder, NULL, 0);
+  code = tBlockBloomFilterEncode(bloom, &encoder);
+  int32_t size = encoder.pos;
+  tEncoderClear(&encoder);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  tBufferClear(buffer);
+  TAOS_CHECK_GOTO(tBufferEnsureCapacity(buffer, size), &lino, _exit);
+  tEncoderInit(&encoder, buffer->data, size);
+  code = tBlockBloomFilterEncode(bloom, &encoder);
+  tEncoderClear(&encoder);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  writer->footer->bloomPtr->offset = writer->file->size;
+  writer->footer->bloomPtr->size = size;
+  TAOS_CHECK_GOTO(tsdbWriteFile(writer->fd, writer->file->size, buffer->data, size, encryptAlgorithm, encryptKey),
+                  &lino, _exit);
+  writer->file->size += size;
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d %s failed at %s:%d since %s", TD_VID(writer->config->tsdb->pVnode), __func__, __FILE__, lino,
+              tstrerror(code));
+  }
+  tBlockBloomFilterDestroy(bloom);
+  return code;
+}
+
 int32_t tsdbFileWriteSttFooter(STsdbFD *fd, const SSttFooter *footer, int64_t *fileSize, int32_t encryptAlgorithm,
                                char *encryptKey) {
   TAOS_CHECK_RETURN(
@@ -867,6 +966,7 @@ static void tsdbSttFWriterDoClose(SSttFileWriter *writer) {
   TARRAY2_DESTROY(writer->tombBlkArray, NULL);
   TARRAY2_DESTROY(writer->statisBlkArray, NULL);
   TARRAY2_DESTROY(writer->sttBlkArray, NULL);
+  TARRAY2_DESTROY(writer->uidArray, NULL);
 }
 
 static int32_t tsdbSttFileDoUpdateHeader(SSttFileWriter *writer) {
@@ -884,6 +984,7 @@ static int32_t tsdbSttFWriterCloseCommit(SSttFileWriter *writer, TFileOpArray *o
   TAOS_CHECK_GOTO(tsdbSttFileDoWriteSttBlk(writer), &lino, _exit);
   TAOS_CHECK_GOTO(tsdbSttFileDoWriteStatisBlk(writer), &lino, _exit);
   TAOS_CHECK_GOTO(tsdbSttFileDoWriteTombBlk(writer), &lino, _exit);
+  TAOS_CHECK_GOTO(tsdbSttFileDoWriteBloomFilter(writer), &lino, _exit);
   TAOS_CHECK_GOTO(tsdbSttFileDoWriteFooter(writer), &lino, _exit);
   TAOS_CHECK_GOTO(tsdbSttFileDoUpdateHeader(writer), &lino, _exit);
 
@@ -976,6 +1077,7 @@ int32_t tsdbSttFileWriteRow(SSttFileWriter *writer, SRowInfo *row) {
   if (writer->ctx->tbid->uid != row->uid) {
     writer->ctx->tbid->suid = row->suid;
     writer->ctx->tbid->uid = row->uid;
+    TAOS_CHECK_GOTO(tsdbSttFileAddBloomUid(writer, row->uid), &lino, _exit);
   }
 
   STsdbRowKey key;
@@ -1046,6 +1148,47 @@ _exit:
   return code;
 }
 
+int32_t tsdbSttFileWriteBlockRows(SSttFileWriter *writer, SBlockData *bdata, int32_t iRow, int32_t nRow) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  if (nRow <= 0) {
+    return 0;
+  }
+
+  // the first row goes through the row path, which switches the table and merges a duplicate key
+  SRowInfo row[1];
+  row->suid = bdata->suid;
+  row->uid = bdata->uid;
+  row->row = tsdbRowFromBlockData(bdata, iRow);
+  TAOS_CHECK_GOTO(tsdbSttFileWriteRow(writer, row), &lino, _exit);
+
+  if (nRow == 1) {
+    goto _exit;
+  }
+
+  // the rest are of the same table with strictly increasing keys, so they can be added in bulk
+  row->row.iRow = iRow + nRow - 1;
+  TAOS_CHECK_GOTO(tStatisBlockUpdateRows(writer->staticBlock, row, nRow - 1), &lino, _exit);
+
+  for (int32_t i = iRow + 1, end = iRow + nRow; i < end;) {
+    if (writer->blockData->nRow >= writer->config->maxRow) {
+      TAOS_CHECK_GOTO(tsdbSttFileDoWriteBlockData(writer), &lino, _exit);
+    }
+
+    int32_t n = TMIN(end - i, writer->config->maxRow - writer->blockData->nRow);
+    TAOS_CHECK_GOTO(tBlockDataAppendBlockRows(writer->blockData, bdata, i, n), &lino, _exit);
+    i += n;
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d %s failed at %s:%d since %s", TD_VID(writer->config->tsdb->pVnode), __func__, __FILE__, lino,
+              tstrerror(code));
+  }
+  return code;
+}
+
 int32_t tsdbSttFileWriteTombRecord(SSttFileWriter *writer, const STombRecord *record) {
   int32_t code;
   int32_t lino;
@@ -1063,6 +1206,7 @@ int32_t tsdbSttFileWriteTombRecord(SSttFileWriter *writer, const STombRecord *re
   }
 
   TAOS_CHECK_GOTO(tTombBlockPut(writer->tombBlock, record), &lino, _exit);
+  TAOS_CHECK_GOTO(tsdbSttFileAddBloomUid(writer, record->uid), &lino, _exit);
 
   if (TOMB_BLOCK_SIZE(writer->tombBlock) >= writer->config->maxRow) {
     TAOS_CHECK_GOTO(tsdbSttFileDoWriteTombBlock(writer), &lino, _exit);
@@ -13,6 +13,7 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "tbloomfilter.h"
 #include "tsdbFS2.h"
 #include "tsdbUtil2.h"
 
@@ -25,14 +26,18 @@ extern "C" {
 
 typedef TARRAY2(SSttBlk) TSttBlkArray;
 typedef TARRAY2(SStatisBlk) TStatisBlkArray;
+typedef TARRAY2(int64_t) TSttUidArray;
 
 typedef struct {
   SFDataPtr sttBlkPtr[1];
   SFDataPtr statisBlkPtr[1];
   SFDataPtr tombBlkPtr[1];
-  SFDataPtr rsrvd[2];
+  SFDataPtr bloomPtr[1];  // filter of the table uids with data or tomb records, empty in files of older versions
+  SFDataPtr rsrvd[1];
 } SSttFooter;
 
+#define TSDB_STT_BLOOM_ERROR_RATE 0.01
+
 // SSttFileReader ==========================================
 typedef struct SSttFileReader       SSttFileReader;
 typedef struct SSttFileReaderConfig SSttFileReaderConfig;
@@ -46,6 +51,7 @@ void    tsdbSttFileReaderClose(SSttFileReader **reader);
 int32_t tsdbSttFileReadSttBlk(SSttFileReader *reader, const TSttBlkArray **sttBlkArray);
 int32_t tsdbSttFileReadStatisBlk(SSttFileReader *reader, const TStatisBlkArray **statisBlkArray);
 int32_t tsdbSttFileReadTombBlk(SSttFileReader *reader, const TTombBlkArray **delBlkArray);
+int32_t tsdbSttFileReadBloomFilter(SSttFileReader *reader, const SBlockBloomFilter **bloom);
 
 int32_t tsdbSttFileReadBlockData(SSttFileReader *reader, const SSttBlk *sttBlk, SBlockData *bData);
 int32_t tsdbSttFileReadBlockDataByColumn(SSttFileReader *reader, const SSttBlk *sttBlk, SBlockData *bData,
@@ -68,6 +74,7 @@ int32_t tsdbSttFileWriterOpen(const SSttFileWriterConfig *config, SSttFileWriter
 int32_t tsdbSttFileWriterClose(SSttFileWriter **writer, int8_t abort, TFileOpArray *opArray);
 int32_t tsdbSttFileWriteRow(SSttFileWriter *writer, SRowInfo *row);
 int32_t tsdbSttFileWriteBlockData(SSttFileWriter *writer, SBlockData *pBlockData);
+int32_t tsdbSttFileWriteBlockRows(SSttFileWriter *writer, SBlockData *pBlockData, int32_t iRow, int32_t nRow);
 int32_t tsdbSttFileWriteTombRecord(SSttFileWriter *writer, const STombRecord *record);
 bool    tsdbSttFileWriterIsOpened(SSttFileWriter *writer);
 
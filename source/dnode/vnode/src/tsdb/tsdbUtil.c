@@ -1320,6 +1320,67 @@ int32_t tBlockDataAppendRow(SBlockData *pBlockData, TSDBROW *pRow, STSchema *pTS
 _exit:
   return code;
 }
+
+// append rows [iRow, iRow + nRow) of pBlockDataFrom column by column
+int32_t tBlockDataAppendBlockRows(SBlockData *pBlockData, SBlockData *pBlockDataFrom, int32_t iRow, int32_t nRow) {
+  int32_t code = 0;
+
+  if (!(pBlockData->suid || pBlockData->uid) || iRow < 0 || nRow < 0 || iRow + nRow > pBlockDataFrom->nRow) {
+    return TSDB_CODE_INVALID_PARA;
+  }
+
+  int32_t nRowTo = pBlockData->nRow + nRow;
+
+  // uid
+  if (pBlockData->uid == 0) {
+    code = tRealloc((uint8_t **)&pBlockData->aUid, sizeof(int64_t) * nRowTo);
+    if (code) goto _exit;
+    for (int32_t i = 0; i < nRow; i++) {
+      pBlockData->aUid[pBlockData->nRow + i] =
+          pBlockDataFrom->uid ? pBlockDataFrom->uid : pBlockDataFrom->aUid[iRow + i];
+    }
+  }
+  // version
+  code = tRealloc((uint8_t **)&pBlockData->aVersion, sizeof(int64_t) * nRowTo);
+  if (code) goto _exit;
+  memcpy(pBlockData->aVersion + pBlockData->nRow, pBlockDataFrom->aVersion + iRow, sizeof(int64_t) * nRow);
+  // timestamp
+  code = tRealloc((uint8_t **)&pBlockData->aTSKEY, sizeof(TSKEY) * nRowTo);
+  if (code) goto _exit;
+  memcpy(pBlockData->aTSKEY + pBlockData->nRow, pBlockDataFrom->aTSKEY + iRow, sizeof(TSKEY) * nRow);
+
+  // columns
+  SColVal   cv = {0};
+  int32_t   iColDataFrom = 0;
+  SColData *pColDataFrom = (iColDataFrom < pBlockDataFrom->nColData) ? &pBlockDataFrom->aColData[iColDataFrom] : NULL;
+
+  for (int32_t iColDataTo = 0; iColDataTo < pBlockData->nColData; iColDataTo++) {
+    SColData *pColDataTo = &pBlockData->aColData[iColDataTo];
+
+    while (pColDataFrom && pColDataFrom->cid < pColDataTo->cid) {
+      pColDataFrom = (++iColDataFrom < pBlockDataFrom->nColData) ? &pBlockDataFrom->aColData[iColDataFrom] : NULL;
+    }
+
+    if (pColDataFrom == NULL || pColDataFrom->cid > pColDataTo->cid) {
+      cv = COL_VAL_NONE(pColDataTo->cid, pColDataTo->type);
+      for (int32_t i = 0; i < nRow; i++) {
+        if ((code = tColDataAppendValue(pColDataTo, &cv))) goto _exit;
+      }
+    } else {
+      for (int32_t i = 0; i < nRow; i++) {
+        if ((code = tColDataGetValue(pColDataFrom, iRow + i, &cv))) goto _exit;
+        if ((code = tColDataAppendValue(pColDataTo, &cv))) goto _exit;
+      }
+
+      pColDataFrom = (++iColDataFrom < pBlockDataFrom->nColData) ? &pBlockDataFrom->aColData[iColDataFrom] : NULL;
+    }
+  }
+  pBlockData->nRow = nRowTo;
+
+_exit:
+  return code;
+}
+
 int32_t tBlockDataUpdateRow(SBlockData *pBlockData, TSDBROW *pRow, STSchema *pTSchema) {
   int32_t code = 0;
 
@@ -1391,6 +1452,55 @@ SColData *tBlockDataGetColData(SBlockData *pBlockData, int16_t cid) {
   return NULL;
 }
 
+#define TSDB_CMPR_TRIAL_SIZE (16 * 1024)
+
+/* Replace an "auto" L2 codec in cmprAlg by a concrete one, so only real codecs reach SBlockCol and
+ * the decoder. With trial set, the head of the data is L1 encoded and handed to the L2 layer, which
+ * picks the codec with the best ratio per decode cost; otherwise lz4 is used.
+ */
+static int32_t tsdbResolveAutoCmprAlg(void *data, int32_t size, int8_t type, bool trial, uint32_t *cmprAlg,
+                                      SBuffer *assist) {
+  int32_t code = 0;
+  uint8_t alg = L2_LZ4;
+  SBuffer local;
+
+  DEFINE_VAR(*cmprAlg)
+  if (l2 != L2_AUTO) {
+    return 0;
+  }
+
+  int32_t nSample = TMIN(size, TSDB_CMPR_TRIAL_SIZE);
+  if (!IS_VAR_DATA_TYPE(type)) {
+    nSample -= nSample % tDataTypes[type].bytes;
+  }
+
+  if (trial && data != NULL && nSample > 0) {
+    SCompressInfo cinfo = {
+        .dataType = type,
+        .cmprAlg = *cmprAlg,
+        .originalSize = nSample,
+    };
+    SET_COMPRESS(l1, L2_DISABLED, L2_LVL_DISABLED, cinfo.cmprAlg);
+
+    tBufferInit(&local);
+    code = tCompressDataToBuffer(data, &cinfo, &local, NULL);
+    if (code == 0) {
+      code = tBufferEnsureCapacity(assist, cinfo.compressedSize + COMP_OVERFLOW_BYTES);
+    }
+    if (code == 0) {
+      code = tsCompressL2Select((const char *)local.data, cinfo.compressedSize, type, (char *)assist->data,
+                                assist->capacity, &alg);
+    }
+    tBufferDestroy(&local);
+    if (code) {
+      return code;
+    }
+  }
+
+  SET_COMPRESS(l1, alg, lvl, *cmprAlg);
+  return 0;
+}
+
 /* buffers[0]: SDiskDataHdr
  * buffers[1]: key part: uid + version + ts + primary keys
  * buffers[2]: SBlockCol part
@@ -1404,6 +1514,10 @@ int32_t tBlockDataCompress(SBlockData *bData, void *pCompr, SBuffer *buffers, SB
   code = tsdbGetColCmprAlgFromSet(pInfo->pColCmpr, 1, &pInfo->defaultCmprAlg);
   TAOS_UNUSED(code);
 
+  code = tsdbResolveAutoCmprAlg(bData->aTSKEY, sizeof(TSKEY) * bData->nRow, TSDB_DATA_TYPE_TIMESTAMP,
+                                pInfo->trialCmpr, &pInfo->defaultCmprAlg, assist);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
   SDiskDataHdr hdr = {
       .delimiter = TSDB_FILE_DLMT,
       .fmtVer = 2,
@@ -1444,6 +1558,10 @@ int32_t tBlockDataCompress(SBlockData *bData, void *pCompr, SBuffer *buffers, SB
       //
     }
 
+    code = tsdbResolveAutoCmprAlg(colData->pData, colData->nData, colData->type, pInfo->trialCmpr, &cinfo.cmprAlg,
+                                  assist);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
     int32_t offset = buffers[3].size;
     code = tColDataCompress(colData, &cinfo, &buffers[3], assist);
     TSDB_CHECK_CODE(code, lino, _exit);
@@ -1683,6 +1801,10 @@ static int32_t tBlockDataCompressKeyPart(SBlockData *bData, SDiskDataHdr *hdr, S
     } else {
     }
 
+    code = tsdbResolveAutoCmprAlg(colData->pData, colData->nData, colData->type, compressInfo->trialCmpr,
+                                  &info.cmprAlg, assist);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
     code = tColDataCompress(colData, &info, buffer, assist);
     TSDB_CHECK_CODE(code, lino, _exit);
 
@@ -1875,4 +1997,27 @@ int32_t tsdbAllocateDiskAtLevel(STsdb *tsdb, int32_t level, const char *label, S
     *diskId = did;
   }
   return 0;
-}
\ No newline at end of file
+}
+
+#define TSDB_READ_LATENCY_EXPIRE_MS 1000
+
+void tsdbUpdateReadLatency(STsdb *tsdb, int64_t us) {
+  // concurrent updates may lose samples, which is fine for an estimation
+  int64_t now = taosGetTimestampMs();
+  int64_t latency = atomic_load_64(&tsdb->readLatency);
+  if (now - atomic_load_64(&tsdb->readLatencyTs) > TSDB_READ_LATENCY_EXPIRE_MS) {
+    latency = us;
+  } else {
+    latency += (us - latency) / 8;
+  }
+  atomic_store_64(&tsdb->readLatency, latency);
+  atomic_store_64(&tsdb->readLatencyTs, now);
+}
+
+int64_t tsdbGetReadLatency(STsdb *tsdb) {
+  // no query has read the files recently
+  if (taosGetTimestampMs() - atomic_load_64(&tsdb->readLatencyTs) > TSDB_READ_LATENCY_EXPIRE_MS) {
+    return 0;
+  }
+  return atomic_load_64(&tsdb->readLatency);
+}
@@ -144,7 +144,7 @@ static int32_t tStatisBlockAppend(STbStatisBlock *block, SRowInfo *row) {
   return 0;
 }
 
-static int32_t tStatisBlockUpdate(STbStatisBlock *block, SRowInfo *row) {
+static int32_t tStatisBlockUpdate(STbStatisBlock *block, SRowInfo *row, int64_t count) {
   STbStatisRecord record;
   STsdbRowKey     key;
   int32_t         c;
@@ -166,7 +166,7 @@ static int32_t tStatisBlockUpdate(STbStatisBlock *block, SRowInfo *row) {
     }
 
     // count
-    record.count++;
+    record.count += count;
     TAOS_CHECK_RETURN(tBufferPutAt(&block->counts, (block->numOfRecords - 1) * sizeof(record.count), &record.count,
                                    sizeof(record.count)));
   } else {
@@ -183,7 +183,7 @@ int32_t tStatisBlockPut(STbStatisBlock *block, SRowInfo *row, int32_t maxRecords
     TAOS_CHECK_RETURN(tBufferGetI64(&br, &lastUid));
 
     if (lastUid == row->uid) {
-      return tStatisBlockUpdate(block, row);
+      return tStatisBlockUpdate(block, row, 1);
     } else if (block->numOfRecords >= maxRecords) {
       return TSDB_CODE_INVALID_PARA;
     }
@@ -191,6 +191,22 @@ int32_t tStatisBlockPut(STbStatisBlock *block, SRowInfo *row, int32_t maxRecords
   return tStatisBlockAppend(block, row);
 }
 
+// count rows of the table of the last record are added, row is the last of them
+int32_t tStatisBlockUpdateRows(STbStatisBlock *block, SRowInfo *row, int64_t count) {
+  if (block->numOfRecords == 0) {
+    return TSDB_CODE_INVALID_PARA;
+  }
+
+  int64_t       lastUid;
+  SBufferReader br = BUFFER_READER_INITIALIZER(sizeof(int64_t) * (block->numOfRecords - 1), &block->uids);
+  TAOS_CHECK_RETURN(tBufferGetI64(&br, &lastUid));
+  if (lastUid != row->uid) {
+    return TSDB_CODE_INVALID_PARA;
+  }
+
+  return tStatisBlockUpdate(block, row, count);
+}
+
 int32_t tStatisBlockGet(STbStatisBlock *statisBlock, int32_t idx, STbStatisRecord *record) {
   SBufferReader reader;
 
@@ -390,6 +406,67 @@ int32_t tBrinBlockGet(SBrinBlock *brinBlock, int32_t idx, SBrinRecord *record) {
   return 0;
 }
 
+// SZoneMapBlock ----------
+void tZoneMapBlockInit(SZoneMapBlock *zoneMapBlock) {
+  zoneMapBlock->numOfRecords = 0;
+  tBufferInit(&zoneMapBlock->offsets);
+  tBufferInit(&zoneMapBlock->data);
+}
+
+void tZoneMapBlockDestroy(SZoneMapBlock *zoneMapBlock) {
+  zoneMapBlock->numOfRecords = 0;
+  tBufferDestroy(&zoneMapBlock->offsets);
+  tBufferDestroy(&zoneMapBlock->data);
+}
+
+void tZoneMapBlockClear(SZoneMapBlock *zoneMapBlock) {
+  zoneMapBlock->numOfRecords = 0;
+  tBufferClear(&zoneMapBlock->offsets);
+  tBufferClear(&zoneMapBlock->data);
+}
+
+int32_t tZoneMapBlockPut(SZoneMapBlock *zoneMapBlock, const void *entry, uint32_t size) {
+  if (size > 0) {
+    TAOS_CHECK_RETURN(tBufferPut(&zoneMapBlock->data, entry, size));
+  }
+  TAOS_CHECK_RETURN(tBufferPutI32(&zoneMapBlock->offsets, (int32_t)zoneMapBlock->data.size));
+  zoneMapBlock->numOfRecords++;
+  return 0;
+}
+
+int32_t tZoneMapBlockGet(const SZoneMapBlock *zoneMapBlock, int32_t idx, const void **entry, uint32_t *size) {
+  if (idx < 0 || idx >= zoneMapBlock->numOfRecords) {
+    return TSDB_CODE_OUT_OF_RANGE;
+  }
+
+  const int32_t *ends = (const int32_t *)zoneMapBlock->offsets.data;
+  int32_t        start = (idx == 0) ? 0 : ends[idx - 1];
+  if (start < 0 || start > ends[idx] || (uint32_t)ends[idx] > zoneMapBlock->data.size) {
+    return TSDB_CODE_FILE_CORRUPTED;
+  }
+
+  *entry = tBufferGetDataAt(&zoneMapBlock->data, start);
+  *size = ends[idx] - start;
+  return 0;
+}
+
+int32_t tPutZoneMapColumn(SBuffer *buffer, const SColumnDataAgg *pColAgg) {
+  TAOS_CHECK_RETURN(tBufferPutI32v(buffer, pColAgg->colId));
+  TAOS_CHECK_RETURN(tBufferPutI16v(buffer, pColAgg->numOfNull));
+  TAOS_CHECK_RETURN(tBufferPutI64v(buffer, pColAgg->min));
+  TAOS_CHECK_RETURN(tBufferPutI64v(buffer, pColAgg->max));
+  return 0;
+}
+
+int32_t tGetZoneMapColumn(SBufferReader *br, SColumnDataAgg *pColAgg) {
+  pColAgg->sum = 0;
+  TAOS_CHECK_RETURN(tBufferGetI32v(br, &pColAgg->colId));
+  TAOS_CHECK_RETURN(tBufferGetI16v(br, &pColAgg->numOfNull));
+  TAOS_CHECK_RETURN(tBufferGetI64v(br, &pColAgg->min));
+  TAOS_CHECK_RETURN(tBufferGetI64v(br, &pColAgg->max));
+  return 0;
+}
+
 // other apis ----------
 int32_t tsdbUpdateSkmTb(STsdb *pTsdb, const TABLEID *tbid, SSkmInfo *pSkmTb) {
   if (tbid->suid) {
@@ -115,6 +115,7 @@ int32_t tStatisBlockInit(STbStatisBlock *statisBlock);
 void    tStatisBlockDestroy(STbStatisBlock *statisBlock);
 void    tStatisBlockClear(STbStatisBlock *statisBlock);
 int32_t tStatisBlockPut(STbStatisBlock *statisBlock, SRowInfo *row, int32_t maxRecords);
+int32_t tStatisBlockUpdateRows(STbStatisBlock *statisBlock, SRowInfo *row, int64_t count);
 int32_t tStatisBlockGet(STbStatisBlock *statisBlock, int32_t idx, STbStatisRecord *record);
 
 // SBrinRecord ----------
@@ -184,6 +185,38 @@ void    tBrinBlockClear(SBrinBlock *brinBlock);
 int32_t tBrinBlockPut(SBrinBlock *brinBlock, const SBrinRecord *record);
 int32_t tBrinBlockGet(SBrinBlock *brinBlock, int32_t idx, SBrinRecord *record);
 
+// SZoneMapBlock ----------
+/*
+ * The min/max/null count of each data block, stored in the .head file next to the brin block indexing the same blocks,
+ * so that a block can be filtered out without reading the .sma or .data file. It covers the columns with SMA on except
+ * decimal ones. Entry i belongs to record i of the brin block, a column not in the entry is unknown (not all null as in
+ * the .sma file).
+ */
+typedef struct {
+  int32_t numOfRecords;
+  SBuffer offsets;  // int32_t, end offset of each entry in data
+  SBuffer data;     // (colId, numOfNull, min, max) of each column
+} SZoneMapBlock;
+
+typedef struct {
+  SFDataPtr dp[1];
+  int64_t   brinOffset;  // offset of the brin block in the .head file
+  int32_t   numRec;
+  int8_t    rsvd[4];
+} SZoneMapBlk;
+
+typedef TARRAY2(SZoneMapBlk) TZoneMapBlkArray;
+
+#define ZONE_MAP_TYPE_VALID(t) (!IS_DECIMAL_TYPE(t))
+
+void    tZoneMapBlockInit(SZoneMapBlock *zoneMapBlock);
+void    tZoneMapBlockDestroy(SZoneMapBlock *zoneMapBlock);
+void    tZoneMapBlockClear(SZoneMapBlock *zoneMapBlock);
+int32_t tZoneMapBlockPut(SZoneMapBlock *zoneMapBlock, const void *entry, uint32_t size);
+int32_t tZoneMapBlockGet(const SZoneMapBlock *zoneMapBlock, int32_t idx, const void **entry, uint32_t *size);
+int32_t tPutZoneMapColumn(SBuffer *buffer, const SColumnDataAgg *pColAgg);
+int32_t tGetZoneMapColumn(SBufferReader *br, SColumnDataAgg *pColAgg);
+
 // other apis
 int32_t tsdbUpdateSkmTb(STsdb *pTsdb, const TABLEID *tbid, SSkmInfo *pSkmTb);
 int32_t tsdbUpdateSkmRow(STsdb *pTsdb, const TABLEID *tbid, int32_t sver, SSkmInfo *pSkmRow);
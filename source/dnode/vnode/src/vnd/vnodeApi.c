@@ -43,9 +43,11 @@ void initTsdbReaderAPI(TsdReader* pReader) {
   pReader->tsdNextDataBlock = tsdbNextDataBlock2;
 
   pReader->tsdReaderRetrieveDataBlock = tsdbRetrieveDataBlock2;
+  pReader->tsdReaderRetrieveRemainColumns = tsdbRetrieveRemainColumns2;
   pReader->tsdReaderReleaseDataBlock = tsdbReleaseDataBlock2;
 
   pReader->tsdReaderRetrieveBlockSMAInfo = tsdbRetrieveDatablockSMA2;
+  pReader->tsdReaderRetrieveBlockZoneMap = (int32_t(*)(void*, SSDataBlock*, bool*))tsdbRetrieveDatablockZoneMap2;
 
   pReader->tsdReaderNotifyClosing = tsdbReaderSetCloseFlag;
   pReader->tsdReaderResetStatus = tsdbReaderReset2;
@@ -58,6 +60,7 @@ void initTsdbReaderAPI(TsdReader* pReader) {
 
   pReader->tsdSetFilesetDelimited = (void (*)(void*))tsdbSetFilesetDelimited;
   pReader->tsdSetSetNotifyCb = (void (*)(void*, TsdReaderNotifyCbFn, void*))tsdbReaderSetNotifyCb;
+  pReader->tsdSetBlockFilter = (void (*)(void*, TsdReaderBlockFilterFn, void*))tsdbReaderSetBlockFilter;
 
   // file set iterate
   pReader->fileSetReaderOpen = tsdbFileSetReaderOpen;
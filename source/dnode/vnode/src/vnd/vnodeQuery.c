@@ -1427,6 +1427,10 @@ int32_t vnodeGetRawWriteMetrics(void *pVnode, SRawWriteMetrics *pRawMetrics) {
   pRawMetrics->merge_time = atomic_load_64(&pVnode1->writeMetrics.merge_time);
   pRawMetrics->last_cache_commit_time = atomic_load_64(&pVnode1->writeMetrics.last_cache_commit_time);
   pRawMetrics->last_cache_commit_count = atomic_load_64(&pVnode1->writeMetrics.last_cache_commit_count);
+  pRawMetrics->commit_fset_count = atomic_load_64(&pVnode1->writeMetrics.commit_fset_count);
+  pRawMetrics->commit_fset_time = atomic_load_64(&pVnode1->writeMetrics.commit_fset_time);
+  pRawMetrics->commit_write_bytes = atomic_load_64(&pVnode1->writeMetrics.commit_write_bytes);
+  pRawMetrics->merge_write_bytes = atomic_load_64(&pVnode1->writeMetrics.merge_write_bytes);
 
   return 0;
 }
@@ -1464,6 +1468,10 @@ int32_t vnodeResetRawWriteMetrics(void *pVnode, const SRawWriteMetrics *pOldMetr
   // Reset new cache metrics
   (void)atomic_sub_fetch_64(&pVnode1->writeMetrics.last_cache_commit_time, pOldMetrics->last_cache_commit_time);
   (void)atomic_sub_fetch_64(&pVnode1->writeMetrics.last_cache_commit_count, pOldMetrics->last_cache_commit_count);
+  (void)atomic_sub_fetch_64(&pVnode1->writeMetrics.commit_fset_count, pOldMetrics->commit_fset_count);
+  (void)atomic_sub_fetch_64(&pVnode1->writeMetrics.commit_fset_time, pOldMetrics->commit_fset_time);
+  (void)atomic_sub_fetch_64(&pVnode1->writeMetrics.commit_write_bytes, pOldMetrics->commit_write_bytes);
+  (void)atomic_sub_fetch_64(&pVnode1->writeMetrics.merge_write_bytes, pOldMetrics->merge_write_bytes);
 
   // Reset sync metrics
   SSyncMetrics syncMetrics = {
@@ -1474,3 +1482,44 @@ int32_t vnodeResetRawWriteMetrics(void *pVnode, const SRawWriteMetrics *pOldMetr
 
   return 0;
 }
+
+/*
+ * Get raw query metrics for a vnode, the block cache keeps cumulative counts so the reported part is subtracted
+ */
+int32_t vnodeGetRawQueryMetrics(void *pVnode, SRawQueryMetrics *pRawMetrics) {
+  if (pVnode == NULL || pRawMetrics == NULL) {
+    return TSDB_CODE_INVALID_PARA;
+  }
+
+  STsdb *pTsdb = ((SVnode *)pVnode)->pTsdb;
+  if (pTsdb == NULL) {
+    return TSDB_CODE_INVALID_PARA;
+  }
+
+  SLRUCacheStat stat = {0};
+  tsdbCacheGetColDataStat(pTsdb, &stat);
+
+  pRawMetrics->block_cache_hits = stat.hits - pTsdb->dCacheReported.hits;
+  pRawMetrics->block_cache_misses = stat.misses - pTsdb->dCacheReported.misses;
+
+  return 0;
+}
+
+/*
+ * Reset raw query metrics for a vnode by adding old values to the reported part
+ */
+int32_t vnodeResetRawQueryMetrics(void *pVnode, const SRawQueryMetrics *pOldMetrics) {
+  if (pVnode == NULL || pOldMetrics == NULL) {
+    return TSDB_CODE_INVALID_PARA;
+  }
+
+  STsdb *pTsdb = ((SVnode *)pVnode)->pTsdb;
+  if (pTsdb == NULL) {
+    return TSDB_CODE_INVALID_PARA;
+  }
+
+  pTsdb->dCacheReported.hits += pOldMetrics->block_cache_hits;
+  pTsdb->dCacheReported.misses += pOldMetrics->block_cache_misses;
+
+  return 0;
+}
@@ -0,0 +1,364 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "tsdbDataFileRW.h"
+#include "vnd.h"
+
+namespace {
+
+const int64_t kUid = 1001;
+const int64_t kStartTs = 1700000000000;
+const int32_t kFid = 1700;
+const int64_t kCid = 12;
+const int32_t kBlockRows = 200;
+const int32_t kBlocks = 3;
+
+// ts, c1 int, c2 double with nulls, c3 varchar with nulls, c4 bigint all null, c5 nchar without null
+SSchema blockCacheSchema[] = {
+    {TSDB_DATA_TYPE_TIMESTAMP, COL_SMA_ON, PRIMARYKEY_TIMESTAMP_COL_ID, 8, "ts"},
+    {TSDB_DATA_TYPE_INT, COL_SMA_ON, 2, 4, "c1"},
+    {TSDB_DATA_TYPE_DOUBLE, COL_SMA_ON, 3, 8, "c2"},
+    {TSDB_DATA_TYPE_VARCHAR, COL_SMA_ON, 4, 32, "c3"},
+    {TSDB_DATA_TYPE_BIGINT, COL_SMA_ON, 5, 8, "c4"},
+    {TSDB_DATA_TYPE_NCHAR, COL_SMA_ON, 6, 64, "c5"},
+};
+
+int16_t allCids[] = {2, 3, 4, 5, 6};
+const int32_t kAllCids = sizeof(allCids) / sizeof(allCids[0]);
+
+SColVal colValue(int16_t cid, int8_t type, int64_t val) {
+  SColVal colVal = {};
+  colVal.cid = cid;
+  colVal.flag = CV_FLAG_VALUE;
+  colVal.value.type = type;
+  colVal.value.val = val;
+  return colVal;
+}
+
+SColVal colVarValue(int16_t cid, int8_t type, const std::string &val) {
+  SColVal colVal = {};
+  colVal.cid = cid;
+  colVal.flag = CV_FLAG_VALUE;
+  colVal.value.type = type;
+  colVal.value.pData = (uint8_t *)val.data();
+  colVal.value.nData = val.size();
+  return colVal;
+}
+
+SColVal colNull(int16_t cid, int8_t type) {
+  SColVal colVal = {};
+  colVal.cid = cid;
+  colVal.flag = CV_FLAG_NULL;
+  colVal.value.type = type;
+  return colVal;
+}
+
+int64_t doubleBits(double v) {
+  int64_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  return bits;
+}
+
+// every value of cid in b is the same as in a, the var-length ones byte by byte
+void expectSameColumns(SBlockData *a, SBlockData *b, const int16_t cids[], int32_t ncid) {
+  ASSERT_EQ(a->nRow, b->nRow);
+  for (int32_t i = 0; i < ncid; ++i) {
+    SColData *ca = tBlockDataGetColData(a, cids[i]);
+    SColData *cb = tBlockDataGetColData(b, cids[i]);
+    ASSERT_NE(ca, nullptr);
+    ASSERT_NE(cb, nullptr);
+    ASSERT_EQ(ca->type, cb->type);
+    ASSERT_EQ(ca->flag, cb->flag) << "cid:" << cids[i];
+    ASSERT_EQ(ca->nVal, cb->nVal) << "cid:" << cids[i];
+
+    for (int32_t iVal = 0; iVal < ca->nVal; ++iVal) {
+      SColVal va, vb;
+      ASSERT_EQ(tColDataGetValue(ca, iVal, &va), 0);
+      ASSERT_EQ(tColDataGetValue(cb, iVal, &vb), 0);
+      ASSERT_EQ(va.flag, vb.flag) << "cid:" << cids[i] << " row:" << iVal;
+      if (!COL_VAL_IS_VALUE(&va)) continue;
+      if (IS_VAR_DATA_TYPE(ca->type)) {
+        ASSERT_EQ(va.value.nData, vb.value.nData) << "cid:" << cids[i] << " row:" << iVal;
+        EXPECT_EQ(memcmp(va.value.pData, vb.value.pData, va.value.nData), 0) << "cid:" << cids[i] << " row:" << iVal;
+      } else {
+        EXPECT_EQ(va.value.val, vb.value.val) << "cid:" << cids[i] << " row:" << iVal;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+class tsdbBlockCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    vnode = (SVnode *)taosMemoryCalloc(1, sizeof(SVnode));
+    tsdb = (STsdb *)taosMemoryCalloc(1, sizeof(STsdb));
+    ASSERT_NE(vnode, nullptr);
+    ASSERT_NE(tsdb, nullptr);
+    vnode->config.vgId = 1;
+    vnode->config.tsdbPageSize = 4096;
+    tsdb->pVnode = vnode;
+
+    schema = tBuildTSchema(blockCacheSchema, sizeof(blockCacheSchema) / sizeof(blockCacheSchema[0]), 1);
+    ASSERT_NE(schema, nullptr);
+
+    ASSERT_EQ(taosMulMkDir(TD_TMP_DIR_PATH), 0);
+    dataName = std::string(TD_TMP_DIR_PATH) + "tsdbBlockCacheTest.data";
+    writeDataFile();
+
+    SDataFileReaderConfig config = {};
+    const char           *fname[TSDB_FTYPE_MAX] = {};
+    config.tsdb = tsdb;
+    config.szPage = vnode->config.tsdbPageSize;
+    config.files[TSDB_FTYPE_DATA].exist = true;
+    config.files[TSDB_FTYPE_DATA].file.fid = kFid;
+    config.files[TSDB_FTYPE_DATA].file.cid = kCid;
+    config.files[TSDB_FTYPE_DATA].file.size = dataSize;
+    fname[TSDB_FTYPE_DATA] = dataName.c_str();
+    ASSERT_EQ(tsdbDataFileReaderOpen(fname, &config, &reader), 0);
+
+    // what a query decodes with the cache off
+    for (int32_t b = 0; b < kBlocks; ++b) {
+      ASSERT_EQ(tBlockDataCreate(&expected[b]), 0);
+      readBlock(b, allCids, kAllCids, &expected[b]);
+    }
+  }
+
+  void TearDown() override {
+    for (int32_t b = 0; b < kBlocks; ++b) {
+      tBlockDataDestroy(&expected[b]);
+    }
+    tsdbDataFileReaderClose(&reader);
+    closeCache();
+    (void)taosRemoveFile(dataName.c_str());
+    tDestroyTSchema(schema);
+    taosMemoryFree(tsdb);
+    taosMemoryFree(vnode);
+  }
+
+  void buildBlockData(int32_t b, SBlockData *bData) {
+    TABLEID tbid = {.suid = 0, .uid = kUid};
+    ASSERT_EQ(tBlockDataInit(bData, &tbid, schema, NULL, 0), 0);
+
+    SArray *colVals = taosArrayInit(schema->numOfCols, sizeof(SColVal));
+    ASSERT_NE(colVals, nullptr);
+    for (int32_t i = 0; i < kBlockRows; ++i) {
+      int32_t     n = b * kBlockRows + i;
+      std::string c3 = "v" + std::to_string(n) + std::string(n % 17, 'x');
+      std::string c5 = std::string(1 + n % 5, 'n') + std::to_string(n);
+      SColVal     colVal;
+
+      taosArrayClear(colVals);
+      colVal = colValue(1, TSDB_DATA_TYPE_TIMESTAMP, kStartTs + n);
+      ASSERT_NE(taosArrayPush(colVals, &colVal), nullptr);
+      colVal = colValue(2, TSDB_DATA_TYPE_INT, n * 7);
+      ASSERT_NE(taosArrayPush(colVals, &colVal), nullptr);
+      colVal = i % 7 == 0 ? colNull(3, TSDB_DATA_TYPE_DOUBLE) : colValue(3, TSDB_DATA_TYPE_DOUBLE, doubleBits(n * 0.5));
+      ASSERT_NE(taosArrayPush(colVals, &colVal), nullptr);
+      colVal = i % 5 == 0 ? colNull(4, TSDB_DATA_TYPE_VARCHAR) : colVarValue(4, TSDB_DATA_TYPE_VARCHAR, c3);
+      ASSERT_NE(taosArrayPush(colVals, &colVal), nullptr);
+      colVal = colNull(5, TSDB_DATA_TYPE_BIGINT);
+      ASSERT_NE(taosArrayPush(colVals, &colVal), nullptr);
+      colVal = colVarValue(6, TSDB_DATA_TYPE_NCHAR, c5);
+      ASSERT_NE(taosArrayPush(colVals, &colVal), nullptr);
+
+      SRow             *row = NULL;
+      SRowBuildScanInfo sinfo = {};
+      ASSERT_EQ(tRowBuild(colVals, schema, &row, &sinfo), 0);
+
+      TSDBROW tsdbRow = {};
+      tsdbRow.type = TSDBROW_ROW_FMT;
+      tsdbRow.version = b + 1;
+      tsdbRow.pTSRow = row;
+      ASSERT_EQ(tBlockDataAppendRow(bData, &tsdbRow, schema, kUid), 0);
+      taosMemoryFree(row);
+    }
+    taosArrayDestroy(colVals);
+  }
+
+  // writes kBlocks blocks to the .data file the way the data file writer does
+  void writeDataFile() {
+    STsdbFD         *fd = NULL;
+    SBlockData       bData[1];
+    SBuffer          buffers[4];
+    SBuffer          assist[1];
+    SColCompressInfo cmprInfo = {.pColCmpr = NULL, .defaultCmprAlg = TWO_STAGE_COMP, .trialCmpr = false};
+    int32_t          flag = TD_FILE_READ | TD_FILE_WRITE | TD_FILE_CREATE | TD_FILE_TRUNC;
+
+    ASSERT_EQ(tsdbOpenFile(dataName.c_str(), tsdb, flag, &fd, 0), 0);
+    ASSERT_EQ(tBlockDataCreate(bData), 0);
+    for (int32_t i = 0; i < 4; ++i) {
+      tBufferInit(&buffers[i]);
+    }
+    tBufferInit(assist);
+
+    dataSize = 0;
+    for (int32_t b = 0; b < kBlocks; ++b) {
+      buildBlockData(b, bData);
+      ASSERT_EQ(tBlockDataCompress(bData, &cmprInfo, buffers, assist), 0);
+
+      SBrinRecord &record = records[b];
+      record = {};
+      record.uid = kUid;
+      record.firstKey.key.ts = bData->aTSKEY[0];
+      record.firstKey.version = b + 1;
+      record.lastKey.key.ts = bData->aTSKEY[bData->nRow - 1];
+      record.lastKey.version = b + 1;
+      record.minVer = b + 1;
+      record.maxVer = b + 1;
+      record.blockOffset = dataSize;
+      record.blockKeySize = buffers[0].size + buffers[1].size;
+      record.blockSize = record.blockKeySize + buffers[2].size + buffers[3].size;
+      record.numRow = bData->nRow;
+      record.count = bData->nRow;
+
+      for (int32_t i = 0; i < 4; ++i) {
+        ASSERT_EQ(tsdbWriteFile(fd, dataSize, (const uint8_t *)buffers[i].data, buffers[i].size, 0, NULL), 0);
+        dataSize += buffers[i].size;
+      }
+      tBlockDataReset(bData);
+    }
+    ASSERT_EQ(tsdbFsyncFile(fd, 0, NULL), 0);
+
+    tsdbCloseFile(&fd);
+    for (int32_t i = 0; i < 4; ++i) {
+      tBufferDestroy(&buffers[i]);
+    }
+    tBufferDestroy(assist);
+    tBlockDataDestroy(bData);
+  }
+
+  // the cache of decoded columns as the tsdb opens it
+  void openCache(size_t capacity) {
+    closeCache();
+    tsdb->dCache = taosLRUCacheInitWithPolicy(capacity, -1, .5, TAOS_LRU_POLICY_TINYLFU);
+    ASSERT_NE(tsdb->dCache, nullptr);
+    taosLRUCacheSetStrictCapacity(tsdb->dCache, true);
+  }
+
+  void closeCache() {
+    if (tsdb->dCache != NULL) {
+      taosLRUCacheEraseUnrefEntries(tsdb->dCache);
+      taosLRUCacheCleanup(tsdb->dCache);
+      tsdb->dCache = NULL;
+    }
+  }
+
+  SLRUCacheStat cacheStat() {
+    SLRUCacheStat stat = {};
+    tsdbCacheGetColDataStat(tsdb, &stat);
+    return stat;
+  }
+
+  void readBlock(int32_t b, const int16_t cids[], int32_t ncid, SBlockData *bData) {
+    int16_t aCid[kAllCids];
+    memcpy(aCid, cids, sizeof(int16_t) * ncid);
+    ASSERT_EQ(tsdbDataFileReadBlockDataByColumn(reader, &records[b], bData, schema, aCid, ncid), 0);
+    ASSERT_EQ(bData->nRow, kBlockRows);
+  }
+
+  // reads every block with cids and checks it against the cache off decode
+  void readAndCheck(const int16_t cids[], int32_t ncid) {
+    SBlockData bData[1];
+    ASSERT_EQ(tBlockDataCreate(bData), 0);
+    for (int32_t b = 0; b < kBlocks; ++b) {
+      readBlock(b, cids, ncid, bData);
+      expectSameColumns(&expected[b], bData, cids, ncid);
+    }
+    tBlockDataDestroy(bData);
+  }
+
+  SVnode          *vnode = NULL;
+  STsdb           *tsdb = NULL;
+  STSchema        *schema = NULL;
+  SDataFileReader *reader = NULL;
+  std::string      dataName;
+  int64_t          dataSize = 0;
+  SBrinRecord      records[kBlocks];
+  SBlockData       expected[kBlocks];
+};
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+TEST_F(tsdbBlockCacheTest, cacheOffDecode) {
+  // the columns the cache has to keep as they are: nulls in fixed and var-length ones, and an all null one
+  for (int32_t b = 0; b < kBlocks; ++b) {
+    EXPECT_EQ(tBlockDataGetColData(&expected[b], 3)->flag, HAS_VALUE | HAS_NULL);
+    EXPECT_EQ(tBlockDataGetColData(&expected[b], 4)->flag, HAS_VALUE | HAS_NULL);
+    EXPECT_EQ(tBlockDataGetColData(&expected[b], 5)->flag, HAS_NULL);
+    EXPECT_EQ(tBlockDataGetColData(&expected[b], 6)->flag, HAS_VALUE);
+  }
+
+  SLRUCacheStat stat = cacheStat();
+  EXPECT_EQ(stat.hits, 0);
+  EXPECT_EQ(stat.misses, 0);
+}
+
+TEST_F(tsdbBlockCacheTest, readTwice) {
+  openCache(1024 * 1024);
+
+  // decoded from the file and put into the cache
+  readAndCheck(allCids, kAllCids);
+  SLRUCacheStat stat = cacheStat();
+  EXPECT_EQ(stat.hits, 0);
+  EXPECT_EQ(stat.misses, kBlocks * kAllCids);
+
+  // copied from the cache without reading the columns of the file
+  readAndCheck(allCids, kAllCids);
+  stat = cacheStat();
+  EXPECT_EQ(stat.hits, kBlocks * kAllCids);
+  EXPECT_EQ(stat.misses, kBlocks * kAllCids);
+
+  // an entry copied out is not changed by the reader reusing its block data
+  readAndCheck(allCids, kAllCids);
+  stat = cacheStat();
+  EXPECT_EQ(stat.hits, 2 * kBlocks * kAllCids);
+}
+
+TEST_F(tsdbBlockCacheTest, partialHit) {
+  openCache(1024 * 1024);
+
+  // c2 and c3 are cached, the others are decoded in the same block data around them
+  int16_t someCids[] = {3, 4};
+  readAndCheck(someCids, 2);
+  readAndCheck(allCids, kAllCids);
+  SLRUCacheStat stat = cacheStat();
+  EXPECT_EQ(stat.hits, kBlocks * 2);
+  EXPECT_EQ(stat.misses, kBlocks * (2 + kAllCids - 2));
+
+  readAndCheck(allCids, kAllCids);
+  stat = cacheStat();
+  EXPECT_EQ(stat.hits, kBlocks * (2 + kAllCids));
+}
+
+TEST_F(tsdbBlockCacheTest, entryDoesNotFit) {
+  // no column of a block fits, every read decodes from the file
+  openCache(64);
+
+  readAndCheck(allCids, kAllCids);
+  readAndCheck(allCids, kAllCids);
+  SLRUCacheStat stat = cacheStat();
+  EXPECT_EQ(stat.hits, 0);
+  EXPECT_EQ(stat.misses, 2 * kBlocks * kAllCids);
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "tsdbMergePlan.h"
+
+namespace {
+
+struct SFileDesc {
+  int32_t level;
+  int64_t size;
+};
+
+// files are given level by level, as they are in a file set
+void mergePlanInit(SMergePlan *plan, const std::vector<SFileDesc> &files) {
+  *plan = SMergePlan{};
+  plan->files = (SMergeFile *)taosMemoryCalloc(files.size() + 1, sizeof(SMergeFile));
+  ASSERT_NE(plan->files, nullptr);
+  for (const SFileDesc &desc : files) {
+    SMergeFile *file = &plan->files[plan->numFile++];
+    file->level = desc.level;
+    file->size = desc.size;
+    file->nRow = desc.size / 16;
+    file->skey = 0;
+    file->ekey = 1000000;
+  }
+  ASSERT_EQ(tsdbMergePlanPrepare(plan), 0);
+}
+
+std::vector<int32_t> mergePlanBest(const SMergePlan *plan) {
+  std::vector<int32_t> best;
+  for (int32_t i = 0; i < plan->numFile; ++i) {
+    if (plan->best[i]) best.push_back(i);
+  }
+  return best;
+}
+
+int32_t mergePlanBestLevel0(const SMergePlan *plan) {
+  int32_t num = 0;
+  for (int32_t i = 0; i < plan->numFile; ++i) {
+    num += (plan->best[i] && plan->files[i].level == 0);
+  }
+  return num;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+TEST(tsdbMergeTest, leveledMergesToHighestLevel) {
+  SMergePlan plan;
+
+  // level 0 overflows into level 1, which is full as well, so everything goes to level 2
+  mergePlanInit(&plan, {{0, 1 << 20}, {0, 1 << 20}, {0, 1 << 20}, {0, 1 << 20}, {1, 64 << 20}, {1, 64 << 20},
+                        {1, 64 << 20}});
+  tsdbMergeProposeLeveled(&plan, 4, false);
+  EXPECT_EQ(plan.level, 2);
+  EXPECT_EQ(mergePlanBest(&plan), std::vector<int32_t>({0, 1, 2, 3, 4, 5, 6}));
+  tsdbMergePlanClear(&plan);
+
+  // the scored variant may stop at level 1 instead of rewriting the large level-1 files
+  mergePlanInit(&plan, {{0, 1 << 20}, {0, 1 << 20}, {0, 1 << 20}, {0, 1 << 20}, {1, 64 << 20}, {1, 64 << 20},
+                        {1, 64 << 20}});
+  tsdbMergeProposeLeveled(&plan, 4, true);
+  EXPECT_EQ(plan.level, 1);
+  EXPECT_EQ(mergePlanBest(&plan), std::vector<int32_t>({0, 1, 2, 3}));
+  tsdbMergePlanClear(&plan);
+
+  // only the oldest level-0 files that fill the level are taken
+  mergePlanInit(&plan, {{0, 100}, {0, 100}, {0, 100}, {0, 100}, {0, 100}, {0, 100}});
+  tsdbMergeProposeLeveled(&plan, 4, false);
+  EXPECT_EQ(plan.level, 1);
+  EXPECT_EQ(mergePlanBest(&plan), std::vector<int32_t>({0, 1, 2, 3}));
+  tsdbMergePlanClear(&plan);
+}
+
+TEST(tsdbMergeTest, tieredGroupsBySize) {
+  SMergePlan plan;
+
+  // 150 is within TSDB_MERGE_TIER_RATIO of the tier average 100 and joins it, 160 is not
+  mergePlanInit(&plan, {{0, 100}, {0, 100}, {0, 100}, {0, 100}, {1, 150}, {1, 160 * 100}});
+  tsdbMergeProposeTiered(&plan, 4);
+  EXPECT_EQ(plan.level, 2);
+  EXPECT_EQ(mergePlanBest(&plan), std::vector<int32_t>({0, 1, 2, 3, 4}));
+  tsdbMergePlanClear(&plan);
+
+  mergePlanInit(&plan, {{0, 100}, {0, 100}, {0, 100}, {0, 100}, {1, 160}});
+  tsdbMergeProposeTiered(&plan, 4);
+  EXPECT_EQ(plan.level, 1);
+  EXPECT_EQ(mergePlanBest(&plan), std::vector<int32_t>({0, 1, 2, 3}));
+  tsdbMergePlanClear(&plan);
+
+  // the tier of large files is left alone while the small level-0 files are merged
+  mergePlanInit(&plan, {{0, 10}, {0, 11}, {0, 12}, {0, 13}, {1, 1000}, {1, 1000}, {1, 1000}, {2, 1000}});
+  tsdbMergeProposeTiered(&plan, 4);
+  EXPECT_EQ(plan.level, 1);
+  EXPECT_EQ(mergePlanBest(&plan), std::vector<int32_t>({0, 1, 2, 3}));
+  tsdbMergePlanClear(&plan);
+}
+
+TEST(tsdbMergeTest, tieredDrainsLevel0) {
+  SMergePlan plan;
+
+  // the only full tier holds a single level-0 file, so it is not ready and the leveled merge is done instead
+  mergePlanInit(&plan, {{0, 10}, {0, 20}, {0, 40}, {0, 1000}, {1, 1000}, {1, 1000}, {1, 1000}});
+  tsdbMergeProposeTiered(&plan, 4);
+  EXPECT_EQ(plan.level, 2);
+  EXPECT_EQ(mergePlanBest(&plan), std::vector<int32_t>({0, 1, 2, 3, 4, 5, 6}));
+  tsdbMergePlanClear(&plan);
+
+  // whatever the sizes are, a merge triggered by a full level 0 takes at least sttTrigger level-0 files
+  std::mt19937 rng(20261018);
+  for (int32_t round = 0; round < 2000; ++round) {
+    int32_t                sttTrigger = 2 + rng() % 15;
+    std::vector<SFileDesc> files;
+    int32_t                numLevel0 = sttTrigger + rng() % sttTrigger;
+    for (int32_t i = 0; i < numLevel0; ++i) {
+      files.push_back({0, (int64_t)(1 + rng() % 1000)});
+    }
+    for (int32_t level = 1; level <= TSDB_MAX_LEVEL; ++level) {
+      int32_t num = rng() % sttTrigger;
+      for (int32_t i = 0; i < num; ++i) {
+        files.push_back({level, (int64_t)(1 + rng() % (1000 << (4 * level)))});
+      }
+    }
+
+    for (int32_t policy = 0; policy < TSDB_MERGE_POLICY_MAX; ++policy) {
+      mergePlanInit(&plan, files);
+      if (policy == TSDB_MERGE_POLICY_TIERED) {
+        tsdbMergeProposeTiered(&plan, sttTrigger);
+      } else {
+        tsdbMergeProposeLeveled(&plan, sttTrigger, policy == TSDB_MERGE_POLICY_LEVELED_SCORED);
+      }
+      ASSERT_GE(plan.score, 0);
+      ASSERT_GE(mergePlanBestLevel0(&plan), sttTrigger) << "round:" << round << " policy:" << policy;
+      ASSERT_LE(plan.level, TSDB_MAX_LEVEL + 1);
+      tsdbMergePlanClear(&plan);
+    }
+  }
+}
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "tsdbFSet2.h"
+#include "vnd.h"
+
+namespace {
+
+const int32_t kFid = 1800;
+
+STFile dataFile(int32_t level, int64_t cid, int64_t size) {
+  STFile f = {};
+  f.type = TSDB_FTYPE_DATA;
+  f.did.level = level;
+  f.did.id = 0;
+  f.fid = kFid;
+  f.cid = cid;
+  f.size = size;
+  f.minVer = 1;
+  f.maxVer = 100;
+  return f;
+}
+
+STFile sttFile(int64_t cid, int64_t size) {
+  STFile f = dataFile(0, cid, size);
+  f.type = TSDB_FTYPE_STT;
+  f.stt->level = 0;
+  return f;
+}
+
+}  // namespace
+
+class tsdbRetentionTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    vnode = (SVnode *)taosMemoryCalloc(1, sizeof(SVnode));
+    tsdb = (STsdb *)taosMemoryCalloc(1, sizeof(STsdb));
+    ASSERT_NE(vnode, nullptr);
+    ASSERT_NE(tsdb, nullptr);
+    vnode->config.vgId = 1;
+    tsdb->pVnode = vnode;
+    tsdb->path = (char *)TD_TMP_DIR_PATH;
+
+    ASSERT_EQ(tsdbTFileSetInit(kFid, &fset), 0);
+  }
+
+  void TearDown() override {
+    tsdbTFileSetClear(&fset);
+    taosMemoryFree(tsdb);
+    taosMemoryFree(vnode);
+  }
+
+  void edit(tsdb_fop_t optype, const STFile &of, const STFile &nf, int64_t offset = 0) {
+    STFileOp op = {};
+    op.optype = optype;
+    op.fid = kFid;
+    op.of = of;
+    op.nf = nf;
+    op.offset = offset;
+    ASSERT_EQ(tsdbTFileSetEdit(tsdb, fset, &op), 0);
+  }
+
+  // save the set to json and load it back, as the fs does with current.json
+  STFileSet *reload(const STFileSet *fset1) {
+    STFileSet *fset2 = nullptr;
+    cJSON     *json = cJSON_CreateObject();
+    EXPECT_NE(json, nullptr);
+    EXPECT_EQ(tsdbTFileSetToJson(fset1, json), 0);
+    EXPECT_EQ(tsdbJsonToTFileSet(tsdb, json, &fset2), 0);
+    cJSON_Delete(json);
+    return fset2;
+  }
+
+  SVnode    *vnode = nullptr;
+  STsdb     *tsdb = nullptr;
+  STFileSet *fset = nullptr;
+};
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+TEST_F(tsdbRetentionTest, ckptJsonRoundTrip) {
+  STFile of = dataFile(0, 10, 256 << 20);
+  STFile nf = dataFile(1, 11, 256 << 20);
+
+  edit(TSDB_FOP_CREATE, STFile{}, of);
+  edit(TSDB_FOP_CKPT, of, nf, 96 << 20);
+  ASSERT_EQ(fset->rtnCkpt.offset, 96 << 20);
+
+  STFileSet *fset2 = reload(fset);
+  ASSERT_NE(fset2, nullptr);
+  EXPECT_EQ(fset2->rtnCkpt.offset, 96 << 20);
+  EXPECT_TRUE(tsdbIsSameTFile(fset2->rtnCkpt.of, &of));
+  EXPECT_FALSE(tsdbIsTFileChanged(fset2->rtnCkpt.of, &of));
+  EXPECT_TRUE(tsdbIsSameTFile(fset2->rtnCkpt.nf, &nf));
+  EXPECT_EQ(fset2->rtnCkpt.nf->did.level, 1);
+  EXPECT_EQ(fset2->rtnCkpt.nf->size, nf.size);
+  EXPECT_EQ(fset2->rtnCkpt.nf->minVer, nf.minVer);
+  EXPECT_EQ(fset2->rtnCkpt.nf->maxVer, nf.maxVer);
+
+  // the loaded checkpoint still matches the source file of the set
+  tsdbTFileSetCheckCkpt(fset2);
+  EXPECT_EQ(fset2->rtnCkpt.offset, 96 << 20);
+  tsdbTFileSetClear(&fset2);
+}
+
+TEST_F(tsdbRetentionTest, noCkptInJson) {
+  edit(TSDB_FOP_CREATE, STFile{}, dataFile(0, 10, 4096));
+
+  cJSON *json = cJSON_CreateObject();
+  ASSERT_NE(json, nullptr);
+  ASSERT_EQ(tsdbTFileSetToJson(fset, json), 0);
+  EXPECT_EQ(cJSON_GetObjectItem(json, "rtn ckpt"), nullptr);
+  cJSON_Delete(json);
+}
+
+TEST_F(tsdbRetentionTest, badCkptIsIgnored) {
+  edit(TSDB_FOP_CREATE, STFile{}, dataFile(0, 10, 4096));
+  edit(TSDB_FOP_CKPT, dataFile(0, 10, 4096), dataFile(1, 11, 4096), 1024);
+
+  cJSON *json = cJSON_CreateObject();
+  ASSERT_NE(json, nullptr);
+  ASSERT_EQ(tsdbTFileSetToJson(fset, json), 0);
+  cJSON *ckpt = cJSON_GetObjectItem(json, "rtn ckpt");
+  ASSERT_NE(ckpt, nullptr);
+  cJSON_DeleteItemFromObject(ckpt, "nf");
+
+  // the set itself loads, only the migration starts over
+  STFileSet *fset2 = nullptr;
+  ASSERT_EQ(tsdbJsonToTFileSet(tsdb, json, &fset2), 0);
+  EXPECT_NE(fset2->farr[TSDB_FTYPE_DATA], nullptr);
+  EXPECT_EQ(fset2->rtnCkpt.offset, 0);
+  tsdbTFileSetClear(&fset2);
+  cJSON_Delete(json);
+}
+
+TEST_F(tsdbRetentionTest, staleCkptIsDropped) {
+  STFile of = dataFile(0, 10, 8192);
+  STFile nf = dataFile(1, 11, 8192);
+
+  edit(TSDB_FOP_CREATE, STFile{}, of);
+  edit(TSDB_FOP_CKPT, of, nf, 4096);
+  tsdbTFileSetCheckCkpt(fset);
+  ASSERT_EQ(fset->rtnCkpt.offset, 4096);
+
+  // a commit appends to the source file, the copied part may not match it anymore
+  STFile of2 = of;
+  of2.size += 4096;
+  edit(TSDB_FOP_MODIFY, of, of2);
+  tsdbTFileSetCheckCkpt(fset);
+  EXPECT_EQ(fset->rtnCkpt.offset, 0);
+
+  // the source file is removed, by a compaction or by the end of the migration
+  edit(TSDB_FOP_CKPT, of2, nf, 4096);
+  edit(TSDB_FOP_REMOVE, of2, STFile{});
+  tsdbTFileSetCheckCkpt(fset);
+  EXPECT_EQ(fset->rtnCkpt.offset, 0);
+
+  // another file of the same type takes its place
+  edit(TSDB_FOP_CREATE, STFile{}, dataFile(0, 12, 8192));
+  edit(TSDB_FOP_CKPT, of2, nf, 4096);
+  tsdbTFileSetCheckCkpt(fset);
+  EXPECT_EQ(fset->rtnCkpt.offset, 0);
+}
+
+TEST_F(tsdbRetentionTest, sttCkpt) {
+  STFile of = sttFile(20, 8192);
+  STFile nf = of;
+  nf.did.level = 1;
+  nf.cid = 21;
+
+  edit(TSDB_FOP_CREATE, STFile{}, of);
+  edit(TSDB_FOP_CKPT, of, nf, 4096);
+  tsdbTFileSetCheckCkpt(fset);
+  ASSERT_EQ(fset->rtnCkpt.offset, 4096);
+
+  STFileSet *fset2 = reload(fset);
+  ASSERT_NE(fset2, nullptr);
+  EXPECT_EQ(fset2->rtnCkpt.offset, 4096);
+  EXPECT_EQ(fset2->rtnCkpt.of->type, TSDB_FTYPE_STT);
+  EXPECT_EQ(fset2->rtnCkpt.of->stt->level, 0);
+  tsdbTFileSetClear(&fset2);
+
+  // the stt file is merged away
+  edit(TSDB_FOP_REMOVE, of, STFile{});
+  tsdbTFileSetCheckCkpt(fset);
+  EXPECT_EQ(fset->rtnCkpt.offset, 0);
+}
@@ -0,0 +1,441 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "tsdbDataFileRW.h"
+#include "vnd.h"
+
+namespace {
+
+const int64_t kUid = 1001;
+const int64_t kStartTs = 1700000000000;
+const int32_t kBlockRows = 100;
+const int32_t kBlocks = 6;
+
+// .head files written before the zone map keep the whole reserved area zero
+typedef struct {
+  SFDataPtr brinBlkPtr[1];
+  char      rsrvd[32];
+} SLegacyHeadFooter;
+
+static_assert(sizeof(SLegacyHeadFooter) == sizeof(SHeadFooter), "the head footer must keep its size");
+
+// ts, c1 int, c2 double with nulls, c3 varchar with nulls, c4 bigint all null, c5 int with SMA off
+SSchema zoneMapSchema[] = {
+    {TSDB_DATA_TYPE_TIMESTAMP, COL_SMA_ON, PRIMARYKEY_TIMESTAMP_COL_ID, 8, "ts"},
+    {TSDB_DATA_TYPE_INT, COL_SMA_ON, 2, 4, "c1"},
+    {TSDB_DATA_TYPE_DOUBLE, COL_SMA_ON, 3, 8, "c2"},
+    {TSDB_DATA_TYPE_VARCHAR, COL_SMA_ON, 4, 16, "c3"},
+    {TSDB_DATA_TYPE_BIGINT, COL_SMA_ON, 5, 8, "c4"},
+    {TSDB_DATA_TYPE_INT, 0, 6, 4, "c5"},
+};
+
+// c1 of block b is a permutation of [b * 1000 - 50, b * 1000 + 49]
+int32_t c1Value(int32_t b, int32_t i) { return b * 1000 + (i * 37) % kBlockRows - 50; }
+double  c2Value(int32_t b, int32_t i) { return (b * kBlockRows + i) * 0.5; }
+bool    c2IsNull(int32_t i) { return i % 7 == 0; }
+bool    c3IsNull(int32_t i) { return i % 5 == 0; }
+
+int16_t nullCount(bool (*isNull)(int32_t)) {
+  int16_t n = 0;
+  for (int32_t i = 0; i < kBlockRows; ++i) {
+    n += isNull(i);
+  }
+  return n;
+}
+
+SColVal colValue(int16_t cid, int8_t type, int64_t val) {
+  SColVal colVal = {};
+  colVal.cid = cid;
+  colVal.flag = CV_FLAG_VALUE;
+  colVal.value.type = type;
+  colVal.value.val = val;
+  return colVal;
+}
+
+SColVal colVarValue(int16_t cid, int8_t type, const std::string &val) {
+  SColVal colVal = {};
+  colVal.cid = cid;
+  colVal.flag = CV_FLAG_VALUE;
+  colVal.value.type = type;
+  colVal.value.pData = (uint8_t *)val.data();
+  colVal.value.nData = val.size();
+  return colVal;
+}
+
+SColVal colNull(int16_t cid, int8_t type) {
+  SColVal colVal = {};
+  colVal.cid = cid;
+  colVal.flag = CV_FLAG_NULL;
+  colVal.value.type = type;
+  return colVal;
+}
+
+int64_t doubleBits(double v) {
+  int64_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  return bits;
+}
+
+double bitsDouble(int64_t bits) {
+  double v;
+  memcpy(&v, &bits, sizeof(v));
+  return v;
+}
+
+const SColumnDataAgg *findColumnAgg(const TColumnDataAggArray *aggArray, int32_t colId) {
+  for (int32_t i = 0; i < TARRAY2_SIZE(aggArray); ++i) {
+    if (TARRAY2_GET_PTR(aggArray, i)->colId == colId) {
+      return TARRAY2_GET_PTR(aggArray, i);
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+class tsdbZoneMapTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    vnode = (SVnode *)taosMemoryCalloc(1, sizeof(SVnode));
+    tsdb = (STsdb *)taosMemoryCalloc(1, sizeof(STsdb));
+    ASSERT_NE(vnode, nullptr);
+    ASSERT_NE(tsdb, nullptr);
+    vnode->config.vgId = 1;
+    vnode->config.tsdbPageSize = 4096;
+    tsdb->pVnode = vnode;
+
+    schema = tBuildTSchema(zoneMapSchema, sizeof(zoneMapSchema) / sizeof(zoneMapSchema[0]), 1);
+    ASSERT_NE(schema, nullptr);
+
+    ASSERT_EQ(taosMulMkDir(TD_TMP_DIR_PATH), 0);
+    headName = std::string(TD_TMP_DIR_PATH) + "tsdbZoneMapTest.head";
+    smaName = std::string(TD_TMP_DIR_PATH) + "tsdbZoneMapTest.sma";
+  }
+
+  void TearDown() override {
+    (void)taosRemoveFile(headName.c_str());
+    (void)taosRemoveFile(smaName.c_str());
+    tDestroyTSchema(schema);
+    taosMemoryFree(tsdb);
+    taosMemoryFree(vnode);
+  }
+
+  void buildBlockData(int32_t b, SBlockData *bData) {
+    TABLEID tbid = {.suid = 0, .uid = kUid};
+    ASSERT_EQ(tBlockDataInit(bData, &tbid, schema, NULL, 0), 0);
+
+    SArray *colVals = taosArrayInit(schema->numOfCols, sizeof(SColVal));
+    ASSERT_NE(colVals, nullptr);
+    for (int32_t i = 0; i < kBlockRows; ++i) {
+      std::string c3 = "v" + std::to_string(b * kBlockRows + i);
+      SColVal     colVal;
+
+      taosArrayClear(colVals);
+      colVal = colValue(1, TSDB_DATA_TYPE_TIMESTAMP, kStartTs + b * kBlockRows + i);
+      ASSERT_NE(taosArrayPush(colVals, &colVal), nullptr);
+      colVal = colValue(2, TSDB_DATA_TYPE_INT, c1Value(b, i));
+      ASSERT_NE(taosArrayPush(colVals, &colVal), nullptr);
+      colVal = c2IsNull(i) ? colNull(3, TSDB_DATA_TYPE_DOUBLE)
+                           : colValue(3, TSDB_DATA_TYPE_DOUBLE, doubleBits(c2Value(b, i)));
+      ASSERT_NE(taosArrayPush(colVals, &colVal), nullptr);
+      colVal = c3IsNull(i) ? colNull(4, TSDB_DATA_TYPE_VARCHAR) : colVarValue(4, TSDB_DATA_TYPE_VARCHAR, c3);
+      ASSERT_NE(taosArrayPush(colVals, &colVal), nullptr);
+      colVal = colNull(5, TSDB_DATA_TYPE_BIGINT);
+      ASSERT_NE(taosArrayPush(colVals, &colVal), nullptr);
+      colVal = colValue(6, TSDB_DATA_TYPE_INT, -i);
+      ASSERT_NE(taosArrayPush(colVals, &colVal), nullptr);
+
+      SRow             *row = NULL;
+      SRowBuildScanInfo sinfo = {};
+      ASSERT_EQ(tRowBuild(colVals, schema, &row, &sinfo), 0);
+
+      TSDBROW tsdbRow = {};
+      tsdbRow.type = TSDBROW_ROW_FMT;
+      tsdbRow.version = b + 1;
+      tsdbRow.pTSRow = row;
+      ASSERT_EQ(tBlockDataAppendRow(bData, &tsdbRow, schema, kUid), 0);
+      taosMemoryFree(row);
+    }
+    taosArrayDestroy(colVals);
+  }
+
+  // writes kBlocks blocks to the .head and .sma files the way the data file writer does, in two brin blocks so that
+  // the zone map is looked up by the brin block offset; a legacy file has no zone map at all
+  void writeFiles(bool legacy) {
+    STsdbFD         *headFd = NULL;
+    STsdbFD         *smaFd = NULL;
+    SBrinBlock       brinBlock[1];
+    SZoneMapBlock    zoneMapBlock[1];
+    TBrinBlkArray    brinBlkArray[1] = {};
+    TZoneMapBlkArray zoneMapBlkArray[1] = {};
+    SBlockData       bData[1];
+    SBuffer          buffers[4];
+    SVersionRange    range = {.minVer = INT64_MAX, .maxVer = INT64_MIN};
+    int32_t          flag = TD_FILE_READ | TD_FILE_WRITE | TD_FILE_CREATE | TD_FILE_TRUNC;
+
+    ASSERT_EQ(tsdbOpenFile(headName.c_str(), tsdb, flag, &headFd, 0), 0);
+    ASSERT_EQ(tsdbOpenFile(smaName.c_str(), tsdb, flag, &smaFd, 0), 0);
+    ASSERT_EQ(tBrinBlockInit(brinBlock), 0);
+    tZoneMapBlockInit(zoneMapBlock);
+    ASSERT_EQ(tBlockDataCreate(bData), 0);
+    for (int32_t i = 0; i < 4; ++i) {
+      tBufferInit(&buffers[i]);
+    }
+
+    headSize = 0;
+    smaSize = 0;
+    for (int32_t b = 0; b < kBlocks; ++b) {
+      buildBlockData(b, bData);
+      ASSERT_EQ(bData->nRow, kBlockRows);
+
+      SBuffer *sma = &buffers[0];
+      SBuffer *zoneMap = &buffers[1];
+      ASSERT_EQ(tsdbBlockDataPutAgg(bData, sma, zoneMap), 0);
+      ASSERT_EQ(tsdbWriteFile(smaFd, smaSize, (uint8_t *)sma->data, sma->size, 0, NULL), 0);
+
+      SBrinRecord record = {};
+      record.suid = 0;
+      record.uid = kUid;
+      record.firstKey.key.ts = bData->aTSKEY[0];
+      record.firstKey.version = b + 1;
+      record.lastKey.key.ts = bData->aTSKEY[bData->nRow - 1];
+      record.lastKey.version = b + 1;
+      record.minVer = b + 1;
+      record.maxVer = b + 1;
+      record.blockOffset = b * 4096;
+      record.smaOffset = smaSize;
+      record.blockSize = 4096;
+      record.blockKeySize = 1024;
+      record.smaSize = sma->size;
+      record.numRow = bData->nRow;
+      record.count = bData->nRow;
+      smaSize += sma->size;
+
+      ASSERT_EQ(tBrinBlockPut(brinBlock, &record), 0);
+      if (!legacy) {
+        ASSERT_EQ(tZoneMapBlockPut(zoneMapBlock, zoneMap->data, zoneMap->size), 0);
+      }
+
+      if (b == kBlocks / 2 - 1 || b == kBlocks - 1) {
+        int64_t brinOffset = headSize;
+        ASSERT_EQ(tsdbFileWriteBrinBlock(headFd, brinBlock, TWO_STAGE_COMP, &headSize, brinBlkArray, buffers, &range, 0,
+                                         NULL),
+                  0);
+        ASSERT_EQ(tsdbFileWriteZoneMapBlock(headFd, zoneMapBlock, brinOffset, &headSize, zoneMapBlkArray, 0, NULL),
+                  0);
+      }
+      tBlockDataReset(bData);
+    }
+
+    if (legacy) {
+      SLegacyHeadFooter footer = {};
+      ASSERT_EQ(tsdbFileWriteBrinBlk(headFd, brinBlkArray, footer.brinBlkPtr, &headSize, 0, NULL), 0);
+      ASSERT_EQ(tsdbWriteFile(headFd, headSize, (const uint8_t *)&footer, sizeof(footer), 0, NULL), 0);
+      headSize += sizeof(footer);
+    } else {
+      SHeadFooter footer = {};
+      ASSERT_EQ(tsdbFileWriteBrinBlk(headFd, brinBlkArray, footer.brinBlkPtr, &headSize, 0, NULL), 0);
+      ASSERT_EQ(tsdbFileWriteZoneMapBlk(headFd, zoneMapBlkArray, footer.zoneMapBlkPtr, &headSize, 0, NULL), 0);
+      ASSERT_EQ(tsdbFileWriteHeadFooter(headFd, &headSize, &footer, 0, NULL), 0);
+    }
+    ASSERT_EQ(tsdbFsyncFile(headFd, 0, NULL), 0);
+    ASSERT_EQ(tsdbFsyncFile(smaFd, 0, NULL), 0);
+
+    tsdbCloseFile(&headFd);
+    tsdbCloseFile(&smaFd);
+    for (int32_t i = 0; i < 4; ++i) {
+      tBufferDestroy(&buffers[i]);
+    }
+    tBlockDataDestroy(bData);
+    tZoneMapBlockDestroy(zoneMapBlock);
+    tBrinBlockDestroy(brinBlock);
+    TARRAY2_DESTROY(brinBlkArray, NULL);
+    TARRAY2_DESTROY(zoneMapBlkArray, NULL);
+  }
+
+  void openReader(SDataFileReader **reader) {
+    SDataFileReaderConfig config = {};
+    const char           *fname[TSDB_FTYPE_MAX] = {};
+
+    config.tsdb = tsdb;
+    config.szPage = vnode->config.tsdbPageSize;
+    config.files[TSDB_FTYPE_HEAD].exist = true;
+    config.files[TSDB_FTYPE_HEAD].file.size = headSize;
+    config.files[TSDB_FTYPE_SMA].exist = true;
+    config.files[TSDB_FTYPE_SMA].file.size = smaSize;
+    fname[TSDB_FTYPE_HEAD] = headName.c_str();
+    fname[TSDB_FTYPE_SMA] = smaName.c_str();
+    ASSERT_EQ(tsdbDataFileReaderOpen(fname, &config, reader), 0);
+  }
+
+  // the .sma file keeps the columns with SMA on that have a value, the all null c4 is left out
+  void checkBlockSma(int32_t b, const TColumnDataAggArray *smaArray) {
+    ASSERT_EQ(TARRAY2_SIZE(smaArray), 3);
+
+    const SColumnDataAgg *c1 = findColumnAgg(smaArray, 2);
+    ASSERT_NE(c1, nullptr);
+    EXPECT_EQ(c1->min, b * 1000 - 50);
+    EXPECT_EQ(c1->max, b * 1000 + 49);
+    EXPECT_EQ(c1->numOfNull, 0);
+
+    const SColumnDataAgg *c2 = findColumnAgg(smaArray, 3);
+    ASSERT_NE(c2, nullptr);
+    EXPECT_EQ(bitsDouble(c2->min), c2Value(b, 1));
+    EXPECT_EQ(bitsDouble(c2->max), c2Value(b, kBlockRows - 1));
+    EXPECT_EQ(c2->numOfNull, nullCount(c2IsNull));
+
+    EXPECT_EQ(findColumnAgg(smaArray, 5), nullptr);
+    EXPECT_EQ(findColumnAgg(smaArray, 6), nullptr);
+  }
+
+  SVnode     *vnode = NULL;
+  STsdb      *tsdb = NULL;
+  STSchema   *schema = NULL;
+  std::string headName;
+  std::string smaName;
+  int64_t     headSize = 0;
+  int64_t     smaSize = 0;
+};
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+TEST_F(tsdbZoneMapTest, writeReadRoundTrip) {
+  writeFiles(false);
+
+  SDataFileReader *reader = NULL;
+  openReader(&reader);
+  ASSERT_NE(reader, nullptr);
+
+  const TBrinBlkArray *brinBlkArray = NULL;
+  ASSERT_EQ(tsdbDataFileReadBrinBlk(reader, &brinBlkArray), 0);
+  ASSERT_EQ(TARRAY2_SIZE(brinBlkArray), 2);
+
+  const TZoneMapBlkArray *zoneMapBlkArray = NULL;
+  ASSERT_EQ(tsdbDataFileReadZoneMapBlk(reader, &zoneMapBlkArray), 0);
+  ASSERT_EQ(TARRAY2_SIZE(zoneMapBlkArray), 2);
+
+  SBrinBlock          brinBlock[1];
+  TColumnDataAggArray zoneMap[1] = {};
+  TColumnDataAggArray smaArray[1] = {};
+  int32_t             b = 0;
+  ASSERT_EQ(tBrinBlockInit(brinBlock), 0);
+  for (int32_t i = 0; i < TARRAY2_SIZE(brinBlkArray); ++i) {
+    const SBrinBlk *brinBlk = TARRAY2_GET_PTR(brinBlkArray, i);
+    EXPECT_EQ(TARRAY2_GET_PTR(zoneMapBlkArray, i)->brinOffset, brinBlk->dp->offset);
+
+    ASSERT_EQ(tsdbDataFileReadBrinBlock(reader, brinBlk, brinBlock), 0);
+    for (int32_t j = 0; j < brinBlock->numOfRecords; ++j, ++b) {
+      SBrinRecord record;
+      ASSERT_EQ(tBrinBlockGet(brinBlock, j, &record), 0);
+      EXPECT_EQ(record.firstKey.key.ts, kStartTs + b * kBlockRows);
+
+      ASSERT_EQ(tsdbDataFileReadBlockZoneMap(reader, brinBlk->dp->offset, j, zoneMap), 0);
+
+      // every column with SMA on has an entry, c5 with SMA off has none
+      ASSERT_EQ(TARRAY2_SIZE(zoneMap), 4);
+      EXPECT_EQ(findColumnAgg(zoneMap, 6), nullptr);
+
+      const SColumnDataAgg *c1 = findColumnAgg(zoneMap, 2);
+      ASSERT_NE(c1, nullptr);
+      EXPECT_EQ(c1->min, b * 1000 - 50);
+      EXPECT_EQ(c1->max, b * 1000 + 49);
+      EXPECT_EQ(c1->numOfNull, 0);
+
+      const SColumnDataAgg *c2 = findColumnAgg(zoneMap, 3);
+      ASSERT_NE(c2, nullptr);
+      EXPECT_EQ(bitsDouble(c2->min), c2Value(b, 1));
+      EXPECT_EQ(bitsDouble(c2->max), c2Value(b, kBlockRows - 1));
+      EXPECT_EQ(c2->numOfNull, nullCount(c2IsNull));
+
+      // var-length columns only carry the null count
+      const SColumnDataAgg *c3 = findColumnAgg(zoneMap, 4);
+      ASSERT_NE(c3, nullptr);
+      EXPECT_EQ(c3->numOfNull, nullCount(c3IsNull));
+
+      // an all null column is kept with every row null, unlike the .sma file which drops it
+      const SColumnDataAgg *c4 = findColumnAgg(zoneMap, 5);
+      ASSERT_NE(c4, nullptr);
+      EXPECT_EQ(c4->numOfNull, kBlockRows);
+
+      ASSERT_EQ(tsdbDataFileReadBlockSma(reader, &record, smaArray), 0);
+      checkBlockSma(b, smaArray);
+    }
+  }
+  EXPECT_EQ(b, kBlocks);
+
+  // a record past the end of its zone map block is unknown
+  ASSERT_EQ(tsdbDataFileReadBlockZoneMap(reader, TARRAY2_GET_PTR(brinBlkArray, 0)->dp->offset, kBlocks, zoneMap), 0);
+  EXPECT_EQ(TARRAY2_SIZE(zoneMap), 0);
+
+  TARRAY2_DESTROY(zoneMap, NULL);
+  TARRAY2_DESTROY(smaArray, NULL);
+  tBrinBlockDestroy(brinBlock);
+  tsdbDataFileReaderClose(&reader);
+}
+
+TEST_F(tsdbZoneMapTest, legacyHeadFileFallsBackToSma) {
+  writeFiles(true);
+
+  SDataFileReader *reader = NULL;
+  openReader(&reader);
+  ASSERT_NE(reader, nullptr);
+
+  const TBrinBlkArray *brinBlkArray = NULL;
+  ASSERT_EQ(tsdbDataFileReadBrinBlk(reader, &brinBlkArray), 0);
+  ASSERT_EQ(TARRAY2_SIZE(brinBlkArray), 2);
+
+  const TZoneMapBlkArray *zoneMapBlkArray = NULL;
+  ASSERT_EQ(tsdbDataFileReadZoneMapBlk(reader, &zoneMapBlkArray), 0);
+  EXPECT_EQ(TARRAY2_SIZE(zoneMapBlkArray), 0);
+
+  SBrinBlock          brinBlock[1];
+  TColumnDataAggArray zoneMap[1] = {};
+  TColumnDataAggArray smaArray[1] = {};
+  int32_t             b = 0;
+  ASSERT_EQ(tBrinBlockInit(brinBlock), 0);
+  for (int32_t i = 0; i < TARRAY2_SIZE(brinBlkArray); ++i) {
+    const SBrinBlk *brinBlk = TARRAY2_GET_PTR(brinBlkArray, i);
+
+    ASSERT_EQ(tsdbDataFileReadBrinBlock(reader, brinBlk, brinBlock), 0);
+    for (int32_t j = 0; j < brinBlock->numOfRecords; ++j, ++b) {
+      SBrinRecord record;
+      ASSERT_EQ(tBrinBlockGet(brinBlock, j, &record), 0);
+      EXPECT_EQ(record.firstKey.key.ts, kStartTs + b * kBlockRows);
+      EXPECT_EQ(record.lastKey.key.ts, kStartTs + b * kBlockRows + kBlockRows - 1);
+      EXPECT_EQ(record.numRow, kBlockRows);
+
+      // no zone map means every column is unknown, the reader then loads the block SMA instead
+      ASSERT_EQ(tsdbDataFileReadBlockZoneMap(reader, brinBlk->dp->offset, j, zoneMap), 0);
+      EXPECT_EQ(TARRAY2_SIZE(zoneMap), 0);
+
+      ASSERT_EQ(tsdbDataFileReadBlockSma(reader, &record, smaArray), 0);
+      checkBlockSma(b, smaArray);
+    }
+  }
+  EXPECT_EQ(b, kBlocks);
+
+  TARRAY2_DESTROY(zoneMap, NULL);
+  TARRAY2_DESTROY(smaArray, NULL);
+  tBrinBlockDestroy(brinBlock);
+  tsdbDataFileReaderClose(&reader);
+}
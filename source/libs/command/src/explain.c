@@ -347,6 +347,19 @@ static char* qExplainGetScanMode(STableScanPhysiNode* pScan) {
   return "ts_order";
 }
 
+static char* qExplainGetSortMethod(int32_t sortMethod) {
+  switch (sortMethod) {
+    case SORT_QSORT_T:
+      return "quicksort";
+    case SORT_RADIX_T:
+      return "radix sort";
+    default:
+      break;
+  }
+
+  return "merge sort";
+}
+
 static char* qExplainGetScanDataLoad(STableScanPhysiNode* pScan) {
   switch (pScan->dataRequired) {
     case FUNC_DATA_REQUIRED_DATA_LOAD:
@@ -971,7 +984,7 @@ static int32_t qExplainResNodeToRowsImpl(SExplainResNode *pResNode, SExplainCtx
         int32_t           nodeNum = taosArrayGetSize(pResNode->pExecInfo);
         SExplainExecInfo *execInfo = taosArrayGet(pResNode->pExecInfo, 0);
         SSortExecInfo    *pExecInfo = (SSortExecInfo *)execInfo->verboseInfo;
-        EXPLAIN_ROW_APPEND("%s", pExecInfo->sortMethod == SORT_QSORT_T ? "quicksort" : "merge sort");
+        EXPLAIN_ROW_APPEND("%s", qExplainGetSortMethod(pExecInfo->sortMethod));
         if (pExecInfo->sortBuffer > 1024 * 1024) {
           EXPLAIN_ROW_APPEND("  Buffers:%.2f Mb", pExecInfo->sortBuffer / (1024 * 1024.0));
         } else if (pExecInfo->sortBuffer > 1024) {
@@ -1345,7 +1358,7 @@ static int32_t qExplainResNodeToRowsImpl(SExplainResNode *pResNode, SExplainCtx
           int32_t           nodeNum = taosArrayGetSize(pResNode->pExecInfo);
           SExplainExecInfo *execInfo = taosArrayGet(pResNode->pExecInfo, 0);
           SSortExecInfo    *pExecInfo = (SSortExecInfo *)execInfo->verboseInfo;
-          EXPLAIN_ROW_APPEND("%s", pExecInfo->sortMethod == SORT_QSORT_T ? "quicksort" : "merge sort");
+          EXPLAIN_ROW_APPEND("%s", qExplainGetSortMethod(pExecInfo->sortMethod));
           if (pExecInfo->sortBuffer > 1024 * 1024) {
             EXPLAIN_ROW_APPEND("  Buffers:%.2f Mb", pExecInfo->sortBuffer / (1024 * 1024.0));
           } else if (pExecInfo->sortBuffer > 1024) {
@@ -1567,7 +1580,7 @@ static int32_t qExplainResNodeToRowsImpl(SExplainResNode *pResNode, SExplainCtx
         int32_t           nodeNum = taosArrayGetSize(pResNode->pExecInfo);
         SExplainExecInfo *execInfo = taosArrayGet(pResNode->pExecInfo, 0);
         SSortExecInfo    *pExecInfo = (SSortExecInfo *)execInfo->verboseInfo;
-        EXPLAIN_ROW_APPEND("%s", pExecInfo->sortMethod == SORT_QSORT_T ? "quicksort" : "merge sort");
+        EXPLAIN_ROW_APPEND("%s", qExplainGetSortMethod(pExecInfo->sortMethod));
         if (pExecInfo->sortBuffer > 1024 * 1024) {
           EXPLAIN_ROW_APPEND("  Buffers:%.2f Mb", pExecInfo->sortBuffer / (1024 * 1024.0));
         } else if (pExecInfo->sortBuffer > 1024) {
@@ -237,4 +237,7 @@ int32_t extractKeysLen(const SArray* keys, int32_t* pLen);
 int32_t getDbVgInfoForExec(void* clientRpc, const char* dbFName, const char* tbName, SVgroupInfo* pVgInfo);
 void    rmDbVgInfoFromCache(const char* dbFName);
 
+// the memory pool session of the running query is close to its quota, operators able to spill should do it now
+bool isQueryMemNearQuota(void);
+
 #endif  // TDENGINE_EXECUTIL_H
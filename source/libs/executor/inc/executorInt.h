@@ -276,8 +276,10 @@ typedef struct STableScanBase {
   int32_t                dataBlockLoadFlag;
   SLimitInfo             limitInfo;
   // there are more than one table list exists in one task, if only one vnode exists.
-  STableListInfo* pTableListInfo;
-  TsdReader       readerAPI;
+  STableListInfo*     pTableListInfo;
+  TsdReader           readerAPI;
+  SArray*             pFilterColIds;  // SArray<int16_t>, data columns of the filter, loaded before the other columns
+  STableScanRtFilter* pRtFilter;      // join key filter pushed by the hash join above
 } STableScanBase;
 
 typedef struct STableScanInfo {
@@ -791,6 +793,7 @@ int32_t     getBufferPgSize(int32_t rowSize, uint32_t* defaultPgsz, int64_t* def
 extern void doDestroyExchangeOperatorInfo(void* param);
 
 int32_t doFilter(SSDataBlock* pBlock, SFilterInfo* pFilterInfo, SColMatchInfo* pColMatchInfo);
+int32_t applyFilterResult(SSDataBlock* pBlock, const SColumnInfoData* p, int32_t status, SColMatchInfo* pColMatchInfo);
 int32_t addTagPseudoColumnData(SReadHandle* pHandle, const SExprInfo* pExpr, int32_t numOfExpr, SSDataBlock* pBlock,
                                int32_t rows, SExecTaskInfo* pTask, STableMetaCacheInfo* pCache);
 
@@ -909,6 +912,8 @@ void    destroyOperatorParamValue(void* pValues);
 int32_t mergeOperatorParams(SOperatorParam* pDst, SOperatorParam* pSrc);
 int32_t buildTableScanOperatorParam(SOperatorParam** ppRes, SArray* pUidList, int32_t srcOpType, bool tableSeq);
 int32_t buildTableScanOperatorParamEx(SOperatorParam** ppRes, SArray* pUidList, int32_t srcOpType, SOrgTbInfo *pMap, bool tableSeq, STimeWindow *window);
+int32_t buildTableScanRtFilterParam(SOperatorParam** ppRes, STableScanRtFilter* pFilter);
+void    destroyTableScanRtFilter(STableScanRtFilter* pFilter);
 void    freeExchangeGetBasicOperatorParam(void* pParam);
 void    freeOperatorParam(SOperatorParam* pParam, SOperatorParamType type);
 void    freeResetOperatorParams(struct SOperatorInfo* pOperator, SOperatorParamType type, bool allFree);
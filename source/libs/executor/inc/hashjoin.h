@@ -27,6 +27,14 @@ extern "C" {
 #define HJOIN_BLK_SIZE_LIMIT 10485760
 #define HJOIN_ROW_BITMAP_SIZE (2 * 1048576)
 #define HJOIN_BLK_THRESHOLD_RATIO 0.9
+#define HJOIN_PROBE_BATCH_SIZE 1024
+#define HJOIN_SPILL_PART_BITS 4
+#define HJOIN_SPILL_PART_NUM (1 << HJOIN_SPILL_PART_BITS)
+#define HJOIN_SPILL_BLK_ROWS 4096
+#define HJOIN_SPILL_BUILD 0
+#define HJOIN_SPILL_PROBE 1
+#define HJOIN_RT_FILTER_MAX_KEYS 1048576
+#define HJOIN_RT_FILTER_FPP 0.01
 
 typedef int32_t (*hJoinImplFp)(SOperatorInfo*);
 
@@ -56,6 +64,9 @@ typedef struct SHJoinCtx {
   int32_t      probeEndIdx;
   int32_t      probePostIdx;
   bool         readMatch;
+  int32_t      probeBatchEnd;  // last row of the probe batch looked up
+  int32_t      matchNum;       // matched rows of the probe batch
+  int32_t      matchIdx;       // the matched row being output
 } SHJoinCtx;
 
 typedef struct SHJoinColInfo {
@@ -63,6 +74,7 @@ typedef struct SHJoinColInfo {
   int32_t          dstSlot;
   bool             keyCol;
   bool             vardata;
+  int8_t           type;
   int32_t*         offset;
   int32_t          bytes;
   char*            data;
@@ -128,8 +140,32 @@ typedef struct SHJoinExecInfo {
   int64_t probeBlkRows;
   int64_t resRows;
   int64_t expectRows;
+  int64_t spillBuildRows;
+  int64_t spillProbeRows;
 } SHJoinExecInfo;
 
+typedef struct SHJoinSpillPart {
+  bool         inMem;      // the build rows are in the key hash while probing
+  int64_t      bytes;      // spilled bytes of the build rows
+  SSDataBlock* pBlk[2];    // rows of the build/probe side not written to the spill buffer yet
+  SArray*      pPages[2];  // SArray<int32_t>, spill buffer pages of the build/probe side
+} SHJoinSpillPart;
+
+/*
+ * Grace hash join. Once the build rows reach the limit, the build and probe rows are partitioned by the top
+ * HJOIN_SPILL_PART_BITS bits of the hash of the join key. The partitions fitting in memory are joined while probing
+ * as before, the probe rows of the others are spilled, and each spilled partition is joined after the probe side ends.
+ */
+typedef struct SHJoinSpillCtx {
+  bool            enabled;    // the build rows are partitioned
+  bool            probeDone;  // the probe downstream is exhausted, the spilled partitions are being joined
+  int32_t         partIdx;    // the spilled partition being joined
+  int32_t         pageIdx;    // the next probe page of partIdx
+  SDiskbasedBuf*  pBuf[2];    // spilled build/probe rows, created on the first spill of each side
+  SSDataBlock*    pBlk[2];    // a build/probe page loaded back
+  SHJoinSpillPart parts[HJOIN_SPILL_PART_NUM];
+} SHJoinSpillCtx;
+
 
 typedef struct SHJoinOperatorInfo {
   EJoinType        joinType;
@@ -151,6 +187,11 @@ typedef struct SHJoinOperatorInfo {
   SHJoinExecInfo   execInfo;
   int32_t          blkThreshold;
   hJoinImplFp      joinFp;  
+  int32_t*         pMatchRows;    // probe row of each match in the probe batch
+  SGroupData**     pMatchGroups;  // build group of each match in the probe batch
+  SHJoinSpillCtx   spill;
+  SOperatorParam*  pRtFilterParam;  // join key filter to push to the probe table scan with its first fetch
+  bool             rtFilterPushed;
 } SHJoinOperatorInfo;
 
 
@@ -181,6 +222,12 @@ int32_t hJoinCopyMergeMidBlk(SHJoinCtx* pCtx, SSDataBlock** ppMid, SSDataBlock**
 int32_t hJoinHandleMidRemains(SHJoinOperatorInfo* pJoin, SHJoinCtx* pCtx);
 bool hJoinBlkReachThreshold(SHJoinOperatorInfo* pInfo, int64_t blkRows);
 int32_t hJoinCopyNMatchRowsToBlock(SHJoinOperatorInfo* pJoin, SSDataBlock* pRes, int32_t startIdx, int32_t rows);
+int32_t hJoinSpillRow(SHJoinOperatorInfo* pJoin, int32_t side, int32_t part, SSDataBlock* pSrc, int32_t rowIdx);
+int32_t hJoinBuildRtFilter(struct SOperatorInfo* pOperator);
+
+static FORCE_INLINE int32_t hJoinGetKeyPart(const char* pKey, size_t keyLen) {
+  return MurmurHash3_32(pKey, keyLen) >> (32 - HJOIN_SPILL_PART_BITS);
+}
 
 
 #ifdef __cplusplus
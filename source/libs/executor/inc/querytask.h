@@ -21,6 +21,7 @@ extern "C" {
   #endif
   
   #include "executorInt.h"
+  #include "tarena.h"
 
 #define GET_TASKID(_t) (((SExecTaskInfo*)(_t))->id.str)
 
@@ -105,6 +106,7 @@ struct SExecTaskInfo {
   bool                  paramSet;
   SQueryAutoQWorkerPoolCB* pWorkerCb;
   SStreamRuntimeInfo*      pStreamRuntimeInfo;
+  SArena*                  pArena;  // scratch memory of one batch, reset each time the task is executed
 };
 
 void    buildTaskId(uint64_t taskId, uint64_t queryId, char* dst);
@@ -234,6 +234,12 @@ void tsortSetMergeLimitReachedFp(SSortHandle* pHandle, void (*mergeLimitReached)
 
 int32_t tsortComparBlockCell(SSDataBlock* pLeftBlock, SSDataBlock* pRightBlock, int32_t leftRowIndex,
                              int32_t rightRowIndex, void* pOrder);
+
+/**
+ * @brief stop the workers of the parallel in-memory sort, they are started again by the next parallel sort
+ */
+void tsortCleanupWorkerPool(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -876,6 +876,7 @@ int32_t buildTableScanOperatorParam(SOperatorParam** ppRes, SArray* pUidList, in
   pScan->pOrgTbInfo = NULL;
   pScan->window.skey = INT64_MAX;
   pScan->window.ekey = INT64_MIN;
+  pScan->pRtFilter = NULL;
 
   (*ppRes)->opType = srcOpType;
   (*ppRes)->downstreamIdx = 0;
@@ -886,6 +887,32 @@ int32_t buildTableScanOperatorParam(SOperatorParam** ppRes, SArray* pUidList, in
   return TSDB_CODE_SUCCESS;
 }
 
+// the param takes over pFilter, and keeps the table list of the scan
+int32_t buildTableScanRtFilterParam(SOperatorParam** ppRes, STableScanRtFilter* pFilter) {
+  *ppRes = taosMemoryMalloc(sizeof(SOperatorParam));
+  if (NULL == *ppRes) {
+    return terrno;
+  }
+
+  STableScanOperatorParam* pScan = taosMemoryCalloc(1, sizeof(STableScanOperatorParam));
+  if (NULL == pScan) {
+    taosMemoryFreeClear(*ppRes);
+    return terrno;
+  }
+
+  pScan->window.skey = INT64_MAX;
+  pScan->window.ekey = INT64_MIN;
+  pScan->pRtFilter = pFilter;
+
+  (*ppRes)->opType = QUERY_NODE_PHYSICAL_PLAN_TABLE_SCAN;
+  (*ppRes)->downstreamIdx = 0;
+  (*ppRes)->value = pScan;
+  (*ppRes)->pChildren = NULL;
+  (*ppRes)->reUse = false;
+
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t buildTableScanOperatorParamEx(SOperatorParam** ppRes, SArray* pUidList, int32_t srcOpType, SOrgTbInfo *pMap, bool tableSeq, STimeWindow *window) {
   int32_t                  code = TSDB_CODE_SUCCESS;
   int32_t                  lino = 0;
@@ -912,6 +939,7 @@ int32_t buildTableScanOperatorParamEx(SOperatorParam** ppRes, SArray* pUidList,
   pScan->tableSeq = tableSeq;
   pScan->window.skey = window->skey;
   pScan->window.ekey = window->ekey;
+  pScan->pRtFilter = NULL;
 
   (*ppRes)->opType = srcOpType;
   (*ppRes)->downstreamIdx = 0;
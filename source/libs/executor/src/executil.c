@@ -21,6 +21,7 @@
 #include "querynodes.h"
 #include "tarray.h"
 #include "tdatablock.h"
+#include "tglobal.h"
 #include "thash.h"
 #include "tmsg.h"
 #include "ttime.h"
@@ -3491,3 +3492,18 @@ _end:
   }
   return code;
 }
+
+bool isQueryMemNearQuota(void) {
+#if !defined(BUILD_TEST) && !defined(TD_ASTRA)
+  int64_t allocSize = 0;
+  if (tsSingleQueryMaxMemorySize <= 0 || threadPoolSession == NULL ||
+      taosMemPoolGetSessionStat(threadPoolSession, NULL, &allocSize, NULL) != TSDB_CODE_SUCCESS) {
+    return false;
+  }
+
+  // leave the last quarter of the quota to the data kept in memory and the other operators
+  return allocSize >= (int64_t)tsSingleQueryMaxMemorySize * 1048576L / 4 * 3;
+#else
+  return false;
+#endif
+}
@@ -716,6 +716,10 @@ int32_t qExecTaskOpt(qTaskInfo_t tinfo, SArray* pResList, uint64_t* useconds, bo
     return pTaskInfo->code;
   }
 
+  // scratch memory of the last batch is not referenced any more
+  taosArenaReset(pTaskInfo->pArena);
+  SArena* pPrevArena = taosArenaSetThreadArena(pTaskInfo->pArena);
+
   // error occurs, record the error code and return to client
   int32_t ret = setjmp(pTaskInfo->env);
   if (ret != TSDB_CODE_SUCCESS) {
@@ -723,6 +727,7 @@ int32_t qExecTaskOpt(qTaskInfo_t tinfo, SArray* pResList, uint64_t* useconds, bo
     (void)cleanUpUdfs();
 
     qDebug("%s task abort due to error/cancel occurs, code:%s", GET_TASKID(pTaskInfo), tstrerror(pTaskInfo->code));
+    (void)taosArenaSetThreadArena(pPrevArena);
     atomic_store_64(&pTaskInfo->owner, 0);
 
     return pTaskInfo->code;
@@ -786,6 +791,8 @@ int32_t qExecTaskOpt(qTaskInfo_t tinfo, SArray* pResList, uint64_t* useconds, bo
       break;
     }
 
+    // scratch memory is given back before getNextFn returns, nothing in the arena survives a batch
+    taosArenaReset(pTaskInfo->pArena);
     code = pTaskInfo->pRoot->fpSet.getNextFn(pTaskInfo->pRoot, &pRes);
     QUERY_CHECK_CODE(code, lino, _end);
     code = blockDataCheck(pRes);
@@ -811,6 +818,7 @@ _end:
   qDebug("%s task suspended, %d rows in %d blocks returned, total:%" PRId64 " rows, in sinkNode:%d, elapsed:%.2f ms",
          GET_TASKID(pTaskInfo), current, (int32_t)taosArrayGetSize(pResList), total, 0, el / 1000.0);
 
+  (void)taosArenaSetThreadArena(pPrevArena);
   atomic_store_64(&pTaskInfo->owner, 0);
   if (code) {
     pTaskInfo->code = code;
@@ -820,6 +828,8 @@ _end:
   return pTaskInfo->code;
 }
 
+void qCleanupSharedRes(void) { tsortCleanupWorkerPool(); }
+
 void qCleanExecTaskBlockBuf(qTaskInfo_t tinfo) {
   SExecTaskInfo* pTaskInfo = (SExecTaskInfo*)tinfo;
   SArray*        pList = pTaskInfo->pResultBlockList;
@@ -866,12 +876,17 @@ int32_t qExecTask(qTaskInfo_t tinfo, SSDataBlock** pRes, uint64_t* useconds) {
     pTaskInfo->cost.start = taosGetTimestampUs();
   }
 
+  // scratch memory of the last batch is not referenced any more
+  taosArenaReset(pTaskInfo->pArena);
+  SArena* pPrevArena = taosArenaSetThreadArena(pTaskInfo->pArena);
+
   // error occurs, record the error code and return to client
   int32_t ret = setjmp(pTaskInfo->env);
   if (ret != TSDB_CODE_SUCCESS) {
     pTaskInfo->code = ret;
     (void)cleanUpUdfs();
     qDebug("%s task abort due to error/cancel occurs, code:%s", GET_TASKID(pTaskInfo), tstrerror(pTaskInfo->code));
+    (void)taosArenaSetThreadArena(pPrevArena);
     atomic_store_64(&pTaskInfo->owner, 0);
     return pTaskInfo->code;
   }
@@ -912,6 +927,7 @@ int32_t qExecTask(qTaskInfo_t tinfo, SSDataBlock** pRes, uint64_t* useconds) {
   qDebug("%s task suspended, %d rows returned, total:%" PRId64 " rows, in sinkNode:%d, elapsed:%.2f ms",
          GET_TASKID(pTaskInfo), current, total, 0, el / 1000.0);
 
+  (void)taosArenaSetThreadArena(pPrevArena);
   atomic_store_64(&pTaskInfo->owner, 0);
   return pTaskInfo->code;
 }
@@ -1644,12 +1660,17 @@ int32_t streamExecuteTask(qTaskInfo_t tInfo, SSDataBlock** ppRes, uint64_t* usec
     pTaskInfo->cost.start = taosGetTimestampUs();
   }
 
+  // scratch memory of the last batch is not referenced any more
+  taosArenaReset(pTaskInfo->pArena);
+  SArena* pPrevArena = taosArenaSetThreadArena(pTaskInfo->pArena);
+
   // error occurs, record the error code and return to client
   int32_t ret = setjmp(pTaskInfo->env);
   if (ret != TSDB_CODE_SUCCESS) {
     pTaskInfo->code = ret;
     (void)cleanUpUdfs();
     qDebug("%s task abort due to error/cancel occurs, code:%s", GET_TASKID(pTaskInfo), tstrerror(pTaskInfo->code));
+    (void)taosArenaSetThreadArena(pPrevArena);
     atomic_store_64(&pTaskInfo->owner, 0);
     return pTaskInfo->code;
   }
@@ -1686,6 +1707,7 @@ int32_t streamExecuteTask(qTaskInfo_t tInfo, SSDataBlock** ppRes, uint64_t* usec
   qDebug("%s task suspended, %d rows returned, total:%" PRId64 " rows, in sinkNode:%d, elapsed:%.2f ms",
          GET_TASKID(pTaskInfo), current, total, 0, el / 1000.0);
 
+  (void)taosArenaSetThreadArena(pPrevArena);
   atomic_store_64(&pTaskInfo->owner, 0);
   return pTaskInfo->code;
 }
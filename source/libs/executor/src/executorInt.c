@@ -21,6 +21,7 @@
 #include "tfill.h"
 #include "tname.h"
 
+#include "tbloomfilter.h"
 #include "tdatablock.h"
 #include "tmsg.h"
 #include "ttime.h"
@@ -310,15 +311,18 @@ static int32_t doCreateConstantValColumnInfo(SInputColumnInfoData* pInput, SFunc
       colDataSetDouble(pColInfo, i, &v);
     }
   } else if (type == TSDB_DATA_TYPE_VARCHAR || type == TSDB_DATA_TYPE_GEOMETRY) {
-    char* tmp = taosMemoryMalloc(pFuncParam->param.nLen + VARSTR_HEADER_SIZE);
+    char* tmp = taosArenaScratchMalloc(pFuncParam->param.nLen + VARSTR_HEADER_SIZE);
     QUERY_CHECK_NULL(tmp, code, lino, _end, terrno);
 
     STR_WITH_SIZE_TO_VARSTR(tmp, pFuncParam->param.pz, pFuncParam->param.nLen);
     for (int32_t i = 0; i < numOfRows; ++i) {
       code = colDataSetVal(pColInfo, i, tmp, false);
-      QUERY_CHECK_CODE(code, lino, _end);
+      if (code != TSDB_CODE_SUCCESS) {
+        break;
+      }
     }
-    taosMemoryFree(tmp);
+    taosArenaScratchFree(tmp);
+    QUERY_CHECK_CODE(code, lino, _end);
   }
 
 _end:
@@ -595,6 +599,22 @@ int32_t doFilter(SSDataBlock* pBlock, SFilterInfo* pFilterInfo, SColMatchInfo* p
       filterExecute(pFilterInfo, pBlock, &p, NULL, param1.numOfCols, &status);
   QUERY_CHECK_CODE(code, lino, _err);
 
+  code = applyFilterResult(pBlock, p, status, pColMatchInfo);
+  QUERY_CHECK_CODE(code, lino, _err);
+
+_err:
+  if (code != TSDB_CODE_SUCCESS) {
+    qError("%s failed at line %d since %s", __func__, lino, tstrerror(code));
+  }
+  colDataDestroy(p);
+  taosMemoryFree(p);
+  return code;
+}
+
+int32_t applyFilterResult(SSDataBlock* pBlock, const SColumnInfoData* p, int32_t status, SColMatchInfo* pColMatchInfo) {
+  int32_t code = TSDB_CODE_SUCCESS;
+  int32_t lino = 0;
+
   code = extractQualifiedTupleByFilterResult(pBlock, p, status);
   QUERY_CHECK_CODE(code, lino, _err);
 
@@ -620,8 +640,6 @@ _err:
   if (code != TSDB_CODE_SUCCESS) {
     qError("%s failed at line %d since %s", __func__, lino, tstrerror(code));
   }
-  colDataDestroy(p);
-  taosMemoryFree(p);
   return code;
 }
 
@@ -1244,6 +1262,15 @@ void freeMergeJoinNotifyOperatorParam(SOperatorParam* pParam) { freeOperatorPara
 
 void freeTagScanGetOperatorParam(SOperatorParam* pParam) { freeOperatorParamImpl(pParam, OP_GET_PARAM); }
 
+void destroyTableScanRtFilter(STableScanRtFilter* pFilter) {
+  if (pFilter == NULL) {
+    return;
+  }
+
+  tBlockBloomFilterDestroy(pFilter->pBloom);
+  taosMemoryFree(pFilter);
+}
+
 void freeTableScanGetOperatorParam(SOperatorParam* pParam) {
   STableScanOperatorParam* pTableScanParam = (STableScanOperatorParam*)pParam->value;
   taosArrayDestroy(pTableScanParam->pUidList);
@@ -1251,6 +1278,7 @@ void freeTableScanGetOperatorParam(SOperatorParam* pParam) {
     taosArrayDestroy(pTableScanParam->pOrgTbInfo->colMap);
     taosMemoryFreeClear(pTableScanParam->pOrgTbInfo);
   }
+  destroyTableScanRtFilter(pTableScanParam->pRtFilter);
   freeOperatorParamImpl(pParam, OP_GET_PARAM);
 }
 
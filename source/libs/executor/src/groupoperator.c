@@ -27,20 +27,56 @@
 #include "operator.h"
 #include "querytask.h"
 #include "tcompare.h"
+#include "tglobal.h"
 #include "thash.h"
+#include "tsort.h"
 #include "ttypes.h"
 
+#define GROUP_SPILL_RADIX_BITS 4
+#define GROUP_SPILL_PARTITIONS (1 << GROUP_SPILL_RADIX_BITS)
+#define GROUP_SPILL_MAX_LEVEL  (64 / GROUP_SPILL_RADIX_BITS)
+#define GROUP_SPILL_BLOCK_ROWS 4096  // rows of a partition gathered before they are written to the spill buffer
+
+typedef struct SGroupSpillPage {
+  int32_t  pageId;
+  uint64_t groupId;  // group id of the input block the rows come from
+} SGroupSpillPage;
+
+typedef struct SGroupSpillPart {
+  int32_t level;   // radix level to split the partition at if it spills again
+  SArray* pPages;  // SArray<SGroupSpillPage>
+} SGroupSpillPart;
+
+/*
+ * Radix partitioned spill of the hash group by. Once the groups in memory reach the limit, the rows of the groups not
+ * in memory yet are written to disk, partitioned by GROUP_SPILL_RADIX_BITS bits of the hash of their group key. The
+ * groups in memory are returned first, then each spilled partition is aggregated in turn, and spills one level deeper
+ * if it does not fit either. All rows of a group are aggregated in the same pass, so no partial state is merged.
+ */
+typedef struct SGroupSpillInfo {
+  bool           full;   // no new group is kept in memory in the current pass
+  int32_t        level;  // radix level of the current pass
+  SDiskbasedBuf* pBuf;   // spilled rows, created on the first spill
+  SSDataBlock*   pPartBlock[GROUP_SPILL_PARTITIONS];  // rows of each partition not written to pBuf yet
+  SArray*        pPartPages[GROUP_SPILL_PARTITIONS];  // SArray<SGroupSpillPage>, pages of each partition in this pass
+  SArray*        pParts;       // SArray<SGroupSpillPart>, spilled partitions waiting to be aggregated
+  SArray*        pPassPages;   // SArray<SGroupSpillPage>, pages of the partition aggregated in the current pass
+  SSDataBlock*   pBlock;       // a spilled page loaded back
+  int64_t        numOfRows;    // total spilled rows
+} SGroupSpillInfo;
+
 typedef struct SGroupbyOperatorInfo {
-  SOptrBasicInfo binfo;
-  SAggSupporter  aggSup;
-  SArray*        pGroupCols;     // group by columns, SArray<SColumn>
-  SArray*        pGroupColVals;  // current group column values, SArray<SGroupKeys>
-  bool           isInit;         // denote if current val is initialized or not
-  char*          keyBuf;         // group by keys for hash
-  int32_t        groupKeyLen;    // total group by column width
-  SGroupResInfo  groupResInfo;
-  SExprSupp      scalarSup;
-  SOperatorInfo* pOperator;
+  SOptrBasicInfo  binfo;
+  SAggSupporter   aggSup;
+  SArray*         pGroupCols;     // group by columns, SArray<SColumn>
+  SArray*         pGroupColVals;  // current group column values, SArray<SGroupKeys>
+  bool            isInit;         // denote if current val is initialized or not
+  char*           keyBuf;         // group by keys for hash
+  int32_t         groupKeyLen;    // total group by column width
+  SGroupResInfo   groupResInfo;
+  SExprSupp       scalarSup;
+  SOperatorInfo*  pOperator;
+  SGroupSpillInfo spill;
 } SGroupbyOperatorInfo;
 
 // The sort in partition may be needed later.
@@ -76,12 +112,31 @@ static void freeGroupKey(void* param) {
   taosMemoryFree(pKey->pData);
 }
 
+static void destroyGroupSpillInfo(SGroupSpillInfo* pSpill) {
+  for (int32_t i = 0; i < GROUP_SPILL_PARTITIONS; ++i) {
+    blockDataDestroy(pSpill->pPartBlock[i]);
+    taosArrayDestroy(pSpill->pPartPages[i]);
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(pSpill->pParts); ++i) {
+    SGroupSpillPart* pPart = taosArrayGet(pSpill->pParts, i);
+    taosArrayDestroy(pPart->pPages);
+  }
+
+  taosArrayDestroy(pSpill->pParts);
+  taosArrayDestroy(pSpill->pPassPages);
+  blockDataDestroy(pSpill->pBlock);
+  destroyDiskbasedBuf(pSpill->pBuf);
+  (void)memset(pSpill, 0, sizeof(SGroupSpillInfo));
+}
+
 static void destroyGroupOperatorInfo(void* param) {
   if (param == NULL) {
     return;
   }
   SGroupbyOperatorInfo* pInfo = (SGroupbyOperatorInfo*)param;
 
+  destroyGroupSpillInfo(&pInfo->spill);
   cleanupBasicInfo(&pInfo->binfo);
   taosMemoryFreeClear(pInfo->keyBuf);
   taosArrayDestroy(pInfo->pGroupCols);
@@ -308,18 +363,221 @@ static void doAssignGroupKeys(SqlFunctionCtx* pCtx, int32_t numOfOutput, int32_t
   }
 }
 
+// hashed the same way as doSetResultOutBufByKey, the hash both locates the group in memory and picks its partition
+static uint64_t groupSpillHashKey(SAggSupporter* pAggSup, char* pData, int32_t bytes, uint64_t groupId) {
+  SET_RES_WINDOW_KEY(pAggSup->keyBuf, pData, bytes, groupId);
+  uint64_t hash = calcGroupId(pAggSup->keyBuf, GET_RES_WINDOW_KEY_LEN(bytes));
+  *(uint64_t*)pAggSup->keyBuf = hash;
+  return hash;
+}
+
+static void groupSpillCheckMem(SOperatorInfo* pOperator) {
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SGroupSpillInfo*      pSpill = &pInfo->spill;
+  int64_t               limit = (int64_t)atomic_load_32(&tsQueryGroupByMemSizeMB) * 1048576L;
+
+  if (pSpill->full || limit <= 0 || pSpill->level >= GROUP_SPILL_MAX_LEVEL) {
+    return;
+  }
+
+  SSHashObj* pHashmap = pInfo->aggSup.pResultRowHashTable;
+  int32_t    numOfGroups = tSimpleHashGetSize(pHashmap);
+  int64_t    size = tSimpleHashGetMemSize(pHashmap) + getTotalBufSize(pInfo->aggSup.pResultBuf) +
+                 (int64_t)numOfGroups * (GET_RES_WINDOW_KEY_LEN(pInfo->groupKeyLen) + sizeof(SResultRowPosition));
+
+  if (size >= limit || isQueryMemNearQuota()) {
+    pSpill->full = true;
+    qDebug("%s group by holds %d groups in %" PRId64 " bytes, spill new groups at level %d",
+           GET_TASKID(pOperator->pTaskInfo), numOfGroups, size, pSpill->level);
+  }
+}
+
+static int32_t groupSpillFlushPart(SGroupSpillInfo* pSpill, int32_t part) {
+  int32_t      code = TSDB_CODE_SUCCESS;
+  int32_t      lino = 0;
+  SSDataBlock* pPartBlock = pSpill->pPartBlock[part];
+  SSDataBlock* p = NULL;
+
+  if (pSpill->pBuf == NULL) {
+    if (!osTempSpaceAvailable()) {
+      code = TSDB_CODE_NO_DISKSPACE;
+      qError("group by spill failed since %s, tempDir:%s", tstrerror(code), tsTempDir);
+      return code;
+    }
+
+    int32_t pageSize = getProperSortPageSize(blockDataGetRowSize(pPartBlock), taosArrayGetSize(pPartBlock->pDataBlock));
+    code = createDiskbasedBuf(&pSpill->pBuf, pageSize, (int64_t)pageSize * GROUP_SPILL_PARTITIONS, "groupSpillBuf",
+                              tsTempDir);
+    QUERY_CHECK_CODE(code, lino, _end);
+
+    code = createOneDataBlock(pPartBlock, false, &pSpill->pBlock);
+    QUERY_CHECK_CODE(code, lino, _end);
+  }
+
+  if (pSpill->pPartPages[part] == NULL) {
+    pSpill->pPartPages[part] = taosArrayInit(4, sizeof(SGroupSpillPage));
+    QUERY_CHECK_NULL(pSpill->pPartPages[part], code, lino, _end, terrno);
+  }
+
+  int32_t start = 0;
+  while (start < pPartBlock->info.rows) {
+    int32_t stop = 0;
+    code = blockDataSplitRows(pPartBlock, pPartBlock->info.hasVarCol, start, &stop, getBufPageSize(pSpill->pBuf));
+    QUERY_CHECK_CODE(code, lino, _end);
+
+    code = blockDataExtractBlock(pPartBlock, start, stop - start + 1, &p);
+    QUERY_CHECK_CODE(code, lino, _end);
+
+    SGroupSpillPage page = {.pageId = -1, .groupId = pPartBlock->info.id.groupId};
+    void*           pPage = getNewBufPage(pSpill->pBuf, &page.pageId);
+    QUERY_CHECK_NULL(pPage, code, lino, _end, terrno);
+
+    code = blockDataToBuf(pPage, p);
+    setBufPageDirty(pPage, true);
+    releaseBufPage(pSpill->pBuf, pPage);
+    QUERY_CHECK_CODE(code, lino, _end);
+
+    void* px = taosArrayPush(pSpill->pPartPages[part], &page);
+    QUERY_CHECK_NULL(px, code, lino, _end, terrno);
+
+    blockDataDestroy(p);
+    p = NULL;
+    start = stop + 1;
+  }
+
+  blockDataCleanup(pPartBlock);
+
+_end:
+  blockDataDestroy(p);
+  if (code != TSDB_CODE_SUCCESS) {
+    qError("%s failed at line %d since %s", __func__, lino, tstrerror(code));
+  }
+  return code;
+}
+
+static int32_t groupSpillRows(SGroupSpillInfo* pSpill, SSDataBlock* pBlock, uint64_t hash, int32_t rowIndex,
+                              int32_t num) {
+  int32_t code = TSDB_CODE_SUCCESS;
+  int32_t part = (hash >> (pSpill->level * GROUP_SPILL_RADIX_BITS)) & (GROUP_SPILL_PARTITIONS - 1);
+
+  if (pSpill->pPartBlock[part] == NULL) {
+    code = createOneDataBlock(pBlock, false, &pSpill->pPartBlock[part]);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  // a page keeps the group id of one input block only
+  SSDataBlock* pPartBlock = pSpill->pPartBlock[part];
+  if (pPartBlock->info.rows > 0 && pPartBlock->info.id.groupId != pBlock->info.id.groupId) {
+    code = groupSpillFlushPart(pSpill, part);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  pPartBlock->info.id.groupId = pBlock->info.id.groupId;
+  code = blockDataEnsureCapacity(pPartBlock, pPartBlock->info.rows + num);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  code = blockDataMergeNRows(pPartBlock, pBlock, rowIndex, num);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  pSpill->numOfRows += num;
+  if (pPartBlock->info.rows >= GROUP_SPILL_BLOCK_ROWS) {
+    code = groupSpillFlushPart(pSpill, part);
+  }
+  return code;
+}
+
+// write out the rows left of the current pass, and queue the partitions spilled in it
+static int32_t groupSpillEndPass(SOperatorInfo* pOperator) {
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SGroupSpillInfo*      pSpill = &pInfo->spill;
+  int32_t               code = TSDB_CODE_SUCCESS;
+  int32_t               lino = 0;
+  int32_t               numOfParts = 0;
+
+  for (int32_t i = 0; i < GROUP_SPILL_PARTITIONS; ++i) {
+    if (pSpill->pPartBlock[i] != NULL && pSpill->pPartBlock[i]->info.rows > 0) {
+      code = groupSpillFlushPart(pSpill, i);
+      QUERY_CHECK_CODE(code, lino, _end);
+    }
+
+    if (taosArrayGetSize(pSpill->pPartPages[i]) == 0) {
+      continue;
+    }
+
+    if (pSpill->pParts == NULL) {
+      pSpill->pParts = taosArrayInit(GROUP_SPILL_PARTITIONS, sizeof(SGroupSpillPart));
+      QUERY_CHECK_NULL(pSpill->pParts, code, lino, _end, terrno);
+    }
+
+    SGroupSpillPart part = {.level = pSpill->level + 1, .pPages = pSpill->pPartPages[i]};
+    void*           px = taosArrayPush(pSpill->pParts, &part);
+    QUERY_CHECK_NULL(px, code, lino, _end, terrno);
+
+    pSpill->pPartPages[i] = NULL;
+    numOfParts += 1;
+  }
+
+  if (numOfParts > 0) {
+    qDebug("%s group by spilled %d partitions at level %d, total spilled rows:%" PRId64, GET_TASKID(pOperator->pTaskInfo),
+           numOfParts, pSpill->level, pSpill->numOfRows);
+  }
+  pSpill->full = false;
+
+_end:
+  if (code != TSDB_CODE_SUCCESS) {
+    qError("%s failed at line %d since %s", __func__, lino, tstrerror(code));
+  }
+  return code;
+}
+
+// aggregate the rows [rowIndex, rowIndex + num) of the current group, or spill them if the group is not in memory
+static int32_t doAggGroupRows(SOperatorInfo* pOperator, SSDataBlock* pBlock, int32_t rowIndex, int32_t num) {
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SqlFunctionCtx*       pCtx = pOperator->exprSupp.pCtx;
+  int32_t               len = buildGroupKeys(pInfo->keyBuf, pInfo->pGroupColVals);
+
+  if (pInfo->spill.full) {
+    uint64_t hash = groupSpillHashKey(&pInfo->aggSup, pInfo->keyBuf, len, pBlock->info.id.groupId);
+    if (tSimpleHashGet(pInfo->aggSup.pResultRowHashTable, pInfo->aggSup.keyBuf, GET_RES_WINDOW_KEY_LEN(len)) == NULL) {
+      return groupSpillRows(&pInfo->spill, pBlock, hash, rowIndex, num);
+    }
+  }
+
+  int32_t code = setGroupResultOutputBuf(pOperator, &(pInfo->binfo), pOperator->exprSupp.numOfExprs, pInfo->keyBuf,
+                                         len, pBlock->info.id.groupId, pInfo->aggSup.pResultBuf, &pInfo->aggSup);
+  if (code != TSDB_CODE_SUCCESS) {  // null data, too many state code
+    return code;
+  }
+
+  code = applyAggFunctionOnPartialTuples(pOperator->pTaskInfo, pCtx, NULL, rowIndex, num, pBlock->info.rows,
+                                         pOperator->exprSupp.numOfExprs);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  // assign the group keys or user input constant values if required
+  doAssignGroupKeys(pCtx, pOperator->exprSupp.numOfExprs, pBlock->info.rows, rowIndex);
+  return TSDB_CODE_SUCCESS;
+}
+
 static void doHashGroupbyAgg(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
   SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
   SGroupbyOperatorInfo* pInfo = pOperator->info;
 
-  SqlFunctionCtx* pCtx = pOperator->exprSupp.pCtx;
-  int32_t         numOfGroupCols = taosArrayGetSize(pInfo->pGroupCols);
+  int32_t numOfGroupCols = taosArrayGetSize(pInfo->pGroupCols);
   //  if (type == TSDB_DATA_TYPE_FLOAT || type == TSDB_DATA_TYPE_DOUBLE) {
   //  qError("QInfo:0x%" PRIx64 ", group by not supported on double/float columns, abort", GET_TASKID(pRuntimeEnv));
   //    return;
   //  }
 
-  int32_t len = 0;
   terrno = TSDB_CODE_SUCCESS;
 
   int32_t num = 0;
@@ -351,41 +609,20 @@ static void doHashGroupbyAgg(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
       continue;
     }
 
-    len = buildGroupKeys(pInfo->keyBuf, pInfo->pGroupColVals);
-    int32_t ret = setGroupResultOutputBuf(pOperator, &(pInfo->binfo), pOperator->exprSupp.numOfExprs, pInfo->keyBuf,
-                                          len, pBlock->info.id.groupId, pInfo->aggSup.pResultBuf, &pInfo->aggSup);
-    if (ret != TSDB_CODE_SUCCESS) {  // null data, too many state code
-      T_LONG_JMP(pTaskInfo->env, ret);
-    }
-
-    int32_t rowIndex = j - num;
-    ret = applyAggFunctionOnPartialTuples(pTaskInfo, pCtx, NULL, rowIndex, num, pBlock->info.rows,
-                                          pOperator->exprSupp.numOfExprs);
+    int32_t ret = doAggGroupRows(pOperator, pBlock, j - num, num);
     if (ret != TSDB_CODE_SUCCESS) {
       T_LONG_JMP(pTaskInfo->env, ret);
     }
 
-    // assign the group keys or user input constant values if required
-    doAssignGroupKeys(pCtx, pOperator->exprSupp.numOfExprs, pBlock->info.rows, rowIndex);
     recordNewGroupKeys(pInfo->pGroupCols, pInfo->pGroupColVals, pBlock, j);
     num = 1;
   }
 
   if (num > 0) {
-    len = buildGroupKeys(pInfo->keyBuf, pInfo->pGroupColVals);
-    int32_t ret = setGroupResultOutputBuf(pOperator, &(pInfo->binfo), pOperator->exprSupp.numOfExprs, pInfo->keyBuf,
-                                          len, pBlock->info.id.groupId, pInfo->aggSup.pResultBuf, &pInfo->aggSup);
+    int32_t ret = doAggGroupRows(pOperator, pBlock, pBlock->info.rows - num, num);
     if (ret != TSDB_CODE_SUCCESS) {
       T_LONG_JMP(pTaskInfo->env, ret);
     }
-
-    int32_t rowIndex = pBlock->info.rows - num;
-    ret = applyAggFunctionOnPartialTuples(pTaskInfo, pCtx, NULL, rowIndex, num, pBlock->info.rows,
-                                          pOperator->exprSupp.numOfExprs);
-    if (ret != TSDB_CODE_SUCCESS) {
-      T_LONG_JMP(pTaskInfo->env, ret);
-    }
-    doAssignGroupKeys(pCtx, pOperator->exprSupp.numOfExprs, pBlock->info.rows, rowIndex);
   }
 }
 
@@ -430,6 +667,92 @@ void doBuildResultDatablockByHash(SOperatorInfo* pOperator, SOptrBasicInfo* pbIn
   }
 }
 
+static void initGroupResInfoByHash(SGroupResInfo* pGroupResInfo) {
+  if (pGroupResInfo->pRows != NULL) {
+    taosArrayDestroy(pGroupResInfo->pRows);
+    pGroupResInfo->pRows = NULL;
+  }
+
+  if (pGroupResInfo->pBuf) {
+    taosMemoryFree(pGroupResInfo->pBuf);
+    pGroupResInfo->pBuf = NULL;
+  }
+
+  pGroupResInfo->index = 0;
+  pGroupResInfo->iter = 0;
+  pGroupResInfo->dataPos = NULL;
+}
+
+// drop the groups returned, the buffers are kept for the next pass
+static int32_t groupSpillResetAggSup(SOperatorInfo* pOperator) {
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SAggSupporter*        pAggSup = &pInfo->aggSup;
+
+  tSimpleHashCleanup(pAggSup->pResultRowHashTable);
+  pAggSup->pResultRowHashTable = tSimpleHashInit(100, taosFastHash);
+  if (pAggSup->pResultRowHashTable == NULL) {
+    return terrno;
+  }
+
+  clearDiskbasedBuf(pAggSup->pResultBuf);
+  pAggSup->currentPageId = -1;
+  for (int32_t i = 0; i < pOperator->exprSupp.numOfExprs; ++i) {
+    pOperator->exprSupp.pCtx[i].saveHandle.currentPage = -1;
+  }
+
+  initResultRowInfo(&pInfo->binfo.resultRowInfo);
+  initGroupResInfoByHash(&pInfo->groupResInfo);
+  pInfo->isInit = false;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t groupSpillAggregatePart(SOperatorInfo* pOperator) {
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SGroupSpillInfo*      pSpill = &pInfo->spill;
+  SSDataBlock*          pBlock = pSpill->pBlock;
+  int32_t               code = TSDB_CODE_SUCCESS;
+  int32_t               lino = 0;
+
+  // the deepest partition first, so that the pages it spills reuse the ones just read
+  SGroupSpillPart* pPart = taosArrayPop(pSpill->pParts);
+  taosArrayDestroy(pSpill->pPassPages);
+  pSpill->pPassPages = pPart->pPages;
+  pSpill->level = pPart->level;
+
+  code = groupSpillResetAggSup(pOperator);
+  QUERY_CHECK_CODE(code, lino, _end);
+
+  for (int32_t i = 0; i < taosArrayGetSize(pSpill->pPassPages); ++i) {
+    SGroupSpillPage* pPageInfo = taosArrayGet(pSpill->pPassPages, i);
+    void*            pPage = getBufPage(pSpill->pBuf, pPageInfo->pageId);
+    QUERY_CHECK_NULL(pPage, code, lino, _end, terrno);
+
+    code = blockDataFromBuf(pBlock, pPage);
+    if (code == TSDB_CODE_SUCCESS) {
+      code = dBufSetBufPageRecycled(pSpill->pBuf, pPage);
+    } else {
+      releaseBufPage(pSpill->pBuf, pPage);
+    }
+    QUERY_CHECK_CODE(code, lino, _end);
+
+    pBlock->info.id.groupId = pPageInfo->groupId;
+    code = setInputDataBlock(&pOperator->exprSupp, pBlock, pInfo->binfo.inputTsOrder, pBlock->info.scanFlag, true);
+    QUERY_CHECK_CODE(code, lino, _end);
+
+    doHashGroupbyAgg(pOperator, pBlock);
+    groupSpillCheckMem(pOperator);
+  }
+
+  code = groupSpillEndPass(pOperator);
+  QUERY_CHECK_CODE(code, lino, _end);
+
+_end:
+  if (code != TSDB_CODE_SUCCESS) {
+    qError("%s failed at line %d since %s", __func__, lino, tstrerror(code));
+  }
+  return code;
+}
+
 static SSDataBlock* buildGroupResultDataBlockByHash(SOperatorInfo* pOperator) {
   int32_t               code = TSDB_CODE_SUCCESS;
   int32_t               lino = 0;
@@ -445,11 +768,22 @@ static SSDataBlock* buildGroupResultDataBlockByHash(SOperatorInfo* pOperator) {
     QUERY_CHECK_CODE(code, lino, _end);
 
     if (!hasRemainResultByHash(pOperator)) {
-      setOperatorCompleted(pOperator);
       // clean hash after completed
       tSimpleHashCleanup(pInfo->aggSup.pResultRowHashTable);
       pInfo->aggSup.pResultRowHashTable = NULL;
-      break;
+      if (taosArrayGetSize(pInfo->spill.pParts) == 0) {
+        setOperatorCompleted(pOperator);
+        break;
+      }
+
+      // the groups of the next spilled partition are built on the next call
+      if (pRes->info.rows > 0) {
+        break;
+      }
+
+      code = groupSpillAggregatePart(pOperator);
+      QUERY_CHECK_CODE(code, lino, _end);
+      continue;
     }
     if (pRes->info.rows > 0) {
       break;
@@ -505,23 +839,16 @@ static int32_t hashGroupbyAggregateNext(SOperatorInfo* pOperator, SSDataBlock**
     }
 
     doHashGroupbyAgg(pOperator, pBlock);
+    groupSpillCheckMem(pOperator);
   }
 
+  code = groupSpillEndPass(pOperator);
+  QUERY_CHECK_CODE(code, lino, _end);
+
   pOperator->status = OP_RES_TO_RETURN;
 
   // initGroupedResultInfo(&pInfo->groupResInfo, pInfo->aggSup.pResultRowHashTable, 0);
-  if (pGroupResInfo->pRows != NULL) {
-    taosArrayDestroy(pGroupResInfo->pRows);
-  }
-
-  if (pGroupResInfo->pBuf) {
-    taosMemoryFree(pGroupResInfo->pBuf);
-    pGroupResInfo->pBuf = NULL;
-  }
-
-  pGroupResInfo->index = 0;
-  pGroupResInfo->iter = 0;
-  pGroupResInfo->dataPos = NULL;
+  initGroupResInfoByHash(pGroupResInfo);
 
   pOperator->cost.openCost = (taosGetTimestampUs() - st) / 1000.0;
 
@@ -548,6 +875,7 @@ static int32_t resetGroupOperState(SOperatorInfo* pOper) {
     false);
 
   cleanupGroupResInfo(&pInfo->groupResInfo);
+  destroyGroupSpillInfo(&pInfo->spill);
 
   qInfo("[group key] len use:%d", pInfo->groupKeyLen);
   int32_t code = resetAggSup(&pOper->exprSupp, &pInfo->aggSup, pTaskInfo, pPhynode->pAggFuncs, pPhynode->pGroupKeys,
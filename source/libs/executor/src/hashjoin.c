@@ -29,52 +29,90 @@
 
 
 
+// look the rows of a probe batch up in one pass before output, the rows of the partitions not in memory are spilled
+static int32_t hJoinProbeBatch(SHJoinOperatorInfo* pJoin) {
+  SHJoinTableCtx* pProbe = pJoin->pProbe;
+  SHJoinCtx*      pCtx = &pJoin->ctx;
+  bool            spill = pJoin->spill.enabled && !pJoin->spill.probeDone;
+  size_t          bufLen = 0;
+  int32_t         matchNum = 0;
+
+  pCtx->probeBatchEnd = TMIN(pCtx->probeStartIdx + HJOIN_PROBE_BATCH_SIZE - 1, pCtx->probeEndIdx);
+  for (int32_t i = pCtx->probeStartIdx; i <= pCtx->probeBatchEnd; ++i) {
+    if (hJoinCopyKeyColsDataToBuf(pProbe, i, &bufLen)) {
+      continue;
+    }
+
+    if (spill) {
+      int32_t part = hJoinGetKeyPart(pProbe->keyData, bufLen);
+      if (!pJoin->spill.parts[part].inMem) {
+        HJ_ERR_RET(hJoinSpillRow(pJoin, HJOIN_SPILL_PROBE, part, pCtx->pProbeData, i));
+        continue;
+      }
+    }
+
+    SGroupData* pGroup = tSimpleHashGet(pJoin->pKeyHash, pProbe->keyData, bufLen);
+    if (pGroup) {
+      pJoin->pMatchRows[matchNum] = i;
+      pJoin->pMatchGroups[matchNum] = pGroup;
+      matchNum++;
+    }
+  }
+
+  pCtx->matchNum = matchNum;
+  pCtx->matchIdx = 0;
+  pCtx->probeStartIdx = matchNum > 0 ? pJoin->pMatchRows[0] : pCtx->probeBatchEnd + 1;
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static FORCE_INLINE void hJoinNextMatch(SHJoinOperatorInfo* pJoin) {
+  SHJoinCtx* pCtx = &pJoin->ctx;
+  if (++pCtx->matchIdx < pCtx->matchNum) {
+    pCtx->probeStartIdx = pJoin->pMatchRows[pCtx->matchIdx];
+  } else {
+    pCtx->probeStartIdx = pCtx->probeBatchEnd + 1;
+  }
+}
+
 int32_t hInnerJoinDo(struct SOperatorInfo* pOperator) {
   SHJoinOperatorInfo* pJoin = pOperator->info;
   SHJoinTableCtx* pProbe = pJoin->pProbe;
   SHJoinCtx* pCtx = &pJoin->ctx;
   SSDataBlock* pRes = pJoin->finBlk;
-  size_t bufLen = 0;
   int32_t code = 0;
   bool allFetched = false;
 
   if (pJoin->ctx.pBuildRow) {
     hJoinAppendResToBlock(pOperator, pRes, &allFetched);
+    if (allFetched) {
+      hJoinNextMatch(pJoin);
+    }
     if (pRes->info.rows >= pRes->info.capacity) {
-      if (allFetched) {
-        ++pCtx->probeStartIdx;
-      }
-      
       return code;
-    } else {
-      ++pCtx->probeStartIdx;
     }
   }
 
-  for (; pCtx->probeStartIdx <= pCtx->probeEndIdx; ++pCtx->probeStartIdx) {
-    if (hJoinCopyKeyColsDataToBuf(pProbe, pCtx->probeStartIdx, &bufLen)) {
+  while (true) {
+    if (pCtx->matchIdx >= pCtx->matchNum) {
+      if (pCtx->probeStartIdx > pCtx->probeEndIdx) {
+        break;
+      }
+
+      HJ_ERR_RET(hJoinProbeBatch(pJoin));
       continue;
     }
-    
-    SGroupData* pGroup = tSimpleHashGet(pJoin->pKeyHash, pProbe->keyData, bufLen);
-/*
-    size_t keySize = 0;
-    int32_t* pKey = tSimpleHashGetKey(pGroup, &keySize);
-    A S S E R T(keySize == bufLen && 0 == memcmp(pKey, pProbe->keyData, bufLen));
-    int64_t rows = getSingleKeyRowsNum(pGroup->rows);
-    pJoin->execInfo.expectRows += rows;    
-    qTrace("hash_key:%d, rows:%" PRId64, *pKey, rows);
-*/
-    if (pGroup) {
-      pCtx->pBuildRow = pGroup->rows;
-      hJoinAppendResToBlock(pOperator, pRes, &allFetched);
-      if (pRes->info.rows >= pRes->info.capacity) {
-        if (allFetched) {
-          ++pCtx->probeStartIdx;
-        }
-        
-        return code;
-      }
+
+    // the key data was moved on by the batch lookup, the result copies the build key from it
+    (void)hJoinCopyKeyColsDataToBuf(pProbe, pCtx->probeStartIdx, NULL);
+
+    pCtx->pBuildRow = pJoin->pMatchGroups[pCtx->matchIdx]->rows;
+    hJoinAppendResToBlock(pOperator, pRes, &allFetched);
+    if (allFetched) {
+      hJoinNextMatch(pJoin);
+    }
+    if (pRes->info.rows >= pRes->info.capacity) {
+      return code;
     }
   }
 
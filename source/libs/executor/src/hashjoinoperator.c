@@ -20,8 +20,10 @@
 #include "os.h"
 #include "querynodes.h"
 #include "querytask.h"
+#include "tbloomfilter.h"
 #include "tcompare.h"
 #include "tdatablock.h"
+#include "tglobal.h"
 #include "thash.h"
 #include "tmsg.h"
 #include "ttypes.h"
@@ -165,6 +167,7 @@ static int32_t hJoinInitKeyColsInfo(SHJoinTableCtx* pTable, SNodeList* pList) {
     SColumnNode* pColNode = (SColumnNode*)pNode;
     pTable->keyCols[i].srcSlot = pColNode->slotId;
     pTable->keyCols[i].vardata = IS_VAR_DATA_TYPE(pColNode->node.resType.type);
+    pTable->keyCols[i].type = pColNode->node.resType.type;
     pTable->keyCols[i].bytes = pColNode->node.resType.bytes;
     bufSize += pColNode->node.resType.bytes;
     ++i;
@@ -466,6 +469,40 @@ static void hJoinDestroyKeyHash(SSHashObj** ppHash) {
   *ppHash = NULL;
 }
 
+static int32_t hJoinInitKeyHash(SHJoinOperatorInfo* pJoin, size_t hashCap) {
+  pJoin->pKeyHash = tSimpleHashInit(hashCap, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY));
+  if (NULL == pJoin->pKeyHash) {
+    return terrno;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hJoinResetKeyHash(SHJoinOperatorInfo* pJoin, size_t hashCap) {
+  hJoinDestroyKeyHash(&pJoin->pKeyHash);
+  taosArrayDestroyEx(pJoin->pRowBufs, hJoinFreeBufPage);
+  pJoin->pRowBufs = NULL;
+
+  HJ_ERR_RET(hJoinInitBufPages(pJoin));
+  return hJoinInitKeyHash(pJoin, hashCap);
+}
+
+static void hJoinDestroySpillCtx(SHJoinSpillCtx* pSpill) {
+  for (int32_t i = 0; i < HJOIN_SPILL_PART_NUM; ++i) {
+    for (int32_t side = HJOIN_SPILL_BUILD; side <= HJOIN_SPILL_PROBE; ++side) {
+      blockDataDestroy(pSpill->parts[i].pBlk[side]);
+      taosArrayDestroy(pSpill->parts[i].pPages[side]);
+    }
+  }
+
+  for (int32_t side = HJOIN_SPILL_BUILD; side <= HJOIN_SPILL_PROBE; ++side) {
+    blockDataDestroy(pSpill->pBlk[side]);
+    destroyDiskbasedBuf(pSpill->pBuf[side]);
+  }
+
+  TAOS_MEMSET(pSpill, 0, sizeof(*pSpill));
+}
+
 static FORCE_INLINE int32_t hJoinRetrieveColDataFromRowBufs(SArray* pRowBufs, SBufRowInfo* pRow, char** ppData) {
   *ppData = NULL;
   
@@ -874,6 +911,335 @@ static bool hJoinFilterTimeRange(SSDataBlock* pBlock, STimeWindow* pRange, int32
   return true;
 }
 
+static bool hJoinBuildMemFull(SHJoinOperatorInfo* pJoin) {
+  int64_t limit = (int64_t)atomic_load_32(&tsQueryHashJoinMemSizeMB) * 1048576L;
+
+  // the outer joins emit the unmatched probe rows while probing, only the inner join can put a partition off
+  if (limit <= 0 || !IS_INNER_NONE_JOIN(pJoin->joinType, pJoin->subType)) {
+    return false;
+  }
+
+  int64_t size = (int64_t)taosArrayGetSize(pJoin->pRowBufs) * HASH_JOIN_DEFAULT_PAGE_SIZE +
+                 tSimpleHashGetMemSize(pJoin->pKeyHash) + pJoin->execInfo.buildBlkRows * (int64_t)sizeof(SBufRowInfo);
+
+  return size >= limit || isQueryMemNearQuota();
+}
+
+static int32_t hJoinGetSpillBlk(SHJoinSpillPart* pPart, int32_t side, SSDataBlock* pTemplate, SSDataBlock** ppBlk) {
+  if (NULL == pPart->pBlk[side]) {
+    HJ_ERR_RET(createOneDataBlock(pTemplate, false, &pPart->pBlk[side]));
+    HJ_ERR_RET(blockDataEnsureCapacity(pPart->pBlk[side], HJOIN_SPILL_BLK_ROWS));
+  }
+
+  *ppBlk = pPart->pBlk[side];
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hJoinSpillFlushBlk(SHJoinOperatorInfo* pJoin, SHJoinSpillPart* pPart, int32_t side) {
+  SHJoinSpillCtx* pSpill = &pJoin->spill;
+  SSDataBlock*    pBlk = pPart->pBlk[side];
+  SSDataBlock*    p = NULL;
+  int32_t         code = TSDB_CODE_SUCCESS;
+  int32_t         lino = 0;
+
+  if (NULL == pBlk || pBlk->info.rows <= 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (NULL == pSpill->pBuf[side]) {
+    if (!osTempSpaceAvailable()) {
+      code = TSDB_CODE_NO_DISKSPACE;
+      qError("hash join spill failed since %s, tempDir:%s", tstrerror(code), tsTempDir);
+      return code;
+    }
+
+    int32_t pageSize = getProperSortPageSize(blockDataGetRowSize(pBlk), taosArrayGetSize(pBlk->pDataBlock));
+    code = createDiskbasedBuf(&pSpill->pBuf[side], pageSize, (int64_t)pageSize * HJOIN_SPILL_PART_NUM,
+                              "hashJoinSpillBuf", tsTempDir);
+    QUERY_CHECK_CODE(code, lino, _end);
+
+    code = createOneDataBlock(pBlk, false, &pSpill->pBlk[side]);
+    QUERY_CHECK_CODE(code, lino, _end);
+  }
+
+  if (NULL == pPart->pPages[side]) {
+    pPart->pPages[side] = taosArrayInit(4, sizeof(int32_t));
+    QUERY_CHECK_NULL(pPart->pPages[side], code, lino, _end, terrno);
+  }
+
+  int32_t start = 0;
+  while (start < pBlk->info.rows) {
+    int32_t stop = 0;
+    code = blockDataSplitRows(pBlk, pBlk->info.hasVarCol, start, &stop, getBufPageSize(pSpill->pBuf[side]));
+    QUERY_CHECK_CODE(code, lino, _end);
+
+    code = blockDataExtractBlock(pBlk, start, stop - start + 1, &p);
+    QUERY_CHECK_CODE(code, lino, _end);
+
+    int32_t pageId = -1;
+    void*   pPage = getNewBufPage(pSpill->pBuf[side], &pageId);
+    QUERY_CHECK_NULL(pPage, code, lino, _end, terrno);
+
+    code = blockDataToBuf(pPage, p);
+    setBufPageDirty(pPage, true);
+    releaseBufPage(pSpill->pBuf[side], pPage);
+    QUERY_CHECK_CODE(code, lino, _end);
+
+    void* px = taosArrayPush(pPart->pPages[side], &pageId);
+    QUERY_CHECK_NULL(px, code, lino, _end, terrno);
+
+    if (HJOIN_SPILL_BUILD == side) {
+      pPart->bytes += getBufPageSize(pSpill->pBuf[side]);
+    }
+
+    blockDataDestroy(p);
+    p = NULL;
+    start = stop + 1;
+  }
+
+  blockDataCleanup(pBlk);
+
+_end:
+  blockDataDestroy(p);
+  if (code != TSDB_CODE_SUCCESS) {
+    qError("%s failed at line %d since %s", __func__, lino, tstrerror(code));
+  }
+  return code;
+}
+
+int32_t hJoinSpillRow(SHJoinOperatorInfo* pJoin, int32_t side, int32_t part, SSDataBlock* pSrc, int32_t rowIdx) {
+  SHJoinSpillPart* pPart = &pJoin->spill.parts[part];
+  SSDataBlock*     pBlk = NULL;
+
+  HJ_ERR_RET(hJoinGetSpillBlk(pPart, side, pSrc, &pBlk));
+  HJ_ERR_RET(blockDataMergeNRows(pBlk, pSrc, rowIdx, 1));
+
+  if (HJOIN_SPILL_BUILD == side) {
+    pJoin->execInfo.spillBuildRows++;
+  } else {
+    pJoin->execInfo.spillProbeRows++;
+  }
+
+  if (pBlk->info.rows >= HJOIN_SPILL_BLK_ROWS) {
+    HJ_ERR_RET(hJoinSpillFlushBlk(pJoin, pPart, side));
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// decode the rows of a group back to the layout of the build downstream, the columns not used by the join are null
+static int32_t hJoinSpillGroupRows(SHJoinOperatorInfo* pJoin, SSDataBlock* pTemplate, SGroupData* pGroup) {
+  SHJoinTableCtx*  pBuild = pJoin->pBuild;
+  size_t           keyLen = 0;
+  char*            pKey = tSimpleHashGetKey(pGroup, &keyLen);
+  SHJoinSpillPart* pPart = &pJoin->spill.parts[hJoinGetKeyPart(pKey, keyLen)];
+  SSDataBlock*     pBlk = NULL;
+  char*            pData = NULL;
+
+  HJ_ERR_RET(hJoinGetSpillBlk(pPart, HJOIN_SPILL_BUILD, pTemplate, &pBlk));
+
+  for (SBufRowInfo* pRow = pGroup->rows; pRow; pRow = pRow->next) {
+    int32_t row = pBlk->info.rows;
+    int32_t colNum = taosArrayGetSize(pBlk->pDataBlock);
+    for (int32_t i = 0; i < colNum; ++i) {
+      colDataSetNULL(taosArrayGet(pBlk->pDataBlock, i), row);
+    }
+
+    char* pKeyData = pKey;
+    for (int32_t i = 0; i < pBuild->keyNum; ++i) {
+      SColumnInfoData* pCol = taosArrayGet(pBlk->pDataBlock, pBuild->keyCols[i].srcSlot);
+      HJ_ERR_RET(colDataSetVal(pCol, row, pKeyData, false));
+      pKeyData += pBuild->keyCols[i].vardata ? varDataTLen(pKeyData) : pBuild->keyCols[i].bytes;
+    }
+
+    HJ_ERR_RET(hJoinRetrieveColDataFromRowBufs(pJoin->pRowBufs, pRow, &pData));
+    if (pData) {
+      char* pValData = pData + pBuild->valBitMapSize;
+      for (int32_t i = 0, m = 0; i < pBuild->valNum; ++i) {
+        if (pBuild->valCols[i].keyCol) {
+          continue;
+        }
+        if (!BMIsNull(pData, m)) {
+          SColumnInfoData* pCol = taosArrayGet(pBlk->pDataBlock, pBuild->valCols[i].srcSlot);
+          HJ_ERR_RET(colDataSetVal(pCol, row, pValData, false));
+          pValData += pBuild->valCols[i].vardata ? varDataTLen(pValData) : pBuild->valCols[i].bytes;
+        }
+        m++;
+      }
+    }
+
+    pBlk->info.rows++;
+    pJoin->execInfo.spillBuildRows++;
+    if (pBlk->info.rows >= HJOIN_SPILL_BLK_ROWS) {
+      HJ_ERR_RET(hJoinSpillFlushBlk(pJoin, pPart, HJOIN_SPILL_BUILD));
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// move the build rows in memory to the partitions, the following build rows go to the partitions directly
+static int32_t hJoinStartSpill(SHJoinOperatorInfo* pJoin, SSDataBlock* pTemplate) {
+  qDebug("hash join build rows exceed %dMB after %" PRId64 " rows, partition them by join key",
+         tsQueryHashJoinMemSizeMB, pJoin->execInfo.buildBlkRows);
+
+  void*   pIte = NULL;
+  int32_t iter = 0;
+  while ((pIte = tSimpleHashIterate(pJoin->pKeyHash, pIte, &iter)) != NULL) {
+    HJ_ERR_RET(hJoinSpillGroupRows(pJoin, pTemplate, pIte));
+  }
+
+  pJoin->spill.enabled = true;
+  return hJoinResetKeyHash(pJoin, 1024);
+}
+
+static int32_t hJoinLoadSpillPage(SHJoinSpillCtx* pSpill, int32_t side, int32_t pageId) {
+  void* pPage = getBufPage(pSpill->pBuf[side], pageId);
+  if (NULL == pPage) {
+    return terrno;
+  }
+
+  int32_t code = blockDataFromBuf(pSpill->pBlk[side], pPage);
+  if (TSDB_CODE_SUCCESS == code) {
+    code = dBufSetBufPageRecycled(pSpill->pBuf[side], pPage);
+  } else {
+    releaseBufPage(pSpill->pBuf[side], pPage);
+  }
+
+  return code;
+}
+
+// the rows were filtered by the time range and had the primary key expr applied before being spilled
+static int32_t hJoinAddSpillBlockToHash(SHJoinOperatorInfo* pJoin, SSDataBlock* pBlock) {
+  SHJoinTableCtx* pBuild = pJoin->pBuild;
+  size_t          bufLen = 0;
+
+  HJ_ERR_RET(hJoinSetKeyColsData(pBlock, pBuild));
+
+  for (int32_t i = 0; i < pBlock->info.rows; ++i) {
+    if (hJoinCopyKeyColsDataToBuf(pBuild, i, &bufLen)) {
+      continue;
+    }
+    HJ_ERR_RET(hJoinAddRowToHash(pJoin, pBlock, bufLen, i));
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hJoinLoadSpillPart(SHJoinOperatorInfo* pJoin, SHJoinSpillPart* pPart) {
+  SHJoinSpillCtx* pSpill = &pJoin->spill;
+  int32_t         pageNum = taosArrayGetSize(pPart->pPages[HJOIN_SPILL_BUILD]);
+
+  for (int32_t i = 0; i < pageNum; ++i) {
+    int32_t* pPageId = taosArrayGet(pPart->pPages[HJOIN_SPILL_BUILD], i);
+    HJ_ERR_RET(hJoinLoadSpillPage(pSpill, HJOIN_SPILL_BUILD, *pPageId));
+    HJ_ERR_RET(hJoinAddSpillBlockToHash(pJoin, pSpill->pBlk[HJOIN_SPILL_BUILD]));
+  }
+
+  taosArrayDestroy(pPart->pPages[HJOIN_SPILL_BUILD]);
+  pPart->pPages[HJOIN_SPILL_BUILD] = NULL;
+  return TSDB_CODE_SUCCESS;
+}
+
+// keep the smallest partitions in memory while probing, as many as half of the limit holds, since the key hash and
+// the row infos take more memory than the pages written
+static int32_t hJoinEndBuildSpill(SHJoinOperatorInfo* pJoin) {
+  SHJoinSpillCtx* pSpill = &pJoin->spill;
+  int64_t         limit = (int64_t)atomic_load_32(&tsQueryHashJoinMemSizeMB) * 1048576L / 2;
+  int64_t         size = 0;
+  int32_t         inMemNum = 0;
+  int32_t         order[HJOIN_SPILL_PART_NUM];
+
+  for (int32_t i = 0; i < HJOIN_SPILL_PART_NUM; ++i) {
+    HJ_ERR_RET(hJoinSpillFlushBlk(pJoin, &pSpill->parts[i], HJOIN_SPILL_BUILD));
+
+    int32_t j = i;
+    for (; j > 0 && pSpill->parts[order[j - 1]].bytes > pSpill->parts[i].bytes; --j) {
+      order[j] = order[j - 1];
+    }
+    order[j] = i;
+  }
+
+  for (int32_t i = 0; i < HJOIN_SPILL_PART_NUM; ++i) {
+    SHJoinSpillPart* pPart = &pSpill->parts[order[i]];
+    if (size + pPart->bytes > limit || isQueryMemNearQuota()) {
+      break;
+    }
+
+    HJ_ERR_RET(hJoinLoadSpillPart(pJoin, pPart));
+    pPart->inMem = true;
+    size += pPart->bytes;
+    inMemNum++;
+  }
+
+  qDebug("hash join spilled %" PRId64 " build rows, %d of %d partitions kept in memory, %" PRId64 " bytes",
+         pJoin->execInfo.spillBuildRows, inMemNum, HJOIN_SPILL_PART_NUM, size);
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// the probe rows of the partitions not in memory are spilled while probing, each of those partitions is joined
+// after the probe downstream is exhausted by loading its build rows and then feeding its probe rows back
+static int32_t hJoinGetProbeBlock(struct SOperatorInfo* pOperator, SSDataBlock** ppBlock) {
+  SHJoinOperatorInfo* pJoin = pOperator->info;
+  SHJoinSpillCtx*     pSpill = &pJoin->spill;
+
+  *ppBlock = NULL;
+  if (!pSpill->probeDone) {
+    if (NULL != pJoin->pRtFilterParam) {
+      SOperatorInfo*  pDownstream = pOperator->pDownstream[pJoin->pProbe->downStreamIdx];
+      SOperatorParam* pParam = pJoin->pRtFilterParam;
+
+      // the table scan takes the param
+      pJoin->pRtFilterParam = NULL;
+      HJ_ERR_RET(pDownstream->fpSet.getNextExtFn(pDownstream, pParam, ppBlock));
+    } else {
+      *ppBlock = getNextBlockFromDownstream(pOperator, pJoin->pProbe->downStreamIdx);
+    }
+    if (NULL != *ppBlock || !pSpill->enabled) {
+      return TSDB_CODE_SUCCESS;
+    }
+
+    for (int32_t i = 0; i < HJOIN_SPILL_PART_NUM; ++i) {
+      HJ_ERR_RET(hJoinSpillFlushBlk(pJoin, &pSpill->parts[i], HJOIN_SPILL_PROBE));
+    }
+
+    qDebug("hash join spilled %" PRId64 " probe rows", pJoin->execInfo.spillProbeRows);
+
+    pSpill->probeDone = true;
+    pSpill->partIdx = -1;
+    pSpill->pageIdx = 0;
+  }
+
+  while (true) {
+    if (pSpill->partIdx >= 0) {
+      SHJoinSpillPart* pPart = &pSpill->parts[pSpill->partIdx];
+      if (pSpill->pageIdx < taosArrayGetSize(pPart->pPages[HJOIN_SPILL_PROBE])) {
+        int32_t* pPageId = taosArrayGet(pPart->pPages[HJOIN_SPILL_PROBE], pSpill->pageIdx++);
+        HJ_ERR_RET(hJoinLoadSpillPage(pSpill, HJOIN_SPILL_PROBE, *pPageId));
+        *ppBlock = pSpill->pBlk[HJOIN_SPILL_PROBE];
+        return TSDB_CODE_SUCCESS;
+      }
+    }
+
+    // an inner join has nothing to output for a partition without build or probe rows
+    do {
+      pSpill->partIdx++;
+    } while (pSpill->partIdx < HJOIN_SPILL_PART_NUM &&
+             (pSpill->parts[pSpill->partIdx].inMem ||
+              0 == taosArrayGetSize(pSpill->parts[pSpill->partIdx].pPages[HJOIN_SPILL_BUILD]) ||
+              0 == taosArrayGetSize(pSpill->parts[pSpill->partIdx].pPages[HJOIN_SPILL_PROBE])));
+
+    if (pSpill->partIdx >= HJOIN_SPILL_PART_NUM) {
+      return TSDB_CODE_SUCCESS;
+    }
+
+    HJ_ERR_RET(hJoinResetKeyHash(pJoin, 1024));
+    HJ_ERR_RET(hJoinLoadSpillPart(pJoin, &pSpill->parts[pSpill->partIdx]));
+    pSpill->pageIdx = 0;
+  }
+}
+
 static int32_t hJoinAddBlockRowsToHash(SSDataBlock* pBlock, SHJoinOperatorInfo* pJoin) {
   SHJoinTableCtx* pBuild = pJoin->pBuild;
   int32_t startIdx = 0, endIdx = pBlock->info.rows - 1;
@@ -893,7 +1259,11 @@ static int32_t hJoinAddBlockRowsToHash(SSDataBlock* pBlock, SHJoinOperatorInfo*
     if (hJoinCopyKeyColsDataToBuf(pBuild, i, &bufLen)) {
       continue;
     }
-    code = hJoinAddRowToHash(pJoin, pBlock, bufLen, i);
+    if (pJoin->spill.enabled) {
+      code = hJoinSpillRow(pJoin, HJOIN_SPILL_BUILD, hJoinGetKeyPart(pBuild->keyData, bufLen), pBlock, i);
+    } else {
+      code = hJoinAddRowToHash(pJoin, pBlock, bufLen, i);
+    }
     if (code) {
       return code;
     }
@@ -902,6 +1272,84 @@ static int32_t hJoinAddBlockRowsToHash(SSDataBlock* pBlock, SHJoinOperatorInfo*
   return code;
 }
 
+static int32_t hJoinFillRtFilter(SHJoinOperatorInfo* pJoin, STableScanRtFilter* pFilter) {
+  SHJoinColInfo* pKey = &pJoin->pProbe->keyCols[0];
+  int32_t        keyNum = tSimpleHashGetSize(pJoin->pKeyHash);
+  void*          pIte = NULL;
+  int32_t        iter = 0;
+
+  HJ_ERR_RET(tBlockBloomFilterInit(keyNum, HJOIN_RT_FILTER_FPP, &pFilter->pBloom));
+
+  pFilter->hasRange = IS_SIGNED_NUMERIC_TYPE(pKey->type) || TSDB_DATA_TYPE_TIMESTAMP == pKey->type;
+  pFilter->min = INT64_MAX;
+  pFilter->max = INT64_MIN;
+  while ((pIte = tSimpleHashIterate(pJoin->pKeyHash, pIte, &iter)) != NULL) {
+    size_t keyLen = 0;
+    char*  pKeyData = tSimpleHashGetKey(pIte, &keyLen);
+    tBlockBloomFilterPut(pFilter->pBloom, pKeyData, keyLen);
+
+    if (pFilter->hasRange) {
+      int64_t v = 0;
+      GET_TYPED_DATA(v, int64_t, pKey->type, pKeyData, 0);
+      pFilter->min = TMIN(pFilter->min, v);
+      pFilter->max = TMAX(pFilter->max, v);
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// the probe rows whose key is not in the hash never match in an inner join, so the keys of a single key join are
+// pushed to the probe table scan as a range and a bloom filter to drop those rows before they are read up. The filter
+// left by the last build is cleared if no filter can be built this time.
+int32_t hJoinBuildRtFilter(struct SOperatorInfo* pOperator) {
+  SHJoinOperatorInfo* pJoin = pOperator->info;
+  SHJoinColInfo*      pKey = &pJoin->pProbe->keyCols[0];
+  SHJoinColInfo*      pBuildKey = &pJoin->pBuild->keyCols[0];
+  SOperatorInfo*      pDownstream = pOperator->pDownstream[pJoin->pProbe->downStreamIdx];
+  STableScanRtFilter* pFilter = NULL;
+  int32_t             code = TSDB_CODE_SUCCESS;
+
+  // the hash keys are build side values, they are only comparable with the probe values of the same type and width
+  if (!IS_INNER_NONE_JOIN(pJoin->joinType, pJoin->subType) || 1 != pJoin->pProbe->keyNum ||
+      pKey->type != pBuildKey->type || pKey->bytes != pBuildKey->bytes ||
+      QUERY_NODE_PHYSICAL_PLAN_TABLE_SCAN != pDownstream->operatorType ||
+      (pOperator->pDownstreamGetParams && pOperator->pDownstreamGetParams[pJoin->pProbe->downStreamIdx])) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  bool build = !pJoin->spill.enabled && tSimpleHashGetSize(pJoin->pKeyHash) > 0 &&
+               tSimpleHashGetSize(pJoin->pKeyHash) <= HJOIN_RT_FILTER_MAX_KEYS && !IS_STR_DATA_BLOB(pKey->type);
+  if (!build && !pJoin->rtFilterPushed) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  pFilter = taosMemoryCalloc(1, sizeof(STableScanRtFilter));
+  if (NULL == pFilter) {
+    return terrno;
+  }
+
+  pFilter->slotId = pKey->srcSlot;
+  pFilter->type = pKey->type;
+  pFilter->bytes = pKey->bytes;
+  if (build) {
+    HJ_ERR_JRET(hJoinFillRtFilter(pJoin, pFilter));
+  }
+
+  freeOperatorParam(pJoin->pRtFilterParam, OP_GET_PARAM);
+  pJoin->pRtFilterParam = NULL;
+  HJ_ERR_JRET(buildTableScanRtFilterParam(&pJoin->pRtFilterParam, pFilter));
+  pJoin->rtFilterPushed = build;
+
+  qDebug("hash join runtime filter built, keys:%d, range:%d", build ? tSimpleHashGetSize(pJoin->pKeyHash) : 0,
+         build && pFilter->hasRange);
+  return TSDB_CODE_SUCCESS;
+
+_return:
+  destroyTableScanRtFilter(pFilter);
+  return code;
+}
+
 static int32_t hJoinBuildHash(struct SOperatorInfo* pOperator, bool* queryDone) {
   SHJoinOperatorInfo* pJoin = pOperator->info;
   SSDataBlock*        pBlock = NULL;
@@ -920,12 +1368,24 @@ static int32_t hJoinBuildHash(struct SOperatorInfo* pOperator, bool* queryDone)
     if (code) {
       return code;
     }
+
+    if (!pJoin->spill.enabled && hJoinBuildMemFull(pJoin)) {
+      HJ_ERR_RET(hJoinStartSpill(pJoin, pBlock));
+    }
   }
 
-  if (IS_INNER_NONE_JOIN(pJoin->joinType, pJoin->subType) && tSimpleHashGetSize(pJoin->pKeyHash) <= 0) {
+  if (pJoin->spill.enabled) {
+    HJ_ERR_RET(hJoinEndBuildSpill(pJoin));
+  }
+
+  if (IS_INNER_NONE_JOIN(pJoin->joinType, pJoin->subType) && tSimpleHashGetSize(pJoin->pKeyHash) <= 0 &&
+      !pJoin->spill.enabled) {
     hJoinSetDone(pOperator);
     *queryDone = true;
+    return TSDB_CODE_SUCCESS;
   }
+
+  HJ_ERR_RET(hJoinBuildRtFilter(pOperator));
   
   //qTrace("build table rows:%" PRId64, hJoinGetRowsNumOfKeyHash(pJoin->pKeyHash));
 
@@ -936,7 +1396,9 @@ static int32_t hJoinPrepareStart(struct SOperatorInfo* pOperator, SSDataBlock* p
   SHJoinOperatorInfo* pJoin = pOperator->info;
   SHJoinTableCtx* pProbe = pJoin->pProbe;
   int32_t startIdx = 0, endIdx = pBlock->info.rows - 1;
-  if (pProbe->hasTimeRange && !hJoinFilterTimeRange(pBlock, &pJoin->tblTimeRange, pProbe->primCol->srcSlot, &startIdx, &endIdx)) {
+  // the spilled rows were filtered and had the primary key expr applied already, and are not in time order any more
+  bool spilled = pJoin->spill.probeDone;
+  if (!spilled && pProbe->hasTimeRange && !hJoinFilterTimeRange(pBlock, &pJoin->tblTimeRange, pProbe->primCol->srcSlot, &startIdx, &endIdx)) {
     if (!IS_INNER_NONE_JOIN(pJoin->joinType, pJoin->subType)) {
       pJoin->ctx.probeEndIdx = -1;
       pJoin->ctx.probePostIdx = 0;
@@ -950,7 +1412,9 @@ static int32_t hJoinPrepareStart(struct SOperatorInfo* pOperator, SSDataBlock* p
     return TSDB_CODE_SUCCESS;
   }
 
-  HJ_ERR_RET(hJoinLaunchPrimExpr(pBlock, pProbe, startIdx, endIdx));
+  if (!spilled) {
+    HJ_ERR_RET(hJoinLaunchPrimExpr(pBlock, pProbe, startIdx, endIdx));
+  }
 
   int32_t code = hJoinSetKeyColsData(pBlock, pProbe);
   if (code) {
@@ -968,6 +1432,8 @@ static int32_t hJoinPrepareStart(struct SOperatorInfo* pOperator, SSDataBlock* p
   pJoin->ctx.rowRemains = true;
   pJoin->ctx.probePreIdx = 0;
   pJoin->ctx.probePostIdx = endIdx + 1;
+  pJoin->ctx.matchNum = 0;
+  pJoin->ctx.matchIdx = 0;
 
   if (!IS_INNER_NONE_JOIN(pJoin->joinType, pJoin->subType) && startIdx > 0) {
     pJoin->ctx.probePhase = E_JOIN_PHASE_PRE;
@@ -1037,7 +1503,9 @@ static int32_t hJoinMainProcess(struct SOperatorInfo* pOperator, SSDataBlock** p
   }
 
   while (true) {
-    SSDataBlock* pBlock = getNextBlockFromDownstream(pOperator, pJoin->pProbe->downStreamIdx);
+    SSDataBlock* pBlock = NULL;
+    code = hJoinGetProbeBlock(pOperator, &pBlock);
+    QUERY_CHECK_CODE(code, lino, _end);
     if (NULL == pBlock) {
       hJoinSetDone(pOperator);
       break;
@@ -1081,11 +1549,17 @@ _end:
 
 static void destroyHashJoinOperator(void* param) {
   SHJoinOperatorInfo* pJoinOperator = (SHJoinOperatorInfo*)param;
-  qDebug("hashJoin exec info, buildBlk:%" PRId64 ", buildRows:%" PRId64 ", probeBlk:%" PRId64 ", probeRows:%" PRId64 ", resRows:%" PRId64, 
+  qDebug("hashJoin exec info, buildBlk:%" PRId64 ", buildRows:%" PRId64 ", probeBlk:%" PRId64 ", probeRows:%" PRId64 ", resRows:%" PRId64
+         ", spillBuildRows:%" PRId64 ", spillProbeRows:%" PRId64,
          pJoinOperator->execInfo.buildBlkNum, pJoinOperator->execInfo.buildBlkRows, pJoinOperator->execInfo.probeBlkNum, 
-         pJoinOperator->execInfo.probeBlkRows, pJoinOperator->execInfo.resRows);
+         pJoinOperator->execInfo.probeBlkRows, pJoinOperator->execInfo.resRows, pJoinOperator->execInfo.spillBuildRows,
+         pJoinOperator->execInfo.spillProbeRows);
 
   hJoinDestroyKeyHash(&pJoinOperator->pKeyHash);
+  hJoinDestroySpillCtx(&pJoinOperator->spill);
+  taosMemoryFreeClear(pJoinOperator->pMatchRows);
+  taosMemoryFreeClear(pJoinOperator->pMatchGroups);
+  freeOperatorParam(pJoinOperator->pRtFilterParam, OP_GET_PARAM);
 
   hJoinFreeTableInfo(&pJoinOperator->tbs[0]);
   hJoinFreeTableInfo(&pJoinOperator->tbs[1]);
@@ -1179,27 +1653,12 @@ static int32_t resetHashJoinOperState(SOperatorInfo* pOper) {
   pOper->status = OP_NOT_OPENED;
 
   pHjOper->execInfo = (SHJoinExecInfo){0};
+  hJoinDestroySpillCtx(&pHjOper->spill);
+  freeOperatorParam(pHjOper->pRtFilterParam, OP_GET_PARAM);
+  pHjOper->pRtFilterParam = NULL;
 
-  void*   pIte = NULL;
-  int32_t iter = 0;
-  while ((pIte = tSimpleHashIterate(pHjOper->pKeyHash, pIte, &iter)) != NULL) {
-    SGroupData* pGroup = pIte;
-    SBufRowInfo* pRow = pGroup->rows;
-    SBufRowInfo* pNext = NULL;
-    while (pRow) {
-      pNext = pRow->next;
-      taosMemoryFree(pRow);
-      pRow = pNext;
-    }
-  }
-  tSimpleHashCleanup(pHjOper->pKeyHash);
   size_t hashCap = pHjOper->pBuild->inputStat.inputRowNum > 0 ? (pHjOper->pBuild->inputStat.inputRowNum * 1.5) : 1024;
-  pHjOper->pKeyHash = tSimpleHashInit(hashCap, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY));
-  if (pHjOper->pKeyHash == NULL) {
-    return terrno; 
-  }
-  taosArrayDestroyEx(pHjOper->pRowBufs, hJoinFreeBufPage);
-  int32_t code = hJoinInitBufPages(pHjOper);
+  int32_t code = hJoinResetKeyHash(pHjOper, hashCap);
   int64_t limit = pHjOper->ctx.limit;
   pHjOper->ctx = (SHJoinCtx){0};
   pHjOper->ctx.limit = limit;
@@ -1235,8 +1694,11 @@ int32_t createHashJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t numOfDow
   HJ_ERR_JRET(hJoinInitBufPages(pInfo));
 
   size_t hashCap = pInfo->pBuild->inputStat.inputRowNum > 0 ? (pInfo->pBuild->inputStat.inputRowNum * 1.5) : 1024;
-  pInfo->pKeyHash = tSimpleHashInit(hashCap, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY));
-  if (pInfo->pKeyHash == NULL) {
+  HJ_ERR_JRET(hJoinInitKeyHash(pInfo, hashCap));
+
+  pInfo->pMatchRows = taosMemoryMalloc(HJOIN_PROBE_BATCH_SIZE * sizeof(*pInfo->pMatchRows));
+  pInfo->pMatchGroups = taosMemoryMalloc(HJOIN_PROBE_BATCH_SIZE * sizeof(*pInfo->pMatchGroups));
+  if (NULL == pInfo->pMatchRows || NULL == pInfo->pMatchGroups) {
     code = terrno;
     goto _return;
   }
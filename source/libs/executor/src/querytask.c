@@ -57,6 +57,12 @@ int32_t doCreateTask(uint64_t queryId, uint64_t taskId, int32_t vgId, EOPTR_EXEC
     return terrno;
   }
 
+  int32_t code = taosArenaCreate(TAOS_ARENA_DEFAULT_CHUNK_SIZE, &p->pArena);
+  if (code != TSDB_CODE_SUCCESS) {
+    doDestroyTask(p);
+    return code;
+  }
+
   p->storageAPI = *pAPI;
   taosInitRWLatch(&p->lock);
 
@@ -296,6 +302,8 @@ void doDestroyTask(SExecTaskInfo* pTaskInfo) {
     freeOperatorParam(pTaskInfo->pOpParam, OP_GET_PARAM);
     pTaskInfo->pOpParam = NULL;
   }
+  taosArenaDestroy(pTaskInfo->pArena);
+  pTaskInfo->pArena = NULL;
   taosMemoryFreeClear(pTaskInfo->sql);
   taosMemoryFreeClear(pTaskInfo->id.str);
   taosMemoryFreeClear(pTaskInfo);
@@ -23,6 +23,7 @@
 #include "systable.h"
 #include "tname.h"
 
+#include "tbloomfilter.h"
 #include "tdatablock.h"
 #include "tmsg.h"
 #include "ttime.h"
@@ -257,6 +258,12 @@ static int32_t doFilterByBlockSMA(SFilterInfo* pFilterInfo, SColumnDataAgg* pCol
   return filterRangeExecute(pFilterInfo, pColsAgg, numOfCols, numOfRows, keep);
 }
 
+// the tsdb reader does not read ahead the blocks this drops by their zone map, as loadDataBlock would skip them
+static int32_t doFilterReadAheadBlock(SColumnDataAgg* pColsAgg, int32_t numOfCols, int32_t numOfRows, void* param,
+                                      bool* keep) {
+  return doFilterByBlockSMA((SFilterInfo*)param, pColsAgg, numOfCols, numOfRows, keep);
+}
+
 static int32_t doLoadBlockSMA(STableScanBase* pTableScanInfo, SSDataBlock* pBlock, SExecTaskInfo* pTaskInfo,
                               bool* pLoad) {
   SStorageAPI* pAPI = &pTaskInfo->storageAPI;
@@ -281,6 +288,128 @@ static int32_t doLoadBlockSMA(STableScanBase* pTableScanInfo, SSDataBlock* pBloc
   return code;
 }
 
+// the zone map in the .head file holds the min/max/null count of the block, it filters as the sma info does without
+// reading the .sma file
+static int32_t doLoadBlockZoneMap(STableScanBase* pTableScanInfo, SSDataBlock* pBlock, SExecTaskInfo* pTaskInfo,
+                                  bool* pLoad) {
+  SStorageAPI* pAPI = &pTaskInfo->storageAPI;
+  bool         allColumnsHaveAgg = false;
+
+  *pLoad = false;
+  if (pAPI->tsdReader.tsdReaderRetrieveBlockZoneMap == NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t code = pAPI->tsdReader.tsdReaderRetrieveBlockZoneMap(pTableScanInfo->dataReader, pBlock, &allColumnsHaveAgg);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  *pLoad = allColumnsHaveAgg;
+  return code;
+}
+
+// the block can be skipped if the range of the join key in it does not overlap the range of the build side keys
+static int32_t doRtFilterPruneDataBlock(STableScanBase* pTableScanInfo, SSDataBlock* pBlock, SExecTaskInfo* pTaskInfo,
+                                        bool* keep) {
+  STableScanRtFilter* pFilter = pTableScanInfo->pRtFilter;
+  int64_t             min = 0;
+  int64_t             max = 0;
+
+  *keep = true;
+  if (pFilter == NULL || !pFilter->hasRange) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (pFilter->colId == PRIMARYKEY_TIMESTAMP_COL_ID) {
+    min = pBlock->info.window.skey;
+    max = pBlock->info.window.ekey;
+  } else {
+    bool    success = false;
+    int32_t code = doLoadBlockZoneMap(pTableScanInfo, pBlock, pTaskInfo, &success);
+    if (code == TSDB_CODE_SUCCESS &&
+        (pBlock->pBlockAgg == NULL || pBlock->pBlockAgg[pFilter->slotId].colId == -1)) {
+      taosMemoryFreeClear(pBlock->pBlockAgg);
+      code = doLoadBlockSMA(pTableScanInfo, pBlock, pTaskInfo, &success);
+    }
+
+    SColumnDataAgg* pAgg = (pBlock->pBlockAgg != NULL) ? &pBlock->pBlockAgg[pFilter->slotId] : NULL;
+    bool            found = (code == TSDB_CODE_SUCCESS && pAgg != NULL && pAgg->colId != -1);
+    if (found) {
+      // null keys never match
+      if (pAgg->numOfNull >= pBlock->info.rows) {
+        *keep = false;
+      } else {
+        min = pAgg->min;
+        max = pAgg->max;
+      }
+    }
+
+    taosMemoryFreeClear(pBlock->pBlockAgg);
+    if (code != TSDB_CODE_SUCCESS || !found || !(*keep)) {
+      return code;
+    }
+  }
+
+  *keep = (max >= pFilter->min && min <= pFilter->max);
+  return TSDB_CODE_SUCCESS;
+}
+
+// drop the rows whose join key is out of the range of the build side keys, or not in their bloom filter
+static int32_t doRtFilterBlockRows(STableScanBase* pTableScanInfo, SSDataBlock* pBlock) {
+  STableScanRtFilter* pFilter = pTableScanInfo->pRtFilter;
+  int32_t             rows = pBlock->info.rows;
+  int32_t             numOfQualified = 0;
+  int32_t             code = TSDB_CODE_SUCCESS;
+
+  if (pFilter == NULL || rows <= 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pFilter->slotId);
+  if (pCol == NULL) {
+    return terrno;
+  }
+
+  bool* pKeep = taosArenaScratchMalloc(rows * sizeof(bool));
+  if (pKeep == NULL) {
+    return terrno;
+  }
+
+  for (int32_t i = 0; i < rows; ++i) {
+    pKeep[i] = false;
+    if (colDataIsNull_s(pCol, i)) {
+      continue;
+    }
+
+    char* pData = colDataGetData(pCol, i);
+    if (pFilter->hasRange) {
+      int64_t v = 0;
+      GET_TYPED_DATA(v, int64_t, pFilter->type, pData, 0);
+      if (v < pFilter->min || v > pFilter->max) {
+        continue;
+      }
+    }
+
+    if (pFilter->pBloom != NULL) {
+      int32_t len = IS_VAR_DATA_TYPE(pFilter->type) ? varDataTLen(pData) : pFilter->bytes;
+      if (tBlockBloomFilterNoContain(pFilter->pBloom, pData, len)) {
+        continue;
+      }
+    }
+
+    pKeep[i] = true;
+    ++numOfQualified;
+  }
+
+  if (numOfQualified < rows) {
+    code = trimDataBlock(pBlock, rows, pKeep);
+  }
+
+  taosArenaScratchFree(pKeep);
+  return code;
+}
+
 static int32_t doSetTagColumnData(STableScanBase* pTableScanInfo, SSDataBlock* pBlock, SExecTaskInfo* pTaskInfo,
                                   int32_t rows) {
   int32_t    code = 0;
@@ -337,6 +466,49 @@ static bool isDynVtbScan(SOperatorInfo* pOperator) {
   return pOperator->dynamicTask && ((STableScanInfo*)(pOperator->info))->virtualStableScan;
 }
 
+// Apply the filter to the block holding only the filter columns, and load the other columns only if any row is
+// qualified, the reader is released by tsdReaderRetrieveRemainColumns in any case.
+static int32_t doFilterBeforeLoadRemainColumns(SOperatorInfo* pOperator, STableScanBase* pTableScanInfo,
+                                               SSDataBlock* pBlock) {
+  int32_t            code = TSDB_CODE_SUCCESS;
+  int32_t            lino = 0;
+  SStorageAPI*       pAPI = &pOperator->pTaskInfo->storageAPI;
+  SFilterInfo*       pFilterInfo = pOperator->exprSupp.pFilterInfo;
+  SColumnInfoData*   p = NULL;
+  int32_t            status = FILTER_RESULT_NONE_QUALIFIED;
+  bool               released = false;
+  SFilterColumnParam param1 = {.numOfCols = taosArrayGetSize(pBlock->pDataBlock), .pDataBlock = pBlock->pDataBlock};
+
+  if (pBlock->info.rows > 0) {
+    code = filterSetDataFromSlotId(pFilterInfo, &param1);
+    QUERY_CHECK_CODE(code, lino, _end);
+
+    code = filterExecute(pFilterInfo, pBlock, &p, NULL, param1.numOfCols, &status);
+    QUERY_CHECK_CODE(code, lino, _end);
+  }
+
+  released = true;
+  code = pAPI->tsdReader.tsdReaderRetrieveRemainColumns(pTableScanInfo->dataReader, pBlock,
+                                                         status != FILTER_RESULT_NONE_QUALIFIED);
+  QUERY_CHECK_CODE(code, lino, _end);
+
+  if (pBlock->info.rows > 0) {
+    code = applyFilterResult(pBlock, p, status, &pTableScanInfo->matchInfo);
+    QUERY_CHECK_CODE(code, lino, _end);
+  }
+
+_end:
+  if (code != TSDB_CODE_SUCCESS) {
+    qError("%s failed at line %d since %s", __func__, lino, tstrerror(code));
+  }
+  if (!released) {
+    (void)pAPI->tsdReader.tsdReaderRetrieveRemainColumns(pTableScanInfo->dataReader, pBlock, false);
+  }
+  colDataDestroy(p);
+  taosMemoryFree(p);
+  return code;
+}
+
 static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableScanInfo, SSDataBlock* pBlock,
                              uint32_t* status) {
   int32_t        code = TSDB_CODE_SUCCESS;
@@ -412,16 +584,26 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
     return TSDB_CODE_QRY_EXECUTOR_INTERNAL_ERROR;
   }
 
-  // try to filter data block according to sma info
+  // try to filter data block according to the zone map, or the sma info if the zone map does not cover all columns
   if (pOperator->exprSupp.pFilterInfo != NULL && (!loadSMA)) {
     bool success = true;
-    code = doLoadBlockSMA(pTableScanInfo, pBlock, pTaskInfo, &success);
+    code = doLoadBlockZoneMap(pTableScanInfo, pBlock, pTaskInfo, &success);
     if (code) {
       pAPI->tsdReader.tsdReaderReleaseDataBlock(pTableScanInfo->dataReader);
-      qError("%s failed to retrieve sma info", GET_TASKID(pTaskInfo));
+      qError("%s failed to retrieve zone map, code:%s", GET_TASKID(pTaskInfo), tstrerror(code));
       QUERY_CHECK_CODE(code, lino, _end);
     }
 
+    if (!success) {
+      taosMemoryFreeClear(pBlock->pBlockAgg);
+      code = doLoadBlockSMA(pTableScanInfo, pBlock, pTaskInfo, &success);
+      if (code) {
+        pAPI->tsdReader.tsdReaderReleaseDataBlock(pTableScanInfo->dataReader);
+        qError("%s failed to retrieve sma info", GET_TASKID(pTaskInfo));
+        QUERY_CHECK_CODE(code, lino, _end);
+      }
+    }
+
     if (success) {
       size_t size = taosArrayGetSize(pBlock->pDataBlock);
       bool   keep = false;
@@ -448,6 +630,25 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
   // free the sma info, since it should not be involved in *later computing process.
   taosMemoryFreeClear(pBlock->pBlockAgg);
 
+  // try to filter data block according to the join key filter pushed by the hash join above
+  if (pTableScanInfo->pRtFilter != NULL && (!loadSMA)) {
+    bool keep = true;
+    code = doRtFilterPruneDataBlock(pTableScanInfo, pBlock, pTaskInfo, &keep);
+    if (code) {
+      pAPI->tsdReader.tsdReaderReleaseDataBlock(pTableScanInfo->dataReader);
+      QUERY_CHECK_CODE(code, lino, _end);
+    }
+
+    if (!keep) {
+      qDebug("%s data block filter out by join runtime filter, brange:%" PRId64 "-%" PRId64 ", rows:%" PRId64,
+             GET_TASKID(pTaskInfo), pBlockInfo->window.skey, pBlockInfo->window.ekey, pBlockInfo->rows);
+      pCost->filterOutBlocks += 1;
+      (*status) = FUNC_DATA_REQUIRED_FILTEROUT;
+      pAPI->tsdReader.tsdReaderReleaseDataBlock(pTableScanInfo->dataReader);
+      return TSDB_CODE_SUCCESS;
+    }
+  }
+
   // try to filter data block according to current results
   code = doDynamicPruneDataBlock(pOperator, pBlockInfo, status);
   if (code) {
@@ -473,9 +674,15 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
   pCost->totalCheckedRows += pBlock->info.rows;
   pCost->loadBlocks += 1;
 
+  // with a filter, only the columns it uses are loaded at first, see doFilterBeforeLoadRemainColumns
+  bool         lateLoad = (pOperator->exprSupp.pFilterInfo != NULL && pTableScanInfo->pFilterColIds != NULL);
   SSDataBlock* p = NULL;
-  code = pAPI->tsdReader.tsdReaderRetrieveDataBlock(pTableScanInfo->dataReader, &p, NULL);
+  code = pAPI->tsdReader.tsdReaderRetrieveDataBlock(pTableScanInfo->dataReader, &p,
+                                                    lateLoad ? pTableScanInfo->pFilterColIds : NULL);
   if (p == NULL || code != TSDB_CODE_SUCCESS || p != pBlock) {
+    if (lateLoad) {
+      (void)pAPI->tsdReader.tsdReaderRetrieveRemainColumns(pTableScanInfo->dataReader, pBlock, false);
+    }
     return code;
   }
 
@@ -486,6 +693,9 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
     // dyn vtb scan do not read tag from origin tables.
     code = doSetTagColumnData(pTableScanInfo, pBlock, pTaskInfo, pBlock->info.rows);
     if (code) {
+      if (lateLoad) {
+        (void)pAPI->tsdReader.tsdReaderRetrieveRemainColumns(pTableScanInfo->dataReader, pBlock, false);
+      }
       return code;
     }
   }
@@ -494,7 +704,11 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
   pCost->totalRows -= pBlock->info.rows;
 
   if (pOperator->exprSupp.pFilterInfo != NULL) {
-    code = doFilter(pBlock, pOperator->exprSupp.pFilterInfo, &pTableScanInfo->matchInfo);
+    if (lateLoad) {
+      code = doFilterBeforeLoadRemainColumns(pOperator, pTableScanInfo, pBlock);
+    } else {
+      code = doFilter(pBlock, pOperator->exprSupp.pFilterInfo, &pTableScanInfo->matchInfo);
+    }
     QUERY_CHECK_CODE(code, lino, _end);
 
     int64_t st = taosGetTimestampUs();
@@ -515,6 +729,11 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
     setOperatorCompleted(pOperator);
   }
 
+  // after the limit, which belongs to the rows of the scan itself. No filter is set on a scan with a limit, see
+  // setTableScanRtFilter
+  code = doRtFilterBlockRows(pTableScanInfo, pBlock);
+  QUERY_CHECK_CODE(code, lino, _end);
+
   pCost->totalRows += pBlock->info.rows;
 
 _end:
@@ -1348,6 +1567,10 @@ static int32_t createVTableScanInfoFromParam(SOperatorInfo* pOperator) {
   taosRUnLockLatch(&pTaskInfo->lock);
   QUERY_CHECK_CODE(code, lino, _return);
 
+  if (pOperator->exprSupp.pFilterInfo != NULL) {
+    pAPI->tsdReader.tsdSetBlockFilter(pInfo->base.dataReader, doFilterReadAheadBlock, pOperator->exprSupp.pFilterInfo);
+  }
+
   if (pInfo->pResBlock->info.capacity > pOperator->resultInfo.capacity) {
     pOperator->resultInfo.capacity = pInfo->pResBlock->info.capacity;
   }
@@ -1448,6 +1671,11 @@ static int32_t groupSeqTableScan(SOperatorInfo* pOperator, SSDataBlock** pResBlo
       pAPI->tsdReader.tsdSetFilesetDelimited(pInfo->base.dataReader);
     }
 
+    if (pOperator->exprSupp.pFilterInfo != NULL) {
+      pAPI->tsdReader.tsdSetBlockFilter(pInfo->base.dataReader, doFilterReadAheadBlock,
+                                        pOperator->exprSupp.pFilterInfo);
+    }
+
     if (pInfo->pResBlock->info.capacity > pOperator->resultInfo.capacity) {
       pOperator->resultInfo.capacity = pInfo->pResBlock->info.capacity;
     }
@@ -1484,6 +1712,49 @@ _end:
   return code;
 }
 
+static bool hasTableScanLimit(const SLimitInfo* pLimitInfo) {
+  return pLimitInfo->limit.limit != -1 || pLimitInfo->limit.offset > 0 || pLimitInfo->slimit.limit != -1 ||
+         pLimitInfo->slimit.offset > 0;
+}
+
+// the filter replaces the one set before, and it only applies to a data column read by the scan. A scan with a
+// limit or offset takes no filter, since skipping blocks or rows would change which rows the limit keeps.
+static void setTableScanRtFilter(SOperatorInfo* pOperator) {
+  STableScanInfo*          pInfo = pOperator->info;
+  STableScanOperatorParam* pParam = pOperator->pOperatorGetParam->value;
+  STableScanRtFilter*      pFilter = pParam->pRtFilter;
+
+  pParam->pRtFilter = NULL;
+  destroyTableScanRtFilter(pInfo->base.pRtFilter);
+  pInfo->base.pRtFilter = NULL;
+
+  if ((!pFilter->hasRange && pFilter->pBloom == NULL) || isDynVtbScan(pOperator) ||
+      hasTableScanLimit(&pInfo->base.limitInfo)) {
+    destroyTableScanRtFilter(pFilter);
+    return;
+  }
+
+  int32_t num = taosArrayGetSize(pInfo->base.matchInfo.pList);
+  for (int32_t i = 0; i < num; ++i) {
+    SColMatchItem* pItem = taosArrayGet(pInfo->base.matchInfo.pList, i);
+    if (pItem == NULL || pItem->dstSlotId != pFilter->slotId) {
+      continue;
+    }
+
+    if (pItem->dataType.type == pFilter->type && pItem->dataType.bytes == pFilter->bytes) {
+      pFilter->colId = pItem->colId;
+      pInfo->base.pRtFilter = pFilter;
+      qDebug("%s join runtime filter set on column %d, range:%d, bloom:%d", GET_TASKID(pOperator->pTaskInfo),
+             pFilter->colId, pFilter->hasRange, pFilter->pBloom != NULL);
+      return;
+    }
+    break;
+  }
+
+  qDebug("%s join runtime filter on slot %d ignored", GET_TASKID(pOperator->pTaskInfo), pFilter->slotId);
+  destroyTableScanRtFilter(pFilter);
+}
+
 static bool isEmptyQueryTimeWindow(STimeWindow* pWindow) {
   return (pWindow == NULL) || (pWindow->skey > pWindow->ekey);
 }
@@ -1496,6 +1767,13 @@ int32_t doTableScanNext(SOperatorInfo* pOperator, SSDataBlock** ppRes) {
   SStorageAPI*    pAPI = &pTaskInfo->storageAPI;
   QRY_PARAM_CHECK(ppRes);
   qTrace("%s call", __FUNCTION__);
+  if (pOperator->pOperatorGetParam &&
+      ((STableScanOperatorParam*)pOperator->pOperatorGetParam->value)->pRtFilter != NULL) {
+    setTableScanRtFilter(pOperator);
+    freeOperatorParam(pOperator->pOperatorGetParam, OP_GET_PARAM);
+    pOperator->pOperatorGetParam = NULL;
+  }
+
   if (pOperator->pOperatorGetParam) {
     pOperator->dynamicTask = true;
     if (isDynVtbScan(pOperator)) {
@@ -1630,7 +1908,77 @@ static int32_t getTableScannerExecInfo(struct SOperatorInfo* pOptr, void** pOptr
   return 0;
 }
 
+static EDealRes collectFilterColIdsWalker(SNode* pNode, void* pContext) {
+  if (QUERY_NODE_COLUMN == nodeType(pNode)) {
+    SColumnNode* pCol = (SColumnNode*)pNode;
+    SArray*      pColIds = pContext;
+    int16_t      colId = pCol->colId;
+
+    if (pCol->colType != COLUMN_TYPE_COLUMN) {
+      return DEAL_RES_CONTINUE;
+    }
+
+    for (int32_t i = 0; i < taosArrayGetSize(pColIds); ++i) {
+      if (*(int16_t*)taosArrayGet(pColIds, i) == colId) {
+        return DEAL_RES_CONTINUE;
+      }
+    }
+
+    if (taosArrayPush(pColIds, &colId) == NULL) {
+      return DEAL_RES_ERROR;
+    }
+  }
+  return DEAL_RES_CONTINUE;
+}
+
+// The data columns used by the filter, which are loaded and filtered before the other columns of a data block. NULL if
+// the filter uses all the scanned columns, since nothing could be saved then.
+static int32_t collectFilterColIds(SScanPhysiNode* pScanNode, SArray** ppColIds) {
+  int32_t code = TSDB_CODE_SUCCESS;
+  int32_t lino = 0;
+  SArray* pColIds = NULL;
+
+  *ppColIds = NULL;
+  if (pScanNode->node.pConditions == NULL) {
+    return code;
+  }
+
+  pColIds = taosArrayInit(4, sizeof(int16_t));
+  QUERY_CHECK_NULL(pColIds, code, lino, _end, terrno);
+
+  nodesWalkExpr(pScanNode->node.pConditions, collectFilterColIdsWalker, pColIds);
+
+  int32_t numOfRemainCols = 0;
+  SNode*  pNode = NULL;
+  FOREACH(pNode, pScanNode->pScanCols) {
+    SColumnNode* pCol = (SColumnNode*)((STargetNode*)pNode)->pExpr;
+    if (pCol->colId == PRIMARYKEY_TIMESTAMP_COL_ID) {
+      continue;
+    }
+
+    bool found = false;
+    for (int32_t i = 0; i < taosArrayGetSize(pColIds) && !found; ++i) {
+      found = (*(int16_t*)taosArrayGet(pColIds, i) == pCol->colId);
+    }
+    numOfRemainCols += found ? 0 : 1;
+  }
+
+  if (numOfRemainCols > 0) {
+    *ppColIds = pColIds;
+    pColIds = NULL;
+  }
+
+_end:
+  if (code != TSDB_CODE_SUCCESS) {
+    qError("%s failed at line %d since %s", __func__, lino, tstrerror(code));
+  }
+  taosArrayDestroy(pColIds);
+  return code;
+}
+
 static void destroyTableScanBase(STableScanBase* pBase, TsdReader* pAPI) {
+  destroyTableScanRtFilter(pBase->pRtFilter);
+  pBase->pRtFilter = NULL;
   cleanupQueryTableDataCond(&pBase->cond);
   cleanupQueryTableDataCond(&pBase->orgCond);
 
@@ -1643,6 +1991,7 @@ static void destroyTableScanBase(STableScanBase* pBase, TsdReader* pAPI) {
     taosArrayDestroy(pBase->matchInfo.pList);
   }
 
+  taosArrayDestroy(pBase->pFilterColIds);
   tableListDestroy(pBase->pTableListInfo);
   taosLRUCacheCleanup(pBase->metaCache.pTableMetaEntryCache);
   cleanupExprSupp(&pBase->pseudoSup);
@@ -1737,6 +2086,11 @@ int32_t createTableScanOperatorInfo(STableScanPhysiNode* pTableScanNode, SReadHa
                             pTaskInfo->pStreamRuntimeInfo);
   QUERY_CHECK_CODE(code, lino, _error);
 
+  if (!pInfo->virtualStableScan) {
+    code = collectFilterColIds(pScanNode, &pInfo->base.pFilterColIds);
+    QUERY_CHECK_CODE(code, lino, _error);
+  }
+
   pInfo->currentGroupId = -1;
 
   pInfo->tableEndIndex = -1;
@@ -1822,7 +2176,7 @@ static int32_t doBlockDataPrimaryKeyFilter(SSDataBlock* pBlock, STqOffsetVal* of
   if (pBlock->info.window.skey != offset->ts || offset->primaryKey.type == 0) {
     return code;
   }
-  bool* p = taosMemoryCalloc(pBlock->info.rows, sizeof(bool));
+  bool* p = taosArenaScratchCalloc(pBlock->info.rows, sizeof(bool));
   QUERY_CHECK_NULL(p, code, lino, _end, terrno);
   bool hasUnqualified = false;
 
@@ -1843,12 +2197,12 @@ static int32_t doBlockDataPrimaryKeyFilter(SSDataBlock* pBlock, STqOffsetVal* of
       if (IS_STR_DATA_BLOB(pColPk->info.type)) {
         QUERY_CHECK_CODE(code = TSDB_CODE_BLOB_NOT_SUPPORT_PRIMARY_KEY, lino, _end);
       }
-      void* tmq = taosMemoryMalloc(offset->primaryKey.nData + VARSTR_HEADER_SIZE);
+      void* tmq = taosArenaScratchMalloc(offset->primaryKey.nData + VARSTR_HEADER_SIZE);
       QUERY_CHECK_NULL(tmq, code, lino, _end, terrno);
       memcpy(varDataVal(tmq), offset->primaryKey.pData, offset->primaryKey.nData);
       varDataLen(tmq) = offset->primaryKey.nData;
       p[i] = (*ts > offset->ts) || (func(data, tmq) > 0);
-      taosMemoryFree(tmq);
+      taosArenaScratchFree(tmq);
     } else {
       p[i] = (*ts > offset->ts) || (func(data, VALUE_GET_DATUM(&offset->primaryKey, pColPk->info.type)) > 0);
     }
@@ -1864,7 +2218,7 @@ static int32_t doBlockDataPrimaryKeyFilter(SSDataBlock* pBlock, STqOffsetVal* of
   }
 
 _end:
-  taosMemoryFree(p);
+  taosArenaScratchFree(p);
   if (code != TSDB_CODE_SUCCESS) {
     qError("%s failed at line %d since %s", __func__, lino, tstrerror(code));
   }
@@ -4250,6 +4604,9 @@ void startGroupTableMergeScan(SOperatorInfo* pOperator) {
     pAPI->tsdReader.tsdSetFilesetDelimited(pInfo->base.dataReader);
   }
   pAPI->tsdReader.tsdSetSetNotifyCb(pInfo->base.dataReader, tableMergeScanTsdbNotifyCb, pInfo);
+  if (pOperator->exprSupp.pFilterInfo != NULL) {
+    pAPI->tsdReader.tsdSetBlockFilter(pInfo->base.dataReader, doFilterReadAheadBlock, pOperator->exprSupp.pFilterInfo);
+  }
 
   code = startDurationForGroupTableMergeScan(pOperator);
   QUERY_CHECK_CODE(code, lino, _end);
@@ -20,12 +20,14 @@
 #include "tcompare.h"
 #include "tdatablock.h"
 #include "tdef.h"
+#include "tglobal.h"
 #include "theap.h"
 #include "tlosertree.h"
 #include "tpagedbuf.h"
 #include "tsimplehash.h"
 #include "tsort.h"
 #include "tutil.h"
+#include "tworker.h"
 
 #define AllocatedTupleType  0
 #define ReferencedTupleType 1  // tuple references to one row in pDataBlock
@@ -90,6 +92,7 @@ struct SSortHandle {
   int8_t            closed;
   const char*       idStr;
   bool              inMemSort;
+  int32_t           inMemSortMethod;  // SORT_QSORT_T or SORT_RADIX_T, used by the last in-memory block sort
   bool              needAdjust;
   STupleHandle      tupleHandle;
   void*             param;
@@ -297,6 +300,7 @@ int32_t tsortCreateSortHandle(SArray* pSortInfo, int32_t type, int32_t pageSize,
   QUERY_CHECK_NULL(pSortHandle->pSortInfo, code, lino, _err, terrno);
 
   pSortHandle->loops = 0;
+  pSortHandle->inMemSortMethod = SORT_QSORT_T;
   pSortHandle->pqMaxTupleLength = pqMaxTupleLength;
   if (pqMaxRows != 0) {
     pSortHandle->pqSortBufSize = pqSortBufSize;
@@ -2436,6 +2440,525 @@ static void freeSortSource(void* p) {
   taosMemoryFreeClear(*pSource);
 }
 
+// parallel sort ----------
+
+#define TSORT_PAR_MIN_ROWS   8192  // rows of a slice worth handing over to a sort worker
+#define TSORT_PAR_MAX_SLICES 16
+#define TSORT_PAR_SAMPLES    16  // rows sampled from each sorted slice to choose the partition splitters
+
+/*
+ * A block is sorted in parallel as slices of rows, each sorted by blockDataSortEx on its own. A block kept in memory
+ * is then merged back by partitions: splitter keys are chosen from rows sampled from all slices, so partition p holds
+ * the rows between splitter p and p + 1 of every slice, and the partitions are merged independently and concatenated.
+ * A block flushed to the disk buffer does not need the merge, each slice becomes a sorted run of its own.
+ */
+typedef struct SSortParCtx {
+  SSDataBlock*  pSrc;         // the rows to sort, read concurrently while the slices are extracted
+  SArray*       pOrderInfo;   // the order columns with compFn set, each item works on its own copy
+  int32_t       numOfSlices;  //
+  SSDataBlock** pSlices;      //
+  SSDataBlock** pParts;       // merged partitions
+  int32_t*      pBounds;      // first row of each partition in each slice, numOfSlices * (numOfSlices + 1)
+  int32_t       sortMethod;   // used for the first slice
+} SSortParCtx;
+
+typedef int32_t (*__sort_par_fn_t)(SSortParCtx* pCtx, int32_t idx, SArray* pOrderInfo);
+
+/*
+ * The items of a job are taken one by one by the sorting task and the sort workers. The task always takes part, so
+ * the job makes progress even if every worker is busy, and it returns when all items are done. A worker starting
+ * after that finds nothing to do, so the job itself is reference counted and freed by the last one leaving it.
+ */
+typedef struct SSortParJob {
+  int32_t         ref;
+  int32_t         numOfItems;
+  int32_t         nextItem;
+  int32_t         doneItems;
+  int32_t         code;         // the first failure
+  tsem_t          done;         // posted when the last item is done
+  void*           pMemSession;  // memory pool session of the sorting task, used by the workers running an item
+  __sort_par_fn_t fp;
+  SSortParCtx*    pCtx;
+} SSortParJob;
+
+static SQWorkerPool sortWorkerPool = {0};
+static STaosQueue*  sortWorkerQueue = NULL;
+static SRWLatch     sortWorkerPoolLock = 0;
+static int8_t       sortWorkerPoolInited = 0;  // the pool is started by the first parallel sort
+
+// the pool and the jobs outlive the query, their memory must not be charged to the query memory pool session
+static void* tsortSetMemSession(void* pSession) {
+#if !defined(BUILD_TEST) && !defined(TD_ASTRA)
+  void* pPrev = threadPoolSession;
+  threadPoolSession = pSession;
+  return pPrev;
+#else
+  return NULL;
+#endif
+}
+
+static void tsortParJobRelease(SSortParJob* pJob) {
+  if (atomic_sub_fetch_32(&pJob->ref, 1) == 0) {
+    (void)tsem_destroy(&pJob->done);
+    taosMemoryFree(pJob);
+  }
+}
+
+static void tsortParJobRun(SSortParJob* pJob, bool isWorker) {
+  while (1) {
+    int32_t idx = atomic_fetch_add_32(&pJob->nextItem, 1);
+    if (idx >= pJob->numOfItems) {
+      break;
+    }
+
+    if (isWorker) {
+      (void)tsortSetMemSession(pJob->pMemSession);
+    }
+
+    // blockDataSortEx writes the order info, and nothing allocated for the task may be left once the item is done
+    int32_t code = TSDB_CODE_SUCCESS;
+    SArray* pOrderInfo = taosArrayDup(pJob->pCtx->pOrderInfo, NULL);
+    if (pOrderInfo == NULL) {
+      code = terrno;
+    } else if (atomic_load_32(&pJob->code) == TSDB_CODE_SUCCESS) {
+      code = pJob->fp(pJob->pCtx, idx, pOrderInfo);
+    }
+    taosArrayDestroy(pOrderInfo);
+
+    if (isWorker) {
+      (void)tsortSetMemSession(NULL);
+    }
+
+    if (code != TSDB_CODE_SUCCESS) {
+      (void)atomic_val_compare_exchange_32(&pJob->code, TSDB_CODE_SUCCESS, code);
+    }
+    if (atomic_add_fetch_32(&pJob->doneItems, 1) == pJob->numOfItems) {
+      (void)tsem_post(&pJob->done);
+    }
+  }
+}
+
+static void tsortParWorkerFp(SQueueInfo* pInfo, void* pItem) {
+  SSortParJob* pJob = *(SSortParJob**)pItem;
+  taosFreeQitem(pItem);
+
+  tsortParJobRun(pJob, true);
+  tsortParJobRelease(pJob);
+}
+
+void tsortCleanupWorkerPool(void) {
+  taosWLockLatch(&sortWorkerPoolLock);
+  if (sortWorkerPoolInited) {
+    if (sortWorkerQueue != NULL) {
+      // the workers are stopped first, the items left in the queue still hold a reference to their jobs
+      tQWorkerCleanup(&sortWorkerPool);
+      while (1) {
+        void* pItem = NULL;
+        taosReadQitem(sortWorkerQueue, &pItem);
+        if (pItem == NULL) {
+          break;
+        }
+        SSortParJob* pJob = *(SSortParJob**)pItem;
+        taosFreeQitem(pItem);
+        tsortParJobRelease(pJob);
+      }
+      tQWorkerFreeQueue(&sortWorkerPool, sortWorkerQueue);
+      sortWorkerQueue = NULL;
+    }
+    atomic_store_8(&sortWorkerPoolInited, 0);
+  }
+  taosWUnLockLatch(&sortWorkerPoolLock);
+}
+
+static void tsortInitWorkerPool() {
+  void* pSession = tsortSetMemSession(NULL);
+
+  sortWorkerPool.name = "sort";
+  sortWorkerPool.min = tsNumOfSortThreads;
+  sortWorkerPool.max = tsNumOfSortThreads;
+  int32_t code = tQWorkerInit(&sortWorkerPool);
+  if (code != TSDB_CODE_SUCCESS) {
+    qError("failed to init sort worker pool since %s", tstrerror(code));
+  } else {
+    sortWorkerQueue = tQWorkerAllocQueue(&sortWorkerPool, NULL, tsortParWorkerFp);
+    if (sortWorkerQueue == NULL) {
+      qError("failed to alloc sort worker queue since %s", tstrerror(terrno));
+      tQWorkerCleanup(&sortWorkerPool);
+    }
+  }
+
+  (void)tsortSetMemSession(pSession);
+}
+
+static int32_t tsortRunParJob(SSortParCtx* pCtx, __sort_par_fn_t fp, int32_t numOfItems) {
+  void*        pSession = tsortSetMemSession(NULL);
+  SSortParJob* pJob = taosMemoryCalloc(1, sizeof(SSortParJob));
+  if (pJob == NULL) {
+    (void)tsortSetMemSession(pSession);
+    return terrno;
+  }
+
+  int32_t code = tsem_init(&pJob->done, 0, 0);
+  if (code != TSDB_CODE_SUCCESS) {
+    taosMemoryFree(pJob);
+    (void)tsortSetMemSession(pSession);
+    return code;
+  }
+
+  pJob->ref = 1;
+  pJob->numOfItems = numOfItems;
+  pJob->pMemSession = pSession;
+  pJob->fp = fp;
+  pJob->pCtx = pCtx;
+
+  // failing to hand the job over to a worker is not an error, the task does the items left
+  taosRLockLatch(&sortWorkerPoolLock);
+  int32_t numOfWorkers = (sortWorkerQueue != NULL) ? TMIN(numOfItems - 1, sortWorkerPool.max) : 0;
+  for (int32_t i = 0; i < numOfWorkers; ++i) {
+    void* pItem = NULL;
+    if (taosAllocateQitem(sizeof(SSortParJob*), DEF_QITEM, 0, &pItem) != TSDB_CODE_SUCCESS) {
+      break;
+    }
+
+    *(SSortParJob**)pItem = pJob;
+    (void)atomic_add_fetch_32(&pJob->ref, 1);
+    if (taosWriteQitem(sortWorkerQueue, pItem) != TSDB_CODE_SUCCESS) {
+      (void)atomic_sub_fetch_32(&pJob->ref, 1);
+      taosFreeQitem(pItem);
+      break;
+    }
+  }
+  taosRUnLockLatch(&sortWorkerPoolLock);
+  (void)tsortSetMemSession(pSession);
+
+  tsortParJobRun(pJob, false);
+  if (atomic_load_32(&pJob->doneItems) < numOfItems) {
+    (void)tsem_wait(&pJob->done);
+  }
+  code = atomic_load_32(&pJob->code);
+
+  pSession = tsortSetMemSession(NULL);
+  tsortParJobRelease(pJob);
+  (void)tsortSetMemSession(pSession);
+  return code;
+}
+
+static int32_t tsortGetNumOfSlices(SSortHandle* pHandle) {
+  SSDataBlock* pBlock = pHandle->pDataBlock;
+  if (tsNumOfSortThreads <= 0 || pBlock->info.rows < TSORT_PAR_MIN_ROWS * 2) {
+    return 1;
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(pHandle->pSortInfo); ++i) {
+    SBlockOrderInfo* pOrder = taosArrayGet(pHandle->pSortInfo, i);
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pOrder->slotId);
+    if (pCol == NULL || pCol->info.type == TSDB_DATA_TYPE_JSON) {
+      return 1;
+    }
+  }
+
+  if (!atomic_load_8(&sortWorkerPoolInited)) {
+    taosWLockLatch(&sortWorkerPoolLock);
+    if (!sortWorkerPoolInited) {
+      // a pool failing to start is not retried, sorts run in the task thread instead
+      tsortInitWorkerPool();
+      atomic_store_8(&sortWorkerPoolInited, 1);
+    }
+    taosWUnLockLatch(&sortWorkerPoolLock);
+  }
+  if (sortWorkerQueue == NULL) {
+    return 1;
+  }
+
+  int32_t numOfSlices = pBlock->info.rows / TSORT_PAR_MIN_ROWS;
+  numOfSlices = TMIN(numOfSlices, sortWorkerPool.max + 1);
+  return TMIN(numOfSlices, TSORT_PAR_MAX_SLICES);
+}
+
+static void tsortDestroyParCtx(SSortParCtx* pCtx) {
+  for (int32_t i = 0; i < pCtx->numOfSlices; ++i) {
+    if (pCtx->pSlices) {
+      blockDataDestroy(pCtx->pSlices[i]);
+    }
+    if (pCtx->pParts) {
+      blockDataDestroy(pCtx->pParts[i]);
+    }
+  }
+
+  taosMemoryFreeClear(pCtx->pSlices);
+  taosMemoryFreeClear(pCtx->pParts);
+  taosMemoryFreeClear(pCtx->pBounds);
+  taosArrayDestroy(pCtx->pOrderInfo);
+  pCtx->pOrderInfo = NULL;
+}
+
+static int32_t tsortComparRows(SSDataBlock* pLeft, int32_t leftIdx, SSDataBlock* pRight, int32_t rightIdx,
+                               SArray* pOrderInfo) {
+  for (int32_t i = 0; i < taosArrayGetSize(pOrderInfo); ++i) {
+    int32_t ret = tsortComparBlockCell(pLeft, pRight, leftIdx, rightIdx, TARRAY_GET_ELEM(pOrderInfo, i));
+    if (ret != 0) {
+      return ret;
+    }
+  }
+  return 0;
+}
+
+static int32_t tsortParSortSlice(SSortParCtx* pCtx, int32_t idx, SArray* pOrderInfo) {
+  int32_t rows = pCtx->pSrc->info.rows;
+  int32_t start = (int64_t)rows * idx / pCtx->numOfSlices;
+  int32_t end = (int64_t)rows * (idx + 1) / pCtx->numOfSlices;
+
+  int32_t code = blockDataExtractBlock(pCtx->pSrc, start, end - start, &pCtx->pSlices[idx]);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  int32_t sortMethod = SORT_QSORT_T;
+  code = blockDataSortEx(pCtx->pSlices[idx], pOrderInfo, &sortMethod);
+  if (idx == 0) {
+    pCtx->sortMethod = sortMethod;
+  }
+  return code;
+}
+
+static int32_t tsortParMergePart(SSortParCtx* pCtx, int32_t part, SArray* pOrderInfo) {
+  int32_t numOfSlices = pCtx->numOfSlices;
+  int32_t pos[TSORT_PAR_MAX_SLICES] = {0};
+  int32_t end[TSORT_PAR_MAX_SLICES] = {0};
+  int32_t rows = 0;
+
+  for (int32_t i = 0; i < numOfSlices; ++i) {
+    pos[i] = pCtx->pBounds[i * (numOfSlices + 1) + part];
+    end[i] = pCtx->pBounds[i * (numOfSlices + 1) + part + 1];
+    rows += end[i] - pos[i];
+  }
+
+  int32_t code = createOneDataBlock(pCtx->pSlices[0], false, &pCtx->pParts[part]);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  SSDataBlock* pPart = pCtx->pParts[part];
+  code = blockDataEnsureCapacity(pPart, rows);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  // the slices are few, a linear scan of their heads is cheaper than maintaining a tree
+  while (1) {
+    int32_t min = -1;
+    for (int32_t i = 0; i < numOfSlices; ++i) {
+      if (pos[i] < end[i] &&
+          (min < 0 || tsortComparRows(pCtx->pSlices[i], pos[i], pCtx->pSlices[min], pos[min], pOrderInfo) < 0)) {
+        min = i;
+      }
+    }
+
+    if (min < 0) {
+      break;
+    }
+
+    code = appendOneRowToDataBlock(pPart, pCtx->pSlices[min], &pos[min]);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+typedef struct SSortParSample {
+  int32_t slice;
+  int32_t row;
+} SSortParSample;
+
+static int32_t tsortParSampleCompar(const void* p1, const void* p2, const void* param) {
+  const SSortParCtx*    pCtx = param;
+  const SSortParSample* pLeft = p1;
+  const SSortParSample* pRight = p2;
+  return tsortComparRows(pCtx->pSlices[pLeft->slice], pLeft->row, pCtx->pSlices[pRight->slice], pRight->row,
+                         pCtx->pOrderInfo);
+}
+
+// choose the splitters among rows sampled evenly from the sorted slices, and find where they split each slice
+static int32_t tsortSplitSlices(SSortParCtx* pCtx) {
+  int32_t         numOfSlices = pCtx->numOfSlices;
+  int32_t         numOfSamples = numOfSlices * TSORT_PAR_SAMPLES;
+  SSortParSample* pSamples = taosMemoryMalloc(numOfSamples * sizeof(SSortParSample));
+  if (pSamples == NULL) {
+    return terrno;
+  }
+
+  pCtx->pBounds = taosMemoryCalloc(numOfSlices * (numOfSlices + 1), sizeof(int32_t));
+  if (pCtx->pBounds == NULL) {
+    taosMemoryFree(pSamples);
+    return terrno;
+  }
+
+  for (int32_t i = 0; i < numOfSlices; ++i) {
+    int32_t rows = pCtx->pSlices[i]->info.rows;
+    for (int32_t j = 0; j < TSORT_PAR_SAMPLES; ++j) {
+      pSamples[i * TSORT_PAR_SAMPLES + j] =
+          (SSortParSample){.slice = i, .row = (int64_t)rows * (2 * j + 1) / (2 * TSORT_PAR_SAMPLES)};
+    }
+  }
+
+  taosqsort_r(pSamples, numOfSamples, sizeof(SSortParSample), pCtx, tsortParSampleCompar);
+
+  for (int32_t i = 0; i < numOfSlices; ++i) {
+    SSDataBlock* pSlice = pCtx->pSlices[i];
+    int32_t*     pBound = pCtx->pBounds + i * (numOfSlices + 1);
+
+    pBound[numOfSlices] = pSlice->info.rows;
+    for (int32_t p = 1; p < numOfSlices; ++p) {
+      // the first row not less than the splitter, so rows equal to a splitter go to the same partition
+      SSortParSample* pSplitter = &pSamples[p * TSORT_PAR_SAMPLES];
+      int32_t         lo = pBound[p - 1];
+      int32_t         hi = pSlice->info.rows;
+      while (lo < hi) {
+        int32_t mid = lo + (hi - lo) / 2;
+        if (tsortComparRows(pSlice, mid, pCtx->pSlices[pSplitter->slice], pSplitter->row, pCtx->pOrderInfo) < 0) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+      pBound[p] = lo;
+    }
+  }
+
+  taosMemoryFree(pSamples);
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t tsortSortSlices(SSortHandle* pHandle, SSortParCtx* pCtx, int32_t numOfSlices) {
+  SSDataBlock* pBlock = pHandle->pDataBlock;
+
+  pCtx->pSrc = pBlock;
+  pCtx->numOfSlices = numOfSlices;
+  pCtx->pOrderInfo = taosArrayDup(pHandle->pSortInfo, NULL);
+  if (pCtx->pOrderInfo == NULL) {
+    return terrno;
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(pCtx->pOrderInfo); ++i) {
+    SBlockOrderInfo* pOrder = taosArrayGet(pCtx->pOrderInfo, i);
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pOrder->slotId);
+    pOrder->compFn = getKeyComparFunc(pCol->info.type, pOrder->order);
+  }
+
+  pCtx->pSlices = taosMemoryCalloc(numOfSlices, sizeof(SSDataBlock*));
+  if (pCtx->pSlices == NULL) {
+    return terrno;
+  }
+
+  int32_t code = tsortRunParJob(pCtx, tsortParSortSlice, numOfSlices);
+  if (code == TSDB_CODE_SUCCESS) {
+    blockDataCleanup(pBlock);
+  }
+  return code;
+}
+
+// sort pHandle->pDataBlock that is kept in memory
+static int32_t tsortSortInMem(SSortHandle* pHandle) {
+  int32_t     code = 0;
+  int32_t     lino = 0;
+  SSortParCtx ctx = {0};
+  int64_t     st = taosGetTimestampUs();
+
+  int32_t numOfSlices = tsortGetNumOfSlices(pHandle);
+  if (numOfSlices <= 1) {
+    code = blockDataSortEx(pHandle->pDataBlock, pHandle->pSortInfo, &pHandle->inMemSortMethod);
+    QUERY_CHECK_CODE(code, lino, _end);
+  } else {
+    int64_t rows = pHandle->pDataBlock->info.rows;
+    code = tsortSortSlices(pHandle, &ctx, numOfSlices);
+    QUERY_CHECK_CODE(code, lino, _end);
+
+    // the slices hold all rows now, give back the buffers of the input block instead of keeping them for reuse, so
+    // that no more than two copies of the data are alive at any time
+    SSDataBlock* pOutput = NULL;
+    code = createOneDataBlock(pHandle->pDataBlock, false, &pOutput);
+    QUERY_CHECK_CODE(code, lino, _end);
+    blockDataDestroy(pHandle->pDataBlock);
+    pHandle->pDataBlock = pOutput;
+
+    code = tsortSplitSlices(&ctx);
+    QUERY_CHECK_CODE(code, lino, _end);
+
+    ctx.pParts = taosMemoryCalloc(numOfSlices, sizeof(SSDataBlock*));
+    QUERY_CHECK_NULL(ctx.pParts, code, lino, _end, terrno);
+
+    code = tsortRunParJob(&ctx, tsortParMergePart, numOfSlices);
+    QUERY_CHECK_CODE(code, lino, _end);
+
+    for (int32_t i = 0; i < numOfSlices; ++i) {
+      blockDataDestroy(ctx.pSlices[i]);
+      ctx.pSlices[i] = NULL;
+    }
+
+    // each part is released as soon as it is copied to the output
+    code = blockDataEnsureCapacity(pOutput, rows);
+    QUERY_CHECK_CODE(code, lino, _end);
+    for (int32_t i = 0; i < numOfSlices; ++i) {
+      code = blockDataMerge(pOutput, ctx.pParts[i]);
+      QUERY_CHECK_CODE(code, lino, _end);
+      blockDataDestroy(ctx.pParts[i]);
+      ctx.pParts[i] = NULL;
+    }
+    pHandle->inMemSortMethod = ctx.sortMethod;
+  }
+
+  if (pHandle->pqMaxRows > 0) blockDataKeepFirstNRows(pHandle->pDataBlock, pHandle->pqMaxRows);
+  pHandle->sortElapsed += (taosGetTimestampUs() - st);
+
+  qDebug("%s in-memory sort of %" PRId64 " rows in %d slices", pHandle->idStr, pHandle->pDataBlock->info.rows,
+         numOfSlices);
+
+_end:
+  if (code != TSDB_CODE_SUCCESS) {
+    qError("%s %s failed at line %d since %s", pHandle->idStr, __func__, lino, tstrerror(code));
+  }
+  tsortDestroyParCtx(&ctx);
+  return code;
+}
+
+// sort pHandle->pDataBlock and flush it into the disk buffer as sorted runs
+static int32_t tsortSortToBuf(SSortHandle* pHandle) {
+  int32_t     code = 0;
+  int32_t     lino = 0;
+  SSortParCtx ctx = {0};
+  int64_t     st = taosGetTimestampUs();
+
+  int32_t numOfSlices = tsortGetNumOfSlices(pHandle);
+  if (numOfSlices <= 1) {
+    code = blockDataSort(pHandle->pDataBlock, pHandle->pSortInfo);
+    QUERY_CHECK_CODE(code, lino, _end);
+    pHandle->sortElapsed += (taosGetTimestampUs() - st);
+
+    if (pHandle->pqMaxRows > 0) blockDataKeepFirstNRows(pHandle->pDataBlock, pHandle->pqMaxRows);
+    code = doAddToBuf(pHandle->pDataBlock, pHandle);
+    QUERY_CHECK_CODE(code, lino, _end);
+  } else {
+    code = tsortSortSlices(pHandle, &ctx, numOfSlices);
+    QUERY_CHECK_CODE(code, lino, _end);
+    pHandle->sortElapsed += (taosGetTimestampUs() - st);
+
+    for (int32_t i = 0; i < numOfSlices; ++i) {
+      if (pHandle->pqMaxRows > 0) blockDataKeepFirstNRows(ctx.pSlices[i], pHandle->pqMaxRows);
+      code = doAddToBuf(ctx.pSlices[i], pHandle);
+      QUERY_CHECK_CODE(code, lino, _end);
+    }
+  }
+
+_end:
+  if (code != TSDB_CODE_SUCCESS) {
+    qError("%s %s failed at line %d since %s", pHandle->idStr, __func__, lino, tstrerror(code));
+  }
+  tsortDestroyParCtx(&ctx);
+  return code;
+}
+
 static int32_t createBlocksQuickSortInitialSources(SSortHandle* pHandle) {
   int32_t       code = 0;
   int32_t       lino = 0;
@@ -2461,8 +2984,10 @@ static int32_t createBlocksQuickSortInitialSources(SSortHandle* pHandle) {
       uint32_t numOfCols = taosArrayGetSize(pBlock->pDataBlock);
       pHandle->pageSize = getProperSortPageSize(blockDataGetRowSize(pBlock), numOfCols);
 
-      // todo, number of pages are set according to the total available sort buffer
-      pHandle->numOfPages = 1024;
+      // todo, number of pages are set according to the total available sort buffer, unless given by the caller
+      if (pHandle->numOfPages <= 0) {
+        pHandle->numOfPages = 1024;
+      }
       sortBufSize = pHandle->numOfPages * pHandle->pageSize;
       code = createOneDataBlock(pBlock, false, &pHandle->pDataBlock);
       QUERY_CHECK_CODE(code, lino, _end);
@@ -2478,14 +3003,7 @@ static int32_t createBlocksQuickSortInitialSources(SSortHandle* pHandle) {
     size_t size = blockDataGetSize(pHandle->pDataBlock);
     if (size > sortBufSize) {
       // Perform the in-memory sort and then flush data in the buffer into disk.
-      int64_t st = taosGetTimestampUs();
-      code = blockDataSort(pHandle->pDataBlock, pHandle->pSortInfo);
-      QUERY_CHECK_CODE(code, lino, _end);
-
-      pHandle->sortElapsed += (taosGetTimestampUs() - st);
-
-      if (pHandle->pqMaxRows > 0) blockDataKeepFirstNRows(pHandle->pDataBlock, pHandle->pqMaxRows);
-      code = doAddToBuf(pHandle->pDataBlock, pHandle);
+      code = tsortSortToBuf(pHandle);
       QUERY_CHECK_CODE(code, lino, _end);
     }
   }
@@ -2493,16 +3011,11 @@ static int32_t createBlocksQuickSortInitialSources(SSortHandle* pHandle) {
   if (pHandle->pDataBlock != NULL && pHandle->pDataBlock->info.rows > 0) {
     size_t size = blockDataGetSize(pHandle->pDataBlock);
 
-    // Perform the in-memory sort and then flush data in the buffer into disk.
-    int64_t st = taosGetTimestampUs();
-    code = blockDataSort(pHandle->pDataBlock, pHandle->pSortInfo);
-    QUERY_CHECK_CODE(code, lino, _end);
-
-    if (pHandle->pqMaxRows > 0) blockDataKeepFirstNRows(pHandle->pDataBlock, pHandle->pqMaxRows);
-    pHandle->sortElapsed += (taosGetTimestampUs() - st);
-
     // All sorted data can fit in memory, external memory sort is not needed. Return to directly
     if (size <= sortBufSize && pHandle->pBuf == NULL) {
+      code = tsortSortInMem(pHandle);
+      QUERY_CHECK_CODE(code, lino, _end);
+
       pHandle->cmpParam.numOfSources = 1;
       pHandle->inMemSort = true;
 
@@ -2510,7 +3023,8 @@ static int32_t createBlocksQuickSortInitialSources(SSortHandle* pHandle) {
       pHandle->tupleHandle.rowIndex = -1;
       pHandle->tupleHandle.pBlock = pHandle->pDataBlock;
     } else {
-      code = doAddToBuf(pHandle->pDataBlock, pHandle);
+      // Perform the in-memory sort and then flush data in the buffer into disk.
+      code = tsortSortToBuf(pHandle);
     }
   }
 
@@ -2960,7 +3474,7 @@ SSortExecInfo tsortGetSortExecInfo(SSortHandle* pHandle) {
     info.sortBuffer = 2 * 1048576;   // 2mb by default
   } else {
     info.sortBuffer = pHandle->pageSize * pHandle->numOfPages;
-    info.sortMethod = pHandle->inMemSort ? SORT_QSORT_T : SORT_SPILLED_MERGE_SORT_T;
+    info.sortMethod = pHandle->inMemSort ? pHandle->inMemSortMethod : SORT_SPILLED_MERGE_SORT_T;
     info.loops = pHandle->loops;
 
     if (pHandle->pBuf != NULL) {
@@ -1,6 +1,139 @@
 #include "gtest/gtest.h"
+#include <vector>
 
 #include "executil.h"
+#include "executor.h"
+#include "tdatablock.h"
+#include "tglobal.h"
+#include "tsort.h"
+
+namespace {
+
+typedef struct {
+  std::vector<SSDataBlock *> blocks;
+  size_t                     next;
+} SSortTestSource;
+
+int32_t sortTestFetch(void *param, SSDataBlock **ppBlock) {
+  SSortTestSource *pSource = (SSortTestSource *)param;
+  *ppBlock = (pSource->next < pSource->blocks.size()) ? pSource->blocks[pSource->next++] : nullptr;
+  return TSDB_CODE_SUCCESS;
+}
+
+// every row carries a payload derived from its key, so that rows torn apart by the sort are noticed
+int64_t sortTestPayload(int64_t key) { return key * 3 + 1; }
+
+void sortTestCreateBlocks(SSortTestSource *pSource, int32_t numOfBlocks, int32_t rows) {
+  for (int32_t i = 0; i < numOfBlocks; ++i) {
+    SSDataBlock *pBlock = nullptr;
+    ASSERT_EQ(createDataBlock(&pBlock), 0);
+    SColumnInfoData keyCol = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 1);
+    SColumnInfoData payloadCol = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 2);
+    ASSERT_EQ(blockDataAppendColInfo(pBlock, &keyCol), 0);
+    ASSERT_EQ(blockDataAppendColInfo(pBlock, &payloadCol), 0);
+    ASSERT_EQ(blockDataEnsureCapacity(pBlock, rows), 0);
+
+    SColumnInfoData *pKey = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 0);
+    SColumnInfoData *pPayload = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 1);
+    for (int32_t r = 0; r < rows; ++r) {
+      if ((i * rows + r) % 997 == 0) {
+        colDataSetNULL(pKey, r);
+        colDataSetNULL(pPayload, r);
+      } else {
+        int64_t key = taosRand() % 5000;  // plenty of duplicates across the slices
+        int64_t payload = sortTestPayload(key);
+        ASSERT_EQ(colDataSetVal(pKey, r, (const char *)&key, false), 0);
+        ASSERT_EQ(colDataSetVal(pPayload, r, (const char *)&payload, false), 0);
+      }
+    }
+    pBlock->info.rows = rows;
+    pSource->blocks.push_back(pBlock);
+  }
+}
+
+// numOfPages of the sort buffer, -1 for the default one that keeps all the rows in memory
+void sortTestRun(int32_t order, int32_t numOfBlocks = 5, int32_t rows = 8000, int32_t numOfPages = -1) {
+  SSortTestSource source = {};
+  sortTestCreateBlocks(&source, numOfBlocks, rows);
+
+  SBlockOrderInfo orderInfo = {0};
+  orderInfo.slotId = 0;
+  orderInfo.order = order;
+  orderInfo.nullFirst = (order == TSDB_ORDER_ASC);
+  SArray *pOrderInfo = taosArrayInit(1, sizeof(SBlockOrderInfo));
+  ASSERT_NE(taosArrayPush(pOrderInfo, &orderInfo), nullptr);
+
+  SSortHandle *pHandle = nullptr;
+  ASSERT_EQ(tsortCreateSortHandle(pOrderInfo, SORT_SINGLESOURCE_SORT, -1, numOfPages, NULL, "sort_test", 0, 0, 0, &pHandle),
+            0);
+  tsortSetFetchRawDataFp(pHandle, sortTestFetch, NULL, NULL);
+
+  SSortSource *pSource = (SSortSource *)taosMemoryCalloc(1, sizeof(SSortSource));
+  ASSERT_NE(pSource, nullptr);
+  pSource->param = &source;
+  pSource->onlyRef = true;
+  ASSERT_EQ(tsortAddSource(pHandle, pSource), 0);
+  ASSERT_EQ(tsortOpen(pHandle), 0);
+
+  int32_t numOfRows = 0;
+  int32_t numOfNulls = 0;
+  bool    hasPrev = false;
+  int64_t prev = 0;
+  while (1) {
+    STupleHandle *pTuple = nullptr;
+    ASSERT_EQ(tsortNextTuple(pHandle, &pTuple), 0);
+    if (pTuple == nullptr) {
+      break;
+    }
+
+    numOfRows++;
+    if (tsortIsNullVal(pTuple, 0)) {
+      // nulls are all at the head in ascending order and at the tail in descending order
+      EXPECT_EQ(hasPrev, order == TSDB_ORDER_DESC);
+      EXPECT_TRUE(tsortIsNullVal(pTuple, 1));
+      numOfNulls++;
+      continue;
+    }
+
+    if (order == TSDB_ORDER_DESC) {
+      EXPECT_EQ(numOfNulls, 0);
+    }
+    void *pKey = nullptr;
+    void *pPayload = nullptr;
+    tsortGetValue(pTuple, 0, &pKey);
+    tsortGetValue(pTuple, 1, &pPayload);
+    int64_t key = *(int64_t *)pKey;
+    EXPECT_EQ(*(int64_t *)pPayload, sortTestPayload(key));
+    if (hasPrev) {
+      if (order == TSDB_ORDER_ASC) {
+        ASSERT_LE(prev, key);
+      } else {
+        ASSERT_GE(prev, key);
+      }
+    }
+    hasPrev = true;
+    prev = key;
+  }
+
+  EXPECT_EQ(numOfRows, numOfBlocks * rows);
+  EXPECT_EQ(numOfNulls, (numOfBlocks * rows + 996) / 997);
+
+  SSortExecInfo info = tsortGetSortExecInfo(pHandle);
+  if (numOfPages > 0) {
+    EXPECT_EQ(info.sortMethod, SORT_SPILLED_MERGE_SORT_T);
+    EXPECT_GT(info.writeBytes, 0);
+  } else {
+    EXPECT_NE(info.sortMethod, SORT_SPILLED_MERGE_SORT_T);
+  }
+
+  tsortDestroySortHandle(pHandle);
+  taosArrayDestroy(pOrderInfo);
+  for (SSDataBlock *pBlock : source.blocks) {
+    blockDataDestroy(pBlock);
+  }
+}
+
+}  // namespace
 
 TEST(execUtilTest, resRowTest) {
   SDiskbasedBuf *pBuf = nullptr;
@@ -33,3 +166,28 @@ TEST(execUtilTest, resRowTest) {
 
   destroyDiskbasedBuf(pBuf);
 }
+
+TEST(execUtilTest, parallelSortTest) {
+  // the input is split into slices sorted by the sort workers and merged by partitions
+  tsNumOfSortThreads = 2;
+  sortTestRun(TSDB_ORDER_ASC);
+  sortTestRun(TSDB_ORDER_DESC);
+
+  // the workers are started again after they are cleaned up
+  qCleanupSharedRes();
+  sortTestRun(TSDB_ORDER_ASC);
+  qCleanupSharedRes();
+}
+
+TEST(execUtilTest, parallelSortToBufTest) {
+  // a block is larger than the sort buffer of 64 pages, so each one is sorted in slices and flushed as sorted runs,
+  // which are merged from the disk buffer
+  if (tsTempDir[0] == 0) {
+    tstrncpy(tsTempDir, TD_TMP_DIR_PATH, PATH_MAX);
+  }
+  ASSERT_EQ(taosGetDiskSize(tsTempDir, &tsTempSpace.size), 0);
+  tsNumOfSortThreads = 2;
+  sortTestRun(TSDB_ORDER_ASC, 4, 40000, 64);
+  sortTestRun(TSDB_ORDER_DESC, 4, 40000, 64);
+  qCleanupSharedRes();
+}
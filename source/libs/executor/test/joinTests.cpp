@@ -42,6 +42,7 @@
 #include "stub.h"
 #include "querytask.h"
 #include "hashjoin.h"
+#include "tbloomfilter.h"
 
 
 namespace {
@@ -3787,6 +3788,90 @@ TEST(functionsTest, branch) {
 }
 #endif
 
+#if 1
+TEST(hashJoinTest, rtFilterRebuild) {
+  SOperatorInfo      op = {0};
+  SOperatorInfo      scan = {0};
+  SOperatorInfo*     downstream[2] = {&scan, &scan};
+  SHJoinOperatorInfo join;
+  SHJoinColInfo      buildKey = {0};
+  SHJoinColInfo      probeKey = {0};
+  SGroupData         group = {0};
+  int64_t            keys[] = {100, 300, 200};
+  int64_t            missKey = 250;
+
+  memset(&join, 0, sizeof(join));
+  op.info = &join;
+  op.pDownstream = downstream;
+  op.numOfDownstream = 2;
+  scan.operatorType = QUERY_NODE_PHYSICAL_PLAN_TABLE_SCAN;
+
+  join.joinType = JOIN_TYPE_INNER;
+  join.subType = JOIN_STYPE_NONE;
+  join.pBuild = &join.tbs[0];
+  join.pProbe = &join.tbs[1];
+  join.pProbe->downStreamIdx = 1;
+  buildKey.type = probeKey.type = TSDB_DATA_TYPE_TIMESTAMP;
+  buildKey.bytes = probeKey.bytes = sizeof(int64_t);
+  probeKey.srcSlot = 2;
+  join.pBuild->keyNum = join.pProbe->keyNum = 1;
+  join.pBuild->keyCols = &buildKey;
+  join.pProbe->keyCols = &probeKey;
+
+  join.pKeyHash = tSimpleHashInit(16, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY));
+  ASSERT_NE(join.pKeyHash, nullptr);
+  for (int32_t i = 0; i < sizeof(keys) / sizeof(keys[0]); ++i) {
+    ASSERT_EQ(tSimpleHashPut(join.pKeyHash, &keys[i], sizeof(int64_t), &group, sizeof(group)), 0);
+  }
+
+  // the first build pushes the range and the bloom filter of the keys
+  ASSERT_EQ(hJoinBuildRtFilter(&op), 0);
+  ASSERT_NE(join.pRtFilterParam, nullptr);
+  STableScanRtFilter* pFilter = ((STableScanOperatorParam*)join.pRtFilterParam->value)->pRtFilter;
+  ASSERT_NE(pFilter, nullptr);
+  ASSERT_EQ(pFilter->slotId, 2);
+  ASSERT_TRUE(pFilter->hasRange);
+  ASSERT_EQ(pFilter->min, 100);
+  ASSERT_EQ(pFilter->max, 300);
+  ASSERT_NE(pFilter->pBloom, nullptr);
+  for (int32_t i = 0; i < sizeof(keys) / sizeof(keys[0]); ++i) {
+    ASSERT_FALSE(tBlockBloomFilterNoContain(pFilter->pBloom, &keys[i], sizeof(int64_t)));
+  }
+  JT_PRINTF("missing key %" PRId64 " passes the bloom filter:%d\n", missKey,
+            !tBlockBloomFilterNoContain(pFilter->pBloom, &missKey, sizeof(int64_t)));
+  ASSERT_TRUE(join.rtFilterPushed);
+
+  // taken by the scan
+  freeOperatorParam(join.pRtFilterParam, OP_GET_PARAM);
+  join.pRtFilterParam = NULL;
+
+  // the rebuild spills and builds no filter, the one pushed before is cleared by an empty one
+  join.spill.enabled = true;
+  ASSERT_EQ(hJoinBuildRtFilter(&op), 0);
+  ASSERT_NE(join.pRtFilterParam, nullptr);
+  pFilter = ((STableScanOperatorParam*)join.pRtFilterParam->value)->pRtFilter;
+  ASSERT_NE(pFilter, nullptr);
+  ASSERT_FALSE(pFilter->hasRange);
+  ASSERT_EQ(pFilter->pBloom, nullptr);
+  ASSERT_FALSE(join.rtFilterPushed);
+  freeOperatorParam(join.pRtFilterParam, OP_GET_PARAM);
+  join.pRtFilterParam = NULL;
+
+  // nothing left to clear
+  ASSERT_EQ(hJoinBuildRtFilter(&op), 0);
+  ASSERT_EQ(join.pRtFilterParam, nullptr);
+
+  // keys of different types are not comparable
+  join.spill.enabled = false;
+  buildKey.type = TSDB_DATA_TYPE_INT;
+  buildKey.bytes = sizeof(int32_t);
+  ASSERT_EQ(hJoinBuildRtFilter(&op), 0);
+  ASSERT_EQ(join.pRtFilterParam, nullptr);
+
+  tSimpleHashCleanup(join.pKeyHash);
+}
+#endif
+
 
 int main(int argc, char** argv) {
   taosSeedRand(taosGetTimestampSec());
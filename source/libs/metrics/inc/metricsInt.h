@@ -34,6 +34,8 @@ extern "C" {
 
 #define VNODE_WRITE_METRIC "write_metrics"
 #define DNODE_METRIC       "dnodes_metrics"
+#define QWORKER_METRIC     "query_worker_metrics"
+#define VNODE_QUERY_METRIC "query_metrics"
 
 // Metric name definitions following monFramework.c pattern
 #define WRITE_TABLE                   "taosd_write_metrics"
@@ -56,6 +58,11 @@ extern "C" {
 #define WRITE_MERGE_TIME              WRITE_TABLE ":merge_time"
 #define WRITE_LAST_CACHE_COMMIT_TIME  WRITE_TABLE ":last_cache_commit_time"
 #define WRITE_LAST_CACHE_COMMIT_COUNT WRITE_TABLE ":last_cache_commit_count"
+#define WRITE_COMMIT_FSET_COUNT       WRITE_TABLE ":commit_fset_count"
+#define WRITE_COMMIT_FSET_TIME        WRITE_TABLE ":commit_fset_time"
+// write amplification is (commit_write_bytes + merge_write_bytes) / commit_write_bytes
+#define WRITE_COMMIT_WRITE_BYTES      WRITE_TABLE ":commit_write_bytes"
+#define WRITE_MERGE_WRITE_BYTES       WRITE_TABLE ":merge_write_bytes"
 
 #define DNODE_TABLE                    "taosd_dnodes_metrics"
 #define DNODE_RPC_QUEUE_MEMORY_ALLOWED DNODE_TABLE ":rpc_queue_memory_allowed"
@@ -63,6 +70,15 @@ extern "C" {
 #define DNODE_APPLY_MEMORY_ALLOWED     DNODE_TABLE ":apply_memory_allowed"
 #define DNODE_APPLY_MEMORY_USED        DNODE_TABLE ":apply_memory_used"
 
+#define QUERY_TABLE              "taosd_query_metrics"
+#define QUERY_BLOCK_CACHE_HITS   QUERY_TABLE ":block_cache_hits"
+#define QUERY_BLOCK_CACHE_MISSES QUERY_TABLE ":block_cache_misses"
+
+#define QWORKER_TABLE       "taosd_query_worker_metrics"
+#define QWORKER_RUN_COUNT   QWORKER_TABLE ":run_count"
+#define QWORKER_STEAL_COUNT QWORKER_TABLE ":steal_count"
+#define QWORKER_PARK_COUNT  QWORKER_TABLE ":park_count"
+
 extern taos_counter_t *write_total_requests;
 extern taos_counter_t *write_total_rows;
 extern taos_counter_t *write_total_bytes;
@@ -82,6 +98,14 @@ extern taos_counter_t *write_merge_count;
 extern taos_counter_t *write_merge_time;
 extern taos_counter_t *write_last_cache_commit_time;
 extern taos_counter_t *write_last_cache_commit_count;
+extern taos_counter_t *write_commit_fset_count;
+extern taos_counter_t *write_commit_fset_time;
+extern taos_counter_t *write_commit_write_bytes;
+extern taos_counter_t *write_merge_write_bytes;
+
+// Global query metrics counters
+extern taos_counter_t *query_block_cache_hits;
+extern taos_counter_t *query_block_cache_misses;
 
 // Global dnode metrics counters
 extern taos_gauge_t *dnode_rpc_queue_memory_allowed;
@@ -89,6 +113,11 @@ extern taos_gauge_t *dnode_rpc_queue_memory_used;
 extern taos_gauge_t *dnode_apply_memory_allowed;
 extern taos_gauge_t *dnode_apply_memory_used;
 
+// Global query worker metrics gauges
+extern taos_gauge_t *qworker_run_count;
+extern taos_gauge_t *qworker_steal_count;
+extern taos_gauge_t *qworker_park_count;
+
 // Macro for deleting a counter key with error logging
 #define METRICS_DELETE_COUNTER(counter, key)                                     \
   do {                                                                           \
@@ -34,6 +34,14 @@ taos_counter_t *write_merge_count = NULL;
 taos_counter_t *write_merge_time = NULL;
 taos_counter_t *write_last_cache_commit_time = NULL;
 taos_counter_t *write_last_cache_commit_count = NULL;
+taos_counter_t *write_commit_fset_count = NULL;
+taos_counter_t *write_commit_fset_time = NULL;
+taos_counter_t *write_commit_write_bytes = NULL;
+taos_counter_t *write_merge_write_bytes = NULL;
+
+// Global query metrics counters
+taos_counter_t *query_block_cache_hits = NULL;
+taos_counter_t *query_block_cache_misses = NULL;
 
 // Global dnode metrics counters
 taos_gauge_t *dnode_rpc_queue_memory_allowed = NULL;
@@ -41,6 +49,11 @@ taos_gauge_t *dnode_rpc_queue_memory_used = NULL;
 taos_gauge_t *dnode_apply_memory_allowed = NULL;
 taos_gauge_t *dnode_apply_memory_used = NULL;
 
+// Global query worker metrics gauges, the workers report cumulative values
+taos_gauge_t *qworker_run_count = NULL;
+taos_gauge_t *qworker_steal_count = NULL;
+taos_gauge_t *qworker_park_count = NULL;
+
 // Helper function to clean expired metrics from a counter
 static void cleanExpiredCounterMetrics(taos_counter_t *counter, SHashObj *pValidVgroups, const char *counterName) {
   if (counter == NULL || pValidVgroups == NULL) {
@@ -116,6 +129,20 @@ int32_t initMetricsManager() {
       taos_counter_new(WRITE_LAST_CACHE_COMMIT_TIME, "Last cache commit time", 6, write_labels));
   write_last_cache_commit_count = taos_collector_registry_must_register_metric(
       taos_counter_new(WRITE_LAST_CACHE_COMMIT_COUNT, "Last cache commit count", 6, write_labels));
+  write_commit_fset_count = taos_collector_registry_must_register_metric(
+      taos_counter_new(WRITE_COMMIT_FSET_COUNT, "Committed file set count", 6, write_labels));
+  write_commit_fset_time = taos_collector_registry_must_register_metric(
+      taos_counter_new(WRITE_COMMIT_FSET_TIME, "File set commit time", 6, write_labels));
+  write_commit_write_bytes = taos_collector_registry_must_register_metric(
+      taos_counter_new(WRITE_COMMIT_WRITE_BYTES, "Commit write bytes", 6, write_labels));
+  write_merge_write_bytes = taos_collector_registry_must_register_metric(
+      taos_counter_new(WRITE_MERGE_WRITE_BYTES, "Merge write bytes", 6, write_labels));
+
+  // Initialize global query counters, labeled like the write ones
+  query_block_cache_hits = taos_collector_registry_must_register_metric(
+      taos_counter_new(QUERY_BLOCK_CACHE_HITS, "Block cache hits", 6, write_labels));
+  query_block_cache_misses = taos_collector_registry_must_register_metric(
+      taos_counter_new(QUERY_BLOCK_CACHE_MISSES, "Block cache misses", 6, write_labels));
 
   // Initialize global dnode counters
   const char *dnode_labels[] = {"metric_type", "cluster_id", "dnode_id", "dnode_ep"};
@@ -128,6 +155,15 @@ int32_t initMetricsManager() {
   dnode_apply_memory_used = taos_collector_registry_must_register_metric(
       taos_gauge_new(DNODE_APPLY_MEMORY_USED, "Apply memory used", 4, dnode_labels));
 
+  // Initialize global query worker gauges
+  const char *qworker_labels[] = {"metric_type", "cluster_id", "dnode_id", "dnode_ep", "pool_name", "worker_id"};
+  qworker_run_count = taos_collector_registry_must_register_metric(
+      taos_gauge_new(QWORKER_RUN_COUNT, "Query worker processed msgs", 6, qworker_labels));
+  qworker_steal_count = taos_collector_registry_must_register_metric(
+      taos_gauge_new(QWORKER_STEAL_COUNT, "Query worker stolen msgs", 6, qworker_labels));
+  qworker_park_count = taos_collector_registry_must_register_metric(
+      taos_gauge_new(QWORKER_PARK_COUNT, "Query worker park count", 6, qworker_labels));
+
   return TSDB_CODE_SUCCESS;
 }
 
@@ -160,6 +196,10 @@ int32_t addWriteMetrics(int32_t vgId, int32_t dnodeId, int64_t clusterId, const
   taos_counter_add(write_merge_time, (double)pRawMetrics->merge_time, label_values);
   taos_counter_add(write_last_cache_commit_time, (double)pRawMetrics->last_cache_commit_time, label_values);
   taos_counter_add(write_last_cache_commit_count, (double)pRawMetrics->last_cache_commit_count, label_values);
+  taos_counter_add(write_commit_fset_count, (double)pRawMetrics->commit_fset_count, label_values);
+  taos_counter_add(write_commit_fset_time, (double)pRawMetrics->commit_fset_time, label_values);
+  taos_counter_add(write_commit_write_bytes, (double)pRawMetrics->commit_write_bytes, label_values);
+  taos_counter_add(write_merge_write_bytes, (double)pRawMetrics->merge_write_bytes, label_values);
 
   // Update low level metrics when tsMetricsFlag is 1
   if (tsMetricsLevel == 1) {
@@ -177,6 +217,26 @@ int32_t addWriteMetrics(int32_t vgId, int32_t dnodeId, int64_t clusterId, const
   return TSDB_CODE_SUCCESS;
 }
 
+int32_t addQueryMetrics(int32_t vgId, int32_t dnodeId, int64_t clusterId, const char *dnodeEp, const char *dbname,
+                        const SRawQueryMetrics *pRawMetrics) {
+  if (pRawMetrics == NULL) {
+    return TSDB_CODE_INVALID_PARA;
+  }
+
+  // Prepare label values
+  char clusterIdStr[32], dnodeIdStr[32], vgIdStr[32];
+  snprintf(clusterIdStr, sizeof(clusterIdStr), "%" PRId64, clusterId);
+  snprintf(dnodeIdStr, sizeof(dnodeIdStr), "%d", dnodeId);
+  snprintf(vgIdStr, sizeof(vgIdStr), "%d", vgId);
+  const char *label_values[] = {VNODE_QUERY_METRIC,     clusterIdStr, dnodeIdStr,
+                                dnodeEp ? dnodeEp : "", vgIdStr,      dbname ? dbname : ""};
+
+  taos_counter_add(query_block_cache_hits, (double)pRawMetrics->block_cache_hits, label_values);
+  taos_counter_add(query_block_cache_misses, (double)pRawMetrics->block_cache_misses, label_values);
+
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t addDnodeMetrics(const SRawDnodeMetrics *pRawMetrics, int64_t clusterId, int32_t dnodeId, const char *dnodeEp) {
   if (pRawMetrics == NULL) {
     return TSDB_CODE_INVALID_PARA;
@@ -197,6 +257,27 @@ int32_t addDnodeMetrics(const SRawDnodeMetrics *pRawMetrics, int64_t clusterId,
   return TSDB_CODE_SUCCESS;
 }
 
+int32_t addQueryWorkerMetrics(const SRawQueryWorkerMetrics *pRawMetrics, int64_t clusterId, int32_t dnodeId,
+                              const char *dnodeEp) {
+  if (pRawMetrics == NULL) {
+    return TSDB_CODE_INVALID_PARA;
+  }
+
+  // Prepare label values
+  char clusterIdStr[32], dnodeIdStr[32], workerIdStr[32];
+  snprintf(clusterIdStr, sizeof(clusterIdStr), "%" PRId64, clusterId);
+  snprintf(dnodeIdStr, sizeof(dnodeIdStr), "%d", dnodeId);
+  snprintf(workerIdStr, sizeof(workerIdStr), "%d", pRawMetrics->workerId);
+  const char *label_values[] = {QWORKER_METRIC, clusterIdStr, dnodeIdStr, dnodeEp ? dnodeEp : "",
+                                pRawMetrics->poolName ? pRawMetrics->poolName : "", workerIdStr};
+
+  taos_gauge_set(qworker_run_count, (double)pRawMetrics->runCount, label_values);
+  taos_gauge_set(qworker_steal_count, (double)pRawMetrics->stealCount, label_values);
+  taos_gauge_set(qworker_park_count, (double)pRawMetrics->parkCount, label_values);
+
+  return TSDB_CODE_SUCCESS;
+}
+
 // New function to clean expired metrics based on valid vgroups
 int32_t cleanupExpiredMetrics(SHashObj *pValidVgroups) {
   // Clean expired metrics for all write metrics counters
@@ -219,5 +300,11 @@ int32_t cleanupExpiredMetrics(SHashObj *pValidVgroups) {
   cleanExpiredCounterMetrics(write_merge_time, pValidVgroups, "write_merge_time");
   cleanExpiredCounterMetrics(write_last_cache_commit_time, pValidVgroups, "write_last_cache_commit_time");
   cleanExpiredCounterMetrics(write_last_cache_commit_count, pValidVgroups, "write_last_cache_commit_count");
+  cleanExpiredCounterMetrics(write_commit_fset_count, pValidVgroups, "write_commit_fset_count");
+  cleanExpiredCounterMetrics(write_commit_fset_time, pValidVgroups, "write_commit_fset_time");
+  cleanExpiredCounterMetrics(write_commit_write_bytes, pValidVgroups, "write_commit_write_bytes");
+  cleanExpiredCounterMetrics(write_merge_write_bytes, pValidVgroups, "write_merge_write_bytes");
+  cleanExpiredCounterMetrics(query_block_cache_hits, pValidVgroups, "query_block_cache_hits");
+  cleanExpiredCounterMetrics(query_block_cache_misses, pValidVgroups, "query_block_cache_misses");
   return TSDB_CODE_SUCCESS;
 }
\ No newline at end of file
@@ -77,6 +77,10 @@ void MetricsTest::PrepareRawWriteMetrics(SRawWriteMetrics *pMetrics, int32_t mul
   pMetrics->merge_time = 8000 * multiplier; // microseconds
   pMetrics->last_cache_commit_time = 3500 * multiplier; // microseconds
   pMetrics->last_cache_commit_count = 15 * multiplier;
+  pMetrics->commit_fset_count = 40 * multiplier;
+  pMetrics->commit_fset_time = 5500 * multiplier; // microseconds
+  pMetrics->commit_write_bytes = 9000 * multiplier;
+  pMetrics->merge_write_bytes = 12000 * multiplier;
 }
 
 void MetricsTest::PrepareRawDnodeMetrics(SRawDnodeMetrics *pMetrics) {
@@ -226,6 +230,33 @@ TEST_F(MetricsTest, AddDnodeMetrics) {
   ASSERT_EQ(code, TSDB_CODE_SUCCESS);
 }
 
+TEST_F(MetricsTest, AddQueryWorkerMetrics) {
+  for (int32_t i = 0; i < 4; i++) {
+    SRawQueryWorkerMetrics rawMetrics = {0};
+    rawMetrics.poolName = "vnode-query";
+    rawMetrics.workerId = i;
+    rawMetrics.runCount = 1000 * (i + 1);
+    rawMetrics.stealCount = 10 * i;
+    rawMetrics.parkCount = 100 + i;
+
+    int32_t code = addQueryWorkerMetrics(&rawMetrics, 123456789, 1, "localhost:6030");
+    ASSERT_EQ(code, TSDB_CODE_SUCCESS);
+  }
+
+  ASSERT_EQ(addQueryWorkerMetrics(nullptr, 123456789, 1, "localhost:6030"), TSDB_CODE_INVALID_PARA);
+}
+
+TEST_F(MetricsTest, AddQueryMetrics) {
+  SRawQueryMetrics rawMetrics = {0};
+  rawMetrics.block_cache_hits = 900;
+  rawMetrics.block_cache_misses = 100;
+
+  int32_t code = addQueryMetrics(100, 1, 123456789, "localhost:6030", "test_db_1", &rawMetrics);
+  ASSERT_EQ(code, TSDB_CODE_SUCCESS);
+
+  ASSERT_EQ(addQueryMetrics(100, 1, 123456789, "localhost:6030", "test_db_1", nullptr), TSDB_CODE_INVALID_PARA);
+}
+
 TEST_F(MetricsTest, MultipleVgroups) {
   // Add metrics for multiple vgroups
   for (int32_t i = 200; i <= 205; i++) {
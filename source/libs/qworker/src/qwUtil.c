@@ -599,6 +599,8 @@ void qwCloseRef(void) {
 
     taosHashCleanup(gQueryMgmt.pJobInfo);
     gQueryMgmt.pJobInfo = NULL;
+
+    qCleanupSharedRes();
   }
   taosWUnLockLatch(&gQwMgmt.lock);
 }
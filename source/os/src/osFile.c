@@ -12,6 +12,9 @@
  * You should have received a copy of the GNU Affero General Public License
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE  // O_DIRECT and sync_file_range
+#endif
 #define ALLOW_FORBID_FUNC
 #include "os.h"
 #include "osSemaphore.h"
@@ -789,6 +792,9 @@ int taosOpenFileNotStream(const char *path, int32_t tdFileOptions) {
   access |= (tdFileOptions & TD_FILE_TEXT) ? O_TEXT : 0;
   access |= (tdFileOptions & TD_FILE_EXCL) ? O_EXCL : 0;
   access |= (tdFileOptions & TD_FILE_CLOEXEC) ? O_CLOEXEC : 0;
+#if defined(LINUX) && defined(O_DIRECT)
+  access |= (tdFileOptions & TD_FILE_DIRECT) ? O_DIRECT : 0;
+#endif
 
   int fd = open(path, access, S_IRWXU | S_IRWXG | S_IRWXO);
   if (-1 == fd) {
@@ -1343,6 +1349,52 @@ _exit:
   return ret;
 }
 
+// ask the kernel to start reading the range into the page cache and return without waiting for it, a later read of
+// the range then hits the cache. It is only a hint, platforms without such an interface do nothing.
+int32_t taosReadAheadFile(TdFilePtr pFile, int64_t offset, int64_t length) {
+  if (pFile == NULL || offset < 0 || length <= 0) {
+    return TSDB_CODE_INVALID_PARA;
+  }
+
+#if defined(WINDOWS) || defined(TD_ASTRA)
+  return 0;
+#else
+  if (pFile->fd < 0) {
+    return TSDB_CODE_INVALID_PARA;
+  }
+#if defined(_TD_DARWIN_64)
+  struct radvisory ra = {.ra_offset = offset, .ra_count = (int)TMIN(length, INT32_MAX)};
+  if (fcntl(pFile->fd, F_RDADVISE, &ra) == -1) {
+    return TAOS_SYSTEM_ERROR(ERRNO);
+  }
+#else
+  int32_t ret = posix_fadvise(pFile->fd, offset, length, POSIX_FADV_WILLNEED);
+  if (ret != 0) {
+    return TAOS_SYSTEM_ERROR(ret);
+  }
+#endif
+  return 0;
+#endif
+}
+
+// ask the kernel to start writing the dirty pages of the range back and return without waiting for it, so that a
+// later fsync has little left to do. It is only a hint, platforms without such an interface do nothing.
+int32_t taosWriteBehindFile(TdFilePtr pFile, int64_t offset, int64_t length) {
+  if (pFile == NULL || offset < 0 || length <= 0) {
+    return TSDB_CODE_INVALID_PARA;
+  }
+
+#if defined(LINUX) && defined(SYNC_FILE_RANGE_WRITE)
+  if (pFile->fd < 0) {
+    return TSDB_CODE_INVALID_PARA;
+  }
+  if (sync_file_range(pFile->fd, offset, length, SYNC_FILE_RANGE_WRITE) == -1) {
+    return TAOS_SYSTEM_ERROR(ERRNO);
+  }
+#endif
+  return 0;
+}
+
 int32_t taosFsyncFile(TdFilePtr pFile) {
   if (pFile == NULL) {
     return 0;
@@ -214,4 +214,35 @@ TEST(osFileTests, taosCreateFile) {
 
   TdFilePtr retptr2 = taosOpenFile(NULL, 0);
   EXPECT_EQ(retptr2, nullptr);
-}
\ No newline at end of file
+}
+
+TEST(osFileTests, taosDirectWriteFile) {
+  char path[PATH_MAX] = {0};
+  taosGetTmpfilePath("/tmp", "direct", path);
+
+  const int64_t size = 64 * 1024;
+  char         *buf = (char *)taosMemoryMallocAlign(4096, size);
+  ASSERT_NE(buf, nullptr);
+  memset(buf, 'd', size);
+
+  TdFilePtr pFile = taosOpenFile(path, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_READ | TD_FILE_TRUNC | TD_FILE_DIRECT);
+  if (pFile == NULL) {
+    // the file system of the tmp dir does not support direct io
+    pFile = taosOpenFile(path, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_READ | TD_FILE_TRUNC);
+  }
+  ASSERT_NE(pFile, nullptr);
+
+  EXPECT_EQ(taosPWriteFile(pFile, buf, size, 0), size);
+  EXPECT_EQ(taosWriteBehindFile(pFile, 0, size), 0);
+  EXPECT_EQ(taosFsyncFile(pFile), 0);
+  EXPECT_NE(taosWriteBehindFile(pFile, -1, size), 0);
+  EXPECT_NE(taosWriteBehindFile(NULL, 0, size), 0);
+
+  int64_t fileSize = 0;
+  EXPECT_EQ(taosFStatFile(pFile, &fileSize, NULL), 0);
+  EXPECT_EQ(fileSize, size);
+
+  EXPECT_EQ(taosCloseFile(&pFile), 0);
+  EXPECT_EQ(taosRemoveFile(path), 0);
+  taosMemoryFree(buf);
+}
@@ -22,9 +22,31 @@ extern "C" {
 
 #include "tlog.h"
 
+#define LOG_MAX_LINE_SIZE        (10024)
+#define LOG_MAX_LINE_BUFFER_SIZE (LOG_MAX_LINE_SIZE + 3)
+
+typedef enum {
+  LOG_RING_NONE = 0,    // lines are formatted by the caller and pushed into the shared log buffer
+  LOG_RING_TEXT = 1,    // per-thread rings, lines are formatted by the log thread
+  LOG_RING_BINARY = 2,  // per-thread rings, records are written in binary and decoded offline
+} ELogRingMode;
+
 void taosOpenNewSlowLogFile();
 void taosLogObjSetToday(int64_t ts);
 
+int32_t taosLogBuildHead(char *buffer, int32_t size, int64_t ts, int64_t tid, const char *flags);
+
+/*
+ * Per-thread log rings. Each thread logs into a ring of its own without any lock, the log thread drains all rings.
+ * Lines may be kept as the format and the raw arguments, and are formatted when drained.
+ */
+int32_t taosLogRingInit();
+void    taosLogRingCleanup();
+int32_t taosLogRingPutFmt(const char *flags, const char *format, va_list args);
+int32_t taosLogRingPutText(const char *msg, int32_t msgLen);
+void    taosLogRingDrain(int8_t mode, int32_t fileVer, FLogOutput fp, void *param);
+int32_t taosLogBinaryEncodeText(const char *msg, int32_t msgLen, char *buf, int32_t size);
+
 #ifdef __cplusplus
 }
 #endif
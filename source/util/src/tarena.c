@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _DEFAULT_SOURCE
+#include "tarena.h"
+#include "taoserror.h"
+#include "tdef.h"
+
+#define TAOS_ARENA_ALIGN(s) (((s) + 7) & ~((int64_t)7))
+
+typedef struct SArenaChunk {
+  struct SArenaChunk *next;  // the older chunk
+  int64_t             size;
+  int64_t             used;
+  char                data[];
+} SArenaChunk;
+
+struct SArena {
+  void        *pSession;  // memory pool session the chunks are charged to, NULL if they are taken from the heap
+  int64_t      chunkSize;
+  SArenaChunk *pChunk;  // the chunk being allocated from, chunks are linked from the newest to the oldest
+  int64_t      memSize;
+  int64_t      allocSize;
+};
+
+typedef struct SArenaScratchHead {
+  SArena *pArena;  // NULL if the scratch buffer is allocated from the heap
+  int64_t size;
+} SArenaScratchHead;
+
+static threadlocal SArena *tsThreadArena = NULL;
+
+// chunks go to the session of the arena whatever thread allocates or frees them, one quota check per chunk
+static void *taosArenaChunkMalloc(SArena *pArena, int64_t size) {
+#if !defined(BUILD_TEST) && !defined(TD_ASTRA)
+  if (pArena->pSession != NULL) {
+    return taosMemPoolMalloc(gMemPoolHandle, pArena->pSession, size, (char *)__FILE__, __LINE__);
+  }
+#endif
+  return taosMemMalloc(size);
+}
+
+static void taosArenaChunkFree(SArena *pArena, SArenaChunk *pChunk) {
+#if !defined(BUILD_TEST) && !defined(TD_ASTRA)
+  if (pArena->pSession != NULL) {
+    taosMemPoolFree(gMemPoolHandle, pArena->pSession, pChunk, (char *)__FILE__, __LINE__);
+    return;
+  }
+#endif
+  taosMemFree(pChunk);
+}
+
+static SArenaChunk *taosArenaNewChunk(SArena *pArena, int64_t size) {
+  SArenaChunk *pChunk = taosArenaChunkMalloc(pArena, sizeof(SArenaChunk) + size);
+  if (pChunk == NULL) {
+    return NULL;
+  }
+
+  pChunk->size = size;
+  pChunk->used = 0;
+  pChunk->next = pArena->pChunk;
+
+  pArena->pChunk = pChunk;
+  pArena->memSize += size;
+  return pChunk;
+}
+
+int32_t taosArenaCreate(int64_t chunkSize, SArena **ppArena) {
+  if (chunkSize <= 0 || ppArena == NULL) {
+    return TSDB_CODE_INVALID_PARA;
+  }
+
+  SArena *pArena = taosMemCalloc(1, sizeof(SArena));
+  if (pArena == NULL) {
+    return terrno;
+  }
+
+#if !defined(BUILD_TEST) && !defined(TD_ASTRA)
+  // the arena is charged to the memory pool session of the creating thread, i.e. the query the task belongs to
+  pArena->pSession = threadPoolEnabled ? threadPoolSession : NULL;
+#endif
+
+  // the first chunk is allocated lazily, tasks that never use the arena cost nothing
+  pArena->chunkSize = TAOS_ARENA_ALIGN(chunkSize);
+  *ppArena = pArena;
+  return TSDB_CODE_SUCCESS;
+}
+
+void taosArenaDestroy(SArena *pArena) {
+  if (pArena == NULL) {
+    return;
+  }
+
+  if (tsThreadArena == pArena) {
+    tsThreadArena = NULL;
+  }
+
+  SArenaChunk *pChunk = pArena->pChunk;
+  while (pChunk != NULL) {
+    SArenaChunk *pNext = pChunk->next;
+    taosArenaChunkFree(pArena, pChunk);
+    pChunk = pNext;
+  }
+
+  taosMemFree(pArena);
+}
+
+void *taosArenaMalloc(SArena *pArena, int64_t size) {
+  if (pArena == NULL || size < 0) {
+    terrno = TSDB_CODE_INVALID_PARA;
+    return NULL;
+  }
+
+  size = TAOS_ARENA_ALIGN(size);
+
+  SArenaChunk *pChunk = pArena->pChunk;
+  if (pChunk == NULL || pChunk->used + size > pChunk->size) {
+    // a request larger than the chunk size gets a chunk of its own
+    pChunk = taosArenaNewChunk(pArena, TMAX(pArena->chunkSize, size));
+    if (pChunk == NULL) {
+      return NULL;
+    }
+  }
+
+  void *p = pChunk->data + pChunk->used;
+  pChunk->used += size;
+  pArena->allocSize += size;
+  return p;
+}
+
+void *taosArenaCalloc(SArena *pArena, int64_t num, int64_t size) {
+  void *p = taosArenaMalloc(pArena, num * size);
+  if (p != NULL) {
+    (void)memset(p, 0, num * size);
+  }
+  return p;
+}
+
+void taosArenaReset(SArena *pArena) {
+  if (pArena == NULL || pArena->pChunk == NULL) {
+    return;
+  }
+
+  int64_t      allocSize = pArena->allocSize;
+  SArenaChunk *pChunk = pArena->pChunk;
+  while (pChunk->next != NULL) {
+    SArenaChunk *pNext = pChunk->next;
+    pArena->memSize -= pChunk->size;
+    taosArenaChunkFree(pArena, pChunk);
+    pChunk = pNext;
+  }
+
+  pChunk->used = 0;
+  pArena->pChunk = pChunk;
+  pArena->allocSize = 0;
+
+  // the last batch did not fit in one chunk, enlarge the kept chunk so that the next one does
+  if (allocSize > pChunk->size && allocSize <= TAOS_ARENA_MAX_CHUNK_SIZE) {
+    int64_t size = (allocSize + pArena->chunkSize - 1) / pArena->chunkSize * pArena->chunkSize;
+
+    pArena->memSize -= pChunk->size;
+    pArena->pChunk = NULL;
+    taosArenaChunkFree(pArena, pChunk);
+
+    // on failure the next allocation retries with the default chunk size
+    (void)taosArenaNewChunk(pArena, size);
+  }
+}
+
+int64_t taosArenaGetMemSize(SArena *pArena) { return pArena ? pArena->memSize : 0; }
+
+int64_t taosArenaGetAllocSize(SArena *pArena) { return pArena ? pArena->allocSize : 0; }
+
+SArena *taosArenaSetThreadArena(SArena *pArena) {
+  SArena *pPrev = tsThreadArena;
+  tsThreadArena = pArena;
+  return pPrev;
+}
+
+SArena *taosArenaGetThreadArena(void) { return tsThreadArena; }
+
+void *taosArenaScratchMalloc(int64_t size) {
+  SArena *pArena = tsThreadArena;
+  int64_t total = TAOS_ARENA_ALIGN((int64_t)sizeof(SArenaScratchHead) + size);
+
+  SArenaScratchHead *pHead = pArena ? taosArenaMalloc(pArena, total) : taosMemoryMalloc(total);
+  if (pHead == NULL) {
+    return NULL;
+  }
+
+  pHead->pArena = pArena;
+  pHead->size = total;
+  return pHead + 1;
+}
+
+void *taosArenaScratchCalloc(int64_t num, int64_t size) {
+  void *p = taosArenaScratchMalloc(num * size);
+  if (p != NULL) {
+    (void)memset(p, 0, num * size);
+  }
+  return p;
+}
+
+void taosArenaScratchFree(void *ptr) {
+  if (ptr == NULL) {
+    return;
+  }
+
+  SArenaScratchHead *pHead = (SArenaScratchHead *)ptr - 1;
+  SArena            *pArena = pHead->pArena;
+  if (pArena == NULL) {
+    taosMemoryFree(pHead);
+    return;
+  }
+
+  // only the latest allocation can be given back, the others are released by the next reset
+  SArenaChunk *pChunk = pArena->pChunk;
+  if (pChunk != NULL && (char *)pHead + pHead->size == pChunk->data + pChunk->used) {
+    pChunk->used -= pHead->size;
+    pArena->allocSize -= pHead->size;
+  }
+}
@@ -202,3 +202,164 @@ _error:
 }
 
 bool tBloomFilterIsFull(const SBloomFilter* pBF) { return pBF->size >= pBF->expectedEntries; }
+
+// split block bloom filter ==================================================
+static const uint32_t blockBfSalt[BLOCK_BF_WORDS] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                                     0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+// the high 32 bits of the hash choose the block, the low 32 bits choose one bit in each word of the block
+static FORCE_INLINE uint32_t* blockBfGetBlock(const SBlockBloomFilter* pBF, uint64_t hash) {
+  uint64_t idx = ((hash >> 32) * pBF->numBlocks) >> 32;
+  return pBF->blocks + idx * BLOCK_BF_WORDS;
+}
+
+#ifdef __AVX2__
+static FORCE_INLINE __m256i blockBfMaskAVX2(uint32_t key) {
+  __m256i salt = _mm256_loadu_si256((const __m256i*)blockBfSalt);
+  __m256i hash = _mm256_mullo_epi32(_mm256_set1_epi32(key), salt);
+  hash = _mm256_srli_epi32(hash, 27);
+  return _mm256_sllv_epi32(_mm256_set1_epi32(1), hash);
+}
+#endif
+
+int32_t tBlockBloomFilterInit(uint64_t expectedEntries, double errorRate, SBlockBloomFilter** ppBF) {
+  int32_t code = 0;
+  int32_t lino = 0;
+  if (expectedEntries < 1 || errorRate <= 0 || errorRate >= 1.0) {
+    code = TSDB_CODE_INVALID_PARA;
+    QUERY_CHECK_CODE(code, lino, _error);
+  }
+  SBlockBloomFilter* pBF = taosMemoryCalloc(1, sizeof(SBlockBloomFilter));
+  if (pBF == NULL) {
+    code = terrno;
+    QUERY_CHECK_CODE(code, lino, _error);
+  }
+
+  // same number of bits as the classic filter, a block filter needs a little more bits for the same error rate
+  // ln(2)^2 = 0.480453013918201
+  double   lnRate = fabs(log(errorRate));
+  uint64_t numBits = (uint64_t)ceil(expectedEntries * lnRate / 0.480453013918201 * 1.2);
+  uint64_t numBlocks = (numBits + BLOCK_BF_BYTES * 8 - 1) / (BLOCK_BF_BYTES * 8);
+  if (numBlocks > INT32_MAX / BLOCK_BF_BYTES) {
+    tBlockBloomFilterDestroy(pBF);
+    code = TSDB_CODE_INVALID_PARA;
+    QUERY_CHECK_CODE(code, lino, _error);
+  }
+
+  pBF->numBlocks = (uint32_t)numBlocks;
+  pBF->size = 0;
+  pBF->blocks = taosMemoryCalloc(pBF->numBlocks, BLOCK_BF_BYTES);
+  if (pBF->blocks == NULL) {
+    tBlockBloomFilterDestroy(pBF);
+    code = terrno;
+    QUERY_CHECK_CODE(code, lino, _error);
+  }
+  (*ppBF) = pBF;
+
+_error:
+  if (code != TSDB_CODE_SUCCESS) {
+    uError("%s failed at line %d since %s", __func__, lino, tstrerror(code));
+  }
+  return code;
+}
+
+void tBlockBloomFilterPutHash(SBlockBloomFilter* pBF, uint64_t hash) {
+  uint32_t* block = blockBfGetBlock(pBF, hash);
+  uint32_t  key = (uint32_t)hash;
+
+#ifdef __AVX2__
+  if (tsSIMDEnable && tsAVX2Supported) {
+    __m256i bits = _mm256_loadu_si256((const __m256i*)block);
+    _mm256_storeu_si256((__m256i*)block, _mm256_or_si256(bits, blockBfMaskAVX2(key)));
+    pBF->size++;
+    return;
+  }
+#endif
+
+  for (int32_t i = 0; i < BLOCK_BF_WORDS; ++i) {
+    block[i] |= 1U << ((key * blockBfSalt[i]) >> 27);
+  }
+  pBF->size++;
+}
+
+void tBlockBloomFilterPut(SBlockBloomFilter* pBF, const void* keyBuf, uint32_t len) {
+  tBlockBloomFilterPutHash(pBF, MurmurHash3_64(keyBuf, len));
+}
+
+bool tBlockBloomFilterNoContainHash(const SBlockBloomFilter* pBF, uint64_t hash) {
+  const uint32_t* block = blockBfGetBlock(pBF, hash);
+  uint32_t        key = (uint32_t)hash;
+
+#ifdef __AVX2__
+  if (tsSIMDEnable && tsAVX2Supported) {
+    __m256i bits = _mm256_loadu_si256((const __m256i*)block);
+    return !_mm256_testc_si256(bits, blockBfMaskAVX2(key));
+  }
+#endif
+
+  for (int32_t i = 0; i < BLOCK_BF_WORDS; ++i) {
+    if (!(block[i] & (1U << ((key * blockBfSalt[i]) >> 27)))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool tBlockBloomFilterNoContain(const SBlockBloomFilter* pBF, const void* keyBuf, uint32_t len) {
+  return tBlockBloomFilterNoContainHash(pBF, MurmurHash3_64(keyBuf, len));
+}
+
+void tBlockBloomFilterDestroy(SBlockBloomFilter* pBF) {
+  if (pBF == NULL) {
+    return;
+  }
+  taosMemoryFree(pBF->blocks);
+  taosMemoryFree(pBF);
+}
+
+int32_t tBlockBloomFilterEncode(const SBlockBloomFilter* pBF, SEncoder* pEncoder) {
+  TAOS_CHECK_RETURN(tEncodeU32(pEncoder, pBF->numBlocks));
+  TAOS_CHECK_RETURN(tEncodeU64(pEncoder, pBF->size));
+  TAOS_CHECK_RETURN(tEncodeBinary(pEncoder, (const uint8_t*)pBF->blocks, pBF->numBlocks * BLOCK_BF_BYTES));
+  return 0;
+}
+
+int32_t tBlockBloomFilterDecode(SDecoder* pDecoder, SBlockBloomFilter** ppBF) {
+  int32_t            code = 0;
+  int32_t            lino = 0;
+  uint8_t*           data = NULL;
+  uint32_t           len = 0;
+  SBlockBloomFilter* pBF = taosMemoryCalloc(1, sizeof(SBlockBloomFilter));
+  if (!pBF) {
+    code = terrno;
+    QUERY_CHECK_CODE(code, lino, _error);
+  }
+  if (tDecodeU32(pDecoder, &pBF->numBlocks) < 0) {
+    code = TSDB_CODE_FAILED;
+    QUERY_CHECK_CODE(code, lino, _error);
+  }
+  if (tDecodeU64(pDecoder, &pBF->size) < 0) {
+    code = TSDB_CODE_FAILED;
+    QUERY_CHECK_CODE(code, lino, _error);
+  }
+  if (tDecodeBinary(pDecoder, &data, &len) < 0) {
+    code = TSDB_CODE_FAILED;
+    QUERY_CHECK_CODE(code, lino, _error);
+  }
+  if (pBF->numBlocks == 0 || len != (uint64_t)pBF->numBlocks * BLOCK_BF_BYTES) {
+    code = TSDB_CODE_INVALID_DATA_FMT;
+    QUERY_CHECK_CODE(code, lino, _error);
+  }
+
+  pBF->blocks = taosMemoryMalloc(len);
+  QUERY_CHECK_NULL(pBF->blocks, code, lino, _error, terrno);
+  (void)memcpy(pBF->blocks, data, len);
+
+  (*ppBF) = pBF;
+  return TSDB_CODE_SUCCESS;
+
+_error:
+  tBlockBloomFilterDestroy(pBF);
+  uError("%s failed at line %d since %s", __func__, lino, tstrerror(code));
+  return code;
+}
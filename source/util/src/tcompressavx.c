@@ -0,0 +1,641 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * SIMD encoders for the regular (L1) compression algorithms.
+ *
+ * Every encoder in this file is split into two stages:
+ *   1. a vectorized transform stage, which computes the delta-of-delta / delta / XOR values and their zigzag
+ *      encoding for a batch of input values, and also detects the overflow conditions checked by the scalar code;
+ *   2. a packing stage, which emits the flags and the significant bytes of the transformed values.
+ *
+ * The output is byte-for-byte identical to tsCompressTimestampImp, tsCompressINTImp, tsCompressFloatImp and
+ * tsCompressDoubleImp, so that data written with or without SIMD can be read by any version. All encoders return
+ * -1 when they cannot handle the input, and the caller must fall back to the scalar implementation in that case.
+ */
+
+#include "tcompression.h"
+#include "tlog.h"
+#include "ttypes.h"
+
+#define SIMPLE8B_MAX_INT64 ((uint64_t)1152921504606846974LL)
+
+// number of values transformed in one round, must be even so that a pair of values never crosses two rounds
+#define CMPR_SIMD_BATCH 512
+// simple8b needs to look ahead at most 240 + 1 values to choose the selector
+#define CMPR_S8B_LOOKAHEAD 241
+#define CMPR_S8B_WINDOW    1024
+
+// result of a transform stage
+#define CMPR_TRANS_OK       0
+#define CMPR_TRANS_RAW      1  // the input cannot be compressed, store the original data
+#define CMPR_TRANS_FALLBACK 2  // ambiguous input for the vectorized path, let the scalar encoder decide
+
+#ifdef __AVX2__
+typedef int32_t (*__cmpr_ts_transform_fn_t)(const int64_t *istream, int32_t start, int32_t end, uint64_t *zz);
+typedef int32_t (*__cmpr_int_transform_fn_t)(const char *input, int32_t start, int32_t end, uint64_t *zz, char type);
+
+/* ------------------------------------------- scalar helpers ---------------------------------------------------- */
+// same overflow semantics as safeInt64Add(a, -b) in tcompression.c, with b == INT64_MIN rejected up front
+static FORCE_INLINE int32_t cmprSubOverflow(int64_t a, int64_t b, int64_t *r) {
+  if (b == INT64_MIN) return CMPR_TRANS_FALLBACK;
+  *r = (int64_t)((uint64_t)a - (uint64_t)b);
+  return ((a ^ b) & (a ^ *r)) < 0 ? CMPR_TRANS_RAW : CMPR_TRANS_OK;
+}
+
+static FORCE_INLINE uint8_t cmprNumOfBytes(uint64_t v) {
+  return v == 0 ? 0 : (uint8_t)(LONG_BYTES - BUILDIN_CLZL(v) / BITS_PER_BYTE);
+}
+
+static FORCE_INLINE int64_t cmprReadInt(const char *input, int32_t i, char type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT:
+      return ((const int8_t *)input)[i];
+    case TSDB_DATA_TYPE_SMALLINT:
+      return ((const int16_t *)input)[i];
+    case TSDB_DATA_TYPE_INT:
+      return ((const int32_t *)input)[i];
+    default:
+      return ((const int64_t *)input)[i];
+  }
+}
+
+// delta of delta of the i-th timestamp, i >= 2
+static FORCE_INLINE int32_t cmprTsDodScalar(const int64_t *istream, int32_t i, uint64_t *zz) {
+  int64_t d1 = 0, d0 = 0, dod = 0;
+  int32_t code = cmprSubOverflow(istream[i], istream[i - 1], &d1);
+  if (code) return code;
+  code = cmprSubOverflow(istream[i - 1], istream[i - 2], &d0);
+  if (code) return code;
+  code = cmprSubOverflow(d1, d0, &dod);
+  if (code) return code;
+  *zz = ZIGZAG_ENCODE(int64_t, dod);
+  return CMPR_TRANS_OK;
+}
+
+// prologue of the timestamp encoder, keeps the behaviour of the first two values of tsCompressTimestampImp
+static int32_t cmprTsHead(const int64_t *istream, int32_t end, uint64_t *zz) {
+  // the scalar encoder compares the first value with 0x8000000000000000 as unsigned, negative ones are not compressed
+  if (istream[0] < 0) return CMPR_TRANS_RAW;
+  zz[0] = ZIGZAG_ENCODE(int64_t, istream[0]);
+  if (end > 1) {
+    int64_t delta = 0;
+    int32_t code = cmprSubOverflow(istream[1], istream[0], &delta);
+    if (code) return code;
+    zz[1] = ZIGZAG_ENCODE(int64_t, delta);
+  }
+  return CMPR_TRANS_OK;
+}
+
+static FORCE_INLINE int32_t cmprIntZigzagScalar(const char *input, int32_t i, uint64_t *zz, char type) {
+  int64_t curr = cmprReadInt(input, i, type);
+  int64_t prev = i > 0 ? cmprReadInt(input, i - 1, type) : 0;
+  int64_t diff = 0;
+  int32_t code = cmprSubOverflow(curr, prev, &diff);
+  if (code) return code;
+  *zz = ZIGZAG_ENCODE(int64_t, diff);
+  return *zz >= SIMPLE8B_MAX_INT64 ? CMPR_TRANS_RAW : CMPR_TRANS_OK;
+}
+
+/* ------------------------------------------- packing stage ----------------------------------------------------- */
+static int32_t cmprTsPack(const uint64_t *zz, int32_t num, bool tail, char *output, int32_t *pos, int32_t limit) {
+  int32_t _pos = *pos;
+  int32_t i = 0;
+  for (; i + 1 < num; i += 2) {
+    uint8_t flag1 = cmprNumOfBytes(zz[i]);
+    uint8_t flag2 = cmprNumOfBytes(zz[i + 1]);
+    if (_pos + CHAR_BYTES + flag1 + flag2 > limit) return CMPR_TRANS_RAW;
+
+    output[_pos++] = (char)(flag1 | (flag2 << 4));
+    if (_pos + flag1 + LONG_BYTES <= limit) {
+      // it is safe to store the whole word, the extra bytes will be overwritten
+      memcpy(output + _pos, &zz[i], LONG_BYTES);
+      _pos += flag1;
+      memcpy(output + _pos, &zz[i + 1], LONG_BYTES);
+      _pos += flag2;
+    } else {
+      memcpy(output + _pos, &zz[i], flag1);
+      _pos += flag1;
+      memcpy(output + _pos, &zz[i + 1], flag2);
+      _pos += flag2;
+    }
+  }
+
+  if (tail && i < num) {
+    uint8_t flag1 = cmprNumOfBytes(zz[i]);
+    if (_pos + CHAR_BYTES + flag1 > limit) return CMPR_TRANS_RAW;
+    output[_pos++] = (char)flag1;
+    memcpy(output + _pos, &zz[i], flag1);
+    _pos += flag1;
+  }
+
+  *pos = _pos;
+  return CMPR_TRANS_OK;
+}
+
+static int32_t cmprS8bPack(const char *input, int32_t nelements, char *output, char type,
+                           __cmpr_int_transform_fn_t fn) {
+  // Selector value:              0    1   2   3   4   5   6   7   8  9  10  11
+  // 12  13  14  15
+  static const char    bit_per_integer[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
+  static const int32_t selector_to_elems[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
+  static const char    bit_to_selector[] = {0,  2,  3,  4,  5,  6,  7,  8,  9,  10, 10, 11, 11, 12, 12, 12, 13, 13, 13, 13, 13,
+                                            14, 14, 14, 14, 14, 14, 14, 14, 14, 14, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+                                            15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15};
+
+  int32_t word_length = getWordLength(type);
+  int32_t byte_limit = nelements * word_length + 1;
+  int32_t opos = 1;
+
+  uint64_t zz[CMPR_S8B_WINDOW];
+  uint8_t  bits[CMPR_S8B_WINDOW];
+  int32_t  base = 0;   // index of the first value in the window
+  int32_t  avail = 0;  // number of transformed values in the window
+
+  for (int32_t i = 0; i < nelements;) {
+    // make sure that all values the selector may look at are transformed
+    int32_t need = TMIN(i + CMPR_S8B_LOOKAHEAD, nelements);
+    if (base + avail < need) {
+      int32_t keep = base + avail - i;
+      if (keep > 0) {
+        memmove(zz, zz + (i - base), keep * sizeof(uint64_t));
+        memmove(bits, bits + (i - base), keep);
+      }
+      base = i;
+      avail = keep;
+
+      int32_t end = TMIN(base + CMPR_S8B_WINDOW, nelements);
+      int32_t code = fn(input, base + avail, end, zz + avail, type);
+      if (code == CMPR_TRANS_RAW) goto _copy_and_exit;
+      if (code != CMPR_TRANS_OK) return -1;
+
+      for (int32_t k = avail; k < end - base; ++k) {
+        bits[k] = zz[k] == 0 ? 0 : (uint8_t)((LONG_BYTES * BITS_PER_BYTE) - BUILDIN_CLZL(zz[k]));
+      }
+      avail = end - base;
+    }
+
+    char    selector = 0;
+    char    bit = 0;
+    int32_t elems = 0;
+
+    for (int32_t j = i; j < nelements; j++) {
+      int32_t tmp_bit = bits[j - base];
+      if (elems + 1 <= selector_to_elems[(int32_t)selector] &&
+          elems + 1 <= selector_to_elems[(int32_t)(bit_to_selector[tmp_bit])]) {
+        // If can hold another one.
+        selector = selector > bit_to_selector[tmp_bit] ? selector : bit_to_selector[tmp_bit];
+        elems++;
+        bit = bit_per_integer[(int32_t)selector];
+      } else {
+        // if cannot hold another one.
+        while (elems < selector_to_elems[(int32_t)selector]) selector++;
+        elems = selector_to_elems[(int32_t)selector];
+        bit = bit_per_integer[(int32_t)selector];
+        break;
+      }
+    }
+
+    uint64_t buffer = (uint64_t)selector;
+    uint64_t mask = INT64MASK(bit);
+    for (int32_t k = 0; k < elems; k++, i++) {
+      buffer |= ((zz[i - base] & mask) << (bit * k + 4));
+    }
+
+    if (opos + sizeof(buffer) <= byte_limit) {
+      memcpy(output + opos, &buffer, sizeof(buffer));
+      opos += sizeof(buffer);
+    } else {
+      goto _copy_and_exit;
+    }
+  }
+
+  output[0] = 0;
+  return opos;
+
+_copy_and_exit:
+  output[0] = 1;
+  memcpy(output + 1, input, byte_limit - 1);
+  return byte_limit;
+}
+
+static int32_t cmprTsEncode(const char *const input, const int32_t nelements, char *const output,
+                            __cmpr_ts_transform_fn_t fn) {
+  if (nelements <= 0) return -1;
+
+  const int64_t *istream = (const int64_t *)input;
+  int32_t        limit = nelements * LONG_BYTES;
+  int32_t        _pos = 1;
+  uint64_t       zz[CMPR_SIMD_BATCH];
+
+  for (int32_t start = 0; start < nelements; start += CMPR_SIMD_BATCH) {
+    int32_t end = TMIN(start + CMPR_SIMD_BATCH, nelements);
+    int32_t code = CMPR_TRANS_OK;
+    if (start == 0) {
+      code = cmprTsHead(istream, end, zz);
+      if (code == CMPR_TRANS_OK && end > 2) code = fn(istream, 2, end, zz + 2);
+    } else {
+      code = fn(istream, start, end, zz);
+    }
+    if (code == CMPR_TRANS_OK) code = cmprTsPack(zz, end - start, end == nelements, output, &_pos, limit);
+
+    if (code == CMPR_TRANS_RAW) {
+      output[0] = 0;  // Means the string is not compressed
+      memcpy(output + 1, input, limit);
+      return limit + 1;
+    } else if (code != CMPR_TRANS_OK) {
+      return -1;
+    }
+  }
+
+  output[0] = 1;  // Means the string is compressed
+  return _pos;
+}
+
+#define CMPR_FLOAT_FLAG(diff, bytes, clzFn, ctzFn, flag)                                   \
+  do {                                                                                     \
+    int32_t clz = (bytes) * BITS_PER_BYTE, ctz = clz;                                      \
+    if (diff) {                                                                            \
+      ctz = ctzFn(diff);                                                                   \
+      clz = clzFn(diff);                                                                   \
+    }                                                                                      \
+    uint8_t nbytes = (uint8_t)((bytes) - ((ctz > clz) ? ctz : clz) / BITS_PER_BYTE);       \
+    if (nbytes > 0) nbytes--;                                                              \
+    (flag) = (ctz > clz) ? (((uint8_t)1 << 3) | nbytes) : nbytes;                          \
+  } while (0)
+
+static FORCE_INLINE void cmprPutDouble(uint64_t diff, uint8_t flag, char *output, int32_t *pos, bool wide) {
+  uint8_t nbytes = (flag & INT8MASK(3)) + 1;
+  diff >>= (LONG_BYTES * BITS_PER_BYTE - nbytes * BITS_PER_BYTE) * (flag >> 3);
+  memcpy(output + *pos, &diff, wide ? LONG_BYTES : nbytes);
+  *pos += nbytes;
+}
+
+static FORCE_INLINE void cmprPutFloat(uint32_t diff, uint8_t flag, char *output, int32_t *pos, bool wide) {
+  uint8_t nbytes = (flag & INT8MASK(3)) + 1;
+  diff >>= (FLOAT_BYTES * BITS_PER_BYTE - nbytes * BITS_PER_BYTE) * (flag >> 3);
+  memcpy(output + *pos, &diff, wide ? FLOAT_BYTES : nbytes);
+  *pos += nbytes;
+}
+
+static int32_t cmprDoublePack(const uint64_t *diff, int32_t num, bool tail, char *output, int32_t *pos,
+                              int32_t limit) {
+  int32_t opos = *pos;
+  int32_t i = 0;
+  for (; i + 1 < num; i += 2) {
+    uint8_t flag1, flag2;
+    CMPR_FLOAT_FLAG(diff[i], LONG_BYTES, BUILDIN_CLZL, BUILDIN_CTZL, flag1);
+    CMPR_FLOAT_FLAG(diff[i + 1], LONG_BYTES, BUILDIN_CLZL, BUILDIN_CTZL, flag2);
+    int32_t nbyte1 = (flag1 & INT8MASK(3)) + 1;
+    int32_t nbyte2 = (flag2 & INT8MASK(3)) + 1;
+    if (opos + 1 + nbyte1 + nbyte2 > limit) return CMPR_TRANS_RAW;
+
+    bool wide = (opos + 1 + nbyte1 + LONG_BYTES <= limit);
+    output[opos++] = (char)(flag1 | (flag2 << 4));
+    cmprPutDouble(diff[i], flag1, output, &opos, wide);
+    cmprPutDouble(diff[i + 1], flag2, output, &opos, wide);
+  }
+
+  if (tail && i < num) {
+    uint8_t flag1;
+    CMPR_FLOAT_FLAG(diff[i], LONG_BYTES, BUILDIN_CLZL, BUILDIN_CTZL, flag1);
+    int32_t nbyte1 = (flag1 & INT8MASK(3)) + 1;
+    if (opos + 1 + nbyte1 + 1 > limit) return CMPR_TRANS_RAW;
+    output[opos++] = (char)flag1;
+    cmprPutDouble(diff[i], flag1, output, &opos, false);
+    cmprPutDouble(0, 0, output, &opos, false);
+  }
+
+  *pos = opos;
+  return CMPR_TRANS_OK;
+}
+
+static int32_t cmprFloatPack(const uint32_t *diff, int32_t num, bool tail, char *output, int32_t *pos,
+                             int32_t limit) {
+  int32_t opos = *pos;
+  int32_t i = 0;
+  for (; i + 1 < num; i += 2) {
+    uint8_t flag1, flag2;
+    CMPR_FLOAT_FLAG(diff[i], FLOAT_BYTES, BUILDIN_CLZ, BUILDIN_CTZ, flag1);
+    CMPR_FLOAT_FLAG(diff[i + 1], FLOAT_BYTES, BUILDIN_CLZ, BUILDIN_CTZ, flag2);
+    int32_t nbyte1 = (flag1 & INT8MASK(3)) + 1;
+    int32_t nbyte2 = (flag2 & INT8MASK(3)) + 1;
+    if (opos + 1 + nbyte1 + nbyte2 > limit) return CMPR_TRANS_RAW;
+
+    bool wide = (opos + 1 + nbyte1 + FLOAT_BYTES <= limit);
+    output[opos++] = (char)(flag1 | (flag2 << 4));
+    cmprPutFloat(diff[i], flag1, output, &opos, wide);
+    cmprPutFloat(diff[i + 1], flag2, output, &opos, wide);
+  }
+
+  if (tail && i < num) {
+    uint8_t flag1;
+    CMPR_FLOAT_FLAG(diff[i], FLOAT_BYTES, BUILDIN_CLZ, BUILDIN_CTZ, flag1);
+    int32_t nbyte1 = (flag1 & INT8MASK(3)) + 1;
+    if (opos + 1 + nbyte1 + 1 > limit) return CMPR_TRANS_RAW;
+    output[opos++] = (char)flag1;
+    cmprPutFloat(diff[i], flag1, output, &opos, false);
+    cmprPutFloat(0, 0, output, &opos, false);
+  }
+
+  *pos = opos;
+  return CMPR_TRANS_OK;
+}
+
+/* ------------------------------------------- AVX2 transforms --------------------------------------------------- */
+// ZIGZAG_ENCODE(int64_t, v) for 4 lanes, AVX2 has no arithmetic right shift for 64-bit lanes
+static FORCE_INLINE __m256i cmprZigzagAvx2(__m256i v) {
+  __m256i sign = _mm256_cmpgt_epi64(_mm256_setzero_si256(), v);
+  return _mm256_xor_si256(_mm256_slli_epi64(v, 1), sign);
+}
+
+// a - b for 4 lanes, *bad collects overflow lanes and lanes where b is INT64_MIN
+static FORCE_INLINE __m256i cmprSubAvx2(__m256i a, __m256i b, __m256i *ovf, __m256i *amb) {
+  __m256i r = _mm256_sub_epi64(a, b);
+  *ovf = _mm256_or_si256(*ovf, _mm256_and_si256(_mm256_xor_si256(a, b), _mm256_xor_si256(a, r)));
+  *amb = _mm256_or_si256(*amb, _mm256_cmpeq_epi64(b, _mm256_set1_epi64x(INT64_MIN)));
+  return r;
+}
+
+static FORCE_INLINE int32_t cmprTransResultAvx2(__m256i ovf, __m256i amb) {
+  if (_mm256_movemask_pd(_mm256_castsi256_pd(amb))) return CMPR_TRANS_FALLBACK;
+  if (_mm256_movemask_pd(_mm256_castsi256_pd(ovf))) return CMPR_TRANS_RAW;
+  return CMPR_TRANS_OK;
+}
+
+static int32_t cmprTsTransformAvx2(const int64_t *istream, int32_t start, int32_t end, uint64_t *zz) {
+  __m256i ovf = _mm256_setzero_si256();
+  __m256i amb = _mm256_setzero_si256();
+  int32_t i = start;
+  for (; i + 4 <= end; i += 4) {
+    __m256i v2 = _mm256_loadu_si256((const __m256i *)(istream + i));
+    __m256i v1 = _mm256_loadu_si256((const __m256i *)(istream + i - 1));
+    __m256i v0 = _mm256_loadu_si256((const __m256i *)(istream + i - 2));
+    __m256i d1 = cmprSubAvx2(v2, v1, &ovf, &amb);
+    __m256i d0 = cmprSubAvx2(v1, v0, &ovf, &amb);
+    __m256i dod = cmprSubAvx2(d1, d0, &ovf, &amb);
+    _mm256_storeu_si256((__m256i *)(zz + i - start), cmprZigzagAvx2(dod));
+  }
+
+  int32_t code = cmprTransResultAvx2(ovf, amb);
+  for (; code == CMPR_TRANS_OK && i < end; ++i) {
+    code = cmprTsDodScalar(istream, i, zz + i - start);
+  }
+  return code;
+}
+
+// load 4 integers of the given type and sign extend them to 64 bits
+static FORCE_INLINE __m256i cmprLoadIntAvx2(const char *input, int32_t i, char type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT: {
+      int32_t v = 0;
+      memcpy(&v, input + i, sizeof(v));
+      return _mm256_cvtepi8_epi64(_mm_cvtsi32_si128(v));
+    }
+    case TSDB_DATA_TYPE_SMALLINT:
+      return _mm256_cvtepi16_epi64(_mm_loadl_epi64((const __m128i *)(input + i * SHORT_BYTES)));
+    case TSDB_DATA_TYPE_INT:
+      return _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)(input + i * INT_BYTES)));
+    default:
+      return _mm256_loadu_si256((const __m256i *)(input + i * LONG_BYTES));
+  }
+}
+
+static int32_t cmprIntTransformAvx2(const char *input, int32_t start, int32_t end, uint64_t *zz, char type) {
+  __m256i ovf = _mm256_setzero_si256();
+  __m256i amb = _mm256_setzero_si256();
+  __m256i maxVal = _mm256_set1_epi64x(SIMPLE8B_MAX_INT64 - 1);
+  int32_t i = start;
+  int32_t code = CMPR_TRANS_OK;
+
+  if (i == 0 && i < end) {
+    code = cmprIntZigzagScalar(input, i, zz, type);
+    if (code) return code;
+    i++;
+  }
+
+  for (; i + 4 <= end; i += 4) {
+    __m256i curr = cmprLoadIntAvx2(input, i, type);
+    __m256i prev = cmprLoadIntAvx2(input, i - 1, type);
+    __m256i v = cmprZigzagAvx2(cmprSubAvx2(curr, prev, &ovf, &amb));
+    // zigzag values are unsigned, the ones with the highest bit set are too large as well
+    ovf = _mm256_or_si256(ovf, _mm256_or_si256(v, _mm256_cmpgt_epi64(v, maxVal)));
+    _mm256_storeu_si256((__m256i *)(zz + i - start), v);
+  }
+
+  code = cmprTransResultAvx2(ovf, amb);
+  for (; code == CMPR_TRANS_OK && i < end; ++i) {
+    code = cmprIntZigzagScalar(input, i, zz + i - start, type);
+  }
+  return code;
+}
+
+static void cmprDoubleTransformAvx2(const uint64_t *istream, int32_t start, int32_t end, uint64_t *diff) {
+  int32_t i = start;
+  if (i == 0 && i < end) {
+    diff[0] = istream[0];
+    i++;
+  }
+  for (; i + 4 <= end; i += 4) {
+    __m256i curr = _mm256_loadu_si256((const __m256i *)(istream + i));
+    __m256i prev = _mm256_loadu_si256((const __m256i *)(istream + i - 1));
+    _mm256_storeu_si256((__m256i *)(diff + i - start), _mm256_xor_si256(curr, prev));
+  }
+  for (; i < end; ++i) {
+    diff[i - start] = istream[i] ^ istream[i - 1];
+  }
+}
+
+static void cmprFloatTransformAvx2(const uint32_t *istream, int32_t start, int32_t end, uint32_t *diff) {
+  int32_t i = start;
+  if (i == 0 && i < end) {
+    diff[0] = istream[0];
+    i++;
+  }
+  for (; i + 8 <= end; i += 8) {
+    __m256i curr = _mm256_loadu_si256((const __m256i *)(istream + i));
+    __m256i prev = _mm256_loadu_si256((const __m256i *)(istream + i - 1));
+    _mm256_storeu_si256((__m256i *)(diff + i - start), _mm256_xor_si256(curr, prev));
+  }
+  for (; i < end; ++i) {
+    diff[i - start] = istream[i] ^ istream[i - 1];
+  }
+}
+
+/* ------------------------------------------- AVX512 transforms ------------------------------------------------- */
+#ifdef __AVX512F__
+static FORCE_INLINE __m512i cmprSubAvx512(__m512i a, __m512i b, __mmask8 *ovf, __mmask8 *amb) {
+  __m512i r = _mm512_sub_epi64(a, b);
+  __m512i x = _mm512_and_si512(_mm512_xor_si512(a, b), _mm512_xor_si512(a, r));
+  *ovf |= _mm512_cmplt_epi64_mask(x, _mm512_setzero_si512());
+  *amb |= _mm512_cmpeq_epi64_mask(b, _mm512_set1_epi64(INT64_MIN));
+  return r;
+}
+
+static FORCE_INLINE __m512i cmprZigzagAvx512(__m512i v) {
+  return _mm512_xor_si512(_mm512_slli_epi64(v, 1), _mm512_srai_epi64(v, 63));
+}
+
+static int32_t cmprTsTransformAvx512(const int64_t *istream, int32_t start, int32_t end, uint64_t *zz) {
+  __mmask8 ovf = 0, amb = 0;
+  int32_t  i = start;
+  for (; i + 8 <= end; i += 8) {
+    __m512i v2 = _mm512_loadu_si512((const void *)(istream + i));
+    __m512i v1 = _mm512_loadu_si512((const void *)(istream + i - 1));
+    __m512i v0 = _mm512_loadu_si512((const void *)(istream + i - 2));
+    __m512i d1 = cmprSubAvx512(v2, v1, &ovf, &amb);
+    __m512i d0 = cmprSubAvx512(v1, v0, &ovf, &amb);
+    __m512i dod = cmprSubAvx512(d1, d0, &ovf, &amb);
+    _mm512_storeu_si512((void *)(zz + i - start), cmprZigzagAvx512(dod));
+  }
+
+  int32_t code = amb ? CMPR_TRANS_FALLBACK : (ovf ? CMPR_TRANS_RAW : CMPR_TRANS_OK);
+  for (; code == CMPR_TRANS_OK && i < end; ++i) {
+    code = cmprTsDodScalar(istream, i, zz + i - start);
+  }
+  return code;
+}
+
+static FORCE_INLINE __m512i cmprLoadIntAvx512(const char *input, int32_t i, char type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT:
+      return _mm512_cvtepi8_epi64(_mm_loadl_epi64((const __m128i *)(input + i)));
+    case TSDB_DATA_TYPE_SMALLINT:
+      return _mm512_cvtepi16_epi64(_mm_loadu_si128((const __m128i *)(input + i * SHORT_BYTES)));
+    case TSDB_DATA_TYPE_INT:
+      return _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i *)(input + i * INT_BYTES)));
+    default:
+      return _mm512_loadu_si512((const void *)(input + i * LONG_BYTES));
+  }
+}
+
+static int32_t cmprIntTransformAvx512(const char *input, int32_t start, int32_t end, uint64_t *zz, char type) {
+  __mmask8 ovf = 0, amb = 0;
+  __m512i  maxVal = _mm512_set1_epi64(SIMPLE8B_MAX_INT64);
+  int32_t  i = start;
+  int32_t  code = CMPR_TRANS_OK;
+
+  if (i == 0 && i < end) {
+    code = cmprIntZigzagScalar(input, i, zz, type);
+    if (code) return code;
+    i++;
+  }
+
+  for (; i + 8 <= end; i += 8) {
+    __m512i curr = cmprLoadIntAvx512(input, i, type);
+    __m512i prev = cmprLoadIntAvx512(input, i - 1, type);
+    __m512i v = cmprZigzagAvx512(cmprSubAvx512(curr, prev, &ovf, &amb));
+    ovf |= _mm512_cmpge_epu64_mask(v, maxVal);
+    _mm512_storeu_si512((void *)(zz + i - start), v);
+  }
+
+  code = amb ? CMPR_TRANS_FALLBACK : (ovf ? CMPR_TRANS_RAW : CMPR_TRANS_OK);
+  for (; code == CMPR_TRANS_OK && i < end; ++i) {
+    code = cmprIntZigzagScalar(input, i, zz + i - start, type);
+  }
+  return code;
+}
+#endif
+#endif
+
+/* ------------------------------------------- public encoders --------------------------------------------------- */
+int32_t tsCompressTimestampImpAvx2(const char *const input, const int32_t nelements, char *const output) {
+#ifdef __AVX2__
+  return cmprTsEncode(input, nelements, output, cmprTsTransformAvx2);
+#else
+  uError("unable run %s without avx2 instructions", __func__);
+  return -1;
+#endif
+}
+
+int32_t tsCompressTimestampImpAvx512(const char *const input, const int32_t nelements, char *const output) {
+#if defined(__AVX2__) && defined(__AVX512F__)
+  return cmprTsEncode(input, nelements, output, cmprTsTransformAvx512);
+#else
+  uError("unable run %s without avx512 instructions", __func__);
+  return -1;
+#endif
+}
+
+int32_t tsCompressINTImpAvx2(const char *const input, const int32_t nelements, char *const output, const char type) {
+#ifdef __AVX2__
+  if (getWordLength(type) < 0) return -1;
+  return cmprS8bPack(input, nelements, output, type, cmprIntTransformAvx2);
+#else
+  uError("unable run %s without avx2 instructions", __func__);
+  return -1;
+#endif
+}
+
+int32_t tsCompressINTImpAvx512(const char *const input, const int32_t nelements, char *const output,
+                               const char type) {
+#if defined(__AVX2__) && defined(__AVX512F__)
+  if (getWordLength(type) < 0) return -1;
+  return cmprS8bPack(input, nelements, output, type, cmprIntTransformAvx512);
+#else
+  uError("unable run %s without avx512 instructions", __func__);
+  return -1;
+#endif
+}
+
+int32_t tsCompressDoubleImpAvx2(const char *const input, const int32_t nelements, char *const output) {
+#ifdef __AVX2__
+  const uint64_t *istream = (const uint64_t *)input;
+  int32_t         byte_limit = nelements * DOUBLE_BYTES + 1;
+  int32_t         opos = 1;
+  uint64_t        diff[CMPR_SIMD_BATCH];
+
+  for (int32_t start = 0; start < nelements; start += CMPR_SIMD_BATCH) {
+    int32_t end = TMIN(start + CMPR_SIMD_BATCH, nelements);
+    cmprDoubleTransformAvx2(istream, start, end, diff);
+    if (cmprDoublePack(diff, end - start, end == nelements, output, &opos, byte_limit) != CMPR_TRANS_OK) {
+      output[0] = 1;
+      memcpy(output + 1, input, byte_limit - 1);
+      return byte_limit;
+    }
+  }
+
+  output[0] = 0;
+  return opos;
+#else
+  uError("unable run %s without avx2 instructions", __func__);
+  return -1;
+#endif
+}
+
+int32_t tsCompressFloatImpAvx2(const char *const input, const int32_t nelements, char *const output) {
+#ifdef __AVX2__
+  const uint32_t *istream = (const uint32_t *)input;
+  int32_t         byte_limit = nelements * FLOAT_BYTES + 1;
+  int32_t         opos = 1;
+  uint32_t        diff[CMPR_SIMD_BATCH];
+
+  for (int32_t start = 0; start < nelements; start += CMPR_SIMD_BATCH) {
+    int32_t end = TMIN(start + CMPR_SIMD_BATCH, nelements);
+    cmprFloatTransformAvx2(istream, start, end, diff);
+    if (cmprFloatPack(diff, end - start, end == nelements, output, &opos, byte_limit) != CMPR_TRANS_OK) {
+      output[0] = 1;
+      memcpy(output + 1, input, byte_limit - 1);
+      return byte_limit;
+    }
+  }
+
+  output[0] = 0;
+  return opos;
+#else
+  uError("unable run %s without avx2 instructions", __func__);
+  return -1;
+#endif
+}
@@ -318,6 +318,48 @@ int8_t tsGetCompressL2Level(uint8_t alg, uint8_t lvl) {
   return 1;
 }
 
+// Relative decode cost of each L2 codec (lz4 == 100), indexed by TCmprL2Type. Used by the auto
+// codec selection to trade compression ratio against read throughput.
+static const int32_t compressL2DecodeCost[] = {100, 100, 380, 170, 100, 900};
+
+// xz and tsz are never picked automatically: xz decodes an order of magnitude slower than lz4 and
+// tsz is lossy for float/double.
+static const uint8_t compressL2AutoCandidates[] = {L2_LZ4, L2_ZSTD, L2_ZLIB};
+
+int32_t tsGetCompressL2DecodeCost(uint8_t l2) {
+  if (l2 >= sizeof(compressL2DecodeCost) / sizeof(compressL2DecodeCost[0])) {
+    return compressL2DecodeCost[L2_LZ4];
+  }
+  return compressL2DecodeCost[l2];
+}
+
+int32_t tsCompressL2Select(const char *pIn, int32_t nIn, const char type, char *pBuf, int32_t nBuf, uint8_t *l2) {
+  if (pIn == NULL || nIn <= 0 || pBuf == NULL || nBuf < nIn + COMP_OVERFLOW_BYTES || l2 == NULL) {
+    return TSDB_CODE_INVALID_PARA;
+  }
+
+  uint8_t best = L2_LZ4;
+  int64_t bestScore = INT64_MAX;
+  for (int32_t i = 0; i < sizeof(compressL2AutoCandidates) / sizeof(compressL2AutoCandidates[0]); i++) {
+    uint8_t alg = compressL2AutoCandidates[i];
+    // trial at the cheapest level, the selected codec is applied at the configured level afterwards
+    int32_t len = compressL2Dict[alg].comprFn(pIn, nIn, pBuf, nBuf, type, tsGetCompressL2Level(alg, L2_LVL_LOW));
+    if (len <= 0) {
+      continue;
+    }
+
+    int64_t score = (int64_t)len * compressL2DecodeCost[alg];
+    if (score < bestScore) {
+      bestScore = score;
+      best = alg;
+    }
+  }
+
+  uTrace("auto compress select:%s, size:%d, type:%s", compressL2Dict[best].name, nIn, tDataTypes[type].name);
+  *l2 = best;
+  return 0;
+}
+
 static const int32_t TEST_NUMBER = 1;
 #define is_bigendian()     ((*(char *)&TEST_NUMBER) == 0)
 #define SIMPLE8B_MAX_INT64 ((uint64_t)1152921504606846974LL)
@@ -346,6 +388,19 @@ void tsCompressExit() { tdszExit(); }
  * Compress Integer (Simple8B).
  */
 int32_t tsCompressINTImp(const char *const input, const int32_t nelements, char *const output, const char type) {
+  if (tsSIMDEnable && tsAVX512Enable && tsAVX512Supported) {
+    int32_t cnt = tsCompressINTImpAvx512(input, nelements, output, type);
+    if (cnt >= 0) {
+      return cnt;
+    }
+  }
+  if (tsSIMDEnable && tsAVX2Supported) {
+    int32_t cnt = tsCompressINTImpAvx2(input, nelements, output, type);
+    if (cnt >= 0) {
+      return cnt;
+    }
+  }
+
   // Selector value:              0    1   2   3   4   5   6   7   8  9  10  11
   // 12  13  14  15
   char    bit_per_integer[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
@@ -478,6 +533,13 @@ int32_t tsDecompressINTImp(const char *const input, const int32_t nelements, cha
     }
   }
 
+  if (tsSIMDEnable && tsAVX2Supported && type == TSDB_DATA_TYPE_BIGINT) {
+    int32_t cnt = tsDecompressBigintImplAvx2(input, nelements, output);
+    if (cnt >= 0) {
+      return cnt;
+    }
+  }
+
   // Selector value: 0    1   2   3   4   5   6   7   8  9  10  11 12  13  14  15
   char    bit_per_integer[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
   int32_t selector_to_elems[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
@@ -607,6 +669,18 @@ int32_t tsCompressBoolImp(const char *const input, const int32_t nelements, char
 }
 
 int32_t tsDecompressBoolImp(const char *const input, const int32_t nelements, char *const output) {
+  if (tsSIMDEnable && tsAVX2Supported) {
+    int32_t cnt = tsDecompressBoolImpAvx2(input, nelements, output);
+    if (cnt >= 0) {
+      return cnt;
+    }
+  }
+#if defined(__ARM_NEON) && defined(__aarch64__)
+  if (tsSIMDEnable) {
+    return tsDecompressBoolImpNeon(input, nelements, output);
+  }
+#endif
+
   int32_t ipos = -1, opos = 0;
   int32_t ele_per_byte = BITS_PER_BYTE / 2;
 
@@ -767,6 +841,19 @@ int32_t tsCompressTimestampImp(const char *const input, const int32_t nelements,
 
   if (nelements == 0) return 0;
 
+  if (tsSIMDEnable && tsAVX512Enable && tsAVX512Supported) {
+    int32_t cnt = tsCompressTimestampImpAvx512(input, nelements, output);
+    if (cnt >= 0) {
+      return cnt;
+    }
+  }
+  if (tsSIMDEnable && tsAVX2Supported) {
+    int32_t cnt = tsCompressTimestampImpAvx2(input, nelements, output);
+    if (cnt >= 0) {
+      return cnt;
+    }
+  }
+
   int64_t *istream = (int64_t *)input;
 
   int64_t prev_value = istream[0];
@@ -971,6 +1058,14 @@ void encodeDoubleValue(uint64_t diff, uint8_t flag, char *const output, int32_t
 }
 
 int32_t tsCompressDoubleImp(const char *const input, const int32_t nelements, char *const output) {
+  // use AVX2 implementation when allowed, the output is the same as the one below
+  if (tsSIMDEnable && tsAVX2Supported) {
+    int32_t cnt = tsCompressDoubleImpAvx2(input, nelements, output);
+    if (cnt >= 0) {
+      return cnt;
+    }
+  }
+
   int32_t byte_limit = nelements * DOUBLE_BYTES + 1;
   int32_t opos = 1;
 
@@ -1130,6 +1225,14 @@ void encodeFloatValue(uint32_t diff, uint8_t flag, char *const output, int32_t *
 }
 
 int32_t tsCompressFloatImp(const char *const input, const int32_t nelements, char *const output) {
+  // use AVX2 implementation when allowed, the output is the same as the one below
+  if (tsSIMDEnable && tsAVX2Supported) {
+    int32_t cnt = tsCompressFloatImpAvx2(input, nelements, output);
+    if (cnt >= 0) {
+      return cnt;
+    }
+  }
+
   float  *istream = (float *)input;
   int32_t byte_limit = nelements * FLOAT_BYTES + 1;
   int32_t opos = 1;
@@ -1604,6 +1707,9 @@ int32_t tsDecompressBigint(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int
 #define FUNC_COMPRESS_IMPL(pIn, nIn, nEle, pOut, nOut, alg, pBuf, nBuf, type, compress)                               \
   do {                                                                                                                \
     DEFINE_VAR(alg)                                                                                                   \
+    if (l2 == L2_AUTO) {                                                                                              \
+      l2 = L2_LZ4; /* callers resolve auto per block, fall back to lz4 if it slips through */                         \
+    }                                                                                                                 \
     if (l1 != L1_DISABLED && l2 == L2_DISABLED) {                                                                     \
       if (compress) {                                                                                                 \
         uTrace("encode:%s, compress:%s, level:%s, type:%s", compressL1Dict[l1].name, "disabled", "disabled",          \
@@ -15,7 +15,11 @@
 
 #include "tcompression.h"
 
-#ifdef __AVX2__
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#if defined(__AVX2__) || (defined(__ARM_NEON) && defined(__aarch64__))
 char tsSIMDEnable = 1;
 #else
 char tsSIMDEnable = 0;
@@ -193,6 +197,157 @@ int32_t tsDecompressIntImpl_Hw(const char *const input, const int32_t nelements,
 #endif
 }
 
+int32_t tsDecompressBigintImplAvx2(const char *const input, const int32_t nelements, char *const output) {
+#ifdef __AVX2__
+  // Selector value:           0  1   2   3   4   5   6   7   8  9  10  11 12  13  14  15
+  char    bit_per_integer[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
+  int32_t selector_to_elems[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
+
+  const char *ip = input + 1;
+  int64_t    *p = (int64_t *)output;
+  int32_t     _pos = 0;
+  int64_t     prevValue = 0;
+
+  __m256i zero = _mm256_setzero_si256();
+  __m256i one = _mm256_set1_epi64x(1);
+
+  while (_pos < nelements) {
+    uint64_t w = 0;
+    memcpy(&w, ip, LONG_BYTES);
+
+    char    selector = (char)(w & INT64MASK(4));
+    char    bit = bit_per_integer[(int32_t)selector];
+    int32_t elems = selector_to_elems[(int32_t)selector];
+    int32_t num = TMIN(elems, nelements - _pos);
+    int32_t batch = num >> 2;
+    int32_t remain = num & 0x03;
+
+    if (selector == 0 || selector == 1) {
+      __m256i prev = _mm256_set1_epi64x(prevValue);
+      for (int32_t i = 0; i < batch; ++i) {
+        _mm256_storeu_si256((__m256i *)&p[_pos], prev);
+        _pos += 4;
+      }
+      for (int32_t i = 0; i < remain; ++i) {
+        p[_pos++] = prevValue;
+      }
+    } else {
+      __m256i base = _mm256_set1_epi64x(w);
+      __m256i maskVal = _mm256_set1_epi64x(INT64MASK(bit));
+      __m256i shiftBits = _mm256_set_epi64x(bit * 3 + 4, bit * 2 + 4, bit + 4, 4);
+      __m256i inc = _mm256_set1_epi64x(bit << 2);
+
+      for (int32_t i = 0; i < batch; ++i) {
+        __m256i zigzagVal = _mm256_and_si256(_mm256_srlv_epi64(base, shiftBits), maskVal);
+
+        // ZIGZAG_DECODE(T, v) (((v) >> 1) ^ -((T)((v)&1)))
+        __m256i signmask = _mm256_sub_epi64(zero, _mm256_and_si256(zigzagVal, one));
+        __m256i delta = _mm256_xor_si256(_mm256_srli_epi64(zigzagVal, 1), signmask);
+
+        // prefix sum of the 4 deltas: shift by one lane and add, then shift by two lanes and add
+        __m256i cumSum = _mm256_add_epi64(
+            delta, _mm256_blend_epi32(_mm256_permute4x64_epi64(delta, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x03));
+        cumSum = _mm256_add_epi64(
+            cumSum, _mm256_blend_epi32(_mm256_permute4x64_epi64(cumSum, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x0F));
+        cumSum = _mm256_add_epi64(cumSum, _mm256_set1_epi64x(prevValue));
+        _mm256_storeu_si256((__m256i *)&p[_pos], cumSum);
+
+        shiftBits = _mm256_add_epi64(shiftBits, inc);
+        prevValue = p[_pos + 3];
+        _pos += 4;
+      }
+
+      // handle the remain value
+      int32_t v = 4 + batch * bit * 4;
+      for (int32_t i = 0; i < remain; i++) {
+        uint64_t zigzag_value = ((w >> v) & INT64MASK(bit));
+        prevValue += ZIGZAG_DECODE(int64_t, zigzag_value);
+        p[_pos++] = prevValue;
+        v += bit;
+      }
+    }
+
+    ip += LONG_BYTES;
+  }
+
+  return nelements * LONG_BYTES;
+#else
+  uError("unable run %s without avx2 instructions", __func__);
+  return -1;
+#endif
+}
+
+int32_t tsDecompressBoolImpAvx2(const char *const input, const int32_t nelements, char *const output) {
+#ifdef __AVX2__
+  // each input byte holds 4 values of 2 bits, 0b01 is true, 0b10 is null and the others are false
+  __m256i spread = _mm256_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                    3, 3, 3, 3);
+  __m256i fieldMask = _mm256_set1_epi32(0xC0300C03);
+  __m256i trueVal = _mm256_set1_epi32(0x40100401);
+  __m256i nullVal = _mm256_set1_epi32(0x80200802);
+
+  int32_t i = 0;
+  for (; i + 32 <= nelements; i += 32) {
+    // spread 8 input bytes to 32 output bytes, input bytes 0 ~ 3 to the lower lane and 4 ~ 7 to the upper one
+    __m128i packed = _mm_loadl_epi64((const __m128i *)(input + (i >> 2)));
+    __m256i bytes = _mm256_inserti128_si256(_mm256_castsi128_si256(packed), _mm_srli_si128(packed, 4), 1);
+    bytes = _mm256_shuffle_epi8(bytes, spread);
+    __m256i field = _mm256_and_si256(bytes, fieldMask);
+    __m256i isTrue = _mm256_and_si256(_mm256_cmpeq_epi8(field, trueVal), _mm256_set1_epi8(1));
+    __m256i isNull = _mm256_and_si256(_mm256_cmpeq_epi8(field, nullVal), _mm256_set1_epi8(TSDB_DATA_BOOL_NULL));
+    _mm256_storeu_si256((__m256i *)(output + i), _mm256_or_si256(isTrue, isNull));
+  }
+
+  for (; i < nelements; i++) {
+    uint8_t ele = (input[i >> 2] >> (2 * (i & 0x03))) & INT8MASK(2);
+    output[i] = (ele == 1) ? 1 : ((ele == 2) ? TSDB_DATA_BOOL_NULL : 0);
+  }
+
+  return nelements;
+#else
+  uError("unable run %s without avx2 instructions", __func__);
+  return -1;
+#endif
+}
+
+int32_t tsDecompressBoolImpNeon(const char *const input, const int32_t nelements, char *const output) {
+#if defined(__ARM_NEON) && defined(__aarch64__)
+  static const uint8_t spreadIdx[16] = {0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3};
+  static const uint8_t fieldIdx[16] = {0x03, 0x0C, 0x30, 0xC0, 0x03, 0x0C, 0x30, 0xC0,
+                                       0x03, 0x0C, 0x30, 0xC0, 0x03, 0x0C, 0x30, 0xC0};
+  static const uint8_t trueIdx[16] = {0x01, 0x04, 0x10, 0x40, 0x01, 0x04, 0x10, 0x40,
+                                      0x01, 0x04, 0x10, 0x40, 0x01, 0x04, 0x10, 0x40};
+  static const uint8_t nullIdx[16] = {0x02, 0x08, 0x20, 0x80, 0x02, 0x08, 0x20, 0x80,
+                                      0x02, 0x08, 0x20, 0x80, 0x02, 0x08, 0x20, 0x80};
+
+  uint8x16_t spread = vld1q_u8(spreadIdx);
+  uint8x16_t fieldMask = vld1q_u8(fieldIdx);
+  uint8x16_t trueVal = vld1q_u8(trueIdx);
+  uint8x16_t nullVal = vld1q_u8(nullIdx);
+
+  int32_t i = 0;
+  for (; i + 16 <= nelements; i += 16) {
+    uint32_t packed = 0;
+    memcpy(&packed, input + (i >> 2), sizeof(packed));
+    uint8x16_t bytes = vqtbl1q_u8(vreinterpretq_u8_u32(vdupq_n_u32(packed)), spread);
+    uint8x16_t field = vandq_u8(bytes, fieldMask);
+    uint8x16_t isTrue = vandq_u8(vceqq_u8(field, trueVal), vdupq_n_u8(1));
+    uint8x16_t isNull = vandq_u8(vceqq_u8(field, nullVal), vdupq_n_u8(TSDB_DATA_BOOL_NULL));
+    vst1q_u8((uint8_t *)(output + i), vorrq_u8(isTrue, isNull));
+  }
+
+  for (; i < nelements; i++) {
+    uint8_t ele = (input[i >> 2] >> (2 * (i & 0x03))) & INT8MASK(2);
+    output[i] = (ele == 1) ? 1 : ((ele == 2) ? TSDB_DATA_BOOL_NULL : 0);
+  }
+
+  return nelements;
+#else
+  uError("unable run %s without neon instructions", __func__);
+  return -1;
+#endif
+}
+
 #ifdef __AVX2__
 FORCE_INLINE __m256i decodeFloatAvx2(const char *data, const char *flag) {
   __m256i dataVec = _mm256_load_si256((__m256i *)data);
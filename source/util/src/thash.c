@@ -31,6 +31,27 @@
 #define GET_HASH_NODE_DATA(_n) ((char *)(_n) + sizeof(SHashNode))
 #define GET_HASH_PNODE(_n)     ((SHashNode *)((char *)(_n) - sizeof(SHashNode)))
 
+#define HASH_STRIPE_BITS      5
+#define HASH_STRIPE_NUM       (1 << HASH_STRIPE_BITS)
+#define HASH_STRIPE_MIN_SLOTS 8
+#define HASH_STRIPE_LOAD      (0.7)
+#define HASH_REHASH_STEP      64  // old slots moved by each writer while a stripe is rehashing
+#define HASH_INLINE_KEY_LEN   8
+#define HASH_SLOT_EMPTY       ((SHashNode *)0)
+#define HASH_SLOT_DELETED     ((SHashNode *)1)
+#define HASH_SLOT_IS_NODE(_s) ((_s)->pNode > HASH_SLOT_DELETED)
+
+#define HASH_SLAB_CLASS_SIZE   16
+#define HASH_SLAB_MAX_NODE     512
+#define HASH_SLAB_CLASS_NUM    (HASH_SLAB_MAX_NODE / HASH_SLAB_CLASS_SIZE)
+#define HASH_SLAB_MIN_CHUNK    4
+#define HASH_SLAB_MAX_CHUNK    (16 * 1024)
+#define HASH_NODE_SIZE(_k, _d) (sizeof(SHashNode) + (_k) + (_d) + 1)
+
+// while rehashing, the nodes not moved yet will need slots in the new array too
+#define HASH_STRIPE_NEED_RESIZE(_s) \
+  ((_s)->used + ((_s)->oldSlots != NULL ? (_s)->size : 0) + 1 > (_s)->capacity * HASH_STRIPE_LOAD)
+
 #define FREE_HASH_NODE(_fp, _n)      \
   do {                               \
     if (_fp != NULL) {               \
@@ -58,6 +79,28 @@ typedef struct SHashEntry {
   SHashNode *next;
 } SHashEntry;
 
+typedef struct SHashSlot {
+  SHashNode *pNode;    // HASH_SLOT_EMPTY, HASH_SLOT_DELETED or the node
+  uint32_t   hashVal;  // mixed hash value, see taosHashMix
+  uint32_t   keyLen;
+  char       key[HASH_INLINE_KEY_LEN];  // copy of short keys, so probing doesn't touch the node
+} SHashSlot;
+
+typedef struct SHashStripe {
+  SRWLatch   latch;
+  int32_t    size;         // number of nodes, same meaning as SHashObj::size
+  uint32_t   capacity;     // number of slots
+  uint32_t   used;         // slots not empty, tombstones included
+  SHashSlot *slots;
+  SHashSlot *oldSlots;     // slots being migrated by an incremental rehash
+  uint32_t   oldCapacity;
+  uint32_t   rehashIdx;    // next old slot to migrate
+  SHashNode *freeList[HASH_SLAB_CLASS_NUM];
+  uint16_t   chunkNodes[HASH_SLAB_CLASS_NUM];  // number of nodes in the next slab chunk of a class
+  SArray    *pChunks;      // slab chunks, released in taosHashCleanup
+  char       padding[64];  // keep the latches of neighbour stripes out of the same cache line
+} SHashStripe;
+
 struct SHashObj {
   int64_t           size;          // number of elements in hash table
   size_t            capacity;      // number of slots
@@ -70,6 +113,7 @@ struct SHashObj {
   bool              enableUpdate;  // enable update
   SArray           *pMemBlock;     // memory block allocated for SHashEntry
   _hash_before_fn_t callbackFp;    // function invoked before return the value to caller
+  SHashStripe      *stripes;       // HASH_STRIPED_LOCK only, hashList is not used then
   //  int64_t           compTimes;
 };
 
@@ -232,6 +276,34 @@ static FORCE_INLINE bool taosHashTableEmpty(const SHashObj *pHashObj);
  */
 static FORCE_INLINE bool taosHashTableEmpty(const SHashObj *pHashObj) { return taosHashGetSize(pHashObj) == 0; }
 
+/*
+ * HASH_STRIPED_LOCK implementation, see the end of this file
+ */
+static int32_t taosHashStripeInit(SHashObj *pHashObj, size_t capacity);
+static int32_t taosHashStripePut(SHashObj *pHashObj, const void *key, size_t keyLen, const void *data, size_t size);
+static void   *taosHashStripeGet(SHashObj *pHashObj, const void *key, size_t keyLen, void **d, int32_t *size,
+                                 bool addRef);
+static int32_t taosHashStripeRemove(SHashObj *pHashObj, const void *key, size_t keyLen);
+static void    taosHashStripeClear(SHashObj *pHashObj);
+static void    taosHashStripeCleanup(SHashObj *pHashObj);
+static void   *taosHashStripeIterate(SHashObj *pHashObj, void *p);
+static void    taosHashStripeCancelIterate(SHashObj *pHashObj, void *p);
+static int32_t taosHashStripeGetSize(const SHashObj *pHashObj);
+static int32_t taosHashStripeMaxProbeLength(const SHashObj *pHashObj);
+static size_t  taosHashStripeGetMemSize(const SHashObj *pHashObj);
+
+/**
+ * copy the payload of a found node to the buffer of caller, grow it if required
+ *
+ * @param pHashObj   hash table object
+ * @param pNode      the node found
+ * @param d          destination buffer, may be allocated or reallocated here if size is not NULL
+ * @param size       size of the destination buffer
+ * @param addRef     add the reference count of node
+ * @return           payload of node, NULL if out of memory
+ */
+static char *doGetNodeData(SHashObj *pHashObj, SHashNode *pNode, void **d, int32_t *size, bool addRef);
+
 SHashObj *taosHashInit(size_t capacity, _hash_fn_t fn, bool update, SHashLockTypeE type) {
   if (fn == NULL) {
     terrno = TSDB_CODE_INVALID_PARA;
@@ -247,6 +319,29 @@ SHashObj *taosHashInit(size_t capacity, _hash_fn_t fn, bool update, SHashLockTyp
     return NULL;
   }
 
+  pHashObj->stripes = NULL;
+  if (type == HASH_STRIPED_LOCK) {
+    pHashObj->size = 0;
+    pHashObj->capacity = 0;
+    pHashObj->hashList = NULL;
+    pHashObj->pMemBlock = NULL;
+    pHashObj->equalFp = memcmp;
+    pHashObj->hashFp = fn;
+    pHashObj->type = type;
+    pHashObj->lock = 0;
+    pHashObj->enableUpdate = update;
+    pHashObj->freeFp = NULL;
+    pHashObj->callbackFp = NULL;
+
+    int32_t code = taosHashStripeInit(pHashObj, capacity);
+    if (code != 0) {
+      taosMemoryFree(pHashObj);
+      terrno = code;
+      return NULL;
+    }
+    return pHashObj;
+  }
+
   // the max slots is not defined by user
   pHashObj->capacity = taosHashCapacity((int32_t)capacity);
   pHashObj->size = 0;
@@ -313,6 +408,9 @@ int32_t taosHashGetSize(const SHashObj *pHashObj) {
   if (pHashObj == NULL) {
     return 0;
   }
+  if (pHashObj->type == HASH_STRIPED_LOCK) {
+    return taosHashStripeGetSize(pHashObj);
+  }
   return (int32_t)atomic_load_64((int64_t *)&pHashObj->size);
 }
 
@@ -321,6 +419,10 @@ int32_t taosHashPut(SHashObj *pHashObj, const void *key, size_t keyLen, const vo
     return terrno = TSDB_CODE_INVALID_PTR;
   }
 
+  if (pHashObj->type == HASH_STRIPED_LOCK) {
+    return taosHashStripePut(pHashObj, key, keyLen, data, size);
+  }
+
   int32_t     code = TSDB_CODE_SUCCESS;
   uint32_t hashVal = (*pHashObj->hashFp)(key, (uint32_t)keyLen);
 
@@ -405,6 +507,10 @@ void *taosHashGetImpl(SHashObj *pHashObj, const void *key, size_t keyLen, void *
     return NULL;
   }
 
+  if (pHashObj->type == HASH_STRIPED_LOCK) {
+    return taosHashStripeGet(pHashObj, key, keyLen, d, size, addRef);
+  }
+
   if ((atomic_load_64((int64_t *)&pHashObj->size) == 0)) {
     return NULL;
   }
@@ -428,43 +534,47 @@ void *taosHashGetImpl(SHashObj *pHashObj, const void *key, size_t keyLen, void *
 
   SHashNode *pNode = doSearchInEntryList(pHashObj, pe, key, keyLen, hashVal);
   if (pNode != NULL) {
-    if (pHashObj->callbackFp != NULL) {
-      pHashObj->callbackFp(GET_HASH_NODE_DATA(pNode));
-    }
+    data = doGetNodeData(pHashObj, pNode, d, size, addRef);
+  }
 
-    if (size != NULL) {
-      if (*d == NULL) {
-        *size = pNode->dataLen;
-        *d = taosMemoryCalloc(1, *size);
-        if (*d == NULL) {
-          return NULL;
-        }
-      } else if (*size < pNode->dataLen) {
-        *size = pNode->dataLen;
-        char *tmp = taosMemoryRealloc(*d, *size);
-        if (tmp == NULL) {
-          return NULL;
-        }
+  taosHashEntryRUnlock(pHashObj, pe);
+  taosHashRUnlock(pHashObj);
 
-        *d = tmp;
-      }
-    }
+  return data;
+}
 
-    if (addRef) {
-      (void)atomic_add_fetch_16(&pNode->refCount, 1);
-    }
+char *doGetNodeData(SHashObj *pHashObj, SHashNode *pNode, void **d, int32_t *size, bool addRef) {
+  if (pHashObj->callbackFp != NULL) {
+    pHashObj->callbackFp(GET_HASH_NODE_DATA(pNode));
+  }
 
-    if (*d != NULL) {
-      memcpy(*d, GET_HASH_NODE_DATA(pNode), pNode->dataLen);
+  if (size != NULL) {
+    if (*d == NULL) {
+      *size = pNode->dataLen;
+      *d = taosMemoryCalloc(1, *size);
+      if (*d == NULL) {
+        return NULL;
+      }
+    } else if (*size < pNode->dataLen) {
+      *size = pNode->dataLen;
+      char *tmp = taosMemoryRealloc(*d, *size);
+      if (tmp == NULL) {
+        return NULL;
+      }
+
+      *d = tmp;
     }
+  }
 
-    data = GET_HASH_NODE_DATA(pNode);
+  if (addRef) {
+    (void)atomic_add_fetch_16(&pNode->refCount, 1);
   }
 
-  taosHashEntryRUnlock(pHashObj, pe);
-  taosHashRUnlock(pHashObj);
+  if (*d != NULL) {
+    memcpy(*d, GET_HASH_NODE_DATA(pNode), pNode->dataLen);
+  }
 
-  return data;
+  return GET_HASH_NODE_DATA(pNode);
 }
 
 int32_t taosHashRemove(SHashObj *pHashObj, const void *key, size_t keyLen) {
@@ -472,6 +582,10 @@ int32_t taosHashRemove(SHashObj *pHashObj, const void *key, size_t keyLen) {
     return TSDB_CODE_INVALID_PARA;
   }
 
+  if (pHashObj->type == HASH_STRIPED_LOCK) {
+    return taosHashStripeRemove(pHashObj, key, keyLen);
+  }
+
   uint32_t hashVal = (*pHashObj->hashFp)(key, (uint32_t)keyLen);
 
   // disable the resize process
@@ -528,6 +642,11 @@ void taosHashClear(SHashObj *pHashObj) {
     return;
   }
 
+  if (pHashObj->type == HASH_STRIPED_LOCK) {
+    taosHashStripeClear(pHashObj);
+    return;
+  }
+
   SHashNode *pNode, *pNext;
 
   taosHashWLock(pHashObj);
@@ -560,6 +679,11 @@ void taosHashCleanup(SHashObj *pHashObj) {
     return;
   }
 
+  if (pHashObj->type == HASH_STRIPED_LOCK) {
+    taosHashStripeCleanup(pHashObj);
+    return;
+  }
+
   taosHashClear(pHashObj);
   taosMemoryFreeClear(pHashObj->hashList);
 
@@ -580,6 +704,10 @@ int32_t taosHashGetMaxOverflowLinkLength(const SHashObj *pHashObj) {
     return 0;
   }
 
+  if (pHashObj->type == HASH_STRIPED_LOCK) {
+    return taosHashStripeMaxProbeLength(pHashObj);
+  }
+
   int32_t num = 0;
 
   taosHashRLock((SHashObj *)pHashObj);
@@ -708,6 +836,10 @@ size_t taosHashGetMemSize(const SHashObj *pHashObj) {
     return 0;
   }
 
+  if (pHashObj->type == HASH_STRIPED_LOCK) {
+    return taosHashStripeGetMemSize(pHashObj);
+  }
+
   return (pHashObj->capacity * (sizeof(SHashEntry) + sizeof(void *))) + sizeof(SHashNode) * taosHashGetSize(pHashObj) +
          sizeof(SHashObj);
 }
@@ -774,7 +906,11 @@ static void *taosHashReleaseNode(SHashObj *pHashObj, void *p, int *slot) {
 }
 
 void *taosHashIterate(SHashObj *pHashObj, void *p) {
-  if (pHashObj == NULL || pHashObj->size == 0) return NULL;
+  if (pHashObj == NULL) return NULL;
+  if (pHashObj->type == HASH_STRIPED_LOCK) {
+    return taosHashStripeIterate(pHashObj, p);
+  }
+  if (pHashObj->size == 0) return NULL;
 
   int   slot = 0;
   char *data = NULL;
@@ -833,6 +969,11 @@ void *taosHashIterate(SHashObj *pHashObj, void *p) {
 void taosHashCancelIterate(SHashObj *pHashObj, void *p) {
   if (pHashObj == NULL || p == NULL) return;
 
+  if (pHashObj->type == HASH_STRIPED_LOCK) {
+    taosHashStripeCancelIterate(pHashObj, p);
+    return;
+  }
+
   // only add the read lock to disable the resize process
   taosHashRLock(pHashObj);
 
@@ -854,3 +995,545 @@ void *taosHashAcquire(SHashObj *pHashObj, const void *key, size_t keyLen) {
 void taosHashRelease(SHashObj *pHashObj, void *p) { taosHashCancelIterate(pHashObj, p); }
 
 int64_t taosHashGetCompTimes(SHashObj *pHashObj) { return 0 /*atomic_load_64(&pHashObj->compTimes)*/; }
+
+/*************************************************************************
+ *                  HASH_STRIPED_LOCK
+ *************************************************************************/
+// murmur3 finalizer, the default hash of integer keys is the identity and would put them all into one stripe
+static FORCE_INLINE uint32_t taosHashMix(uint32_t h) {
+  h ^= h >> 16;
+  h *= 0x85ebca6b;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35;
+  h ^= h >> 16;
+  return h;
+}
+
+static FORCE_INLINE SHashStripe *taosHashGetStripe(const SHashObj *pHashObj, uint32_t mix) {
+  return &pHashObj->stripes[mix >> (32 - HASH_STRIPE_BITS)];
+}
+
+static SHashNode *taosHashStripeAllocNode(SHashStripe *pStripe, size_t nodeSize) {
+  if (nodeSize > HASH_SLAB_MAX_NODE) {
+    return taosMemoryMalloc(nodeSize);
+  }
+
+  int32_t cls = (int32_t)((nodeSize - 1) / HASH_SLAB_CLASS_SIZE);
+  if (pStripe->freeList[cls] == NULL) {
+    size_t  classSize = (cls + 1) * HASH_SLAB_CLASS_SIZE;
+    int32_t num = pStripe->chunkNodes[cls] < HASH_SLAB_MIN_CHUNK ? HASH_SLAB_MIN_CHUNK : pStripe->chunkNodes[cls];
+    char   *pChunk = taosMemoryMalloc(classSize * num);
+    if (pChunk == NULL) {
+      return NULL;
+    }
+
+    if (taosArrayPush(pStripe->pChunks, &pChunk) == NULL) {
+      taosMemoryFree(pChunk);
+      return NULL;
+    }
+
+    for (int32_t i = num - 1; i >= 0; --i) {
+      SHashNode *pNode = (SHashNode *)(pChunk + i * classSize);
+      pNode->next = pStripe->freeList[cls];
+      pStripe->freeList[cls] = pNode;
+    }
+
+    // chunks grow geometrically, so the many small tables stay small
+    num <<= 1;
+    pStripe->chunkNodes[cls] = (num * classSize > HASH_SLAB_MAX_CHUNK) ? HASH_SLAB_MAX_CHUNK / classSize : num;
+  }
+
+  SHashNode *pNode = pStripe->freeList[cls];
+  pStripe->freeList[cls] = pNode->next;
+  return pNode;
+}
+
+static void taosHashStripeFreeNode(SHashObj *pHashObj, SHashStripe *pStripe, SHashNode *pNode) {
+  if (pHashObj->freeFp != NULL) {
+    (pHashObj->freeFp)(GET_HASH_NODE_DATA(pNode));
+  }
+
+  size_t nodeSize = HASH_NODE_SIZE(pNode->keyLen, pNode->dataLen);
+  if (nodeSize > HASH_SLAB_MAX_NODE) {
+    taosMemoryFree(pNode);
+    return;
+  }
+
+  int32_t cls = (int32_t)((nodeSize - 1) / HASH_SLAB_CLASS_SIZE);
+  pNode->next = pStripe->freeList[cls];
+  pStripe->freeList[cls] = pNode;
+}
+
+static SHashNode *taosHashStripeCreateNode(SHashStripe *pStripe, const void *key, size_t keyLen, const void *pData,
+                                           size_t dsize, uint32_t hashVal) {
+  SHashNode *pNewNode = taosHashStripeAllocNode(pStripe, HASH_NODE_SIZE(keyLen, dsize));
+  if (pNewNode == NULL) {
+    return NULL;
+  }
+
+  pNewNode->keyLen = (uint32_t)keyLen;
+  pNewNode->hashVal = hashVal;
+  pNewNode->dataLen = (uint32_t)dsize;
+  pNewNode->refCount = 1;
+  pNewNode->removed = 0;
+  pNewNode->next = NULL;
+
+  if (pData) memcpy(GET_HASH_NODE_DATA(pNewNode), pData, dsize);
+  memcpy(GET_HASH_NODE_KEY(pNewNode), key, keyLen);
+
+  return pNewNode;
+}
+
+static FORCE_INLINE bool taosHashSlotMatch(const SHashObj *pHashObj, const SHashSlot *pSlot, uint32_t mix,
+                                           const void *key, uint32_t keyLen) {
+  if (!HASH_SLOT_IS_NODE(pSlot) || pSlot->hashVal != mix || pSlot->keyLen != keyLen || pSlot->pNode->removed) {
+    return false;
+  }
+
+  if (keyLen <= HASH_INLINE_KEY_LEN && pHashObj->equalFp == memcmp) {
+    return memcmp(pSlot->key, key, keyLen) == 0;
+  }
+
+  return (*pHashObj->equalFp)(GET_HASH_NODE_KEY(pSlot->pNode), key, keyLen) == 0;
+}
+
+static SHashSlot *taosHashSlotsFind(const SHashObj *pHashObj, SHashSlot *slots, uint32_t capacity, uint32_t mix,
+                                    const void *key, uint32_t keyLen) {
+  uint32_t mask = capacity - 1;
+  uint32_t idx = mix & mask;
+
+  for (uint32_t i = 0; i < capacity; ++i, idx = (idx + 1) & mask) {
+    SHashSlot *pSlot = &slots[idx];
+    if (pSlot->pNode == HASH_SLOT_EMPTY) {
+      return NULL;
+    }
+
+    if (taosHashSlotMatch(pHashObj, pSlot, mix, key, keyLen)) {
+      return pSlot;
+    }
+  }
+
+  return NULL;
+}
+
+static SHashSlot *taosHashSlotsFindNode(SHashSlot *slots, uint32_t capacity, uint32_t mix, const SHashNode *pNode) {
+  uint32_t mask = capacity - 1;
+  uint32_t idx = mix & mask;
+
+  for (uint32_t i = 0; i < capacity; ++i, idx = (idx + 1) & mask) {
+    SHashSlot *pSlot = &slots[idx];
+    if (pSlot->pNode == HASH_SLOT_EMPTY) {
+      return NULL;
+    }
+
+    if (pSlot->pNode == pNode) {
+      return pSlot;
+    }
+  }
+
+  return NULL;
+}
+
+// during a rehash a key lives in exactly one of the two slot arrays
+static SHashSlot *taosHashStripeFind(const SHashObj *pHashObj, SHashStripe *pStripe, uint32_t mix, const void *key,
+                                     uint32_t keyLen) {
+  SHashSlot *pSlot = taosHashSlotsFind(pHashObj, pStripe->slots, pStripe->capacity, mix, key, keyLen);
+  if (pSlot == NULL && pStripe->oldSlots != NULL) {
+    pSlot = taosHashSlotsFind(pHashObj, pStripe->oldSlots, pStripe->oldCapacity, mix, key, keyLen);
+  }
+
+  return pSlot;
+}
+
+static SHashSlot *taosHashStripeFindNode(SHashStripe *pStripe, uint32_t mix, const SHashNode *pNode) {
+  SHashSlot *pSlot = taosHashSlotsFindNode(pStripe->slots, pStripe->capacity, mix, pNode);
+  if (pSlot == NULL && pStripe->oldSlots != NULL) {
+    pSlot = taosHashSlotsFindNode(pStripe->oldSlots, pStripe->oldCapacity, mix, pNode);
+  }
+
+  return pSlot;
+}
+
+// the caller makes sure the key of pNode is not in the stripe and there is room for it
+static void taosHashStripeAddNode(SHashStripe *pStripe, SHashNode *pNode, uint32_t mix) {
+  uint32_t mask = pStripe->capacity - 1;
+  uint32_t idx = mix & mask;
+
+  while (HASH_SLOT_IS_NODE(&pStripe->slots[idx])) {
+    idx = (idx + 1) & mask;
+  }
+
+  SHashSlot *pSlot = &pStripe->slots[idx];
+  if (pSlot->pNode == HASH_SLOT_EMPTY) {
+    pStripe->used++;
+  }
+
+  pSlot->pNode = pNode;
+  pSlot->hashVal = mix;
+  pSlot->keyLen = pNode->keyLen;
+  if (pNode->keyLen <= HASH_INLINE_KEY_LEN) {
+    memcpy(pSlot->key, GET_HASH_NODE_KEY(pNode), pNode->keyLen);
+  }
+}
+
+/**
+ * move at most step slots of the old slot array into the new one, the old array is released once it is drained
+ *
+ * @param pStripe  stripe with write lock held
+ * @param step     number of old slots to visit, UINT32_MAX to finish the rehash
+ */
+static void taosHashStripeRehash(SHashStripe *pStripe, uint32_t step) {
+  if (pStripe->oldSlots == NULL) {
+    return;
+  }
+
+  uint32_t end = (pStripe->oldCapacity - pStripe->rehashIdx > step) ? pStripe->rehashIdx + step : pStripe->oldCapacity;
+  for (; pStripe->rehashIdx < end; pStripe->rehashIdx++) {
+    SHashSlot *pSlot = &pStripe->oldSlots[pStripe->rehashIdx];
+    if (HASH_SLOT_IS_NODE(pSlot)) {
+      taosHashStripeAddNode(pStripe, pSlot->pNode, pSlot->hashVal);
+      // keep the probe chains of the old array intact for the keys not moved yet
+      pSlot->pNode = HASH_SLOT_DELETED;
+    }
+  }
+
+  if (pStripe->rehashIdx == pStripe->oldCapacity) {
+    taosMemoryFreeClear(pStripe->oldSlots);
+    pStripe->oldCapacity = 0;
+    pStripe->rehashIdx = 0;
+  }
+}
+
+/**
+ * make room for one more slot, start an incremental rehash when the load factor is reached
+ *
+ * @param pStripe  stripe with write lock held
+ * @return
+ */
+static int32_t taosHashStripeReserve(SHashStripe *pStripe) {
+  if (!HASH_STRIPE_NEED_RESIZE(pStripe)) {
+    return 0;
+  }
+
+  // the previous rehash is not done yet, finish it before starting another one
+  taosHashStripeRehash(pStripe, UINT32_MAX);
+  if (!HASH_STRIPE_NEED_RESIZE(pStripe)) {
+    return 0;
+  }
+
+  // grow only if the nodes fill the stripe, otherwise it is the tombstones that need to be purged
+  uint32_t newCapacity = pStripe->capacity;
+  if (pStripe->size * 2 >= pStripe->capacity * HASH_STRIPE_LOAD &&
+      newCapacity < HASH_MAX_CAPACITY / HASH_STRIPE_NUM) {
+    newCapacity <<= 1u;
+  }
+
+  SHashSlot *slots = taosMemoryCalloc(newCapacity, sizeof(SHashSlot));
+  if (slots == NULL) {
+    // go on with a higher load as long as there are free slots
+    return (pStripe->used + 1 < pStripe->capacity) ? 0 : terrno;
+  }
+
+  pStripe->oldSlots = pStripe->slots;
+  pStripe->oldCapacity = pStripe->capacity;
+  pStripe->rehashIdx = 0;
+  pStripe->slots = slots;
+  pStripe->capacity = newCapacity;
+  pStripe->used = 0;
+
+  taosHashStripeRehash(pStripe, HASH_REHASH_STEP);
+  return 0;
+}
+
+// drop a reference of the node, the node is released when nobody refers it
+static void taosHashStripeUnrefNode(SHashObj *pHashObj, SHashStripe *pStripe, SHashSlot *pSlot) {
+  SHashNode *pNode = pSlot->pNode;
+
+  (void)atomic_sub_fetch_16(&pNode->refCount, 1);
+  if (pNode->refCount <= 0) {
+    pSlot->pNode = HASH_SLOT_DELETED;
+    (void)atomic_sub_fetch_32(&pStripe->size, 1);
+    taosHashStripeFreeNode(pHashObj, pStripe, pNode);
+  }
+}
+
+static void taosHashStripeDestroy(SHashObj *pHashObj) {
+  for (int32_t i = 0; i < HASH_STRIPE_NUM; ++i) {
+    SHashStripe *pStripe = &pHashObj->stripes[i];
+
+    taosMemoryFreeClear(pStripe->slots);
+    taosMemoryFreeClear(pStripe->oldSlots);
+
+    size_t num = taosArrayGetSize(pStripe->pChunks);
+    for (int32_t j = 0; j < num; ++j) {
+      void *p = taosArrayGetP(pStripe->pChunks, j);
+      taosMemoryFree(p);
+    }
+    taosArrayDestroy(pStripe->pChunks);
+  }
+
+  taosMemoryFreeClear(pHashObj->stripes);
+}
+
+int32_t taosHashStripeInit(SHashObj *pHashObj, size_t capacity) {
+  uint32_t slots = (uint32_t)taosHashCapacity((int32_t)(capacity / HASH_STRIPE_NUM));
+  if (slots < HASH_STRIPE_MIN_SLOTS) {
+    slots = HASH_STRIPE_MIN_SLOTS;
+  }
+
+  pHashObj->stripes = taosMemoryCalloc(HASH_STRIPE_NUM, sizeof(SHashStripe));
+  if (pHashObj->stripes == NULL) {
+    return terrno;
+  }
+
+  for (int32_t i = 0; i < HASH_STRIPE_NUM; ++i) {
+    SHashStripe *pStripe = &pHashObj->stripes[i];
+
+    taosInitRWLatch(&pStripe->latch);
+    pStripe->capacity = slots;
+    pStripe->slots = taosMemoryCalloc(slots, sizeof(SHashSlot));
+    pStripe->pChunks = taosArrayInit(4, sizeof(void *));
+    if (pStripe->slots == NULL || pStripe->pChunks == NULL) {
+      taosHashStripeDestroy(pHashObj);
+      return terrno;
+    }
+  }
+
+  pHashObj->capacity = (size_t)slots * HASH_STRIPE_NUM;
+  return 0;
+}
+
+int32_t taosHashStripeGetSize(const SHashObj *pHashObj) {
+  int32_t size = 0;
+  for (int32_t i = 0; i < HASH_STRIPE_NUM; ++i) {
+    size += atomic_load_32((int32_t *)&pHashObj->stripes[i].size);
+  }
+  return size;
+}
+
+int32_t taosHashStripePut(SHashObj *pHashObj, const void *key, size_t keyLen, const void *data, size_t size) {
+  int32_t      code = TSDB_CODE_SUCCESS;
+  uint32_t     hashVal = (*pHashObj->hashFp)(key, (uint32_t)keyLen);
+  uint32_t     mix = taosHashMix(hashVal);
+  SHashStripe *pStripe = taosHashGetStripe(pHashObj, mix);
+
+  taosWLockLatch(&pStripe->latch);
+
+  // every writer helps to move the stripe forward, so a resize never stalls the stripe for long
+  taosHashStripeRehash(pStripe, HASH_REHASH_STEP);
+  code = taosHashStripeReserve(pStripe);
+  if (code != 0) {
+    goto _exit;
+  }
+
+  SHashSlot *pSlot = taosHashStripeFind(pHashObj, pStripe, mix, key, (uint32_t)keyLen);
+  if (pSlot != NULL && !pHashObj->enableUpdate) {
+    code = terrno = TSDB_CODE_DUP_KEY;
+    goto _exit;
+  }
+
+  SHashNode *pNewNode = taosHashStripeCreateNode(pStripe, key, keyLen, data, size, hashVal);
+  if (pNewNode == NULL) {
+    code = terrno;
+    goto _exit;
+  }
+
+  if (pSlot == NULL) {
+    taosHashStripeAddNode(pStripe, pNewNode, mix);
+    (void)atomic_add_fetch_32(&pStripe->size, 1);
+  } else {
+    // the key, hash value and inline key of the slot stay the same
+    SHashNode *pNode = pSlot->pNode;
+    pSlot->pNode = pNewNode;
+
+    (void)atomic_sub_fetch_16(&pNode->refCount, 1);
+    if (pNode->refCount <= 0) {
+      taosHashStripeFreeNode(pHashObj, pStripe, pNode);
+    } else {
+      // still referenced by others, keep it until released, as the chained table does
+      pNode->removed = 1;
+      taosHashStripeAddNode(pStripe, pNode, mix);
+      (void)atomic_add_fetch_32(&pStripe->size, 1);
+    }
+  }
+
+_exit:
+  taosWUnLockLatch(&pStripe->latch);
+  return code;
+}
+
+void *taosHashStripeGet(SHashObj *pHashObj, const void *key, size_t keyLen, void **d, int32_t *size, bool addRef) {
+  uint32_t     mix = taosHashMix((*pHashObj->hashFp)(key, (uint32_t)keyLen));
+  SHashStripe *pStripe = taosHashGetStripe(pHashObj, mix);
+  char        *data = NULL;
+
+  if (atomic_load_32(&pStripe->size) == 0) {
+    return NULL;
+  }
+
+  taosRLockLatch(&pStripe->latch);
+
+  SHashSlot *pSlot = taosHashStripeFind(pHashObj, pStripe, mix, key, (uint32_t)keyLen);
+  if (pSlot != NULL) {
+    data = doGetNodeData(pHashObj, pSlot->pNode, d, size, addRef);
+  }
+
+  taosRUnLockLatch(&pStripe->latch);
+  return data;
+}
+
+int32_t taosHashStripeRemove(SHashObj *pHashObj, const void *key, size_t keyLen) {
+  int32_t      code = TSDB_CODE_NOT_FOUND;
+  uint32_t     mix = taosHashMix((*pHashObj->hashFp)(key, (uint32_t)keyLen));
+  SHashStripe *pStripe = taosHashGetStripe(pHashObj, mix);
+
+  taosWLockLatch(&pStripe->latch);
+  taosHashStripeRehash(pStripe, HASH_REHASH_STEP);
+
+  SHashSlot *pSlot = taosHashStripeFind(pHashObj, pStripe, mix, key, (uint32_t)keyLen);
+  if (pSlot != NULL) {
+    code = 0;
+    pSlot->pNode->removed = 1;
+    taosHashStripeUnrefNode(pHashObj, pStripe, pSlot);
+  }
+
+  taosWUnLockLatch(&pStripe->latch);
+  return code;
+}
+
+void taosHashStripeClear(SHashObj *pHashObj) {
+  for (int32_t i = 0; i < HASH_STRIPE_NUM; ++i) {
+    SHashStripe *pStripe = &pHashObj->stripes[i];
+
+    taosWLockLatch(&pStripe->latch);
+    taosHashStripeRehash(pStripe, UINT32_MAX);
+
+    for (uint32_t j = 0; j < pStripe->capacity; ++j) {
+      SHashSlot *pSlot = &pStripe->slots[j];
+      if (HASH_SLOT_IS_NODE(pSlot)) {
+        taosHashStripeFreeNode(pHashObj, pStripe, pSlot->pNode);
+      }
+    }
+
+    memset(pStripe->slots, 0, pStripe->capacity * sizeof(SHashSlot));
+    pStripe->used = 0;
+    pStripe->size = 0;
+    taosWUnLockLatch(&pStripe->latch);
+  }
+}
+
+void taosHashStripeCleanup(SHashObj *pHashObj) {
+  taosHashStripeClear(pHashObj);
+  taosHashStripeDestroy(pHashObj);
+  taosMemoryFree(pHashObj);
+}
+
+void *taosHashStripeIterate(SHashObj *pHashObj, void *p) {
+  int32_t      stripe = 0;
+  uint32_t     idx = 0;
+  SHashStripe *pLocked = NULL;
+
+  if (p != NULL) {
+    SHashNode *pOld = GET_HASH_PNODE(p);
+    uint32_t   mix = taosHashMix(pOld->hashVal);
+
+    stripe = (int32_t)(mix >> (32 - HASH_STRIPE_BITS));
+    pLocked = &pHashObj->stripes[stripe];
+
+    taosWLockLatch(&pLocked->latch);
+    // a single slot array keeps the position of the iterator meaningful
+    taosHashStripeRehash(pLocked, UINT32_MAX);
+
+    SHashSlot *pSlot = taosHashSlotsFindNode(pLocked->slots, pLocked->capacity, mix, pOld);
+    if (pSlot != NULL) {
+      idx = (uint32_t)(pSlot - pLocked->slots) + 1;
+      taosHashStripeUnrefNode(pHashObj, pLocked, pSlot);
+    } else {
+      idx = pLocked->capacity;
+    }
+  }
+
+  for (; stripe < HASH_STRIPE_NUM; ++stripe, idx = 0) {
+    SHashStripe *pStripe = &pHashObj->stripes[stripe];
+
+    if (pStripe != pLocked) {
+      if (atomic_load_32(&pStripe->size) == 0) {
+        continue;
+      }
+      taosWLockLatch(&pStripe->latch);
+      taosHashStripeRehash(pStripe, UINT32_MAX);
+    }
+    pLocked = NULL;
+
+    for (; idx < pStripe->capacity; ++idx) {
+      SHashSlot *pSlot = &pStripe->slots[idx];
+      if (!HASH_SLOT_IS_NODE(pSlot) || pSlot->pNode->removed) {
+        continue;
+      }
+
+      uint16_t afterRef = atomic_add_fetch_16(&pSlot->pNode->refCount, 1);
+      if (afterRef >= MAX_WARNING_REF_COUNT) {
+        uWarn("hash entry ref count is abnormally high: %d", afterRef);
+      }
+
+      char *data = GET_HASH_NODE_DATA(pSlot->pNode);
+      taosWUnLockLatch(&pStripe->latch);
+      return data;
+    }
+
+    taosWUnLockLatch(&pStripe->latch);
+  }
+
+  return NULL;
+}
+
+void taosHashStripeCancelIterate(SHashObj *pHashObj, void *p) {
+  SHashNode   *pNode = GET_HASH_PNODE(p);
+  uint32_t     mix = taosHashMix(pNode->hashVal);
+  SHashStripe *pStripe = taosHashGetStripe(pHashObj, mix);
+
+  taosWLockLatch(&pStripe->latch);
+
+  SHashSlot *pSlot = taosHashStripeFindNode(pStripe, mix, pNode);
+  if (pSlot != NULL) {
+    taosHashStripeUnrefNode(pHashObj, pStripe, pSlot);
+  }
+
+  taosWUnLockLatch(&pStripe->latch);
+}
+
+// the longest run of occupied slots, the open addressing counterpart of the longest overflow link list
+int32_t taosHashStripeMaxProbeLength(const SHashObj *pHashObj) {
+  int32_t num = 0;
+
+  for (int32_t i = 0; i < HASH_STRIPE_NUM; ++i) {
+    SHashStripe *pStripe = &pHashObj->stripes[i];
+    int32_t      run = 0;
+
+    taosRLockLatch(&pStripe->latch);
+    for (uint32_t j = 0; j < pStripe->capacity; ++j) {
+      run = (pStripe->slots[j].pNode == HASH_SLOT_EMPTY) ? 0 : run + 1;
+      if (num < run) {
+        num = run;
+      }
+    }
+    taosRUnLockLatch(&pStripe->latch);
+  }
+
+  return num;
+}
+
+size_t taosHashStripeGetMemSize(const SHashObj *pHashObj) {
+  size_t size = sizeof(SHashObj) + HASH_STRIPE_NUM * sizeof(SHashStripe);
+
+  for (int32_t i = 0; i < HASH_STRIPE_NUM; ++i) {
+    SHashStripe *pStripe = &pHashObj->stripes[i];
+
+    taosRLockLatch(&pStripe->latch);
+    size += ((size_t)pStripe->capacity + pStripe->oldCapacity) * sizeof(SHashSlot) +
+            pStripe->size * sizeof(SHashNode);
+    taosRUnLockLatch(&pStripe->latch);
+  }
+
+  return size;
+}
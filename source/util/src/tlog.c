@@ -16,6 +16,7 @@
 #define _DEFAULT_SOURCE
 #include "tlog.h"
 #include "os.h"
+#include "tlogInt.h"
 #include "tconfig.h"
 #include "tglobal.h"
 #include "tjson.h"
@@ -23,8 +24,6 @@
 #include "tutil.h"
 #include "tcommon.h"
 
-#define LOG_MAX_LINE_SIZE              (10024)
-#define LOG_MAX_LINE_BUFFER_SIZE       (LOG_MAX_LINE_SIZE + 3)
 #define LOG_MAX_STACK_LINE_SIZE        (512)
 #define LOG_MAX_STACK_LINE_BUFFER_SIZE (LOG_MAX_STACK_LINE_SIZE + 3)
 #define LOG_MAX_LINE_DUMP_SIZE         (1024 * 1024)
@@ -83,6 +82,8 @@ typedef struct {
   int64_t       lastKeepFileSec;
   int64_t       timestampToday;
   int8_t        outputType;  // ELogOutputType
+  int8_t        ringMode;    // ELogRingMode
+  int32_t       fileVer;     // increased once a new log file is opened
   pid_t         pid;
   char          logName[PATH_MAX];
   char          slowLogName[PATH_MAX];
@@ -100,6 +101,8 @@ static SRWLatch tsLogRotateLatch = 0;
 
 bool tsLogEmbedded = 0;
 bool tsAsyncLog = true;
+bool tsLogThreadRing = false;
+bool tsLogBinary = false;
 #ifdef ASSERT_NOT_CORE
 bool tsAssert = false;
 #else
@@ -153,6 +156,7 @@ int64_t dbgWSize = 0;
 
 static void     *taosAsyncOutputLog(void *param);
 static int32_t   taosPushLogBuffer(SLogBuff *pLogBuf, const char *msg, int32_t msgLen);
+static int32_t   taosPushLogBufferImpl(SLogBuff *pLogBuf, const char *msg, int32_t msgLen);
 static SLogBuff *taosLogBuffNew(int32_t bufSize);
 static void      taosCloseLogByFd(TdFilePtr pFile);
 static int32_t   taosInitNormalLog(const char *fn, int32_t maxFileNum);
@@ -160,6 +164,15 @@ static void      taosWriteLog(SLogBuff *pLogBuf);
 static void      taosWriteSlowLog(SLogBuff *pLogBuf);
 
 static int32_t taosStartLog() {
+  if (tsLogThreadRing || tsLogBinary) {
+    int32_t code = taosLogRingInit();
+    if (code == 0) {
+      tsLogObj.ringMode = tsLogBinary ? LOG_RING_BINARY : LOG_RING_TEXT;
+    } else {
+      uError("failed to init log rings since %s, log lines are formatted by callers", tstrerror(code));
+    }
+  }
+
   TdThreadAttr threadAttr;
   (void)taosThreadAttrInit(&threadAttr);
 #ifdef TD_COMPACT_OS
@@ -325,6 +338,11 @@ void taosCloseLog() {
     taosThreadClear(&tsLogObj.logHandle->asyncThread);
   }
 
+  if (tsLogObj.ringMode != LOG_RING_NONE) {
+    tsLogObj.ringMode = LOG_RING_NONE;
+    taosLogRingCleanup();
+  }
+
   if (tsLogObj.slowHandle != NULL) {
     (void)taosThreadMutexDestroy(&tsLogObj.slowHandle->buffMutex);
     (void)taosCloseFile(&tsLogObj.slowHandle->pFile);
@@ -443,6 +461,7 @@ static OldFileKeeper *taosOpenNewFile() {
   TdFilePtr pOldFile = tsLogObj.logHandle->pFile;
   tsLogObj.logHandle->pFile = pFile;
   tsLogObj.lines = 0;
+  TAOS_UNUSED(atomic_add_fetch_32(&tsLogObj.fileVer, 1));
   OldFileKeeper *oldFileKeeper = taosMemoryMalloc(sizeof(OldFileKeeper));
   if (oldFileKeeper == NULL) {
     uError("create old log keep info faild! mem is not enough.");
@@ -722,39 +741,42 @@ static void taosUpdateLogNums(ELogLevel level) {
   }
 }
 
+int32_t taosLogBuildHead(char *buffer, int32_t size, int64_t ts, int64_t tid, const char *flags) {
+  // the local time is only converted once a second
+  static threadlocal time_t    lastSec = -1;
+  static threadlocal struct tm lastTm;
+
+  time_t curTime = (time_t)(ts / 1000000);
+  if (curTime != lastSec) {
+    struct tm Tm;
+    if (taosLocalTime(&curTime, &Tm, NULL, 0, NULL) == NULL) {
+      uError("%s failed to get local time, code:%d", __FUNCTION__, ERRNO);
+      return 0;
+    }
+    lastTm = Tm;
+    lastSec = curTime;
+  }
+
+  int32_t len = snprintf(buffer, size, "%02d/%02d %02d:%02d:%02d.%06d %08" PRId64 " %s %s", lastTm.tm_mon + 1,
+                         lastTm.tm_mday, lastTm.tm_hour, lastTm.tm_min, lastTm.tm_sec, (int32_t)(ts % 1000000), tid,
+                         LOG_EDITION_FLG, flags);
+  return TMIN(len, size - 1);
+}
+
 static inline int32_t taosBuildLogHead(char *buffer, const char *flags) {
-  struct tm      Tm, *ptm;
   struct timeval timeSecs;
 
   TAOS_UNUSED(taosGetTimeOfDay(&timeSecs));
-  time_t curTime = timeSecs.tv_sec;
-  ptm = taosLocalTime(&curTime, &Tm, NULL, 0, NULL);
-  if (ptm == NULL) {
-    uError("%s failed to get local time, code:%d", __FUNCTION__, ERRNO);
-    return 0;
-  }
-  return snprintf(buffer, LOG_MAX_STACK_LINE_BUFFER_SIZE, "%02d/%02d %02d:%02d:%02d.%06d %08" PRId64 " %s %s",
-                  ptm->tm_mon + 1, ptm->tm_mday, ptm->tm_hour, ptm->tm_min, ptm->tm_sec, (int32_t)timeSecs.tv_usec,
-                  taosGetSelfPthreadId(), LOG_EDITION_FLG, flags);
+  return taosLogBuildHead(buffer, LOG_MAX_STACK_LINE_BUFFER_SIZE,
+                          (int64_t)timeSecs.tv_sec * 1000000 + (int64_t)timeSecs.tv_usec, taosGetSelfPthreadId(),
+                          flags);
 }
 
-static inline void taosPrintLogImp(ELogLevel level, int32_t dflag, const char *buffer, int32_t len) {
-  if ((dflag & DEBUG_FILE) && tsLogObj.logHandle && tsLogObj.logHandle->pFile != NULL && osLogSpaceSufficient()) {
-    taosUpdateLogNums(level);
-    if (tsAsyncLog) {
-      TAOS_UNUSED(taosPushLogBuffer(tsLogObj.logHandle, buffer, len));
-    } else {
-      TAOS_UNUSED(taosWriteFile(tsLogObj.logHandle->pFile, buffer, len));
-    }
-
-    if (tsNumOfLogLines > 0) {
-      TAOS_UNUSED(atomic_add_fetch_32(&tsLogObj.lines, 1));
-      if ((tsLogObj.lines > tsNumOfLogLines) && (tsLogObj.openInProgress == 0)) {
-        TAOS_UNUSED(taosOpenNewLogFile());
-      }
-    }
-  }
+static inline bool taosLogToFile(int32_t dflag) {
+  return (dflag & DEBUG_FILE) && tsLogObj.logHandle && tsLogObj.logHandle->pFile != NULL && osLogSpaceSufficient();
+}
 
+static inline int taosLogScreenFd(int32_t dflag) {
   int fd = 0;
   if (tsLogObj.outputType == LOG_OUTPUT_FILE) {
 #ifndef TAOSD_INTEGRATED    
@@ -767,7 +789,52 @@ static inline void taosPrintLogImp(ELogLevel level, int32_t dflag, const char *b
   } else if (tsLogObj.outputType == LOG_OUTPUT_STDERR) {
     fd = 2;
   }
+  return fd;
+}
+
+static inline void taosLogCountLine() {
+  if (tsNumOfLogLines > 0) {
+    TAOS_UNUSED(atomic_add_fetch_32(&tsLogObj.lines, 1));
+    if ((tsLogObj.lines > tsNumOfLogLines) && (tsLogObj.openInProgress == 0)) {
+      TAOS_UNUSED(taosOpenNewLogFile());
+    }
+  }
+}
+
+static void taosPushLogText(const char *msg, int32_t msgLen) {
+  if (taosLogRingPutText(msg, msgLen) != TSDB_CODE_OPS_NOT_SUPPORT) {
+    return;
+  }
+
+  // too long for the ring of the thread
+  if (tsLogObj.ringMode != LOG_RING_BINARY) {
+    TAOS_UNUSED(taosPushLogBuffer(tsLogObj.logHandle, msg, msgLen));
+    return;
+  }
+
+  char *buf = taosMemoryMalloc(msgLen + 5);
+  if (buf != NULL) {
+    int32_t len = taosLogBinaryEncodeText(msg, msgLen, buf, msgLen + 5);
+    TAOS_UNUSED(taosPushLogBuffer(tsLogObj.logHandle, buf, len));
+    taosMemoryFree(buf);
+  }
+}
+
+static inline void taosPrintLogImp(ELogLevel level, int32_t dflag, const char *buffer, int32_t len) {
+  if (taosLogToFile(dflag)) {
+    taosUpdateLogNums(level);
+    if (tsLogObj.ringMode != LOG_RING_NONE) {
+      taosPushLogText(buffer, len);
+    } else if (tsAsyncLog) {
+      TAOS_UNUSED(taosPushLogBuffer(tsLogObj.logHandle, buffer, len));
+    } else {
+      TAOS_UNUSED(taosWriteFile(tsLogObj.logHandle->pFile, buffer, len));
+    }
+
+    taosLogCountLine();
+  }
 
+  int fd = taosLogScreenFd(dflag);
   if (fd) {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-result"
@@ -835,6 +902,21 @@ void taosPrintLog(const char *flags, int32_t level, int32_t dflag, const char *f
 
   va_list argpointer, argpointer_copy;
   va_start(argpointer, format);
+
+  // lines only written to the log file are formatted by the log thread
+  if (tsLogObj.ringMode != LOG_RING_NONE && taosLogScreenFd(dflag) == 0 && !(tsLogFp && level <= DEBUG_INFO) &&
+      taosLogToFile(dflag)) {
+    va_copy(argpointer_copy, argpointer);
+    int32_t code = taosLogRingPutFmt(flags, format, argpointer_copy);
+    va_end(argpointer_copy);
+    if (code != TSDB_CODE_OPS_NOT_SUPPORT) {
+      taosUpdateLogNums(level);
+      taosLogCountLine();
+      va_end(argpointer);
+      return;
+    }
+  }
+
   va_copy(argpointer_copy, argpointer);
 
   if (taosPrintLogImplUseStackBuffer(flags, level, dflag, format, argpointer) == 0) {
@@ -947,6 +1029,11 @@ static void taosCopyLogBuffer(SLogBuff *pLogBuf, int32_t start, int32_t end, con
 }
 
 static int32_t taosPushLogBuffer(SLogBuff *pLogBuf, const char *msg, int32_t msgLen) {
+  if (pLogBuf == NULL || pLogBuf->stop) return -1;
+  return taosPushLogBufferImpl(pLogBuf, msg, msgLen);
+}
+
+static int32_t taosPushLogBufferImpl(SLogBuff *pLogBuf, const char *msg, int32_t msgLen) {
   int32_t        start = 0;
   int32_t        end = 0;
   int32_t        remainSize = 0;
@@ -954,8 +1041,6 @@ static int32_t taosPushLogBuffer(SLogBuff *pLogBuf, const char *msg, int32_t msg
   char           tmpBuf[128];
   int32_t        tmpBufLen = 0;
 
-  if (pLogBuf == NULL || pLogBuf->stop) return -1;
-
   (void)taosThreadMutexLock(&LOG_BUF_MUTEX(pLogBuf));
   start = LOG_BUF_START(pLogBuf);
   end = LOG_BUF_END(pLogBuf);
@@ -964,6 +1049,11 @@ static int32_t taosPushLogBuffer(SLogBuff *pLogBuf, const char *msg, int32_t msg
 
   if (lostLine > 0) {
     tmpBufLen = snprintf(tmpBuf, tListLen(tmpBuf), "...Lost %" PRId64 " lines here...\n", lostLine);
+    if (pLogBuf == tsLogObj.logHandle && tsLogObj.ringMode == LOG_RING_BINARY) {
+      char text[128];
+      (void)memcpy(text, tmpBuf, tmpBufLen);
+      tmpBufLen = taosLogBinaryEncodeText(text, tmpBufLen, tmpBuf, tListLen(tmpBuf));
+    }
   }
 
   if (remainSize <= msgLen || ((lostLine > 0) && (remainSize <= (msgLen + tmpBufLen)))) {
@@ -1001,6 +1091,29 @@ static int32_t taosGetLogRemainSize(SLogBuff *pLogBuf, int32_t start, int32_t en
   return rSize >= 0 ? rSize : LOG_BUF_SIZE(pLogBuf) + rSize;
 }
 
+static void taosLogRingOutput(void *param, const char *msg, int32_t msgLen) {
+  SLogBuff *pLogBuf = (SLogBuff *)param;
+
+  (void)taosThreadMutexLock(&LOG_BUF_MUTEX(pLogBuf));
+  int32_t size = taosGetLogRemainSize(pLogBuf, LOG_BUF_START(pLogBuf), LOG_BUF_END(pLogBuf));
+  (void)taosThreadMutexUnlock(&LOG_BUF_MUTEX(pLogBuf));
+
+  // only the log thread consumes the buffer, write it out instead of losing lines
+  if (LOG_BUF_SIZE(pLogBuf) - size - 1 <= msgLen) {
+    pLogBuf->lastDuration = LOG_MAX_WAIT_MSEC;
+    taosWriteLog(pLogBuf);
+  }
+
+  // lines left in the rings are still drained after the log is stopped
+  TAOS_UNUSED(taosPushLogBufferImpl(pLogBuf, msg, msgLen));
+}
+
+static void taosDrainLogRings(SLogBuff *pLogBuf) {
+  if (tsLogObj.ringMode != LOG_RING_NONE) {
+    taosLogRingDrain(tsLogObj.ringMode, atomic_load_32(&tsLogObj.fileVer), taosLogRingOutput, pLogBuf);
+  }
+}
+
 static void taosWriteSlowLog(SLogBuff *pLogBuf) {
   int32_t lock = atomic_val_compare_exchange_32(&pLogBuf->lock, 0, 1);
   if (lock == 1) return;
@@ -1205,11 +1318,13 @@ static void *taosAsyncOutputLog(void *param) {
     }
 
     // Polling the buffer
+    taosDrainLogRings(pLogBuf);
     taosWriteLog(pLogBuf);
     if (pSlowBuf) taosWriteSlowLog(pSlowBuf);
 
     if (pLogBuf->stop || (pSlowBuf && pSlowBuf->stop)) {
       pLogBuf->lastDuration = LOG_MAX_WAIT_MSEC;
+      taosDrainLogRings(pLogBuf);
       taosWriteLog(pLogBuf);
       if (pSlowBuf) taosWriteSlowLog(pSlowBuf);
       break;
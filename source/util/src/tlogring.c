@@ -0,0 +1,1116 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _DEFAULT_SOURCE
+#include "taos.h"
+#include "taoserror.h"
+#include "tarray.h"
+#include "thash.h"
+#include "tlogInt.h"
+#include "tutil.h"
+
+#define LOG_RING_SIZE         (128 * 1024)  // must be a power of 2
+#define LOG_RING_MAX_REC_SIZE (LOG_RING_SIZE / 4)
+#define LOG_RING_MAX_ARG_SIZE 1024
+#define LOG_RING_MAX_FMT_LEN  4096
+#define LOG_RING_MAX_SPEC_LEN 32
+#define LOG_RING_WRAP         (-1)
+#define LOG_RING_WRITER_SLOTS 64  // must be a power of 2
+#define LOG_RING_ALIGN(s)     (((s) + 7) & ~((int32_t)7))
+
+/*
+ * Binary log file layout, all integers are in host byte order:
+ *   magic:  LOG_BIN_MAGIC, int32_t version. The dictionary is reset, written at startup and for each new file.
+ *   dict:   'D', uint32_t id, uint32_t len, string. Defines a format or flags string used by later records.
+ *   record: 'R', uint32_t dataLen, int64_t ts, int64_t tid, uint32_t flagsId, uint32_t fmtId, raw arguments.
+ *   text:   'T', uint32_t len, a line formatted by the caller.
+ * Anything outside of the binary stream, e.g. the banner of a new log file, is kept as is.
+ */
+#define LOG_BIN_MAGIC       "\377TDLOGBIN"
+#define LOG_BIN_MAGIC_LEN   9
+#define LOG_BIN_MAGIC_TAG   0xff
+#define LOG_BIN_VERSION     1
+#define LOG_BIN_DICT        'D'
+#define LOG_BIN_REC         'R'
+#define LOG_BIN_TEXT        'T'
+#define LOG_BIN_REC_HEAD    (1 + 4 + 8 + 8 + 4 + 4)
+#define LOG_BIN_MAX_LEN     (64 * 1024 * 1024)
+#define LOG_DECODE_BUF_SIZE (4 * 1024 * 1024)
+
+typedef enum {
+  LOG_REC_TEXT = 0,
+  LOG_REC_FMT = 1,
+} ELogRecType;
+
+typedef struct {
+  int32_t  len;       // length of the record aligned to 8 bytes, LOG_RING_WRAP if the rest of the ring is skipped
+  int8_t   type;      // ELogRecType
+  uint8_t  flagsLen;  // with the trailing '\0'
+  uint16_t fmtLen;    // with the trailing '\0'
+  int32_t  dataLen;   // length of the arguments, or of the line for LOG_REC_TEXT
+  int32_t  reserved;
+  int64_t  ts;  // in microseconds
+  int64_t  tid;
+} SLogRecHead;
+
+typedef struct SLogRing {
+  struct SLogRing *next;
+  int64_t          head;  // read offset, only moved by the log thread
+  int64_t          tail;  // write offset, only moved by the owner thread
+  int64_t          lostLines;
+  int32_t          closed;  // the owner thread has exited
+  int32_t          drainClosed;
+  int64_t          drainHead;  // offsets of the records being drained, used by the log thread only
+  int64_t          drainTail;
+  char             buffer[];
+} SLogRing;
+
+// number of threads between taosLogRingAcquire and taosLogRingRelease, spread over cache lines
+typedef struct {
+  int32_t num;
+  char    pad[60];
+} SLogRingWriters;
+
+typedef enum {
+  LOG_ARG_NONE = 0,
+  LOG_ARG_INT,
+  LOG_ARG_UINT,
+  LOG_ARG_CHAR,
+  LOG_ARG_DOUBLE,
+  LOG_ARG_STR,
+  LOG_ARG_PTR,
+} ELogArgType;
+
+typedef enum {
+  LOG_LEN_NONE = 0,
+  LOG_LEN_HH,
+  LOG_LEN_H,
+  LOG_LEN_L,
+  LOG_LEN_LL,
+  LOG_LEN_J,
+  LOG_LEN_Z,
+  LOG_LEN_T,
+  LOG_LEN_BIG_L,
+} ELogLenMod;
+
+typedef struct {
+  int32_t start;     // offset of '%'
+  int32_t modStart;  // offset of the length modifier
+  int32_t end;       // offset after the conversion character
+  int32_t prec;      // -1 if no precision is given
+  int8_t  nStar;
+  int8_t  lenMod;   // ELogLenMod
+  int8_t  argType;  // ELogArgType
+} SLogConv;
+
+struct SLogDecoder {
+  SArray   *pDict;  // char *, indexed by id
+  TdFilePtr pFile;
+  char     *buf;
+  int64_t   cap;
+  int64_t   start;
+  int64_t   end;
+  bool      eof;
+  char      line[LOG_MAX_LINE_BUFFER_SIZE];
+};
+
+static TdThreadKey     tsLogRingKey;
+static TdThreadOnce    tsLogRingOnce = PTHREAD_ONCE_INIT;
+static TdThreadMutex   tsLogRingMutex;     // never destroyed, a thread may still be about to lock it at cleanup
+static SLogRing       *tsLogRings = NULL;  // all rings, protected by tsLogRingMutex
+static int8_t          tsLogRingInited = 0;
+static int32_t         tsLogRingVer = 0;  // rings of older versions are freed by taosLogRingCleanup
+static SLogRingWriters tsLogRingWriters[LOG_RING_WRITER_SLOTS];
+
+static threadlocal SLogRing *tsLocalLogRing = NULL;
+static threadlocal int32_t   tsLocalLogRingVer = 0;
+static threadlocal bool      tsLocalLogRingCreating = false;
+static threadlocal int32_t   tsLocalLogRingSlot = -1;
+
+// used by the log thread only
+static char      tsLogRingLine[LOG_MAX_LINE_BUFFER_SIZE];
+static char      tsLogRingBin[LOG_BIN_REC_HEAD + LOG_RING_MAX_REC_SIZE];
+static char      tsLogRingDict[9 + LOG_RING_MAX_FMT_LEN];
+static SHashObj *tsLogBinDict = NULL;  // string -> id
+static SLogRing **tsLogRingActive = NULL;
+static int32_t    tsLogRingActiveCap = 0;
+static uint32_t  tsLogBinNextId = 0;
+static int32_t   tsLogBinFileVer = -1;
+
+static bool taosLogParseConv(const char *fmt, int32_t pos, SLogConv *pConv) {
+  int32_t i = pos + 1;
+
+  pConv->start = pos;
+  pConv->prec = -1;
+  pConv->nStar = 0;
+
+  while (fmt[i] == '-' || fmt[i] == '+' || fmt[i] == ' ' || fmt[i] == '#' || fmt[i] == '0') i++;
+
+  if (fmt[i] == '*') {
+    pConv->nStar++;
+    i++;
+  } else {
+    while (isdigit((unsigned char)fmt[i])) i++;
+  }
+
+  if (fmt[i] == '.') {
+    i++;
+    if (fmt[i] == '*') {
+      pConv->nStar++;
+      i++;
+    } else {
+      pConv->prec = 0;
+      while (isdigit((unsigned char)fmt[i])) {
+        pConv->prec = pConv->prec * 10 + (fmt[i] - '0');
+        i++;
+      }
+    }
+  }
+
+  pConv->modStart = i;
+  switch (fmt[i]) {
+    case 'h':
+      pConv->lenMod = (fmt[i + 1] == 'h') ? LOG_LEN_HH : LOG_LEN_H;
+      i += (fmt[i + 1] == 'h') ? 2 : 1;
+      break;
+    case 'l':
+      pConv->lenMod = (fmt[i + 1] == 'l') ? LOG_LEN_LL : LOG_LEN_L;
+      i += (fmt[i + 1] == 'l') ? 2 : 1;
+      break;
+    case 'q':
+      pConv->lenMod = LOG_LEN_LL;
+      i++;
+      break;
+    case 'j':
+      pConv->lenMod = LOG_LEN_J;
+      i++;
+      break;
+    case 'z':
+      pConv->lenMod = LOG_LEN_Z;
+      i++;
+      break;
+    case 't':
+      pConv->lenMod = LOG_LEN_T;
+      i++;
+      break;
+    case 'L':
+      pConv->lenMod = LOG_LEN_BIG_L;
+      i++;
+      break;
+    default:
+      pConv->lenMod = LOG_LEN_NONE;
+      break;
+  }
+
+  switch (fmt[i]) {
+    case 'd':
+    case 'i':
+      pConv->argType = LOG_ARG_INT;
+      break;
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+      pConv->argType = LOG_ARG_UINT;
+      break;
+    case 'c':
+      pConv->argType = LOG_ARG_CHAR;
+      break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+      pConv->argType = LOG_ARG_DOUBLE;
+      break;
+    case 's':
+      pConv->argType = LOG_ARG_STR;
+      break;
+    case 'p':
+      pConv->argType = LOG_ARG_PTR;
+      break;
+    case '%':
+      if (i != pos + 1) return false;
+      pConv->argType = LOG_ARG_NONE;
+      break;
+    default:
+      // %n, %m, positional arguments and so on are left to the caller
+      return false;
+  }
+
+  // long double, wide chars and wide strings are not supported either
+  if (pConv->lenMod == LOG_LEN_BIG_L) return false;
+  if (pConv->lenMod != LOG_LEN_NONE && pConv->argType != LOG_ARG_INT && pConv->argType != LOG_ARG_UINT &&
+      !(pConv->argType == LOG_ARG_DOUBLE && pConv->lenMod == LOG_LEN_L)) {
+    return false;
+  }
+
+  pConv->end = i + 1;
+  return pConv->end - pConv->start <= LOG_RING_MAX_SPEC_LEN;
+}
+
+#define LOG_ARG_PUT(buf, cap, len, v)                \
+  do {                                               \
+    if ((len) + (int32_t)sizeof(v) > (cap)) {        \
+      return TSDB_CODE_OPS_NOT_SUPPORT;              \
+    }                                                \
+    (void)memcpy((buf) + (len), &(v), sizeof(v));    \
+    (len) += (int32_t)sizeof(v);                     \
+  } while (0)
+
+#define LOG_ARG_GET(data, dataLen, off, v)                 \
+  do {                                                     \
+    if ((off) + (int32_t)sizeof(v) > (dataLen)) {          \
+      return -1;                                           \
+    }                                                      \
+    (void)memcpy(&(v), (data) + (off), sizeof(v));         \
+    (off) += (int32_t)sizeof(v);                           \
+  } while (0)
+
+static int32_t taosLogSerializeArgs(const char *format, va_list args, char *buf, int32_t cap, int32_t *pLen) {
+  int32_t  len = 0;
+  SLogConv conv = {0};
+
+  for (const char *p = strchr(format, '%'); p != NULL; p = strchr(format + conv.end, '%')) {
+    if (!taosLogParseConv(format, (int32_t)(p - format), &conv)) {
+      return TSDB_CODE_OPS_NOT_SUPPORT;
+    }
+
+    for (int32_t i = 0; i < conv.nStar; ++i) {
+      int32_t v = va_arg(args, int);
+      LOG_ARG_PUT(buf, cap, len, v);
+      if (i == conv.nStar - 1 && format[conv.modStart - 1] == '*' && format[conv.modStart - 2] == '.') {
+        conv.prec = v < 0 ? -1 : v;
+      }
+    }
+
+    switch (conv.argType) {
+      case LOG_ARG_INT: {
+        int64_t v = 0;
+        switch (conv.lenMod) {
+          case LOG_LEN_HH:
+            v = (signed char)va_arg(args, int);
+            break;
+          case LOG_LEN_H:
+            v = (short)va_arg(args, int);
+            break;
+          case LOG_LEN_L:
+            v = va_arg(args, long);
+            break;
+          case LOG_LEN_LL:
+            v = va_arg(args, long long);
+            break;
+          case LOG_LEN_J:
+            v = va_arg(args, intmax_t);
+            break;
+          case LOG_LEN_Z:
+            v = (int64_t)va_arg(args, size_t);
+            break;
+          case LOG_LEN_T:
+            v = va_arg(args, ptrdiff_t);
+            break;
+          default:
+            v = va_arg(args, int);
+            break;
+        }
+        LOG_ARG_PUT(buf, cap, len, v);
+      } break;
+      case LOG_ARG_UINT: {
+        uint64_t v = 0;
+        switch (conv.lenMod) {
+          case LOG_LEN_HH:
+            v = (unsigned char)va_arg(args, unsigned int);
+            break;
+          case LOG_LEN_H:
+            v = (unsigned short)va_arg(args, unsigned int);
+            break;
+          case LOG_LEN_L:
+            v = va_arg(args, unsigned long);
+            break;
+          case LOG_LEN_LL:
+            v = va_arg(args, unsigned long long);
+            break;
+          case LOG_LEN_J:
+            v = va_arg(args, uintmax_t);
+            break;
+          case LOG_LEN_Z:
+            v = va_arg(args, size_t);
+            break;
+          case LOG_LEN_T:
+            v = (uint64_t)va_arg(args, ptrdiff_t);
+            break;
+          default:
+            v = va_arg(args, unsigned int);
+            break;
+        }
+        LOG_ARG_PUT(buf, cap, len, v);
+      } break;
+      case LOG_ARG_CHAR: {
+        int32_t v = va_arg(args, int);
+        LOG_ARG_PUT(buf, cap, len, v);
+      } break;
+      case LOG_ARG_DOUBLE: {
+        double v = va_arg(args, double);
+        LOG_ARG_PUT(buf, cap, len, v);
+      } break;
+      case LOG_ARG_STR: {
+        const char *s = va_arg(args, const char *);
+        int32_t     slen = -1;
+        if (s != NULL) {
+          size_t n = (conv.prec >= 0) ? strnlen(s, conv.prec) : strlen(s);
+          if (n > (size_t)cap) {
+            return TSDB_CODE_OPS_NOT_SUPPORT;
+          }
+          slen = (int32_t)n;
+        }
+        LOG_ARG_PUT(buf, cap, len, slen);
+        if (slen >= 0) {
+          if (len + slen + 1 > cap) {
+            return TSDB_CODE_OPS_NOT_SUPPORT;
+          }
+          (void)memcpy(buf + len, s, slen);
+          buf[len + slen] = 0;
+          len += slen + 1;
+        }
+      } break;
+      case LOG_ARG_PTR: {
+        uint64_t v = (uint64_t)(uintptr_t)va_arg(args, void *);
+        LOG_ARG_PUT(buf, cap, len, v);
+      } break;
+      default:
+        break;
+    }
+  }
+
+  *pLen = len;
+  return TSDB_CODE_SUCCESS;
+}
+
+#define LOG_SNPRINTF_ARG(buf, size, spec, nStar, stars, v)                         \
+  ((nStar) == 0   ? snprintf((buf), (size), (spec), (v))                           \
+   : (nStar) == 1 ? snprintf((buf), (size), (spec), (stars)[0], (v))               \
+                  : snprintf((buf), (size), (spec), (stars)[0], (stars)[1], (v)))
+
+// format the arguments saved by taosLogSerializeArgs, returns -1 if the arguments are broken
+static int32_t taosLogFormatConv(const char *format, const SLogConv *pConv, const char *data, int32_t dataLen,
+                                 int32_t *pOff, char *buf, int32_t size) {
+  char    spec[LOG_RING_MAX_SPEC_LEN + 4];
+  int32_t stars[2] = {0};
+  int32_t off = *pOff;
+  int32_t specLen = pConv->modStart - pConv->start;
+
+  for (int32_t i = 0; i < pConv->nStar; ++i) {
+    LOG_ARG_GET(data, dataLen, off, stars[i]);
+  }
+
+  // the length modifier is replaced since integers are saved in 64 bits
+  (void)memcpy(spec, format + pConv->start, specLen);
+  if (pConv->argType == LOG_ARG_INT || pConv->argType == LOG_ARG_UINT) {
+    spec[specLen++] = 'l';
+    spec[specLen++] = 'l';
+  }
+  spec[specLen++] = format[pConv->end - 1];
+  spec[specLen] = 0;
+
+  int32_t n = 0;
+  switch (pConv->argType) {
+    case LOG_ARG_INT: {
+      long long v = 0;
+      LOG_ARG_GET(data, dataLen, off, v);
+      n = LOG_SNPRINTF_ARG(buf, size, spec, pConv->nStar, stars, v);
+    } break;
+    case LOG_ARG_UINT: {
+      unsigned long long v = 0;
+      LOG_ARG_GET(data, dataLen, off, v);
+      n = LOG_SNPRINTF_ARG(buf, size, spec, pConv->nStar, stars, v);
+    } break;
+    case LOG_ARG_CHAR: {
+      int32_t v = 0;
+      LOG_ARG_GET(data, dataLen, off, v);
+      n = LOG_SNPRINTF_ARG(buf, size, spec, pConv->nStar, stars, v);
+    } break;
+    case LOG_ARG_DOUBLE: {
+      double v = 0;
+      LOG_ARG_GET(data, dataLen, off, v);
+      n = LOG_SNPRINTF_ARG(buf, size, spec, pConv->nStar, stars, v);
+    } break;
+    case LOG_ARG_STR: {
+      int32_t     slen = 0;
+      const char *s = "(null)";
+      LOG_ARG_GET(data, dataLen, off, slen);
+      if (slen >= 0) {
+        if (off + slen + 1 > dataLen || data[off + slen] != 0) {
+          return -1;
+        }
+        s = data + off;
+        off += slen + 1;
+      }
+      n = LOG_SNPRINTF_ARG(buf, size, spec, pConv->nStar, stars, s);
+    } break;
+    case LOG_ARG_PTR: {
+      uint64_t v = 0;
+      LOG_ARG_GET(data, dataLen, off, v);
+      n = LOG_SNPRINTF_ARG(buf, size, spec, pConv->nStar, stars, (void *)(uintptr_t)v);
+    } break;
+    default:
+      n = snprintf(buf, size, "%%");
+      break;
+  }
+
+  *pOff = off;
+  return (n < 0) ? 0 : TMIN(n, size - 1);
+}
+
+static int32_t taosLogFormatBody(const char *format, const char *data, int32_t dataLen, char *buf, int32_t size) {
+  int32_t  len = 0;
+  int32_t  off = 0;
+  int32_t  pos = 0;
+  SLogConv conv = {0};
+
+  while (format[pos] != 0 && len < size - 1) {
+    const char *p = strchr(format + pos, '%');
+    int32_t     literal = (p == NULL) ? (int32_t)strlen(format + pos) : (int32_t)(p - format - pos);
+
+    literal = TMIN(literal, size - 1 - len);
+    (void)memcpy(buf + len, format + pos, literal);
+    len += literal;
+    pos += literal;
+    if (p == NULL || len >= size - 1) break;
+
+    if (!taosLogParseConv(format, pos, &conv)) {
+      break;
+    }
+
+    int32_t n = taosLogFormatConv(format, &conv, data, dataLen, &off, buf + len, size - len);
+    if (n < 0) break;
+    len += n;
+    pos = conv.end;
+  }
+
+  buf[len] = 0;
+  return len;
+}
+
+static int32_t taosLogFormatLine(char *buf, int64_t ts, int64_t tid, const char *flags, const char *format,
+                                 const char *data, int32_t dataLen) {
+  int32_t len = taosLogBuildHead(buf, LOG_MAX_LINE_BUFFER_SIZE, ts, tid, flags);
+  len += taosLogFormatBody(format, data, dataLen, buf + len, LOG_MAX_LINE_SIZE - len + 1);
+  buf[len++] = '\n';
+  buf[len] = 0;
+  return len;
+}
+
+static void taosLogRingDestructor(void *param) {
+  SLogRing *pRing = param;
+  atomic_store_32(&pRing->closed, 1);
+}
+
+static void taosLogRingInitMutex() { (void)taosThreadMutexInit(&tsLogRingMutex, NULL); }
+
+int32_t taosLogRingInit() {
+  if (atomic_load_8(&tsLogRingInited)) return 0;
+
+  int32_t code = taosThreadKeyCreate(&tsLogRingKey, taosLogRingDestructor);
+  if (code != 0) return code;
+
+  (void)taosThreadOnce(&tsLogRingOnce, taosLogRingInitMutex);
+  tsLogBinFileVer = -1;
+  atomic_store_8(&tsLogRingInited, 1);
+  return 0;
+}
+
+void taosLogRingCleanup() {
+  if (!atomic_load_8(&tsLogRingInited)) return;
+
+  // bumping the version retires all rings, then the writers which acquired a ring before that finish their records
+  atomic_store_8(&tsLogRingInited, 0);
+  TAOS_UNUSED(atomic_add_fetch_32(&tsLogRingVer, 1));
+  (void)taosThreadKeyDelete(tsLogRingKey);
+  for (int32_t i = 0; i < LOG_RING_WRITER_SLOTS; ++i) {
+    while (atomic_load_32(&tsLogRingWriters[i].num) != 0) {
+      (void)sched_yield();
+    }
+  }
+
+  (void)taosThreadMutexLock(&tsLogRingMutex);
+  while (tsLogRings != NULL) {
+    SLogRing *pRing = tsLogRings;
+    tsLogRings = pRing->next;
+    taosMemoryFree(pRing);
+  }
+  (void)taosThreadMutexUnlock(&tsLogRingMutex);
+
+  taosHashCleanup(tsLogBinDict);
+  tsLogBinDict = NULL;
+  taosMemoryFreeClear(tsLogRingActive);
+  tsLogRingActiveCap = 0;
+}
+
+static void taosLogRingRelease() {
+  TAOS_UNUSED(atomic_sub_fetch_32(&tsLogRingWriters[tsLocalLogRingSlot].num, 1));
+}
+
+/*
+ * Return the ring of the thread, taosLogRingCleanup does not free any ring until taosLogRingRelease is called. The
+ * writer is counted before it checks the version and cleanup bumps the version before it checks the counters, so
+ * either the writer sees its ring retired or cleanup waits for the writer.
+ */
+static SLogRing *taosLogRingAcquire() {
+  // nobody is counted in once cleanup started, so that it does not wait for busy writers forever
+  if (!atomic_load_8(&tsLogRingInited)) {
+    return NULL;
+  }
+  if (tsLocalLogRingSlot < 0) {
+    tsLocalLogRingSlot = (int32_t)(taosGetSelfPthreadId() & (LOG_RING_WRITER_SLOTS - 1));
+  }
+  TAOS_UNUSED(atomic_add_fetch_32(&tsLogRingWriters[tsLocalLogRingSlot].num, 1));
+
+  SLogRing *pRing = tsLocalLogRing;
+  int32_t   ver = atomic_load_32(&tsLogRingVer);
+  if (pRing != NULL && tsLocalLogRingVer == ver) {
+    return pRing;
+  }
+
+  // the allocation below may print logs as well
+  if (!atomic_load_8(&tsLogRingInited) || tsLocalLogRingCreating) {
+    taosLogRingRelease();
+    return NULL;
+  }
+
+  tsLocalLogRingCreating = true;
+  pRing = taosMemoryCalloc(1, sizeof(SLogRing) + LOG_RING_SIZE);
+  tsLocalLogRingCreating = false;
+  if (pRing == NULL) {
+    taosLogRingRelease();
+    return NULL;
+  }
+
+  // a ring linked after cleanup went through the list would never be freed
+  (void)taosThreadMutexLock(&tsLogRingMutex);
+  if (atomic_load_32(&tsLogRingVer) != ver) {
+    (void)taosThreadMutexUnlock(&tsLogRingMutex);
+    taosMemoryFree(pRing);
+    taosLogRingRelease();
+    return NULL;
+  }
+  pRing->next = tsLogRings;
+  tsLogRings = pRing;
+  (void)taosThreadMutexUnlock(&tsLogRingMutex);
+
+  // the ring is released by the log thread once the thread exits and the ring is drained
+  (void)taosThreadSetSpecific(tsLogRingKey, pRing);
+  tsLocalLogRing = pRing;
+  tsLocalLogRingVer = ver;
+  return pRing;
+}
+
+static SLogRecHead *taosLogRingReserve(SLogRing *pRing, int32_t len, int64_t *pTail) {
+  int64_t tail = pRing->tail;
+  int64_t head = atomic_load_64(&pRing->head);
+  int32_t pos = (int32_t)(tail & (LOG_RING_SIZE - 1));
+  int32_t contiguous = LOG_RING_SIZE - pos;
+  int32_t need = (len <= contiguous) ? len : contiguous + len;
+
+  if (LOG_RING_SIZE - (tail - head) < need) {
+    atomic_add_fetch_64(&pRing->lostLines, 1);
+    return NULL;
+  }
+
+  if (len > contiguous) {
+    ((SLogRecHead *)(pRing->buffer + pos))->len = LOG_RING_WRAP;
+    tail += contiguous;
+    pos = 0;
+  }
+
+  *pTail = tail;
+  return (SLogRecHead *)(pRing->buffer + pos);
+}
+
+int32_t taosLogRingPutFmt(const char *flags, const char *format, va_list args) {
+  if (!atomic_load_8(&tsLogRingInited)) {
+    return TSDB_CODE_OPS_NOT_SUPPORT;
+  }
+
+  size_t flagsLen = strlen(flags) + 1;
+  size_t fmtLen = strlen(format) + 1;
+  if (flagsLen > UINT8_MAX || fmtLen > LOG_RING_MAX_FMT_LEN) {
+    return TSDB_CODE_OPS_NOT_SUPPORT;
+  }
+
+  char    data[LOG_RING_MAX_ARG_SIZE];
+  int32_t dataLen = 0;
+  int32_t code = taosLogSerializeArgs(format, args, data, sizeof(data), &dataLen);
+  if (code != 0) {
+    return code;
+  }
+
+  SLogRing *pRing = taosLogRingAcquire();
+  if (pRing == NULL) {
+    return TSDB_CODE_OPS_NOT_SUPPORT;
+  }
+
+  int64_t      tail = 0;
+  int32_t      len = LOG_RING_ALIGN((int32_t)(sizeof(SLogRecHead) + flagsLen + fmtLen) + dataLen);
+  SLogRecHead *pHead = taosLogRingReserve(pRing, len, &tail);
+  if (pHead == NULL) {
+    taosLogRingRelease();
+    return TSDB_CODE_OUT_OF_BUFFER;
+  }
+
+  pHead->len = len;
+  pHead->type = LOG_REC_FMT;
+  pHead->flagsLen = (uint8_t)flagsLen;
+  pHead->fmtLen = (uint16_t)fmtLen;
+  pHead->dataLen = dataLen;
+  pHead->ts = taosGetTimestampUs();
+  pHead->tid = taosGetSelfPthreadId();
+
+  char *p = (char *)(pHead + 1);
+  (void)memcpy(p, flags, flagsLen);
+  (void)memcpy(p + flagsLen, format, fmtLen);
+  (void)memcpy(p + flagsLen + fmtLen, data, dataLen);
+
+  atomic_store_64(&pRing->tail, tail + len);
+  taosLogRingRelease();
+  return TSDB_CODE_SUCCESS;
+}
+
+int32_t taosLogRingPutText(const char *msg, int32_t msgLen) {
+  int32_t len = LOG_RING_ALIGN((int32_t)sizeof(SLogRecHead) + msgLen);
+  if (len > LOG_RING_MAX_REC_SIZE) {
+    return TSDB_CODE_OPS_NOT_SUPPORT;
+  }
+
+  SLogRing *pRing = taosLogRingAcquire();
+  if (pRing == NULL) {
+    return TSDB_CODE_OPS_NOT_SUPPORT;
+  }
+
+  int64_t      tail = 0;
+  SLogRecHead *pHead = taosLogRingReserve(pRing, len, &tail);
+  if (pHead == NULL) {
+    taosLogRingRelease();
+    return TSDB_CODE_OUT_OF_BUFFER;
+  }
+
+  pHead->len = len;
+  pHead->type = LOG_REC_TEXT;
+  pHead->flagsLen = 0;
+  pHead->fmtLen = 0;
+  pHead->dataLen = msgLen;
+  pHead->ts = taosGetTimestampUs();
+  pHead->tid = taosGetSelfPthreadId();
+  (void)memcpy(pHead + 1, msg, msgLen);
+
+  atomic_store_64(&pRing->tail, tail + len);
+  taosLogRingRelease();
+  return TSDB_CODE_SUCCESS;
+}
+
+int32_t taosLogBinaryEncodeText(const char *msg, int32_t msgLen, char *buf, int32_t size) {
+  if (size < msgLen + 5) return -1;
+
+  uint32_t len = msgLen;
+  buf[0] = LOG_BIN_TEXT;
+  (void)memcpy(buf + 1, &len, sizeof(len));
+  (void)memcpy(buf + 5, msg, msgLen);
+  return msgLen + 5;
+}
+
+// the string is keyed with its trailing '\0', so that an empty string is a valid key as well
+static uint32_t taosLogBinIntern(const char *str, int32_t size, FLogOutput fp, void *param) {
+  uint32_t *pId = taosHashGet(tsLogBinDict, str, size);
+  if (pId != NULL) {
+    return *pId;
+  }
+
+  uint32_t id = tsLogBinNextId++;
+  if (taosHashPut(tsLogBinDict, str, size, &id, sizeof(id)) != 0) {
+    // it is defined again on the next use
+    tsLogBinNextId--;
+  }
+
+  uint32_t len = size - 1;
+  tsLogRingDict[0] = LOG_BIN_DICT;
+  (void)memcpy(tsLogRingDict + 1, &id, sizeof(id));
+  (void)memcpy(tsLogRingDict + 5, &len, sizeof(len));
+  (void)memcpy(tsLogRingDict + 9, str, len);
+  fp(param, tsLogRingDict, 9 + len);
+  return id;
+}
+
+static void taosLogBinReset(FLogOutput fp, void *param) {
+  if (tsLogBinDict == NULL) {
+    tsLogBinDict = taosHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_NO_LOCK);
+  } else {
+    taosHashClear(tsLogBinDict);
+  }
+  tsLogBinNextId = 0;
+
+  char    magic[LOG_BIN_MAGIC_LEN + sizeof(int32_t)];
+  int32_t version = LOG_BIN_VERSION;
+  (void)memcpy(magic, LOG_BIN_MAGIC, LOG_BIN_MAGIC_LEN);
+  (void)memcpy(magic + LOG_BIN_MAGIC_LEN, &version, sizeof(version));
+  fp(param, magic, sizeof(magic));
+}
+
+static void taosLogRingOutputRec(const SLogRecHead *pHead, int8_t mode, FLogOutput fp, void *param) {
+  const char *p = (const char *)(pHead + 1);
+
+  if (pHead->type == LOG_REC_TEXT) {
+    if (mode == LOG_RING_BINARY) {
+      int32_t len = taosLogBinaryEncodeText(p, pHead->dataLen, tsLogRingBin, sizeof(tsLogRingBin));
+      if (len > 0) fp(param, tsLogRingBin, len);
+    } else {
+      fp(param, p, pHead->dataLen);
+    }
+    return;
+  }
+
+  const char *flags = p;
+  const char *format = p + pHead->flagsLen;
+  const char *data = format + pHead->fmtLen;
+
+  if (mode != LOG_RING_BINARY) {
+    int32_t len = taosLogFormatLine(tsLogRingLine, pHead->ts, pHead->tid, flags, format, data, pHead->dataLen);
+    fp(param, tsLogRingLine, len);
+    return;
+  }
+
+  if (tsLogBinDict == NULL) return;
+
+  uint32_t flagsId = taosLogBinIntern(flags, pHead->flagsLen, fp, param);
+  uint32_t fmtId = taosLogBinIntern(format, pHead->fmtLen, fp, param);
+  uint32_t dataLen = pHead->dataLen;
+  char    *q = tsLogRingBin;
+
+  *q++ = LOG_BIN_REC;
+  (void)memcpy(q, &dataLen, sizeof(dataLen));
+  q += sizeof(dataLen);
+  (void)memcpy(q, &pHead->ts, sizeof(pHead->ts));
+  q += sizeof(pHead->ts);
+  (void)memcpy(q, &pHead->tid, sizeof(pHead->tid));
+  q += sizeof(pHead->tid);
+  (void)memcpy(q, &flagsId, sizeof(flagsId));
+  q += sizeof(flagsId);
+  (void)memcpy(q, &fmtId, sizeof(fmtId));
+  q += sizeof(fmtId);
+  (void)memcpy(q, data, dataLen);
+  q += dataLen;
+  fp(param, tsLogRingBin, (int32_t)(q - tsLogRingBin));
+}
+
+// returns the record at the drain head, or NULL if all records taken are drained
+static SLogRecHead *taosLogRingPeek(SLogRing *pRing) {
+  while (pRing->drainHead < pRing->drainTail) {
+    int32_t      pos = (int32_t)(pRing->drainHead & (LOG_RING_SIZE - 1));
+    SLogRecHead *pHead = (SLogRecHead *)(pRing->buffer + pos);
+    if (pHead->len != LOG_RING_WRAP) {
+      return pHead;
+    }
+    pRing->drainHead += LOG_RING_SIZE - pos;
+  }
+
+  atomic_store_64(&pRing->head, pRing->drainHead);
+  return NULL;
+}
+
+static void taosLogRingOutputLost(SLogRing *pRing, int8_t mode, FLogOutput fp, void *param) {
+  int64_t lostLines = atomic_exchange_64(&pRing->lostLines, 0);
+  if (lostLines <= 0) return;
+
+  char    msg[128];
+  int32_t len = snprintf(msg, sizeof(msg), "...Lost %" PRId64 " lines here...\n", lostLines);
+  if (mode == LOG_RING_BINARY) {
+    char buf[sizeof(msg) + 5];
+    len = taosLogBinaryEncodeText(msg, len, buf, sizeof(buf));
+    fp(param, buf, len);
+  } else {
+    fp(param, msg, len);
+  }
+}
+
+void taosLogRingDrain(int8_t mode, int32_t fileVer, FLogOutput fp, void *param) {
+  if (!atomic_load_8(&tsLogRingInited)) return;
+
+  // each log file starts with its own dictionary
+  if (mode == LOG_RING_BINARY && fileVer != tsLogBinFileVer) {
+    taosLogBinReset(fp, param);
+    tsLogBinFileVer = fileVer;
+  }
+
+  (void)taosThreadMutexLock(&tsLogRingMutex);
+
+  int32_t num = 0;
+  for (SLogRing *pRing = tsLogRings; pRing != NULL; pRing = pRing->next) {
+    // nothing is written into the ring after it is closed
+    pRing->drainClosed = atomic_load_32(&pRing->closed);
+    pRing->drainHead = pRing->head;
+    pRing->drainTail = atomic_load_64(&pRing->tail);
+    if (taosLogRingPeek(pRing) == NULL) continue;
+
+    if (num == tsLogRingActiveCap) {
+      int32_t    cap = TMAX(tsLogRingActiveCap * 2, 64);
+      SLogRing **pActive = taosMemoryRealloc(tsLogRingActive, cap * POINTER_BYTES);
+      if (pActive == NULL) {
+        // drained next time
+        pRing->drainTail = pRing->drainHead;
+        pRing->drainClosed = 0;
+        continue;
+      }
+      tsLogRingActive = pActive;
+      tsLogRingActiveCap = cap;
+    }
+    tsLogRingActive[num++] = pRing;
+  }
+
+  // lines of all threads are output in the order of time
+  while (num > 0) {
+    int32_t      min = 0;
+    SLogRecHead *pMin = taosLogRingPeek(tsLogRingActive[0]);
+    for (int32_t i = 1; i < num; ++i) {
+      SLogRecHead *pHead = taosLogRingPeek(tsLogRingActive[i]);
+      if (pHead->ts < pMin->ts) {
+        min = i;
+        pMin = pHead;
+      }
+    }
+
+    taosLogRingOutputRec(pMin, mode, fp, param);
+    tsLogRingActive[min]->drainHead += pMin->len;
+    if (taosLogRingPeek(tsLogRingActive[min]) == NULL) {
+      tsLogRingActive[min] = tsLogRingActive[--num];
+    }
+  }
+
+  SLogRing **ppRing = &tsLogRings;
+  while (*ppRing != NULL) {
+    SLogRing *pRing = *ppRing;
+    taosLogRingOutputLost(pRing, mode, fp, param);
+    if (pRing->drainClosed && pRing->drainHead == pRing->drainTail) {
+      *ppRing = pRing->next;
+      taosMemoryFree(pRing);
+    } else {
+      ppRing = &pRing->next;
+    }
+  }
+
+  (void)taosThreadMutexUnlock(&tsLogRingMutex);
+}
+
+int32_t taosLogDecoderOpen(SLogDecoder **ppDecoder) {
+  SLogDecoder *pDecoder = taosMemoryCalloc(1, sizeof(SLogDecoder));
+  if (pDecoder == NULL) {
+    return terrno;
+  }
+
+  pDecoder->pDict = taosArrayInit(1024, POINTER_BYTES);
+  pDecoder->cap = LOG_DECODE_BUF_SIZE;
+  pDecoder->buf = taosMemoryMalloc(pDecoder->cap);
+  if (pDecoder->pDict == NULL || pDecoder->buf == NULL) {
+    taosLogDecoderClose(pDecoder);
+    return terrno;
+  }
+
+  *ppDecoder = pDecoder;
+  return 0;
+}
+
+void taosLogDecoderClose(SLogDecoder *pDecoder) {
+  if (pDecoder == NULL) return;
+
+  taosArrayDestroyP(pDecoder->pDict, NULL);
+  taosMemoryFree(pDecoder->buf);
+  taosMemoryFree(pDecoder);
+}
+
+// buffer at least n bytes if the file has, the number of bytes available is returned in pAvail
+static int32_t taosLogDecoderFill(SLogDecoder *pDecoder, int64_t n, int64_t *pAvail) {
+  if (pDecoder->end - pDecoder->start < n && !pDecoder->eof) {
+    int64_t avail = pDecoder->end - pDecoder->start;
+    (void)memmove(pDecoder->buf, pDecoder->buf + pDecoder->start, avail);
+    pDecoder->start = 0;
+    pDecoder->end = avail;
+
+    if (n > pDecoder->cap) {
+      char *buf = taosMemoryRealloc(pDecoder->buf, n);
+      if (buf == NULL) return terrno;
+      pDecoder->buf = buf;
+      pDecoder->cap = n;
+    }
+
+    while (pDecoder->end < n && !pDecoder->eof) {
+      int64_t nread = taosReadFile(pDecoder->pFile, pDecoder->buf + pDecoder->end, pDecoder->cap - pDecoder->end);
+      if (nread < 0) return terrno;
+      if (nread == 0) pDecoder->eof = true;
+      pDecoder->end += nread;
+    }
+  }
+
+  *pAvail = pDecoder->end - pDecoder->start;
+  return 0;
+}
+
+static int32_t taosLogDecoderSetDict(SLogDecoder *pDecoder, uint32_t id, const char *str, uint32_t len) {
+  char *s = taosStrndup(str, len);
+  if (s == NULL) return terrno;
+
+  while (taosArrayGetSize(pDecoder->pDict) <= id) {
+    char *dummy = NULL;
+    if (taosArrayPush(pDecoder->pDict, &dummy) == NULL) {
+      taosMemoryFree(s);
+      return terrno;
+    }
+  }
+
+  char **pp = taosArrayGet(pDecoder->pDict, id);
+  taosMemoryFree(*pp);
+  *pp = s;
+  return 0;
+}
+
+static const char *taosLogDecoderGetDict(SLogDecoder *pDecoder, uint32_t id) {
+  if (id >= taosArrayGetSize(pDecoder->pDict)) return NULL;
+  return *(char **)taosArrayGet(pDecoder->pDict, id);
+}
+
+// decode one binary record at the current position, returns false if it is not a valid one
+static bool taosLogDecodeRec(SLogDecoder *pDecoder, FLogOutput fp, void *param, int32_t *pCode) {
+  int64_t avail = 0;
+  char   *p = pDecoder->buf + pDecoder->start;
+
+  switch ((uint8_t)p[0]) {
+    case LOG_BIN_MAGIC_TAG: {
+      if ((*pCode = taosLogDecoderFill(pDecoder, LOG_BIN_MAGIC_LEN + sizeof(int32_t), &avail)) != 0) return false;
+      p = pDecoder->buf + pDecoder->start;
+      if (avail < LOG_BIN_MAGIC_LEN + sizeof(int32_t) || memcmp(p, LOG_BIN_MAGIC, LOG_BIN_MAGIC_LEN) != 0) {
+        return false;
+      }
+      taosArrayClearP(pDecoder->pDict, NULL);
+      pDecoder->start += LOG_BIN_MAGIC_LEN + sizeof(int32_t);
+    } break;
+    case LOG_BIN_DICT: {
+      uint32_t id = 0, len = 0;
+      if ((*pCode = taosLogDecoderFill(pDecoder, 9, &avail)) != 0 || avail < 9) return false;
+      p = pDecoder->buf + pDecoder->start;
+      (void)memcpy(&id, p + 1, sizeof(id));
+      (void)memcpy(&len, p + 5, sizeof(len));
+      if (len > LOG_RING_MAX_FMT_LEN || id > LOG_BIN_MAX_LEN) return false;
+      if ((*pCode = taosLogDecoderFill(pDecoder, 9 + len, &avail)) != 0 || avail < 9 + len) return false;
+      p = pDecoder->buf + pDecoder->start;
+      if ((*pCode = taosLogDecoderSetDict(pDecoder, id, p + 9, len)) != 0) return false;
+      pDecoder->start += 9 + len;
+    } break;
+    case LOG_BIN_TEXT: {
+      uint32_t len = 0;
+      if ((*pCode = taosLogDecoderFill(pDecoder, 5, &avail)) != 0 || avail < 5) return false;
+      (void)memcpy(&len, pDecoder->buf + pDecoder->start + 1, sizeof(len));
+      if (len > LOG_BIN_MAX_LEN) return false;
+      if ((*pCode = taosLogDecoderFill(pDecoder, 5 + len, &avail)) != 0 || avail < 5 + len) return false;
+      fp(param, pDecoder->buf + pDecoder->start + 5, len);
+      pDecoder->start += 5 + len;
+    } break;
+    case LOG_BIN_REC: {
+      uint32_t dataLen = 0, flagsId = 0, fmtId = 0;
+      int64_t  ts = 0, tid = 0;
+      if ((*pCode = taosLogDecoderFill(pDecoder, LOG_BIN_REC_HEAD, &avail)) != 0 || avail < LOG_BIN_REC_HEAD) {
+        return false;
+      }
+      p = pDecoder->buf + pDecoder->start;
+      (void)memcpy(&dataLen, p + 1, sizeof(dataLen));
+      (void)memcpy(&ts, p + 5, sizeof(ts));
+      (void)memcpy(&tid, p + 13, sizeof(tid));
+      (void)memcpy(&flagsId, p + 21, sizeof(flagsId));
+      (void)memcpy(&fmtId, p + 25, sizeof(fmtId));
+      if (dataLen > LOG_RING_MAX_REC_SIZE) return false;
+      if ((*pCode = taosLogDecoderFill(pDecoder, LOG_BIN_REC_HEAD + dataLen, &avail)) != 0 ||
+          avail < LOG_BIN_REC_HEAD + dataLen) {
+        return false;
+      }
+
+      const char *flags = taosLogDecoderGetDict(pDecoder, flagsId);
+      const char *format = taosLogDecoderGetDict(pDecoder, fmtId);
+      int32_t     len = 0;
+      if (flags == NULL || format == NULL) {
+        // the dictionary is in the previous file
+        len = taosLogFormatLine(pDecoder->line, ts, tid, "", "<format not found>", NULL, 0);
+      } else {
+        p = pDecoder->buf + pDecoder->start + LOG_BIN_REC_HEAD;
+        len = taosLogFormatLine(pDecoder->line, ts, tid, flags, format, p, dataLen);
+      }
+      fp(param, pDecoder->line, len);
+      pDecoder->start += LOG_BIN_REC_HEAD + dataLen;
+    } break;
+    default:
+      return false;
+  }
+
+  return true;
+}
+
+int32_t taosLogDecodeFile(SLogDecoder *pDecoder, const char *fileName, FLogOutput fp, void *param) {
+  int32_t code = 0;
+  int64_t avail = 0;
+  int64_t from = 0;
+  bool    binary = false;
+
+  pDecoder->pFile = taosOpenFile(fileName, TD_FILE_READ);
+  if (pDecoder->pFile == NULL) {
+    return terrno;
+  }
+  pDecoder->start = pDecoder->end = 0;
+  pDecoder->eof = false;
+
+  while (true) {
+    if (binary) {
+      if ((code = taosLogDecoderFill(pDecoder, 1, &avail)) != 0) break;
+      if (avail == 0) break;
+      if (!taosLogDecodeRec(pDecoder, fp, param, &code)) {
+        if (code != 0) break;
+        // not a valid record, copy the bytes as is until the next magic
+        binary = false;
+        from = 1;
+      }
+      continue;
+    }
+
+    if ((code = taosLogDecoderFill(pDecoder, LOG_DECODE_BUF_SIZE, &avail)) != 0) break;
+    if (avail == 0) break;
+
+    char *p = pDecoder->buf + pDecoder->start;
+    char *pMagic = tmemmem(p + from, (int32_t)(avail - from), LOG_BIN_MAGIC, LOG_BIN_MAGIC_LEN);
+
+    int64_t n = 0;
+    if (pMagic != NULL) {
+      n = pMagic - p;
+      binary = true;
+    } else {
+      // the tail may be the beginning of a magic, the buffer is full unless at the end of the file
+      n = pDecoder->eof ? avail : avail - (LOG_BIN_MAGIC_LEN - 1);
+    }
+    from = 0;
+
+    if (n > 0) {
+      fp(param, p, (int32_t)n);
+      pDecoder->start += n;
+    }
+  }
+
+  (void)taosCloseFile(&pDecoder->pFile);
+  return code;
+}
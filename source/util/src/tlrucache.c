@@ -35,6 +35,10 @@ enum {
   TAOS_LRU_IN_HIGH_PRI_POOL = (1 << 2),  // Whether this entry is in high-pri pool.
 
   TAOS_LRU_HAS_HIT = (1 << 3),  // Whether this entry has had any lookups (hits).
+
+  TAOS_LRU_IN_MAIN = (1 << 4),  // W-TinyLFU: whether this entry has been admitted from the window to the main segment.
+
+  TAOS_LRU_IN_PROTECTED = (1 << 5),  // W-TinyLFU: whether this entry is in the protected part of the main segment.
 };
 
 struct SLRUEntry {
@@ -57,6 +61,8 @@ struct SLRUEntry {
 #define TAOS_LRU_ENTRY_IN_HIGH_POOL(h) ((h)->flags & TAOS_LRU_IN_HIGH_PRI_POOL)
 #define TAOS_LRU_ENTRY_IS_HIGH_PRI(h)  ((h)->flags & TAOS_LRU_IS_HIGH_PRI)
 #define TAOS_LRU_ENTRY_HAS_HIT(h)      ((h)->flags & TAOS_LRU_HAS_HIT)
+#define TAOS_LRU_ENTRY_IN_MAIN(h)      ((h)->flags & TAOS_LRU_IN_MAIN)
+#define TAOS_LRU_ENTRY_IN_PROTECTED(h) ((h)->flags & TAOS_LRU_IN_PROTECTED)
 
 #define TAOS_LRU_ENTRY_SET_IN_CACHE(h, inCache) \
   do {                                          \
@@ -82,7 +88,16 @@ struct SLRUEntry {
       (h)->flags &= ~TAOS_LRU_IS_HIGH_PRI;       \
     }                                            \
   } while (0)
-#define TAOS_LRU_ENTRY_SET_HIT(h) ((h)->flags |= TAOS_LRU_HAS_HIT)
+#define TAOS_LRU_ENTRY_SET_HIT(h)     ((h)->flags |= TAOS_LRU_HAS_HIT)
+#define TAOS_LRU_ENTRY_SET_IN_MAIN(h) ((h)->flags |= TAOS_LRU_IN_MAIN)
+#define TAOS_LRU_ENTRY_SET_IN_PROTECTED(h, inProtected) \
+  do {                                                  \
+    if (inProtected) {                                  \
+      (h)->flags |= TAOS_LRU_IN_PROTECTED;              \
+    } else {                                            \
+      (h)->flags &= ~TAOS_LRU_IN_PROTECTED;             \
+    }                                                   \
+  } while (0)
 
 #define TAOS_LRU_ENTRY_HAS_REFS(h) ((h)->refs > 0)
 #define TAOS_LRU_ENTRY_REF(h)      (++(h)->refs)
@@ -237,6 +252,79 @@ static SLRUEntry *taosLRUEntryTableRemove(SLRUEntryTable *table, const void *key
   return result;
 }
 
+/*
+ * Count-min sketch with 4-bit saturating counters used by W-TinyLFU to estimate the access frequency of a key.
+ * All counters are halved every sampleSize additions, so that the estimation follows the recent workload.
+ */
+#define TAOS_LRU_SKETCH_DEPTH    4
+#define TAOS_LRU_SKETCH_MAX_FREQ 15
+#define TAOS_LRU_SKETCH_MIN_BITS 10
+#define TAOS_LRU_SKETCH_MAX_BITS 20
+
+typedef struct SLRUFreqSketch {
+  uint8_t *counters;  // TAOS_LRU_SKETCH_DEPTH rows of (1 << widthBits) counters
+  int32_t  widthBits;
+  uint32_t additions;
+  uint32_t sampleSize;
+} SLRUFreqSketch;
+
+static const uint32_t taosLRUSketchSeeds[TAOS_LRU_SKETCH_DEPTH] = {0x97CB3127, 0xB4B82E3D, 0xC2B2AE35, 0x9E3779B1};
+
+static int32_t taosLRUSketchInit(SLRUFreqSketch *sketch, int32_t widthBits) {
+  uint8_t *counters = taosMemoryCalloc(TAOS_LRU_SKETCH_DEPTH, 1 << widthBits);
+  if (!counters) {
+    TAOS_RETURN(terrno);
+  }
+
+  taosMemoryFree(sketch->counters);
+  sketch->counters = counters;
+  sketch->widthBits = widthBits;
+  sketch->additions = 0;
+  sketch->sampleSize = 10 * (1 << widthBits);
+
+  TAOS_RETURN(TSDB_CODE_SUCCESS);
+}
+
+static void taosLRUSketchCleanup(SLRUFreqSketch *sketch) { taosMemoryFreeClear(sketch->counters); }
+
+// The shard index is taken from the low bits of the hash, so the counter index uses the high bits of a product.
+static FORCE_INLINE uint8_t *taosLRUSketchCounter(SLRUFreqSketch *sketch, uint32_t hash, int32_t row) {
+  uint32_t idx = (hash * taosLRUSketchSeeds[row]) >> (32 - sketch->widthBits);
+  return &sketch->counters[((size_t)row << sketch->widthBits) + idx];
+}
+
+static void taosLRUSketchIncrement(SLRUFreqSketch *sketch, uint32_t hash) {
+  if (!sketch->counters) return;
+
+  for (int32_t i = 0; i < TAOS_LRU_SKETCH_DEPTH; ++i) {
+    uint8_t *counter = taosLRUSketchCounter(sketch, hash, i);
+    if (*counter < TAOS_LRU_SKETCH_MAX_FREQ) {
+      ++(*counter);
+    }
+  }
+
+  if (++sketch->additions >= sketch->sampleSize) {
+    size_t size = (size_t)TAOS_LRU_SKETCH_DEPTH << sketch->widthBits;
+    for (size_t i = 0; i < size; ++i) {
+      sketch->counters[i] >>= 1;
+    }
+    sketch->additions >>= 1;
+  }
+}
+
+static uint8_t taosLRUSketchFrequency(SLRUFreqSketch *sketch, uint32_t hash) {
+  if (!sketch->counters) return 0;
+
+  uint8_t freq = TAOS_LRU_SKETCH_MAX_FREQ;
+  for (int32_t i = 0; i < TAOS_LRU_SKETCH_DEPTH; ++i) {
+    freq = TMIN(freq, *taosLRUSketchCounter(sketch, hash, i));
+  }
+  return freq;
+}
+
+#define TAOS_LRU_WINDOW_RATIO  0.01  // W-TinyLFU: share of the admission window
+#define TAOS_LRU_PROTECT_RATIO 0.8   // W-TinyLFU: share of the protected part in the main segment
+
 struct SLRUCacheShard {
   size_t         capacity;
   size_t         highPriPoolUsage;
@@ -248,11 +336,139 @@ struct SLRUCacheShard {
   SLRUEntryTable table;
   size_t         usage;     // Memory size for entries residing in the cache.
   size_t         lruUsage;  // Memory size for entries residing only in the LRU list.
+  LRUPolicy      policy;
+  // W-TinyLFU: new entries enter the window, window victims are admitted into the main segment (probation and
+  // protected SLRU lists) only if they are estimated to be more frequent than the victim of the main segment.
+  SLRUEntry      window;
+  SLRUEntry      probation;
+  SLRUEntry      protect;
+  size_t         windowUsage;
+  size_t         windowCapacity;
+  size_t         protectUsage;
+  size_t         protectCapacity;
+  SLRUFreqSketch sketch;
+  int64_t        hits;
+  int64_t        misses;
   TdThreadMutex  mutex;
 };
 
 #define TAOS_LRU_CACHE_SHARD_HASH32(key, len) (MurmurHash3_32((key), (len)))
 
+#define TAOS_LRU_LIST_EMPTY(head) ((head)->next == (head))
+
+static void taosLRUListAppend(SLRUEntry *head, SLRUEntry *e) {
+  e->next = head;
+  e->prev = head->prev;
+
+  e->prev->next = e;
+  e->next->prev = e;
+}
+
+static void taosLRUListUnlink(SLRUEntry *e) {
+  e->next->prev = e->prev;
+  e->prev->next = e->next;
+  e->prev = e->next = NULL;
+}
+
+static bool taosLRUCacheShardLRUEmpty(SLRUCacheShard *shard) {
+  if (shard->policy == TAOS_LRU_POLICY_TINYLFU) {
+    return TAOS_LRU_LIST_EMPTY(&shard->window) && TAOS_LRU_LIST_EMPTY(&shard->probation) &&
+           TAOS_LRU_LIST_EMPTY(&shard->protect);
+  }
+
+  return TAOS_LRU_LIST_EMPTY(&shard->lru);
+}
+
+static void taosLRUCacheShardSetTinyLFUCapacity(SLRUCacheShard *shard) {
+  shard->windowCapacity = shard->capacity * TAOS_LRU_WINDOW_RATIO;
+  shard->protectCapacity = (shard->capacity - shard->windowCapacity) * TAOS_LRU_PROTECT_RATIO;
+}
+
+static void taosLRUCacheShardAdmit(SLRUCacheShard *shard, SLRUEntry *e) {
+  taosLRUListUnlink(e);
+  shard->windowUsage -= e->totalCharge;
+
+  TAOS_LRU_ENTRY_SET_IN_MAIN(e);
+  taosLRUListAppend(&shard->probation, e);
+}
+
+// window overflow is admitted freely while the main segment is not full
+static void taosLRUCacheShardMaintainWindow(SLRUCacheShard *shard) {
+  size_t mainCapacity = shard->capacity - shard->windowCapacity;
+  while (shard->windowUsage > shard->windowCapacity && !TAOS_LRU_LIST_EMPTY(&shard->window)) {
+    SLRUEntry *e = shard->window.next;
+    if (shard->lruUsage - shard->windowUsage + e->totalCharge > mainCapacity) {
+      break;
+    }
+    taosLRUCacheShardAdmit(shard, e);
+  }
+}
+
+static void taosLRUCacheShardTinyLFUInsert(SLRUCacheShard *shard, SLRUEntry *e) {
+  if (!TAOS_LRU_ENTRY_IN_MAIN(e)) {
+    taosLRUListAppend(&shard->window, e);
+    shard->windowUsage += e->totalCharge;
+  } else if (TAOS_LRU_ENTRY_HAS_HIT(e)) {
+    // referenced again while in the main segment, promote to protected
+    taosLRUListAppend(&shard->protect, e);
+    TAOS_LRU_ENTRY_SET_IN_PROTECTED(e, true);
+    shard->protectUsage += e->totalCharge;
+
+    while (shard->protectUsage > shard->protectCapacity && shard->protect.next != e) {
+      SLRUEntry *old = shard->protect.next;
+      taosLRUListUnlink(old);
+      TAOS_LRU_ENTRY_SET_IN_PROTECTED(old, false);
+      shard->protectUsage -= old->totalCharge;
+      taosLRUListAppend(&shard->probation, old);
+    }
+  } else {
+    taosLRUListAppend(&shard->probation, e);
+  }
+
+  shard->lruUsage += e->totalCharge;
+  taosLRUCacheShardMaintainWindow(shard);
+}
+
+static void taosLRUCacheShardTinyLFURemove(SLRUCacheShard *shard, SLRUEntry *e) {
+  taosLRUListUnlink(e);
+
+  shard->lruUsage -= e->totalCharge;
+  if (!TAOS_LRU_ENTRY_IN_MAIN(e)) {
+    shard->windowUsage -= e->totalCharge;
+  } else if (TAOS_LRU_ENTRY_IN_PROTECTED(e)) {
+    shard->protectUsage -= e->totalCharge;
+    TAOS_LRU_ENTRY_SET_IN_PROTECTED(e, false);
+  }
+}
+
+// pick the entry to evict, the window candidate competes with the main victim by estimated frequency
+static SLRUEntry *taosLRUCacheShardTinyLFUVictim(SLRUCacheShard *shard, size_t charge) {
+  SLRUEntry *candidate = NULL;
+  SLRUEntry *victim = NULL;
+
+  if (!TAOS_LRU_LIST_EMPTY(&shard->window) && shard->windowUsage + charge > shard->windowCapacity) {
+    candidate = shard->window.next;
+  }
+  if (!TAOS_LRU_LIST_EMPTY(&shard->probation)) {
+    victim = shard->probation.next;
+  } else if (!TAOS_LRU_LIST_EMPTY(&shard->protect)) {
+    victim = shard->protect.next;
+  }
+
+  if (candidate == NULL) {
+    return victim ? victim : shard->window.next;
+  } else if (victim == NULL) {
+    return candidate;
+  }
+
+  if (taosLRUSketchFrequency(&shard->sketch, candidate->hash) > taosLRUSketchFrequency(&shard->sketch, victim->hash)) {
+    taosLRUCacheShardAdmit(shard, candidate);
+    return victim;
+  }
+
+  return candidate;
+}
+
 static void taosLRUCacheShardMaintainPoolSize(SLRUCacheShard *shard) {
   while (shard->highPriPoolUsage > shard->highPriPoolCapacity) {
     shard->lruLowPri = shard->lruLowPri->next;
@@ -263,6 +479,11 @@ static void taosLRUCacheShardMaintainPoolSize(SLRUCacheShard *shard) {
 }
 
 static void taosLRUCacheShardLRUInsert(SLRUCacheShard *shard, SLRUEntry *e) {
+  if (shard->policy == TAOS_LRU_POLICY_TINYLFU) {
+    taosLRUCacheShardTinyLFUInsert(shard, e);
+    return;
+  }
+
   if (shard->highPriPoolRatio > 0 && (TAOS_LRU_ENTRY_IS_HIGH_PRI(e) || TAOS_LRU_ENTRY_HAS_HIT(e))) {
     e->next = &shard->lru;
     e->prev = shard->lru.prev;
@@ -288,6 +509,11 @@ static void taosLRUCacheShardLRUInsert(SLRUCacheShard *shard, SLRUEntry *e) {
 }
 
 static void taosLRUCacheShardLRURemove(SLRUCacheShard *shard, SLRUEntry *e) {
+  if (shard->policy == TAOS_LRU_POLICY_TINYLFU) {
+    taosLRUCacheShardTinyLFURemove(shard, e);
+    return;
+  }
+
   if (shard->lruLowPri == e) {
     shard->lruLowPri = e->prev;
   }
@@ -302,8 +528,9 @@ static void taosLRUCacheShardLRURemove(SLRUCacheShard *shard, SLRUEntry *e) {
 }
 
 static void taosLRUCacheShardEvictLRU(SLRUCacheShard *shard, size_t charge, SArray *deleted) {
-  while (shard->usage + charge > shard->capacity && shard->lru.next != &shard->lru) {
-    SLRUEntry *old = shard->lru.next;
+  while (shard->usage + charge > shard->capacity && !taosLRUCacheShardLRUEmpty(shard)) {
+    SLRUEntry *old =
+        shard->policy == TAOS_LRU_POLICY_TINYLFU ? taosLRUCacheShardTinyLFUVictim(shard, charge) : shard->lru.next;
 
     taosLRUCacheShardLRURemove(shard, old);
     SLRUEntry *tentry = taosLRUEntryTableRemove(&shard->table, old->keyData, old->keyLength, old->hash);
@@ -326,6 +553,7 @@ static void taosLRUCacheShardSetCapacity(SLRUCacheShard *shard, size_t capacity)
 
   shard->capacity = capacity;
   shard->highPriPoolCapacity = capacity * shard->highPriPoolRatio;
+  taosLRUCacheShardSetTinyLFUCapacity(shard);
   taosLRUCacheShardEvictLRU(shard, 0, lastReferenceList);
 
   (void)taosThreadMutexUnlock(&shard->mutex);
@@ -338,8 +566,15 @@ static void taosLRUCacheShardSetCapacity(SLRUCacheShard *shard, size_t capacity)
 }
 
 static int taosLRUCacheShardInit(SLRUCacheShard *shard, size_t capacity, bool strict, double highPriPoolRatio,
-                                 int maxUpperHashBits) {
-  TAOS_CHECK_RETURN(taosLRUEntryTableInit(&shard->table, maxUpperHashBits));
+                                 int maxUpperHashBits, LRUPolicy policy) {
+  if (policy == TAOS_LRU_POLICY_TINYLFU) {
+    TAOS_CHECK_RETURN(taosLRUSketchInit(&shard->sketch, TAOS_LRU_SKETCH_MIN_BITS));
+  }
+  int32_t code = taosLRUEntryTableInit(&shard->table, maxUpperHashBits);
+  if (code) {
+    taosLRUSketchCleanup(&shard->sketch);
+    TAOS_RETURN(code);
+  }
 
   (void)taosThreadMutexInit(&shard->mutex, NULL);
 
@@ -356,6 +591,15 @@ static int taosLRUCacheShardInit(SLRUCacheShard *shard, size_t capacity, bool st
   shard->lru.next = &shard->lru;
   shard->lru.prev = &shard->lru;
   shard->lruLowPri = &shard->lru;
+
+  shard->policy = policy;
+  shard->window.next = shard->window.prev = &shard->window;
+  shard->probation.next = shard->probation.prev = &shard->probation;
+  shard->protect.next = shard->protect.prev = &shard->protect;
+  shard->windowUsage = 0;
+  shard->protectUsage = 0;
+  shard->hits = 0;
+  shard->misses = 0;
   (void)taosThreadMutexUnlock(&shard->mutex);
 
   taosLRUCacheShardSetCapacity(shard, capacity);
@@ -367,6 +611,7 @@ static void taosLRUCacheShardCleanup(SLRUCacheShard *shard) {
   (void)taosThreadMutexDestroy(&shard->mutex);
 
   taosLRUEntryTableCleanup(&shard->table);
+  taosLRUSketchCleanup(&shard->sketch);
 }
 
 static LRUStatus taosLRUCacheShardInsertEntry(SLRUCacheShard *shard, SLRUEntry *e, LRUHandle **handle,
@@ -384,7 +629,7 @@ static LRUStatus taosLRUCacheShardInsertEntry(SLRUCacheShard *shard, SLRUEntry *
 
   (void)taosThreadMutexLock(&shard->mutex);
 
-  if (shard->usage + e->totalCharge > shard->capacity && shard->lru.next != &shard->lru) {
+  if (shard->usage + e->totalCharge > shard->capacity && !taosLRUCacheShardLRUEmpty(shard)) {
     if (!lastReferenceList) {
       lastReferenceList = taosArrayInit(16, POINTER_BYTES);
       if (!lastReferenceList) {
@@ -412,6 +657,13 @@ static LRUStatus taosLRUCacheShardInsertEntry(SLRUCacheShard *shard, SLRUEntry *
   } else {
     SLRUEntry *old = taosLRUEntryTableInsert(&shard->table, e);
     shard->usage += e->totalCharge;
+    if (shard->policy == TAOS_LRU_POLICY_TINYLFU) {
+      taosLRUSketchIncrement(&shard->sketch, e->hash);
+      // keep the sketch wide enough for the number of entries, the counters restart from zero
+      if (shard->table.elems > (1u << shard->sketch.widthBits) && shard->sketch.widthBits < TAOS_LRU_SKETCH_MAX_BITS) {
+        (void)taosLRUSketchInit(&shard->sketch, shard->sketch.widthBits + 1);
+      }
+    }
     if (old != NULL) {
       status = TAOS_LRU_STATUS_OK_OVERWRITTEN;
 
@@ -497,6 +749,12 @@ static LRUHandle *taosLRUCacheShardLookup(SLRUCacheShard *shard, const void *key
     }
     TAOS_LRU_ENTRY_REF(e);
     TAOS_LRU_ENTRY_SET_HIT(e);
+    ++shard->hits;
+  } else {
+    ++shard->misses;
+  }
+  if (shard->policy == TAOS_LRU_POLICY_TINYLFU) {
+    taosLRUSketchIncrement(&shard->sketch, hash);
   }
 
   (void)taosThreadMutexUnlock(&shard->mutex);
@@ -543,8 +801,9 @@ static void taosLRUCacheShardEraseUnrefEntries(SLRUCacheShard *shard) {
 
   (void)taosThreadMutexLock(&shard->mutex);
 
-  while (shard->lru.next != &shard->lru) {
-    SLRUEntry *old = shard->lru.next;
+  while (!taosLRUCacheShardLRUEmpty(shard)) {
+    SLRUEntry *old =
+        shard->policy == TAOS_LRU_POLICY_TINYLFU ? taosLRUCacheShardTinyLFUVictim(shard, 0) : shard->lru.next;
     taosLRUCacheShardLRURemove(shard, old);
     SLRUEntry *tentry = taosLRUEntryTableRemove(&shard->table, old->keyData, old->keyLength, old->hash);
     TAOS_LRU_ENTRY_SET_IN_CACHE(old, false);
@@ -645,6 +904,15 @@ static size_t taosLRUCacheShardGetPinnedUsage(SLRUCacheShard *shard) {
   return usage;
 }
 
+static void taosLRUCacheShardGetStat(SLRUCacheShard *shard, SLRUCacheStat *pStat) {
+  (void)taosThreadMutexLock(&shard->mutex);
+
+  pStat->hits += shard->hits;
+  pStat->misses += shard->misses;
+
+  (void)taosThreadMutexUnlock(&shard->mutex);
+}
+
 static void taosLRUCacheShardSetStrictCapacity(SLRUCacheShard *shard, bool strict) {
   (void)taosThreadMutexLock(&shard->mutex);
 
@@ -681,6 +949,10 @@ static int getDefaultCacheShardBits(size_t capacity) {
 }
 
 SLRUCache *taosLRUCacheInit(size_t capacity, int numShardBits, double highPriPoolRatio) {
+  return taosLRUCacheInitWithPolicy(capacity, numShardBits, highPriPoolRatio, TAOS_LRU_POLICY_LRU);
+}
+
+SLRUCache *taosLRUCacheInitWithPolicy(size_t capacity, int numShardBits, double highPriPoolRatio, LRUPolicy policy) {
   if (numShardBits >= 20) {
     return NULL;
   }
@@ -707,7 +979,12 @@ SLRUCache *taosLRUCacheInit(size_t capacity, int numShardBits, double highPriPoo
   size_t perShard = (capacity + (numShards - 1)) / numShards;
   for (int i = 0; i < numShards; ++i) {
     if (TSDB_CODE_SUCCESS !=
-        taosLRUCacheShardInit(&cache->shards[i], perShard, strictCapacity, highPriPoolRatio, 32 - numShardBits)) {
+        taosLRUCacheShardInit(&cache->shards[i], perShard, strictCapacity, highPriPoolRatio, 32 - numShardBits,
+                              policy)) {
+      // the shards initialized so far own their tables, sketches and mutexes
+      for (int j = i - 1; j >= 0; --j) {
+        taosLRUCacheShardCleanup(&cache->shards[j]);
+      }
       taosMemoryFree(cache->shards);
       taosMemoryFree(cache);
       return NULL;
@@ -829,6 +1106,24 @@ int32_t taosLRUCacheGetElems(SLRUCache *cache) {
   return elems;
 }
 
+int32_t taosLRUCacheGetNumShards(SLRUCache *cache) { return cache->numShards; }
+
+void taosLRUCacheGetShardStat(SLRUCache *cache, int32_t shardIdx, SLRUCacheStat *pStat) {
+  pStat->hits = 0;
+  pStat->misses = 0;
+  if (shardIdx >= 0 && shardIdx < cache->numShards) {
+    taosLRUCacheShardGetStat(&cache->shards[shardIdx], pStat);
+  }
+}
+
+void taosLRUCacheGetStat(SLRUCache *cache, SLRUCacheStat *pStat) {
+  pStat->hits = 0;
+  pStat->misses = 0;
+  for (int i = 0; i < cache->numShards; ++i) {
+    taosLRUCacheShardGetStat(&cache->shards[i], pStat);
+  }
+}
+
 size_t taosLRUCacheGetPinnedUsage(SLRUCache *cache) {
   size_t usage = 0;
 
@@ -15,6 +15,7 @@
 
 #define _DEFAULT_SOURCE
 #include "taoserror.h"
+#include "tlockfree.h"
 #include "tlog.h"
 #include "tqueue.h"
 #include "tutil.h"
@@ -24,9 +25,20 @@ int64_t tsQueueMemoryUsed = 0;
 
 int64_t tsApplyMemoryAllowed = 0;
 int64_t tsApplyMemoryUsed = 0;
+/*
+ * Items are kept in an intrusive multi-producer/single-consumer linked list. Producers only swing 'tail'
+ * with an atomic exchange and then link the previous tail to the new node, so taosWriteQitem never takes
+ * a lock. 'stub' is a permanent dummy node, stub->next is the oldest item and tail == stub means empty.
+ * Readers are serialized by 'mutex', which writers never touch. Item and memory counters are atomics,
+ * writers reserve per item while readers subtract a whole drained batch at once.
+ *
+ * Whoever updates the item counter of the queue set of a queue holds 'qsetLatch' shared, joining or leaving a queue
+ * set holds it exclusively. So a queue set never gets a count or a post from a queue that already left it, and its
+ * counter always equals the sum of the counters of its queues.
+ */
 struct STaosQueue {
-  STaosQnode   *head;
   STaosQnode   *tail;
+  STaosQnode   *stub;
   STaosQueue   *next;     // for queue set
   STaosQset    *qset;     // for queue set
   void         *ahandle;  // for queue set
@@ -37,6 +49,7 @@ struct STaosQueue {
   int64_t       threadId;
   int64_t       memLimit;
   int64_t       itemLimit;
+  SRWLatch      qsetLatch;
   TdThreadMutex mutex;
 };
 
@@ -61,11 +74,78 @@ struct STaosQall {
 void taosSetQueueMemoryCapacity(STaosQueue *queue, int64_t cap) { queue->memLimit = cap; }
 void taosSetQueueCapacity(STaosQueue *queue, int64_t size) { queue->itemLimit = size; }
 
+// Wait for a producer which has already swung the tail past pNode but not yet linked pNode->next.
+static STaosQnode *taosQueueWaitNext(STaosQnode *pNode) {
+  STaosQnode *next = atomic_load_ptr(&pNode->next);
+  while (next == NULL) {
+    (void)sched_yield();
+    next = atomic_load_ptr(&pNode->next);
+  }
+  return next;
+}
+
+static void taosQueuePush(STaosQueue *queue, STaosQnode *pNode) {
+  pNode->next = NULL;
+  STaosQnode *prev = atomic_exchange_ptr(&queue->tail, pNode);
+  atomic_store_ptr(&prev->next, pNode);
+}
+
+static FORCE_INLINE bool taosQueueHasItem(STaosQueue *queue) { return atomic_load_ptr(&queue->tail) != queue->stub; }
+
+// Unlink the oldest node, must be called with queue->mutex held.
+static STaosQnode *taosQueuePop(STaosQueue *queue) {
+  STaosQnode *stub = queue->stub;
+  STaosQnode *pNode = atomic_load_ptr(&stub->next);
+  if (pNode == NULL) {
+    if (!taosQueueHasItem(queue)) return NULL;
+    pNode = taosQueueWaitNext(stub);
+  }
+
+  STaosQnode *next = atomic_load_ptr(&pNode->next);
+  if (next == NULL) {
+    // pNode looks like the last one, try to hand the tail back to the stub
+    atomic_store_ptr(&stub->next, NULL);
+    if (atomic_val_compare_exchange_ptr(&queue->tail, pNode, stub) == pNode) {
+      return pNode;
+    }
+    next = taosQueueWaitNext(pNode);
+  }
+
+  atomic_store_ptr(&stub->next, next);
+  return pNode;
+}
+
+// Unlink all nodes as a NULL terminated chain, must be called with queue->mutex held.
+static STaosQnode *taosQueuePopAll(STaosQueue *queue, int32_t *numOfItems, int64_t *memOfItems) {
+  STaosQnode *stub = queue->stub;
+
+  *numOfItems = 0;
+  *memOfItems = 0;
+  if (!taosQueueHasItem(queue)) return NULL;
+
+  // stub->next must be taken before the tail returns to the stub, after that new producers link to it again
+  STaosQnode *first = taosQueueWaitNext(stub);
+  atomic_store_ptr(&stub->next, NULL);
+  STaosQnode *last = atomic_exchange_ptr(&queue->tail, stub);
+
+  STaosQnode *pNode = first;
+  while (1) {
+    (*numOfItems)++;
+    (*memOfItems) += (pNode->size + pNode->dataSize);
+    if (pNode == last) break;
+    pNode = taosQueueWaitNext(pNode);
+  }
+
+  return first;
+}
+
 int32_t taosOpenQueue(STaosQueue **queue) {
-  *queue = taosMemoryCalloc(1, sizeof(STaosQueue));
+  *queue = taosMemoryCalloc(1, sizeof(STaosQueue) + sizeof(STaosQnode));
   if (*queue == NULL) {
     return terrno;
   }
+  (*queue)->stub = (STaosQnode *)((char *)(*queue) + sizeof(STaosQueue));
+  (*queue)->tail = (*queue)->stub;
 
   int32_t code = taosThreadMutexInit(&(*queue)->mutex, NULL);
   if (code) {
@@ -87,10 +167,11 @@ void taosCloseQueue(STaosQueue *queue) {
   if (queue == NULL) return;
   STaosQnode *pTemp;
   STaosQset  *qset;
+  int32_t     numOfItems = 0;
+  int64_t     memOfItems = 0;
 
   (void)taosThreadMutexLock(&queue->mutex);
-  STaosQnode *pNode = queue->head;
-  queue->head = NULL;
+  STaosQnode *pNode = taosQueuePopAll(queue, &numOfItems, &memOfItems);
   qset = queue->qset;
   (void)taosThreadMutexUnlock(&queue->mutex);
 
@@ -113,40 +194,25 @@ void taosCloseQueue(STaosQueue *queue) {
 bool taosQueueEmpty(STaosQueue *queue) {
   if (queue == NULL) return true;
 
-  bool empty = false;
-  (void)taosThreadMutexLock(&queue->mutex);
-  if (queue->head == NULL && queue->tail == NULL && queue->numOfItems == 0 /*&& queue->memOfItems == 0*/) {
-    empty = true;
-  }
-  (void)taosThreadMutexUnlock(&queue->mutex);
-
-  return empty;
+  return !taosQueueHasItem(queue) && atomic_load_32(&queue->numOfItems) == 0 /*&& queue->memOfItems == 0*/;
 }
 
 void taosUpdateItemSize(STaosQueue *queue, int32_t items) {
   if (queue == NULL) return;
 
-  (void)taosThreadMutexLock(&queue->mutex);
-  queue->numOfItems -= items;
-  (void)taosThreadMutexUnlock(&queue->mutex);
+  (void)atomic_sub_fetch_32(&queue->numOfItems, items);
 }
 
 int32_t taosQueueItemSize(STaosQueue *queue) {
   if (queue == NULL) return 0;
 
-  (void)taosThreadMutexLock(&queue->mutex);
-  int32_t numOfItems = queue->numOfItems;
-  (void)taosThreadMutexUnlock(&queue->mutex);
-
-  uTrace("queue:%p, numOfItems:%d memOfItems:%" PRId64, queue, queue->numOfItems, queue->memOfItems);
+  int32_t numOfItems = atomic_load_32(&queue->numOfItems);
+  uTrace("queue:%p, numOfItems:%d memOfItems:%" PRId64, queue, numOfItems, atomic_load_64(&queue->memOfItems));
   return numOfItems;
 }
 
 int64_t taosQueueMemorySize(STaosQueue *queue) {
-  (void)taosThreadMutexLock(&queue->mutex);
-  int64_t memOfItems = queue->memOfItems;
-  (void)taosThreadMutexUnlock(&queue->mutex);
-  return memOfItems;
+  return atomic_load_64(&queue->memOfItems);
 }
 
 int32_t taosAllocateQitem(int32_t size, EQItype itype, int64_t dataSize, void **item) {
@@ -205,54 +271,91 @@ void taosFreeQitem(void *pItem) {
   taosMemoryFree(pNode);
 }
 
+static bool taosQueueReserveMem(STaosQueue *queue, int64_t size, int64_t *memOfItems) {
+  int64_t limit = queue->memLimit;
+  if (limit <= 0) {
+    *memOfItems = atomic_add_fetch_64(&queue->memOfItems, size);
+    return true;
+  }
+
+  int64_t old = atomic_load_64(&queue->memOfItems);
+  while (1) {
+    if (old + size > limit) return false;
+    int64_t cur = atomic_val_compare_exchange_64(&queue->memOfItems, old, old + size);
+    if (cur == old) break;
+    old = cur;
+  }
+
+  *memOfItems = old + size;
+  return true;
+}
+
+static bool taosQueueReserveItem(STaosQueue *queue, int32_t *numOfItems) {
+  int64_t limit = queue->itemLimit;
+  if (limit <= 0) {
+    *numOfItems = atomic_add_fetch_32(&queue->numOfItems, 1);
+    return true;
+  }
+
+  int32_t old = atomic_load_32(&queue->numOfItems);
+  while (1) {
+    if (old + 1 > limit) return false;
+    int32_t cur = atomic_val_compare_exchange_32(&queue->numOfItems, old, old + 1);
+    if (cur == old) break;
+    old = cur;
+  }
+
+  *numOfItems = old + 1;
+  return true;
+}
+
 int32_t taosWriteQitem(STaosQueue *queue, void *pItem) {
   int32_t     code = 0;
   STaosQnode *pNode = (STaosQnode *)(((char *)pItem) - sizeof(STaosQnode));
+  int64_t     size = pNode->size + pNode->dataSize;
   pNode->timestamp = taosGetTimestampUs();
   pNode->next = NULL;
 
-  (void)taosThreadMutexLock(&queue->mutex);
-  if (queue->memLimit > 0 && (queue->memOfItems + pNode->size + pNode->dataSize) > queue->memLimit) {
+  // a counter only grows if the item fits under its limit, so concurrent writers near the limit are not rejected
+  // because of a reservation that is given back right after
+  int64_t memOfItems = 0;
+  if (!taosQueueReserveMem(queue, size, &memOfItems)) {
     code = TSDB_CODE_UTIL_QUEUE_OUT_OF_MEMORY;
-    uError("item:%p, failed to put into queue:%p, queue mem limit:%" PRId64 ", reason:%s" PRId64, pItem, queue,
+    uError("item:%p, failed to put into queue:%p, queue mem limit:%" PRId64 ", reason:%s", pItem, queue,
            queue->memLimit, tstrerror(code));
-
-    (void)taosThreadMutexUnlock(&queue->mutex);
     return code;
-  } else if (queue->itemLimit > 0 && queue->numOfItems + 1 > queue->itemLimit) {
+  }
+
+  // the item is counted in the queue and in its queue set at the same time
+  int32_t numOfItems = 0;
+  taosRLockLatch(&queue->qsetLatch);
+  if (!taosQueueReserveItem(queue, &numOfItems)) {
+    taosRUnLockLatch(&queue->qsetLatch);
+    (void)atomic_sub_fetch_64(&queue->memOfItems, size);
     code = TSDB_CODE_UTIL_QUEUE_OUT_OF_MEMORY;
-    uError("item:%p, failed to put into queue:%p, queue size limit:%" PRId64 ", reason:%s" PRId64, pItem, queue,
+    uError("item:%p, failed to put into queue:%p, queue size limit:%" PRId64 ", reason:%s", pItem, queue,
            queue->itemLimit, tstrerror(code));
-    (void)taosThreadMutexUnlock(&queue->mutex);
     return code;
   }
 
-  if (queue->tail) {
-    queue->tail->next = pNode;
-    queue->tail = pNode;
-  } else {
-    queue->head = pNode;
-    queue->tail = pNode;
-  }
-  queue->numOfItems++;
-  queue->memOfItems += (pNode->size + pNode->dataSize);
-  if (queue->qset) {
-    (void)atomic_add_fetch_32(&queue->qset->numOfItems, 1);
+  STaosQset *qset = queue->qset;
+  if (qset) {
+    (void)atomic_add_fetch_32(&qset->numOfItems, 1);
   }
 
-  uTrace("item:%p, is put into queue:%p, items:%d mem:%" PRId64, pItem, queue, queue->numOfItems, queue->memOfItems);
+  taosQueuePush(queue, pNode);
+  uTrace("item:%p, is put into queue:%p, items:%d mem:%" PRId64, pItem, queue, numOfItems, memOfItems);
 
-  (void)taosThreadMutexUnlock(&queue->mutex);
-
-  if (queue->qset) {
-    if (tsem_post(&queue->qset->sem) != 0) {
-      uError("failed to post semaphore for queue set:%p", queue->qset);
+  if (qset) {
+    if (tsem_post(&qset->sem) != 0) {
+      uError("failed to post semaphore for queue set:%p", qset);
     } else {
-      uDebug("sem_post Qset %p, sem:%p", queue->qset, &queue->qset->sem);
+      uDebug("sem_post Qset %p, sem:%p", qset, &qset->sem);
     }
   } else {
     uDebug("empty qset");
   }
+  taosRUnLockLatch(&queue->qsetLatch);
   return code;
 }
 
@@ -260,24 +363,20 @@ void taosReadQitem(STaosQueue *queue, void **ppItem) {
   STaosQnode *pNode = NULL;
 
   (void)taosThreadMutexLock(&queue->mutex);
+  pNode = taosQueuePop(queue);
+  (void)taosThreadMutexUnlock(&queue->mutex);
 
-  if (queue->head) {
-    pNode = queue->head;
+  if (pNode) {
     *ppItem = pNode->item;
-    queue->head = pNode->next;
-    if (queue->head == NULL) {
-      queue->tail = NULL;
-    }
-    queue->numOfItems--;
-    queue->memOfItems -= (pNode->size + pNode->dataSize);
+    int64_t memOfItems = atomic_sub_fetch_64(&queue->memOfItems, pNode->size + pNode->dataSize);
+    taosRLockLatch(&queue->qsetLatch);
+    int32_t numOfItems = atomic_sub_fetch_32(&queue->numOfItems, 1);
     if (queue->qset) {
       (void)atomic_sub_fetch_32(&queue->qset->numOfItems, 1);
     }
-    uTrace("item:%p, is read out from queue:%p, items:%d mem:%" PRId64, *ppItem, queue, queue->numOfItems,
-           queue->memOfItems);
+    taosRUnLockLatch(&queue->qsetLatch);
+    uTrace("item:%p, is read out from queue:%p, items:%d mem:%" PRId64, *ppItem, queue, numOfItems, memOfItems);
   }
-
-  (void)taosThreadMutexUnlock(&queue->mutex);
 }
 
 int32_t taosAllocateQall(STaosQall **qall) {
@@ -291,43 +390,39 @@ int32_t taosAllocateQall(STaosQall **qall) {
 void taosFreeQall(STaosQall *qall) { taosMemoryFree(qall); }
 
 int32_t taosReadAllQitems(STaosQueue *queue, STaosQall *qall) {
-  int32_t numOfItems = 0;
-  bool    empty;
+  int32_t     numOfItems = 0;
+  int64_t     memOfItems = 0;
+  STaosQnode *pNode = NULL;
 
   (void)taosThreadMutexLock(&queue->mutex);
-
-  empty = queue->head == NULL;
-  if (!empty) {
-    memset(qall, 0, sizeof(STaosQall));
-    qall->current = queue->head;
-    qall->start = queue->head;
-    qall->numOfItems = queue->numOfItems;
-    qall->memOfItems = queue->memOfItems;
-
-    qall->unAccessedNumOfItems = queue->numOfItems;
-    qall->unAccessMemOfItems = queue->memOfItems;
-
-    numOfItems = qall->numOfItems;
-
-    queue->head = NULL;
-    queue->tail = NULL;
-    queue->numOfItems = 0;
-    queue->memOfItems = 0;
-    uTrace("read %d items from queue:%p, items:%d mem:%" PRId64, numOfItems, queue, queue->numOfItems,
-           queue->memOfItems);
-    if (queue->qset) {
-      (void)atomic_sub_fetch_32(&queue->qset->numOfItems, qall->numOfItems);
-    }
-  }
-
+  pNode = taosQueuePopAll(queue, &numOfItems, &memOfItems);
   (void)taosThreadMutexUnlock(&queue->mutex);
 
   // if source queue is empty, we set destination qall to empty too.
-  if (empty) {
+  if (pNode == NULL) {
     qall->current = NULL;
     qall->start = NULL;
     qall->numOfItems = 0;
+    return 0;
+  }
+
+  memset(qall, 0, sizeof(STaosQall));
+  qall->current = pNode;
+  qall->start = pNode;
+  qall->numOfItems = numOfItems;
+  qall->memOfItems = memOfItems;
+  qall->unAccessedNumOfItems = numOfItems;
+  qall->unAccessMemOfItems = memOfItems;
+
+  // the whole batch is accounted with a single atomic operation per counter
+  int64_t leftMem = atomic_sub_fetch_64(&queue->memOfItems, memOfItems);
+  taosRLockLatch(&queue->qsetLatch);
+  int32_t leftItems = atomic_sub_fetch_32(&queue->numOfItems, numOfItems);
+  if (queue->qset) {
+    (void)atomic_sub_fetch_32(&queue->qset->numOfItems, numOfItems);
   }
+  taosRUnLockLatch(&queue->qsetLatch);
+  uTrace("read %d items from queue:%p, items:%d mem:%" PRId64, numOfItems, queue, leftItems, leftMem);
   return numOfItems;
 }
 
@@ -412,8 +507,10 @@ int32_t taosAddIntoQset(STaosQset *qset, STaosQueue *queue, void *ahandle) {
   qset->numOfQueues++;
 
   (void)taosThreadMutexLock(&queue->mutex);
-  (void)atomic_add_fetch_32(&qset->numOfItems, queue->numOfItems);
-  queue->qset = qset;
+  taosWLockLatch(&queue->qsetLatch);
+  (void)atomic_add_fetch_32(&qset->numOfItems, atomic_load_32(&queue->numOfItems));
+  atomic_store_ptr(&queue->qset, qset);
+  taosWUnLockLatch(&queue->qsetLatch);
   (void)taosThreadMutexUnlock(&queue->mutex);
 
   (void)taosThreadMutexUnlock(&qset->mutex);
@@ -450,8 +547,10 @@ void taosRemoveFromQset(STaosQset *qset, STaosQueue *queue) {
       qset->numOfQueues--;
 
       (void)taosThreadMutexLock(&queue->mutex);
-      (void)atomic_sub_fetch_32(&qset->numOfItems, queue->numOfItems);
-      queue->qset = NULL;
+      taosWLockLatch(&queue->qsetLatch);
+      (void)atomic_sub_fetch_32(&qset->numOfItems, atomic_load_32(&queue->numOfItems));
+      atomic_store_ptr(&queue->qset, NULL);
+      taosWUnLockLatch(&queue->qsetLatch);
       queue->next = NULL;
       (void)taosThreadMutexUnlock(&queue->mutex);
     }
@@ -463,6 +562,12 @@ void taosRemoveFromQset(STaosQset *qset, STaosQueue *queue) {
 }
 
 int32_t taosReadQitemFromQset(STaosQset *qset, void **ppItem, SQueueInfo *qinfo) {
+  return taosReadQitemsFromQset(qset, ppItem, 1, qinfo);
+}
+
+// Only one semaphore count is taken for the whole batch, the counts of the other items stay posted so that
+// idle readers are woken up and can take over part of the batch from the caller.
+int32_t taosReadQitemsFromQset(STaosQset *qset, void **ppItems, int32_t maxItems, SQueueInfo *qinfo) {
   STaosQnode *pNode = NULL;
   int32_t     code = 0;
 
@@ -479,30 +584,30 @@ int32_t taosReadQitemFromQset(STaosQset *qset, void **ppItem, SQueueInfo *qinfo)
     STaosQueue *queue = qset->current;
     if (queue) qset->current = queue->next;
     if (queue == NULL) break;
-    if (queue->head == NULL) continue;
+    if (!taosQueueHasItem(queue)) continue;
 
+    int64_t memOfItems = 0;
     (void)taosThreadMutexLock(&queue->mutex);
+    while (code < maxItems && (pNode = taosQueuePop(queue)) != NULL) {
+      if (code == 0) {
+        qinfo->ahandle = queue->ahandle;
+        qinfo->fp = queue->itemFp;
+        qinfo->queue = queue;
+        qinfo->timestamp = pNode->timestamp;
+      }
+      ppItems[code++] = pNode->item;
+      memOfItems += (pNode->size + pNode->dataSize);
+    }
+    (void)taosThreadMutexUnlock(&queue->mutex);
 
-    if (queue->head) {
-      pNode = queue->head;
-      *ppItem = pNode->item;
-      qinfo->ahandle = queue->ahandle;
-      qinfo->fp = queue->itemFp;
-      qinfo->queue = queue;
-      qinfo->timestamp = pNode->timestamp;
-
-      queue->head = pNode->next;
-      if (queue->head == NULL) queue->tail = NULL;
+    if (code > 0) {
       // queue->numOfItems--;
-      queue->memOfItems -= (pNode->size + pNode->dataSize);
-      (void)atomic_sub_fetch_32(&qset->numOfItems, 1);
-      code = 1;
-      uTrace("item:%p, is read out from queue:%p, items:%d mem:%" PRId64, *ppItem, queue, queue->numOfItems - 1,
-             queue->memOfItems);
+      memOfItems = atomic_sub_fetch_64(&queue->memOfItems, memOfItems);
+      (void)atomic_sub_fetch_32(&qset->numOfItems, code);
+      uTrace("%d items, first:%p, are read out from queue:%p, items:%d mem:%" PRId64, code, ppItems[0], queue,
+             atomic_load_32(&queue->numOfItems) - code, memOfItems);
+      break;
     }
-
-    (void)taosThreadMutexUnlock(&queue->mutex);
-    if (pNode) break;
   }
 
   (void)taosThreadMutexUnlock(&qset->mutex);
@@ -512,6 +617,7 @@ int32_t taosReadQitemFromQset(STaosQset *qset, void **ppItem, SQueueInfo *qinfo)
 
 int32_t taosReadAllQitemsFromQset(STaosQset *qset, STaosQall *qall, SQueueInfo *qinfo) {
   STaosQueue *queue;
+  STaosQnode *pNode = NULL;
   int32_t     code = 0;
 
   if (tsem_wait(&qset->sem) != 0) {
@@ -524,29 +630,31 @@ int32_t taosReadAllQitemsFromQset(STaosQset *qset, STaosQall *qall, SQueueInfo *
     queue = qset->current;
     if (queue) qset->current = queue->next;
     if (queue == NULL) break;
-    if (queue->head == NULL) continue;
+    if (!taosQueueHasItem(queue)) continue;
 
+    int32_t numOfItems = 0;
+    int64_t memOfItems = 0;
     (void)taosThreadMutexLock(&queue->mutex);
+    pNode = taosQueuePopAll(queue, &numOfItems, &memOfItems);
+    (void)taosThreadMutexUnlock(&queue->mutex);
 
-    if (queue->head) {
-      qall->current = queue->head;
-      qall->start = queue->head;
-      qall->numOfItems = queue->numOfItems;
-      qall->memOfItems = queue->memOfItems;
-      qall->unAccessedNumOfItems = queue->numOfItems;
-      qall->unAccessMemOfItems = queue->memOfItems;
+    if (pNode) {
+      qall->current = pNode;
+      qall->start = pNode;
+      qall->numOfItems = numOfItems;
+      qall->memOfItems = memOfItems;
+      qall->unAccessedNumOfItems = numOfItems;
+      qall->unAccessMemOfItems = memOfItems;
 
       code = qall->numOfItems;
       qinfo->ahandle = queue->ahandle;
       qinfo->fp = queue->itemsFp;
       qinfo->queue = queue;
-      qinfo->timestamp = queue->head->timestamp;
+      qinfo->timestamp = pNode->timestamp;
 
-      queue->head = NULL;
-      queue->tail = NULL;
       // queue->numOfItems = 0;
-      queue->memOfItems = 0;
-      uTrace("read %d items from queue:%p, items:0 mem:%" PRId64, code, queue, queue->memOfItems);
+      int64_t leftMem = atomic_sub_fetch_64(&queue->memOfItems, memOfItems);
+      uTrace("read %d items from queue:%p, items:0 mem:%" PRId64, code, queue, leftMem);
 
       (void)atomic_sub_fetch_32(&qset->numOfItems, qall->numOfItems);
       for (int32_t j = 1; j < qall->numOfItems; ++j) {
@@ -554,11 +662,8 @@ int32_t taosReadAllQitemsFromQset(STaosQset *qset, STaosQall *qall, SQueueInfo *
           uError("failed to wait semaphore for qset:%p", qset);
         }
       }
+      break;
     }
-
-    (void)taosThreadMutexUnlock(&queue->mutex);
-
-    if (code != 0) break;
   }
 
   (void)taosThreadMutexUnlock(&qset->mutex);
@@ -573,6 +678,7 @@ int64_t taosQallUnAccessedMemSize(STaosQall *qall) { return qall->unAccessMemOfI
 
 void    taosResetQitems(STaosQall *qall) { qall->current = qall->start; }
 int32_t taosGetQueueNumber(STaosQset *qset) { return qset->numOfQueues; }
+int32_t taosQsetItemSize(STaosQset *qset) { return atomic_load_32(&qset->numOfItems); }
 
 void taosQueueSetThreadId(STaosQueue *pQueue, int64_t threadId) { pQueue->threadId = threadId; }
 
@@ -588,6 +588,8 @@ static int32_t tQueryAutoQWorkerBeforeBlocking(void *p);
 static int32_t tQueryAutoQWorkerRecoverFromBlocking(void *p);
 static void    tQueryAutoQWorkerWaitingCheck(SQueryAutoQWorkerPool *pPool);
 static bool    tQueryAutoQWorkerTryRecycleWorker(SQueryAutoQWorkerPool *pPool, SQueryAutoQWorker *pWorker);
+static bool    tQueryAutoQWorkerTrySignalWaitingAfterBlock(void *p);
+static bool    tQueryAutoQWorkerTrySignalWaitingBeforeProcess(void *p);
 
 #define GET_ACTIVE_N(int64_val)  (int32_t)((int64_val) >> 32)
 #define GET_RUNNING_N(int64_val) (int32_t)(int64_val & 0xFFFFFFFF)
@@ -658,6 +660,130 @@ static int64_t atomicCompareExchangeActiveAndRunning(int64_t *ptr, int32_t *expe
   }
 }
 
+#define QUERY_AUTOQ_BATCH_SIZE 4  // max msgs taken from one queue by a single read, must not exceed the local deque
+
+static bool tQueryAutoQWorkerPopLocal(SQueryAutoQWorker *pWorker, void **pMsg, SQueueInfo *pInfo) {
+  if (atomic_load_32(&pWorker->localNum) == 0) return false;
+
+  bool ret = false;
+  taosWLockLatch(&pWorker->localLatch);
+  if (pWorker->localNum > 0) {
+    SQueryAutoQLocalMsg *pLocal = &pWorker->localMsgs[pWorker->localHead];
+    *pMsg = pLocal->msg;
+    *pInfo = pLocal->qinfo;
+    pWorker->localHead = (pWorker->localHead + 1) % QUERY_AUTOQ_LOCAL_SIZE;
+    (void)atomic_sub_fetch_32(&pWorker->localNum, 1);
+    ret = true;
+  }
+  taosWUnLockLatch(&pWorker->localLatch);
+  return ret;
+}
+
+static void tQueryAutoQWorkerPushLocal(SQueryAutoQWorker *pWorker, void **msgs, int32_t num, const SQueueInfo *pInfo) {
+  taosWLockLatch(&pWorker->localLatch);
+  for (int32_t i = 0; i < num && pWorker->localNum < QUERY_AUTOQ_LOCAL_SIZE; ++i) {
+    SQueryAutoQLocalMsg *pLocal =
+        &pWorker->localMsgs[(pWorker->localHead + pWorker->localNum) % QUERY_AUTOQ_LOCAL_SIZE];
+    pLocal->msg = msgs[i];
+    pLocal->qinfo = *pInfo;
+    pLocal->qinfo.timestamp = ((STaosQnode *)((char *)msgs[i] - sizeof(STaosQnode)))->timestamp;
+    (void)atomic_add_fetch_32(&pWorker->localNum, 1);
+  }
+  taosWUnLockLatch(&pWorker->localLatch);
+}
+
+// Take the oldest msg from the local deque of any other worker. The pool lock only keeps the workers alive while
+// their deques are looked at, if it is busy the steal is skipped rather than lining idle workers up behind it. The
+// msgs left behind keep their semaphore counts posted, so the worker comes back to them after the queue set read.
+static bool tQueryAutoQWorkerSteal(SQueryAutoQWorkerPool *pPool, SQueryAutoQWorker *pWorker, void **pMsg,
+                                   SQueueInfo *pInfo) {
+  bool ret = false;
+
+  if (taosThreadMutexTryLock(&pPool->poolLock) != 0) {
+    return false;
+  }
+  for (SListNode *pNode = TD_DLIST_HEAD(pPool->workers); pNode != NULL && !ret; pNode = TD_DLIST_NODE_NEXT(pNode)) {
+    SQueryAutoQWorker *pVictim = (SQueryAutoQWorker *)pNode->data;
+    if (pVictim != pWorker) {
+      ret = tQueryAutoQWorkerPopLocal(pVictim, pMsg, pInfo);
+    }
+  }
+  (void)taosThreadMutexUnlock(&pPool->poolLock);
+
+  if (ret) {
+    (void)atomic_add_fetch_64(&pWorker->stealNum, 1);
+  }
+  return ret;
+}
+
+/*
+ * The worker serves its own deque first, then steals from other workers and only then waits on the queue set.
+ * A read from the queue set takes a short run of msgs from one queue, so msgs of the same vnode are processed on
+ * the same core. The semaphore counts of the extra msgs stay posted and wake up idle workers to steal them.
+ */
+static int32_t tQueryAutoQWorkerGetMsg(SQueryAutoQWorkerPool *pPool, SQueryAutoQWorker *pWorker, void **pMsg,
+                                       SQueueInfo *pInfo) {
+  void *msgs[QUERY_AUTOQ_BATCH_SIZE];
+
+  while (1) {
+    if (tQueryAutoQWorkerPopLocal(pWorker, pMsg, pInfo)) return 1;
+    if (tQueryAutoQWorkerSteal(pPool, pWorker, pMsg, pInfo)) return 1;
+
+    // nothing queued, the read blocks until a new msg arrives
+    if (taosQsetItemSize(pPool->qset) == 0) {
+      (void)atomic_add_fetch_64(&pWorker->parkNum, 1);
+    }
+    int32_t num = taosReadQitemsFromQset(pPool->qset, msgs, QUERY_AUTOQ_BATCH_SIZE, pInfo);
+    if (num > 0) {
+      *pMsg = msgs[0];
+      if (num > 1) {
+        tQueryAutoQWorkerPushLocal(pWorker, msgs + 1, num - 1, pInfo);
+      }
+      return 1;
+    }
+
+    // woken up to exit, or for msgs already taken by other workers
+    if (pPool->exit) return 0;
+  }
+}
+
+// msgs left in the local deque of an exiting worker go back to their queues, the queue item counts already cover
+// them, so the count added by the write is given back at once
+static void tQueryAutoQWorkerRequeueLocal(SQueryAutoQWorker *pWorker) {
+  SQueryAutoQWorkerPool *pPool = pWorker->pool;
+  SQueueInfo             qinfo = {0};
+  void                  *msg = NULL;
+
+  while (tQueryAutoQWorkerPopLocal(pWorker, &msg, &qinfo)) {
+    int32_t code = taosWriteQitem(qinfo.queue, msg);
+    if (code == TSDB_CODE_SUCCESS) {
+      taosUpdateItemSize(qinfo.queue, 1);
+      continue;
+    }
+
+    // the queue is full, process it here so that it is replied and freed by its handler
+    uWarn("worker:%s:%d failed to put msg:%p back to queue since %s, process it before exit", pPool->name, pWorker->id,
+          msg, tstrerror(code));
+    if (qinfo.fp != NULL) {
+      qinfo.workerId = pWorker->id;
+      qinfo.threadNum = pPool->num;
+      qinfo.workerCb = pPool->pCb;
+      (*((FItem)qinfo.fp))(&qinfo, msg);
+    }
+    taosUpdateItemSize(qinfo.queue, 1);
+  }
+}
+
+// give up the running slot while msgs are left in the local deque. A waiting worker, if any, is woken up and takes
+// over the running slot, this worker stays active to serve its deque instead of parking in the backup pool.
+static void tQueryAutoQWorkerYieldRunning(SQueryAutoQWorkerPool *pPool) {
+  if (tQueryAutoQWorkerTrySignalWaitingAfterBlock(pPool) || tQueryAutoQWorkerTrySignalWaitingBeforeProcess(pPool)) {
+    (void)atomicFetchAddActive(&pPool->activeRunningN, 1);
+  } else {
+    (void)atomicFetchSubRunning(&pPool->activeRunningN, 1);
+  }
+}
+
 static void *tQueryAutoQWorkerThreadFp(SQueryAutoQWorker *worker) {
   SQueryAutoQWorkerPool *pool = worker->pool;
   SQueueInfo             qinfo = {0};
@@ -674,7 +800,7 @@ static void *tQueryAutoQWorkerThreadFp(SQueryAutoQWorker *worker) {
   uDebug("worker:%s:%d is running, thread:%08" PRId64, pool->name, worker->id, worker->pid);
 
   while (1) {
-    if (taosReadQitemFromQset(pool->qset, (void **)&msg, &qinfo) == 0) {
+    if (tQueryAutoQWorkerGetMsg(pool, worker, (void **)&msg, &qinfo) == 0) {
       uInfo("worker:%s:%d qset:%p, got no message and exiting, thread:%08" PRId64, pool->name, worker->id, pool->qset,
             worker->pid);
       break;
@@ -700,14 +826,19 @@ static void *tQueryAutoQWorkerThreadFp(SQueryAutoQWorker *worker) {
       qinfo.workerCb = pool->pCb;
       (*((FItem)qinfo.fp))(&qinfo, msg);
     }
+    (void)atomic_add_fetch_64(&worker->runNum, 1);
 
     taosUpdateItemSize(qinfo.queue, 1);
-    if (!tQueryAutoQWorkerTryRecycleWorker(pool, worker)) {
+    if (atomic_load_32(&worker->localNum) > 0) {
+      // not recycled until the local deque is drained
+      tQueryAutoQWorkerYieldRunning(pool);
+    } else if (!tQueryAutoQWorkerTryRecycleWorker(pool, worker)) {
       uDebug("worker:%s:%d exited", pool->name, worker->id);
       break;
     }
   }
 
+  tQueryAutoQWorkerRequeueLocal(worker);
   DestoryThreadLocalRegComp();
 
   return NULL;
@@ -815,6 +946,7 @@ bool tQueryAutoQWorkerTryRecycleWorker(SQueryAutoQWorkerPool *pPool, SQueryAutoQ
     (void)taosThreadMutexUnlock(&pPool->poolLock);
 
     // start to wait at backup cond
+    (void)atomic_add_fetch_64(&pWorker->parkNum, 1);
     (void)taosThreadMutexLock(&pPool->backupLock);
     (void)atomic_fetch_add_32(&pPool->backupNum, 1);
     if (!pPool->exit) (void)taosThreadCondWait(&pPool->backupCond, &pPool->backupLock);
@@ -1035,6 +1167,30 @@ STaosQueue *tQueryAutoQWorkerAllocQueue(SQueryAutoQWorkerPool *pool, void *ahand
 
 void tQueryAutoQWorkerFreeQueue(SQueryAutoQWorkerPool *pPool, STaosQueue *pQ) { taosCloseQueue(pQ); }
 
+int32_t tQueryAutoQWorkerGetStat(SQueryAutoQWorkerPool *pPool, SArray *pStats) {
+  int32_t code = 0;
+
+  (void)taosThreadMutexLock(&pPool->poolLock);
+  SList *lists[] = {pPool->workers, pPool->backupWorkers};
+  for (int32_t i = 0; i < tListLen(lists) && code == 0; ++i) {
+    if (lists[i] == NULL) continue;
+    for (SListNode *pNode = TD_DLIST_HEAD(lists[i]); pNode != NULL; pNode = TD_DLIST_NODE_NEXT(pNode)) {
+      SQueryAutoQWorker    *pWorker = (SQueryAutoQWorker *)pNode->data;
+      SQueryAutoQWorkerStat stat = {.id = pWorker->id,
+                                    .runNum = atomic_load_64(&pWorker->runNum),
+                                    .stealNum = atomic_load_64(&pWorker->stealNum),
+                                    .parkNum = atomic_load_64(&pWorker->parkNum)};
+      if (taosArrayPush(pStats, &stat) == NULL) {
+        code = terrno;
+        break;
+      }
+    }
+  }
+  (void)taosThreadMutexUnlock(&pPool->poolLock);
+
+  return code;
+}
+
 static int32_t tQueryAutoQWorkerAddWorker(SQueryAutoQWorkerPool *pool) {
   // try backup pool
   int32_t backup = pool->backupNum;
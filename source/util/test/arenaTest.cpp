@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "os.h"
+#include "tarena.h"
+
+TEST(arenaTest, allocTest) {
+  SArena *pArena = NULL;
+  ASSERT_EQ(taosArenaCreate(1024, &pArena), 0);
+  ASSERT_EQ(taosArenaGetMemSize(pArena), 0);
+
+  char *pPrev = NULL;
+  for (int32_t i = 0; i < 1000; ++i) {
+    char *p = (char *)taosArenaMalloc(pArena, i % 13 + 1);
+    ASSERT_NE(p, nullptr);
+    ASSERT_EQ((uintptr_t)p % 8, 0);
+    memset(p, i, i % 13 + 1);
+    if (pPrev != NULL) {
+      ASSERT_EQ(pPrev[0], (char)(i - 1));
+    }
+    pPrev = p;
+  }
+
+  // a large request gets a chunk of its own
+  char *pLarge = (char *)taosArenaCalloc(pArena, 10, 1000);
+  ASSERT_NE(pLarge, nullptr);
+  for (int32_t i = 0; i < 10000; ++i) {
+    ASSERT_EQ(pLarge[i], 0);
+  }
+
+  int64_t allocSize = taosArenaGetAllocSize(pArena);
+  ASSERT_GT(taosArenaGetMemSize(pArena), 10000);
+  ASSERT_GE(taosArenaGetMemSize(pArena), allocSize);
+
+  // the kept chunk grows to hold the whole batch
+  taosArenaReset(pArena);
+  ASSERT_EQ(taosArenaGetAllocSize(pArena), 0);
+  ASSERT_GE(taosArenaGetMemSize(pArena), allocSize);
+
+  int64_t memSize = taosArenaGetMemSize(pArena);
+  for (int32_t i = 0; i < 1000; ++i) {
+    ASSERT_NE(taosArenaMalloc(pArena, i % 13 + 1), nullptr);
+  }
+  ASSERT_NE(taosArenaMalloc(pArena, 10000), nullptr);
+  ASSERT_EQ(taosArenaGetMemSize(pArena), memSize);
+
+  taosArenaDestroy(pArena);
+}
+
+TEST(arenaTest, scratchTest) {
+  // no thread arena, from the heap
+  ASSERT_EQ(taosArenaGetThreadArena(), nullptr);
+  char *p = (char *)taosArenaScratchCalloc(10, 10);
+  ASSERT_NE(p, nullptr);
+  ASSERT_EQ(p[99], 0);
+  taosArenaScratchFree(p);
+  taosArenaScratchFree(NULL);
+
+  SArena *pArena = NULL;
+  ASSERT_EQ(taosArenaCreate(TAOS_ARENA_DEFAULT_CHUNK_SIZE, &pArena), 0);
+  ASSERT_EQ(taosArenaSetThreadArena(pArena), nullptr);
+  ASSERT_EQ(taosArenaGetThreadArena(), pArena);
+
+  // the latest scratch buffer is given back when freed
+  char *pBitmap = (char *)taosArenaScratchCalloc(1, 100);
+  ASSERT_NE(pBitmap, nullptr);
+  int64_t allocSize = taosArenaGetAllocSize(pArena);
+  for (int32_t i = 0; i < 100000; ++i) {
+    char *p2 = (char *)taosArenaScratchMalloc(i % 100 + 1);
+    ASSERT_NE(p2, nullptr);
+    memset(p2, 1, i % 100 + 1);
+    taosArenaScratchFree(p2);
+  }
+  ASSERT_EQ(taosArenaGetAllocSize(pArena), allocSize);
+  ASSERT_EQ(taosArenaGetMemSize(pArena), TAOS_ARENA_DEFAULT_CHUNK_SIZE);
+
+  // out of order frees are released by the reset
+  char *p1 = (char *)taosArenaScratchMalloc(16);
+  char *p2 = (char *)taosArenaScratchMalloc(16);
+  taosArenaScratchFree(p1);
+  taosArenaScratchFree(p2);
+  taosArenaScratchFree(pBitmap);
+  ASSERT_GT(taosArenaGetAllocSize(pArena), 0);
+
+  taosArenaReset(pArena);
+  ASSERT_EQ(taosArenaGetAllocSize(pArena), 0);
+
+  ASSERT_EQ(taosArenaSetThreadArena(NULL), pArena);
+  taosArenaDestroy(pArena);
+}
@@ -157,4 +157,65 @@ TEST(TD_UTIL_BLOOMFILTER_TEST, scalable_bloomFilter) {
 
   tScalableBfDestroy(pSBF1);
   tScalableBfDestroy(pSBF4);
-}
\ No newline at end of file
+}
+TEST(TD_UTIL_BLOOMFILTER_TEST, block_bloomFilter) {
+  int64_t ts1 = 1650803518000;
+
+  SBlockBloomFilter* pBFTmp = NULL;
+  GTEST_ASSERT_NE(0, tBlockBloomFilterInit(100, 0, &pBFTmp));
+  GTEST_ASSERT_NE(0, tBlockBloomFilterInit(100, 1, &pBFTmp));
+  GTEST_ASSERT_NE(0, tBlockBloomFilterInit(0, 0.01, &pBFTmp));
+
+  int64_t            size = 10000;
+  SBlockBloomFilter* pBF = NULL;
+  GTEST_ASSERT_EQ(0, tBlockBloomFilterInit(size, 0.01, &pBF));
+  for (int64_t i = 0; i < size; i++) {
+    int64_t ts = i + ts1;
+    tBlockBloomFilterPut(pBF, &ts, sizeof(int64_t));
+  }
+  GTEST_ASSERT_EQ(pBF->size, size);
+
+  // the simd and the scalar probes agree
+  char simdEnable = tsSIMDEnable;
+  for (int32_t round = 0; round < 2; round++) {
+    tsSIMDEnable = round == 0 ? simdEnable : 0;
+
+    int64_t falsePositive = 0;
+    for (int64_t i = 0; i < size; i++) {
+      int64_t ts = i + ts1;
+      GTEST_ASSERT_FALSE(tBlockBloomFilterNoContain(pBF, &ts, sizeof(int64_t)));
+
+      ts = i + ts1 + size;
+      if (!tBlockBloomFilterNoContain(pBF, &ts, sizeof(int64_t))) {
+        falsePositive++;
+      }
+    }
+    GTEST_ASSERT_LT(falsePositive, size * 2 / 100);
+  }
+  tsSIMDEnable = simdEnable;
+
+  SEncoder encoder = {0};
+  tEncoderInit(&encoder, NULL, 0);
+  GTEST_ASSERT_EQ(0, tBlockBloomFilterEncode(pBF, &encoder));
+  int32_t len = encoder.pos;
+  tEncoderClear(&encoder);
+
+  uint8_t* buf = (uint8_t*)taosMemoryMalloc(len);
+  tEncoderInit(&encoder, buf, len);
+  GTEST_ASSERT_EQ(0, tBlockBloomFilterEncode(pBF, &encoder));
+  tEncoderClear(&encoder);
+
+  SDecoder           decoder = {0};
+  SBlockBloomFilter* pBF1 = NULL;
+  tDecoderInit(&decoder, buf, len);
+  GTEST_ASSERT_EQ(0, tBlockBloomFilterDecode(&decoder, &pBF1));
+  tDecoderClear(&decoder);
+
+  GTEST_ASSERT_EQ(pBF1->numBlocks, pBF->numBlocks);
+  GTEST_ASSERT_EQ(pBF1->size, pBF->size);
+  GTEST_ASSERT_EQ(0, memcmp(pBF1->blocks, pBF->blocks, pBF->numBlocks * BLOCK_BF_BYTES));
+
+  taosMemoryFree(buf);
+  tBlockBloomFilterDestroy(pBF);
+  tBlockBloomFilterDestroy(pBF1);
+}
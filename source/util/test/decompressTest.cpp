@@ -514,6 +514,11 @@ struct DataTypeSupportAvx<double> {
   static const bool value = true;
 };
 
+template <>
+struct DataTypeSupportAvx<int64_t> {
+  static const bool value = true;
+};
+
 template <typename T, typename CompF, typename DecompF>
 static void decompressBasicTest(size_t dataSize, const CompF& compress, const DecompF& decompress, T min, T max) {
   auto              origData = utilTestRandomData(dataSize, min, max);
@@ -638,6 +643,70 @@ TEST(utilTest, decompressDoubleBasic) {
 TEST(utilTest, decompressDoublePerf) { RUN_PERF_TEST(double, tsCompressDouble, tsDecompressDouble, 0, 9999999999); }
 
 
+// bool columns are usually status flags: long runs of the same value with a few nulls in between
+static std::vector<int8_t> utilTestBoolData(int32_t n, int32_t runLen, int32_t nullPercent) {
+  std::mt19937        gen(decompressRandomSeed);
+  std::vector<int8_t> data(n);
+  int8_t              val = 0;
+  for (int32_t i = 0; i < n; ++i) {
+    if (runLen <= 1 || gen() % runLen == 0) val = gen() & 0x1;
+    data[i] = (gen() % 100 < nullPercent) ? TSDB_DATA_BOOL_NULL : val;
+  }
+  return data;
+}
+
+static void decompressBoolTest(const char* shape, int32_t n, int32_t runLen, int32_t nullPercent, int32_t nround) {
+  auto              origData = utilTestBoolData(n, runLen, nullPercent);
+  std::vector<char> compData(origData.size() + 1);
+  int32_t cnt = tsCompressBool(origData.data(), origData.size(), origData.size(), compData.data(), compData.size(),
+                               ONE_STAGE_COMP, nullptr, 0);
+  ASSERT_LE(cnt, compData.size());
+  decltype(origData) decompData(origData.size());
+
+  tsAVX2Supported = 0;
+  auto ms = measureRunTime(
+      [&]() {
+        tsDecompressBool(compData.data(), cnt, decompData.size(), decompData.data(), decompData.size(),
+                         ONE_STAGE_COMP, nullptr, 0);
+      },
+      nround);
+  EXPECT_EQ(origData, decompData);
+  if (nround > 1) {
+    std::cout << "Decompression of " << nround * n << " bool (" << shape << ") without SIMD costs " << ms
+              << " ms, avg speed: " << nround * n * 1000.0 / ms << " tuples/s\n";
+  }
+
+  taosGetSystemInfo();
+  if (tsAVX2Supported) {
+    std::fill(decompData.begin(), decompData.end(), 0);
+    ms = measureRunTime(
+        [&]() {
+          tsDecompressBool(compData.data(), cnt, decompData.size(), decompData.data(), decompData.size(),
+                           ONE_STAGE_COMP, nullptr, 0);
+        },
+        nround);
+    EXPECT_EQ(origData, decompData);
+    if (nround > 1) {
+      std::cout << "Decompression of " << nround * n << " bool (" << shape << ") using AVX2 costs " << ms
+                << " ms, avg speed: " << nround * n * 1000.0 / ms << " tuples/s\n";
+    }
+  }
+}
+
+TEST(utilTest, decompressBoolBasic) {
+  refreshSeed();
+  for (int32_t r = 1; r <= 4096; ++r) {
+    decompressBoolTest("random", r, 1, 10, 1);
+  }
+}
+
+TEST(utilTest, decompressBoolPerf) {
+  refreshSeed();
+  decompressBoolTest("random", 4096, 1, 0, 100000);
+  decompressBoolTest("runs of 1000", 4096, 1000, 0, 100000);
+  decompressBoolTest("runs of 100 with 5% null", 4096, 100, 5, 100000);
+}
+
 TEST(utilTest, decompressTimestampBasic) {
   refreshSeed();
   for (int32_t r = 1; r <= 4096; ++r) {
@@ -649,3 +718,73 @@ TEST(utilTest, decompressTimestampPerf) {
   refreshSeed();
   decompressPerfTest<int64_t>("timestamp", tsCompressTimestamp, tsDecompressTimestamp, 0, 1000000000L);
 }
+
+template <typename T, typename CompF>
+static void compressSimdBasicTest(size_t dataSize, const CompF& compress, T min, T max) {
+  auto              origData = utilTestRandomData(dataSize, min, max);
+  std::vector<char> scalarData(origData.size() * sizeof(origData[0]) + 1);
+  std::vector<char> simdData(scalarData.size());
+
+  // the encoders with SIMD instructions must produce exactly the same bytes
+  tsAVX2Supported = 0;
+  tsAVX512Supported = 0;
+  int32_t cnt = compress(origData.data(), origData.size(), origData.size(), scalarData.data(), scalarData.size(),
+                         ONE_STAGE_COMP, nullptr, 0);
+  ASSERT_LE(cnt, scalarData.size());
+
+  taosGetSystemInfo();
+  if (!tsAVX2Supported) return;
+  int32_t simdCnt = compress(origData.data(), origData.size(), origData.size(), simdData.data(), simdData.size(),
+                             ONE_STAGE_COMP, nullptr, 0);
+  ASSERT_EQ(cnt, simdCnt);
+  EXPECT_EQ(0, memcmp(scalarData.data(), simdData.data(), cnt));
+}
+
+TEST(utilTest, compressSimdBasic) {
+  refreshSeed();
+  for (int32_t r = 1; r <= 1024; ++r) {
+    compressSimdBasicTest<int8_t>(r, tsCompressTinyint, 0, 100);
+    compressSimdBasicTest<int16_t>(r, tsCompressSmallint, 0, 10000);
+    compressSimdBasicTest<int32_t>(r, tsCompressInt, 0, 1000000);
+    compressSimdBasicTest<int64_t>(r, tsCompressBigint, 0, 1000000000L);
+    compressSimdBasicTest<int64_t>(r, tsCompressBigint, INT64_MIN, INT64_MAX);
+    compressSimdBasicTest<float>(r, tsCompressFloat, 0, 99999);
+    compressSimdBasicTest<double>(r, tsCompressDouble, 0, 9999999999);
+    compressSimdBasicTest<int64_t>(r, tsCompressTimestamp, 0, 1000000000L);
+    compressSimdBasicTest<int64_t>(r, tsCompressTimestamp, -1000, 1000);
+  }
+}
+
+TEST(utilTest, compressL2Select) {
+  const int32_t     n = 4096;
+  std::vector<char> buf(n + COMP_OVERFLOW_BYTES);
+  uint8_t           l2 = L2_UNKNOWN;
+
+  // random bytes don't compress, the cheapest codec to decode wins
+  auto randData = utilTestRandomData<int8_t>(n, INT8_MIN, INT8_MAX);
+  ASSERT_EQ(tsCompressL2Select((const char*)randData.data(), n, TSDB_DATA_TYPE_TINYINT, buf.data(), buf.size(), &l2),
+            0);
+  EXPECT_EQ(l2, L2_LZ4);
+
+  std::vector<int8_t> constData(n, 7);
+  ASSERT_EQ(tsCompressL2Select((const char*)constData.data(), n, TSDB_DATA_TYPE_TINYINT, buf.data(), buf.size(), &l2),
+            0);
+  EXPECT_TRUE(l2 == L2_LZ4 || l2 == L2_ZSTD || l2 == L2_ZLIB);
+
+  EXPECT_NE(tsCompressL2Select((const char*)constData.data(), n, TSDB_DATA_TYPE_TINYINT, buf.data(), n, &l2), 0);
+
+  // an unresolved auto codec must still round trip
+  auto     origData = utilTestRandomData<int64_t>(n, 0, 1000000000L);
+  uint32_t cmprAlg = 0;
+  SET_COMPRESS(L1_SIMPLE_8B, L2_AUTO, L2_LVL_MEDIUM, cmprAlg);
+  std::vector<char>    cmprData(n * sizeof(int64_t) + COMP_OVERFLOW_BYTES);
+  std::vector<char>    assist(cmprData.size());
+  std::vector<int64_t> decompData(n);
+  int32_t cnt = tsCompressBigint2(origData.data(), n * sizeof(int64_t), n, cmprData.data(), cmprData.size(), cmprAlg,
+                                  assist.data(), assist.size());
+  ASSERT_GT(cnt, 0);
+  int32_t size = tsDecompressBigint2(cmprData.data(), cnt, n, decompData.data(), n * sizeof(int64_t), cmprAlg,
+                                     assist.data(), assist.size());
+  ASSERT_EQ(size, n * sizeof(int64_t));
+  EXPECT_EQ(0, memcmp(origData.data(), decompData.data(), size));
+}
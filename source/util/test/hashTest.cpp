@@ -15,9 +15,8 @@ typedef struct TESTSTRUCT {
 } TESTSTRUCT;
 
 // the simple test code for basic operations
-void simpleTest() {
-  SHashObj* hashTable =
-      (SHashObj*)taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_INT), false, HASH_ENTRY_LOCK);
+void simpleTest(SHashLockTypeE type) {
+  SHashObj* hashTable = (SHashObj*)taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_INT), false, type);
   ASSERT_EQ(taosHashGetSize(hashTable), 0);
 
   // put 400 elements in the hash table
@@ -53,9 +52,8 @@ void simpleTest() {
   taosHashCleanup(hashTable);
 }
 
-void stringKeyTest() {
-  auto* hashTable =
-      (SHashObj*)taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_ENTRY_LOCK);
+void stringKeyTest(SHashLockTypeE type) {
+  auto* hashTable = (SHashObj*)taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, type);
   ASSERT_EQ(taosHashGetSize(hashTable), 0);
 
   char key[128] = {0};
@@ -140,16 +138,132 @@ void noLockPerformanceTest() {
   taosHashCleanup(hashTable);
 }
 
+typedef struct SHashThreadCtx {
+  SHashObj* hashTable;
+  int32_t   seed;
+  int32_t   numOfOps;
+} SHashThreadCtx;
+
+// 90% get, 9% put and 1% remove over 1 million keys
+void* hashThreadFunc(void* param) {
+  SHashThreadCtx* pCtx = (SHashThreadCtx*)param;
+  uint64_t        s = pCtx->seed * 7919 + 1;
+
+  for (int32_t i = 0; i < pCtx->numOfOps; ++i) {
+    s ^= s << 13;
+    s ^= s >> 7;
+    s ^= s << 17;
+
+    int64_t key = s % 1000000;
+    if (s % 100 < 9) {
+      (void)taosHashPut(pCtx->hashTable, &key, sizeof(key), &key, sizeof(key));
+    } else if (s % 100 == 9) {
+      (void)taosHashRemove(pCtx->hashTable, &key, sizeof(key));
+    } else {
+      int64_t* p = (int64_t*)taosHashGet(pCtx->hashTable, &key, sizeof(key));
+      if (p != nullptr && *p != key) {
+        printf("unexpected value:%" PRId64 " of key:%" PRId64 "\n", *p, key);
+      }
+    }
+  }
+
+  return nullptr;
+}
+
+// the get/put scaling of the chained table against the striped open addressing one
 void multithreadsTest() {
-  // todo
+  const int32_t  numOfOps = 200000;
+  SHashLockTypeE types[] = {HASH_ENTRY_LOCK, HASH_STRIPED_LOCK};
+
+  for (int32_t t = 0; t < sizeof(types) / sizeof(types[0]); ++t) {
+    for (int32_t numOfThreads = 1; numOfThreads <= 16; numOfThreads *= 2) {
+      SHashObj* hashTable =
+          (SHashObj*)taosHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), true, types[t]);
+      for (int64_t key = 0; key < 200000; ++key) {
+        ASSERT_EQ(taosHashPut(hashTable, &key, sizeof(key), &key, sizeof(key)), 0);
+      }
+
+      TdThread       threads[16];
+      SHashThreadCtx ctx[16];
+      int64_t        st = taosGetTimestampUs();
+      for (int32_t i = 0; i < numOfThreads; ++i) {
+        ctx[i] = {.hashTable = hashTable, .seed = i, .numOfOps = numOfOps};
+        ASSERT_EQ(taosThreadCreate(&threads[i], NULL, hashThreadFunc, &ctx[i]), 0);
+      }
+      for (int32_t i = 0; i < numOfThreads; ++i) {
+        (void)taosThreadJoin(threads[i], NULL);
+      }
+      int64_t et = taosGetTimestampUs();
+
+      int32_t num = 0;
+      for (void* p = taosHashIterate(hashTable, NULL); p != NULL; p = taosHashIterate(hashTable, p)) {
+        ++num;
+      }
+      ASSERT_EQ(num, taosHashGetSize(hashTable));
+
+      printf("lock type:%d, threads:%d, %.2f Mops/s\n", types[t], numOfThreads,
+             (double)numOfThreads * numOfOps / (et - st));
+      taosHashCleanup(hashTable);
+    }
+  }
+}
+
+// the striped table keeps the slab nodes, inline keys and incremental rehash correct under churn
+void stripedChurnTest() {
+  SHashObj* hashTable =
+      (SHashObj*)taosHashInit(4, taosGetDefaultHashFunction(TSDB_DATA_TYPE_INT), false, HASH_STRIPED_LOCK);
+
+  for (int32_t i = 0; i < 100000; ++i) {
+    ASSERT_EQ(taosHashPut(hashTable, &i, sizeof(i), &i, sizeof(i)), 0);
+  }
+  int32_t dup = 1;
+  ASSERT_EQ(taosHashPut(hashTable, &dup, sizeof(dup), &dup, sizeof(dup)), TSDB_CODE_DUP_KEY);
+
+  for (int32_t i = 0; i < 100000; i += 2) {
+    ASSERT_EQ(taosHashRemove(hashTable, &i, sizeof(i)), 0);
+  }
+
+  for (int32_t r = 0; r < 10; ++r) {
+    for (int32_t i = 200000; i < 210000; ++i) {
+      ASSERT_EQ(taosHashPut(hashTable, &i, sizeof(i), &i, sizeof(i)), 0);
+      ASSERT_EQ(taosHashRemove(hashTable, &i, sizeof(i)), 0);
+    }
+  }
+  ASSERT_EQ(taosHashGetSize(hashTable), 50000);
+
+  for (int32_t i = 0; i < 100000; ++i) {
+    int32_t* p = (int32_t*)taosHashGet(hashTable, &i, sizeof(i));
+    if (i % 2 == 0) {
+      ASSERT_TRUE(p == nullptr);
+    } else {
+      ASSERT_TRUE(p != nullptr);
+      ASSERT_EQ(*p, i);
+    }
+  }
+
+  // remove while iterating
+  int32_t num = 0;
+  for (int32_t* p = (int32_t*)taosHashIterate(hashTable, NULL); p != NULL;
+       p = (int32_t*)taosHashIterate(hashTable, p)) {
+    int32_t key = *p;
+    if (key % 4 == 1) {
+      ASSERT_EQ(taosHashRemove(hashTable, &key, sizeof(key)), 0);
+    }
+    ++num;
+  }
+  ASSERT_EQ(num, 50000);
+  ASSERT_EQ(taosHashGetSize(hashTable), 25000);
+
+  taosHashClear(hashTable);
+  ASSERT_EQ(taosHashGetSize(hashTable), 0);
+  taosHashCleanup(hashTable);
 }
 
 // check the function robustness
 void invalidOperationTest() {}
 
-void acquireRleaseTest() {
-  SHashObj* hashTable =
-      (SHashObj*)taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_INT), true, HASH_ENTRY_LOCK);
+void acquireRleaseTest(SHashLockTypeE type) {
+  SHashObj* hashTable = (SHashObj*)taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_INT), true, type);
   ASSERT_EQ(taosHashGetSize(hashTable), 0);
 
   int32_t     key = 2;
@@ -407,10 +521,17 @@ int main(int argc, char** argv) {
 }
 
 TEST(testCase, hashTest) {
-  simpleTest();
-  stringKeyTest();
+  simpleTest(HASH_ENTRY_LOCK);
+  stringKeyTest(HASH_ENTRY_LOCK);
   noLockPerformanceTest();
   multithreadsTest();
-  acquireRleaseTest();
+  acquireRleaseTest(HASH_ENTRY_LOCK);
   // perfTest();
 }
+
+TEST(testCase, stripedHashTest) {
+  simpleTest(HASH_STRIPED_LOCK);
+  stringKeyTest(HASH_STRIPED_LOCK);
+  acquireRleaseTest(HASH_STRIPED_LOCK);
+  stripedChurnTest();
+}
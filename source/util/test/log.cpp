@@ -47,6 +47,123 @@ TEST(log, check_log_refactor) {
   taosCloseLog();
 }
 
+static void logRingTestOutput(void *param, const char *msg, int32_t msgLen) {
+  ((std::string *)param)->append(msg, msgLen);
+}
+
+static void *logRingTestFunc(void *param) {
+  int32_t idx = (int32_t)(intptr_t)param;
+  for (int32_t i = 0; i < 200; ++i) {
+    uDebug("thread:%d line:%d str:%s dbl:%.2f hex:%x pad:%-5s|%05" PRId64 " chr:%c pct:%% prec:%.*s", idx, i, "abc",
+           i + 0.5, i, "ab", (int64_t)i * 1000, 'a' + i % 26, 3, "truncated");
+  }
+  return NULL;
+}
+
+TEST(log, thread_ring) {
+  const char *path = TD_TMP_DIR_PATH "tdring";
+  std::string longStr(2048, 'x');
+
+  for (int32_t binary = 0; binary < 2; ++binary) {
+    TAOS_UNUSED(taosRemoveDir(path));
+    TAOS_UNUSED(taosMkDir(path));
+    tstrncpy(tsLogDir, path, PATH_MAX);
+    tsAsyncLog = 1;
+    tsLogThreadRing = true;
+    tsLogBinary = binary;
+    uDebugFlag = 143;
+    EXPECT_EQ(taosInitLog("ringlog", 1, false), 0);
+
+    TdThread threads[4];
+    for (int32_t i = 0; i < 4; ++i) {
+      TdThreadAttr attr;
+      (void)taosThreadAttrInit(&attr);
+      EXPECT_EQ(taosThreadCreate(&threads[i], &attr, logRingTestFunc, (void *)(intptr_t)i), 0);
+      (void)taosThreadAttrDestroy(&attr);
+    }
+    for (int32_t i = 0; i < 4; ++i) {
+      (void)taosThreadJoin(threads[i], NULL);
+    }
+    // too long to be kept as arguments, formatted by the caller
+    uDebug("long line:%s", longStr.c_str());
+    taosCloseLog();
+
+    SLogDecoder *pDecoder = NULL;
+    std::string  content;
+    ASSERT_EQ(taosLogDecoderOpen(&pDecoder), 0);
+    TdDirPtr pDir = taosOpenDir(path);
+    ASSERT_NE(pDir, nullptr);
+    TdDirEntryPtr de = NULL;
+    while ((de = taosReadDir(pDir)) != NULL) {
+      char *name = taosGetDirEntryName(de);
+      if (strncmp(name, "ringlog", 7) != 0) continue;
+      std::string fileName = std::string(path) + TD_DIRSEP + name;
+      EXPECT_EQ(taosLogDecodeFile(pDecoder, fileName.c_str(), logRingTestOutput, &content), 0);
+    }
+    TAOS_UNUSED(taosCloseDir(&pDir));
+    taosLogDecoderClose(pDecoder);
+
+    char expected[256];
+    for (int32_t idx = 0; idx < 4; ++idx) {
+      for (int32_t i = 0; i < 200; ++i) {
+        snprintf(expected, sizeof(expected),
+                 "UTL DEBUG thread:%d line:%d str:%s dbl:%.2f hex:%x pad:%-5s|%05" PRId64 " chr:%c pct:%% prec:%.*s\n",
+                 idx, i, "abc", i + 0.5, i, "ab", (int64_t)i * 1000, 'a' + i % 26, 3, "truncated");
+        EXPECT_NE(content.find(expected), std::string::npos) << expected;
+      }
+    }
+    EXPECT_NE(content.find("long line:" + longStr + "\n"), std::string::npos);
+    EXPECT_EQ(content.find("TDLOGBIN"), std::string::npos);
+  }
+
+  tsLogThreadRing = false;
+  tsLogBinary = false;
+  tsAsyncLog = 0;
+  TAOS_UNUSED(taosRemoveDir(path));
+}
+
+static int32_t logRingCleanupStop = 0;
+
+static void *logRingCleanupFunc(void *param) {
+  char    msg[64];
+  int32_t len = snprintf(msg, sizeof(msg), "thread:%d ring line\n", (int32_t)(intptr_t)param);
+  while (atomic_load_32(&logRingCleanupStop) == 0) {
+    TAOS_UNUSED(taosLogRingPutText(msg, len));
+  }
+  return NULL;
+}
+
+static void logRingCountOutput(void *param, const char *msg, int32_t msgLen) { (*(int64_t *)param)++; }
+
+TEST(log, ring_cleanup) {
+  int64_t lines = 0;
+
+  // the rings are freed and created again while the threads keep writing into them
+  ASSERT_EQ(taosLogRingInit(), 0);
+  TdThread threads[4];
+  for (int32_t i = 0; i < 4; ++i) {
+    TdThreadAttr attr;
+    (void)taosThreadAttrInit(&attr);
+    EXPECT_EQ(taosThreadCreate(&threads[i], &attr, logRingCleanupFunc, (void *)(intptr_t)i), 0);
+    (void)taosThreadAttrDestroy(&attr);
+  }
+
+  for (int32_t round = 0; round < 100; ++round) {
+    taosUsleep(500);
+    taosLogRingDrain(LOG_RING_TEXT, 0, logRingCountOutput, &lines);
+    taosLogRingCleanup();
+    ASSERT_EQ(taosLogRingInit(), 0);
+  }
+
+  atomic_store_32(&logRingCleanupStop, 1);
+  for (int32_t i = 0; i < 4; ++i) {
+    (void)taosThreadJoin(threads[i], NULL);
+  }
+  taosLogRingDrain(LOG_RING_TEXT, 0, logRingCountOutput, &lines);
+  taosLogRingCleanup();
+  EXPECT_GT(lines, 0);
+}
+
 extern char *tsLogOutput;
 static void *taosLogCrashMockFunc(void *param) {
   printf("%s:%d entry\n", __func__, __LINE__);
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "os.h"
+#include "tlrucache.h"
+
+namespace {
+
+void lruTestDeleter(const void *key, size_t keyLen, void *value, void *ud) { (*(int32_t *)ud)++; }
+
+// lookup the key and insert it on miss, as the block caches do
+bool lruTestAccess(SLRUCache *cache, int32_t key, int32_t *deleted) {
+  LRUHandle *handle = taosLRUCacheLookup(cache, &key, sizeof(key));
+  if (handle != NULL) {
+    (void)taosLRUCacheRelease(cache, handle, false);
+    return true;
+  }
+
+  LRUStatus status = taosLRUCacheInsert(cache, &key, sizeof(key), NULL, 1, lruTestDeleter, NULL, NULL,
+                                        TAOS_LRU_PRIORITY_LOW, deleted);
+  EXPECT_EQ(status, TAOS_LRU_STATUS_OK);
+  return false;
+}
+
+// warm a hot set, run a one-pass scan larger than the cache, then count how many hot keys survived
+int32_t lruTestScan(LRUPolicy policy) {
+  const int32_t capacity = 1000;
+  const int32_t hotNum = 400;
+  int32_t       deleted = 0;
+
+  SLRUCache *cache = taosLRUCacheInitWithPolicy(capacity, 0, 0, policy);
+  if (cache == NULL) return -1;
+
+  for (int32_t round = 0; round < 4; ++round) {
+    for (int32_t i = 0; i < hotNum; ++i) {
+      (void)lruTestAccess(cache, i, &deleted);
+    }
+  }
+  for (int32_t i = 0; i < capacity * 10; ++i) {
+    (void)lruTestAccess(cache, 100000 + i, &deleted);
+  }
+
+  EXPECT_LE(taosLRUCacheGetUsage(cache), capacity);
+
+  int32_t hits = 0;
+  for (int32_t i = 0; i < hotNum; ++i) {
+    LRUHandle *handle = taosLRUCacheLookup(cache, &i, sizeof(i));
+    if (handle != NULL) {
+      hits++;
+      (void)taosLRUCacheRelease(cache, handle, false);
+    }
+  }
+
+  int32_t elems = taosLRUCacheGetElems(cache);
+  taosLRUCacheEraseUnrefEntries(cache);
+  EXPECT_EQ(taosLRUCacheGetElems(cache), 0);
+  EXPECT_EQ(taosLRUCacheGetUsage(cache), 0);
+  taosLRUCacheCleanup(cache);
+
+  std::cout << "policy:" << policy << " hot hits:" << hits << "/" << hotNum << " elems:" << elems << std::endl;
+  return hits;
+}
+
+}  // namespace
+
+TEST(lruCacheTest, statTest) {
+  int32_t    deleted = 0;
+  SLRUCache *cache = taosLRUCacheInit(1024, 2, 0.5);
+  ASSERT_NE(cache, nullptr);
+  ASSERT_EQ(taosLRUCacheGetNumShards(cache), 4);
+
+  for (int32_t i = 0; i < 100; ++i) {
+    ASSERT_FALSE(lruTestAccess(cache, i, &deleted));
+  }
+  for (int32_t i = 0; i < 100; ++i) {
+    ASSERT_TRUE(lruTestAccess(cache, i, &deleted));
+  }
+
+  SLRUCacheStat stat = {0};
+  taosLRUCacheGetStat(cache, &stat);
+  ASSERT_EQ(stat.hits, 100);
+  ASSERT_EQ(stat.misses, 100);
+
+  SLRUCacheStat sum = {0};
+  for (int32_t i = 0; i < taosLRUCacheGetNumShards(cache); ++i) {
+    SLRUCacheStat shardStat = {0};
+    taosLRUCacheGetShardStat(cache, i, &shardStat);
+    sum.hits += shardStat.hits;
+    sum.misses += shardStat.misses;
+  }
+  ASSERT_EQ(sum.hits, stat.hits);
+  ASSERT_EQ(sum.misses, stat.misses);
+
+  taosLRUCacheCleanup(cache);
+  ASSERT_EQ(deleted, 100);
+}
+
+TEST(lruCacheTest, tinyLFUEraseTest) {
+  int32_t    deleted = 0;
+  SLRUCache *cache = taosLRUCacheInitWithPolicy(64, 0, 0.5, TAOS_LRU_POLICY_TINYLFU);
+  ASSERT_NE(cache, nullptr);
+
+  for (int32_t round = 0; round < 3; ++round) {
+    for (int32_t i = 0; i < 200; ++i) {
+      (void)lruTestAccess(cache, i % 80, &deleted);
+      ASSERT_LE(taosLRUCacheGetUsage(cache), 64);
+    }
+  }
+  for (int32_t i = 0; i < 80; i += 2) {
+    taosLRUCacheErase(cache, &i, sizeof(i));
+  }
+
+  taosLRUCacheSetCapacity(cache, 16);
+  ASSERT_LE(taosLRUCacheGetUsage(cache), 16);
+
+  taosLRUCacheEraseUnrefEntries(cache);
+  ASSERT_EQ(taosLRUCacheGetElems(cache), 0);
+
+  SLRUCacheStat stat = {0};
+  taosLRUCacheGetStat(cache, &stat);
+  ASSERT_EQ(stat.hits + stat.misses, 600);
+  ASSERT_EQ(deleted, stat.misses);
+
+  taosLRUCacheCleanup(cache);
+}
+
+TEST(lruCacheTest, scanResistTest) {
+  int32_t lruHits = lruTestScan(TAOS_LRU_POLICY_LRU);
+  int32_t lfuHits = lruTestScan(TAOS_LRU_POLICY_TINYLFU);
+
+  ASSERT_EQ(lruHits, 0);
+  ASSERT_GE(lfuHits, 400 * 9 / 10);
+}
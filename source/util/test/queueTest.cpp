@@ -0,0 +1,292 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "os.h"
+#include "tqueue.h"
+
+namespace {
+
+typedef struct {
+  STaosQueue *queue;
+  int32_t     id;
+  int32_t     numOfItems;
+  int32_t     failed;
+} SQueueProducer;
+
+void *queueProducerFunc(void *param) {
+  SQueueProducer *pProducer = (SQueueProducer *)param;
+  for (int32_t i = 0; i < pProducer->numOfItems; ++i) {
+    int64_t *pItem = NULL;
+    if (taosAllocateQitem(sizeof(int64_t), DEF_QITEM, 0, (void **)&pItem) != 0) {
+      pProducer->failed++;
+      continue;
+    }
+    *pItem = ((int64_t)pProducer->id << 32) | i;
+    if (taosWriteQitem(pProducer->queue, pItem) != 0) {
+      taosFreeQitem(pItem);
+      pProducer->failed++;
+    }
+  }
+  return NULL;
+}
+
+// drain everything and check that the items of each producer come out in order
+void queueCheckOrder(STaosQall *qall, int32_t *next) {
+  int64_t *pItem = NULL;
+  while (taosGetQitem(qall, (void **)&pItem) != 0) {
+    int32_t id = (int32_t)(*pItem >> 32);
+    int32_t seq = (int32_t)(*pItem & 0xFFFFFFFF);
+    ASSERT_EQ(seq, next[id]);
+    next[id]++;
+    taosFreeQitem(pItem);
+  }
+}
+
+}  // namespace
+
+TEST(queueTest, basicTest) {
+  STaosQueue *queue = NULL;
+  ASSERT_EQ(taosOpenQueue(&queue), 0);
+  ASSERT_TRUE(taosQueueEmpty(queue));
+
+  for (int32_t i = 0; i < 10; ++i) {
+    int32_t *pItem = NULL;
+    ASSERT_EQ(taosAllocateQitem(sizeof(int32_t), DEF_QITEM, 100, (void **)&pItem), 0);
+    *pItem = i;
+    ASSERT_EQ(taosWriteQitem(queue, pItem), 0);
+  }
+  ASSERT_FALSE(taosQueueEmpty(queue));
+  ASSERT_EQ(taosQueueItemSize(queue), 10);
+  ASSERT_EQ(taosQueueMemorySize(queue), 10 * (sizeof(int32_t) + 100));
+
+  int32_t *pItem = NULL;
+  taosReadQitem(queue, (void **)&pItem);
+  ASSERT_NE(pItem, nullptr);
+  ASSERT_EQ(*pItem, 0);
+  taosFreeQitem(pItem);
+  ASSERT_EQ(taosQueueItemSize(queue), 9);
+
+  STaosQall *qall = NULL;
+  ASSERT_EQ(taosAllocateQall(&qall), 0);
+  ASSERT_EQ(taosReadAllQitems(queue, qall), 9);
+  ASSERT_EQ(taosQueueItemSize(queue), 0);
+  ASSERT_EQ(taosQueueMemorySize(queue), 0);
+  ASSERT_TRUE(taosQueueEmpty(queue));
+
+  for (int32_t i = 1; i < 10; ++i) {
+    ASSERT_EQ(taosGetQitem(qall, (void **)&pItem), 1);
+    ASSERT_EQ(*pItem, i);
+    taosFreeQitem(pItem);
+  }
+  ASSERT_EQ(taosGetQitem(qall, (void **)&pItem), 0);
+  ASSERT_EQ(taosReadAllQitems(queue, qall), 0);
+
+  // the item limit is enforced without a lock and the reservation is given back on failure
+  taosSetQueueCapacity(queue, 2);
+  for (int32_t i = 0; i < 3; ++i) {
+    ASSERT_EQ(taosAllocateQitem(sizeof(int32_t), DEF_QITEM, 0, (void **)&pItem), 0);
+    if (i < 2) {
+      ASSERT_EQ(taosWriteQitem(queue, pItem), 0);
+    } else {
+      ASSERT_EQ(taosWriteQitem(queue, pItem), TSDB_CODE_UTIL_QUEUE_OUT_OF_MEMORY);
+      taosFreeQitem(pItem);
+    }
+  }
+  ASSERT_EQ(taosQueueItemSize(queue), 2);
+
+  taosFreeQall(qall);
+  taosCloseQueue(queue);
+}
+
+TEST(queueTest, multiProducerTest) {
+  const int32_t  numOfThreads = 8;
+  const int32_t  numOfItems = 100000;
+  STaosQueue    *queue = NULL;
+  STaosQall     *qall = NULL;
+  TdThread       threads[numOfThreads];
+  SQueueProducer producers[numOfThreads];
+  int32_t        next[numOfThreads] = {0};
+
+  ASSERT_EQ(taosOpenQueue(&queue), 0);
+  ASSERT_EQ(taosAllocateQall(&qall), 0);
+
+  for (int32_t i = 0; i < numOfThreads; ++i) {
+    producers[i] = {queue, i, numOfItems, 0};
+    ASSERT_EQ(taosThreadCreate(&threads[i], NULL, queueProducerFunc, &producers[i]), 0);
+  }
+
+  int64_t total = 0;
+  int64_t st = taosGetTimestampUs();
+  while (total < (int64_t)numOfThreads * numOfItems) {
+    int32_t num = taosReadAllQitems(queue, qall);
+    if (num == 0) {
+      (void)sched_yield();
+      continue;
+    }
+    ASSERT_EQ(taosQallItemSize(qall), num);
+    ASSERT_EQ(taosQallMemSize(qall), num * sizeof(int64_t));
+    queueCheckOrder(qall, next);
+    total += num;
+  }
+  int64_t cost = taosGetTimestampUs() - st;
+
+  for (int32_t i = 0; i < numOfThreads; ++i) {
+    (void)taosThreadJoin(threads[i], NULL);
+    ASSERT_EQ(producers[i].failed, 0);
+    ASSERT_EQ(next[i], numOfItems);
+  }
+  ASSERT_TRUE(taosQueueEmpty(queue));
+  ASSERT_EQ(taosQueueMemorySize(queue), 0);
+  std::cout << numOfThreads << " producers, " << total << " items, cost:" << cost << "us" << std::endl;
+
+  taosFreeQall(qall);
+  taosCloseQueue(queue);
+}
+
+TEST(queueTest, qsetTest) {
+  const int32_t  numOfQueues = 4;
+  const int32_t  numOfItems = 20000;
+  STaosQset     *qset = NULL;
+  STaosQueue    *queues[numOfQueues];
+  STaosQall     *qall = NULL;
+  TdThread       threads[numOfQueues];
+  SQueueProducer producers[numOfQueues];
+  int32_t        next[numOfQueues] = {0};
+
+  ASSERT_EQ(taosOpenQset(&qset), 0);
+  ASSERT_EQ(taosAllocateQall(&qall), 0);
+  for (int32_t i = 0; i < numOfQueues; ++i) {
+    ASSERT_EQ(taosOpenQueue(&queues[i]), 0);
+    ASSERT_EQ(taosAddIntoQset(qset, queues[i], NULL), 0);
+  }
+  ASSERT_EQ(taosGetQueueNumber(qset), numOfQueues);
+
+  for (int32_t i = 0; i < numOfQueues; ++i) {
+    producers[i] = {queues[i], i, numOfItems, 0};
+    ASSERT_EQ(taosThreadCreate(&threads[i], NULL, queueProducerFunc, &producers[i]), 0);
+  }
+
+  // every wake-up of the reader must find items, a zero return means the worker exits
+  int64_t total = 0;
+  while (total < (int64_t)numOfQueues * numOfItems) {
+    SQueueInfo qinfo = {0};
+    int32_t    num = taosReadAllQitemsFromQset(qset, qall, &qinfo);
+    ASSERT_GT(num, 0);
+    queueCheckOrder(qall, next);
+    taosUpdateItemSize((STaosQueue *)qinfo.queue, num);
+    total += num;
+  }
+
+  for (int32_t i = 0; i < numOfQueues; ++i) {
+    (void)taosThreadJoin(threads[i], NULL);
+    ASSERT_EQ(next[i], numOfItems);
+    ASSERT_TRUE(taosQueueEmpty(queues[i]));
+  }
+
+  taosQsetThreadResume(qset);
+  SQueueInfo qinfo = {0};
+  ASSERT_EQ(taosReadAllQitemsFromQset(qset, qall, &qinfo), 0);
+
+  for (int32_t i = 0; i < numOfQueues; ++i) {
+    taosCloseQueue(queues[i]);
+  }
+  taosFreeQall(qall);
+  taosCloseQset(qset);
+}
+
+TEST(queueTest, limitTest) {
+  const int32_t  numOfThreads = 8;
+  const int32_t  numOfItems = 20000;
+  const int32_t  numOfFit = 1000;
+  STaosQueue    *queue = NULL;
+  STaosQall     *qall = NULL;
+  TdThread       threads[numOfThreads];
+  SQueueProducer producers[numOfThreads];
+
+  ASSERT_EQ(taosAllocateQall(&qall), 0);
+
+  // exactly numOfFit items fit under either limit, however the concurrent writers interleave
+  for (int32_t round = 0; round < 2; ++round) {
+    ASSERT_EQ(taosOpenQueue(&queue), 0);
+    if (round == 0) {
+      taosSetQueueMemoryCapacity(queue, numOfFit * sizeof(int64_t));
+    } else {
+      taosSetQueueCapacity(queue, numOfFit);
+    }
+
+    for (int32_t i = 0; i < numOfThreads; ++i) {
+      producers[i] = {queue, i, numOfItems, 0};
+      ASSERT_EQ(taosThreadCreate(&threads[i], NULL, queueProducerFunc, &producers[i]), 0);
+    }
+
+    int64_t failed = 0;
+    for (int32_t i = 0; i < numOfThreads; ++i) {
+      (void)taosThreadJoin(threads[i], NULL);
+      failed += producers[i].failed;
+    }
+    ASSERT_EQ(failed, (int64_t)numOfThreads * numOfItems - numOfFit);
+    ASSERT_EQ(taosQueueItemSize(queue), numOfFit);
+    ASSERT_EQ(taosQueueMemorySize(queue), numOfFit * sizeof(int64_t));
+
+    ASSERT_EQ(taosReadAllQitems(queue, qall), numOfFit);
+    int64_t *pItem = NULL;
+    while (taosGetQitem(qall, (void **)&pItem) != 0) {
+      taosFreeQitem(pItem);
+    }
+    taosCloseQueue(queue);
+  }
+
+  taosFreeQall(qall);
+}
+
+TEST(queueTest, qsetMembershipTest) {
+  const int32_t  numOfThreads = 4;
+  const int32_t  numOfItems = 50000;
+  STaosQset     *qset = NULL;
+  STaosQueue    *queue = NULL;
+  STaosQall     *qall = NULL;
+  TdThread       threads[numOfThreads];
+  SQueueProducer producers[numOfThreads];
+  int32_t        next[numOfThreads] = {0};
+
+  ASSERT_EQ(taosOpenQset(&qset), 0);
+  ASSERT_EQ(taosOpenQueue(&queue), 0);
+  ASSERT_EQ(taosAllocateQall(&qall), 0);
+
+  for (int32_t i = 0; i < numOfThreads; ++i) {
+    producers[i] = {queue, i, numOfItems, 0};
+    ASSERT_EQ(taosThreadCreate(&threads[i], NULL, queueProducerFunc, &producers[i]), 0);
+  }
+
+  // the queue joins and leaves the set while items are written and read, the set must not keep any stale count
+  int64_t total = 0;
+  bool    inQset = false;
+  while (total < (int64_t)numOfThreads * numOfItems) {
+    if (inQset) {
+      taosRemoveFromQset(qset, queue);
+      ASSERT_EQ(taosQsetItemSize(qset), 0);
+    } else {
+      ASSERT_EQ(taosAddIntoQset(qset, queue, NULL), 0);
+    }
+    inQset = !inQset;
+
+    int32_t num = taosReadAllQitems(queue, qall);
+    queueCheckOrder(qall, next);
+    total += num;
+  }
+
+  for (int32_t i = 0; i < numOfThreads; ++i) {
+    (void)taosThreadJoin(threads[i], NULL);
+    ASSERT_EQ(producers[i].failed, 0);
+    ASSERT_EQ(next[i], numOfItems);
+  }
+  ASSERT_TRUE(taosQueueEmpty(queue));
+  if (inQset) {
+    ASSERT_EQ(taosQsetItemSize(qset), 0);
+  }
+
+  taosCloseQueue(queue);
+  ASSERT_EQ(taosGetQueueNumber(qset), 0);
+  taosFreeQall(qall);
+  taosCloseQset(qset);
+}
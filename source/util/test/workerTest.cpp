@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "os.h"
+#include "tarray.h"
+#include "tqueue.h"
+#include "tworker.h"
+
+namespace {
+
+typedef struct {
+  int32_t seq;
+  bool    isLong;
+} SWorkerTestMsg;
+
+int64_t workerTestProcessed = 0;
+
+void workerTestProcessFp(SQueueInfo *pInfo, void *pItem) {
+  SWorkerTestMsg *pMsg = (SWorkerTestMsg *)pItem;
+  if (pMsg->isLong) {
+    // a long query blocks in the middle, so that the waiting paths of the pool are walked through
+    SQueryAutoQWorkerPoolCB *pCb = (SQueryAutoQWorkerPoolCB *)pInfo->workerCb;
+    EXPECT_EQ(pCb->beforeBlocking(pCb->pPool), 0);
+    taosMsleep(5);
+    EXPECT_EQ(pCb->afterRecoverFromBlocking(pCb->pPool), 0);
+  }
+
+  (void)atomic_add_fetch_64(&workerTestProcessed, 1);
+  taosFreeQitem(pItem);
+}
+
+}  // namespace
+
+TEST(workerTest, queryAutoQWorkerTest) {
+  const int32_t         numOfQueues = 4;
+  const int32_t         numOfMsgs = 4000;
+  SQueryAutoQWorkerPool pool = {0};
+  STaosQueue           *queues[numOfQueues] = {0};
+
+  pool.name = "test-query";
+  pool.min = 4;
+  pool.max = 4;
+  ASSERT_EQ(tQueryAutoQWorkerInit(&pool), 0);
+
+  for (int32_t i = 0; i < numOfQueues; ++i) {
+    queues[i] = tQueryAutoQWorkerAllocQueue(&pool, NULL, workerTestProcessFp);
+    ASSERT_NE(queues[i], nullptr);
+  }
+
+  // short msgs mixed with long ones, queued in bursts so that the reads take batches into the local deques
+  for (int32_t i = 0; i < numOfMsgs; ++i) {
+    SWorkerTestMsg *pMsg = NULL;
+    ASSERT_EQ(taosAllocateQitem(sizeof(SWorkerTestMsg), DEF_QITEM, 0, (void **)&pMsg), 0);
+    pMsg->seq = i;
+    pMsg->isLong = (i % 50 == 0);
+    ASSERT_EQ(taosWriteQitem(queues[i % numOfQueues], pMsg), 0);
+  }
+
+  // the same wait as a vnode close does before freeing its queue
+  int64_t start = taosGetTimestampMs();
+  for (int32_t i = 0; i < numOfQueues; ++i) {
+    while (!taosQueueEmpty(queues[i])) {
+      ASSERT_LT(taosGetTimestampMs() - start, 60 * 1000);
+      taosMsleep(1);
+    }
+  }
+  ASSERT_EQ(atomic_load_64(&workerTestProcessed), numOfMsgs);
+
+  SArray *pStats = taosArrayInit(4, sizeof(SQueryAutoQWorkerStat));
+  ASSERT_NE(pStats, nullptr);
+  ASSERT_EQ(tQueryAutoQWorkerGetStat(&pool, pStats), 0);
+  int64_t runNum = 0, stealNum = 0;
+  for (int32_t i = 0; i < taosArrayGetSize(pStats); ++i) {
+    SQueryAutoQWorkerStat *pStat = (SQueryAutoQWorkerStat *)taosArrayGet(pStats, i);
+    runNum += pStat->runNum;
+    stealNum += pStat->stealNum;
+  }
+  taosArrayDestroy(pStats);
+  ASSERT_LE(runNum, numOfMsgs);
+  std::cout << "workers run:" << runNum << " steal:" << stealNum << std::endl;
+
+  for (int32_t i = 0; i < numOfQueues; ++i) {
+    tQueryAutoQWorkerFreeQueue(&pool, queues[i]);
+  }
+  tQueryAutoQWorkerCleanup(&pool);
+}
@@ -13,6 +13,7 @@
 
 import sys
 import os
+import glob
 import os.path
 import platform
 import distro
@@ -193,6 +194,13 @@ class TDDnode:
 
         return totalSize
 
+    def countLog(self, pattern):
+        count = 0
+        for name in glob.glob(os.path.join(self.logDir, "taosdlog.*")):
+            with open(name, errors="ignore") as f:
+                count += sum(1 for line in f if pattern in line)
+        return count
+
     def addExtraCfg(self, option, value):
         self.cfgDict.update({option: value})
 
@@ -762,6 +770,13 @@ class TDDnodes:
         self.check(index)
         return self.dnodes[index - 1].getDataSize()
 
+    def countLog(self, index, pattern):
+        '''
+            the number of lines of the taosd log of dnode index that contain pattern
+        '''
+        self.check(index)
+        return self.dnodes[index - 1].countLog(pattern)
+
     def forcestop(self, index):
         self.check(index)
         self.dnodes[index - 1].forcestop()
@@ -130,6 +130,27 @@ class TDSql:
                 time.sleep(1)
                 pass
 
+    def sqlValue(self, value):
+        '''
+            the literal of value in a sql statement, None is null and str is quoted
+        '''
+        if value is None:
+            return "null"
+        return f"'{value}'" if isinstance(value, str) else str(value)
+
+    def insertRows(self, tbname, rows, batchSize=1000):
+        '''
+            insert rows into tbname, batchSize rows each statement, a row is a tuple of its column values
+        '''
+        batch = []
+        for row in rows:
+            batch.append("(" + ", ".join(self.sqlValue(v) for v in row) + ")")
+            if len(batch) == batchSize:
+                self.execute(f"insert into {tbname} values " + " ".join(batch))
+                batch = []
+        if batch:
+            self.execute(f"insert into {tbname} values " + " ".join(batch))
+
     def no_error(self, sql):
         caller = inspect.getframeinfo(inspect.stack()[1][0])
         expectErrOccurred = False
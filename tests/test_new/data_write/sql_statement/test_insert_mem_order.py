@@ -0,0 +1,122 @@
+import random
+
+from util.log import *
+from util.cases import *
+from util.sql import *
+
+
+class TestInsertMemOrder:
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+
+        self.dbname = "memorder"
+        # keys are offsets from this timestamp, so that out-of-order ones can go before the first appended one
+        self.start = 1700000000000
+        # the expected content of each table, timestamp -> (c1, c2)
+        self.rows = {"t1": {}, "t2": {}}
+        self.seq = 0
+
+    def test_insert_mem_order(self):
+        """测试内存表顺序写入、乱序写入及交替写入后的查询结果
+
+        顺序写入的数据追加到内存表的数据块链表，乱序和重复时间戳的数据写入跳表，
+        查询时两者按时间戳合并，覆盖不同批次大小、重复时间戳覆盖写、多表交替写入、升序和降序扫描、
+        按时间范围查询以及落盘前后的结果
+
+        Since: v3.3.7.0
+
+        Labels: insert
+
+        History:
+            - 2026-10-18 Created
+
+        """
+        self.run()
+
+    def insert_rows(self, table, keys):
+        # every write gets a new c1, so an overwrite of a key shows up in the result
+        rows = []
+        for key in keys:
+            self.seq += 1
+            rows.append((self.start + key, self.seq, None if self.seq % 13 == 0 else f"v{self.seq}"))
+            self.rows[table][self.start + key] = rows[-1][1:]
+        tdSql.insertRows(table, rows)
+
+    def check_rows(self, table, skey=0, ekey=2**63 - 1):
+        for order in ["asc", "desc"]:
+            tdSql.query(f"select cast(ts as bigint), c1, c2 from {table} where ts >= {skey} and ts <= {ekey} "
+                        f"order by ts {order}")
+            keys = sorted((ts for ts in self.rows[table] if skey <= ts <= ekey), reverse=(order == "desc"))
+            tdSql.checkRows(len(keys))
+            for row, ts in zip(tdSql.queryResult, keys):
+                c1, c2 = self.rows[table][ts]
+                if row[0] != ts or row[1] != c1 or row[2] != c2:
+                    tdLog.exit(f"{table} [{skey}, {ekey}] {order}, expected ({ts}, {c1}, {c2}), got {row}")
+
+    def check_all(self):
+        for table in self.rows:
+            self.check_rows(table)
+            keys = sorted(self.rows[table])
+            if not keys:
+                continue
+            # ranges starting and ending inside the chunks, on existing keys and between them
+            for _ in range(20):
+                skey = random.choice(keys) + random.choice([-1, 0, 1])
+                ekey = skey + random.randint(0, 50000)
+                self.check_rows(table, skey, ekey)
+
+            tdSql.query(f"select count(*), first(c1), last(c1) from {table}")
+            tdSql.checkData(0, 0, len(keys))
+            tdSql.checkData(0, 1, self.rows[table][keys[0]][0])
+            tdSql.checkData(0, 2, self.rows[table][keys[-1]][0])
+
+    def run(self):
+        random.seed(20261018)
+        db = self.dbname
+        tdSql.execute(f"drop database if exists {db}")
+        tdSql.execute(f"create database {db} vgroups 1")
+        tdSql.execute(f"use {db}")
+        tdSql.execute("create table t1(ts timestamp, c1 int, c2 varchar(16))")
+        tdSql.execute("create table t2(ts timestamp, c1 int, c2 varchar(16))")
+
+        # in order, in batches of growing and uneven sizes, so that rows fill the chunks across their borders
+        key = 0
+        for size in [1, 1, 2, 15, 16, 17, 31, 100, 1000, 4095, 4097, 3]:
+            self.insert_rows("t1", range(key, key + size * 10, 10))
+            key += size * 10
+        self.check_all()
+
+        # the last key, an earlier key of the appended rows and a key twice in one statement are overwritten
+        self.insert_rows("t1", [key - 10])
+        self.insert_rows("t1", [0, 10, 15000, 15000, 20000])
+        self.check_all()
+
+        # out of order, before the first key and between the appended keys
+        self.insert_rows("t1", [-5, -3, -1])
+        self.insert_rows("t1", random.sample(range(1, key, 10), 500))
+        self.check_all()
+
+        # appended and out-of-order batches interleaved, on two tables at once
+        key2 = 0
+        for i in range(30):
+            self.insert_rows("t1", range(key, key + 100, 2))
+            self.insert_rows("t2", range(key2, key2 + 50))
+            key += 100
+            key2 += 50
+            self.insert_rows("t1", [random.randrange(0, key) for _ in range(7)])
+            self.insert_rows("t2", [random.randrange(0, key2) for _ in range(3)] + [key2 - 1])
+        self.check_all()
+
+        # the chunks are written to the files, then the memtable rows are merged with the file rows
+        tdSql.execute(f"flush database {db}")
+        self.check_all()
+        self.insert_rows("t1", range(key, key + 3000, 3))
+        self.insert_rows("t1", random.sample(range(0, key), 300))
+        self.insert_rows("t2", range(key2 - 20, key2 + 20))
+        self.check_all()
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
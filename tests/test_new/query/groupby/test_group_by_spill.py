@@ -0,0 +1,112 @@
+import time
+
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import tdDnodes
+
+
+class TestGroupBySpill:
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+
+        self.dbname = "gbspill"
+        self.rowsPerTable = 40000
+        self.numOfTables = 3
+        # c1 has this many distinct values, c4 a bit fewer; each group takes far more than 20 bytes of result row and
+        # hash entry, so the groups of any of the queries below do not fit in 1 MB
+        self.groups = 50000
+
+    def test_group_by_spill(self):
+        """测试高基数分组聚合超出内存限制时分区落盘
+
+        将 queryGroupByMemSizeMB 设为最小值，使内存中放不下的分组的数据行按分区写入磁盘后再聚合，
+        结果与不落盘时一致，覆盖多个 vgroup 的两阶段聚合、空值分组、变长分组键和多列分组
+
+        Since: v3.3.7.0
+
+        Labels: group by
+
+        History:
+            - 2026-10-18 Created
+
+        """
+        self.run()
+
+    def prepare_data(self):
+        db = self.dbname
+        tdSql.execute(f"drop database if exists {db}")
+        tdSql.execute(f"create database {db} vgroups 2")
+        tdSql.execute(f"use {db}")
+
+        tdSql.execute("create table st(ts timestamp, c1 int, c2 bigint, c3 double, c4 varchar(24)) tags(t1 int)")
+        for t in range(self.numOfTables):
+            tdSql.execute(f"create table ct{t} using st tags({t})")
+
+        # most of the groups have rows in every child table, so the groups of both vgroups meet in the merge phase
+        for t in range(self.numOfTables):
+            rows = ((1600000000000 + i * 1000,
+                     None if i % 1009 == 0 else (i * 7 + t) % self.groups,
+                     i + t,
+                     (i % 100) / 4,
+                     None if i % 997 == 0 else f"g{(i * 13 + t) % (self.groups * 3 // 5)}")
+                    for i in range(self.rowsPerTable))
+            tdSql.insertRows(f"ct{t}", rows)
+
+        tdSql.execute(f"flush database {db}")
+
+    def set_mem_limit(self, mb):
+        tdSql.execute(f"alter all dnodes 'queryGroupByMemSizeMB' '{mb}'")
+
+    def query_sorted(self, sql):
+        tdSql.query(sql)
+        return sorted(tdSql.queryResult, key=str)
+
+    def wait_spilled(self, sql, before):
+        # the executor logs each spill pass at debug level, the log is written asynchronously
+        for i in range(20):
+            if tdDnodes.countLog(1, "group by spilled") > before:
+                return
+            time.sleep(0.5)
+        tdLog.exit(f"group by does not spill, sql:{sql}")
+
+    def check_spill_result(self, sql):
+        self.set_mem_limit(0)
+        expected = self.query_sorted(sql)
+        self.set_mem_limit(1)
+        before = tdDnodes.countLog(1, "group by spilled")
+        spilled = self.query_sorted(sql)
+        self.wait_spilled(sql, before)
+
+        if spilled != expected:
+            tdLog.exit(f"spilled group by result differs, sql:{sql}, rows:{len(spilled)}, expected:{len(expected)}")
+        return len(expected)
+
+    def run(self):
+        self.prepare_data()
+
+        try:
+            # one group per distinct key plus the null group
+            rows = self.check_spill_result("select c1, count(*), sum(c2), max(c3), min(c4) from st group by c1")
+            tdSql.query("select count(distinct c1) from st")
+            tdSql.checkEqual(rows, tdSql.queryResult[0][0] + 1)
+
+            # a single child table runs in one phase
+            self.check_spill_result("select c1, count(*), avg(c3), last(c2) from ct0 group by c1")
+
+            # var-length key, and two keys
+            self.check_spill_result("select c4, count(*), sum(c2), first(c1) from st group by c4")
+            self.check_spill_result("select c1, c4, count(*), spread(c2) from st group by c1, c4")
+
+            # functions keeping many values per group, and a filter on the groups
+            self.check_spill_result("select c1, count(*), percentile(c3, 50) from ct1 group by c1")
+            self.check_spill_result("select c4, count(*), max(c2) from st group by c4 having count(*) > 2")
+            self.check_spill_result("select count(*), sum(cnt) from (select c1, count(*) cnt from st group by c1)")
+        finally:
+            self.set_mem_limit(1024)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
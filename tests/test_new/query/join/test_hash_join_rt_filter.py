@@ -0,0 +1,112 @@
+from util.log import *
+from util.cases import *
+from util.sql import *
+
+
+class TestHashJoinRtFilter:
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+
+        self.dbname = "rtf"
+        self.start = 1620000000000
+        self.probeRows = 20000
+        self.buildRows = 50
+
+    def test_hash_join_rt_filter(self):
+        """测试hash join下推到探测表扫描的运行时过滤
+
+        探测表数据远多于构建表，使用 HASH_JOIN hint 的查询结果与 merge join 的结果一致，
+        覆盖按数据块时间范围裁剪、空值、多键连接、带 limit 的子查询以及超级表连接
+
+        Since: v3.3.7.0
+
+        Labels: join
+
+        History:
+            - 2026-10-18 Created
+
+        """
+        self.run()
+
+    def prepare_data(self):
+        db = self.dbname
+        tdSql.execute(f"drop database if exists {db}")
+        # small blocks, so that most of the probe blocks are pruned by their time range
+        tdSql.execute(f"create database {db} vgroups 1 minrows 10 maxrows 200")
+        tdSql.execute(f"use {db}")
+
+        tdSql.execute("create table pt(ts timestamp, c1 int, c2 binary(16))")
+        tdSql.execute("create table bt(ts timestamp, c1 int, c2 binary(16))")
+        tdSql.execute("create table sta(ts timestamp, c1 int) tags(tg1 int)")
+        tdSql.execute("create table sta1 using sta tags(1)")
+        tdSql.execute("create table sta2 using sta tags(2)")
+        tdSql.execute("create table stb(ts timestamp, c1 int) tags(tg1 int)")
+        tdSql.execute("create table stb1 using stb tags(1)")
+        tdSql.execute("create table stb2 using stb tags(2)")
+
+        # the probe table has a row every second, every 7th c1 is null
+        tdSql.insertRows("pt", ((self.start + i * 1000, None if i % 7 == 0 else i % 100, f"p{i % 13}")
+                                for i in range(self.probeRows)))
+
+        # the build table hits a few scattered seconds of the probe table, some of them with null c1, and misses some
+        secs = [(i * 397) % (self.probeRows + 100) for i in range(self.buildRows)]
+        tdSql.insertRows("bt", ((self.start + sec * 1000, None if i % 5 == 0 else sec % 100, f"b{i % 3}")
+                                for i, sec in enumerate(secs)))
+
+        # the child tables of sta have a row every second, the ones of stb match every 97th of them
+        for tb, step, delta in [("sta1", 1, 0), ("sta2", 1, 1), ("stb1", 97, 0), ("stb2", 97, 0)]:
+            tdSql.insertRows(tb, ((self.start + i * 1000, i + delta) for i in range(0, 2000, step)))
+
+        tdSql.execute(f"flush database {db}")
+
+    def check_same_result(self, sql):
+        # the merge join does not push any filter to the scan, its result is the reference
+        tdSql.query(sql.format(hint=""))
+        expected = sorted(tdSql.queryResult, key=str)
+        tdSql.query(sql.format(hint="/*+ HASH_JOIN() */"))
+        actual = sorted(tdSql.queryResult, key=str)
+        if actual != expected:
+            tdLog.exit(f"hash join result differs, sql:{sql}, rows:{len(actual)}, expected rows:{len(expected)}")
+        return len(expected)
+
+    def run(self):
+        self.prepare_data()
+
+        # timestamp key, the probe blocks out of the range of the build keys are skipped
+        rows = self.check_same_result("select {hint} a.ts, a.c1, a.c2, b.c1, b.c2 from pt a join bt b on a.ts = b.ts")
+        tdSql.query("select count(*) from bt where ts < %d" % (self.start + self.probeRows * 1000))
+        tdSql.checkEqual(rows, tdSql.queryResult[0][0])
+
+        self.check_same_result("select {hint} a.ts, a.c1, b.c1 from bt b join pt a on a.ts = b.ts")
+        self.check_same_result("select {hint} count(*), sum(a.c1), max(b.c1) from pt a join bt b on a.ts = b.ts")
+
+        # null values of the non-key columns are kept, rows with null keys of a multi-key join never match
+        self.check_same_result("select {hint} a.ts, a.c1, b.c1 from pt a join bt b on a.ts = b.ts and a.c1 = b.c1")
+        self.check_same_result("select {hint} a.ts, a.c1, b.c1 from pt a join bt b on a.ts = b.ts where a.c1 is null")
+        self.check_same_result("select {hint} a.ts, b.c2 from pt a join bt b on a.ts = b.ts and a.c2 = b.c2")
+
+        # the probe side has its own filter and a range on the key
+        self.check_same_result(
+            "select {hint} a.ts, a.c1 from pt a join bt b on a.ts = b.ts where a.c1 > 10 and a.ts > %d" %
+            (self.start + 5000 * 1000))
+
+        # the limit of the subquery belongs to the probe rows before the join
+        for limit in [1, 100, 3000]:
+            self.check_same_result(
+                "select {hint} a.ts, a.c1 from (select * from pt limit %d) a join bt b on a.ts = b.ts" % limit)
+            self.check_same_result(
+                "select {hint} a.ts, a.c1 from (select * from pt limit 10 offset %d) a join bt b on a.ts = b.ts" % limit)
+
+        # no build key at all
+        tdSql.query("select /*+ HASH_JOIN() */ a.ts from pt a join bt b on a.ts = b.ts where b.ts < %d" % self.start)
+        tdSql.checkRows(0)
+
+        # super table join, the child tables are joined one pair at a time
+        self.check_same_result("select {hint} a.ts, a.c1, b.c1 from sta a join stb b on a.ts = b.ts and a.tg1 = b.tg1")
+        self.check_same_result("select {hint} a.ts, a.c1, b.c1 from sta a join stb b on a.ts = b.ts")
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
@@ -0,0 +1,117 @@
+import time
+
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import tdDnodes
+
+
+class TestHashJoinSpill:
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+
+        self.dbname = "hjspill"
+        self.rows = 30000
+
+    def test_hash_join_spill(self):
+        """测试hash join构建表超出内存限制时分区落盘
+
+        将 queryHashJoinMemSizeMB 设为最小值，使构建表和探测表的数据都按分区写入磁盘，
+        结果与不落盘的 hash join 以及 merge join 的结果一致，覆盖空值连接键和多个变长连接键
+
+        Since: v3.3.7.0
+
+        Labels: join
+
+        History:
+            - 2026-10-18 Created
+
+        """
+        self.run()
+
+    def prepare_data(self):
+        db = self.dbname
+        tdSql.execute(f"drop database if exists {db}")
+        tdSql.execute(f"create database {db} vgroups 1")
+        tdSql.execute(f"use {db}")
+
+        tdSql.execute("create table pt(ts timestamp, c1 int, c2 varchar(32), c3 nchar(16))")
+        tdSql.execute("create table bt(ts timestamp, c1 int, c2 varchar(32), c3 nchar(16), pad varchar(200))")
+
+        # the build table is several megabytes, far above the 1 MB limit, so most of its partitions stay on disk; it
+        # has two thirds of the probe timestamps, with keys partly equal to the probe ones
+        pad = "x" * 180
+        keys = [1610000000000 + i * 1000 for i in range(self.rows)]
+        c3 = [None if i % 13 == 0 else f"n{i % 5}" for i in range(self.rows)]
+        tdSql.insertRows("pt", ((keys[i], i % 100, None if i % 11 == 0 else f"k{i % 37}", c3[i])
+                                for i in range(self.rows)))
+        tdSql.insertRows("bt", ((keys[i], i % 50, None if i % 17 == 0 else f"k{i % 37 if i % 2 == 0 else (i * 7) % 37}",
+                                 c3[i], f"{pad}{i % 10}") for i in range(self.rows) if i % 3 != 0), batchSize=500)
+
+        tdSql.execute(f"flush database {db}")
+
+    def set_mem_limit(self, mb):
+        tdSql.execute(f"alter all dnodes 'queryHashJoinMemSizeMB' '{mb}'")
+
+    def query_sorted(self, sql):
+        tdSql.query(sql)
+        return sorted(tdSql.queryResult, key=str)
+
+    def wait_spilled(self, sql, before):
+        # the executor logs the spilled rows at debug level, the log is written asynchronously
+        for i in range(20):
+            if tdDnodes.countLog(1, "hash join spilled") > before:
+                return
+            time.sleep(0.5)
+        tdLog.exit(f"hash join does not spill, sql:{sql}")
+
+    def check_spill_result(self, sql):
+        # the merge join and the in-memory hash join are the references
+        expected = self.query_sorted(sql.format(hint=""))
+
+        self.set_mem_limit(0)
+        inMem = self.query_sorted(sql.format(hint="/*+ HASH_JOIN() */"))
+        self.set_mem_limit(1)
+        before = tdDnodes.countLog(1, "hash join spilled")
+        spilled = self.query_sorted(sql.format(hint="/*+ HASH_JOIN() */"))
+        self.wait_spilled(sql, before)
+
+        if inMem != expected:
+            tdLog.exit(f"in-memory hash join result differs, sql:{sql}, rows:{len(inMem)}, expected:{len(expected)}")
+        if spilled != expected:
+            tdLog.exit(f"spilled hash join result differs, sql:{sql}, rows:{len(spilled)}, expected:{len(expected)}")
+        return len(expected)
+
+    def run(self):
+        self.prepare_data()
+
+        try:
+            # timestamp key only, two thirds of the probe rows match
+            rows = self.check_spill_result("select {hint} a.ts, a.c1, b.c1, b.pad from pt a join bt b on a.ts = b.ts")
+            tdSql.checkEqual(rows, self.rows - (self.rows + 2) // 3)
+
+            self.check_spill_result("select {hint} count(*), sum(a.c1), max(b.c1), min(b.pad) from pt a join bt b on a.ts = b.ts")
+
+            # var-length keys, rows with a null key never match
+            self.check_spill_result(
+                "select {hint} a.ts, a.c2, b.c2, b.pad from pt a join bt b on a.ts = b.ts and a.c2 = b.c2")
+            self.check_spill_result(
+                "select {hint} a.ts, a.c2, a.c3, b.c1 from pt a join bt b on a.ts = b.ts and a.c2 = b.c2 and a.c3 = b.c3")
+            self.check_spill_result(
+                "select {hint} count(*) from pt a join bt b on a.ts = b.ts and a.c3 = b.c3 where a.c2 is null")
+
+            # the null values of the non-key columns survive the spill
+            self.check_spill_result(
+                "select {hint} a.ts, a.c2, b.c2, b.c3 from pt a join bt b on a.ts = b.ts where b.c2 is null or a.c3 is null")
+
+            # filters on both sides
+            self.check_spill_result(
+                "select {hint} a.ts, b.pad from pt a join bt b on a.ts = b.ts and a.c2 = b.c2 where a.c1 > 20 and b.c1 < 30")
+        finally:
+            self.set_mem_limit(1024)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
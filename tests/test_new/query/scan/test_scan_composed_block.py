@@ -0,0 +1,115 @@
+import time
+
+from util.log import *
+from util.cases import *
+from util.sql import *
+
+
+class TestScanComposedBlock:
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+
+        self.dbname = "composed"
+        self.fileRows = 10000
+        # the expected content of the table, timestamp -> (c1, c2)
+        self.rows = {}
+
+    def test_scan_composed_block(self):
+        """测试文件数据块与stt、内存数据重叠时组合数据块的结果
+
+        数据文件块与 stt 文件、内存中的乱序数据以及删除的数据重叠时，按列拷贝的无重叠行段与逐行合并的行
+        拼接后结果正确，覆盖数据块边界、覆盖写、删除、升序和降序扫描
+
+        Since: v3.3.7.0
+
+        Labels: scan
+
+        History:
+            - 2026-10-18 Created
+
+        """
+        self.run()
+
+    def insert_rows(self, rows):
+        for ts, values in rows:
+            self.rows[ts] = values
+        tdSql.insertRows("t1", ((ts, c1, c2) for ts, (c1, c2) in rows))
+
+    def delete_rows(self, skey, ekey):
+        tdSql.execute(f"delete from t1 where ts >= {skey} and ts <= {ekey}")
+        for ts in [ts for ts in self.rows if skey <= ts <= ekey]:
+            del self.rows[ts]
+
+    # the data file rows are 10 ms apart, which leaves room for stt and memtable rows between them
+    def file_key(self, i):
+        return 1680000000000 + i * 10
+
+    def prepare_data(self):
+        db = self.dbname
+        tdSql.execute(f"drop database if exists {db}")
+        # with stt_trigger 1 the first flush goes to the data file, in blocks of at most 1000 rows
+        tdSql.execute(f"create database {db} vgroups 1 minrows 100 maxrows 1000 stt_trigger 1")
+        tdSql.execute(f"use {db}")
+        tdSql.execute("create table t1(ts timestamp, c1 int, c2 varchar(16))")
+
+        self.insert_rows([(self.file_key(i), (i, None if i % 9 == 0 else f"f{i}")) for i in range(self.fileRows)])
+        tdSql.execute(f"flush database {db}")
+
+        # the later flushes stay in stt files
+        tdSql.execute(f"alter database {db} stt_trigger 8")
+        time.sleep(2)
+
+        # stt rows between file rows, around block borders, in the middle and at both ends, plus a few overwrites
+        stt = []
+        for k in list(range(0, 5)) + list(range(995, 1006)) + list(range(4500, 4520)) + list(range(9990, 10010)):
+            stt.append((self.file_key(k) + 5, (-k, f"s{k}")))
+        for k in [0, 1, 999, 1000, 1001, 4510, 7777, 9999]:
+            stt.append((self.file_key(k), (-k - 100000, f"o{k}")))
+        self.insert_rows(stt)
+        tdSql.execute(f"flush database {db}")
+
+        # memtable rows overlapping both the file blocks and the stt rows
+        mem = []
+        for k in list(range(2000, 2003)) + list(range(4505, 4515)) + [8999, 9000]:
+            mem.append((self.file_key(k) + 5, (k + 200000, None if k % 2 == 0 else f"m{k}")))
+            mem.append((self.file_key(k), (k + 300000, f"n{k}")))
+        self.insert_rows(mem)
+
+        # deletes cutting into file rows, stt rows and memtable rows
+        self.delete_rows(self.file_key(100), self.file_key(150))
+        self.delete_rows(self.file_key(998) + 1, self.file_key(1002))
+        self.delete_rows(self.file_key(4508), self.file_key(4511) + 5)
+        self.delete_rows(self.file_key(9000), self.file_key(9000))
+
+    def check_rows(self, where, skey, ekey, order):
+        tdSql.query(f"select cast(ts as bigint), c1, c2 from t1 {where} order by ts {order}")
+        keys = sorted(ts for ts in self.rows if skey <= ts <= ekey)
+        if order == "desc":
+            keys.reverse()
+        tdSql.checkRows(len(keys))
+
+        for row, ts in zip(tdSql.queryResult, keys):
+            c1, c2 = self.rows[ts]
+            if row[0] != ts or row[1] != c1 or row[2] != c2:
+                tdLog.exit(f"{where} order {order}, expected ({ts}, {c1}, {c2}), got {row}")
+
+    def run(self):
+        self.prepare_data()
+
+        for round in range(2):
+            for order in ["asc", "desc"]:
+                self.check_rows("", 0, 2**63 - 1, order)
+
+                # ranges starting and ending inside the overlapping runs
+                for skey, ekey in [(self.file_key(990), self.file_key(1010)), (self.file_key(4000), self.file_key(5000)),
+                                   (self.file_key(1), self.file_key(9995))]:
+                    self.check_rows(f"where ts >= {skey} and ts <= {ekey}", skey, ekey, order)
+
+            # the memtable rows go to stt files as well
+            tdSql.execute(f"flush database {self.dbname}")
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
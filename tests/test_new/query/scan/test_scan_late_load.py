@@ -0,0 +1,96 @@
+from util.log import *
+from util.cases import *
+from util.sql import *
+
+
+class TestScanLateLoad:
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+
+        self.dbname = "lateload"
+        self.fileRows = 20000
+        self.memRows = 3000
+
+    def test_scan_late_load(self):
+        """测试表扫描先加载过滤列、再加载其余列
+
+        过滤条件过滤掉数据块中的全部行、部分行或不过滤任何行时，逐行检查未参与过滤的列的值，
+        覆盖文件数据块与内存数据合并、空值、升序和降序扫描
+
+        Since: v3.3.7.0
+
+        Labels: scan
+
+        History:
+            - 2026-10-18 Created
+
+        """
+        self.run()
+
+    # the values of row i, derived from its timestamp so that every returned row can be checked
+    def row_values(self, i):
+        c1 = i % 1000
+        c2 = i * 3
+        c3 = None if i % 7 == 0 else f"v{i}"
+        c4 = None if i % 11 == 0 else i / 4
+        return c1, c2, c3, c4
+
+    def insert_rows(self, start, end):
+        tdSql.insertRows("t1", ((1690000000000 + i * 1000,) + self.row_values(i) for i in range(start, end)))
+
+    def prepare_data(self):
+        db = self.dbname
+        tdSql.execute(f"drop database if exists {db}")
+        tdSql.execute(f"create database {db} vgroups 1 minrows 100 maxrows 1000")
+        tdSql.execute(f"use {db}")
+        tdSql.execute("create table t1(ts timestamp, c1 int, c2 bigint, c3 varchar(16), c4 double)")
+
+        # file blocks of at most 1000 rows, then rows in the memtable, some of them overwriting file rows
+        self.insert_rows(0, self.fileRows)
+        tdSql.execute(f"flush database {db}")
+        self.insert_rows(self.fileRows - self.memRows // 2, self.fileRows + self.memRows // 2)
+
+    def check_rows(self, where, pred, order="asc"):
+        tdSql.query(f"select ts, c3, c4, c2 from t1 where {where} order by ts {order}")
+        expected = [i for i in range(self.fileRows + self.memRows // 2) if pred(i)]
+        if order == "desc":
+            expected.reverse()
+        tdSql.checkRows(len(expected))
+
+        for row, i in zip(tdSql.queryResult, expected):
+            c1, c2, c3, c4 = self.row_values(i)
+            if row[1] != c3 or row[2] != c4 or row[3] != c2:
+                tdLog.exit(f"where {where} order {order}, row {i} expected ({c3}, {c4}, {c2}), got {row}")
+
+    def run(self):
+        self.prepare_data()
+
+        for order in ["asc", "desc"]:
+            # no row passes, the remaining columns of every block are dropped
+            self.check_rows("c1 > 5000", lambda i: False, order)
+
+            # some rows of every block pass
+            self.check_rows("c1 < 10", lambda i: i % 1000 < 10, order)
+            self.check_rows("c1 % 3 = 1 and c2 > 100", lambda i: i % 1000 % 3 == 1 and i * 3 > 100, order)
+
+            # all rows of a few blocks pass and none of the others
+            self.check_rows("c2 >= 30000 and c2 < 36000", lambda i: 30000 <= i * 3 < 36000, order)
+
+            # every row passes
+            self.check_rows("c1 >= 0", lambda i: True, order)
+
+            # a filter column that is also projected, and a filter on a column with nulls
+            self.check_rows("c2 < 6000 and c1 > 500", lambda i: i * 3 < 6000 and i % 1000 > 500, order)
+            self.check_rows("c4 is null", lambda i: i % 11 == 0, order)
+
+        # aggregates over the columns loaded in the second phase
+        tdSql.query("select count(c3), count(c4), sum(c4) from t1 where c1 < 100")
+        rows = [i for i in range(self.fileRows + self.memRows // 2) if i % 1000 < 100]
+        tdSql.checkData(0, 0, len([i for i in rows if i % 7 != 0]))
+        tdSql.checkData(0, 1, len([i for i in rows if i % 11 != 0]))
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
@@ -0,0 +1,87 @@
+from util.log import *
+from util.cases import *
+from util.sql import *
+
+
+class TestScanReadAhead:
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+
+        self.dbname = "readahead"
+        self.rows = 30000
+
+    def test_scan_read_ahead(self):
+        """测试表扫描预读后续数据块
+
+        queryReadAheadSizeMB 为 0、较小值和默认值时，跨越多个文件数据块的扫描结果一致，
+        覆盖只查询部分列、过滤条件依据 zone map 跳过数据块、空值、升序和降序扫描，并检查设为 0 时关闭预读
+
+        Since: v3.3.7.0
+
+        Labels: scan
+
+        History:
+            - 2026-10-18 Created
+
+        """
+        self.run()
+
+    def prepare_data(self):
+        db = self.dbname
+        tdSql.execute(f"drop database if exists {db}")
+        tdSql.execute(f"create database {db} vgroups 1 minrows 100 maxrows 1000")
+        tdSql.execute(f"use {db}")
+
+        # c1 grows with ts, so a range on it keeps only a few blocks by their zone map, and the wide pad column is
+        # the one a query not selecting it should not read ahead
+        tdSql.execute("create table t1(ts timestamp, c1 int, c2 bigint, c3 varchar(16), pad varchar(256))")
+        pad = "p" * 240
+        rows = ((1537146000000 + i * 1000, i, None if i % 9 == 0 else i * 5, f"v{i % 97}", f"{pad}{i % 10}")
+                for i in range(self.rows))
+        tdSql.insertRows("t1", rows)
+        tdSql.execute(f"flush database {db}")
+
+    def set_read_ahead(self, mb):
+        tdSql.execute(f"alter all dnodes 'queryReadAheadSizeMB' '{mb}'")
+        tdSql.query("show dnode 1 variables like 'queryReadAheadSizeMB'")
+        tdSql.checkRows(1)
+        tdSql.checkData(0, 2, str(mb))
+
+    def check_read_ahead(self, sql):
+        self.set_read_ahead(0)
+        expected = tdSql.getResult(sql)
+        for mb in [1, 16]:
+            self.set_read_ahead(mb)
+            result = tdSql.getResult(sql)
+            if result != expected:
+                tdLog.exit(f"read ahead {mb} MB changes the result of {sql}, rows:{len(result)}, expected:{len(expected)}")
+        return expected
+
+    def run(self):
+        self.prepare_data()
+
+        try:
+            # every column, and part of them, over all the blocks
+            for order in ["asc", "desc"]:
+                rows = self.check_read_ahead(f"select * from t1 order by ts {order}")
+                tdSql.checkEqual(len(rows), self.rows)
+                self.check_read_ahead(f"select ts, c2 from t1 order by ts {order}")
+
+            # blocks dropped by the zone map of c1, kept ones far apart, and a filter the zone map can not decide
+            rows = self.check_read_ahead("select ts, c1, c3 from t1 where c1 between 4500 and 5600 order by ts")
+            tdSql.checkEqual(len(rows), 1101)
+            rows = self.check_read_ahead("select c1, c2 from t1 where c1 < 800 or c1 > 28900 order by ts desc")
+            tdSql.checkEqual(len(rows), 800 + self.rows - 28901)
+            self.check_read_ahead("select ts, c2 from t1 where c2 is null order by ts")
+            self.check_read_ahead("select c3, count(*), sum(c2) from t1 where c1 % 7 = 3 group by c3 order by c3")
+
+            # aggregates load no column data
+            self.check_read_ahead("select count(*), first(ts), last(ts) from t1")
+        finally:
+            self.set_read_ahead(16)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
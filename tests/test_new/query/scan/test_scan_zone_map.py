@@ -0,0 +1,98 @@
+import re
+
+from util.log import *
+from util.cases import *
+from util.sql import *
+
+
+class TestScanZoneMap:
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+
+        self.dbname = "zonemap"
+        self.rows = 20000
+
+    def test_scan_zone_map(self):
+        """测试依据数据块 zone map 跳过数据块
+
+        过滤条件落在数据块取值范围之外时扫描不加载该数据块，结果与无法依据 zone map 过滤的等价条件一致，
+        覆盖整型、浮点、含空值和全空列
+
+        Since: v3.3.7.0
+
+        Labels: scan
+
+        History:
+            - 2026-10-18 Created
+
+        """
+        self.run()
+
+    def prepare_data(self):
+        db = self.dbname
+        tdSql.execute(f"drop database if exists {db}")
+        tdSql.execute(f"create database {db} vgroups 1 minrows 100 maxrows 1000 stt_trigger 1")
+        tdSql.execute(f"use {db}")
+
+        # the flush goes to the data file, whose blocks have a zone map; c1 and c2 grow with ts, so each block covers
+        # its own narrow range of them, and c4 is all null
+        tdSql.execute("create table t1(ts timestamp, c1 int, c2 double, c3 varchar(16), c4 bigint)")
+        rows = ((1537146000000 + i * 1000, i, None if i % 11 == 0 else i * 0.25, f"v{i % 13}", None)
+                for i in range(self.rows))
+        tdSql.insertRows("t1", rows)
+        tdSql.execute(f"flush database {db}")
+
+    def scan_blocks(self, sql):
+        # (total_blocks, load_blocks) of the table scan in explain analyze
+        for row in tdSql.getResult(f"explain analyze verbose true {sql}"):
+            m = re.search(r"total_blocks=([\d.]+) +load_blocks=([\d.]+)", str(row[0]))
+            if m:
+                return float(m.group(1)), float(m.group(2))
+        tdLog.exit(f"no table scan I/O in the explain of {sql}")
+
+    def check_pruned(self, cond, unpruned, rows):
+        # unpruned is the same condition on an expression of the column, which the zone map can not decide
+        sql = f"select ts, c1, c2, c3 from t1 where {cond} order by ts"
+        expected = tdSql.getResult(f"select ts, c1, c2, c3 from t1 where {unpruned} order by ts")
+        result = tdSql.getResult(sql)
+        if result != expected:
+            tdLog.exit(f"zone map pruning changes the result of {sql}, rows:{len(result)}, expected:{len(expected)}")
+        tdSql.checkEqual(len(result), rows)
+
+        total, loaded = self.scan_blocks(sql)
+        total2, loaded2 = self.scan_blocks(f"select ts, c1, c2, c3 from t1 where {unpruned} order by ts")
+        tdSql.checkEqual(total, total2)
+        tdSql.checkEqual(loaded2, total2)
+        if loaded >= loaded2:
+            tdLog.exit(f"no block is skipped by the zone map for {cond}, load_blocks:{loaded} of {total}")
+
+    def run(self):
+        self.prepare_data()
+
+        total, loaded = self.scan_blocks("select * from t1")
+        tdLog.info(f"t1 has {total} file blocks")
+        tdSql.checkGreater(total, 10)
+
+        self.check_pruned("c1 between 4500 and 5600", "c1 + 0 between 4500 and 5600", 1101)
+        self.check_pruned("c1 < 300 or c1 >= 19800", "c1 + 0 < 300 or c1 + 0 >= 19800", 500)
+        self.check_pruned("c2 > 4900", "c2 + 0 > 4900", len([i for i in range(19601, self.rows) if i % 11 != 0]))
+        self.check_pruned("c1 > 19000 and c3 = 'v1'", "c1 + 0 > 19000 and c3 = 'v1'",
+                          len([i for i in range(19001, self.rows) if i % 13 == 1]))
+
+        # a range outside of every block keeps no block at all
+        tdSql.query("select * from t1 where c1 > 100000")
+        tdSql.checkRows(0)
+        total, loaded = self.scan_blocks("select * from t1 where c1 > 100000")
+        tdSql.checkEqual(loaded, 0)
+
+        # an all null column has a zone map entry as well, comparisons on it keep no block
+        tdSql.query("select * from t1 where c4 > 0")
+        tdSql.checkRows(0)
+        total, loaded = self.scan_blocks("select * from t1 where c4 > 0")
+        tdSql.checkEqual(loaded, 0)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
@@ -0,0 +1,178 @@
+import glob
+import json
+import os
+import random
+import time
+
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import tdDnodes
+
+
+class TestRetentionResume:
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+
+        self.rows = 100000
+        self.day = 86400000
+
+    def test_retention_resume(self):
+        """测试多级存储迁移中断后从检查点继续
+
+        迁移数据文件到下一级存储时停止 taosd，current.json 中保存已拷贝的偏移，重启后再次迁移从该偏移继续，数据完整；
+        检查点之后源文件被写入时丢弃该检查点，迁移从头开始
+
+        Since: v3.3.7.0
+
+        Labels: storage, retention
+
+        History:
+            - 2026-10-18 Created
+
+        """
+        self.run()
+
+    def deploy(self):
+        # level 0 on data0, and the files older than keep0 migrate to level 1 on data1
+        root = os.path.join(tdDnodes.getDnodesRootDir(), "dnode1")
+        self.levels = [os.path.join(root, "data0"), os.path.join(root, "data1")]
+        for d in self.levels:
+            tdSql.createDir(d)
+        cfg = {f"{self.levels[0]} 0 1": "dataDir", f"{self.levels[1]} 1 0": "dataDir"}
+
+        tdDnodes.stop(1)
+        tdDnodes.deploy(1, cfg)
+        tdDnodes.startWithoutSleep(1)
+        self.logDir = tdDnodes.dnodes[0].logDir
+
+    def restart(self):
+        tdDnodes.stop(1)
+        tdDnodes.startWithoutSleep(1)
+
+    def set_speed_limit(self, mb):
+        tdSql.execute(f"alter all dnodes 'retentionSpeedLimitMB' '{mb}'")
+
+    def prepare_db(self, db):
+        tdSql.execute(f"drop database if exists {db}")
+        tdSql.execute(f"create database {db} vgroups 1 duration 1d keep 10d,100d,3650d stt_trigger 1")
+        tdSql.execute(f"use {db}")
+        tdSql.query(f"show {db}.vgroups")
+        vgId = tdSql.getData(0, 0)
+
+        # random payload does not compress, so the data file is large enough to take seconds to copy at 1 MB/s; all
+        # the rows are in the same day, the same file set, which is younger than keep0 and flushed to level 0
+        tdSql.execute("create table t1(ts timestamp, c1 int, pad varchar(200))")
+        self.start = (int(time.time() * 1000) // self.day - 5) * self.day + 3600000
+        rows = ((self.start + i * 10, i, "%0200x" % random.getrandbits(800)) for i in range(self.rows))
+        tdSql.insertRows("t1", rows)
+        tdSql.execute(f"flush database {db}")
+        return vgId
+
+    def tsdb_dir(self, vgId, level):
+        return os.path.join(self.levels[level], "vnode", f"vnode{vgId}", "tsdb")
+
+    def current(self, vgId):
+        with open(os.path.join(self.tsdb_dir(vgId, 0), "current.json")) as f:
+            return json.load(f)
+
+    def ckpts(self, vgId):
+        return [fset["rtn ckpt"] for fset in self.current(vgId)["fset"] if "rtn ckpt" in fset]
+
+    def data_level(self, vgId):
+        levels = [fset["data"]["did.level"] for fset in self.current(vgId)["fset"] if "data" in fset]
+        tdSql.checkEqual(len(levels), 1)
+        return levels[0]
+
+    def wait_copying(self, vgId):
+        # the target data file shows up on level 1 once the copy starts
+        for i in range(60):
+            files = glob.glob(os.path.join(self.tsdb_dir(vgId, 1), "*.data"))
+            if files and os.path.getsize(files[0]) > 0:
+                return
+            time.sleep(1)
+        tdLog.exit(f"vgroup {vgId} does not start to migrate")
+
+    def wait_migrated(self, vgId):
+        for i in range(120):
+            if self.data_level(vgId) == 1:
+                return
+            time.sleep(1)
+        tdLog.exit(f"vgroup {vgId} does not finish migrating")
+
+    def stop_migrating(self, db, vgId):
+        # make the file set older than keep0 and stop taosd in the middle of its migration
+        self.set_speed_limit(1)
+        tdSql.execute(f"alter database {db} keep 3d,100d,3650d")
+        tdSql.execute(f"trim database {db}")
+        self.wait_copying(vgId)
+        tdDnodes.stop(1)
+
+        ckpts = self.ckpts(vgId)
+        tdSql.checkEqual(len(ckpts), 1)
+        tdLog.info(f"vgroup {vgId} stops migrating at {ckpts[0]}")
+        tdSql.checkGreater(ckpts[0]["offset"], 0)
+        tdSql.checkEqual(ckpts[0]["of"]["data"]["did.level"], 0)
+        tdSql.checkEqual(ckpts[0]["nf"]["data"]["did.level"], 1)
+        return ckpts[0]
+
+    def resumed(self, ckpt):
+        pattern = f"offset:{int(ckpt['offset'])}"
+        for name in glob.glob(os.path.join(self.logDir, "taosdlog.*")):
+            with open(name, errors="ignore") as f:
+                if any("resume to migrate" in line and pattern in line for line in f):
+                    return True
+        return False
+
+    def check_resume(self):
+        db = "rtn_resume"
+        vgId = self.prepare_db(db)
+        expected = tdSql.getResult(f"select * from {db}.t1 order by ts")
+
+        ckpt = self.stop_migrating(db, vgId)
+        tdDnodes.startWithoutSleep(1)
+        self.set_speed_limit(0)
+        tdSql.execute(f"trim database {db}")
+        self.wait_migrated(vgId)
+
+        if not self.resumed(ckpt):
+            tdLog.exit(f"vgroup {vgId} does not resume migrating from offset {ckpt['offset']}")
+        tdSql.checkEqual(len(self.ckpts(vgId)), 0)
+        if tdSql.getResult(f"select * from {db}.t1 order by ts") != expected:
+            tdLog.exit(f"the data of {db} changes after resuming the migration")
+
+        # the data survives another restart as well
+        self.restart()
+        tdSql.query(f"select count(*), sum(c1) from {db}.t1")
+        tdSql.checkData(0, 0, self.rows)
+        tdSql.checkData(0, 1, self.rows * (self.rows - 1) // 2)
+
+    def check_stale(self):
+        db = "rtn_stale"
+        vgId = self.prepare_db(db)
+        self.stop_migrating(db, vgId)
+        tdDnodes.startWithoutSleep(1)
+
+        # a commit to the source file set makes the copied part stale
+        tdSql.execute(f"insert into {db}.t1 values({self.start - 1000}, -1, 'new')")
+        tdSql.execute(f"flush database {db}")
+        tdSql.checkEqual(len(self.ckpts(vgId)), 0)
+
+        self.set_speed_limit(0)
+        tdSql.execute(f"trim database {db}")
+        self.wait_migrated(vgId)
+        tdSql.query(f"select count(*), sum(c1), min(c1) from {db}.t1")
+        tdSql.checkData(0, 0, self.rows + 1)
+        tdSql.checkData(0, 1, self.rows * (self.rows - 1) // 2 - 1)
+        tdSql.checkData(0, 2, -1)
+
+    def run(self):
+        self.deploy()
+        self.check_resume()
+        self.check_stale()
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
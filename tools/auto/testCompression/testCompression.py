@@ -304,6 +304,41 @@ def testQuery():
     else:
         return speed
 
+def getColumnNames():
+    context = readFileContext(templateFile)
+    names = []
+    start = context.find('"columns"')
+    end   = context.find("]", start)
+    pos   = context.find('"name"', start)
+    while pos != -1 and pos < end:
+        value = findContextValue(context[pos:], "name")
+        names.append(value.replace('"', '').strip())
+        pos = context.find('"name"', pos + 6)
+    return names
+
+def getQueryTime(output):
+    # Query OK, 1 row(s) in set (0.004162s)
+    pos = output.find("row(s) in set (")
+    if pos == -1:
+        return None
+    pos += len("row(s) in set (")
+    end = output.find("s)", pos)
+    return float(output[pos:end])
+
+def columnDecodeSpeed(algo, resultFile, rows):
+    # the filter on the column forces every block of it to be read and decompressed
+    for name in getColumnNames():
+        command = f'taos -s "select count(*) from dbrate.meters where {name} is not null;"'
+        out, err = run(command)
+        spent = getQueryTime(out)
+        if spent is None or spent <= 0:
+            speed = "unknown"
+        else:
+            speed = str(int(rows / spent))
+        context = "%10s %10s %10s %30s\n"%("", algo, name, speed + " Rows/second")
+        showLog(context)
+        appendFileContext(resultFile, context)
+
 def doTest(algo, resultFile):
     print(f"doTest algo: {algo} \n")
 
@@ -320,11 +355,16 @@ def doTest(algo, resultFile):
     # total compress rate
     totalCompressRate(algo, resultFile, writeSpeed, querySpeed)
 
+    # per column decode throughput, shows what the ratio above costs on the read side
+    context = readFileContext(templateFile)
+    rows = int(findContextValue(context, "insert_rows")) * int(findContextValue(context, "childtable_count"))
+    columnDecodeSpeed(algo, resultFile, rows)
+
 
 def main():
 
     # test compress method
-    algos = ["lz4", "zlib", "zstd", "xz", "disabled"]
+    algos = ["lz4", "zlib", "zstd", "xz", "auto", "disabled"]
     #algos = ["lz4"]
 
     # record result
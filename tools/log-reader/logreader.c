@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "os.h"
+#include "taoserror.h"
+#include "tlog.h"
+
+// decode the log files written with binaryLog enabled, the text lines are printed to stdout
+static void logReaderOutput(void *param, const char *msg, int32_t msgLen) {
+  TAOS_UNUSED(fwrite(msg, 1, msgLen, (FILE *)param));
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    (void)printf("Usage: %s <log file> [<log file> ...]\n", argv[0]);
+    (void)printf("  rotated log files should be given in the order they are written\n");
+    return 1;
+  }
+
+  SLogDecoder *pDecoder = NULL;
+  int32_t      code = taosLogDecoderOpen(&pDecoder);
+  if (code != 0) {
+    (void)fprintf(stderr, "failed to open log decoder since %s\n", tstrerror(code));
+    return 1;
+  }
+
+  for (int32_t i = 1; i < argc; ++i) {
+    code = taosLogDecodeFile(pDecoder, argv[i], logReaderOutput, stdout);
+    if (code != 0) {
+      (void)fprintf(stderr, "failed to decode log file:%s since %s\n", argv[i], tstrerror(code));
+      break;
+    }
+  }
+
+  taosLogDecoderClose(pDecoder);
+  (void)fflush(stdout);
+  return code == 0 ? 0 : 1;
+}